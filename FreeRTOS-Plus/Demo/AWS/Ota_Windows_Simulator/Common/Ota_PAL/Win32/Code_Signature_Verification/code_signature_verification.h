@@ -42,4 +42,18 @@
  */
 OtaPalMainStatus_t xValidateImageSignature( OtaFileContext_t* const pFileContext );
 
+/**
+* @brief Add the next bytes of the received file to the digest checked by
+* xValidateImageSignature(). A call with pFileContext->digestSize of zero starts
+* a new digest.
+* @param[in] pFileContext pointer to File context
+* @param[in] pucData The bytes to hash, or NULL to read them from the file at
+* offset pFileContext->digestSize.
+* @param[in] ulDataSize The number of bytes to hash.
+* @return OtaPalMainStatus_t , OtaPalSuccess if the bytes were added to the digest.
+*/
+OtaPalMainStatus_t xUpdateImageDigest( OtaFileContext_t* const pFileContext,
+                                       const uint8_t* pucData,
+                                       uint32_t ulDataSize );
+
 #endif
@@ -83,6 +83,12 @@ typedef struct SignatureVerificationState
     mbedtls_sha256_context xSHA256Context;
 } SignatureVerificationState_t, * SignatureVerificationStatePtr_t;
 
+/**
+ * @brief Digest of the file being received, updated by xUpdateImageDigest().
+ * NULL when no digest is being streamed.
+ */
+static void* pvStreamedDigestContext = NULL;
+
 /**
  * @brief Initializes digital signature verification.
  *
@@ -390,6 +396,95 @@ static BaseType_t prvSignatureVerificationFinal(void* pvContext,
     return xResult;
 }
 
+/* Add the next bytes of the received file to the streamed digest. */
+OtaPalMainStatus_t xUpdateImageDigest(OtaFileContext_t* const C,
+    const uint8_t* pucData,
+    uint32_t ulDataSize)
+{
+    OtaPalMainStatus_t eResult = OtaPalSuccess;
+    uint8_t* pucBuf = NULL;
+    uint32_t ulBytesToRead;
+
+    /* A new file starts a new digest. Drop the digest of a file that was never
+     * closed, for example after an abort. */
+    if (C->digestSize == 0UL)
+    {
+        if (pvStreamedDigestContext != NULL)
+        {
+            (void)prvSignatureVerificationFinal(pvStreamedDigestContext, NULL, 0, NULL, 0);
+            pvStreamedDigestContext = NULL;
+        }
+
+        if (pdFALSE == prvSignatureVerificationStart(&pvStreamedDigestContext, ASYMMETRIC_ALGORITHM_ECDSA, HASH_ALGORITHM_SHA256))
+        {
+            pvStreamedDigestContext = NULL;
+            eResult = OtaPalOutOfMemory;
+        }
+    }
+    else if (pvStreamedDigestContext == NULL)
+    {
+        /* An earlier update failed, the file is hashed when it is closed. */
+        eResult = OtaPalSignatureCheckFailed;
+    }
+    else
+    {
+        /* Nothing special to do. */
+    }
+
+    if (eResult == OtaPalSuccess)
+    {
+        if (pucData != NULL)
+        {
+            prvSignatureVerificationUpdate(pvStreamedDigestContext, pucData, ulDataSize);
+        }
+        else
+        {
+            /* The data arrived after a gap and is only in the file, read it back. */
+            pucBuf = pvPortMalloc(OTA_PAL_WIN_BUF_SIZE); /*lint !e9079 Allow conversion. */
+
+            if (pucBuf == NULL)
+            {
+                eResult = OtaPalOutOfMemory;
+            }
+            else if (fseek(C->pFile, (long)C->digestSize, SEEK_SET) != 0) /*lint !e586
+                                                                           * C standard library call is being used for portability. */
+            {
+                eResult = OtaPalSignatureCheckFailed;
+            }
+            else
+            {
+                while ((eResult == OtaPalSuccess) && (ulDataSize > 0UL))
+                {
+                    ulBytesToRead = (ulDataSize < OTA_PAL_WIN_BUF_SIZE) ? ulDataSize : (uint32_t)OTA_PAL_WIN_BUF_SIZE;
+
+                    if (fread(pucBuf, 1, ulBytesToRead, C->pFile) == ulBytesToRead) /*lint !e586
+                                                                                       * C standard library call is being used for portability. */
+                    {
+                        prvSignatureVerificationUpdate(pvStreamedDigestContext, pucBuf, ulBytesToRead);
+                        ulDataSize -= ulBytesToRead;
+                    }
+                    else
+                    {
+                        eResult = OtaPalSignatureCheckFailed;
+                    }
+                }
+            }
+
+            vPortFree(pucBuf);
+        }
+    }
+
+    /* The digest no longer matches the file, so it is hashed again on close. */
+    if ((eResult != OtaPalSuccess) && (pvStreamedDigestContext != NULL))
+    {
+        LogError(("Failed to update the streamed image digest.\r\n"));
+        (void)prvSignatureVerificationFinal(pvStreamedDigestContext, NULL, 0, NULL, 0);
+        pvStreamedDigestContext = NULL;
+    }
+
+    return eResult;
+}
+
 /* Verify the signature of the specified file. */
 OtaPalMainStatus_t xValidateImageSignature(OtaFileContext_t* const C)
 {
@@ -397,10 +492,30 @@ OtaPalMainStatus_t xValidateImageSignature(OtaFileContext_t* const C)
     uint32_t ulBytesRead;
     uint32_t ulSignerCertSize;
     uint8_t* pucBuf, * pucSignerCert;
-    void* pvSigVerifyContext;
+    void* pvSigVerifyContext = NULL;
+    BaseType_t xDigestStreamed = pdFALSE;
+
+        /* Use the digest computed while the file was received if it covers the
+         * whole file, otherwise hash the stored file. */
+        if ((pvStreamedDigestContext != NULL) && (C->digestSize == C->fileSize))
+        {
+            pvSigVerifyContext = pvStreamedDigestContext;
+            xDigestStreamed = pdTRUE;
+        }
+        else if (pvStreamedDigestContext != NULL)
+        {
+            (void)prvSignatureVerificationFinal(pvStreamedDigestContext, NULL, 0, NULL, 0);
+        }
+        else
+        {
+            /* Nothing special to do. */
+        }
+
+        pvStreamedDigestContext = NULL;
 
         /* Verify an ECDSA-SHA256 signature. */
-        if (pdFALSE == prvSignatureVerificationStart(&pvSigVerifyContext, ASYMMETRIC_ALGORITHM_ECDSA, HASH_ALGORITHM_SHA256))
+        if ((xDigestStreamed == pdFALSE) &&
+            (pdFALSE == prvSignatureVerificationStart(&pvSigVerifyContext, ASYMMETRIC_ALGORITHM_ECDSA, HASH_ALGORITHM_SHA256)))
         {
             eResult = OtaPalSignatureCheckFailed;
         }
@@ -410,7 +525,24 @@ OtaPalMainStatus_t xValidateImageSignature(OtaFileContext_t* const C)
                 OTA_JsonFileSignatureKey, (const char*)C->pCertFilepath));
             pucSignerCert = otaPal_ReadAndAssumeCertificate((const uint8_t* const)C->pCertFilepath, &ulSignerCertSize);
 
-            if (pucSignerCert != NULL)
+            if ((pucSignerCert != NULL) && (xDigestStreamed == pdTRUE))
+            {
+                LogInfo(("Using the digest computed while the file was received.\r\n"));
+
+                if (pdFALSE == prvSignatureVerificationFinal(pvSigVerifyContext,
+                    (char*)pucSignerCert,
+                    (size_t)ulSignerCertSize,
+                    C->pSignature->data,
+                    C->pSignature->size)) /*lint !e732 !e9034 Allow comparison in this context. */
+                {
+                    eResult = OtaPalSignatureCheckFailed;
+                }
+                pvSigVerifyContext = NULL;	/* The context has been freed by prvSignatureVerificationFinal(). */
+
+                /* Free the signer certificate that we now own after prvReadAndAssumeCertificate(). */
+                vPortFree(pucSignerCert);
+            }
+            else if (pucSignerCert != NULL)
             {
                 pucBuf = pvPortMalloc( OTA_PAL_WIN_BUF_SIZE ); /*lint !e9079 Allow conversion. */
 
@@ -269,6 +269,26 @@ static OtaPalMainStatus_t otaPal_CheckFileSignature( OtaFileContext_t* const C )
     return eResult;
 }
 
+/* Hash the next bytes of the receive file as they are received. */
+
+OtaPalStatus_t otaPal_UpdateDigest( OtaFileContext_t * const C,
+                                    const uint8_t * pData,
+                                    uint32_t dataSize )
+{
+    OtaPalMainStatus_t mainErr = OtaPalSignatureCheckFailed;
+
+    if( prvContextValidate( C ) == pdTRUE )
+    {
+        mainErr = xUpdateImageDigest( C, pData, dataSize );
+    }
+    else
+    {
+        LogError( ( "ERROR - Invalid context.\r\n" ) );
+    }
+
+    return OTA_PAL_COMBINE_ERR( mainErr, 0 );
+}
+
 /*-----------------------------------------------------------*/
 
 OtaPalStatus_t otaPal_ResetDevice( OtaFileContext_t* const pFileContext )
@@ -204,4 +204,25 @@ OtaPalStatus_t  otaPal_SetPlatformImageState( OtaFileContext_t * const C,
  */
 OtaPalImageState_t otaPal_GetPlatformImageState( OtaFileContext_t * const C );
 
+/**
+ * @brief Hash the next bytes of the receive file as they are received.
+ *
+ * The digest is kept until otaPal_CloseFile(), which checks the signature against
+ * it instead of reading the file back if it covers the whole file.
+ *
+ * @note The input OtaFileContext_t C is checked for NULL by the OTA agent before this
+ * function is called.
+ *
+ * @param[in] C OTA file context information.
+ * @param[in] pData The bytes to hash, or NULL to read dataSize bytes back from the
+ * file at offset C->digestSize.
+ * @param[in] dataSize The number of bytes to hash.
+ *
+ * @return The OTA PAL layer error code combined with the MCU specific error code. See OTA Agent
+ * error codes information in ota.h.
+ */
+OtaPalStatus_t otaPal_UpdateDigest( OtaFileContext_t * const C,
+                                    const uint8_t * pData,
+                                    uint32_t dataSize );
+
 #endif /* ifndef _OTA_PAL_H_ */
\ No newline at end of file
@@ -35,8 +35,355 @@
 /* Subscription manager header include. */
 #include "subscription_manager.h"
 
+/**
+ * @brief One level of an incoming topic still to be matched, and the
+ * topic filter level that matched the level before it.
+ */
+typedef struct topicMatch
+{
+    uint16_t usNode;
+    uint32_t ulTopicIndex;
+} TopicMatch_t;
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Find the length of the topic or topic filter level starting at an index.
+ *
+ * @param[in] pcTopic The topic or topic filter.
+ * @param[in] usTopicLength Length of the topic or topic filter.
+ * @param[in] usIndex Index of the start of the level.
+ *
+ * @return Length of the level, excluding the separator.
+ */
+static uint16_t prvLevelLength( const char * pcTopic,
+                                uint16_t usTopicLength,
+                                uint16_t usIndex );
+
+/**
+ * @brief Check that the wildcards of a topic filter each make up a whole
+ * level, that '#' is only the last level, and that the filter is not too deep.
+ *
+ * @param[in] pcTopicFilterString Topic filter.
+ * @param[in] usTopicFilterLength Length of topic filter.
+ *
+ * @return `true` if the filter may be added to the trie; `false` otherwise.
+ */
+static bool prvIsValidFilter( const char * pcTopicFilterString,
+                              uint16_t usTopicFilterLength );
+
+/**
+ * @brief Compute the child table slot at which to start looking for a level.
+ *
+ * @param[in] usParent The parent node.
+ * @param[in] pcLevel The text of the level.
+ * @param[in] usLevelLength Length of the level.
+ *
+ * @return The slot.
+ */
+static uint32_t prvChildSlot( uint16_t usParent,
+                              const char * pcLevel,
+                              uint16_t usLevelLength );
+
+/**
+ * @brief Find the node for a level of topic filter, other than a wildcard level.
+ *
+ * @param[in] pxSubscriptionManager The subscription manager.
+ * @param[in] usParent The parent node.
+ * @param[in] pcLevel The text of the level.
+ * @param[in] usLevelLength Length of the level.
+ * @param[out] pulSlot The slot holding the node if found, else the empty slot
+ * where it would be added.
+ *
+ * @return The node, or 0 if there is none.
+ */
+static uint16_t prvFindChild( const SubscriptionManager_t * pxSubscriptionManager,
+                              uint16_t usParent,
+                              const char * pcLevel,
+                              uint16_t usLevelLength,
+                              uint32_t * pulSlot );
+
+/**
+ * @brief Add the levels of a subscription's topic filter to the trie and
+ * link the subscription to the node of its last level.
+ *
+ * @param[in] pxSubscriptionManager The subscription manager.
+ * @param[in] usIndex Index of the subscription in the list.
+ *
+ * @return `true` if added; `false` if SUBSCRIPTION_MANAGER_MAX_TOPIC_NODES
+ * is too small.
+ */
+static bool prvInsertFilter( SubscriptionManager_t * pxSubscriptionManager,
+                             uint16_t usIndex );
+
+/**
+ * @brief Rebuild the trie from the subscription list, so that the nodes of
+ * removed subscriptions may be used again.
+ *
+ * @param[in] pxSubscriptionManager The subscription manager.
+ */
+static void prvRebuildTrie( SubscriptionManager_t * pxSubscriptionManager );
+
+/**
+ * @brief Invoke the callbacks of the subscriptions ending at a node.
+ *
+ * @param[in] pxSubscriptionManager The subscription manager.
+ * @param[in] usNode The node.
+ * @param[in] pxPublishInfo Info of incoming publish.
+ *
+ * @return `true` if a callback was invoked; `false` otherwise.
+ */
+static bool prvInvokeCallbacks( SubscriptionManager_t * pxSubscriptionManager,
+                                uint16_t usNode,
+                                MQTTPublishInfo_t * pxPublishInfo );
+
+/*-----------------------------------------------------------*/
+
+static uint16_t prvLevelLength( const char * pcTopic,
+                                uint16_t usTopicLength,
+                                uint16_t usIndex )
+{
+    uint16_t usEnd = usIndex;
+
+    while( ( usEnd < usTopicLength ) && ( pcTopic[ usEnd ] != '/' ) )
+    {
+        usEnd++;
+    }
+
+    return usEnd - usIndex;
+}
+
+/*-----------------------------------------------------------*/
+
+static bool prvIsValidFilter( const char * pcTopicFilterString,
+                              uint16_t usTopicFilterLength )
+{
+    bool xValid = true;
+    uint32_t ulLevels = 0U, ulIndex = 0U, ulLevelLength, ulChar;
+
+    while( ( xValid == true ) && ( ulIndex <= usTopicFilterLength ) )
+    {
+        ulLevelLength = prvLevelLength( pcTopicFilterString, usTopicFilterLength, ( uint16_t ) ulIndex );
+        ulLevels++;
+
+        for( ulChar = ulIndex; ulChar < ( ulIndex + ulLevelLength ); ulChar++ )
+        {
+            if( ( ( pcTopicFilterString[ ulChar ] == '+' ) || ( pcTopicFilterString[ ulChar ] == '#' ) ) &&
+                ( ulLevelLength != 1U ) )
+            {
+                xValid = false;
+            }
+        }
+
+        ulIndex += ulLevelLength + 1U;
+
+        if( ( ulLevelLength == 1U ) &&
+            ( pcTopicFilterString[ ulIndex - 2U ] == '#' ) &&
+            ( ulIndex <= usTopicFilterLength ) )
+        {
+            /* '#' is not the last level. */
+            xValid = false;
+        }
+    }
+
+    if( ulLevels > SUBSCRIPTION_MANAGER_MAX_FILTER_LEVELS )
+    {
+        xValid = false;
+    }
+
+    return xValid;
+}
+
+/*-----------------------------------------------------------*/
+
+static uint32_t prvChildSlot( uint16_t usParent,
+                              const char * pcLevel,
+                              uint16_t usLevelLength )
+{
+    /* FNV-1a over the parent node and the level text. */
+    uint32_t ulHash = 2166136261UL ^ usParent;
+    uint16_t usIndex;
+
+    ulHash *= 16777619UL;
+
+    for( usIndex = 0U; usIndex < usLevelLength; usIndex++ )
+    {
+        ulHash ^= ( uint8_t ) pcLevel[ usIndex ];
+        ulHash *= 16777619UL;
+    }
+
+    return ulHash & ( SUBSCRIPTION_MANAGER_CHILD_TABLE_SIZE - 1U );
+}
+
+/*-----------------------------------------------------------*/
+
+static uint16_t prvFindChild( const SubscriptionManager_t * pxSubscriptionManager,
+                              uint16_t usParent,
+                              const char * pcLevel,
+                              uint16_t usLevelLength,
+                              uint32_t * pulSlot )
+{
+    uint32_t ulSlot = prvChildSlot( usParent, pcLevel, usLevelLength );
+    uint16_t usNode = pxSubscriptionManager->usChildTable[ ulSlot ];
+    const TopicNode_t * pxNode;
+
+    /* The table is never more than half full, so an empty slot ends the search. */
+    while( usNode != 0U )
+    {
+        pxNode = &( pxSubscriptionManager->xTopicNodes[ usNode ] );
+
+        if( ( pxNode->usParent == usParent ) &&
+            ( pxNode->usLevelLength == usLevelLength ) &&
+            ( memcmp( &( pxSubscriptionManager->xSubscriptionList[ pxNode->usOwner ].pcSubscriptionFilterString[ pxNode->usLevelOffset ] ),
+                      pcLevel,
+                      usLevelLength ) == 0 ) )
+        {
+            break;
+        }
+
+        ulSlot = ( ulSlot + 1U ) & ( SUBSCRIPTION_MANAGER_CHILD_TABLE_SIZE - 1U );
+        usNode = pxSubscriptionManager->usChildTable[ ulSlot ];
+    }
+
+    *pulSlot = ulSlot;
+
+    return usNode;
+}
+
+/*-----------------------------------------------------------*/
+
+static bool prvInsertFilter( SubscriptionManager_t * pxSubscriptionManager,
+                             uint16_t usIndex )
+{
+    SubscriptionElement_t * pxSubscription = &( pxSubscriptionManager->xSubscriptionList[ usIndex ] );
+    const char * pcFilter = pxSubscription->pcSubscriptionFilterString;
+    uint16_t usFilterLength = pxSubscription->usFilterStringLength;
+    uint16_t usNode = 0U, usChild, usLevelLength;
+    uint16_t * pusWildcardChild;
+    uint32_t ulIndex = 0U, ulSlot = 0U;
+    bool xAdded = true;
+
+    if( pxSubscriptionManager->usTopicNodeCount == 0U )
+    {
+        /* The root node is zero-initialized already. */
+        pxSubscriptionManager->usTopicNodeCount = 1U;
+    }
+
+    while( ( xAdded == true ) && ( ulIndex <= usFilterLength ) )
+    {
+        usLevelLength = prvLevelLength( pcFilter, usFilterLength, ( uint16_t ) ulIndex );
+        pusWildcardChild = NULL;
+
+        if( ( usLevelLength == 1U ) && ( pcFilter[ ulIndex ] == '+' ) )
+        {
+            pusWildcardChild = &( pxSubscriptionManager->xTopicNodes[ usNode ].usSingleLevelChild );
+            usChild = *pusWildcardChild;
+        }
+        else if( ( usLevelLength == 1U ) && ( pcFilter[ ulIndex ] == '#' ) )
+        {
+            pusWildcardChild = &( pxSubscriptionManager->xTopicNodes[ usNode ].usMultiLevelChild );
+            usChild = *pusWildcardChild;
+        }
+        else
+        {
+            usChild = prvFindChild( pxSubscriptionManager, usNode, &( pcFilter[ ulIndex ] ), usLevelLength, &ulSlot );
+        }
+
+        if( ( usChild == 0U ) &&
+            ( pxSubscriptionManager->usTopicNodeCount == SUBSCRIPTION_MANAGER_MAX_TOPIC_NODES ) )
+        {
+            LogError( ( "Not enough topic nodes to add topic filter %.*s.",
+                        ( int ) usFilterLength,
+                        pcFilter ) );
+            xAdded = false;
+        }
+        else if( usChild == 0U )
+        {
+            TopicNode_t * pxChild;
+
+            usChild = pxSubscriptionManager->usTopicNodeCount;
+            pxSubscriptionManager->usTopicNodeCount++;
+
+            pxChild = &( pxSubscriptionManager->xTopicNodes[ usChild ] );
+            memset( pxChild, 0x00, sizeof( TopicNode_t ) );
+            pxChild->usParent = usNode;
+            pxChild->usOwner = usIndex;
+            pxChild->usLevelOffset = ( uint16_t ) ulIndex;
+            pxChild->usLevelLength = usLevelLength;
+
+            if( pusWildcardChild != NULL )
+            {
+                *pusWildcardChild = usChild;
+            }
+            else
+            {
+                pxSubscriptionManager->usChildTable[ ulSlot ] = usChild;
+            }
+        }
+        else
+        {
+            /* The level is shared with another filter. */
+        }
+
+        usNode = usChild;
+        ulIndex += ( uint32_t ) usLevelLength + 1U;
+    }
+
+    if( xAdded == true )
+    {
+        pxSubscription->usNextOnTopicNode = pxSubscriptionManager->xTopicNodes[ usNode ].usFirstSubscription;
+        pxSubscriptionManager->xTopicNodes[ usNode ].usFirstSubscription = usIndex + 1U;
+    }
+
+    return xAdded;
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvRebuildTrie( SubscriptionManager_t * pxSubscriptionManager )
+{
+    uint16_t usIndex;
+
+    memset( pxSubscriptionManager->usChildTable, 0x00, sizeof( pxSubscriptionManager->usChildTable ) );
+    memset( &( pxSubscriptionManager->xTopicNodes[ 0 ] ), 0x00, sizeof( TopicNode_t ) );
+    pxSubscriptionManager->usTopicNodeCount = 1U;
+
+    for( usIndex = 0U; usIndex < SUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS; usIndex++ )
+    {
+        if( pxSubscriptionManager->xSubscriptionList[ usIndex ].usFilterStringLength != 0U )
+        {
+            /* These filters all fitted before, so they fit again. */
+            ( void ) prvInsertFilter( pxSubscriptionManager, usIndex );
+        }
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static bool prvInvokeCallbacks( SubscriptionManager_t * pxSubscriptionManager,
+                                uint16_t usNode,
+                                MQTTPublishInfo_t * pxPublishInfo )
+{
+    uint16_t usNext = pxSubscriptionManager->xTopicNodes[ usNode ].usFirstSubscription;
+    SubscriptionElement_t * pxSubscription;
+    bool publishHandled = false;
+
+    while( usNext != 0U )
+    {
+        pxSubscription = &( pxSubscriptionManager->xSubscriptionList[ usNext - 1U ] );
+        pxSubscription->pxIncomingPublishCallback( pxSubscription->pvIncomingPublishCallbackContext,
+                                                   pxPublishInfo );
+        publishHandled = true;
+        usNext = pxSubscription->usNextOnTopicNode;
+    }
+
+    return publishHandled;
+}
+
+/*-----------------------------------------------------------*/
 
-bool addSubscription( SubscriptionElement_t * pxSubscriptionList,
+
+bool addSubscription( SubscriptionManager_t * pxSubscriptionManager,
                       const char * pcTopicFilterString,
                       uint16_t usTopicFilterLength,
                       IncomingPubCallback_t pxIncomingPublishCallback,
@@ -45,21 +392,32 @@ bool addSubscription( SubscriptionElement_t * pxSubscriptionList,
     int32_t lIndex = 0;
     size_t xAvailableIndex = SUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS;
     bool xReturnStatus = false;
+    SubscriptionElement_t * pxSubscriptionList;
 
-    if( ( pxSubscriptionList == NULL ) ||
+    if( ( pxSubscriptionManager == NULL ) ||
         ( pcTopicFilterString == NULL ) ||
         ( usTopicFilterLength == 0U ) ||
         ( pxIncomingPublishCallback == NULL ) )
     {
-        LogError( ( "Invalid parameter. pxSubscriptionList=%p, pcTopicFilterString=%p,"
+        LogError( ( "Invalid parameter. pxSubscriptionManager=%p, pcTopicFilterString=%p,"
                     " usTopicFilterLength=%u, pxIncomingPublishCallback=%p.",
-                    pxSubscriptionList,
+                    pxSubscriptionManager,
                     pcTopicFilterString,
                     ( unsigned int ) usTopicFilterLength,
                     pxIncomingPublishCallback ) );
     }
+    else if( prvIsValidFilter( pcTopicFilterString, usTopicFilterLength ) == false )
+    {
+        LogError( ( "Invalid topic filter %.*s: wildcards must be whole levels, '#' must be"
+                    " the last level, and there may be at most %u levels.",
+                    ( int ) usTopicFilterLength,
+                    pcTopicFilterString,
+                    ( unsigned int ) SUBSCRIPTION_MANAGER_MAX_FILTER_LEVELS ) );
+    }
     else
     {
+        pxSubscriptionList = pxSubscriptionManager->xSubscriptionList;
+
         /* Start at end of array, so that we will insert at the first available index.
          * Scans backwards to find duplicates. */
         for( lIndex = ( int32_t ) SUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS - 1; lIndex >= 0; lIndex-- )
@@ -89,7 +447,14 @@ bool addSubscription( SubscriptionElement_t * pxSubscriptionList,
             pxSubscriptionList[ xAvailableIndex ].usFilterStringLength = usTopicFilterLength;
             pxSubscriptionList[ xAvailableIndex ].pxIncomingPublishCallback = pxIncomingPublishCallback;
             pxSubscriptionList[ xAvailableIndex ].pvIncomingPublishCallbackContext = pvIncomingPublishCallbackContext;
-            xReturnStatus = true;
+            xReturnStatus = prvInsertFilter( pxSubscriptionManager, ( uint16_t ) xAvailableIndex );
+
+            if( xReturnStatus == false )
+            {
+                /* Drop the subscription, and any levels it added to the trie. */
+                memset( &( pxSubscriptionList[ xAvailableIndex ] ), 0x00, sizeof( SubscriptionElement_t ) );
+                prvRebuildTrie( pxSubscriptionManager );
+            }
         }
     }
 
@@ -98,24 +463,28 @@ bool addSubscription( SubscriptionElement_t * pxSubscriptionList,
 
 /*-----------------------------------------------------------*/
 
-void removeSubscription( SubscriptionElement_t * pxSubscriptionList,
+void removeSubscription( SubscriptionManager_t * pxSubscriptionManager,
                          const char * pcTopicFilterString,
                          uint16_t usTopicFilterLength )
 {
     int32_t lIndex = 0;
+    bool xRemoved = false;
+    SubscriptionElement_t * pxSubscriptionList;
 
-    if( ( pxSubscriptionList == NULL ) ||
+    if( ( pxSubscriptionManager == NULL ) ||
         ( pcTopicFilterString == NULL ) ||
         ( usTopicFilterLength == 0U ) )
     {
-        LogError( ( "Invalid parameter. pxSubscriptionList=%p, pcTopicFilterString=%p,"
+        LogError( ( "Invalid parameter. pxSubscriptionManager=%p, pcTopicFilterString=%p,"
                     " usTopicFilterLength=%u.",
-                    pxSubscriptionList,
+                    pxSubscriptionManager,
                     pcTopicFilterString,
                     ( unsigned int ) usTopicFilterLength ) );
     }
     else
     {
+        pxSubscriptionList = pxSubscriptionManager->xSubscriptionList;
+
         for( lIndex = 0; lIndex < SUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS; lIndex++ )
         {
             if( pxSubscriptionList[ lIndex ].usFilterStringLength == usTopicFilterLength )
@@ -123,48 +492,121 @@ void removeSubscription( SubscriptionElement_t * pxSubscriptionList,
                 if( strncmp( pxSubscriptionList[ lIndex ].pcSubscriptionFilterString, pcTopicFilterString, usTopicFilterLength ) == 0 )
                 {
                     memset( &( pxSubscriptionList[ lIndex ] ), 0x00, sizeof( SubscriptionElement_t ) );
+                    xRemoved = true;
                 }
             }
         }
+
+        /* Unsubscribing is rare, so rather than reference count the levels of
+         * the trie, rebuild it from the remaining subscriptions. */
+        if( xRemoved == true )
+        {
+            prvRebuildTrie( pxSubscriptionManager );
+        }
     }
 }
 
 /*-----------------------------------------------------------*/
 
-bool handleIncomingPublishes( SubscriptionElement_t * pxSubscriptionList,
+bool handleIncomingPublishes( SubscriptionManager_t * pxSubscriptionManager,
                               MQTTPublishInfo_t * pxPublishInfo )
 {
-    int32_t lIndex = 0;
-    bool isMatched = false, publishHandled = false;
+    /* Each node visited adds at most two nodes a level deeper, one of
+     * which is visited next, so one pending node per level suffices. */
+    TopicMatch_t xStack[ SUBSCRIPTION_MANAGER_MAX_FILTER_LEVELS + 1U ];
+    uint32_t ulStackDepth = 0U;
+    TopicMatch_t xMatch;
+    const TopicNode_t * pxNode;
+    const char * pcTopic;
+    uint16_t usTopicLength, usLevelLength, usChild;
+    uint32_t ulSlot;
+    bool publishHandled = false, xIsRoot;
 
-    if( ( pxSubscriptionList == NULL ) ||
+    if( ( pxSubscriptionManager == NULL ) ||
         ( pxPublishInfo == NULL ) )
     {
-        LogError( ( "Invalid parameter. pxSubscriptionList=%p, pxPublishInfo=%p,",
-                    pxSubscriptionList,
+        LogError( ( "Invalid parameter. pxSubscriptionManager=%p, pxPublishInfo=%p,",
+                    pxSubscriptionManager,
                     pxPublishInfo ) );
     }
-    else
+    else if( ( pxSubscriptionManager->usTopicNodeCount != 0U ) &&
+             ( pxPublishInfo->pTopicName != NULL ) &&
+             ( pxPublishInfo->topicNameLength != 0U ) )
     {
-        for( lIndex = 0; lIndex < SUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS; lIndex++ )
+        pcTopic = pxPublishInfo->pTopicName;
+        usTopicLength = pxPublishInfo->topicNameLength;
+
+        /* Start at the root, with the whole topic to match. */
+        xStack[ 0 ].usNode = 0U;
+        xStack[ 0 ].ulTopicIndex = 0U;
+        ulStackDepth = 1U;
+
+        while( ulStackDepth > 0U )
         {
-            if( pxSubscriptionList[ lIndex ].usFilterStringLength > 0 )
+            ulStackDepth--;
+            xMatch = xStack[ ulStackDepth ];
+            pxNode = &( pxSubscriptionManager->xTopicNodes[ xMatch.usNode ] );
+            xIsRoot = ( xMatch.usNode == 0U );
+
+            /* Topic names starting with '$' are not matched by filters
+             * starting with a wildcard. */
+            if( ( xIsRoot == true ) && ( pcTopic[ 0 ] == '$' ) )
+            {
+                /* Only literal levels are followed from the root. */
+            }
+            else if( pxNode->usMultiLevelChild != 0U )
+            {
+                /* '#' matches the remaining levels, or none, as "sport/#"
+                 * matches "sport". */
+                if( prvInvokeCallbacks( pxSubscriptionManager, pxNode->usMultiLevelChild, pxPublishInfo ) == true )
+                {
+                    publishHandled = true;
+                }
+            }
+            else
             {
-                MQTT_MatchTopic( pxPublishInfo->pTopicName,
-                                 pxPublishInfo->topicNameLength,
-                                 pxSubscriptionList[ lIndex ].pcSubscriptionFilterString,
-                                 pxSubscriptionList[ lIndex ].usFilterStringLength,
-                                 &isMatched );
+                /* No multi-level wildcard below this level. */
+            }
 
-                if( isMatched == true )
+            if( xMatch.ulTopicIndex > usTopicLength )
+            {
+                /* Every level of the topic has been matched. */
+                if( prvInvokeCallbacks( pxSubscriptionManager, xMatch.usNode, pxPublishInfo ) == true )
                 {
-                    pxSubscriptionList[ lIndex ].pxIncomingPublishCallback( pxSubscriptionList[ lIndex ].pvIncomingPublishCallbackContext,
-                                                                            pxPublishInfo );
                     publishHandled = true;
                 }
             }
+            else
+            {
+                usLevelLength = prvLevelLength( pcTopic, usTopicLength, ( uint16_t ) xMatch.ulTopicIndex );
+
+                usChild = prvFindChild( pxSubscriptionManager,
+                                        xMatch.usNode,
+                                        &( pcTopic[ xMatch.ulTopicIndex ] ),
+                                        usLevelLength,
+                                        &ulSlot );
+
+                if( usChild != 0U )
+                {
+                    xStack[ ulStackDepth ].usNode = usChild;
+                    xStack[ ulStackDepth ].ulTopicIndex = xMatch.ulTopicIndex + usLevelLength + 1U;
+                    ulStackDepth++;
+                }
+
+                if( ( pxNode->usSingleLevelChild != 0U ) &&
+                    !( ( xIsRoot == true ) && ( pcTopic[ 0 ] == '$' ) ) )
+                {
+                    xStack[ ulStackDepth ].usNode = pxNode->usSingleLevelChild;
+                    xStack[ ulStackDepth ].ulTopicIndex = xMatch.ulTopicIndex + usLevelLength + 1U;
+                    ulStackDepth++;
+                }
+            }
         }
     }
+    else
+    {
+        /* Nothing is subscribed, or there is no topic to match. */
+    }
 
     return publishHandled;
 }
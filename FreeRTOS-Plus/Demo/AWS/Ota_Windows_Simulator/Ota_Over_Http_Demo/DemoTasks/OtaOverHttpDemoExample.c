@@ -577,15 +577,14 @@ static TlsTransportParams_t xTlsTransportParams;
 static TlsTransportParams_t xTlsTransportParamsHttps;
 
 /**
- * @brief The global array of subscription elements.
+ * @brief The global subscription manager.
  *
- * @note No thread safety is required to this array, since the updates the array
- * elements are done only from one task at a time. The subscription manager
- * implementation expects that the array of the subscription elements used for
- * storing subscriptions to be initialized to 0. As this is a global array, it
- * will be initialized to 0 by default.
+ * @note No thread safety is required to this structure, since it is updated
+ * only from one task at a time. The subscription manager implementation expects
+ * that the structure used for storing subscriptions to be initialized to 0. As
+ * this is a global variable, it will be initialized to 0 by default.
  */
-static SubscriptionElement_t xGlobalSubscriptionList[ SUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS ];
+static SubscriptionManager_t xGlobalSubscriptionManager;
 
 /**
  * @brief Buffer used to store the firmware image file path.
@@ -1258,7 +1257,7 @@ static void prvIncomingPublishCallback( MQTTAgentContext_t * pMqttAgentContext,
 
     /* Fan out the incoming publishes to the callbacks registered using
      * subscription manager. */
-    xPublishHandled = handleIncomingPublishes( ( SubscriptionElement_t * ) pMqttAgentContext->pIncomingCallbackContext,
+    xPublishHandled = handleIncomingPublishes( ( SubscriptionManager_t * ) pMqttAgentContext->pIncomingCallbackContext,
                                                pxPublishInfo );
 
     /* If there are no callbacks to handle the incoming publishes,
@@ -1299,7 +1298,7 @@ static void prvSubscriptionCommandCallback( void * pxCommandContext,
                             pxSubscribeArgs->pSubscribeInfo[ xIndex ].topicFilterLength,
                             pxSubscribeArgs->pSubscribeInfo[ xIndex ].pTopicFilter ) );
                 /* Remove subscription callback for unsubscribe. */
-                removeSubscription( xGlobalSubscriptionList,
+                removeSubscription( &xGlobalSubscriptionManager,
                                     pxSubscribeArgs->pSubscribeInfo[ xIndex ].pTopicFilter,
                                     pxSubscribeArgs->pSubscribeInfo[ xIndex ].topicFilterLength );
             }
@@ -1332,10 +1331,10 @@ static MQTTStatus_t prvHandleResubscribe( void )
     {
         /* Check if there is a subscription in the subscription list. This demo
          * doesn't check for duplicate subscriptions. */
-        if( xGlobalSubscriptionList[ ulIndex ].usFilterStringLength != 0 )
+        if( xGlobalSubscriptionManager.xSubscriptionList[ ulIndex ].usFilterStringLength != 0 )
         {
-            xSubInfo[ usNumSubscriptions ].pTopicFilter = xGlobalSubscriptionList[ ulIndex ].pcSubscriptionFilterString;
-            xSubInfo[ usNumSubscriptions ].topicFilterLength = xGlobalSubscriptionList[ ulIndex ].usFilterStringLength;
+            xSubInfo[ usNumSubscriptions ].pTopicFilter = xGlobalSubscriptionManager.xSubscriptionList[ ulIndex ].pcSubscriptionFilterString;
+            xSubInfo[ usNumSubscriptions ].topicFilterLength = xGlobalSubscriptionManager.xSubscriptionList[ ulIndex ].usFilterStringLength;
 
             /* QoS1 is used for all the subscriptions in this demo. */
             xSubInfo[ usNumSubscriptions ].qos = MQTTQoS1;
@@ -1404,7 +1403,7 @@ static void prvRegisterOTACallback( const char * pTopicFilter,
         if( isMatch )
         {
             /* Add subscription so that incoming publishes are routed to the application callback. */
-            subscriptionAdded = addSubscription( ( SubscriptionElement_t * ) xGlobalMqttAgentContext.pIncomingCallbackContext,
+            subscriptionAdded = addSubscription( ( SubscriptionManager_t * ) xGlobalMqttAgentContext.pIncomingCallbackContext,
                                                  pTopicFilter,
                                                  topicFilterLength,
                                                  otaTopicFilterCallbacks[ index ].callback,
@@ -1587,8 +1586,8 @@ static MQTTStatus_t prvMQTTInit( void )
                               &xTransport,
                               prvGetTimeMs,
                               prvIncomingPublishCallback,
-                              /* Context to pass into the callback. Passing the pointer to subscription array. */
-                              xGlobalSubscriptionList );
+                              /* Context to pass into the callback. Passing the pointer to subscription manager. */
+                              &xGlobalSubscriptionManager );
 
     return xReturn;
 }
@@ -2281,6 +2280,7 @@ static void setOtaInterfaces( OtaInterfaces_t * pOtaInterfaces )
     pOtaInterfaces->pal.reset = otaPal_ResetDevice;
     pOtaInterfaces->pal.abort = otaPal_Abort;
     pOtaInterfaces->pal.createFile = otaPal_CreateFileForRx;
+    pOtaInterfaces->pal.updateDigest = otaPal_UpdateDigest;
 }
 
 /*-----------------------------------------------------------*/
@@ -2504,7 +2504,7 @@ static BaseType_t prvRunOTADemo( void )
      * Remvove callback for receiving messages intended for OTA agent from broker,
      * for which the topic has not been subscribed for.
      */
-    removeSubscription( ( SubscriptionElement_t * ) xGlobalMqttAgentContext.pIncomingCallbackContext,
+    removeSubscription( ( SubscriptionManager_t * ) xGlobalMqttAgentContext.pIncomingCallbackContext,
                         OTA_DEFAULT_TOPIC_FILTER,
                         OTA_DEFAULT_TOPIC_FILTER_LENGTH );
 
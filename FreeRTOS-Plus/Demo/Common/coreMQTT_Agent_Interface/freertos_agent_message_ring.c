@@ -0,0 +1,255 @@
+/*
+ * FreeRTOS V202212.01
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+
+/**
+ * @file freertos_agent_message_ring.c
+ * @brief Implements a lock-free multiple producer, single consumer ring of
+ * commands for the agent.
+ *
+ * Senders claim a position in the ring by advancing writeIndex with a
+ * compare-and-swap, then store the command pointer in the slot of that
+ * position. The agent task takes the pointer from the slot at readIndex, and
+ * only then advances readIndex, so a slot is empty again by the time a sender
+ * can claim its position for the next lap of the ring. A slot that has been
+ * claimed but not yet written reads as NULL, so the agent treats the ring as
+ * empty until the sender completes.
+ *
+ * The kernel is only involved when a task has to block: the agent waits on a
+ * task notification when the ring is empty, and senders wait on a counting
+ * semaphore when it is full. The agent gives the semaphore once for each slot
+ * it frees while senders wait, so that every freed slot can wake a sender.
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+/* Header include. */
+#include "freertos_agent_message_ring.h"
+
+#if ( agentMESSAGE_RING_USE_CRITICAL_SECTIONS != 0 )
+
+/* atomic.h falls back to critical sections on ports that cannot mask
+ * interrupts from an ISR. */
+    #undef portSET_INTERRUPT_MASK_FROM_ISR
+    #undef portCLEAR_INTERRUPT_MASK_FROM_ISR
+#endif
+
+#include "atomic.h"
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Take the command at the read position of the ring, if it has been
+ * written.
+ *
+ * @param[in] pMsgCtx The ring to read.
+ *
+ * @return The command, or NULL if there is none.
+ */
+static MQTTAgentCommand_t * prvTakeCommand( MQTTAgentMessageContext_t * pMsgCtx );
+
+/*-----------------------------------------------------------*/
+
+static MQTTAgentCommand_t * prvTakeCommand( MQTTAgentMessageContext_t * pMsgCtx )
+{
+    const uint32_t readIndex = pMsgCtx->readIndex;
+    MQTTAgentCommand_t * volatile * pSlot = &( pMsgCtx->pSlots[ readIndex & pMsgCtx->slotMask ] );
+    MQTTAgentCommand_t * pCommand = *pSlot;
+
+    if( pCommand != NULL )
+    {
+        /* Only the agent empties slots and advances readIndex, so neither
+         * needs an atomic operation, but the slot must be empty before its
+         * position is freed for senders. */
+        *pSlot = NULL;
+        portMEMORY_BARRIER();
+        pMsgCtx->readIndex = readIndex + 1U;
+        portMEMORY_BARRIER();
+
+        if( pMsgCtx->sendersWaiting != 0U )
+        {
+            ( void ) xSemaphoreGive( pMsgCtx->freeSlotSemaphore );
+        }
+    }
+
+    return pCommand;
+}
+
+/*-----------------------------------------------------------*/
+
+bool Agent_MessageRingInit( MQTTAgentMessageContext_t * pMsgCtx,
+                            MQTTAgentCommand_t ** pSlots,
+                            uint32_t slotCount )
+{
+    configASSERT( pMsgCtx != NULL );
+    configASSERT( pSlots != NULL );
+    configASSERT( ( slotCount != 0U ) && ( ( slotCount & ( slotCount - 1U ) ) == 0U ) );
+
+    memset( ( void * ) pSlots, 0x00, slotCount * sizeof( MQTTAgentCommand_t * ) );
+    pMsgCtx->pSlots = pSlots;
+    pMsgCtx->slotMask = slotCount - 1U;
+    pMsgCtx->writeIndex = 0U;
+    pMsgCtx->readIndex = 0U;
+    pMsgCtx->agentWaiting = 0U;
+    pMsgCtx->agentTask = NULL;
+    pMsgCtx->sendersWaiting = 0U;
+    pMsgCtx->freeSlotSemaphore = xSemaphoreCreateCounting( slotCount, 0U );
+
+    return ( pMsgCtx->freeSlotSemaphore != NULL ) ? true : false;
+}
+
+/*-----------------------------------------------------------*/
+
+bool Agent_MessageRingSend( MQTTAgentMessageContext_t * pMsgCtx,
+                            MQTTAgentCommand_t * const * pCommandToSend,
+                            uint32_t blockTimeMs )
+{
+    TimeOut_t xTimeOut;
+    TickType_t xTicksToWait = pdMS_TO_TICKS( blockTimeMs );
+    BaseType_t xTimedOut = pdFALSE;
+    bool timeOutSet = false;
+    bool slotClaimed = false;
+    uint32_t writeIndex = 0U;
+
+    if( ( pMsgCtx != NULL ) && ( pCommandToSend != NULL ) && ( *pCommandToSend != NULL ) )
+    {
+        while( ( slotClaimed == false ) && ( xTimedOut == pdFALSE ) )
+        {
+            writeIndex = pMsgCtx->writeIndex;
+
+            if( ( writeIndex - pMsgCtx->readIndex ) <= pMsgCtx->slotMask )
+            {
+                slotClaimed = ( Atomic_CompareAndSwap_u32( &( pMsgCtx->writeIndex ),
+                                                           writeIndex + 1U,
+                                                           writeIndex ) == ATOMIC_COMPARE_AND_SWAP_SUCCESS );
+            }
+            else if( xTicksToWait == 0U )
+            {
+                xTimedOut = pdTRUE;
+            }
+            else
+            {
+                /* The ring is full. Announce the wait before checking the ring
+                 * again, so that the agent either sees the count and gives the
+                 * semaphore, or has freed a slot in time for the check. */
+                if( timeOutSet == false )
+                {
+                    vTaskSetTimeOutState( &xTimeOut );
+                    timeOutSet = true;
+                }
+
+                ( void ) Atomic_Increment_u32( &( pMsgCtx->sendersWaiting ) );
+
+                if( ( pMsgCtx->writeIndex - pMsgCtx->readIndex ) > pMsgCtx->slotMask )
+                {
+                    ( void ) xSemaphoreTake( pMsgCtx->freeSlotSemaphore, xTicksToWait );
+                }
+
+                ( void ) Atomic_Decrement_u32( &( pMsgCtx->sendersWaiting ) );
+                xTimedOut = xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait );
+            }
+        }
+    }
+
+    if( slotClaimed == true )
+    {
+        /* The claimed slot belongs to this task until the agent reads it. */
+        pMsgCtx->pSlots[ writeIndex & pMsgCtx->slotMask ] = *pCommandToSend;
+        portMEMORY_BARRIER();
+
+        /* Only wake the agent if it is waiting, which saves the notification
+         * when the agent is busy draining the ring. */
+        if( ( pMsgCtx->agentWaiting != 0U ) &&
+            ( Atomic_AND_u32( &( pMsgCtx->agentWaiting ), 0U ) != 0U ) )
+        {
+            ( void ) xTaskNotifyGiveIndexed( pMsgCtx->agentTask, agentMESSAGE_RING_NOTIFICATION_INDEX );
+        }
+    }
+
+    return slotClaimed;
+}
+
+/*-----------------------------------------------------------*/
+
+bool Agent_MessageRingReceive( MQTTAgentMessageContext_t * pMsgCtx,
+                               MQTTAgentCommand_t ** pReceivedCommand,
+                               uint32_t blockTimeMs )
+{
+    TimeOut_t xTimeOut;
+    TickType_t xTicksToWait = pdMS_TO_TICKS( blockTimeMs );
+    BaseType_t xTimedOut = pdFALSE;
+    MQTTAgentCommand_t * pCommand = NULL;
+
+    if( ( pMsgCtx != NULL ) && ( pReceivedCommand != NULL ) )
+    {
+        pCommand = prvTakeCommand( pMsgCtx );
+
+        if( ( pCommand == NULL ) && ( xTicksToWait != 0U ) )
+        {
+            vTaskSetTimeOutState( &xTimeOut );
+            pMsgCtx->agentTask = xTaskGetCurrentTaskHandle();
+        }
+        else
+        {
+            xTimedOut = pdTRUE;
+        }
+
+        while( ( pCommand == NULL ) && ( xTimedOut == pdFALSE ) )
+        {
+            /* Announce the wait before checking the ring again, so that a
+             * sender either sees the flag and notifies, or has stored its
+             * command in time for the check. */
+            ( void ) Atomic_OR_u32( &( pMsgCtx->agentWaiting ), 1U );
+            pCommand = prvTakeCommand( pMsgCtx );
+
+            if( pCommand == NULL )
+            {
+                ( void ) ulTaskNotifyTakeIndexed( agentMESSAGE_RING_NOTIFICATION_INDEX, pdTRUE, xTicksToWait );
+                pCommand = prvTakeCommand( pMsgCtx );
+            }
+
+            pMsgCtx->agentWaiting = 0U;
+
+            if( pCommand == NULL )
+            {
+                xTimedOut = xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait );
+            }
+        }
+    }
+
+    if( pCommand != NULL )
+    {
+        *pReceivedCommand = pCommand;
+    }
+
+    return ( pCommand != NULL ) ? true : false;
+}
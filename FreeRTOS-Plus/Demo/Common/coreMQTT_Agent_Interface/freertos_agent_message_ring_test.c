@@ -0,0 +1,328 @@
+/*
+ * FreeRTOS V202212.01
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/**
+ * @file freertos_agent_message_ring_test.c
+ * @brief Tests the agent message ring with several tasks sending at once.
+ *
+ * Several sending tasks pass numbered commands through a ring with fewer slots
+ * than senders to a single receiving task, which stands in for the agent. The
+ * test runs in rounds, and each command a sender sends is requested by a
+ * notification from the receiver. In each round the receiver:
+ *
+ * 1. Requests one command and waits for it on the empty ring.
+ * 2. Requests a command from every sender, then waits until the ring is full
+ *    and the remaining senders wait for a free slot.
+ * 3. Frees every slot at once. The receiver runs above the senders, so none of
+ *    them runs until it has freed them all.
+ * 4. Waits until the ring holds the commands of all the waiting senders, which
+ *    only happens if each freed slot woke a sender.
+ * 5. Receives the rest of the commands.
+ *
+ * The receiver also checks that the commands of each sender arrive once and in
+ * order.
+ */
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Header includes. */
+#include "freertos_agent_message_ring.h"
+#include "freertos_agent_message_ring_test.h"
+
+/**
+ * @brief Number of sending tasks.
+ */
+#define ringtestNUM_SENDERS              ( 4U )
+
+/**
+ * @brief Number of slots of the ring, fewer than the senders so that senders
+ * wait for a free slot together.
+ */
+#define ringtestNUM_SLOTS                ( 2U )
+
+/**
+ * @brief Number of senders left waiting for a free slot when every sender has
+ * sent to an empty ring.
+ */
+#define ringtestNUM_WAITING              ( ringtestNUM_SENDERS - ringtestNUM_SLOTS )
+
+/**
+ * @brief Number of commands owned by each sender. A sender sends at most two
+ * commands in a round and the receiver takes all of them before the next
+ * round, so two would do.
+ *
+ * The ring never looks into the commands, so each command is a number that
+ * holds the index of its sender and its sequence number.
+ */
+#define ringtestCOMMANDS_PER_SENDER      ( 2U )
+
+/**
+ * @brief Time to block on the ring, or to wait for the ring to reach the state
+ * expected by a step of the round. Taking this long is an error.
+ */
+#define ringtestBLOCK_TIME_MS            ( 2000U )
+
+/**
+ * @brief Bits of a command that hold the sequence number, the other bits hold
+ * the index of the sender.
+ */
+#define ringtestSEQUENCE_BITS            ( 24U )
+#define ringtestSEQUENCE_MASK            ( ( 1UL << ringtestSEQUENCE_BITS ) - 1UL )
+
+#define ringtestSTACK_SIZE               ( configMINIMAL_STACK_SIZE )
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The task that requests the commands, receives them and checks their
+ * order.
+ */
+static void prvReceiverTask( void * pvParameters );
+
+/**
+ * @brief A task that sends a numbered command each time it is notified.
+ *
+ * @param[in] pvParameters The index of the sender.
+ */
+static void prvSenderTask( void * pvParameters );
+
+/**
+ * @brief Receive a command and check it is the next one from its sender.
+ *
+ * @param[in] pulExpected The next sequence number expected from each sender.
+ */
+static void prvReceiveCommand( uint32_t * pulExpected );
+
+/**
+ * @brief Wait until the ring holds a number of claimed slots while a number of
+ * senders wait for a free slot.
+ *
+ * The fields of the ring are read directly, as the ring has no API to query
+ * them.
+ *
+ * @param[in] ulClaimed The number of claimed slots to wait for.
+ * @param[in] ulWaiting The number of waiting senders to wait for.
+ *
+ * @return pdTRUE if the ring reached the state, or pdFALSE if it did not
+ * within ringtestBLOCK_TIME_MS.
+ */
+static BaseType_t prvWaitForRingState( uint32_t ulClaimed,
+                                       uint32_t ulWaiting );
+
+/*-----------------------------------------------------------*/
+
+static MQTTAgentMessageContext_t xRing;
+static MQTTAgentCommand_t * pxSlots[ ringtestNUM_SLOTS ];
+static uint32_t ulCommands[ ringtestNUM_SENDERS ][ ringtestCOMMANDS_PER_SENDER ];
+static TaskHandle_t xSenderTasks[ ringtestNUM_SENDERS ];
+
+/* Latched to pdTRUE if an error is detected. */
+static volatile BaseType_t xErrorDetected = pdFALSE;
+
+/* Incremented for each command received, to detect a stalled test. */
+static volatile uint32_t ulReceivedCount = 0U;
+
+/*-----------------------------------------------------------*/
+
+void vStartAgentMessageRingTasks( UBaseType_t uxPriority )
+{
+    UBaseType_t uxSender;
+
+    if( Agent_MessageRingInit( &xRing, pxSlots, ringtestNUM_SLOTS ) == true )
+    {
+        /* The senders are created first, as the receiver notifies them. */
+        for( uxSender = 0; uxSender < ringtestNUM_SENDERS; uxSender++ )
+        {
+            xTaskCreate( prvSenderTask,
+                         "RingTx",
+                         ringtestSTACK_SIZE,
+                         ( void * ) uxSender,
+                         uxPriority,
+                         &( xSenderTasks[ uxSender ] ) );
+        }
+
+        xTaskCreate( prvReceiverTask, "RingRx", ringtestSTACK_SIZE, NULL, uxPriority + 1U, NULL );
+    }
+    else
+    {
+        xErrorDetected = pdTRUE;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvReceiverTask( void * pvParameters )
+{
+    uint32_t ulExpected[ ringtestNUM_SENDERS ] = { 0 };
+    uint32_t ulRound = 0U;
+    uint32_t ulSender;
+    uint32_t ulCommand;
+
+    ( void ) pvParameters;
+
+    for( ; ; )
+    {
+        /* 1. Wait on the empty ring for a single sender. */
+        xTaskNotifyGive( xSenderTasks[ ulRound % ringtestNUM_SENDERS ] );
+        prvReceiveCommand( ulExpected );
+
+        /* 2. Fill the ring and leave the other senders waiting. */
+        for( ulSender = 0U; ulSender < ringtestNUM_SENDERS; ulSender++ )
+        {
+            xTaskNotifyGive( xSenderTasks[ ulSender ] );
+        }
+
+        if( prvWaitForRingState( ringtestNUM_SLOTS, ringtestNUM_WAITING ) == pdFALSE )
+        {
+            xErrorDetected = pdTRUE;
+        }
+
+        /* 3. Free every slot before a sender can run. */
+        for( ulCommand = 0U; ulCommand < ringtestNUM_SLOTS; ulCommand++ )
+        {
+            prvReceiveCommand( ulExpected );
+        }
+
+        /* 4. Each freed slot must have woken a waiting sender. */
+        if( prvWaitForRingState( ringtestNUM_WAITING, 0U ) == pdFALSE )
+        {
+            xErrorDetected = pdTRUE;
+        }
+
+        /* 5. Empty the ring for the next round. */
+        for( ulCommand = 0U; ulCommand < ringtestNUM_WAITING; ulCommand++ )
+        {
+            prvReceiveCommand( ulExpected );
+        }
+
+        ulRound++;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvReceiveCommand( uint32_t * pulExpected )
+{
+    MQTTAgentCommand_t * pxCommand = NULL;
+    uint32_t ulCommand;
+    uint32_t ulSender;
+
+    /* A sender may have claimed a slot but not yet written it, so block
+     * rather than poll. */
+    if( Agent_MessageRingReceive( &xRing, &pxCommand, ringtestBLOCK_TIME_MS ) == true )
+    {
+        ulCommand = *( ( const uint32_t * ) pxCommand );
+        ulSender = ulCommand >> ringtestSEQUENCE_BITS;
+
+        if( ( ulSender >= ringtestNUM_SENDERS ) ||
+            ( ( ulCommand & ringtestSEQUENCE_MASK ) != pulExpected[ ulSender ] ) )
+        {
+            xErrorDetected = pdTRUE;
+        }
+        else
+        {
+            pulExpected[ ulSender ] = ( pulExpected[ ulSender ] + 1U ) & ringtestSEQUENCE_MASK;
+            ulReceivedCount++;
+        }
+    }
+    else
+    {
+        xErrorDetected = pdTRUE;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvWaitForRingState( uint32_t ulClaimed,
+                                       uint32_t ulWaiting )
+{
+    TickType_t xTicksWaited = 0U;
+    BaseType_t xReturn = pdFALSE;
+
+    /* The senders run below this task, so give them time to run until the
+     * ring reaches the state. */
+    while( ( xReturn == pdFALSE ) && ( xTicksWaited < pdMS_TO_TICKS( ringtestBLOCK_TIME_MS ) ) )
+    {
+        vTaskDelay( 1U );
+        xTicksWaited++;
+
+        if( ( ( xRing.writeIndex - xRing.readIndex ) == ulClaimed ) &&
+            ( xRing.sendersWaiting == ulWaiting ) )
+        {
+            xReturn = pdTRUE;
+        }
+    }
+
+    return xReturn;
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvSenderTask( void * pvParameters )
+{
+    const uint32_t ulSender = ( uint32_t ) ( uintptr_t ) pvParameters;
+    uint32_t * pulCommand;
+    MQTTAgentCommand_t * pxCommand;
+    uint32_t ulSequence = 0U;
+
+    for( ; ; )
+    {
+        /* Send one command for each notification from the receiver. */
+        ( void ) ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+
+        pulCommand = &( ulCommands[ ulSender ][ ulSequence % ringtestCOMMANDS_PER_SENDER ] );
+        *pulCommand = ( ulSender << ringtestSEQUENCE_BITS ) | ulSequence;
+        pxCommand = ( MQTTAgentCommand_t * ) pulCommand;
+
+        if( Agent_MessageRingSend( &xRing, &pxCommand, ringtestBLOCK_TIME_MS ) == true )
+        {
+            ulSequence = ( ulSequence + 1U ) & ringtestSEQUENCE_MASK;
+        }
+        else
+        {
+            xErrorDetected = pdTRUE;
+        }
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xAreAgentMessageRingTasksStillRunning( void )
+{
+    static uint32_t ulLastReceivedCount = 0U;
+    BaseType_t xReturn = pdTRUE;
+
+    if( ( xErrorDetected != pdFALSE ) || ( ulReceivedCount == ulLastReceivedCount ) )
+    {
+        xReturn = pdFALSE;
+    }
+
+    ulLastReceivedCount = ulReceivedCount;
+
+    return xReturn;
+}
@@ -0,0 +1,149 @@
+/*
+ * FreeRTOS V202212.01
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+
+/**
+ * @file freertos_agent_message_ring.h
+ * @brief Functions to pass commands to the agent through a lock-free ring.
+ *
+ * This is an alternative to freertos_agent_message.h for the agent command
+ * queue. Any number of tasks may send commands, but only the agent task may
+ * receive them. Sending a command claims a slot of the ring with a single
+ * compare-and-swap, and wakes the agent task with a direct to task
+ * notification only if the agent is blocked waiting for a command.
+ *
+ * @note The command pool in freertos_command_pool.c keeps its own queue based
+ * context, as commands are obtained from the pool by any task. Do not include
+ * this header and freertos_agent_message.h in the same source file, as both
+ * define struct MQTTAgentMessageContext.
+ *
+ * @note The ring relies on the functions of atomic.h being atomic with respect
+ * to other tasks. On ports where masking interrupts from an ISR does not stop
+ * the scheduler, such as the POSIX and Windows simulator ports, set
+ * #agentMESSAGE_RING_USE_CRITICAL_SECTIONS to 1.
+ */
+#ifndef FREERTOS_AGENT_MESSAGE_RING_H
+#define FREERTOS_AGENT_MESSAGE_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+/* Include MQTT agent messaging interface. */
+#include "core_mqtt_agent_message_interface.h"
+
+/**
+ * @brief The index of the task notification used to wake the agent task when
+ * a command is sent.
+ */
+#ifndef agentMESSAGE_RING_NOTIFICATION_INDEX
+    #define agentMESSAGE_RING_NOTIFICATION_INDEX    ( tskDEFAULT_INDEX_TO_NOTIFY )
+#endif
+
+/**
+ * @brief Set to 1 to make the atomic operations of the ring use critical
+ * sections instead of masking interrupts.
+ *
+ * The functions of atomic.h mask interrupts with portSET_INTERRUPT_MASK_FROM_ISR().
+ * On the POSIX and Windows simulator ports that does nothing when called from a
+ * task, so the ring must use critical sections there.
+ */
+#ifndef agentMESSAGE_RING_USE_CRITICAL_SECTIONS
+    #define agentMESSAGE_RING_USE_CRITICAL_SECTIONS    ( 0 )
+#endif
+
+/**
+ * @ingroup mqtt_agent_struct_types
+ * @brief Context with which tasks may deliver messages to the agent.
+ */
+struct MQTTAgentMessageContext
+{
+    MQTTAgentCommand_t * volatile * pSlots; /**< Slots of the ring, NULL while empty. */
+    uint32_t slotMask;                      /**< Number of slots minus one. */
+    volatile uint32_t writeIndex;           /**< Position of the next slot claimed by a sender. */
+    volatile uint32_t readIndex;            /**< Position of the next slot read by the agent. */
+    volatile uint32_t agentWaiting;         /**< Non-zero while the agent task waits for a notification. */
+    volatile TaskHandle_t agentTask;        /**< The task receiving commands. */
+    volatile uint32_t sendersWaiting;       /**< Number of senders waiting for a free slot. */
+    SemaphoreHandle_t freeSlotSemaphore;    /**< Counting semaphore given by the agent for each slot it frees while senders wait. */
+};
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Initialize a ring to hold commands sent to the agent. Not thread safe.
+ *
+ * @param[in] pMsgCtx The #MQTTAgentMessageContext_t to initialize.
+ * @param[in] pSlots Storage for the ring, which must remain valid while the
+ * ring is in use.
+ * @param[in] slotCount Number of elements of @p pSlots. Must be a power of two.
+ *
+ * @return `true` if the ring was initialized, else `false` if the semaphore
+ * used by senders to wait for a free slot could not be created.
+ *
+ * @note The semaphore is a counting semaphore, so configUSE_COUNTING_SEMAPHORES
+ * must be set to 1.
+ */
+bool Agent_MessageRingInit( MQTTAgentMessageContext_t * pMsgCtx,
+                            MQTTAgentCommand_t ** pSlots,
+                            uint32_t slotCount );
+
+/**
+ * @brief Send a message to the agent through the ring.
+ * Thread safe, but must not be called from an interrupt.
+ *
+ * @param[in] pMsgCtx An #MQTTAgentMessageContext_t initialized with
+ * Agent_MessageRingInit().
+ * @param[in] pCommandToSend Pointer to address to send to the ring.
+ * @param[in] blockTimeMs Block time to wait for a free slot if the ring is full.
+ *
+ * @return `true` if send was successful, else `false`.
+ */
+bool Agent_MessageRingSend( MQTTAgentMessageContext_t * pMsgCtx,
+                            MQTTAgentCommand_t * const * pCommandToSend,
+                            uint32_t blockTimeMs );
+
+/**
+ * @brief Receive a message from the ring.
+ * Must only be called by the agent task.
+ *
+ * @param[in] pMsgCtx An #MQTTAgentMessageContext_t initialized with
+ * Agent_MessageRingInit().
+ * @param[in] pReceivedCommand Pointer to write address of received command.
+ * @param[in] blockTimeMs Block time to wait for a receive.
+ *
+ * @return `true` if receive was successful, else `false`.
+ */
+bool Agent_MessageRingReceive( MQTTAgentMessageContext_t * pMsgCtx,
+                               MQTTAgentCommand_t ** pReceivedCommand,
+                               uint32_t blockTimeMs );
+
+#endif /* FREERTOS_AGENT_MESSAGE_RING_H */
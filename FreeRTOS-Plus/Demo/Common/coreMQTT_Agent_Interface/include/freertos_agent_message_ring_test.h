@@ -0,0 +1,52 @@
+/*
+ * FreeRTOS V202212.01
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/**
+ * @file freertos_agent_message_ring_test.h
+ * @brief Tasks that test the agent message ring with several senders, in the
+ * style of the standard demo tasks.
+ */
+#ifndef FREERTOS_AGENT_MESSAGE_RING_TEST_H
+#define FREERTOS_AGENT_MESSAGE_RING_TEST_H
+
+/**
+ * @brief Create the receiving task and the sending tasks of the test.
+ *
+ * @param[in] uxPriority Priority of the sending tasks. The receiving task runs
+ * one priority above them.
+ */
+void vStartAgentMessageRingTasks( UBaseType_t uxPriority );
+
+/**
+ * @brief Check the test tasks.
+ *
+ * @return pdTRUE if commands were received since the last call and every
+ * command so far was received once, in order and without the ring stalling,
+ * else pdFALSE.
+ */
+BaseType_t xAreAgentMessageRingTasksStillRunning( void );
+
+#endif /* FREERTOS_AGENT_MESSAGE_RING_TEST_H */
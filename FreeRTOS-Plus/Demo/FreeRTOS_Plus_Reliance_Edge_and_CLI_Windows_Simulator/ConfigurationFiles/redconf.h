@@ -77,6 +77,10 @@
 
 #define REDCONF_BUFFER_COUNT 12U
 
+#define REDCONF_WRITEBACK_BLOCKS 4U
+
+#define REDCONF_READAHEAD_BLOCKS 3U
+
 #define RedMemCpyUnchecked memcpy
 
 #define RedMemMoveUnchecked memmove
@@ -99,6 +103,8 @@
 
 #define REDCONF_IMAP_EXTERNAL 1
 
+#define REDCONF_IMAP_SUMMARY_ENTRIES 32U
+
 #define REDCONF_DISCARDS 0
 
 #define REDCONF_IMAGE_BUILDER 0
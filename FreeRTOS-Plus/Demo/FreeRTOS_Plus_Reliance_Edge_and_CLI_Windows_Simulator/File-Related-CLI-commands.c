@@ -149,6 +149,11 @@ static BaseType_t prvABORTCommand( char *pcWriteBuffer, size_t xWriteBufferLen,
  */
 static BaseType_t prvTESTFSCommand( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
 
+/*
+ * Implements the BENCH-FS command.
+ */
+static BaseType_t prvBENCHFSCommand( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+
 
 /* Structure that defines the DIR command line command, which lists all the
 files in the current directory. */
@@ -317,6 +322,16 @@ static const CLI_Command_Definition_t xTEST_FS =
 	0 /* No parameters are expected. */
 };
 
+/* Structure that defines the BENCH-FS command line command, which measures the
+file system throughput. */
+static const CLI_Command_Definition_t xBENCH_FS =
+{
+	"bench-fs", /* The command string to type. */
+	"\r\nbench-fs:\r\n Measures file system throughput.  ALL FILES WILL BE DELETED!\r\n",
+	prvBENCHFSCommand, /* The function to run. */
+	0 /* No parameters are expected. */
+};
+
 /*-----------------------------------------------------------*/
 
 void vRegisterFileSystemCLICommands( void )
@@ -339,6 +354,7 @@ void vRegisterFileSystemCLICommands( void )
 	FreeRTOS_CLIRegisterCommand( &xTRANSMASKSET );
 	FreeRTOS_CLIRegisterCommand( &xABORT );
 	FreeRTOS_CLIRegisterCommand( &xTEST_FS );
+	FreeRTOS_CLIRegisterCommand( &xBENCH_FS );
 }
 /*-----------------------------------------------------------*/
 
@@ -1462,6 +1478,43 @@ FSSTRESSPARAM param;
 }
 /*-----------------------------------------------------------*/
 
+static BaseType_t prvBENCHFSCommand( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
+{
+UBaseType_t uxOriginalPriority;
+FSBENCHPARAM param;
+
+	/* Avoid compiler warnings. */
+	( void ) xWriteBufferLen;
+	( void ) pcCommandString;
+
+	/* Run at a high priority for the same reason as the TEST-FS command, and
+	so that the results are not skewed by other tasks. */
+	uxOriginalPriority = uxTaskPriorityGet( NULL );
+	vTaskPrioritySet( NULL, configMAX_PRIORITIES - 1 );
+
+	/* Start from an empty volume so the results are repeatable. */
+	red_umount( "" );
+	red_format( "" );
+	red_mount( "" );
+
+	FsBenchDefaultParams(&param);
+	FsBenchStart(&param);
+
+	/* Clean up after the benchmark. */
+	red_umount( "" );
+	red_format( "" );
+	red_mount( "" );
+
+	/* Reset back to the original priority. */
+	vTaskPrioritySet( NULL, uxOriginalPriority );
+
+	sprintf( pcWriteBuffer, "%s", "Benchmark results were sent to Windows console" );
+	strcat( pcWriteBuffer, cliNEW_LINE );
+
+	return pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
 static BaseType_t prvPerformCopy( int32_t lSourceFildes,
 									int32_t lDestinationFiledes,
 									char *pxWriteBuffer,
@@ -70,6 +70,42 @@
     #define SUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS    10U
 #endif
 
+/**
+ * @brief Maximum number of levels in a topic filter.
+ *
+ * AWS IoT allows at most 7 forward slashes in a topic, so 8 levels.
+ */
+#ifndef SUBSCRIPTION_MANAGER_MAX_FILTER_LEVELS
+    #define SUBSCRIPTION_MANAGER_MAX_FILTER_LEVELS    8U
+#endif
+
+/**
+ * @brief Maximum number of distinct topic filter levels held by the subscription
+ * manager, including the root. Filters with a common prefix share the levels of
+ * that prefix.
+ */
+#ifndef SUBSCRIPTION_MANAGER_MAX_TOPIC_NODES
+    #define SUBSCRIPTION_MANAGER_MAX_TOPIC_NODES    ( SUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS * 4U )
+#endif
+
+/**
+ * @brief Number of slots in the table used to find the child of a topic filter
+ * level. Must be a power of two, and at least twice
+ * SUBSCRIPTION_MANAGER_MAX_TOPIC_NODES.
+ */
+#ifndef SUBSCRIPTION_MANAGER_CHILD_TABLE_SIZE
+    #define SUBSCRIPTION_MANAGER_CHILD_TABLE_SIZE    128U
+#endif
+
+#if ( SUBSCRIPTION_MANAGER_MAX_TOPIC_NODES > 0xFFFFU )
+    #error "SUBSCRIPTION_MANAGER_MAX_TOPIC_NODES must fit in 16 bits."
+#endif
+
+#if ( ( SUBSCRIPTION_MANAGER_CHILD_TABLE_SIZE & ( SUBSCRIPTION_MANAGER_CHILD_TABLE_SIZE - 1U ) ) != 0U ) || \
+    ( SUBSCRIPTION_MANAGER_CHILD_TABLE_SIZE < ( 2U * SUBSCRIPTION_MANAGER_MAX_TOPIC_NODES ) )
+    #error "SUBSCRIPTION_MANAGER_CHILD_TABLE_SIZE must be a power of two of at least twice SUBSCRIPTION_MANAGER_MAX_TOPIC_NODES."
+#endif
+
 /**
  * @brief Callback function called when receiving a publish.
  *
@@ -82,9 +118,6 @@ typedef void (* IncomingPubCallback_t )( void * pvIncomingPublishCallbackContext
 /**
  * @brief An element in the list of subscriptions.
  *
- * This subscription manager implementation expects that the array of the
- * subscription elements used for storing subscriptions to be initialized to 0.
- *
  * @note This implementation allows multiple tasks to subscribe to the same topic.
  * In this case, another element is added to the subscription list, differing
  * in the intended publish callback. Also note that the topic filters are not
@@ -97,8 +130,45 @@ typedef struct subscriptionElement
     void * pvIncomingPublishCallbackContext;
     uint16_t usFilterStringLength;
     const char * pcSubscriptionFilterString;
+    uint16_t usNextOnTopicNode; /* One more than the index of the next subscription with the same filter, or 0. */
 } SubscriptionElement_t;
 
+/**
+ * @brief One level of one or more topic filters.
+ *
+ * The text of the level is not copied; it is found in the filter of the
+ * subscription usOwner.
+ */
+typedef struct topicNode
+{
+    uint16_t usParent;
+    uint16_t usOwner;
+    uint16_t usLevelOffset;
+    uint16_t usLevelLength;
+    uint16_t usSingleLevelChild;  /* The node for a '+' level below this one, or 0. */
+    uint16_t usMultiLevelChild;   /* The node for a '#' level below this one, or 0. */
+    uint16_t usFirstSubscription; /* One more than the index of the first subscription ending here, or 0. */
+} TopicNode_t;
+
+/**
+ * @brief The subscriptions, and a tree of their topic filter levels used to find
+ * the subscriptions matching an incoming publish without comparing its topic
+ * with every filter.
+ *
+ * Node 0 is the root. Other levels are found from their parent through
+ * usChildTable, an open-addressed hash table of node indexes, except that
+ * the '+' and '#' wildcard levels are linked from the parent directly.
+ *
+ * The subscription manager expects this structure to be initialized to 0.
+ */
+typedef struct subscriptionManager
+{
+    SubscriptionElement_t xSubscriptionList[ SUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS ];
+    TopicNode_t xTopicNodes[ SUBSCRIPTION_MANAGER_MAX_TOPIC_NODES ];
+    uint16_t usTopicNodeCount;
+    uint16_t usChildTable[ SUBSCRIPTION_MANAGER_CHILD_TABLE_SIZE ];
+} SubscriptionManager_t;
+
 /**
  * @brief Add a subscription to the subscription list.
  *
@@ -106,15 +176,19 @@ typedef struct subscriptionElement
  * context-callback pairs. However, a single context-callback pair may only be
  * associated to the same topic filter once.
  *
- * @param[in] pxSubscriptionList  The pointer to the subscription list array.
+ * @note The '+' and '#' wildcards must each make up a whole level of the topic
+ * filter, and '#' may only be the last level, as MQTT requires.
+ *
+ * @param[in] pxSubscriptionManager  The subscription manager.
  * @param[in] pcTopicFilterString Topic filter string of subscription.
  * @param[in] usTopicFilterLength Length of topic filter string.
  * @param[in] pxIncomingPublishCallback Callback function for the subscription.
  * @param[in] pvIncomingPublishCallbackContext Context for the subscription callback.
  *
- * @return `true` if subscription added or exists, `false` if insufficient memory.
+ * @return `true` if subscription added or exists, `false` if insufficient memory
+ * or the topic filter is not valid.
  */
-bool addSubscription( SubscriptionElement_t * pxSubscriptionList,
+bool addSubscription( SubscriptionManager_t * pxSubscriptionManager,
                       const char * pcTopicFilterString,
                       uint16_t usTopicFilterLength,
                       IncomingPubCallback_t pxIncomingPublishCallback,
@@ -126,11 +200,11 @@ bool addSubscription( SubscriptionElement_t * pxSubscriptionList,
  * @note If the topic filter exists multiple times in the subscription list,
  * then every instance of the subscription will be removed.
  *
- * @param[in] pxSubscriptionList  The pointer to the subscription list array.
+ * @param[in] pxSubscriptionManager  The subscription manager.
  * @param[in] pcTopicFilterString Topic filter of subscription.
  * @param[in] usTopicFilterLength Length of topic filter.
  */
-void removeSubscription( SubscriptionElement_t * pxSubscriptionList,
+void removeSubscription( SubscriptionManager_t * pxSubscriptionManager,
                          const char * pcTopicFilterString,
                          uint16_t usTopicFilterLength );
 
@@ -138,13 +212,16 @@ void removeSubscription( SubscriptionElement_t * pxSubscriptionList,
  * @brief Handle incoming publishes by invoking the callbacks registered
  * for the incoming publish's topic filter.
  *
- * @param[in] pxSubscriptionList  The pointer to the subscription list array.
+ * The cost depends on the number of levels in the topic, not on the number
+ * of subscriptions.
+ *
+ * @param[in] pxSubscriptionManager  The subscription manager.
  * @param[in] pxPublishInfo Info of incoming publish.
  *
  * @return `true` if an application callback could be invoked;
  *  `false` otherwise.
  */
-bool handleIncomingPublishes( SubscriptionElement_t * pxSubscriptionList,
+bool handleIncomingPublishes( SubscriptionManager_t * pxSubscriptionManager,
                               MQTTPublishInfo_t * pxPublishInfo );
 
 #endif /* SUBSCRIPTION_MANAGER_H */
@@ -320,7 +320,7 @@ typedef struct OtaAppBuffer
     uint16_t certFilePathSize;   /*!< @brief Maximum size of the certificate file path. */
     uint8_t * pStreamName;       /*!< @brief Name of stream to download the files. */
     uint16_t streamNameSize;     /*!< @brief Maximum size of the stream name. */
-    uint8_t * pDecodeMemory;     /*!< @brief Place to store the decoded files. */
+    uint8_t * pDecodeMemory;     /*!< @brief Place to store the decoded files, unused when blocks are decoded in place. */
     uint32_t decodeMemorySize;   /*!< @brief Maximum size of the decoded files buffer. */
     uint8_t * pFileBitmap;       /*!< @brief Bitmap of the parameters received. */
     uint16_t fileBitmapSize;     /*!< @brief Maximum size of the bitmap. */
@@ -346,7 +346,8 @@ typedef struct OtaAgentContext
     uint8_t * pClientTokenFromJob;                         /*!< The clientToken field from the latest update job. */
     uint32_t timestampFromJob;                             /*!< Timestamp received from the latest job document. */
     OtaImageState_t imageState;                            /*!< The current application image state. */
-    uint32_t numOfBlocksToReceive;                         /*!< Number of data blocks to receive per data request. */
+    uint32_t numOfBlocksToReceive;                         /*!< Number of data blocks requested but not received yet. */
+    uint32_t nextBlockToRequest;                           /*!< Index of the first block not covered by an outstanding data request. */
     OtaAgentStatistics_t statistics;                       /*!< The OTA agent statistics block. */
     uint32_t requestMomentum;                              /*!< The number of requests sent before a response was received. */
     const OtaInterfaces_t * pOtaInterface;                 /*!< Collection of all interfaces used by the agent. */
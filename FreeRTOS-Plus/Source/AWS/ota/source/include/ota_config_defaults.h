@@ -160,6 +160,26 @@
     #define otaconfigMAX_NUM_BLOCKS_REQUEST    1U
 #endif
 
+/**
+ * @brief The maximum number of data blocks that may be requested from the OTA
+ * streaming service without having been received yet.
+ *
+ * @note When this is larger than otaconfigMAX_NUM_BLOCKS_REQUEST, the agent
+ * requests the next batch of blocks as soon as the outstanding blocks fit in
+ * the remaining window, instead of waiting for the current batch to drain.
+ * This keeps the stream busy while earlier blocks are decoded and written.
+ * Blocks already requested are masked out of the next request so the service
+ * does not send them twice. Only MQTT data transfers are pipelined; HTTP
+ * still requests one block at a time.
+ *
+ * <b>Possible values:</b> Any unsigned 32 integer value greater than or equal
+ * to otaconfigMAX_NUM_BLOCKS_REQUEST. <br>
+ * <b>Default value:</b> otaconfigMAX_NUM_BLOCKS_REQUEST (no pipelining)
+ */
+#ifndef otaconfigMAX_NUM_BLOCKS_IN_FLIGHT
+    #define otaconfigMAX_NUM_BLOCKS_IN_FLIGHT    otaconfigMAX_NUM_BLOCKS_REQUEST
+#endif
+
 /**
  * @brief The maximum number of requests allowed to send without a response
  * before we abort.
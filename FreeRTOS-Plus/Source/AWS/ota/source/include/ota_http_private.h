@@ -93,6 +93,31 @@ OtaErr_t decodeFileBlock_Http( const uint8_t * pMessageBuffer,
                                uint8_t * const * pPayload,
                                size_t * pPayloadSize );
 
+/**
+ * @brief Stub for decoding the file block in place.
+ *
+ * File block received over HTTP is the payload itself, so the payload is
+ * returned as the message buffer.
+ *
+ * @param[in] pMessageBuffer The message to be decoded.
+ * @param[in] messageSize     The size of the message in bytes.
+ * @param[out] pFileId        The server file ID.
+ * @param[out] pBlockId       The file block ID.
+ * @param[out] pBlockSize     The file block size.
+ * @param[out] ppPayload      Start of the payload in the message buffer.
+ * @param[out] pPayloadSize   The payload size.
+ *
+ * @return The OTA PAL layer error code combined with the MCU specific error code. See OTA Agent
+ * error codes information in ota.h.
+ */
+OtaErr_t decodeFileBlockView_Http( const uint8_t * pMessageBuffer,
+                                   size_t messageSize,
+                                   int32_t * pFileId,
+                                   int32_t * pBlockId,
+                                   int32_t * pBlockSize,
+                                   const uint8_t ** ppPayload,
+                                   size_t * pPayloadSize );
+
 /**
  * @brief Cleanup related to OTA data plane over HTTP.
  *
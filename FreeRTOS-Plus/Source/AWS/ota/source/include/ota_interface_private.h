@@ -84,6 +84,13 @@ typedef struct
                                     int32_t * pBlockSize,
                                     uint8_t * const * pPayload,
                                     size_t * pPayloadSize );       /*!< Decode a cbor encoded fileblock. */
+    OtaErr_t ( * decodeFileBlockView )( const uint8_t * pMessageBuffer,
+                                        size_t messageSize,
+                                        int32_t * pFileId,
+                                        int32_t * pBlockId,
+                                        int32_t * pBlockSize,
+                                        const uint8_t ** ppPayload,
+                                        size_t * pPayloadSize ); /*!< Decode a fileblock in place, optional. */
     OtaErr_t ( * cleanup )( const OtaAgentContext_t * pAgentCtx ); /*!< Cleanup related to OTA data plane. */
 } OtaDataInterface_t;
 
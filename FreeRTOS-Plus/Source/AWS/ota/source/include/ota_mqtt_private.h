@@ -105,6 +105,32 @@ OtaErr_t decodeFileBlock_Mqtt( const uint8_t * pMessageBuffer,
                                uint8_t * const * pPayload,
                                size_t * pPayloadSize );
 
+/**
+ * @brief Decode a cbor encoded fileblock without copying the payload.
+ *
+ * This function is used for decoding a file block received over MQTT & encoded in cbor.
+ * The payload is left in the message buffer and is only valid as long as the buffer is.
+ *
+ * @param[in] pMessageBuffer The message to be decoded.
+ * @param[in] messageSize     The size of the message in bytes.
+ * @param[out] pFileId        The server file ID.
+ * @param[out] pBlockId       The file block ID.
+ * @param[out] pBlockSize     The file block size.
+ * @param[out] ppPayload      Start of the payload in the message buffer.
+ * @param[in,out] pPayloadSize   The maximum payload size as in and the payload size as out.
+ *
+ * @return The OTA PAL layer error code combined with the MCU specific error code. See OTA Agent
+ * error codes information in ota.h.
+ */
+
+OtaErr_t decodeFileBlockView_Mqtt( const uint8_t * pMessageBuffer,
+                                   size_t messageSize,
+                                   int32_t * pFileId,
+                                   int32_t * pBlockId,
+                                   int32_t * pBlockSize,
+                                   const uint8_t ** ppPayload,
+                                   size_t * pPayloadSize );
+
 /**
  * @brief Cleanup related to OTA control plane over MQTT.
  *
@@ -61,6 +61,9 @@
  * - [OTA PAL Reset Device](@ref OtaPalResetDevice_t)
  * - [OTA PAL Set Platform Image State](@ref OtaPalSetPlatformImageState_t)
  * - [OTA PAL Get Platform Image State](@ref OtaPalGetPlatformImageState_t)
+ *
+ * The following function is optional and may be left NULL:<br>
+ * - [OTA PAL Update Digest](@ref OtaPalUpdateDigest_t)
  */
 
 /**
@@ -294,6 +297,44 @@ typedef OtaPalStatus_t ( * OtaPalSetPlatformImageState_t )( OtaFileContext_t * c
  */
 typedef OtaPalImageState_t ( * OtaPalGetPlatformImageState_t ) ( OtaFileContext_t * const pFileContext );
 
+/**
+ * @brief Hash the next bytes of the receive file as they are received.
+ *
+ * This optional function lets the PAL compute the image digest while the file is
+ * being downloaded, so the signature check in the close file function does not
+ * have to read the whole image back. The OTA agent only passes data that directly
+ * follows the data already hashed, starting at offset zero, so the digest is always
+ * over a prefix of the file.
+ *
+ * A block that arrives after a gap (for example after a retry) is written but not
+ * hashed. Once the block filling the gap has been hashed, the agent calls this
+ * function again with pData set to NULL and dataSize covering the blocks stored
+ * after it. The PAL must then read those bytes back from the receive file, starting
+ * at offset pFileContext->digestSize.
+ *
+ * pFileContext->digestSize holds the number of bytes hashed so far and is reset to
+ * zero before the create file function is called. If this function fails, the
+ * agent stops calling it for the rest of the file. The close file function must
+ * then check pFileContext->digestSize against pFileContext->fileSize and fall back
+ * to hashing the stored image when the streamed digest is incomplete.
+ *
+ * @note The input OtaFileContext_t pFileContext is checked for NULL by the OTA agent before this
+ * function is called. This function is only called after the same data was written successfully.
+ *
+ * @param[in] pFileContext OTA file context information.
+ * @param[in] pData Pointer to the byte array of data to hash, or NULL to hash data
+ * already stored in the receive file.
+ * @param[in] dataSize The number of bytes to hash.
+ *
+ * @return The OTA PAL layer error code combined with the MCU specific error code. See OTA Agent
+ * error codes information in ota.h.
+ * OtaPalSuccess is returned when the data was added to the digest. On any other value
+ * the agent stops streaming the digest for this file.
+ */
+typedef OtaPalStatus_t ( * OtaPalUpdateDigest_t )( OtaFileContext_t * const pFileContext,
+                                                   const uint8_t * pData,
+                                                   uint32_t dataSize );
+
 /**
  * @ingroup ota_struct_types
  * @brief OTA pal Interface structure.
@@ -314,6 +355,7 @@ typedef struct OtaPalInterface
     OtaPalResetDevice_t reset;                           /*!< @brief Reset the device. */
     OtaPalSetPlatformImageState_t setPlatformImageState; /*!< @brief Set the state of the OTA update image. */
     OtaPalGetPlatformImageState_t getPlatformImageState; /*!< @brief Get the state of the OTA update image. */
+    OtaPalUpdateDigest_t updateDigest;                   /*!< @brief Optional: hash the receive file in order as it arrives. May be NULL. */
 } OtaPalInterface_t;
 
 /* *INDENT-OFF* */
@@ -387,6 +387,7 @@ typedef struct OtaFileContext
     otaconfigOTA_FILE_TYPE * pFile; /*!< @brief File type after file is open for write. */
     uint32_t fileSize;              /*!< @brief The size of the file in bytes. */
     uint32_t blocksRemaining;       /*!< @brief How many blocks remain to be received (a code optimization). */
+    uint32_t digestSize;            /*!< @brief Number of leading file bytes passed in order to the PAL digest. */
     uint32_t fileAttributes;        /*!< @brief Flags specific to the file being received (e.g. secure, bundle, archive). */
     uint32_t serverFileID;          /*!< @brief The file is referenced by this numeric ID in the OTA job. */
     uint8_t * pJobName;             /*!< @brief The job name associated with this file from the job service. */
@@ -317,7 +317,7 @@ static bool validateDataBlock( const OtaFileContext_t * pFileContext,
  * @param[in] pFileContext Information of file to be streamed.
  * @param[in] pRawMsg Raw job document.
  * @param[in] messageSize Length of document.
- * @param[in] pPayload Data stored in the document.
+ * @param[out] pPayload Data stored in the document, points into pRawMsg when decoded in place.
  * @param[out] pBlockSize Block size of incoming data block.
  * @param[out] pBlockIndex Block index of incoming data block.
  * @return IngestResult_t IngestResultAccepted_Continue if successful, other error for failure.
@@ -329,6 +329,20 @@ static IngestResult_t decodeAndStoreDataBlock( const OtaFileContext_t * pFileCon
                                                uint32_t * pBlockSize,
                                                uint32_t * pBlockIndex );
 
+/**
+ * @brief Pass a newly written data block to the PAL digest if it continues the file in order,
+ * followed by the blocks already stored after it.
+ *
+ * @param[in] pFileContext Information of file to be streamed.
+ * @param[in] blockIndex Block index of the data block.
+ * @param[in] blockSize Block size of the data block.
+ * @param[in] pPayload Data of the block.
+ */
+static void updateFileDigest( OtaFileContext_t * pFileContext,
+                              uint32_t blockIndex,
+                              uint32_t blockSize,
+                              const uint8_t * pPayload );
+
 /**
  * @brief Close an open OTA file context and free it.
  *
@@ -484,21 +498,22 @@ static void resetEventQueue( void );
 
 /* OTA state event handler functions. */
 
-static OtaErr_t startHandler( const OtaEventData_t * pEventData );           /*!< Start timers and initiate request for job document. */
-static OtaErr_t requestJobHandler( const OtaEventData_t * pEventData );      /*!< Initiate a request for a job. */
-static OtaErr_t processJobHandler( const OtaEventData_t * pEventData );      /*!< Update file context from job document. */
-static OtaErr_t inSelfTestHandler( const OtaEventData_t * pEventData );      /*!< Handle self test. */
-static OtaErr_t initFileHandler( const OtaEventData_t * pEventData );        /*!< Initialize and handle file transfer. */
-static OtaErr_t processDataHandler( const OtaEventData_t * pEventData );     /*!< Process incoming data blocks. */
-static OtaErr_t requestDataHandler( const OtaEventData_t * pEventData );     /*!< Request for data blocks. */
-static OtaErr_t shutdownHandler( const OtaEventData_t * pEventData );        /*!< Shutdown OTA and cleanup. */
-static OtaErr_t closeFileHandler( const OtaEventData_t * pEventData );       /*!< Close file opened for download. */
-static OtaErr_t userAbortHandler( const OtaEventData_t * pEventData );       /*!< Handle user interrupt to abort task. */
-static OtaErr_t suspendHandler( const OtaEventData_t * pEventData );         /*!< Handle suspend event for OTA agent. */
-static OtaErr_t resumeHandler( const OtaEventData_t * pEventData );          /*!< Resume from a suspended state. */
-static OtaErr_t jobNotificationHandler( const OtaEventData_t * pEventData ); /*!< Upon receiving a new job document cancel current job if present and initiate new download. */
+static OtaErr_t startHandler( const OtaEventData_t * pEventData );            /*!< Start timers and initiate request for job document. */
+static OtaErr_t requestJobHandler( const OtaEventData_t * pEventData );       /*!< Initiate a request for a job. */
+static OtaErr_t processJobHandler( const OtaEventData_t * pEventData );       /*!< Update file context from job document. */
+static OtaErr_t inSelfTestHandler( const OtaEventData_t * pEventData );       /*!< Handle self test. */
+static OtaErr_t initFileHandler( const OtaEventData_t * pEventData );         /*!< Initialize and handle file transfer. */
+static OtaErr_t processDataHandler( const OtaEventData_t * pEventData );      /*!< Process incoming data blocks. */
+static OtaErr_t requestDataHandler( const OtaEventData_t * pEventData );      /*!< Request for data blocks. */
+static OtaErr_t requestDataRetryHandler( const OtaEventData_t * pEventData ); /*!< Request again all data blocks still missing after a timeout. */
+static OtaErr_t shutdownHandler( const OtaEventData_t * pEventData );         /*!< Shutdown OTA and cleanup. */
+static OtaErr_t closeFileHandler( const OtaEventData_t * pEventData );        /*!< Close file opened for download. */
+static OtaErr_t userAbortHandler( const OtaEventData_t * pEventData );        /*!< Handle user interrupt to abort task. */
+static OtaErr_t suspendHandler( const OtaEventData_t * pEventData );          /*!< Handle suspend event for OTA agent. */
+static OtaErr_t resumeHandler( const OtaEventData_t * pEventData );           /*!< Resume from a suspended state. */
+static OtaErr_t jobNotificationHandler( const OtaEventData_t * pEventData );  /*!< Upon receiving a new job document cancel current job if present and initiate new download. */
 static void executeHandler( uint32_t index,
-                            const OtaEventMsg_t * const pEventMsg );         /*!< Execute the handler for selected index from the transition table. */
+                            const OtaEventMsg_t * const pEventMsg );          /*!< Execute the handler for selected index from the transition table. */
 
 /**
  * @brief This is THE OTA agent context and initialization state.
@@ -515,6 +530,7 @@ static OtaAgentContext_t otaAgent =
     0,                    /* timestampFromJob */
     OtaImageStateUnknown, /* imageState */
     1,                    /* numOfBlocksToReceive */
+    0,                    /* nextBlockToRequest */
     { 0 },                /* statistics */
     0,                    /* requestMomentum */
     NULL,                 /* pOtaInterface */
@@ -528,26 +544,26 @@ static OtaAgentContext_t otaAgent =
  */
 static OtaStateTableEntry_t otaTransitionTable[] =
 {
-    /*STATE ,                              EVENT ,                               ACTION ,               NEXT STATE                         */
-    { OtaAgentStateReady,               OtaAgentEventStart,               startHandler,           OtaAgentStateRequestingJob       },
-    { OtaAgentStateRequestingJob,       OtaAgentEventRequestJobDocument,  requestJobHandler,      OtaAgentStateWaitingForJob       },
-    { OtaAgentStateRequestingJob,       OtaAgentEventRequestTimer,        requestJobHandler,      OtaAgentStateWaitingForJob       },
-    { OtaAgentStateWaitingForJob,       OtaAgentEventReceivedJobDocument, processJobHandler,      OtaAgentStateCreatingFile        },
-    { OtaAgentStateCreatingFile,        OtaAgentEventStartSelfTest,       inSelfTestHandler,      OtaAgentStateWaitingForJob       },
-    { OtaAgentStateCreatingFile,        OtaAgentEventCreateFile,          initFileHandler,        OtaAgentStateRequestingFileBlock },
-    { OtaAgentStateCreatingFile,        OtaAgentEventRequestTimer,        initFileHandler,        OtaAgentStateRequestingFileBlock },
-    { OtaAgentStateRequestingFileBlock, OtaAgentEventRequestFileBlock,    requestDataHandler,     OtaAgentStateWaitingForFileBlock },
-    { OtaAgentStateRequestingFileBlock, OtaAgentEventRequestTimer,        requestDataHandler,     OtaAgentStateWaitingForFileBlock },
-    { OtaAgentStateWaitingForFileBlock, OtaAgentEventReceivedFileBlock,   processDataHandler,     OtaAgentStateWaitingForFileBlock },
-    { OtaAgentStateWaitingForFileBlock, OtaAgentEventRequestTimer,        requestDataHandler,     OtaAgentStateWaitingForFileBlock },
-    { OtaAgentStateWaitingForFileBlock, OtaAgentEventRequestFileBlock,    requestDataHandler,     OtaAgentStateWaitingForFileBlock },
-    { OtaAgentStateWaitingForFileBlock, OtaAgentEventRequestJobDocument,  requestJobHandler,      OtaAgentStateWaitingForJob       },
-    { OtaAgentStateWaitingForFileBlock, OtaAgentEventReceivedJobDocument, jobNotificationHandler, OtaAgentStateRequestingJob       },
-    { OtaAgentStateWaitingForFileBlock, OtaAgentEventCloseFile,           closeFileHandler,       OtaAgentStateWaitingForJob       },
-    { OtaAgentStateSuspended,           OtaAgentEventResume,              resumeHandler,          OtaAgentStateRequestingJob       },
-    { OtaAgentStateAll,                 OtaAgentEventSuspend,             suspendHandler,         OtaAgentStateSuspended           },
-    { OtaAgentStateAll,                 OtaAgentEventUserAbort,           userAbortHandler,       OtaAgentStateWaitingForJob       },
-    { OtaAgentStateAll,                 OtaAgentEventShutdown,            shutdownHandler,        OtaAgentStateStopped             },
+    /*STATE ,                              EVENT ,                               ACTION ,                NEXT STATE                         */
+    { OtaAgentStateReady,               OtaAgentEventStart,               startHandler,            OtaAgentStateRequestingJob       },
+    { OtaAgentStateRequestingJob,       OtaAgentEventRequestJobDocument,  requestJobHandler,       OtaAgentStateWaitingForJob       },
+    { OtaAgentStateRequestingJob,       OtaAgentEventRequestTimer,        requestJobHandler,       OtaAgentStateWaitingForJob       },
+    { OtaAgentStateWaitingForJob,       OtaAgentEventReceivedJobDocument, processJobHandler,       OtaAgentStateCreatingFile        },
+    { OtaAgentStateCreatingFile,        OtaAgentEventStartSelfTest,       inSelfTestHandler,       OtaAgentStateWaitingForJob       },
+    { OtaAgentStateCreatingFile,        OtaAgentEventCreateFile,          initFileHandler,         OtaAgentStateRequestingFileBlock },
+    { OtaAgentStateCreatingFile,        OtaAgentEventRequestTimer,        initFileHandler,         OtaAgentStateRequestingFileBlock },
+    { OtaAgentStateRequestingFileBlock, OtaAgentEventRequestFileBlock,    requestDataHandler,      OtaAgentStateWaitingForFileBlock },
+    { OtaAgentStateRequestingFileBlock, OtaAgentEventRequestTimer,        requestDataRetryHandler, OtaAgentStateWaitingForFileBlock },
+    { OtaAgentStateWaitingForFileBlock, OtaAgentEventReceivedFileBlock,   processDataHandler,      OtaAgentStateWaitingForFileBlock },
+    { OtaAgentStateWaitingForFileBlock, OtaAgentEventRequestTimer,        requestDataRetryHandler, OtaAgentStateWaitingForFileBlock },
+    { OtaAgentStateWaitingForFileBlock, OtaAgentEventRequestFileBlock,    requestDataHandler,      OtaAgentStateWaitingForFileBlock },
+    { OtaAgentStateWaitingForFileBlock, OtaAgentEventRequestJobDocument,  requestJobHandler,       OtaAgentStateWaitingForJob       },
+    { OtaAgentStateWaitingForFileBlock, OtaAgentEventReceivedJobDocument, jobNotificationHandler,  OtaAgentStateRequestingJob       },
+    { OtaAgentStateWaitingForFileBlock, OtaAgentEventCloseFile,           closeFileHandler,        OtaAgentStateWaitingForJob       },
+    { OtaAgentStateSuspended,           OtaAgentEventResume,              resumeHandler,           OtaAgentStateRequestingJob       },
+    { OtaAgentStateAll,                 OtaAgentEventSuspend,             suspendHandler,          OtaAgentStateSuspended           },
+    { OtaAgentStateAll,                 OtaAgentEventUserAbort,           userAbortHandler,        OtaAgentStateWaitingForJob       },
+    { OtaAgentStateAll,                 OtaAgentEventShutdown,            shutdownHandler,         OtaAgentStateStopped             },
 };
 
 /**
@@ -1082,6 +1098,10 @@ static OtaErr_t initFileHandler( const OtaEventData_t * pEventData )
         /* Reset the request momentum. */
         otaAgent.requestMomentum = 0;
 
+        /* No data blocks have been requested for this file yet. */
+        otaAgent.numOfBlocksToReceive = 0;
+        otaAgent.nextBlockToRequest = 0;
+
         /* Reset the OTA statistics. */
         ( void ) memset( &otaAgent.statistics, 0, sizeof( otaAgent.statistics ) );
 
@@ -1156,6 +1176,16 @@ static OtaErr_t requestDataHandler( const OtaEventData_t * pEventData )
     return err;
 }
 
+static OtaErr_t requestDataRetryHandler( const OtaEventData_t * pEventData )
+{
+    /* Nothing arrived for a whole request period, so whatever was still in
+     * flight is lost. Ask for every missing block again. */
+    otaAgent.numOfBlocksToReceive = 0;
+    otaAgent.nextBlockToRequest = 0;
+
+    return requestDataHandler( pEventData );
+}
+
 static void dataHandlerCleanup( void )
 {
     OtaEventMsg_t eventMsg = { 0 };
@@ -1271,11 +1301,16 @@ static OtaErr_t processDataHandler( const OtaEventData_t * pEventData )
         /* We're actively receiving a file so update the job status as needed. */
         err = otaControlInterface.updateJobStatus( &otaAgent, JobStatusInProgress, JobReasonReceiving, 0 );
 
-        if( otaAgent.numOfBlocksToReceive > 1U )
+        if( otaAgent.numOfBlocksToReceive > 0U )
         {
             otaAgent.numOfBlocksToReceive--;
         }
-        else
+
+        /* Request the next blocks as soon as they fit in the window of blocks in
+         * flight, so the stream stays busy while this block is written. By
+         * default the window is one request, so this waits for the whole batch. */
+        if( ( otaAgent.numOfBlocksToReceive == 0U ) ||
+            ( ( otaAgent.numOfBlocksToReceive + otaconfigMAX_NUM_BLOCKS_REQUEST ) <= otaconfigMAX_NUM_BLOCKS_IN_FLIGHT ) )
         {
             /* Start the request timer. */
             ( void ) otaAgent.pOtaInterface->os.timer.start( OtaRequestTimer, "OtaRequestTimer", otaconfigFILE_REQUEST_WAIT_MS, otaTimerCallback );
@@ -1364,6 +1399,7 @@ static OtaErr_t shutdownHandler( const OtaEventData_t * pEventData )
     otaAgent.fileIndex = 0;
     otaAgent.serverFileID = 0;
     otaAgent.numOfBlocksToReceive = 0;
+    otaAgent.nextBlockToRequest = 0;
     otaAgent.requestMomentum = 0;
     otaAgent.unsubscribeOnShutdown = 0;
     otaAgent.imageState = OtaImageStateUnknown;
@@ -2487,6 +2523,7 @@ static OtaFileContext_t * getFileContextFromJob( const char * pRawMsg,
             }
 
             pUpdateFile->blocksRemaining = numBlocks; /* Initialize our blocks remaining counter. */
+            pUpdateFile->digestSize = 0;              /* Nothing has been hashed yet. */
 
             /* Create/Open the OTA file on the file system. */
             palStatus = otaAgent.pOtaInterface->pal.createFile( pUpdateFile );
@@ -2617,6 +2654,8 @@ static IngestResult_t processDataBlock( OtaFileContext_t * pFileContext,
 
     if( eIngestResult == IngestResultAccepted_Continue )
     {
+        updateFileDigest( pFileContext, uBlockIndex, uBlockSize, pPayload );
+
         /* Mark this block as received in our bitmap. */
         pFileContext->pRxBlockBitmap[ byte ] &= ( uint8_t ) ( ( uint8_t ) 0xFFU & ( ~bitMask ) );
         pFileContext->blocksRemaining--;
@@ -2627,6 +2666,66 @@ static IngestResult_t processDataBlock( OtaFileContext_t * pFileContext,
     return eIngestResult;
 }
 
+/* Hash the data block if it directly follows the data hashed so far. Blocks
+ * that arrived after a gap are stored but not hashed, and are passed to the PAL
+ * to read back from storage once the block filling the gap has been hashed. */
+
+static void updateFileDigest( OtaFileContext_t * pFileContext,
+                              uint32_t blockIndex,
+                              uint32_t blockSize,
+                              const uint8_t * pPayload )
+{
+    OtaPalStatus_t palStatus = OTA_PAL_COMBINE_ERR( OtaPalUninitialized, 0 );
+    uint32_t nextBlock = blockIndex + 1U;
+    uint32_t storedSize = 0;
+
+    if( ( otaAgent.pOtaInterface->pal.updateDigest != NULL ) &&
+        ( ( blockIndex * OTA_FILE_BLOCK_SIZE ) == pFileContext->digestSize ) )
+    {
+        palStatus = otaAgent.pOtaInterface->pal.updateDigest( pFileContext, pPayload, blockSize );
+
+        if( OTA_PAL_MAIN_ERR( palStatus ) == OtaPalSuccess )
+        {
+            pFileContext->digestSize += blockSize;
+
+            /* Find the blocks already received right after this one. A cleared
+             * bit in the bitmap marks a received block. */
+            while( ( ( nextBlock * OTA_FILE_BLOCK_SIZE ) < pFileContext->fileSize ) &&
+                   ( ( pFileContext->pRxBlockBitmap[ nextBlock >> LOG2_BITS_PER_BYTE ] &
+                       ( uint8_t ) ( 1U << ( nextBlock % BITS_PER_BYTE ) ) ) == 0U ) )
+            {
+                nextBlock++;
+            }
+
+            if( ( nextBlock * OTA_FILE_BLOCK_SIZE ) < pFileContext->fileSize )
+            {
+                storedSize = ( nextBlock * OTA_FILE_BLOCK_SIZE ) - pFileContext->digestSize;
+            }
+            else
+            {
+                storedSize = pFileContext->fileSize - pFileContext->digestSize;
+            }
+
+            if( storedSize > 0U )
+            {
+                palStatus = otaAgent.pOtaInterface->pal.updateDigest( pFileContext, NULL, storedSize );
+
+                if( OTA_PAL_MAIN_ERR( palStatus ) == OtaPalSuccess )
+                {
+                    pFileContext->digestSize += storedSize;
+                }
+            }
+        }
+
+        if( OTA_PAL_MAIN_ERR( palStatus ) != OtaPalSuccess )
+        {
+            LogWarn( ( "Failed to update the file digest, the PAL will hash the stored file: "
+                       "Block index=%u, OtaPalStatus_t=%s",
+                       blockIndex, OTA_PalStatus_strerror( OTA_PAL_MAIN_ERR( palStatus ) ) ) );
+        }
+    }
+}
+
 /* Decode and store the incoming data block. */
 static IngestResult_t decodeAndStoreDataBlock( const OtaFileContext_t * pFileContext,
                                                const uint8_t * pRawMsg,
@@ -2640,6 +2739,8 @@ static IngestResult_t decodeAndStoreDataBlock( const OtaFileContext_t * pFileCon
     int32_t sBlockSize = 0;
     int32_t sBlockIndex = 0;
     size_t payloadSize = 0;
+    const uint8_t * pPayloadView = NULL;
+    OtaErr_t decodeErr = OtaErrNone;
 
     /* If we are expecting a data block, allocate space for it. */
     if( ( pFileContext->pRxBlockBitmap != NULL ) && ( pFileContext->blocksRemaining > 0U ) )
@@ -2649,7 +2750,12 @@ static IngestResult_t decodeAndStoreDataBlock( const OtaFileContext_t * pFileCon
                                                          otaconfigFILE_REQUEST_WAIT_MS,
                                                          otaTimerCallback );
 
-        if( otaAgent.fileContext.decodeMemMaxSize != 0U )
+        if( otaDataInterface.decodeFileBlockView != NULL )
+        {
+            /* The payload is left in the message buffer, so no space is needed. */
+            payloadSize = OTA_FILE_BLOCK_SIZE;
+        }
+        else if( otaAgent.fileContext.decodeMemMaxSize != 0U )
         {
             *pPayload = otaAgent.fileContext.pDecodeMem;
             payloadSize = otaAgent.fileContext.decodeMemMaxSize;
@@ -2670,7 +2776,41 @@ static IngestResult_t decodeAndStoreDataBlock( const OtaFileContext_t * pFileCon
     }
 
     /* Decode the file block if space is allocated. */
-    if( payloadSize > 0u )
+    if( ( payloadSize > 0u ) && ( otaDataInterface.decodeFileBlockView != NULL ) )
+    {
+        /* Decode the file block received in place. */
+        decodeErr = otaDataInterface.decodeFileBlockView( pRawMsg,
+                                                          messageSize,
+                                                          &lFileId,
+                                                          &sBlockIndex,
+                                                          &sBlockSize,
+                                                          &pPayloadView,
+                                                          &payloadSize );
+
+        /* The block is written straight from the message, so the block size
+         * must not reach past the end of the payload. */
+        if( ( decodeErr == OtaErrNone ) && ( payloadSize != ( size_t ) sBlockSize ) )
+        {
+            LogError( ( "Block size does not match the payload size: "
+                        "Block size=%d, Payload size=%u",
+                        ( int ) sBlockSize, ( unsigned ) payloadSize ) );
+            decodeErr = OtaErrInvalidArg;
+        }
+
+        if( decodeErr != OtaErrNone )
+        {
+            eIngestResult = IngestResultBadData;
+        }
+        else
+        {
+            /* The message is held in an event buffer owned by the agent, the
+             * PAL write interface is just not const qualified. */
+            *pPayload = ( uint8_t * ) pPayloadView;
+            *pBlockIndex = ( uint32_t ) sBlockIndex;
+            *pBlockSize = ( uint32_t ) sBlockSize;
+        }
+    }
+    else if( payloadSize > 0u )
     {
         /* Decode the file block received. */
         if( OtaErrNone != otaDataInterface.decodeFileBlock(
@@ -2815,8 +2955,10 @@ static IngestResult_t ingestDataBlock( OtaFileContext_t * pFileContext,
         eIngestResult = ingestDataBlockCleanup( pFileContext, pCloseResult );
     }
 
-    /* Free the payload if it's dynamically allocated by us. */
+    /* Free the payload if it's dynamically allocated by us. A payload decoded
+     * in place points into the event buffer and is not ours to free. */
     if( ( eIngestResult != IngestResultNullInput ) &&
+        ( otaDataInterface.decodeFileBlockView == NULL ) &&
         ( otaAgent.fileContext.decodeMemMaxSize == 0u ) &&
         ( pPayload != NULL ) )
     {
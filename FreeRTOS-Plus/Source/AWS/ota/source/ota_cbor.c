@@ -60,51 +60,36 @@ static CborError checkDataType( CborType expectedType,
 }
 
 /**
- * @brief Decode a Get Stream response message from AWS IoT OTA.
+ * @brief Decode the fields of a Get Stream response message and locate the
+ * payload byte string.
  *
  * @param[in] pMessageBuffer message to decode.
  * @param[in] messageSize size of the message to decode.
+ * @param[out] pCborParser Parser that @p pPayloadValue refers to.
  * @param[out] pFileId Decoded file id value.
  * @param[out] pBlockId Decoded block id value.
  * @param[out] pBlockSize Decoded block size value.
- * @param[out] pPayload Buffer for the decoded payload.
- * @param[in,out] pPayloadSize maximum size of the buffer as in and actual
- * payload size for the decoded payload as out.
+ * @param[out] pPayloadValue Value of the payload byte string.
  *
- * @return TRUE when success, otherwise FALSE.
+ * @return CborError
  */
-bool OTA_CBOR_Decode_GetStreamResponseMessage( const uint8_t * pMessageBuffer,
-                                               size_t messageSize,
-                                               int32_t * pFileId,
-                                               int32_t * pBlockId,
-                                               int32_t * pBlockSize,
-                                               uint8_t * const * pPayload,
-                                               size_t * pPayloadSize )
+static CborError decodeStreamResponseFields( const uint8_t * pMessageBuffer,
+                                             size_t messageSize,
+                                             CborParser * pCborParser,
+                                             int32_t * pFileId,
+                                             int32_t * pBlockId,
+                                             int32_t * pBlockSize,
+                                             CborValue * pPayloadValue )
 {
     CborError cborResult = CborNoError;
-    CborParser cborParser;
     CborValue cborValue, cborMap;
-    size_t payloadSizeReceived = 0;
-
-    if( ( pFileId == NULL ) ||
-        ( pBlockId == NULL ) ||
-        ( pBlockSize == NULL ) ||
-        ( pPayload == NULL ) ||
-        ( pPayloadSize == NULL ) ||
-        ( pMessageBuffer == NULL ) )
-    {
-        cborResult = CborUnknownError;
-    }
 
     /* Initialize the parser. */
-    if( CborNoError == cborResult )
-    {
-        cborResult = cbor_parser_init( pMessageBuffer,
-                                       messageSize,
-                                       0,
-                                       &cborParser,
-                                       &cborMap );
-    }
+    cborResult = cbor_parser_init( pMessageBuffer,
+                                   messageSize,
+                                   0,
+                                   pCborParser,
+                                   &cborMap );
 
     /* Get the outer element and confirm that it's a "map," i.e., a set of
      * CBOR key/value pairs. */
@@ -178,12 +163,63 @@ bool OTA_CBOR_Decode_GetStreamResponseMessage( const uint8_t * pMessageBuffer,
     {
         cborResult = cbor_value_map_find_value( &cborMap,
                                                 OTA_CBOR_BLOCKPAYLOAD_KEY,
-                                                &cborValue );
+                                                pPayloadValue );
+    }
+
+    if( CborNoError == cborResult )
+    {
+        cborResult = checkDataType( CborByteStringType, pPayloadValue );
+    }
+
+    return cborResult;
+}
+
+/**
+ * @brief Decode a Get Stream response message from AWS IoT OTA.
+ *
+ * @param[in] pMessageBuffer message to decode.
+ * @param[in] messageSize size of the message to decode.
+ * @param[out] pFileId Decoded file id value.
+ * @param[out] pBlockId Decoded block id value.
+ * @param[out] pBlockSize Decoded block size value.
+ * @param[out] pPayload Buffer for the decoded payload.
+ * @param[in,out] pPayloadSize maximum size of the buffer as in and actual
+ * payload size for the decoded payload as out.
+ *
+ * @return TRUE when success, otherwise FALSE.
+ */
+bool OTA_CBOR_Decode_GetStreamResponseMessage( const uint8_t * pMessageBuffer,
+                                               size_t messageSize,
+                                               int32_t * pFileId,
+                                               int32_t * pBlockId,
+                                               int32_t * pBlockSize,
+                                               uint8_t * const * pPayload,
+                                               size_t * pPayloadSize )
+{
+    CborError cborResult = CborNoError;
+    CborParser cborParser;
+    CborValue cborValue;
+    size_t payloadSizeReceived = 0;
+
+    if( ( pFileId == NULL ) ||
+        ( pBlockId == NULL ) ||
+        ( pBlockSize == NULL ) ||
+        ( pPayload == NULL ) ||
+        ( pPayloadSize == NULL ) ||
+        ( pMessageBuffer == NULL ) )
+    {
+        cborResult = CborUnknownError;
     }
 
     if( CborNoError == cborResult )
     {
-        cborResult = checkDataType( CborByteStringType, &cborValue );
+        cborResult = decodeStreamResponseFields( pMessageBuffer,
+                                                 messageSize,
+                                                 &cborParser,
+                                                 pFileId,
+                                                 pBlockId,
+                                                 pBlockSize,
+                                                 &cborValue );
     }
 
     /* Calculate the size we need to malloc for the payload. */
@@ -217,6 +253,99 @@ bool OTA_CBOR_Decode_GetStreamResponseMessage( const uint8_t * pMessageBuffer,
     return CborNoError == cborResult;
 }
 
+/**
+ * @brief Decode a Get Stream response message from AWS IoT OTA without
+ * copying the payload.
+ *
+ * The payload is returned as a pointer into @p pMessageBuffer, so it is only
+ * valid for as long as the message buffer is. Only definite length payloads
+ * can be returned this way, since the chunks of an indefinite length byte
+ * string are not contiguous in the message.
+ *
+ * @param[in] pMessageBuffer message to decode.
+ * @param[in] messageSize size of the message to decode.
+ * @param[out] pFileId Decoded file id value.
+ * @param[out] pBlockId Decoded block id value.
+ * @param[out] pBlockSize Decoded block size value.
+ * @param[out] ppPayload Start of the payload in @p pMessageBuffer.
+ * @param[in,out] pPayloadSize maximum size of the payload as in and actual
+ * payload size as out.
+ *
+ * @return TRUE when success, otherwise FALSE.
+ */
+bool OTA_CBOR_Decode_GetStreamResponseMessageView( const uint8_t * pMessageBuffer,
+                                                   size_t messageSize,
+                                                   int32_t * pFileId,
+                                                   int32_t * pBlockId,
+                                                   int32_t * pBlockSize,
+                                                   const uint8_t ** ppPayload,
+                                                   size_t * pPayloadSize )
+{
+    CborError cborResult = CborNoError;
+    CborParser cborParser;
+    CborValue cborValue;
+    size_t payloadSizeReceived = 0;
+
+    if( ( pFileId == NULL ) ||
+        ( pBlockId == NULL ) ||
+        ( pBlockSize == NULL ) ||
+        ( ppPayload == NULL ) ||
+        ( pPayloadSize == NULL ) ||
+        ( pMessageBuffer == NULL ) )
+    {
+        cborResult = CborUnknownError;
+    }
+
+    if( CborNoError == cborResult )
+    {
+        cborResult = decodeStreamResponseFields( pMessageBuffer,
+                                                 messageSize,
+                                                 &cborParser,
+                                                 pFileId,
+                                                 pBlockId,
+                                                 pBlockSize,
+                                                 &cborValue );
+    }
+
+    if( CborNoError == cborResult )
+    {
+        if( false == cbor_value_is_length_known( &cborValue ) )
+        {
+            cborResult = CborErrorUnknownLength;
+        }
+    }
+
+    /* A definite length byte string is a single chunk, so the chunk is the
+     * whole payload. This also checks that it lies within the message. */
+    if( CborNoError == cborResult )
+    {
+        cborResult = cbor_value_begin_string_iteration( &cborValue );
+    }
+
+    if( CborNoError == cborResult )
+    {
+        cborResult = cbor_value_get_byte_string_chunk( &cborValue,
+                                                       ppPayload,
+                                                       &payloadSizeReceived,
+                                                       NULL );
+    }
+
+    if( CborNoError == cborResult )
+    {
+        /* Check if the received payload size is less than or equal to the maximum size. */
+        if( payloadSizeReceived <= ( *pPayloadSize ) )
+        {
+            *pPayloadSize = payloadSizeReceived;
+        }
+        else
+        {
+            cborResult = CborErrorOutOfMemory;
+        }
+    }
+
+    return CborNoError == cborResult;
+}
+
 /**
  * @brief Create an encoded Get Stream Request message for the AWS IoT OTA
  * service. The service allows block count or block bitmap to be requested,
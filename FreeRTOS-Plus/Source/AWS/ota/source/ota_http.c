@@ -133,10 +133,44 @@ OtaErr_t decodeFileBlock_Http( const uint8_t * pMessageBuffer,
                                size_t * pPayloadSize )
 {
     OtaErr_t err = OtaErrNone;
+    const uint8_t * pBlock = NULL;
 
     assert( ( pMessageBuffer != NULL ) && ( pFileId != NULL ) && ( pBlockId != NULL ) &&
             ( pBlockSize != NULL ) && ( pPayload != NULL ) && ( pPayloadSize != NULL ) );
 
+    err = decodeFileBlockView_Http( pMessageBuffer,
+                                    messageSize,
+                                    pFileId,
+                                    pBlockId,
+                                    pBlockSize,
+                                    &pBlock,
+                                    pPayloadSize );
+
+    if( err == OtaErrNone )
+    {
+        /* The data received over HTTP does not require any decoding. */
+        ( void ) memcpy( *pPayload, pBlock, *pPayloadSize );
+    }
+
+    return err;
+}
+
+/*
+ * The HTTP file block is the payload, so it is returned in place.
+ */
+OtaErr_t decodeFileBlockView_Http( const uint8_t * pMessageBuffer,
+                                   size_t messageSize,
+                                   int32_t * pFileId,
+                                   int32_t * pBlockId,
+                                   int32_t * pBlockSize,
+                                   const uint8_t ** ppPayload,
+                                   size_t * pPayloadSize )
+{
+    OtaErr_t err = OtaErrNone;
+
+    assert( ( pMessageBuffer != NULL ) && ( pFileId != NULL ) && ( pBlockId != NULL ) &&
+            ( pBlockSize != NULL ) && ( ppPayload != NULL ) && ( pPayloadSize != NULL ) );
+
     if( messageSize > OTA_FILE_BLOCK_SIZE )
     {
         LogError( ( "Incoming file block size %d larger than block size %d.",
@@ -148,10 +182,7 @@ OtaErr_t decodeFileBlock_Http( const uint8_t * pMessageBuffer,
         *pFileId = 0;
         *pBlockId = ( int32_t ) currBlock;
         *pBlockSize = ( int32_t ) messageSize;
-
-        /* The data received over HTTP does not require any decoding. */
-        ( void ) memcpy( *pPayload, pMessageBuffer, messageSize );
-
+        *ppPayload = pMessageBuffer;
         *pPayloadSize = messageSize;
 
         /* Current block is processed, set the file block to next. */
@@ -93,6 +93,7 @@ OtaErr_t setDataInterface( OtaDataInterface_t * pDataInterface,
             pDataInterface->initFileTransfer = initFileTransfer_Mqtt;
             pDataInterface->requestFileBlock = requestFileBlock_Mqtt;
             pDataInterface->decodeFileBlock = decodeFileBlock_Mqtt;
+            pDataInterface->decodeFileBlockView = decodeFileBlockView_Mqtt;
             pDataInterface->cleanup = cleanupData_Mqtt;
             err = OtaErrNone;
         }
@@ -104,6 +105,7 @@ OtaErr_t setDataInterface( OtaDataInterface_t * pDataInterface,
             pDataInterface->initFileTransfer = initFileTransfer_Http;
             pDataInterface->requestFileBlock = requestDataBlock_Http;
             pDataInterface->decodeFileBlock = decodeFileBlock_Http;
+            pDataInterface->decodeFileBlockView = decodeFileBlockView_Http;
             pDataInterface->cleanup = cleanupData_Http;
             err = OtaErrNone;
         }
@@ -114,6 +116,8 @@ OtaErr_t setDataInterface( OtaDataInterface_t * pDataInterface,
                 pDataInterface->initFileTransfer = initFileTransfer_Mqtt;
                 pDataInterface->requestFileBlock = requestFileBlock_Mqtt;
                 pDataInterface->decodeFileBlock = decodeFileBlock_Mqtt;
+                pDataInterface->decodeFileBlockView = decodeFileBlockView_Mqtt;
+            pDataInterface->decodeFileBlockView = decodeFileBlockView_Mqtt;
                 pDataInterface->cleanup = cleanupData_Mqtt;
                 err = OtaErrNone;
             }
@@ -122,6 +126,8 @@ OtaErr_t setDataInterface( OtaDataInterface_t * pDataInterface,
                 pDataInterface->initFileTransfer = initFileTransfer_Http;
                 pDataInterface->requestFileBlock = requestDataBlock_Http;
                 pDataInterface->decodeFileBlock = decodeFileBlock_Http;
+                pDataInterface->decodeFileBlockView = decodeFileBlockView_Http;
+            pDataInterface->decodeFileBlockView = decodeFileBlockView_Http;
                 pDataInterface->cleanup = cleanupData_Http;
                 err = OtaErrNone;
             }
@@ -131,6 +137,8 @@ OtaErr_t setDataInterface( OtaDataInterface_t * pDataInterface,
                 pDataInterface->initFileTransfer = initFileTransfer_Http;
                 pDataInterface->requestFileBlock = requestDataBlock_Http;
                 pDataInterface->decodeFileBlock = decodeFileBlock_Http;
+                pDataInterface->decodeFileBlockView = decodeFileBlockView_Http;
+            pDataInterface->decodeFileBlockView = decodeFileBlockView_Http;
                 pDataInterface->cleanup = cleanupData_Http;
                 err = OtaErrNone;
             }
@@ -139,6 +147,8 @@ OtaErr_t setDataInterface( OtaDataInterface_t * pDataInterface,
                 pDataInterface->initFileTransfer = initFileTransfer_Mqtt;
                 pDataInterface->requestFileBlock = requestFileBlock_Mqtt;
                 pDataInterface->decodeFileBlock = decodeFileBlock_Mqtt;
+                pDataInterface->decodeFileBlockView = decodeFileBlockView_Mqtt;
+            pDataInterface->decodeFileBlockView = decodeFileBlockView_Mqtt;
                 pDataInterface->cleanup = cleanupData_Mqtt;
                 err = OtaErrNone;
             }
@@ -257,6 +257,28 @@ static size_t stringBuilderUInt32Hex( char * pBuffer,
                                       size_t bufferSizeBytes,
                                       uint32_t value );
 
+/**
+ * @brief Select the blocks to ask for in the next stream data request.
+ *
+ * Blocks below the agent's next block to request are still in flight from an
+ * earlier request, so they are masked out of a copy of the receive bitmap to
+ * keep the service from sending them twice. The service sends the lowest
+ * numbered blocks still set in the bitmap, so the new request window ends after
+ * the last of those.
+ *
+ * @param[in] pAgentCtx The OTA agent context.
+ * @param[in] numBlocks Number of blocks in the file.
+ * @param[out] pRequestBitmap Buffer of OTA_MAX_BLOCK_BITMAP_SIZE bytes for the masked bitmap.
+ * @param[out] pNumRequested Number of blocks the request asks for.
+ * @param[out] pWindowEnd Index of the first block after the request window.
+ * @return const uint8_t* The bitmap to send, either pRequestBitmap or the receive bitmap.
+ */
+static const uint8_t * selectRequestedBlocks( const OtaAgentContext_t * pAgentCtx,
+                                              uint32_t numBlocks,
+                                              uint8_t * pRequestBitmap,
+                                              uint32_t * pNumRequested,
+                                              uint32_t * pWindowEnd );
+
 static size_t stringBuilder( char * pBuffer,
                              size_t bufferSizeBytes,
                              const char * const strings[] )
@@ -352,6 +374,52 @@ static size_t stringBuilderUInt32Hex( char * pBuffer,
     return size;
 }
 
+static const uint8_t * selectRequestedBlocks( const OtaAgentContext_t * pAgentCtx,
+                                              uint32_t numBlocks,
+                                              uint8_t * pRequestBitmap,
+                                              uint32_t * pNumRequested,
+                                              uint32_t * pWindowEnd )
+{
+    const uint8_t * pBitmap = pAgentCtx->fileContext.pRxBlockBitmap;
+    uint32_t bitmapLen = ( numBlocks + ( BITS_PER_BYTE - 1U ) ) >> LOG2_BITS_PER_BYTE;
+    uint32_t blockIndex = pAgentCtx->nextBlockToRequest;
+    uint32_t numRequested = 0;
+
+    assert( pBitmap != NULL );
+
+    if( bitmapLen > OTA_MAX_BLOCK_BITMAP_SIZE )
+    {
+        /* Too large to copy, so ask for every missing block. */
+        blockIndex = 0;
+    }
+    else if( ( blockIndex > 0U ) && ( blockIndex < numBlocks ) )
+    {
+        ( void ) memcpy( pRequestBitmap, pBitmap, bitmapLen );
+        ( void ) memset( pRequestBitmap, 0, blockIndex >> LOG2_BITS_PER_BYTE );
+        pRequestBitmap[ blockIndex >> LOG2_BITS_PER_BYTE ] &= ( uint8_t ) ( 0xFFU << ( blockIndex % BITS_PER_BYTE ) );
+        pBitmap = pRequestBitmap;
+    }
+    else
+    {
+        /* Either nothing or every missing block is in flight. */
+    }
+
+    while( ( blockIndex < numBlocks ) && ( numRequested < otaconfigMAX_NUM_BLOCKS_REQUEST ) )
+    {
+        if( ( pBitmap[ blockIndex >> LOG2_BITS_PER_BYTE ] & ( 1U << ( blockIndex % BITS_PER_BYTE ) ) ) != 0U )
+        {
+            numRequested++;
+        }
+
+        blockIndex++;
+    }
+
+    *pNumRequested = numRequested;
+    *pWindowEnd = blockIndex;
+
+    return pBitmap;
+}
+
 /*
  * Subscribe to the OTA job notification topics.
  */
@@ -1094,8 +1162,12 @@ OtaErr_t requestFileBlock_Mqtt( OtaAgentContext_t * pAgentCtx )
     uint32_t bitmapLen = 0;
     uint32_t msgSizeToPublish = 0;
     uint32_t topicLen = 0;
+    uint32_t numRequested = otaconfigMAX_NUM_BLOCKS_REQUEST;
+    uint32_t windowEnd = 0;
     bool cborEncodeRet = false;
     char pMsg[ OTA_REQUEST_MSG_MAX_SIZE ];
+    uint8_t pRequestBitmap[ OTA_MAX_BLOCK_BITMAP_SIZE ];
+    const uint8_t * pBitmap = NULL;
 
     /* This buffer is used to store the generated MQTT topic. The static size
      * is calculated from the template and the corresponding parameters. */
@@ -1123,65 +1195,81 @@ OtaErr_t requestFileBlock_Mqtt( OtaAgentContext_t * pAgentCtx )
 
     pTopicParts[ 1 ] = ( const char * ) pAgentCtx->pThingName;
     pTopicParts[ 3 ] = ( const char * ) pFileContext->pStreamName;
-
-    /* Reset number of blocks requested. */
-    pAgentCtx->numOfBlocksToReceive = otaconfigMAX_NUM_BLOCKS_REQUEST;
+    pBitmap = pFileContext->pRxBlockBitmap;
 
     numBlocks = ( pFileContext->fileSize + ( OTA_FILE_BLOCK_SIZE - 1U ) ) >> otaconfigLOG2_FILE_BLOCK_SIZE;
     bitmapLen = ( numBlocks + ( BITS_PER_BYTE - 1U ) ) >> LOG2_BITS_PER_BYTE;
 
-    cborEncodeRet = OTA_CBOR_Encode_GetStreamRequestMessage( ( uint8_t * ) pMsg,
-                                                             sizeof( pMsg ),
-                                                             &msgSizeFromStream,
-                                                             OTA_CLIENT_TOKEN,
-                                                             ( int32_t ) pFileContext->serverFileID,
-                                                             ( int32_t ) blockSize,
-                                                             0,
-                                                             pFileContext->pRxBlockBitmap,
-                                                             bitmapLen,
-                                                             ( int32_t ) otaconfigMAX_NUM_BLOCKS_REQUEST );
-
-    if( cborEncodeRet == true )
+    if( pBitmap != NULL )
     {
-        msgSizeToPublish = ( uint32_t ) msgSizeFromStream;
-
-        /* Try to build the dynamic data REQUEST topic to publish to. */
-
-        topicLen = ( uint32_t ) stringBuilder(
-            pTopicBuffer,
-            sizeof( pTopicBuffer ),
-            pTopicParts );
-
-        /* The buffer is static and the size is calculated to fit. */
-        assert( ( topicLen > 0U ) && ( topicLen < sizeof( pTopicBuffer ) ) );
-
-        mqttStatus = pAgentCtx->pOtaInterface->mqtt.publish( pTopicBuffer,
-                                                             ( uint16_t ) topicLen,
-                                                             &pMsg[ 0 ],
-                                                             msgSizeToPublish,
-                                                             0 );
+        pBitmap = selectRequestedBlocks( pAgentCtx, numBlocks, pRequestBitmap, &numRequested, &windowEnd );
+    }
 
-        if( mqttStatus == OtaMqttSuccess )
+    if( ( numRequested == 0U ) && ( pAgentCtx->numOfBlocksToReceive > 0U ) )
+    {
+        /* Every missing block is already in flight. */
+        LogDebug( ( "Skipped data request: All missing blocks have been requested." ) );
+        result = OtaErrNone;
+    }
+    else
+    {
+        cborEncodeRet = OTA_CBOR_Encode_GetStreamRequestMessage( ( uint8_t * ) pMsg,
+                                                                 sizeof( pMsg ),
+                                                                 &msgSizeFromStream,
+                                                                 OTA_CLIENT_TOKEN,
+                                                                 ( int32_t ) pFileContext->serverFileID,
+                                                                 ( int32_t ) blockSize,
+                                                                 0,
+                                                                 pBitmap,
+                                                                 bitmapLen,
+                                                                 ( int32_t ) otaconfigMAX_NUM_BLOCKS_REQUEST );
+
+        if( cborEncodeRet == true )
         {
-            LogInfo( ( "Published to MQTT topic to request the next block: "
-                       "topic=%s",
-                       pTopicBuffer ) );
-            result = OtaErrNone;
+            msgSizeToPublish = ( uint32_t ) msgSizeFromStream;
+
+            /* Try to build the dynamic data REQUEST topic to publish to. */
+
+            topicLen = ( uint32_t ) stringBuilder(
+                pTopicBuffer,
+                sizeof( pTopicBuffer ),
+                pTopicParts );
+
+            /* The buffer is static and the size is calculated to fit. */
+            assert( ( topicLen > 0U ) && ( topicLen < sizeof( pTopicBuffer ) ) );
+
+            mqttStatus = pAgentCtx->pOtaInterface->mqtt.publish( pTopicBuffer,
+                                                                 ( uint16_t ) topicLen,
+                                                                 &pMsg[ 0 ],
+                                                                 msgSizeToPublish,
+                                                                 0 );
+
+            if( mqttStatus == OtaMqttSuccess )
+            {
+                LogInfo( ( "Published to MQTT topic to request the next block: "
+                           "topic=%s",
+                           pTopicBuffer ) );
+                result = OtaErrNone;
+
+                /* The requested blocks are now in flight. */
+                pAgentCtx->numOfBlocksToReceive += numRequested;
+                pAgentCtx->nextBlockToRequest = windowEnd;
+            }
+            else
+            {
+                LogError( ( "Failed to publish MQTT message: "
+                            "publish returned error: "
+                            "OtaMqttStatus_t=%s",
+                            OTA_MQTT_strerror( mqttStatus ) ) );
+            }
         }
         else
         {
-            LogError( ( "Failed to publish MQTT message: "
-                        "publish returned error: "
-                        "OtaMqttStatus_t=%s",
-                        OTA_MQTT_strerror( mqttStatus ) ) );
+            result = OtaErrFailedToEncodeCbor;
+            LogError( ( "Failed to CBOR encode stream request message: "
+                        "OTA_CBOR_Encode_GetStreamRequestMessage returned error." ) );
         }
     }
-    else
-    {
-        result = OtaErrFailedToEncodeCbor;
-        LogError( ( "Failed to CBOR encode stream request message: "
-                    "OTA_CBOR_Encode_GetStreamRequestMessage returned error." ) );
-    }
 
     return result;
 }
@@ -1225,6 +1313,43 @@ OtaErr_t decodeFileBlock_Mqtt( const uint8_t * pMessageBuffer,
     return result;
 }
 
+/*
+ * Decode a cbor encoded fileblock received from streaming service, leaving
+ * the payload in the message buffer.
+ */
+OtaErr_t decodeFileBlockView_Mqtt( const uint8_t * pMessageBuffer,
+                                   size_t messageSize,
+                                   int32_t * pFileId,
+                                   int32_t * pBlockId,
+                                   int32_t * pBlockSize,
+                                   const uint8_t ** ppPayload,
+                                   size_t * pPayloadSize )
+{
+    OtaErr_t result = OtaErrFailedToDecodeCbor;
+    bool cborDecodeRet = false;
+
+    /* Decode the CBOR content. */
+    cborDecodeRet = OTA_CBOR_Decode_GetStreamResponseMessageView( pMessageBuffer,
+                                                                  messageSize,
+                                                                  pFileId,
+                                                                  pBlockId,   /* CBOR requires pointer to int and our block indices never exceed 31 bits. */
+                                                                  pBlockSize, /* CBOR requires pointer to int and our block sizes never exceed 31 bits. */
+                                                                  ppPayload,  /* This points into pMessageBuffer and must not be freed. */
+                                                                  pPayloadSize );
+
+    if( cborDecodeRet == true )
+    {
+        result = OtaErrNone;
+    }
+    else
+    {
+        LogError( ( "Failed to decode MQTT file block: "
+                    "OTA_CBOR_Decode_GetStreamResponseMessageView returned error." ) );
+    }
+
+    return result;
+}
+
 /*
  * Perform any cleanup operations required for control plane.
  */
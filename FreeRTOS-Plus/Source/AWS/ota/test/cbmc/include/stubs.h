@@ -94,6 +94,15 @@ OtaErr_t decodeFileBlockStub( const uint8_t * pMessageBuffer,
                               uint8_t ** pPayload,
                               size_t * pPayloadSize );
 
+/* Stub to decode file block in place. */
+OtaErr_t decodeFileBlockViewStub( const uint8_t * pMessageBuffer,
+                                  size_t messageSize,
+                                  int32_t * pFileId,
+                                  int32_t * pBlockId,
+                                  int32_t * pBlockSize,
+                                  const uint8_t ** ppPayload,
+                                  size_t * pPayloadSize );
+
 /* Stub to free memory. */
 void freeMemStub( void * ptr );
 
@@ -103,6 +112,11 @@ int16_t writeBlockPalStub( OtaFileContext_t * const pFileContext,
                            uint8_t * const pData,
                            uint32_t blockSize );
 
+/* Stub to hash received file data. */
+OtaPalStatus_t updateDigestPalStub( OtaFileContext_t * const pFileContext,
+                                    const uint8_t * pData,
+                                    uint32_t dataSize );
+
 /* Stub to close a file. */
 OtaPalStatus_t closeFilePalStub( OtaFileContext_t * const pFileContext );
 
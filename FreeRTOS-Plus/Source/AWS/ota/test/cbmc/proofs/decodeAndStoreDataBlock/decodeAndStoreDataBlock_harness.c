@@ -65,6 +65,9 @@ void decodeAndStoreDataBlock_harness()
 
     otaDataInterface.decodeFileBlock = decodeFileBlockStub;
 
+    /* The in place decoder is optional in the data interface. */
+    otaDataInterface.decodeFileBlockView = nondet_bool() ? decodeFileBlockViewStub : NULL;
+
     /* otaAgent.pOtaInterface can never be NULL as it is always checked at the start of the OTA
      * Agent specifically in receiveAndProcessOTAEvent function.*/
     otaAgent.pOtaInterface = &otaInterface;
@@ -80,7 +83,8 @@ void decodeAndStoreDataBlock_harness()
                       ( result <= IngestResultDuplicate_Continue ),
                       "Invalid return value from decodeAndStoreDataBlock:Expected value should be from IngestResult_t enum." );
 
-    if( pPayload != NULL )
+    /* A payload decoded in place points into pRawMsg. */
+    if( ( pPayload != NULL ) && ( otaDataInterface.decodeFileBlockView == NULL ) )
     {
         free( pPayload );
     }
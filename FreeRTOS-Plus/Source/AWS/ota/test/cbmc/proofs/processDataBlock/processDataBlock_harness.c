@@ -83,8 +83,15 @@ void processDataBlock_harness()
     __CPROVER_assume( ( uBlockSize == OTA_FILE_BLOCK_SIZE ) ||
                       ( ( fileContext.blocksRemaining == 1 ) && ( uBlockSize < OTA_FILE_BLOCK_SIZE ) ) );
 
+    /* validateDataBlock only accepts blocks within the file, and the bitmap
+     * covers every block of the file. */
+    __CPROVER_assume( fileContext.fileSize <= ( ( OTA_MAX_BLOCK_BITMAP_SIZE << 3 ) * OTA_FILE_BLOCK_SIZE ) );
+    __CPROVER_assume( ( ( uBlockIndex * OTA_FILE_BLOCK_SIZE ) + uBlockSize ) <= fileContext.fileSize );
+    __CPROVER_assume( fileContext.digestSize <= fileContext.fileSize );
+
     /* CBMC preconditions. */
     otaInterface.pal.writeBlock = writeBlockPalStub;
+    otaInterface.pal.updateDigest = updateDigestPalStub;
     otaAgent.pOtaInterface = &otaInterface;
 
     result = processDataBlock( &fileContext, uBlockIndex, uBlockSize, &closeResult, pPayload );
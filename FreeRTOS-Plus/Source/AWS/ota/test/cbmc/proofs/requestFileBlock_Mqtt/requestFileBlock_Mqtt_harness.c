@@ -54,6 +54,29 @@ size_t __CPROVER_file_local_ota_mqtt_c_stringBuilder( char * pBuffer,
     return stringSize;
 }
 
+/* Stub to select the blocks to request. */
+const uint8_t * __CPROVER_file_local_ota_mqtt_c_selectRequestedBlocks( const OtaAgentContext_t * pAgentCtx,
+                                                                       uint32_t numBlocks,
+                                                                       uint8_t * pRequestBitmap,
+                                                                       uint32_t * pNumRequested,
+                                                                       uint32_t * pWindowEnd )
+{
+    uint32_t numRequested;
+    uint32_t windowEnd;
+
+    __CPROVER_assert( pAgentCtx != NULL, "Error: Expected a Non-Null value for pAgentCtx" );
+    __CPROVER_assert( pRequestBitmap != NULL, "Error: Expected a Non-Null value for pRequestBitmap" );
+
+    /* At most otaconfigMAX_NUM_BLOCKS_REQUEST blocks are requested, all of them in the file. */
+    __CPROVER_assume( numRequested <= otaconfigMAX_NUM_BLOCKS_REQUEST );
+    __CPROVER_assume( windowEnd <= numBlocks );
+
+    *pNumRequested = numRequested;
+    *pWindowEnd = windowEnd;
+
+    return pAgentCtx->fileContext.pRxBlockBitmap;
+}
+
 /* Stub to encode the stream request message. */
 bool OTA_CBOR_Encode_GetStreamRequestMessage( uint8_t * pMessageBuffer,
                                               size_t messageBufferSize,
@@ -256,6 +256,39 @@ OtaErr_t decodeFileBlockStub( const uint8_t * pMessageBuffer,
     return err;
 }
 
+OtaErr_t decodeFileBlockViewStub( const uint8_t * pMessageBuffer,
+                                  size_t messageSize,
+                                  int32_t * pFileId,
+                                  int32_t * pBlockId,
+                                  int32_t * pBlockSize,
+                                  const uint8_t ** ppPayload,
+                                  size_t * pPayloadSize )
+{
+    OtaErr_t err;
+    size_t payloadSize;
+
+    /* err must have values only from the OtaErr_t enum. */
+    __CPROVER_assume( ( err >= OtaErrNone ) && ( err <= OtaErrActivateFailed ) );
+
+    /* Pre-conditions.
+     * ppPayload, pPayloadSize, pFileId, pBlockId, pBlockSize are statically initialized in
+     * decodeAndStoreDataBlock before calling this stub and hence cannot be NULL.
+     */
+    __CPROVER_assert( ppPayload != NULL, "Invalid ppPayload value: ppPayload cannot be NULL." );
+    __CPROVER_assert( pMessageBuffer != NULL, "Invalid pMessageBuffer value: pMessageBuffer cannot be NULL." );
+    __CPROVER_assert( pPayloadSize != NULL, "Invalid pPayloadSize value: pPayloadSize cannot be NULL." );
+    __CPROVER_assert( pFileId != NULL, "Invalid pFileId value: pFileId cannot be NULL." );
+    __CPROVER_assert( pBlockId != NULL, "Invalid pBlockId value: pBlockId cannot be NULL." );
+    __CPROVER_assert( pBlockSize != NULL, "Invalid pBlockSize value: pBlockSize cannot be NULL." );
+
+    /* The payload always lies within the message. */
+    __CPROVER_assume( payloadSize <= messageSize );
+    *ppPayload = pMessageBuffer + ( messageSize - payloadSize );
+    *pPayloadSize = payloadSize;
+
+    return err;
+}
+
 void freeMemStub( void * ptr )
 {
     free( ptr );
@@ -277,6 +310,23 @@ int16_t writeBlockPalStub( OtaFileContext_t * const pFileContext,
     return bytesWritten;
 }
 
+OtaPalStatus_t updateDigestPalStub( OtaFileContext_t * const pFileContext,
+                                    const uint8_t * pData,
+                                    uint32_t dataSize )
+{
+    OtaPalStatus_t status;
+
+    __CPROVER_assert( pFileContext != NULL, "Error: Expected a Non-Null value for pFileContext" );
+
+    __CPROVER_assert( dataSize <= ( pFileContext->fileSize - pFileContext->digestSize ),
+                      "Error: Expected the digest to stay within the file" );
+
+    /* A NULL pData asks for data already stored in the file. */
+    __CPROVER_assert( ( pData != NULL ) || ( dataSize > 0U ), "Error: Expected a non-zero dataSize for stored data" );
+
+    return status;
+}
+
 OtaPalStatus_t closeFilePalStub( OtaFileContext_t * const pFileContext )
 {
     OtaPalStatus_t status;
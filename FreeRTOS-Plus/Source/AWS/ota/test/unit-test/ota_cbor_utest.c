@@ -145,6 +145,175 @@ void test_OTA_CborDecodeStreamResponse()
     }
 }
 
+/**
+ * @brief Test OTA_CBOR_Decode_GetStreamResponseMessageView() returns the
+ * payload in place.
+ *
+ */
+void test_OTA_CborDecodeStreamResponseView()
+{
+    uint8_t blockPayload[ OTA_FILE_BLOCK_SIZE ] = { 0 };
+    uint8_t cborWork[ CBOR_TEST_MESSAGE_BUFFER_SIZE ] = { 0 };
+    size_t encodedSize = 0;
+    int fileId = -1;
+    int blockIndex = -1;
+    int blockSize = -1;
+    const uint8_t * pDecodedPayload = NULL;
+    size_t payloadSize = OTA_FILE_BLOCK_SIZE;
+    bool result = false;
+    int i = 0;
+
+    for( i = 0; i < ( int ) sizeof( blockPayload ); i++ )
+    {
+        blockPayload[ i ] = i % UINT8_MAX;
+    }
+
+    result = createOtaStreamingMessage(
+        cborWork,
+        sizeof( cborWork ),
+        CBOR_TEST_BLOCKIDENTITY_VALUE,
+        blockPayload,
+        sizeof( blockPayload ),
+        &encodedSize,
+        true );
+
+    TEST_ASSERT_EQUAL( CborNoError, result );
+
+    result = OTA_CBOR_Decode_GetStreamResponseMessageView(
+        cborWork,
+        encodedSize,
+        &fileId,
+        &blockIndex,
+        &blockSize,
+        &pDecodedPayload,
+        &payloadSize );
+
+    TEST_ASSERT_TRUE( result );
+    TEST_ASSERT_EQUAL( CBOR_TEST_FILEIDENTITY_VALUE, fileId );
+    TEST_ASSERT_EQUAL( CBOR_TEST_BLOCKIDENTITY_VALUE, blockIndex );
+    TEST_ASSERT_EQUAL( OTA_FILE_BLOCK_SIZE, blockSize );
+    TEST_ASSERT_EQUAL( OTA_FILE_BLOCK_SIZE, payloadSize );
+
+    /* The payload is the tail of the message, not a copy of it. */
+    TEST_ASSERT_EQUAL_PTR( &cborWork[ encodedSize - OTA_FILE_BLOCK_SIZE ], pDecodedPayload );
+    TEST_ASSERT_EQUAL_UINT8_ARRAY( blockPayload, pDecodedPayload, OTA_FILE_BLOCK_SIZE );
+}
+
+/**
+ * @brief Test OTA_CBOR_Decode_GetStreamResponseMessageView() fails for
+ * invalid parameters and payloads that cannot be returned in place.
+ *
+ */
+void test_OTA_CborDecodeStreamResponseView_Invalid()
+{
+    uint8_t blockPayload[ OTA_FILE_BLOCK_SIZE ] = { 0 };
+    uint8_t cborWork[ CBOR_TEST_MESSAGE_BUFFER_SIZE ] = { 0 };
+    size_t encodedSize = 0;
+    int fileId = -1;
+    int blockIndex = -1;
+    int blockSize = -1;
+    const uint8_t * pDecodedPayload = NULL;
+    uint8_t copiedPayload[ OTA_FILE_BLOCK_SIZE ] = { 0 };
+    uint8_t * pCopyPayload = copiedPayload;
+    size_t payloadSize = OTA_FILE_BLOCK_SIZE;
+    bool result = false;
+
+    /* {"f": 1, "i": 0, "l": 2, "p": (_ h'01', h'02')} */
+    uint8_t chunkedMessage[] =
+    {
+        0xa4, 0x61, 0x66, 0x01, 0x61, 0x69, 0x00, 0x61, 0x6c, 0x02,
+        0x61, 0x70, 0x5f, 0x41, 0x01, 0x41, 0x02, 0xff
+    };
+
+    result = createOtaStreamingMessage(
+        cborWork,
+        sizeof( cborWork ),
+        CBOR_TEST_BLOCKIDENTITY_VALUE,
+        blockPayload,
+        sizeof( blockPayload ),
+        &encodedSize,
+        true );
+    TEST_ASSERT_EQUAL( CborNoError, result );
+
+    /* Test that decoding fails with invalid parameters. */
+    result = OTA_CBOR_Decode_GetStreamResponseMessageView(
+        NULL,
+        encodedSize,
+        &fileId,
+        &blockIndex,
+        &blockSize,
+        &pDecodedPayload,
+        &payloadSize );
+    TEST_ASSERT_FALSE( result );
+
+    result = OTA_CBOR_Decode_GetStreamResponseMessageView(
+        cborWork,
+        encodedSize,
+        &fileId,
+        &blockIndex,
+        &blockSize,
+        NULL,
+        &payloadSize );
+    TEST_ASSERT_FALSE( result );
+
+    result = OTA_CBOR_Decode_GetStreamResponseMessageView(
+        cborWork,
+        encodedSize,
+        &fileId,
+        &blockIndex,
+        &blockSize,
+        &pDecodedPayload,
+        NULL );
+    TEST_ASSERT_FALSE( result );
+
+    /* Test that decoding fails when the payload runs past the end of the message. */
+    result = OTA_CBOR_Decode_GetStreamResponseMessageView(
+        cborWork,
+        encodedSize - 1,
+        &fileId,
+        &blockIndex,
+        &blockSize,
+        &pDecodedPayload,
+        &payloadSize );
+    TEST_ASSERT_FALSE( result );
+
+    /* Test that decoding fails when the payload is larger than the maximum size. */
+    payloadSize = OTA_FILE_BLOCK_SIZE - 1;
+    result = OTA_CBOR_Decode_GetStreamResponseMessageView(
+        cborWork,
+        encodedSize,
+        &fileId,
+        &blockIndex,
+        &blockSize,
+        &pDecodedPayload,
+        &payloadSize );
+    TEST_ASSERT_FALSE( result );
+
+    /* Test that decoding fails for an indefinite length payload, which is
+     * still accepted by the copying decoder. */
+    payloadSize = OTA_FILE_BLOCK_SIZE;
+    result = OTA_CBOR_Decode_GetStreamResponseMessageView(
+        chunkedMessage,
+        sizeof( chunkedMessage ),
+        &fileId,
+        &blockIndex,
+        &blockSize,
+        &pDecodedPayload,
+        &payloadSize );
+    TEST_ASSERT_FALSE( result );
+
+    result = OTA_CBOR_Decode_GetStreamResponseMessage(
+        chunkedMessage,
+        sizeof( chunkedMessage ),
+        &fileId,
+        &blockIndex,
+        &blockSize,
+        &pCopyPayload,
+        &payloadSize );
+    TEST_ASSERT_TRUE( result );
+    TEST_ASSERT_EQUAL( 2, payloadSize );
+}
+
 /**
  * @brief Test OTA_CBOR_Encode throws an error with invalid(NULL) parameters.
  *
@@ -153,6 +153,11 @@ static uint8_t pLargerJobNameBuffer[ OTA_JOB_ID_MAX_SIZE * 2 ];
 /* A counter to record how many file blocks are received. */
 static int otaReceivedFileBlockNumber = 0;
 
+/* Number of bytes and calls seen by the PAL digest mock. */
+static uint32_t otaDigestSize = 0;
+static int otaDigestCalls = 0;
+static int otaDigestStoredCalls = 0;
+
 /* A boolean reflecting the state of the self-test timer. */
 static bool bSelfTestTimerIsActive = false;
 
@@ -681,6 +686,43 @@ int16_t mockPalWriteBlockPartialWrite( OtaFileContext_t * const unused1,
     return 1;
 }
 
+OtaPalStatus_t mockPalUpdateDigest( OtaFileContext_t * const pFileContext,
+                                    const uint8_t * pData,
+                                    uint32_t dataSize )
+{
+    /* Data must be hashed in file order, after it has been written. NULL data
+     * is read back from the file by a real PAL. */
+    TEST_ASSERT_EQUAL( otaDigestSize, pFileContext->digestSize );
+    TEST_ASSERT_LESS_OR_EQUAL( pFileContext->fileSize, otaDigestSize + dataSize );
+
+    if( pData != NULL )
+    {
+        TEST_ASSERT_EQUAL_MEMORY( pOtaFileBuffer + otaDigestSize, pData, dataSize );
+    }
+    else
+    {
+        otaDigestStoredCalls++;
+    }
+
+    otaDigestSize += dataSize;
+    otaDigestCalls++;
+
+    return OTA_PAL_COMBINE_ERR( OtaPalSuccess, 0 );
+}
+
+OtaPalStatus_t mockPalUpdateDigestAlwaysFail( OtaFileContext_t * const pFileContext,
+                                              const uint8_t * pData,
+                                              uint32_t dataSize )
+{
+    ( void ) pFileContext;
+    ( void ) pData;
+    ( void ) dataSize;
+
+    otaDigestCalls++;
+
+    return OTA_PAL_COMBINE_ERR( OtaPalUninitialized, 0 );
+}
+
 OtaPalStatus_t mockPalActivate( OtaFileContext_t * const pFileContext )
 {
     ( void ) pFileContext;
@@ -819,6 +861,7 @@ static void otaInterfaceDefault()
     otaInterfaces.pal.reset = mockPalResetDevice;
     otaInterfaces.pal.setPlatformImageState = mockPalSetPlatformImageState;
     otaInterfaces.pal.getPlatformImageState = mockPalGetPlatformImageState;
+    otaInterfaces.pal.updateDigest = NULL;
 }
 
 static void otaAppBufferDefault()
@@ -980,6 +1023,9 @@ void setUp()
     otaAppBufferDefault();
 
     otaReceivedFileBlockNumber = 0;
+    otaDigestSize = 0;
+    otaDigestCalls = 0;
+    otaDigestStoredCalls = 0;
 }
 
 void tearDown()
@@ -1845,6 +1891,54 @@ void test_OTA_RequestFileBlockHttpOneBlock()
     otaRequestFileBlock();
 }
 
+void test_OTA_RequestFileBlockSkipsBlocksInFlight()
+{
+    OtaErr_t err = OtaErrUninitialized;
+
+    pOtaJobDoc = JOB_DOC_A;
+    otaRequestFileBlock();
+
+    /* The first request asks for every block of the small test file. */
+    TEST_ASSERT_EQUAL( OTA_TEST_FILE_NUM_BLOCKS, otaAgent.numOfBlocksToReceive );
+    TEST_ASSERT_EQUAL( OTA_TEST_FILE_NUM_BLOCKS, otaAgent.nextBlockToRequest );
+
+    /* Nothing is left to ask for while all of them are in flight. */
+    otaInterfaces.mqtt.publish = stubMqttPublishAlwaysFail;
+    err = requestFileBlock_Mqtt( &otaAgent );
+    TEST_ASSERT_EQUAL( OtaErrNone, err );
+    TEST_ASSERT_EQUAL( OTA_TEST_FILE_NUM_BLOCKS, otaAgent.numOfBlocksToReceive );
+    TEST_ASSERT_EQUAL( OTA_TEST_FILE_NUM_BLOCKS, otaAgent.nextBlockToRequest );
+
+    /* With only the first block in flight, the rest are requested. */
+    otaInterfaces.mqtt.publish = stubMqttPublish;
+    otaAgent.numOfBlocksToReceive = 1;
+    otaAgent.nextBlockToRequest = 1;
+    err = requestFileBlock_Mqtt( &otaAgent );
+    TEST_ASSERT_EQUAL( OtaErrNone, err );
+    TEST_ASSERT_EQUAL( OTA_TEST_FILE_NUM_BLOCKS, otaAgent.numOfBlocksToReceive );
+    TEST_ASSERT_EQUAL( OTA_TEST_FILE_NUM_BLOCKS, otaAgent.nextBlockToRequest );
+}
+
+void test_OTA_RequestFileBlockTimeoutRequestsAllMissingBlocks()
+{
+    OtaEventMsg_t otaEvent = { 0 };
+
+    pOtaJobDoc = JOB_DOC_A;
+    otaRequestFileBlock();
+
+    /* Pretend more blocks were requested than can ever arrive. */
+    otaAgent.numOfBlocksToReceive = 2 * OTA_TEST_FILE_NUM_BLOCKS;
+
+    /* A timeout forgets the blocks in flight and asks for all missing blocks again. */
+    otaInterfaces.os.event.send = mockOSEventSend;
+    otaEvent.eventId = OtaAgentEventRequestTimer;
+    OTA_SignalEvent( &otaEvent );
+    receiveAndProcessOtaEvent();
+    TEST_ASSERT_EQUAL( OtaAgentStateWaitingForFileBlock, OTA_GetState() );
+    TEST_ASSERT_EQUAL( OTA_TEST_FILE_NUM_BLOCKS, otaAgent.numOfBlocksToReceive );
+    TEST_ASSERT_EQUAL( OTA_TEST_FILE_NUM_BLOCKS, otaAgent.nextBlockToRequest );
+}
+
 void test_OTA_RequestFileBlockTimerFails()
 {
     OtaEventMsg_t otaEvent = { 0 };
@@ -2147,6 +2241,142 @@ void test_OTA_ReceiveFileBlockCompleteDifferentFileTypeMqtt()
     test_OTA_ReceiveFileBlockCompleteMqtt();
 }
 
+void test_OTA_ReceiveFileBlockCompleteMqttDigest()
+{
+    otaInterfaces.pal.updateDigest = mockPalUpdateDigest;
+    test_OTA_ReceiveFileBlockCompleteMqtt();
+
+    /* Every block arrived in order, so the whole file was hashed exactly once. */
+    TEST_ASSERT_EQUAL( OTA_TEST_FILE_SIZE, otaDigestSize );
+    TEST_ASSERT_EQUAL( OTA_TEST_FILE_NUM_BLOCKS, otaDigestCalls );
+}
+
+void test_OTA_ReceiveFileBlockOutOfOrderDigest()
+{
+    OtaEventMsg_t otaEvent = { 0 };
+    OtaEventData_t eventBuffers[ 3 ];
+    uint8_t pFileBlock[ OTA_FILE_BLOCK_SIZE ] = { 0 };
+    uint8_t pStreamingMessage[ OTA_FILE_BLOCK_SIZE * 2 ] = { 0 };
+    size_t streamingMessageSize = 0;
+    int blockIndex[ 3 ] = { 1, 0, 2 };
+    uint32_t blockSize[ 3 ] = { OTA_FILE_BLOCK_SIZE, OTA_FILE_BLOCK_SIZE, OTA_TEST_FILE_SIZE - ( 2 * OTA_FILE_BLOCK_SIZE ) };
+    int idx = 0;
+
+    otaInterfaces.pal.updateDigest = mockPalUpdateDigest;
+
+    otaGoToState( OtaAgentStateWaitingForFileBlock );
+    TEST_ASSERT_EQUAL( OtaAgentStateWaitingForFileBlock, OTA_GetState() );
+
+    otaInterfaces.os.event.send = mockOSEventSend;
+
+    for( idx = 0; idx < ( int ) sizeof( pFileBlock ); idx++ )
+    {
+        pFileBlock[ idx ] = idx % UINT8_MAX;
+    }
+
+    /* Block 1 lands before block 0, then the last block arrives in order. */
+    for( idx = 0; idx < 3; idx++ )
+    {
+        createOtaStreamingMessage(
+            pStreamingMessage,
+            sizeof( pStreamingMessage ),
+            blockIndex[ idx ],
+            pFileBlock,
+            blockSize[ idx ],
+            &streamingMessageSize,
+            true );
+
+        otaEvent.eventId = OtaAgentEventReceivedFileBlock;
+        otaEvent.pEventData = &eventBuffers[ idx ];
+        memcpy( otaEvent.pEventData->data, pStreamingMessage, streamingMessageSize );
+        otaEvent.pEventData->dataLength = streamingMessageSize;
+        OTA_SignalEvent( &otaEvent );
+
+        processEntireQueue();
+
+        if( idx == 0 )
+        {
+            /* Block 1 does not follow the hashed data, so it is only stored. */
+            TEST_ASSERT_EQUAL( 0, otaDigestSize );
+            TEST_ASSERT_EQUAL( 0, otaDigestCalls );
+        }
+        else if( idx == 1 )
+        {
+            /* Block 0 fills the gap: it is hashed, then block 1 is read back. */
+            TEST_ASSERT_EQUAL( 2 * OTA_FILE_BLOCK_SIZE, otaDigestSize );
+            TEST_ASSERT_EQUAL( 2 * OTA_FILE_BLOCK_SIZE, otaAgent.fileContext.digestSize );
+            TEST_ASSERT_EQUAL( 2, otaDigestCalls );
+            TEST_ASSERT_EQUAL( 1, otaDigestStoredCalls );
+        }
+        else
+        {
+            /* The last block follows the hashed data again. */
+            TEST_ASSERT_EQUAL( OTA_TEST_FILE_SIZE, otaDigestSize );
+            TEST_ASSERT_EQUAL( 3, otaDigestCalls );
+            TEST_ASSERT_EQUAL( 1, otaDigestStoredCalls );
+        }
+    }
+
+    /* OTA agent should complete the update and go back to waiting for job state. */
+    receiveAndProcessOtaEvent();
+    TEST_ASSERT_EQUAL( OtaAgentStateWaitingForJob, OTA_GetState() );
+}
+
+void test_OTA_ReceiveFileBlockGapDigestToEndOfFile()
+{
+    OtaEventMsg_t otaEvent = { 0 };
+    OtaEventData_t eventBuffers[ 3 ];
+    uint8_t pFileBlock[ OTA_FILE_BLOCK_SIZE ] = { 0 };
+    uint8_t pStreamingMessage[ OTA_FILE_BLOCK_SIZE * 2 ] = { 0 };
+    size_t streamingMessageSize = 0;
+    int blockIndex[ 3 ] = { 2, 1, 0 };
+    uint32_t blockSize[ 3 ] = { OTA_TEST_FILE_SIZE - ( 2 * OTA_FILE_BLOCK_SIZE ), OTA_FILE_BLOCK_SIZE, OTA_FILE_BLOCK_SIZE };
+    int idx = 0;
+
+    otaInterfaces.pal.updateDigest = mockPalUpdateDigest;
+
+    otaGoToState( OtaAgentStateWaitingForFileBlock );
+    TEST_ASSERT_EQUAL( OtaAgentStateWaitingForFileBlock, OTA_GetState() );
+
+    otaInterfaces.os.event.send = mockOSEventSend;
+
+    /* The blocks arrive last to first. */
+    for( idx = 0; idx < 3; idx++ )
+    {
+        createOtaStreamingMessage(
+            pStreamingMessage,
+            sizeof( pStreamingMessage ),
+            blockIndex[ idx ],
+            pFileBlock,
+            blockSize[ idx ],
+            &streamingMessageSize,
+            true );
+
+        otaEvent.eventId = OtaAgentEventReceivedFileBlock;
+        otaEvent.pEventData = &eventBuffers[ idx ];
+        memcpy( otaEvent.pEventData->data, pStreamingMessage, streamingMessageSize );
+        otaEvent.pEventData->dataLength = streamingMessageSize;
+        OTA_SignalEvent( &otaEvent );
+    }
+
+    processEntireQueue();
+
+    /* Block 0 is hashed, then the stored blocks are read back up to the end of
+     * the file, which is shorter than a whole number of blocks. */
+    TEST_ASSERT_EQUAL( OTA_TEST_FILE_SIZE, otaDigestSize );
+    TEST_ASSERT_EQUAL( 2, otaDigestCalls );
+    TEST_ASSERT_EQUAL( 1, otaDigestStoredCalls );
+}
+
+void test_OTA_ReceiveFileBlockDigestFail()
+{
+    otaInterfaces.pal.updateDigest = mockPalUpdateDigestAlwaysFail;
+    test_OTA_ReceiveFileBlockCompleteMqtt();
+
+    /* The failed digest is not retried, but the download still completes. */
+    TEST_ASSERT_EQUAL( 1, otaDigestCalls );
+}
+
 void test_OTA_ReceiveFileBlockMallocFail()
 {
     uint8_t pStreamingMessage[ OTA_FILE_BLOCK_SIZE * 2 ] = { 0 };
@@ -2167,6 +2397,9 @@ void test_OTA_ReceiveFileBlockMallocFail()
     otaGoToState( OtaAgentStateWaitingForFileBlock );
     TEST_ASSERT_EQUAL( OtaAgentStateWaitingForFileBlock, OTA_GetState() );
 
+    /* Blocks decoded in place need no buffer, so decode into a copy. */
+    otaDataInterface.decodeFileBlockView = NULL;
+
     /* Create and send the data block. */
     createOtaStreamingMessage(
         pStreamingMessage,
@@ -2191,6 +2424,80 @@ void test_OTA_ReceiveFileBlockMallocFail()
     TEST_ASSERT_EQUAL( OtaAgentStateWaitingForJob, OTA_GetState() );
 }
 
+void test_OTA_ReceiveFileBlockInPlaceWithoutDecodeMemory()
+{
+    uint8_t pStreamingMessage[ OTA_FILE_BLOCK_SIZE * 2 ] = { 0 };
+    uint8_t pFileBlock[ OTA_FILE_BLOCK_SIZE ] = { 0 };
+    size_t streamingMessageSize = 0;
+    OtaEventData_t eventBuffer;
+    OtaEventMsg_t otaEvent = { 0 };
+    uint32_t idx;
+
+    otaInterfaces.os.event.send = mockOSEventSend;
+
+    /* Provide no decode memory, the block is written from the event buffer. */
+    pOtaAppBuffer.pDecodeMemory = NULL;
+    pOtaAppBuffer.decodeMemorySize = 0;
+
+    otaGoToState( OtaAgentStateWaitingForFileBlock );
+    TEST_ASSERT_EQUAL( OtaAgentStateWaitingForFileBlock, OTA_GetState() );
+
+    for( idx = 0; idx < OTA_FILE_BLOCK_SIZE; ++idx )
+    {
+        pFileBlock[ idx ] = ( uint8_t ) idx;
+    }
+
+    createOtaStreamingMessage(
+        pStreamingMessage,
+        sizeof( pStreamingMessage ),
+        0,
+        pFileBlock,
+        OTA_FILE_BLOCK_SIZE,
+        &streamingMessageSize,
+        true );
+
+    otaEvent.eventId = OtaAgentEventReceivedFileBlock;
+    otaEvent.pEventData = &eventBuffer;
+    memcpy( otaEvent.pEventData->data, pStreamingMessage, streamingMessageSize );
+    otaEvent.pEventData->dataLength = streamingMessageSize;
+    OTA_SignalEvent( &otaEvent );
+
+    /* No allocation is made for the payload. */
+    otaInterfaces.os.mem.malloc = mockMallocAlwaysFail;
+    receiveAndProcessOtaEvent();
+    TEST_ASSERT_EQUAL( OtaAgentStateWaitingForFileBlock, OTA_GetState() );
+    TEST_ASSERT_EQUAL_UINT8_ARRAY( pFileBlock, pOtaFileBuffer, OTA_FILE_BLOCK_SIZE );
+}
+
+void test_OTA_ReceiveFileBlockInPlaceSizeMismatch()
+{
+    OtaEventData_t eventBuffer;
+    OtaEventMsg_t otaEvent = { 0 };
+
+    /* {"f": 0, "i": 0, "l": 16, "p": h'a5'}, a block size larger than the payload. */
+    uint8_t pBadMessage[] =
+    {
+        0xa4, 0x61, 0x66, 0x00, 0x61, 0x69, 0x00, 0x61, 0x6c, 0x10,
+        0x61, 0x70, 0x41, 0xa5
+    };
+
+    otaInterfaces.os.event.send = mockOSEventSend;
+
+    otaGoToState( OtaAgentStateWaitingForFileBlock );
+    TEST_ASSERT_EQUAL( OtaAgentStateWaitingForFileBlock, OTA_GetState() );
+
+    otaEvent.eventId = OtaAgentEventReceivedFileBlock;
+    otaEvent.pEventData = &eventBuffer;
+    memcpy( otaEvent.pEventData->data, pBadMessage, sizeof( pBadMessage ) );
+    otaEvent.pEventData->dataLength = sizeof( pBadMessage );
+    OTA_SignalEvent( &otaEvent );
+
+    /* The block is rejected before it reaches the PAL. */
+    receiveAndProcessOtaEvent();
+    TEST_ASSERT_EQUAL( OtaAgentStateWaitingForFileBlock, OTA_GetState() );
+    TEST_ASSERT_EQUAL( 0, pOtaFileBuffer[ 0 ] );
+}
+
 void test_OTA_DroppedFileBlock()
 {
     OtaEventMsg_t otaEvent = { 0 };
@@ -3216,6 +3523,7 @@ void test_OTA_shutdownHandler_NullInterface()
 
     otaDataInterface.cleanup = NULL;
     otaDataInterface.decodeFileBlock = NULL;
+    otaDataInterface.decodeFileBlockView = NULL;
     otaDataInterface.initFileTransfer = NULL;
     otaDataInterface.requestFileBlock = NULL;
 
@@ -3316,7 +3624,7 @@ void test_OTA_restartOtaAfterShutdownAndDropEvents()
  */
 void test_OTA_setDataInterface_ValidInput( void )
 {
-    OtaDataInterface_t dataInterface = { NULL, NULL, NULL, NULL };
+    OtaDataInterface_t dataInterface = { NULL, NULL, NULL, NULL, NULL };
     uint8_t pProtocol[ OTA_PROTOCOL_BUFFER_SIZE ] = { 0 };
 
     memcpy( pProtocol, "[\"MQTT\"]", sizeof( "[\"MQTT\"]" ) );
@@ -3324,6 +3632,7 @@ void test_OTA_setDataInterface_ValidInput( void )
     TEST_ASSERT_EQUAL( initFileTransfer_Mqtt, dataInterface.initFileTransfer );
     TEST_ASSERT_EQUAL( requestFileBlock_Mqtt, dataInterface.requestFileBlock );
     TEST_ASSERT_EQUAL( decodeFileBlock_Mqtt, dataInterface.decodeFileBlock );
+    TEST_ASSERT_EQUAL( decodeFileBlockView_Mqtt, dataInterface.decodeFileBlockView );
     TEST_ASSERT_EQUAL( cleanupData_Mqtt, dataInterface.cleanup );
 
     memcpy( pProtocol, "[\"HTTP\"]", sizeof( "[\"HTTP\"]" ) );
@@ -3332,6 +3641,7 @@ void test_OTA_setDataInterface_ValidInput( void )
     TEST_ASSERT_EQUAL( initFileTransfer_Http, dataInterface.initFileTransfer );
     TEST_ASSERT_EQUAL( requestDataBlock_Http, dataInterface.requestFileBlock );
     TEST_ASSERT_EQUAL( decodeFileBlock_Http, dataInterface.decodeFileBlock );
+    TEST_ASSERT_EQUAL( decodeFileBlockView_Http, dataInterface.decodeFileBlockView );
     TEST_ASSERT_EQUAL( cleanupData_Http, dataInterface.cleanup );
 
     memcpy( pProtocol, "[\"MQTT\",\"HTTP\"]", sizeof( "[\"MQTT\",\"HTTP\"]" ) );
@@ -3340,6 +3650,7 @@ void test_OTA_setDataInterface_ValidInput( void )
     TEST_ASSERT_NOT_EQUAL( NULL, dataInterface.initFileTransfer );
     TEST_ASSERT_NOT_EQUAL( NULL, dataInterface.requestFileBlock );
     TEST_ASSERT_NOT_EQUAL( NULL, dataInterface.decodeFileBlock );
+    TEST_ASSERT_NOT_EQUAL( NULL, dataInterface.decodeFileBlockView );
     TEST_ASSERT_NOT_EQUAL( NULL, dataInterface.cleanup );
 
     memcpy( pProtocol, "[\"HTTP\",\"MQTT\"]", sizeof( "[\"HTTP\",\"MQTT\"]" ) );
@@ -3348,6 +3659,7 @@ void test_OTA_setDataInterface_ValidInput( void )
     TEST_ASSERT_NOT_EQUAL( NULL, dataInterface.initFileTransfer );
     TEST_ASSERT_NOT_EQUAL( NULL, dataInterface.requestFileBlock );
     TEST_ASSERT_NOT_EQUAL( NULL, dataInterface.decodeFileBlock );
+    TEST_ASSERT_NOT_EQUAL( NULL, dataInterface.decodeFileBlockView );
     TEST_ASSERT_NOT_EQUAL( NULL, dataInterface.cleanup );
 }
 
@@ -3357,7 +3669,7 @@ void test_OTA_setDataInterface_ValidInput( void )
  */
 void test_OTA_setDataInterface_InvalidInput( void )
 {
-    OtaDataInterface_t dataInterface = { NULL, NULL, NULL, NULL };
+    OtaDataInterface_t dataInterface = { NULL, NULL, NULL, NULL, NULL };
     uint8_t pProtocol[ OTA_PROTOCOL_BUFFER_SIZE ] = { 0 };
 
     memcpy( pProtocol, "invalid_protocol", sizeof( "invalid_protocol" ) );
@@ -3365,6 +3677,7 @@ void test_OTA_setDataInterface_InvalidInput( void )
     TEST_ASSERT_EQUAL( NULL, dataInterface.initFileTransfer );
     TEST_ASSERT_EQUAL( NULL, dataInterface.requestFileBlock );
     TEST_ASSERT_EQUAL( NULL, dataInterface.decodeFileBlock );
+    TEST_ASSERT_EQUAL( NULL, dataInterface.decodeFileBlockView );
     TEST_ASSERT_EQUAL( NULL, dataInterface.cleanup );
 
     memcpy( pProtocol, "junkMQTT", sizeof( "junkMQTT" ) );
@@ -3372,6 +3685,7 @@ void test_OTA_setDataInterface_InvalidInput( void )
     TEST_ASSERT_EQUAL( NULL, dataInterface.initFileTransfer );
     TEST_ASSERT_EQUAL( NULL, dataInterface.requestFileBlock );
     TEST_ASSERT_EQUAL( NULL, dataInterface.decodeFileBlock );
+    TEST_ASSERT_EQUAL( NULL, dataInterface.decodeFileBlockView );
     TEST_ASSERT_EQUAL( NULL, dataInterface.cleanup );
 
     memcpy( pProtocol, "HTTPjunk", sizeof( "HTTPjunk" ) );
@@ -3379,6 +3693,7 @@ void test_OTA_setDataInterface_InvalidInput( void )
     TEST_ASSERT_EQUAL( NULL, dataInterface.initFileTransfer );
     TEST_ASSERT_EQUAL( NULL, dataInterface.requestFileBlock );
     TEST_ASSERT_EQUAL( NULL, dataInterface.decodeFileBlock );
+    TEST_ASSERT_EQUAL( NULL, dataInterface.decodeFileBlockView );
     TEST_ASSERT_EQUAL( NULL, dataInterface.cleanup );
 }
 
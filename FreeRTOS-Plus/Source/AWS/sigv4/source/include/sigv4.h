@@ -156,6 +156,7 @@ typedef enum SigV4Status
      * Functions that may return this value:
      * - #SigV4_GenerateHTTPAuthorization
      * - #SigV4_AwsIotDateToIso8601
+     * - #SigV4_GenerateCanonicalHeaders
      */
     SigV4InvalidParameter,
 
@@ -165,6 +166,7 @@ typedef enum SigV4Status
      *
      * Functions that may return this value:
      * - #SigV4_GenerateHTTPAuthorization
+     * - #SigV4_GenerateCanonicalHeaders
      */
     SigV4InsufficientMemory,
 
@@ -185,6 +187,7 @@ typedef enum SigV4Status
      *
      * Functions that may return this value:
      * - #SigV4_GenerateHTTPAuthorization
+     * - #SigV4_GenerateCanonicalHeaders
      */
     SigV4MaxHeaderPairCountExceeded,
 
@@ -213,6 +216,7 @@ typedef enum SigV4Status
      *
      * Functions that may return this value:
      * - #SigV4_GenerateHTTPAuthorization
+     * - #SigV4_GenerateCanonicalHeaders
      */
     SigV4InvalidHttpHeaders
 } SigV4Status_t;
@@ -371,6 +375,30 @@ typedef struct SigV4Credentials
     size_t secretAccessKeyLen; /**< @brief Length of pSecretAccessKey. */
 } SigV4Credentials_t;
 
+/**
+ * @ingroup sigv4_struct_types
+ * @brief Cache of the most recently derived signing key.
+ *
+ * The signing key only depends on the secret access key, the date, the region,
+ * and the service, so it stays the same for every request signed on the same
+ * day. When a cache is passed in #SigV4Parameters_t.pSigningKeyCache, the key
+ * is derived once and reused until the date, region, service, or access key ID
+ * changes, which saves the four HMAC operations of the key derivation for each
+ * request.
+ *
+ * The cache is owned by the application and must be zero-initialized before
+ * its first use. It must not be used by several signing calls at the same
+ * time, and it should be cleared if the secret access key changes without the
+ * access key ID changing.
+ */
+typedef struct SigV4SigningKeyCache
+{
+    char scope[ SIGV4_SIGNING_KEY_CACHE_SCOPE_LENGTH ];   /**< @brief Access key ID, date, region, and service of the cached key. */
+    size_t scopeLen;                                      /**< @brief Length of scope, zero if the cache is empty. */
+    uint8_t signingKey[ SIGV4_HASH_MAX_DIGEST_LENGTH ];   /**< @brief The cached signing key. */
+    size_t signingKeyLen;                                 /**< @brief Length of signingKey. */
+} SigV4SigningKeyCache_t;
+
 /**
  * @ingroup sigv4_struct_types
  * @brief Complete configurations required for generating "String to Sign" and
@@ -429,6 +457,12 @@ typedef struct SigV4Parameters
      * @brief HTTP specific SigV4 parameters for canonical request calculation.
      */
     SigV4HttpParameters_t * pHttpParameters;
+
+    /**
+     * @brief Optional cache for the signing key. If set to NULL, the signing
+     * key is derived for every request.
+     */
+    SigV4SigningKeyCache_t * pSigningKeyCache;
 } SigV4Parameters_t;
 
 /**
@@ -460,6 +494,7 @@ typedef struct SigV4Parameters
  * // pSigv4Auth by the SigV4_GenerateHTTPAuthorization API function.
  * char * signature = NULL;
  * size_t signatureLen = 0;
+ * static SigV4SigningKeyCache_t signingKeyCache = { 0 };
  *
  * SigV4Parameters_t sigv4Params =
  * {
@@ -476,7 +511,9 @@ typedef struct SigV4Parameters
  *     // SigV4 crypto interface. See SigV4CryptoInterface_t interface documentation.
  *     .pCryptoInterface = &cryptoInterface,
  *     // HTTP parameters for the HTTP request to generate a SigV4 authorization header for.
- *     .pHttpParameters  = &sigv4HttpParams
+ *     .pHttpParameters  = &sigv4HttpParams,
+ *     // Optional, zero-initialized cache to reuse the signing key across requests.
+ *     .pSigningKeyCache = &signingKeyCache
  * };
  *
  * status = SigV4_GenerateHTTPAuthorization( &sigv4Params, pSigv4Auth, &sigv4AuthLen, &signature, &signatureLen );
@@ -495,6 +532,60 @@ SigV4Status_t SigV4_GenerateHTTPAuthorization( const SigV4Parameters_t * pParams
                                                size_t * signatureLen );
 /* @[declare_sigV4_generateHTTPAuthorization_function] */
 
+#if ( SIGV4_USE_CANONICAL_SUPPORT == 1 )
+
+/**
+ * @brief Canonicalize a set of HTTP headers once, so that requests with the
+ * same headers can skip the parsing, sorting, and trimming of the headers.
+ *
+ * The output is the canonical headers block of the canonical request, i.e.
+ * lowercase header names sorted in ascending order, each followed by ':', the
+ * trimmed header value, and a newline. It is meant to be passed as
+ * #SigV4HttpParameters_t.pHeaders together with the
+ * #SIGV4_HTTP_HEADERS_ARE_CANONICAL_FLAG flag.
+ *
+ * Header values of a fixed length without leading, trailing, or repeated
+ * spaces, such as the "x-amz-date" value, can be overwritten in place in the
+ * output before each request, since the order of the headers only depends on
+ * their names.
+ *
+ * @param[in] pHeaders The HTTP headers in the same format as
+ * #SigV4HttpParameters_t.pHeaders when no canonical flag is set.
+ * @param[in] headersLen The length of @p pHeaders.
+ * @param[out] pCanonicalHeaders Buffer to hold the canonical headers.
+ * @param[in, out] pCanonicalHeadersLen Input: the length of
+ * @p pCanonicalHeaders, output: the length of the canonical headers written
+ * to the buffer.
+ *
+ * @return #SigV4Success if successful, error code otherwise.
+ *
+ * <b>Example</b>
+ * @code{c}
+ * // Canonicalize the headers of an upload request once.
+ * char canonicalHeaders[ 256U ];
+ * size_t canonicalHeadersLen = sizeof( canonicalHeaders );
+ * char * pDate = NULL;
+ *
+ * status = SigV4_GenerateCanonicalHeaders( pHeaders, headersLen,
+ *                                          canonicalHeaders, &canonicalHeadersLen );
+ *
+ * // Later, for each request, refresh the date and sign the request.
+ * pDate = strstr( canonicalHeaders, "x-amz-date:" ) + strlen( "x-amz-date:" );
+ * memcpy( pDate, pDateISO8601, SIGV4_ISO_STRING_LEN );
+ * sigv4HttpParams.pHeaders = canonicalHeaders;
+ * sigv4HttpParams.headersLen = canonicalHeadersLen;
+ * sigv4HttpParams.flags |= SIGV4_HTTP_HEADERS_ARE_CANONICAL_FLAG;
+ * @endcode
+ */
+/* @[declare_sigV4_generateCanonicalHeaders_function] */
+    SigV4Status_t SigV4_GenerateCanonicalHeaders( const char * pHeaders,
+                                                  size_t headersLen,
+                                                  char * pCanonicalHeaders,
+                                                  size_t * pCanonicalHeadersLen );
+/* @[declare_sigV4_generateCanonicalHeaders_function] */
+
+#endif /* #if ( SIGV4_USE_CANONICAL_SUPPORT == 1 ) */
+
 /**
  * @brief Parse the date header value from the AWS IoT response, and generate
  * the formatted ISO 8601 date required for authentication.
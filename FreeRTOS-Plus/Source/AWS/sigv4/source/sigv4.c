@@ -562,6 +562,41 @@ static SigV4Status_t generateSigningKey( const SigV4Parameters_t * pSigV4Params,
                                          SigV4String_t * pSigningKey,
                                          size_t * pBytesRemaining );
 
+/**
+ * @brief Write the scope that identifies a cached signing key, i.e.
+ * "<access key ID>/<YYYYMMDD>/<region>/<service>".
+ *
+ * @param[in] pSigV4Params The application parameters defining the signing key scope.
+ * @param[out] pScope The buffer to write the scope to.
+ * @param[in] scopeBufLen The length of @p pScope.
+ * @return The number of bytes written, or 0 if the scope does not fit in @p pScope.
+ */
+static size_t writeSigningKeyScope( const SigV4Parameters_t * pSigV4Params,
+                                    char * pScope,
+                                    size_t scopeBufLen );
+
+/**
+ * @brief Copy the signing key from the application's signing key cache onto
+ * a #SigV4String_t if the cache holds the key for the scope of @p pSigV4Params.
+ *
+ * @param[in] pSigV4Params The application parameters, including the cache.
+ * @param[in,out] pSigningKey The #SigV4String_t onto which the signing key will
+ * be copied. On input, the buffer and its length; on a hit, the key.
+ * @return true if the signing key was read from the cache, false otherwise.
+ */
+static bool readSigningKeyCache( const SigV4Parameters_t * pSigV4Params,
+                                 SigV4String_t * pSigningKey );
+
+/**
+ * @brief Store a freshly derived signing key in the application's signing key
+ * cache, if one was provided and the scope fits in it.
+ *
+ * @param[in] pSigV4Params The application parameters, including the cache.
+ * @param[in] pSigningKey The signing key to store.
+ */
+static void writeSigningKeyCache( const SigV4Parameters_t * pSigV4Params,
+                                  const SigV4String_t * pSigningKey );
+
 /**
  * @brief Format the credential scope for the authorization header.
  * Credential scope includes the access key ID, date, region, and service parameters, and
@@ -3074,6 +3109,121 @@ static SigV4Status_t generateSigningKey( const SigV4Parameters_t * pSigV4Params,
     return returnStatus;
 }
 
+static size_t writeSigningKeyScope( const SigV4Parameters_t * pSigV4Params,
+                                    char * pScope,
+                                    size_t scopeBufLen )
+{
+    size_t scopeLen = 0U;
+    char * pBufWrite = pScope;
+
+    assert( pSigV4Params != NULL );
+    assert( pSigV4Params->pCredentials != NULL );
+    assert( pScope != NULL );
+
+    /* The scope is made of the access key ID, the date, region and service,
+     * with a separator after each of the first three. */
+    scopeLen = pSigV4Params->pCredentials->accessKeyIdLen + ISO_DATE_SCOPE_LEN +
+               pSigV4Params->regionLen + pSigV4Params->serviceLen +
+               ( 3U * CREDENTIAL_SCOPE_SEPARATOR_LEN );
+
+    if( scopeLen > scopeBufLen )
+    {
+        LogDebug( ( "Signing key scope does not fit in the signing key cache: "
+                    "ScopeLength=%lu, SIGV4_SIGNING_KEY_CACHE_SCOPE_LENGTH=%lu",
+                    ( unsigned long ) scopeLen, ( unsigned long ) scopeBufLen ) );
+        scopeLen = 0U;
+    }
+    else
+    {
+        pBufWrite += copyString( pBufWrite,
+                                 pSigV4Params->pCredentials->pAccessKeyId,
+                                 pSigV4Params->pCredentials->accessKeyIdLen );
+        *pBufWrite = CREDENTIAL_SCOPE_SEPARATOR;
+        pBufWrite += CREDENTIAL_SCOPE_SEPARATOR_LEN;
+
+        pBufWrite += copyString( pBufWrite, pSigV4Params->pDateIso8601, ISO_DATE_SCOPE_LEN );
+        *pBufWrite = CREDENTIAL_SCOPE_SEPARATOR;
+        pBufWrite += CREDENTIAL_SCOPE_SEPARATOR_LEN;
+
+        pBufWrite += copyString( pBufWrite, pSigV4Params->pRegion, pSigV4Params->regionLen );
+        *pBufWrite = CREDENTIAL_SCOPE_SEPARATOR;
+        pBufWrite += CREDENTIAL_SCOPE_SEPARATOR_LEN;
+
+        pBufWrite += copyString( pBufWrite, pSigV4Params->pService, pSigV4Params->serviceLen );
+
+        /* Avoid warnings from last write if asserts are disabled. */
+        ( void ) pBufWrite;
+        assert( ( size_t ) ( pBufWrite - pScope ) == scopeLen );
+    }
+
+    return scopeLen;
+}
+
+static bool readSigningKeyCache( const SigV4Parameters_t * pSigV4Params,
+                                 SigV4String_t * pSigningKey )
+{
+    bool isHit = false;
+    const SigV4SigningKeyCache_t * pCache = NULL;
+    char scope[ SIGV4_SIGNING_KEY_CACHE_SCOPE_LENGTH ];
+    size_t scopeLen = 0U;
+    size_t keyLen = 0U;
+
+    assert( pSigV4Params != NULL );
+    assert( pSigV4Params->pCryptoInterface != NULL );
+    assert( pSigningKey != NULL );
+    assert( pSigningKey->pData != NULL );
+
+    pCache = pSigV4Params->pSigningKeyCache;
+    keyLen = pSigV4Params->pCryptoInterface->hashDigestLen;
+
+    /* An empty cache, or one filled with a key for another hash function,
+     * cannot be used. */
+    if( ( pCache != NULL ) &&
+        ( pCache->scopeLen > 0U ) &&
+        ( pCache->signingKeyLen == keyLen ) &&
+        ( pSigningKey->dataLen >= keyLen ) )
+    {
+        scopeLen = writeSigningKeyScope( pSigV4Params, scope, sizeof( scope ) );
+
+        if( ( scopeLen == pCache->scopeLen ) &&
+            ( memcmp( scope, pCache->scope, scopeLen ) == 0 ) )
+        {
+            ( void ) memcpy( pSigningKey->pData, pCache->signingKey, keyLen );
+            pSigningKey->dataLen = keyLen;
+            isHit = true;
+        }
+    }
+
+    return isHit;
+}
+
+static void writeSigningKeyCache( const SigV4Parameters_t * pSigV4Params,
+                                  const SigV4String_t * pSigningKey )
+{
+    SigV4SigningKeyCache_t * pCache = NULL;
+
+    assert( pSigV4Params != NULL );
+    assert( pSigningKey != NULL );
+    assert( pSigningKey->dataLen <= SIGV4_HASH_MAX_DIGEST_LENGTH );
+
+    pCache = pSigV4Params->pSigningKeyCache;
+
+    if( pCache != NULL )
+    {
+        /* A scope that does not fit leaves the cache empty, so that the next
+         * lookup cannot match a stale key. */
+        pCache->scopeLen = writeSigningKeyScope( pSigV4Params,
+                                                 pCache->scope,
+                                                 sizeof( pCache->scope ) );
+
+        if( pCache->scopeLen > 0U )
+        {
+            ( void ) memcpy( pCache->signingKey, pSigningKey->pData, pSigningKey->dataLen );
+            pCache->signingKeyLen = pSigningKey->dataLen;
+        }
+    }
+}
+
 static SigV4Status_t writePayloadHashToCanonicalRequest( const SigV4Parameters_t * pParams,
                                                          CanonicalContext_t * pCanonicalContext )
 {
@@ -3244,16 +3394,31 @@ SigV4Status_t SigV4_GenerateHTTPAuthorization( const SigV4Parameters_t * pParams
 
     /* Write the signing key. The is done by computing the following function
      * where the + operator means concatenation:
-     * HMAC(HMAC(HMAC(HMAC("AWS4" + kSecret,pDate),pRegion),pService),"aws4_request") */
+     * HMAC(HMAC(HMAC(HMAC("AWS4" + kSecret,pDate),pRegion),pService),"aws4_request")
+     * The key only depends on the credentials, date, region and service, so
+     * it is taken from the application's cache when that holds it. */
     if( returnStatus == SigV4Success )
     {
         hmacContext.pCryptoInterface = pParams->pCryptoInterface;
         signingKey.pData = canonicalContext.pBufCur;
         signingKey.dataLen = canonicalContext.bufRemaining;
-        returnStatus = generateSigningKey( pParams,
-                                           &hmacContext,
-                                           &signingKey,
-                                           &canonicalContext.bufRemaining );
+
+        if( readSigningKeyCache( pParams, &signingKey ) == true )
+        {
+            canonicalContext.bufRemaining -= signingKey.dataLen;
+        }
+        else
+        {
+            returnStatus = generateSigningKey( pParams,
+                                               &hmacContext,
+                                               &signingKey,
+                                               &canonicalContext.bufRemaining );
+
+            if( returnStatus == SigV4Success )
+            {
+                writeSigningKeyCache( pParams, &signingKey );
+            }
+        }
     }
 
     /* Use the SigningKey and StringToSign to produce the final signature.
@@ -3291,3 +3456,71 @@ SigV4Status_t SigV4_GenerateHTTPAuthorization( const SigV4Parameters_t * pParams
 
     return returnStatus;
 }
+
+/*-----------------------------------------------------------*/
+
+#if ( SIGV4_USE_CANONICAL_SUPPORT == 1 )
+
+    SigV4Status_t SigV4_GenerateCanonicalHeaders( const char * pHeaders,
+                                                  size_t headersLen,
+                                                  char * pCanonicalHeaders,
+                                                  size_t * pCanonicalHeadersLen )
+    {
+        SigV4Status_t returnStatus = SigV4Success;
+        CanonicalContext_t canonicalContext;
+        size_t noOfHeaders = 0U;
+
+        if( pHeaders == NULL )
+        {
+            LogError( ( "Parameter check failed: pHeaders is NULL." ) );
+            returnStatus = SigV4InvalidParameter;
+        }
+        else if( headersLen == 0U )
+        {
+            LogError( ( "Parameter check failed: headersLen is zero." ) );
+            returnStatus = SigV4InvalidParameter;
+        }
+        else if( pCanonicalHeaders == NULL )
+        {
+            LogError( ( "Parameter check failed: pCanonicalHeaders is NULL." ) );
+            returnStatus = SigV4InvalidParameter;
+        }
+        else if( pCanonicalHeadersLen == NULL )
+        {
+            LogError( ( "Parameter check failed: pCanonicalHeadersLen is NULL." ) );
+            returnStatus = SigV4InvalidParameter;
+        }
+        else
+        {
+            /* Empty else. */
+        }
+
+        if( returnStatus == SigV4Success )
+        {
+            returnStatus = parseHeaderKeyValueEntries( pHeaders,
+                                                       headersLen,
+                                                       0U,
+                                                       &noOfHeaders,
+                                                       &canonicalContext );
+        }
+
+        if( returnStatus == SigV4Success )
+        {
+            quickSort( canonicalContext.pHeadersLoc, noOfHeaders, sizeof( SigV4KeyValuePair_t ), cmpHeaderField );
+
+            /* The headers are written straight into the application's buffer
+             * rather than into the processing buffer of the context. */
+            canonicalContext.pBufCur = pCanonicalHeaders;
+            canonicalContext.bufRemaining = *pCanonicalHeadersLen;
+            returnStatus = appendCanonicalizedHeaders( noOfHeaders, 0U, &canonicalContext );
+        }
+
+        if( returnStatus == SigV4Success )
+        {
+            *pCanonicalHeadersLen = ( size_t ) ( canonicalContext.pBufCur - pCanonicalHeaders );
+        }
+
+        return returnStatus;
+    }
+
+#endif /* #if ( SIGV4_USE_CANONICAL_SUPPORT == 1 ) */
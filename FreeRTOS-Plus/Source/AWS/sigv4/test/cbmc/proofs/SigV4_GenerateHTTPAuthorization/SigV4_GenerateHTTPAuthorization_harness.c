@@ -39,6 +39,7 @@ void harness()
     SigV4HttpParameters_t * pHttpParams;
     SigV4CryptoInterface_t * pCryptoInterface;
     SigV4Credentials_t * pCredentials;
+    SigV4SigningKeyCache_t * pSigningKeyCache;
     char * pAuthBuf;
     size_t * authBufLen;
     char * pSignature;
@@ -49,6 +50,7 @@ void harness()
     pSigV4Params = malloc( sizeof( SigV4Parameters_t ) );
     pCryptoInterface = malloc( sizeof( SigV4CryptoInterface_t ) );
     pCredentials = malloc( sizeof( SigV4Credentials_t ) );
+    pSigningKeyCache = malloc( sizeof( SigV4SigningKeyCache_t ) );
 
     /* This property applies to all hash functions. */
     if( pCryptoInterface != NULL )
@@ -70,6 +72,13 @@ void harness()
         pCredentials->pSecretAccessKey = malloc( pCredentials->secretAccessKeyLen );
     }
 
+    if( pSigningKeyCache != NULL )
+    {
+        /* The cache is either empty or holds a key written by a previous call. */
+        __CPROVER_assume( pSigningKeyCache->scopeLen <= SIGV4_SIGNING_KEY_CACHE_SCOPE_LENGTH );
+        __CPROVER_assume( pSigningKeyCache->signingKeyLen <= SIGV4_HASH_MAX_DIGEST_LENGTH );
+    }
+
     if( pHttpParams != NULL )
     {
         /* Make size assumptions for string-like types. */
@@ -102,6 +111,7 @@ void harness()
         pSigV4Params->pCredentials = pCredentials;
         pSigV4Params->pCryptoInterface = pCryptoInterface;
         pSigV4Params->pHttpParameters = pHttpParams;
+        pSigV4Params->pSigningKeyCache = pSigningKeyCache;
     }
 
     authBufLen = malloc( sizeof( size_t ) );
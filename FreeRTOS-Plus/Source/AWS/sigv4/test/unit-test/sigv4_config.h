@@ -36,8 +36,10 @@
 #ifndef SIGV4_CONFIG_H_
 #define SIGV4_CONFIG_H_
 
-
-#define LOGGING_LEVEL_DEBUG    1
+/* The benchmark is built with DISABLE_LOGGING, so that printing is not timed. */
+#ifndef DISABLE_LOGGING
+    #define LOGGING_LEVEL_DEBUG    1
+#endif
 
 /* @[code_example_loggingmacros] */
 /************* Define Logging Macros using printf function ***********/
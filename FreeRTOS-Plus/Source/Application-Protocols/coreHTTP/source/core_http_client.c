@@ -190,9 +190,24 @@ static HTTPStatus_t getFinalResponseStatus( HTTPParsingState_t parsingState,
 /**
  * @brief Receive the HTTP response from the network and parse it.
  *
+ * If #HTTPResponse_t.pBodyCallback is set, the response body is passed to the
+ * application as it is parsed and the buffer space it was received into is
+ * reused for the next network read.
+ *
+ * When the response is part of a pipeline, @p pPipelinedLen is not NULL. On
+ * entry it holds the number of bytes of the response already at the start of
+ * #HTTPResponse_t.pBuffer. Parsing then stops at the end of the response, and
+ * any bytes received after it, which belong to the next response, are
+ * returned through @p pNextResponse and @p pPipelinedLen.
+ *
  * @param[in] pTransport Transport interface.
  * @param[in] pResponse Response message to receive data from the network.
- * @param[in] pRequestHeaders Request headers for the corresponding HTTP request.
+ * @param[in] isHeadResponse Set to 1 if the response is to a HEAD request.
+ * @param[out] pNextResponse The bytes received after the end of the response.
+ * Ignored if @p pPipelinedLen is NULL.
+ * @param[in,out] pPipelinedLen The number of bytes already received on entry,
+ * and the number of bytes received after the response on return. Set to NULL
+ * when the response is not part of a pipeline.
  *
  * @return Returns #HTTPSuccess if successful. #HTTPNetworkError for a transport
  * receive error. Please see #parseHttpResponse and #getFinalResponseStatus for
@@ -200,7 +215,9 @@ static HTTPStatus_t getFinalResponseStatus( HTTPParsingState_t parsingState,
  */
 static HTTPStatus_t receiveAndParseHttpResponse( const TransportInterface_t * pTransport,
                                                  HTTPResponse_t * pResponse,
-                                                 const HTTPRequestHeaders_t * pRequestHeaders );
+                                                 uint8_t isHeadResponse,
+                                                 const uint8_t ** pNextResponse,
+                                                 size_t * pPipelinedLen );
 
 /**
  * @brief Send the HTTP request over the network.
@@ -222,6 +239,106 @@ static HTTPStatus_t sendHttpRequest( const TransportInterface_t * pTransport,
                                      size_t reqBodyBufLen,
                                      uint32_t sendFlags );
 
+/**
+ * @brief Send one chunk of a "Transfer-Encoding: chunked" request body over
+ * the transport send interface.
+ *
+ * The chunk is sent as its size in hexadecimal, `\r\n`, the chunk data, and
+ * another `\r\n`.
+ *
+ * @param[in] pTransport Transport interface.
+ * @param[in] getTimestampMs Function to retrieve a timestamp in milliseconds.
+ * @param[in] pChunk The chunk data to send.
+ * @param[in] chunkLen The length of the chunk data. It must be greater than
+ * zero and at most INT32_MAX.
+ *
+ * @return #HTTPSuccess if successful. If there was a network error or less
+ * bytes than what were specified were sent, then #HTTPNetworkError is
+ * returned.
+ */
+static HTTPStatus_t sendHttpChunk( const TransportInterface_t * pTransport,
+                                   HTTPClient_GetCurrentTimeFunc_t getTimestampMs,
+                                   const uint8_t * pChunk,
+                                   size_t chunkLen );
+
+/**
+ * @brief Send the HTTP request headers followed by a "Transfer-Encoding:
+ * chunked" body read from the application.
+ *
+ * @param[in] pTransport Transport interface.
+ * @param[in] getTimestampMs Function to retrieve a timestamp in milliseconds.
+ * @param[in] pRequestHeaders Request headers to send over the network.
+ * @param[in] pBodySource Application callback that supplies the body.
+ * @param[in] pChunkBuffer Buffer to read each chunk of the body into.
+ * @param[in] chunkBufferLen Length of @p pChunkBuffer.
+ *
+ * @return Returns #HTTPSuccess if successful. #HTTPInsufficientMemory if the
+ * Transfer-Encoding header does not fit in the request header buffer.
+ * #HTTPRequestBodyError if the body callback returned an error. Please see
+ * #sendHttpData for other statuses returned.
+ */
+static HTTPStatus_t sendChunkedHttpRequest( const TransportInterface_t * pTransport,
+                                            HTTPClient_GetCurrentTimeFunc_t getTimestampMs,
+                                            HTTPRequestHeaders_t * pRequestHeaders,
+                                            const HTTPClient_RequestBodySource_t * pBodySource,
+                                            uint8_t * pChunkBuffer,
+                                            size_t chunkBufferLen );
+
+/**
+ * @brief Check the parameters shared by #HTTPClient_Send and
+ * #HTTPClient_SendChunked.
+ *
+ * When the parameters are valid and #HTTPResponse_t.getTime is NULL, it is set
+ * to a function that always returns zero.
+ *
+ * @param[in] pTransport Transport interface.
+ * @param[in] pRequestHeaders Request headers to send over the network.
+ * @param[in] pResponse Response message to receive data from the network.
+ *
+ * @return #HTTPSuccess if the parameters are valid, #HTTPInvalidParameter
+ * otherwise.
+ */
+static HTTPStatus_t validateSendParameters( const TransportInterface_t * pTransport,
+                                            const HTTPRequestHeaders_t * pRequestHeaders,
+                                            HTTPResponse_t * pResponse );
+
+/**
+ * @brief Check the request body given to #HTTPClient_Send or
+ * #HTTPClient_SendPipelined.
+ *
+ * @param[in] pRequestBodyBuf Request body buffer.
+ * @param[in] reqBodyBufLen Length of the request body buffer.
+ *
+ * @return #HTTPSuccess if the request body is valid, #HTTPInvalidParameter
+ * otherwise.
+ */
+static HTTPStatus_t validateRequestBody( const uint8_t * pRequestBodyBuf,
+                                         size_t reqBodyBufLen );
+
+/**
+ * @brief Receive the responses to requests that were pipelined on the same
+ * connection, in order.
+ *
+ * @param[in] pTransport Transport interface.
+ * @param[in,out] pRequests The pipelined requests that were sent.
+ * @param[in] requestCount The number of requests in @p pRequests.
+ *
+ * @return #HTTPSuccess if every response was received, otherwise the status
+ * returned by #HTTPClient_SendPipelined.
+ */
+static HTTPStatus_t receivePipelinedResponses( const TransportInterface_t * pTransport,
+                                               HTTPPipelinedRequest_t * pRequests,
+                                               size_t requestCount );
+
+/**
+ * @brief Check whether the request in @p pRequestHeaders is a HEAD request.
+ *
+ * @param[in] pRequestHeaders Request headers starting with the request-line.
+ *
+ * @return 1 if the request method is HEAD, 0 otherwise.
+ */
+static uint8_t isHeadRequest( const HTTPRequestHeaders_t * pRequestHeaders );
+
 /**
  * @brief Converts an integer value to its ASCII representation in the passed
  * buffer.
@@ -336,10 +453,10 @@ static int findHeaderOnHeaderCompleteCallback( llhttp_t * pHttpParser );
  * server.
  *
  * @param[in] pParsingContext The parsing context to initialize.
- * @param[in] pRequestHeaders Request headers for the corresponding HTTP request.
+ * @param[in] isHeadResponse Set to 1 if the response is to a HEAD request.
  */
 static void initializeParsingContextForFirstResponse( HTTPParsingContext_t * pParsingContext,
-                                                      const HTTPRequestHeaders_t * pRequestHeaders );
+                                                      uint8_t isHeadResponse );
 
 /**
  * @brief Parses the response buffer in @p pResponse.
@@ -476,6 +593,9 @@ static int httpParserOnHeadersCompleteCallback( llhttp_t * pHttpParser );
  * The third invocation of this callback will contain @p pLoc = "developer." and
  * @p length = 10.
  *
+ * If the application set #HTTPResponse_t.pBodyCallback, each part of the body
+ * is passed to it instead of being collected in the response buffer.
+ *
  * @param[in] pHttpParser Parsing object containing state and callback context.
  * @param[in] pLoc - Pointer to the body string in the response message buffer.
  * @param[in] length - The length of the body found.
@@ -928,44 +1048,64 @@ static int httpParserOnBodyCallback( llhttp_t * pHttpParser,
     assert( pLoc >= ( const char * ) ( pResponse->pBuffer ) );
     assert( pLoc < ( const char * ) ( pResponse->pBuffer + pResponse->bufferLen ) );
 
-    /* If this is the first time httpParserOnBodyCallback() has been invoked,
-     * then the start of the response body is NULL. */
-    if( pResponse->pBody == NULL )
+    if( pResponse->pBodyCallback != NULL )
     {
-        /* Ideally the start of the body should follow right after the header
-         * end indicating characters, but to reduce complexity and ensure users
-         * are given the correct start of the body, we set the start of the body
-         * to what the parser tells us is the start. This could come after the
-         * initial transfer encoding chunked header. */
-        pResponse->pBody = ( const uint8_t * ) ( pLoc );
-        pResponse->bodyLen = 0U;
+        /* The body is streamed to the application from where it was received.
+         * Once it has been delivered, its space in the response buffer is
+         * reused for the next network read, starting from where the first
+         * part of the body was received. */
+        if( pParsingContext->pBodyStreamStart == NULL )
+        {
+            pParsingContext->pBodyStreamStart = pLoc;
+        }
+
+        pResponse->pBodyCallback->onBodyCallback( pResponse->pBodyCallback->pContext,
+                                                  ( const uint8_t * ) pLoc,
+                                                  length,
+                                                  pResponse->statusCode );
+        pResponse->bodyLen += length;
     }
+    else
+    {
+        /* If this is the first time httpParserOnBodyCallback() has been invoked,
+         * then the start of the response body is NULL. */
+        if( pResponse->pBody == NULL )
+        {
+            /* Ideally the start of the body should follow right after the header
+             * end indicating characters, but to reduce complexity and ensure users
+             * are given the correct start of the body, we set the start of the body
+             * to what the parser tells us is the start. This could come after the
+             * initial transfer encoding chunked header. */
+            pResponse->pBody = ( const uint8_t * ) ( pLoc );
+            pResponse->bodyLen = 0U;
+        }
 
-    /* The next location to write. */
+        /* The next location to write. */
 
-    /* MISRA Ref 11.8.1 [Removal of const from pointer] */
-    /* More details at: https://github.com/FreeRTOS/coreHTTP/blob/main/MISRA.md#rule-118 */
-    /* coverity[misra_c_2012_rule_11_8_violation] */
-    pNextWriteLoc = ( char * ) ( pResponse->pBody + pResponse->bodyLen );
+        /* MISRA Ref 11.8.1 [Removal of const from pointer] */
+        /* More details at: https://github.com/FreeRTOS/coreHTTP/blob/main/MISRA.md#rule-118 */
+        /* coverity[misra_c_2012_rule_11_8_violation] */
+        pNextWriteLoc = ( char * ) ( pResponse->pBody + pResponse->bodyLen );
 
-    /* If the response is of type Transfer-Encoding: chunked, then actual body
-     * will follow the the chunked header. This body data is in a later location
-     * and must be moved up in the buffer. When pLoc is greater than the current
-     * end of the body, that signals the parser found a chunk header. */
+        /* If the response is of type Transfer-Encoding: chunked, then actual body
+         * will follow the the chunked header. This body data is in a later location
+         * and must be moved up in the buffer. When pLoc is greater than the current
+         * end of the body, that signals the parser found a chunk header. */
 
-    /* MISRA Ref 18.3.1 [Pointer comparison] */
-    /* More details at: https://github.com/FreeRTOS/coreHTTP/blob/main/MISRA.md#rule-183 */
-    /* coverity[pointer_parameter] */
-    /* coverity[misra_c_2012_rule_18_3_violation] */
-    if( pLoc > pNextWriteLoc )
-    {
-        /* memmove is used instead of memcpy because memcpy has undefined behavior
-         * when source and destination locations in memory overlap. */
-        ( void ) memmove( pNextWriteLoc, pLoc, length );
-    }
+        /* MISRA Ref 18.3.1 [Pointer comparison] */
+        /* More details at: https://github.com/FreeRTOS/coreHTTP/blob/main/MISRA.md#rule-183 */
+        /* coverity[pointer_parameter] */
+        /* coverity[misra_c_2012_rule_18_3_violation] */
+        if( pLoc > pNextWriteLoc )
+        {
+            /* memmove is used instead of memcpy because memcpy has undefined behavior
+             * when source and destination locations in memory overlap. */
+            ( void ) memmove( pNextWriteLoc, pLoc, length );
+        }
 
-    /* Increase the length of the body found. */
-    pResponse->bodyLen += length;
+        /* Increase the length of the body found. */
+        pResponse->bodyLen += length;
+    }
 
     /* Set the next location of parsing. */
     pParsingContext->pBufferCur = pLoc + length;
@@ -993,17 +1133,17 @@ static int httpParserOnMessageCompleteCallback( llhttp_t * pHttpParser )
 
     LogDebug( ( "Response parsing: Response message complete." ) );
 
-    return LLHTTP_CONTINUE_PARSING;
+    /* The data after a pipelined response belongs to the next response, so
+     * the parser is paused where this response ends. */
+    return ( pParsingContext->stopAtMessageEnd == 1U ) ? ( int ) HPE_PAUSED : LLHTTP_CONTINUE_PARSING;
 }
 
 /*-----------------------------------------------------------*/
 
 static void initializeParsingContextForFirstResponse( HTTPParsingContext_t * pParsingContext,
-                                                      const HTTPRequestHeaders_t * pRequestHeaders )
+                                                      uint8_t isHeadResponse )
 {
     assert( pParsingContext != NULL );
-    assert( pRequestHeaders != NULL );
-    assert( pRequestHeaders->headersLen >= HTTP_MINIMUM_REQUEST_LINE_LENGTH );
 
     /* Initialize the callbacks that llhttp_execute will invoke. */
     llhttp_settings_init( &( pParsingContext->llhttpSettings ) );
@@ -1028,12 +1168,33 @@ static void initializeParsingContextForFirstResponse( HTTPParsingContext_t * pPa
      * request. For a HEAD response, the third-party parser requires parsing is
      * indicated to stop by returning a 1 from httpParserOnHeadersCompleteCallback().
      * If this is not done, the parser will not indicate the message is complete. */
+    pParsingContext->isHeadResponse = isHeadResponse;
+
+    /* No part of the body has been streamed to the application yet. */
+    pParsingContext->pBodyStreamStart = NULL;
+
+    /* The response is not pipelined unless the caller says otherwise. */
+    pParsingContext->stopAtMessageEnd = 0U;
+    pParsingContext->pMessageEnd = NULL;
+}
+
+/*-----------------------------------------------------------*/
+
+static uint8_t isHeadRequest( const HTTPRequestHeaders_t * pRequestHeaders )
+{
+    uint8_t isHead = 0U;
+
+    assert( pRequestHeaders != NULL );
+    assert( pRequestHeaders->headersLen >= HTTP_MINIMUM_REQUEST_LINE_LENGTH );
+
     if( strncmp( ( const char * ) ( pRequestHeaders->pBuffer ),
                  HTTP_METHOD_HEAD,
                  sizeof( HTTP_METHOD_HEAD ) - 1U ) == 0 )
     {
-        pParsingContext->isHeadResponse = 1U;
+        isHead = 1U;
     }
+
+    return isHead;
 }
 
 /*-----------------------------------------------------------*/
@@ -1053,6 +1214,12 @@ static HTTPStatus_t processLlhttpError( const llhttp_t * pHttpParser )
             /* There were no errors. */
             break;
 
+        case HPE_PAUSED:
+
+            /* The parser was paused at the end of a pipelined response by
+             * httpParserOnMessageCompleteCallback(). */
+            break;
+
         case HPE_INVALID_EOF_STATE:
 
             /* In this case the parser was passed a length of zero, which indicates
@@ -1208,6 +1375,15 @@ static HTTPStatus_t parseHttpResponse( HTTPParsingContext_t * pParsingContext,
     /* The next location to parse will always be after what has already
      * been parsed. */
     pParsingContext->pBufferCur = parsingStartLoc + parseLen;
+
+    /* Remember where a pipelined response ended, since the data after it
+     * was not parsed. */
+    if( ( pParsingContext->stopAtMessageEnd == 1U ) &&
+        ( pParsingContext->state == HTTP_PARSING_COMPLETE ) &&
+        ( pParsingContext->pMessageEnd == NULL ) )
+    {
+        pParsingContext->pMessageEnd = llhttp_get_error_pos( &( pParsingContext->llhttpParser ) );
+    }
     returnStatus = processLlhttpError( &( pParsingContext->llhttpParser ) );
 
     return returnStatus;
@@ -2006,10 +2182,12 @@ static HTTPStatus_t getFinalResponseStatus( HTTPParsingState_t parsingState,
 
 static HTTPStatus_t receiveAndParseHttpResponse( const TransportInterface_t * pTransport,
                                                  HTTPResponse_t * pResponse,
-                                                 const HTTPRequestHeaders_t * pRequestHeaders )
+                                                 uint8_t isHeadResponse,
+                                                 const uint8_t ** pNextResponse,
+                                                 size_t * pPipelinedLen )
 {
     HTTPStatus_t returnStatus = HTTPSuccess;
-    size_t totalReceived = 0U;
+    size_t totalReceived = 0U, alreadyReceived = 0U;
     int32_t currentReceived = 0;
     HTTPParsingContext_t parsingContext = { 0 };
     uint8_t shouldRecv = 1U, shouldParse = 1U, timeoutReached = 0U;
@@ -2019,11 +2197,19 @@ static HTTPStatus_t receiveAndParseHttpResponse( const TransportInterface_t * pT
     assert( pTransport != NULL );
     assert( pTransport->recv != NULL );
     assert( pResponse != NULL );
-    assert( pRequestHeaders != NULL );
+    assert( ( pPipelinedLen == NULL ) || ( pNextResponse != NULL ) );
 
     /* Initialize the parsing context for parsing the response received from the
      * network. */
-    initializeParsingContextForFirstResponse( &parsingContext, pRequestHeaders );
+    initializeParsingContextForFirstResponse( &parsingContext, isHeadResponse );
+
+    if( pPipelinedLen != NULL )
+    {
+        assert( *pPipelinedLen <= pResponse->bufferLen );
+
+        parsingContext.stopAtMessageEnd = 1U;
+        alreadyReceived = *pPipelinedLen;
+    }
 
     /* If the timestamp function was undefined by the application, then do not
      * retry the transport receive. */
@@ -2038,10 +2224,20 @@ static HTTPStatus_t receiveAndParseHttpResponse( const TransportInterface_t * pT
 
     while( shouldRecv == 1U )
     {
-        /* Receive the HTTP response data into the pResponse->pBuffer. */
-        currentReceived = pTransport->recv( pTransport->pNetworkContext,
-                                            pResponse->pBuffer + totalReceived,
-                                            pResponse->bufferLen - totalReceived );
+        if( alreadyReceived > 0U )
+        {
+            /* Parse the start of a pipelined response that was received along
+             * with the previous response before reading from the network. */
+            currentReceived = ( int32_t ) alreadyReceived;
+            alreadyReceived = 0U;
+        }
+        else
+        {
+            /* Receive the HTTP response data into the pResponse->pBuffer. */
+            currentReceived = pTransport->recv( pTransport->pNetworkContext,
+                                                pResponse->pBuffer + totalReceived,
+                                                pResponse->bufferLen - totalReceived );
+        }
 
         /* Transport receive errors are negative. */
         if( currentReceived < 0 )
@@ -2096,6 +2292,15 @@ static HTTPStatus_t receiveAndParseHttpResponse( const TransportInterface_t * pT
             returnStatus = parseHttpResponse( &parsingContext,
                                               pResponse,
                                               ( uint64_t ) currentReceived );
+
+            /* The body parsed so far has been handed to the application's body
+             * callback, so the next network read can overwrite it. */
+            if( ( parsingContext.pBodyStreamStart != NULL ) &&
+                ( parsingContext.state != HTTP_PARSING_COMPLETE ) )
+            {
+                parsingContext.pBufferCur = parsingContext.pBodyStreamStart;
+                totalReceived = ( size_t ) ( ( const uint8_t * ) parsingContext.pBodyStreamStart - pResponse->pBuffer );
+            }
         }
 
         /* Reading should continue if there are no errors in the transport receive
@@ -2118,6 +2323,19 @@ static HTTPStatus_t receiveAndParseHttpResponse( const TransportInterface_t * pT
                                                pResponse->bufferLen );
     }
 
+    if( pPipelinedLen != NULL )
+    {
+        *pPipelinedLen = 0U;
+
+        if( ( returnStatus == HTTPSuccess ) && ( parsingContext.pMessageEnd != NULL ) )
+        {
+            /* The bytes after the end of this response are the start of the
+             * next response in the pipeline. */
+            *pNextResponse = ( const uint8_t * ) parsingContext.pMessageEnd;
+            *pPipelinedLen = totalReceived - ( size_t ) ( *pNextResponse - pResponse->pBuffer );
+        }
+    }
+
     return returnStatus;
 }
 
@@ -2166,12 +2384,168 @@ static HTTPStatus_t sendHttpRequest( const TransportInterface_t * pTransport,
 
 /*-----------------------------------------------------------*/
 
-HTTPStatus_t HTTPClient_Send( const TransportInterface_t * pTransport,
-                              HTTPRequestHeaders_t * pRequestHeaders,
-                              const uint8_t * pRequestBodyBuf,
-                              size_t reqBodyBufLen,
-                              HTTPResponse_t * pResponse,
-                              uint32_t sendFlags )
+static HTTPStatus_t sendHttpChunk( const TransportInterface_t * pTransport,
+                                   HTTPClient_GetCurrentTimeFunc_t getTimestampMs,
+                                   const uint8_t * pChunk,
+                                   size_t chunkLen )
+{
+    HTTPStatus_t returnStatus = HTTPSuccess;
+    uint8_t chunkHeader[ HTTP_MAX_CHUNK_HEADER_LEN ];
+    size_t chunkHeaderLen = 0U;
+    size_t remainingLen = chunkLen;
+    size_t index = 0U;
+
+    /* Directly passing in these strings to memcpy is a MISRA Rule 7.4 violation
+     * Due to this we allocate these pointers for MISRA compliance */
+    const char * pHexDigits = "0123456789abcdef";
+    const char * pHeaderLineSeparator = HTTP_HEADER_LINE_SEPARATOR;
+
+    assert( pTransport != NULL );
+    assert( pChunk != NULL );
+    assert( ( chunkLen > 0U ) && ( chunkLen <= ( size_t ) INT32_MAX ) );
+
+    /* Count the hexadecimal digits of the chunk size. */
+    do
+    {
+        chunkHeaderLen++;
+        remainingLen >>= 4;
+    } while( remainingLen != 0U );
+
+    /* Write the chunk size digits from the least significant one. */
+    remainingLen = chunkLen;
+
+    for( index = chunkHeaderLen; index > 0U; index-- )
+    {
+        chunkHeader[ index - 1U ] = ( uint8_t ) pHexDigits[ remainingLen & 0xFU ];
+        remainingLen >>= 4;
+    }
+
+    ( void ) memcpy( &chunkHeader[ chunkHeaderLen ],
+                     pHeaderLineSeparator,
+                     HTTP_HEADER_LINE_SEPARATOR_LEN );
+    chunkHeaderLen += HTTP_HEADER_LINE_SEPARATOR_LEN;
+
+    LogDebug( ( "Sending an HTTP request body chunk: ChunkBytes=%lu",
+                ( unsigned long ) chunkLen ) );
+
+    returnStatus = sendHttpData( pTransport, getTimestampMs, chunkHeader, chunkHeaderLen );
+
+    if( returnStatus == HTTPSuccess )
+    {
+        returnStatus = sendHttpData( pTransport, getTimestampMs, pChunk, chunkLen );
+    }
+
+    if( returnStatus == HTTPSuccess )
+    {
+        returnStatus = sendHttpData( pTransport,
+                                     getTimestampMs,
+                                     ( const uint8_t * ) pHeaderLineSeparator,
+                                     HTTP_HEADER_LINE_SEPARATOR_LEN );
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static HTTPStatus_t sendChunkedHttpRequest( const TransportInterface_t * pTransport,
+                                            HTTPClient_GetCurrentTimeFunc_t getTimestampMs,
+                                            HTTPRequestHeaders_t * pRequestHeaders,
+                                            const HTTPClient_RequestBodySource_t * pBodySource,
+                                            uint8_t * pChunkBuffer,
+                                            size_t chunkBufferLen )
+{
+    HTTPStatus_t returnStatus = HTTPSuccess;
+    int32_t bytesRead = 0;
+    size_t readLen = chunkBufferLen;
+
+    /* Directly passing in these strings to memcpy is a MISRA Rule 7.4 violation
+     * Due to this we allocate these pointers for MISRA compliance */
+    const char * pLastChunk = HTTP_LAST_CHUNK;
+
+    assert( pTransport != NULL );
+    assert( pRequestHeaders != NULL );
+    assert( pBodySource != NULL );
+    assert( pBodySource->readBodyCallback != NULL );
+    assert( pChunkBuffer != NULL );
+    assert( chunkBufferLen > 0U );
+
+    /* A chunk must be small enough for its size to be returned by the body
+     * callback. */
+    if( readLen > ( size_t ) INT32_MAX )
+    {
+        readLen = ( size_t ) INT32_MAX;
+    }
+
+    returnStatus = addHeader( pRequestHeaders,
+                              HTTP_TRANSFER_ENCODING_FIELD,
+                              HTTP_TRANSFER_ENCODING_FIELD_LEN,
+                              HTTP_TRANSFER_ENCODING_CHUNKED,
+                              HTTP_TRANSFER_ENCODING_CHUNKED_LEN );
+
+    if( returnStatus == HTTPSuccess )
+    {
+        LogDebug( ( "Sending HTTP request headers: HeaderBytes=%lu",
+                    ( unsigned long ) ( pRequestHeaders->headersLen ) ) );
+        returnStatus = sendHttpData( pTransport,
+                                     getTimestampMs,
+                                     pRequestHeaders->pBuffer,
+                                     pRequestHeaders->headersLen );
+    }
+    else
+    {
+        LogError( ( "Failed to write the Transfer-Encoding header to the "
+                    "request header buffer." ) );
+    }
+
+    /* Send each part of the body the application supplies as one chunk, until
+     * the application indicates the body is complete. */
+    while( returnStatus == HTTPSuccess )
+    {
+        bytesRead = pBodySource->readBodyCallback( pBodySource->pContext,
+                                                   pChunkBuffer,
+                                                   readLen );
+
+        if( bytesRead < 0 )
+        {
+            LogError( ( "Failed to read the HTTP request body: "
+                        "Body callback returned an error: Status=%ld",
+                        ( long int ) bytesRead ) );
+            returnStatus = HTTPRequestBodyError;
+        }
+        else if( bytesRead == 0 )
+        {
+            break;
+        }
+        else
+        {
+            /* It is a bug in the application's body callback if more bytes
+             * than requested are returned. */
+            assert( ( size_t ) bytesRead <= readLen );
+
+            returnStatus = sendHttpChunk( pTransport,
+                                          getTimestampMs,
+                                          pChunkBuffer,
+                                          ( size_t ) bytesRead );
+        }
+    }
+
+    if( returnStatus == HTTPSuccess )
+    {
+        returnStatus = sendHttpData( pTransport,
+                                     getTimestampMs,
+                                     ( const uint8_t * ) pLastChunk,
+                                     HTTP_LAST_CHUNK_LEN );
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static HTTPStatus_t validateSendParameters( const TransportInterface_t * pTransport,
+                                            const HTTPRequestHeaders_t * pRequestHeaders,
+                                            HTTPResponse_t * pResponse )
 {
     HTTPStatus_t returnStatus = HTTPInvalidParameter;
 
@@ -2220,7 +2594,34 @@ HTTPStatus_t HTTPClient_Send( const TransportInterface_t * pTransport,
     {
         LogError( ( "Parameter check failed: pResponse->bufferLen is zero." ) );
     }
-    else if( ( pRequestBodyBuf == NULL ) && ( reqBodyBufLen > 0U ) )
+    else if( ( pResponse->pBodyCallback != NULL ) &&
+             ( pResponse->pBodyCallback->onBodyCallback == NULL ) )
+    {
+        LogError( ( "Parameter check failed: pResponse->pBodyCallback->onBodyCallback is NULL." ) );
+    }
+    else
+    {
+        if( pResponse->getTime == NULL )
+        {
+            /* Set a zero timestamp function when the application did not configure
+             * one. */
+            pResponse->getTime = getZeroTimestampMs;
+        }
+
+        returnStatus = HTTPSuccess;
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static HTTPStatus_t validateRequestBody( const uint8_t * pRequestBodyBuf,
+                                         size_t reqBodyBufLen )
+{
+    HTTPStatus_t returnStatus = HTTPInvalidParameter;
+
+    if( ( pRequestBodyBuf == NULL ) && ( reqBodyBufLen > 0U ) )
     {
         /* If there is no body to send we must ensure that the reqBodyBufLen is
          * zero so that no Content-Length header is automatically written. */
@@ -2237,18 +2638,37 @@ HTTPStatus_t HTTPClient_Send( const TransportInterface_t * pTransport,
     }
     else
     {
-        if( pResponse->getTime == NULL )
-        {
-            /* Set a zero timestamp function when the application did not configure
-             * one. */
-            pResponse->getTime = getZeroTimestampMs;
-        }
-
         returnStatus = HTTPSuccess;
     }
 
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+HTTPStatus_t HTTPClient_Send( const TransportInterface_t * pTransport,
+                              HTTPRequestHeaders_t * pRequestHeaders,
+                              const uint8_t * pRequestBodyBuf,
+                              size_t reqBodyBufLen,
+                              HTTPResponse_t * pResponse,
+                              uint32_t sendFlags )
+{
+    HTTPStatus_t returnStatus = HTTPInvalidParameter;
+    uint8_t isHeadResponse = 0U;
+
+    returnStatus = validateRequestBody( pRequestBodyBuf, reqBodyBufLen );
+
+    if( returnStatus == HTTPSuccess )
+    {
+        returnStatus = validateSendParameters( pTransport, pRequestHeaders, pResponse );
+    }
+
     if( returnStatus == HTTPSuccess )
     {
+        /* The request headers are checked before they are sent, since the
+         * application may reuse their buffer for the response. */
+        isHeadResponse = isHeadRequest( pRequestHeaders );
+
         returnStatus = sendHttpRequest( pTransport,
                                         pResponse->getTime,
                                         pRequestHeaders,
@@ -2261,7 +2681,239 @@ HTTPStatus_t HTTPClient_Send( const TransportInterface_t * pTransport,
     {
         returnStatus = receiveAndParseHttpResponse( pTransport,
                                                     pResponse,
-                                                    pRequestHeaders );
+                                                    isHeadResponse,
+                                                    NULL,
+                                                    NULL );
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+HTTPStatus_t HTTPClient_SendChunked( const TransportInterface_t * pTransport,
+                                     HTTPRequestHeaders_t * pRequestHeaders,
+                                     const HTTPClient_RequestBodySource_t * pBodySource,
+                                     HTTPResponse_t * pResponse )
+{
+    HTTPStatus_t returnStatus = HTTPInvalidParameter;
+
+    if( pBodySource == NULL )
+    {
+        LogError( ( "Parameter check failed: pBodySource is NULL." ) );
+    }
+    else if( pBodySource->readBodyCallback == NULL )
+    {
+        LogError( ( "Parameter check failed: pBodySource->readBodyCallback is NULL." ) );
+    }
+    else
+    {
+        returnStatus = validateSendParameters( pTransport, pRequestHeaders, pResponse );
+    }
+
+    if( ( returnStatus == HTTPSuccess ) && ( isHeadRequest( pRequestHeaders ) == 1U ) )
+    {
+        LogError( ( "Parameter check failed: A HEAD request cannot have a body." ) );
+        returnStatus = HTTPInvalidParameter;
+    }
+
+    if( returnStatus == HTTPSuccess )
+    {
+        /* The response buffer is not needed until the whole request has been
+         * sent, so each chunk of the body is read into it. */
+        returnStatus = sendChunkedHttpRequest( pTransport,
+                                               pResponse->getTime,
+                                               pRequestHeaders,
+                                               pBodySource,
+                                               pResponse->pBuffer,
+                                               pResponse->bufferLen );
+    }
+
+    if( returnStatus == HTTPSuccess )
+    {
+        returnStatus = receiveAndParseHttpResponse( pTransport,
+                                                    pResponse,
+                                                    0U,
+                                                    NULL,
+                                                    NULL );
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static HTTPStatus_t receivePipelinedResponses( const TransportInterface_t * pTransport,
+                                               HTTPPipelinedRequest_t * pRequests,
+                                               size_t requestCount )
+{
+    HTTPStatus_t returnStatus = HTTPSuccess;
+    HTTPPipelinedRequest_t * pRequest = NULL;
+    HTTPResponse_t * pResponse = NULL;
+    const uint8_t * pNextResponse = NULL;
+    size_t pipelinedLen = 0U;
+    uint8_t isHeadResponse = 0U;
+    size_t i = 0U;
+
+    assert( pTransport != NULL );
+    assert( pRequests != NULL );
+
+    for( i = 0U; ( i < requestCount ) && ( returnStatus == HTTPSuccess ); i++ )
+    {
+        pRequest = &pRequests[ i ];
+        pResponse = pRequest->pResponse;
+
+        /* The request headers may share the response buffer, so they are
+         * checked before anything is written to it. */
+        isHeadResponse = isHeadRequest( pRequest->pRequestHeaders );
+
+        if( pipelinedLen > pResponse->bufferLen )
+        {
+            LogError( ( "Failed to receive a pipelined HTTP response: The "
+                        "start of the response does not fit in its response "
+                        "buffer: ReceivedBytes=%lu, BufferLength=%lu",
+                        ( unsigned long ) pipelinedLen,
+                        ( unsigned long ) pResponse->bufferLen ) );
+            returnStatus = HTTPInsufficientMemory;
+        }
+        else
+        {
+            if( pipelinedLen > 0U )
+            {
+                /* Move the start of this response, which was received with the
+                 * previous response, to the start of its own buffer. memmove is
+                 * used since the application may receive every response into
+                 * the same buffer. */
+                ( void ) memmove( pResponse->pBuffer, pNextResponse, pipelinedLen );
+            }
+
+            returnStatus = receiveAndParseHttpResponse( pTransport,
+                                                        pResponse,
+                                                        isHeadResponse,
+                                                        &pNextResponse,
+                                                        &pipelinedLen );
+        }
+
+        /* The latency field held the time the request started to be sent. */
+        pRequest->latencyMs = pResponse->getTime() - pRequest->latencyMs;
+        pRequest->status = returnStatus;
+
+        if( ( returnStatus == HTTPSuccess ) &&
+            ( ( pResponse->respFlags & HTTP_RESPONSE_CONNECTION_CLOSE_FLAG ) != 0U ) )
+        {
+            if( pipelinedLen > 0U )
+            {
+                LogError( ( "Response parsing error: Data received past complete "
+                            "response with \"Connection: close\" header present." ) );
+                returnStatus = HTTPSecurityAlertExtraneousResponseData;
+            }
+            else if( ( i + 1U ) < requestCount )
+            {
+                LogWarn( ( "The server closed the connection before responding "
+                           "to every pipelined request: UnansweredRequests=%lu",
+                           ( unsigned long ) ( requestCount - i - 1U ) ) );
+                returnStatus = HTTPNoResponse;
+            }
+            else
+            {
+                /* Empty else MISRA 15.7 */
+            }
+        }
+    }
+
+    /* The requests that were not reached have no latency to report. */
+    for( ; i < requestCount; i++ )
+    {
+        pRequests[ i ].latencyMs = 0U;
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+HTTPStatus_t HTTPClient_SendPipelined( const TransportInterface_t * pTransport,
+                                       HTTPPipelinedRequest_t * pRequests,
+                                       size_t requestCount )
+{
+    HTTPStatus_t returnStatus = HTTPInvalidParameter;
+    HTTPPipelinedRequest_t * pRequest = NULL;
+    size_t i = 0U;
+
+    if( pRequests == NULL )
+    {
+        LogError( ( "Parameter check failed: pRequests is NULL." ) );
+    }
+    else if( requestCount == 0U )
+    {
+        LogError( ( "Parameter check failed: requestCount is zero." ) );
+    }
+    else
+    {
+        returnStatus = HTTPSuccess;
+    }
+
+    /* Every request is checked before any is sent, so that an invalid request
+     * does not leave the pipeline half sent. */
+    for( i = 0U; ( returnStatus == HTTPSuccess ) && ( i < requestCount ); i++ )
+    {
+        pRequest = &pRequests[ i ];
+        returnStatus = validateRequestBody( pRequest->pRequestBodyBuf,
+                                            pRequest->reqBodyBufLen );
+
+        if( returnStatus == HTTPSuccess )
+        {
+            returnStatus = validateSendParameters( pTransport,
+                                                   pRequest->pRequestHeaders,
+                                                   pRequest->pResponse );
+        }
+
+        if( returnStatus != HTTPSuccess )
+        {
+            LogError( ( "Pipelined request %lu is invalid.", ( unsigned long ) i ) );
+        }
+    }
+
+    if( returnStatus == HTTPSuccess )
+    {
+        for( i = 0U; i < requestCount; i++ )
+        {
+            pRequests[ i ].status = HTTPNoResponse;
+            pRequests[ i ].latencyMs = 0U;
+        }
+
+        /* Send every request without waiting for the responses. */
+        for( i = 0U; ( returnStatus == HTTPSuccess ) && ( i < requestCount ); i++ )
+        {
+            pRequest = &pRequests[ i ];
+
+            /* The latency field holds the time the request started to be sent
+             * until its response is received. */
+            pRequest->latencyMs = pRequest->pResponse->getTime();
+
+            returnStatus = sendHttpRequest( pTransport,
+                                            pRequest->pResponse->getTime,
+                                            pRequest->pRequestHeaders,
+                                            pRequest->pRequestBodyBuf,
+                                            pRequest->reqBodyBufLen,
+                                            pRequest->sendFlags );
+
+            if( returnStatus != HTTPSuccess )
+            {
+                pRequest->status = returnStatus;
+            }
+        }
+
+        /* No response is received after a request fails to send. */
+        for( i = 0U; ( returnStatus != HTTPSuccess ) && ( i < requestCount ); i++ )
+        {
+            pRequests[ i ].latencyMs = 0U;
+        }
+    }
+
+    if( returnStatus == HTTPSuccess )
+    {
+        returnStatus = receivePipelinedResponses( pTransport, pRequests, requestCount );
     }
 
     return returnStatus;
@@ -2641,6 +3293,10 @@ const char * HTTPClient_strerror( HTTPStatus_t status )
             str = "HTTPInvalidResponse";
             break;
 
+        case HTTPRequestBodyError:
+            str = "HTTPRequestBodyError";
+            break;
+
         default:
             LogWarn( ( "Invalid status code received for string conversion: "
                        "StatusCode=%d", ( int ) status ) );
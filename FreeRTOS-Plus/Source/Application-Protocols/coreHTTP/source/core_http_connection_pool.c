@@ -0,0 +1,402 @@
+/*
+ * coreHTTP v3.0.0
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_http_connection_pool.c
+ * @brief Implements the user-facing functions in core_http_connection_pool.h.
+ */
+#include <assert.h>
+#include <string.h>
+
+#include "core_http_connection_pool.h"
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Find the open connection to a host.
+ *
+ * @param[in] pPool The connection pool.
+ * @param[in] pHost The host of the connection.
+ * @param[in] hostLen The length of @p pHost.
+ *
+ * @return The open connection to the host, or NULL if there is none.
+ */
+static HTTPPooledConnection_t * findConnection( const HTTPConnectionPool_t * pPool,
+                                                const char * pHost,
+                                                size_t hostLen );
+
+/**
+ * @brief Take a connection to a host from the pool, opening it if needed.
+ *
+ * If no connection is open to the host, a closed connection of the pool is
+ * used for it. If every connection is open, the least recently used one is
+ * closed first.
+ *
+ * @param[in] pPool The connection pool.
+ * @param[in] pHost The host of the connection.
+ * @param[in] hostLen The length of @p pHost.
+ * @param[out] pIsNew Set to 1 if the connection was opened by this call.
+ *
+ * @return The connection, or NULL if a new connection could not be opened.
+ */
+static HTTPPooledConnection_t * acquireConnection( HTTPConnectionPool_t * pPool,
+                                                   const char * pHost,
+                                                   size_t hostLen,
+                                                   uint8_t * pIsNew );
+
+/**
+ * @brief Close a connection of the pool.
+ *
+ * @param[in] pPool The connection pool.
+ * @param[in] pConnection The connection to close.
+ */
+static void closeConnection( const HTTPConnectionPool_t * pPool,
+                             HTTPPooledConnection_t * pConnection );
+
+/**
+ * @brief Check whether requests that failed with a status can be sent again
+ * on a new connection.
+ *
+ * @param[in] status The status the requests failed with.
+ *
+ * @return 1 if the status means the connection went away, 0 otherwise.
+ */
+static uint8_t isConnectionLost( HTTPStatus_t status );
+
+/*-----------------------------------------------------------*/
+
+static HTTPPooledConnection_t * findConnection( const HTTPConnectionPool_t * pPool,
+                                                const char * pHost,
+                                                size_t hostLen )
+{
+    HTTPPooledConnection_t * pConnection = NULL;
+    size_t i = 0U;
+
+    assert( pPool != NULL );
+    assert( pHost != NULL );
+
+    for( i = 0U; ( i < pPool->connectionCount ) && ( pConnection == NULL ); i++ )
+    {
+        if( ( pPool->pConnections[ i ].isConnected == 1U ) &&
+            ( pPool->pConnections[ i ].hostLen == hostLen ) &&
+            ( memcmp( pPool->pConnections[ i ].host, pHost, hostLen ) == 0 ) )
+        {
+            pConnection = &pPool->pConnections[ i ];
+        }
+    }
+
+    return pConnection;
+}
+
+/*-----------------------------------------------------------*/
+
+static HTTPPooledConnection_t * acquireConnection( HTTPConnectionPool_t * pPool,
+                                                   const char * pHost,
+                                                   size_t hostLen,
+                                                   uint8_t * pIsNew )
+{
+    HTTPPooledConnection_t * pConnection = NULL;
+    size_t i = 0U;
+    int32_t connectStatus = 0;
+
+    assert( pPool != NULL );
+    assert( pHost != NULL );
+    assert( hostLen <= HTTP_CONNECTION_POOL_MAX_HOST_LENGTH );
+    assert( pIsNew != NULL );
+
+    *pIsNew = 0U;
+    pConnection = findConnection( pPool, pHost, hostLen );
+
+    if( pConnection == NULL )
+    {
+        /* Use a closed connection if there is one, otherwise the least
+         * recently used open connection. */
+        pConnection = &pPool->pConnections[ 0 ];
+
+        for( i = 1U; ( i < pPool->connectionCount ) && ( pConnection->isConnected == 1U ); i++ )
+        {
+            if( ( pPool->pConnections[ i ].isConnected == 0U ) ||
+                ( pPool->pConnections[ i ].lastUsed < pConnection->lastUsed ) )
+            {
+                pConnection = &pPool->pConnections[ i ];
+            }
+        }
+
+        if( pConnection->isConnected == 1U )
+        {
+            LogDebug( ( "Closing the least recently used connection: Host=%.*s",
+                        ( int ) pConnection->hostLen,
+                        pConnection->host ) );
+            closeConnection( pPool, pConnection );
+        }
+
+        ( void ) memset( &pConnection->transport, 0, sizeof( TransportInterface_t ) );
+        connectStatus = pPool->connectionInterface.connect( pPool->connectionInterface.pContext,
+                                                            pHost,
+                                                            hostLen,
+                                                            &pConnection->transport );
+
+        if( connectStatus != 0 )
+        {
+            LogError( ( "Failed to open a connection: Host=%.*s, Status=%ld",
+                        ( int ) hostLen,
+                        pHost,
+                        ( long int ) connectStatus ) );
+            pConnection = NULL;
+        }
+        else
+        {
+            ( void ) memcpy( pConnection->host, pHost, hostLen );
+            pConnection->hostLen = hostLen;
+            pConnection->isConnected = 1U;
+            pConnection->requestCount = 0U;
+            pPool->connectCount++;
+            *pIsNew = 1U;
+
+            LogDebug( ( "Opened a connection: Host=%.*s",
+                        ( int ) hostLen,
+                        pHost ) );
+        }
+    }
+
+    if( pConnection != NULL )
+    {
+        pPool->useCount++;
+        pConnection->lastUsed = pPool->useCount;
+    }
+
+    return pConnection;
+}
+
+/*-----------------------------------------------------------*/
+
+static void closeConnection( const HTTPConnectionPool_t * pPool,
+                             HTTPPooledConnection_t * pConnection )
+{
+    assert( pPool != NULL );
+    assert( pConnection != NULL );
+    assert( pConnection->isConnected == 1U );
+
+    pPool->connectionInterface.disconnect( pPool->connectionInterface.pContext,
+                                           &pConnection->transport );
+    pConnection->isConnected = 0U;
+}
+
+/*-----------------------------------------------------------*/
+
+static uint8_t isConnectionLost( HTTPStatus_t status )
+{
+    /* A keep-alive connection the server has closed is found when sending to
+     * it fails, or when it returns no response. */
+    return ( ( status == HTTPNetworkError ) || ( status == HTTPNoResponse ) ) ? 1U : 0U;
+}
+
+/*-----------------------------------------------------------*/
+
+HTTPStatus_t HTTPConnectionPool_Init( HTTPConnectionPool_t * pPool,
+                                      HTTPPooledConnection_t * pConnections,
+                                      size_t connectionCount,
+                                      const HTTPConnectionInterface_t * pConnectionInterface )
+{
+    HTTPStatus_t returnStatus = HTTPInvalidParameter;
+
+    if( pPool == NULL )
+    {
+        LogError( ( "Parameter check failed: pPool is NULL." ) );
+    }
+    else if( pConnections == NULL )
+    {
+        LogError( ( "Parameter check failed: pConnections is NULL." ) );
+    }
+    else if( connectionCount == 0U )
+    {
+        LogError( ( "Parameter check failed: connectionCount is zero." ) );
+    }
+    else if( pConnectionInterface == NULL )
+    {
+        LogError( ( "Parameter check failed: pConnectionInterface is NULL." ) );
+    }
+    else if( ( pConnectionInterface->connect == NULL ) ||
+             ( pConnectionInterface->disconnect == NULL ) )
+    {
+        LogError( ( "Parameter check failed: pConnectionInterface->connect or "
+                    "pConnectionInterface->disconnect is NULL." ) );
+    }
+    else
+    {
+        ( void ) memset( pConnections, 0, connectionCount * sizeof( HTTPPooledConnection_t ) );
+        ( void ) memset( pPool, 0, sizeof( HTTPConnectionPool_t ) );
+        pPool->pConnections = pConnections;
+        pPool->connectionCount = connectionCount;
+        pPool->connectionInterface = *pConnectionInterface;
+        returnStatus = HTTPSuccess;
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+HTTPStatus_t HTTPConnectionPool_Send( HTTPConnectionPool_t * pPool,
+                                      const char * pHost,
+                                      size_t hostLen,
+                                      HTTPPipelinedRequest_t * pRequests,
+                                      size_t requestCount )
+{
+    HTTPStatus_t returnStatus = HTTPInvalidParameter;
+    HTTPPooledConnection_t * pConnection = NULL;
+    size_t headersLen[ HTTP_CONNECTION_POOL_MAX_PIPELINE_DEPTH ];
+    size_t next = 0U, batchCount = 0U, answered = 0U, i = 0U;
+    uint8_t isNew = 0U, shouldClose = 0U;
+
+    if( ( pPool == NULL ) || ( pPool->pConnections == NULL ) )
+    {
+        LogError( ( "Parameter check failed: pPool is NULL or not initialized." ) );
+    }
+    else if( ( pHost == NULL ) || ( hostLen == 0U ) )
+    {
+        LogError( ( "Parameter check failed: pHost is NULL or hostLen is zero." ) );
+    }
+    else if( hostLen > HTTP_CONNECTION_POOL_MAX_HOST_LENGTH )
+    {
+        LogError( ( "Parameter check failed: hostLen > HTTP_CONNECTION_POOL_MAX_HOST_LENGTH: "
+                    "hostLen=%lu",
+                    ( unsigned long ) hostLen ) );
+    }
+    else if( ( pRequests == NULL ) || ( requestCount == 0U ) )
+    {
+        LogError( ( "Parameter check failed: pRequests is NULL or requestCount is zero." ) );
+    }
+    else
+    {
+        returnStatus = HTTPSuccess;
+    }
+
+    while( ( returnStatus == HTTPSuccess ) && ( next < requestCount ) )
+    {
+        pConnection = acquireConnection( pPool, pHost, hostLen, &isNew );
+
+        if( pConnection == NULL )
+        {
+            returnStatus = HTTPNetworkError;
+            break;
+        }
+
+        batchCount = requestCount - next;
+
+        if( batchCount > HTTP_CONNECTION_POOL_MAX_PIPELINE_DEPTH )
+        {
+            batchCount = HTTP_CONNECTION_POOL_MAX_PIPELINE_DEPTH;
+        }
+
+        /* Sending a request may append a Content-Length header, so the header
+         * lengths are kept to send the requests again unchanged. */
+        for( i = 0U; i < batchCount; i++ )
+        {
+            headersLen[ i ] = ( pRequests[ next + i ].pRequestHeaders != NULL ) ?
+                              pRequests[ next + i ].pRequestHeaders->headersLen : 0U;
+        }
+
+        returnStatus = HTTPClient_SendPipelined( &pConnection->transport,
+                                                 &pRequests[ next ],
+                                                 batchCount );
+
+        /* Count the requests answered before the first that failed. Nothing
+         * was sent when a request was invalid. */
+        answered = 0U;
+
+        while( ( returnStatus != HTTPInvalidParameter ) &&
+               ( answered < batchCount ) &&
+               ( pRequests[ next + answered ].status == HTTPSuccess ) )
+        {
+            answered++;
+        }
+
+        /* Keep the connection open unless it failed or the server is closing
+         * it after the last response. */
+        shouldClose = ( returnStatus != HTTPSuccess ) ? 1U : 0U;
+
+        if( ( answered > 0U ) &&
+            ( ( pRequests[ next + answered - 1U ].pResponse->respFlags &
+                HTTP_RESPONSE_CONNECTION_CLOSE_FLAG ) != 0U ) )
+        {
+            shouldClose = 1U;
+        }
+
+        if( ( shouldClose == 1U ) && ( returnStatus != HTTPInvalidParameter ) )
+        {
+            closeConnection( pPool, pConnection );
+        }
+
+        pConnection->requestCount += ( uint32_t ) answered;
+
+        /* Send the unanswered requests again on a new connection when the
+         * connection went away, as long as a request was answered or the
+         * connection was a kept open one that may have gone stale. */
+        if( ( isConnectionLost( returnStatus ) == 1U ) &&
+            ( ( answered > 0U ) || ( isNew == 0U ) ) )
+        {
+            LogInfo( ( "Sending requests again on a new connection: "
+                       "Host=%.*s, UnansweredRequests=%lu",
+                       ( int ) hostLen,
+                       pHost,
+                       ( unsigned long ) ( requestCount - next - answered ) ) );
+
+            for( i = answered; i < batchCount; i++ )
+            {
+                pRequests[ next + i ].pRequestHeaders->headersLen = headersLen[ i ];
+            }
+
+            returnStatus = HTTPSuccess;
+        }
+
+        next += answered;
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+void HTTPConnectionPool_CloseAll( HTTPConnectionPool_t * pPool )
+{
+    size_t i = 0U;
+
+    if( ( pPool == NULL ) || ( pPool->pConnections == NULL ) )
+    {
+        LogError( ( "Parameter check failed: pPool is NULL or not initialized." ) );
+    }
+    else
+    {
+        for( i = 0U; i < pPool->connectionCount; i++ )
+        {
+            if( pPool->pConnections[ i ].isConnected == 1U )
+            {
+                closeConnection( pPool, &pPool->pConnections[ i ] );
+            }
+        }
+    }
+}
+
+/*-----------------------------------------------------------*/
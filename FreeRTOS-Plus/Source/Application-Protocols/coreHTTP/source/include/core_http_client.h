@@ -170,6 +170,8 @@ typedef enum HTTPStatus
      * - #HTTPClient_AddHeader
      * - #HTTPClient_AddRangeHeader
      * - #HTTPClient_Send
+     * - #HTTPClient_SendChunked
+     * - #HTTPClient_SendPipelined
      * - #HTTPClient_ReadHeader
      */
     HTTPSuccess,
@@ -182,6 +184,8 @@ typedef enum HTTPStatus
      * - #HTTPClient_AddHeader
      * - #HTTPClient_AddRangeHeader
      * - #HTTPClient_Send
+     * - #HTTPClient_SendChunked
+     * - #HTTPClient_SendPipelined
      * - #HTTPClient_ReadHeader
      */
     HTTPInvalidParameter,
@@ -191,6 +195,7 @@ typedef enum HTTPStatus
      *
      * Functions that may return this value:
      * - #HTTPClient_Send
+     * - #HTTPClient_SendPipelined
      */
     HTTPNetworkError,
 
@@ -206,10 +211,12 @@ typedef enum HTTPStatus
      * @brief No HTTP response was received from the network.
      *
      * This can occur only if there was no data received from the transport
-     * interface.
+     * interface, or if the server closed a pipelined connection before
+     * responding to every request.
      *
      * Functions that may return this value:
      * - #HTTPClient_Send
+     * - #HTTPClient_SendPipelined
      */
     HTTPNoResponse,
 
@@ -304,7 +311,16 @@ typedef enum HTTPStatus
      * Functions that may return this value:
      * - #HTTPClient_ReadHeader
      */
-    HTTPInvalidResponse
+    HTTPInvalidResponse,
+
+    /**
+     * @brief The application's request body callback returned an error while
+     * the request body was being sent.
+     *
+     * Functions that may return this value:
+     * - #HTTPClient_SendChunked
+     */
+    HTTPRequestBodyError
 } HTTPStatus_t;
 
 /**
@@ -410,6 +426,63 @@ typedef struct HTTPClient_ResponseHeaderParsingCallback
     void * pContext;
 } HTTPClient_ResponseHeaderParsingCallback_t;
 
+/**
+ * @ingroup http_struct_types
+ * @brief Callback to receive the response body as it is parsed, instead of
+ * collecting it in #HTTPResponse_t.pBuffer.
+ */
+typedef struct HTTPClient_ResponseBodyCallback
+{
+    /**
+     * @brief Invoked with each part of the response body, in order.
+     *
+     * For a "Transfer-Encoding: chunked" response, the chunk headers are
+     * removed and only the body data is passed.
+     *
+     * @param[in] pContext User context.
+     * @param[in] pBody Location of this part of the body in the response
+     * buffer. It is valid only until the callback returns.
+     * @param[in] bodyLen Length in bytes of this part of the body.
+     * @param[in] statusCode The HTTP response status-code.
+     */
+    void ( * onBodyCallback )( void * pContext,
+                               const uint8_t * pBody,
+                               size_t bodyLen,
+                               uint16_t statusCode );
+
+    /**
+     * @brief Private context for the application.
+     */
+    void * pContext;
+} HTTPClient_ResponseBodyCallback_t;
+
+/**
+ * @ingroup http_struct_types
+ * @brief Callback that supplies the request body of #HTTPClient_SendChunked
+ * one chunk at a time.
+ */
+typedef struct HTTPClient_RequestBodySource
+{
+    /**
+     * @brief Invoked to fill the next chunk of the request body.
+     *
+     * @param[in] pContext User context.
+     * @param[out] pBuffer Buffer to write the next part of the body to.
+     * @param[in] bufferLen The number of bytes available in @p pBuffer.
+     *
+     * @return The number of bytes written to @p pBuffer, zero once the whole
+     * body has been supplied, or a negative value to abort the request.
+     */
+    int32_t ( * readBodyCallback )( void * pContext,
+                                    uint8_t * pBuffer,
+                                    size_t bufferLen );
+
+    /**
+     * @brief Private context for the application.
+     */
+    void * pContext;
+} HTTPClient_RequestBodySource_t;
+
 /**
  * @ingroup http_callback_types
  * @brief Application provided function to query the current time in
@@ -450,6 +523,18 @@ typedef struct HTTPResponse
      */
     HTTPClient_ResponseHeaderParsingCallback_t * pHeaderParsingCallback;
 
+    /**
+     * @brief Optional callback for receiving the response body as it is
+     * parsed. Set to NULL to collect the body in pBuffer.
+     *
+     * When set, pBuffer only needs to hold the response headers. Each part of
+     * the body is passed to the callback and its space in pBuffer is reused
+     * for the next network read, so the body may be much larger than pBuffer.
+     * #HTTPResponse_t.pBody is then NULL and #HTTPResponse_t.bodyLen is the
+     * total number of body bytes passed to the callback.
+     */
+    HTTPClient_ResponseBodyCallback_t * pBodyCallback;
+
     /**
      * @brief Optional callback for getting the system time.
      *
@@ -526,6 +611,43 @@ typedef struct HTTPResponse
     uint32_t respFlags;
 } HTTPResponse_t;
 
+/**
+ * @ingroup http_struct_types
+ * @brief One request of a pipeline sent with #HTTPClient_SendPipelined.
+ */
+typedef struct HTTPPipelinedRequest
+{
+    HTTPRequestHeaders_t * pRequestHeaders; /**< Request headers to send. */
+    const uint8_t * pRequestBodyBuf;        /**< Optional request body. Set to NULL if there is no request body. */
+    size_t reqBodyBufLen;                   /**< The length of the request body in bytes. */
+    uint32_t sendFlags;                     /**< Flags for the request, see @ref http_send_flags. */
+
+    /**
+     * @brief The response to the request is received here.
+     *
+     * The response buffer may be shared with the request headers of the same
+     * request only; every other request of the pipeline must still be intact
+     * when this response is received.
+     */
+    HTTPResponse_t * pResponse;
+
+    /**
+     * @brief The status of this request, updated by #HTTPClient_SendPipelined.
+     *
+     * #HTTPNoResponse is left in requests that were not answered because an
+     * earlier request failed or the server closed the connection.
+     */
+    HTTPStatus_t status;
+
+    /**
+     * @brief Milliseconds from starting to send the request until its
+     * response was complete, measured with #HTTPResponse_t.getTime.
+     *
+     * This is updated by #HTTPClient_SendPipelined.
+     */
+    uint32_t latencyMs;
+} HTTPPipelinedRequest_t;
+
 /**
  * @brief Initialize the request headers, stored in
  * #HTTPRequestHeaders_t.pBuffer, with initial configurations from
@@ -821,6 +943,85 @@ HTTPStatus_t HTTPClient_Send( const TransportInterface_t * pTransport,
                               uint32_t sendFlags );
 /* @[declare_httpclient_send] */
 
+/**
+ * @brief Send the request headers in #HTTPRequestHeaders_t.pBuffer followed by
+ * a request body of unknown length using "Transfer-Encoding: chunked". The
+ * response is received in #HTTPResponse_t.pBuffer.
+ *
+ * The "Transfer-Encoding: chunked" header is written to @p pRequestHeaders
+ * before the headers are sent. The body is then read from
+ * @p pBodySource into #HTTPResponse_t.pBuffer and each read is sent as one
+ * chunk, until the callback returns zero. The response buffer is free to use
+ * for this because the response is not received until the whole request has
+ * been sent. Set #HTTPResponse_t.pBodyCallback to stream a large response body
+ * as well.
+ *
+ * The application should close the connection with the server if any of the
+ * security alerts listed for #HTTPClient_Send are returned.
+ *
+ * @param[in] pTransport Transport interface, see #TransportInterface_t for
+ * more information.
+ * @param[in] pRequestHeaders Request configuration containing the buffer of
+ * headers to send. The request must not be a HEAD request.
+ * @param[in] pBodySource Application callback that supplies the request body.
+ * @param[in] pResponse The response message and some notable response
+ * parameters will be returned here on success.
+ *
+ * @return One of the following:
+ * - #HTTPSuccess (If successful.)
+ * - #HTTPInvalidParameter (If any provided parameters or their members are invalid.)
+ * - #HTTPNetworkError (Errors in sending or receiving over the transport interface.)
+ * - #HTTPRequestBodyError (The body callback returned a negative value.)
+ * - #HTTPInsufficientMemory (The Transfer-Encoding header could not be added
+ * or the response headers could not fit into the response buffer.)
+ * - Please see #HTTPClient_Send for the statuses returned while receiving the
+ * response.
+ */
+/* @[declare_httpclient_sendchunked] */
+HTTPStatus_t HTTPClient_SendChunked( const TransportInterface_t * pTransport,
+                                     HTTPRequestHeaders_t * pRequestHeaders,
+                                     const HTTPClient_RequestBodySource_t * pBodySource,
+                                     HTTPResponse_t * pResponse );
+/* @[declare_httpclient_sendchunked] */
+
+/**
+ * @brief Send several requests over the transport back to back, without
+ * waiting for each response, then receive the responses in order.
+ *
+ * Each request is sent as #HTTPClient_Send would send it. Once every request
+ * has been sent, each response is received into its own
+ * #HTTPPipelinedRequest_t.pResponse. When a network read returns the start of
+ * the next response along with the end of the current one, the extra bytes are
+ * moved to the start of the next response buffer.
+ *
+ * The result of each request is left in #HTTPPipelinedRequest_t.status and the
+ * time it took in #HTTPPipelinedRequest_t.latencyMs. Processing stops at the
+ * first request that fails, and the connection should then be closed. If a
+ * response carries a "Connection: close" header, the remaining requests are
+ * left unanswered with #HTTPNoResponse.
+ *
+ * @note Per RFC 7230 section 6.3.2, only idempotent requests, such as GET
+ * requests for byte ranges written with #HTTPClient_AddRangeHeader, should be
+ * pipelined.
+ *
+ * @param[in] pTransport Transport interface, see #TransportInterface_t for
+ * more information.
+ * @param[in,out] pRequests The requests to send, in order.
+ * @param[in] requestCount The number of requests in @p pRequests.
+ *
+ * @return #HTTPSuccess if a response was received for every request.
+ * #HTTPInvalidParameter if any request is invalid, in which case nothing is
+ * sent. #HTTPNoResponse if the server closed the connection before responding
+ * to every request. #HTTPSecurityAlertExtraneousResponseData if data follows
+ * a response with a "Connection: close" header. Otherwise, the status of the
+ * first request that failed; please see #HTTPClient_Send for those statuses.
+ */
+/* @[declare_httpclient_sendpipelined] */
+HTTPStatus_t HTTPClient_SendPipelined( const TransportInterface_t * pTransport,
+                                       HTTPPipelinedRequest_t * pRequests,
+                                       size_t requestCount );
+/* @[declare_httpclient_sendpipelined] */
+
 /**
  * @brief Read a header from a buffer containing a complete HTTP response.
  * This will return the location of the response header value in the
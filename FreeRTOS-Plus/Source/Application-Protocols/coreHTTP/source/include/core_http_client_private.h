@@ -103,6 +103,20 @@
 #define HTTP_CONTENT_LENGTH_FIELD          "Content-Length"                             /**< HTTP header field "Content-Length". */
 #define HTTP_CONTENT_LENGTH_FIELD_LEN      ( sizeof( HTTP_CONTENT_LENGTH_FIELD ) - 1U ) /**< The length of #HTTP_CONTENT_LENGTH_FIELD. */
 
+/* Constants for the chunked request body of HTTPClient_SendChunked(). */
+#define HTTP_TRANSFER_ENCODING_FIELD          "Transfer-Encoding"                               /**< HTTP header field "Transfer-Encoding". */
+#define HTTP_TRANSFER_ENCODING_FIELD_LEN      ( sizeof( HTTP_TRANSFER_ENCODING_FIELD ) - 1U )   /**< The length of #HTTP_TRANSFER_ENCODING_FIELD. */
+#define HTTP_TRANSFER_ENCODING_CHUNKED        "chunked"                                         /**< HTTP header value "chunked" for the "Transfer-Encoding" header field. */
+#define HTTP_TRANSFER_ENCODING_CHUNKED_LEN    ( sizeof( HTTP_TRANSFER_ENCODING_CHUNKED ) - 1U ) /**< The length of #HTTP_TRANSFER_ENCODING_CHUNKED. */
+#define HTTP_LAST_CHUNK                       "0\r\n\r\n"                                       /**< The zero length chunk and empty trailer that end a chunked body. */
+#define HTTP_LAST_CHUNK_LEN                   ( sizeof( HTTP_LAST_CHUNK ) - 1U )                /**< The length of #HTTP_LAST_CHUNK. */
+
+/**
+ * @brief Maximum length of a chunk header: the size of a chunk of at most
+ * INT32_MAX bytes in hexadecimal, followed by "\r\n".
+ */
+#define HTTP_MAX_CHUNK_HEADER_LEN             ( 8U + HTTP_HEADER_LINE_SEPARATOR_LEN )
+
 /* Constants for header values added based on flags. */
 
 /* MISRA Ref 5.4.1 [Macro identifiers] */
@@ -292,6 +306,9 @@ typedef struct HTTPParsingContext
     size_t lastHeaderFieldLen;        /**< The length of the last header field parsed. */
     const char * pLastHeaderValue;    /**< Holds the last part of the header value parsed. */
     size_t lastHeaderValueLen;        /**< The length of the last value field parsed. */
+    const char * pBodyStreamStart;    /**< Where the first streamed part of the body was received; network reads restart here. */
+    uint8_t stopAtMessageEnd;         /**< Pause the parser at the end of the response, as a pipelined response may follow it. */
+    const char * pMessageEnd;         /**< Where the parser paused after the end of the response. */
 } HTTPParsingContext_t;
 
 /* *INDENT-OFF* */
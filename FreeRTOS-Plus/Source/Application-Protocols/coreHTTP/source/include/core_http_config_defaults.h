@@ -104,6 +104,34 @@
     #define HTTP_SEND_RETRY_TIMEOUT_MS    ( 10U )
 #endif
 
+/**
+ * @brief The longest host name a connection of an #HTTPConnectionPool_t can
+ * be kept open for.
+ *
+ * Each #HTTPPooledConnection_t holds a copy of its host name in an array of
+ * this size.
+ *
+ * <b>Possible values:</b> Any positive integer. <br>
+ * <b>Default value:</b> `64`
+ */
+#ifndef HTTP_CONNECTION_POOL_MAX_HOST_LENGTH
+    #define HTTP_CONNECTION_POOL_MAX_HOST_LENGTH    ( 64U )
+#endif
+
+/**
+ * @brief The maximum number of requests #HTTPConnectionPool_Send sends on a
+ * connection before it waits for their responses.
+ *
+ * Larger values save more round trips, but a server that closes the connection
+ * part way through a pipeline makes more requests be sent again.
+ *
+ * <b>Possible values:</b> Any positive integer. <br>
+ * <b>Default value:</b> `4`
+ */
+#ifndef HTTP_CONNECTION_POOL_MAX_PIPELINE_DEPTH
+    #define HTTP_CONNECTION_POOL_MAX_PIPELINE_DEPTH    ( 4U )
+#endif
+
 /**
  * @brief Macro that is called in the HTTP Client library for logging "Error" level
  * messages.
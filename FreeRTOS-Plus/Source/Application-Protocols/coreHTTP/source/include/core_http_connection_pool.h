@@ -0,0 +1,188 @@
+/*
+ * coreHTTP v3.0.0
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_http_connection_pool.h
+ * @brief User facing functions of the HTTP persistent connection pool.
+ *
+ * The pool keeps HTTP/1.1 keep-alive connections open per host, so that
+ * consecutive requests to the same host, such as the byte ranges of a large
+ * download, do not pay for a new TCP and TLS handshake each. Requests sent
+ * together are pipelined on the connection with #HTTPClient_SendPipelined.
+ */
+
+#ifndef CORE_HTTP_CONNECTION_POOL_H_
+#define CORE_HTTP_CONNECTION_POOL_H_
+
+#include "core_http_client.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * @ingroup http_struct_types
+ * @brief Application functions the pool uses to open and close connections.
+ */
+typedef struct HTTPConnectionInterface
+{
+    /**
+     * @brief Open a connection to a host.
+     *
+     * On success the function fills in the send, receive and network context
+     * of @p pTransport, which the pool then keeps until the connection is
+     * closed.
+     *
+     * @param[in] pContext #HTTPConnectionInterface_t.pContext.
+     * @param[in] pHost The host to connect to. It is not NULL terminated.
+     * @param[in] hostLen The length of @p pHost.
+     * @param[out] pTransport The transport interface of the new connection.
+     *
+     * @return 0 if the connection was opened, any other value otherwise.
+     */
+    int32_t ( * connect )( void * pContext,
+                           const char * pHost,
+                           size_t hostLen,
+                           TransportInterface_t * pTransport );
+
+    /**
+     * @brief Close a connection opened by #HTTPConnectionInterface_t.connect.
+     *
+     * @param[in] pContext #HTTPConnectionInterface_t.pContext.
+     * @param[in] pTransport The transport interface of the connection.
+     */
+    void ( * disconnect )( void * pContext,
+                           TransportInterface_t * pTransport );
+
+    void * pContext; /**< Context passed to the functions above. */
+} HTTPConnectionInterface_t;
+
+/**
+ * @ingroup http_struct_types
+ * @brief A connection kept by an #HTTPConnectionPool_t.
+ *
+ * The application supplies an array of these to #HTTPConnectionPool_Init and
+ * must not modify them while the pool is in use.
+ */
+typedef struct HTTPPooledConnection
+{
+    TransportInterface_t transport;                    /**< Transport interface of the open connection. */
+    char host[ HTTP_CONNECTION_POOL_MAX_HOST_LENGTH ]; /**< The host the connection is open to. */
+    size_t hostLen;                                    /**< The length of the host name. */
+    uint8_t isConnected;                               /**< 1 while the connection is open. */
+    uint32_t lastUsed;                                 /**< When the connection was last used, in pool uses, to close the least recently used one. */
+    uint32_t requestCount;                             /**< Requests answered on the connection since it was opened. */
+} HTTPPooledConnection_t;
+
+/**
+ * @ingroup http_struct_types
+ * @brief A pool of persistent connections.
+ *
+ * The pool is not thread safe; it must be used from one task at a time.
+ */
+typedef struct HTTPConnectionPool
+{
+    HTTPPooledConnection_t * pConnections;          /**< The connections of the pool. */
+    size_t connectionCount;                         /**< The number of connections in pConnections. */
+    HTTPConnectionInterface_t connectionInterface;  /**< Functions to open and close connections. */
+    uint32_t useCount;                              /**< The number of times a connection was taken from the pool. */
+    uint32_t connectCount;                          /**< The number of connections the pool has opened. */
+} HTTPConnectionPool_t;
+
+/**
+ * @brief Initialize a connection pool with no open connections.
+ *
+ * @param[out] pPool The pool to initialize.
+ * @param[in] pConnections Storage for the connections of the pool.
+ * @param[in] connectionCount The number of connections in @p pConnections,
+ * which is the most connections the pool keeps open at once.
+ * @param[in] pConnectionInterface Functions to open and close connections.
+ * The structure is copied into the pool.
+ *
+ * @return #HTTPSuccess if successful, #HTTPInvalidParameter if any parameter
+ * is invalid.
+ */
+/* @[declare_httpconnectionpool_init] */
+HTTPStatus_t HTTPConnectionPool_Init( HTTPConnectionPool_t * pPool,
+                                      HTTPPooledConnection_t * pConnections,
+                                      size_t connectionCount,
+                                      const HTTPConnectionInterface_t * pConnectionInterface );
+/* @[declare_httpconnectionpool_init] */
+
+/**
+ * @brief Send requests to a host over a pooled connection.
+ *
+ * The connection already open to @p pHost is used if there is one. Otherwise a
+ * new connection is opened, closing the least recently used connection first
+ * if the pool is full. The requests are pipelined on the connection at most
+ * #HTTP_CONNECTION_POOL_MAX_PIPELINE_DEPTH at a time with
+ * #HTTPClient_SendPipelined, which also reports the latency of each request.
+ *
+ * The connection is left open for the next requests unless a response carries
+ * a "Connection: close" header or a request fails. When a connection that was
+ * kept open turns out to have been closed by the server, or the server closes
+ * the connection part way through a pipeline, the unanswered requests are sent
+ * again on a new connection. For this reason the request header buffers must
+ * not be shared with the response buffers, and only idempotent requests should
+ * be sent through the pool.
+ *
+ * @param[in] pPool The connection pool.
+ * @param[in] pHost The host the requests are for. It does not need to be NULL
+ * terminated.
+ * @param[in] hostLen The length of @p pHost.
+ * @param[in,out] pRequests The requests to send, in order. The status and
+ * latency of each request are updated.
+ * @param[in] requestCount The number of requests in @p pRequests.
+ *
+ * @return #HTTPSuccess if every request was answered. #HTTPInvalidParameter if
+ * any parameter is invalid. #HTTPNetworkError if a connection could not be
+ * opened. Otherwise, the status of the first request that failed; please see
+ * #HTTPClient_SendPipelined.
+ */
+/* @[declare_httpconnectionpool_send] */
+HTTPStatus_t HTTPConnectionPool_Send( HTTPConnectionPool_t * pPool,
+                                      const char * pHost,
+                                      size_t hostLen,
+                                      HTTPPipelinedRequest_t * pRequests,
+                                      size_t requestCount );
+/* @[declare_httpconnectionpool_send] */
+
+/**
+ * @brief Close every open connection of the pool.
+ *
+ * @param[in] pPool The connection pool.
+ */
+/* @[declare_httpconnectionpool_closeall] */
+void HTTPConnectionPool_CloseAll( HTTPConnectionPool_t * pPool );
+/* @[declare_httpconnectionpool_closeall] */
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* ifndef CORE_HTTP_CONNECTION_POOL_H_ */
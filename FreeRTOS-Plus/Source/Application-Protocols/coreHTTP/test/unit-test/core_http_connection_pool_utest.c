@@ -0,0 +1,662 @@
+/*
+ * coreHTTP v3.0.0
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* The connection pool is tested with the real llhttp parser against a stand-in
+ * HTTP server implemented by the transport interface below. The server answers
+ * range requests for a test object, and can be told to close or drop the
+ * connection to exercise reconnection. */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "unity.h"
+
+#include "core_http_connection_pool.h"
+
+/* The host every test sends its requests to. */
+#define HTTP_TEST_HOST                   "s3.example.com"
+#define HTTP_TEST_HOST_LENGTH            ( sizeof( HTTP_TEST_HOST ) - 1U )
+
+/* A second host for the tests that use more than one host. */
+#define HTTP_TEST_OTHER_HOST             "other.example.com"
+#define HTTP_TEST_OTHER_HOST_LENGTH      ( sizeof( HTTP_TEST_OTHER_HOST ) - 1U )
+
+/* The object the server returns ranges of. */
+#define HTTP_TEST_OBJECT                 "abcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ!@"
+#define HTTP_TEST_OBJECT_LENGTH          ( sizeof( HTTP_TEST_OBJECT ) - 1U )
+
+/* The number of ranges the object is downloaded in. */
+#define HTTP_TEST_RANGE_COUNT            8U
+#define HTTP_TEST_RANGE_LENGTH           ( HTTP_TEST_OBJECT_LENGTH / HTTP_TEST_RANGE_COUNT )
+
+/* The number of connections in the pool. */
+#define HTTP_TEST_POOL_SIZE              2U
+
+#define HTTP_TEST_REQUEST_BUFFER_LENGTH     256U
+#define HTTP_TEST_RESPONSE_BUFFER_LENGTH    256U
+#define HTTP_TEST_SERVER_BUFFER_LENGTH      4096U
+
+/* Mock a NetworkContext structure for the test. Each one is one connection
+ * to the stand-in server. */
+struct NetworkContext
+{
+    bool isOpen;                                         /* The connection was opened and not yet closed. */
+    bool isDropped;                                      /* The server dropped the connection without telling the client. */
+    bool isClosedByServer;                               /* The server sent "Connection: close" and ignores what follows. */
+    char host[ 64 ];                                     /* The host the connection is open to. */
+    char requests[ HTTP_TEST_SERVER_BUFFER_LENGTH ];     /* Request bytes not yet answered. */
+    size_t requestsLen;                                  /* The length of requests. */
+    char responses[ HTTP_TEST_SERVER_BUFFER_LENGTH ];    /* Response bytes not yet read by the client. */
+    size_t responsesLen;                                 /* The length of responses. */
+    size_t requestsAnswered;                             /* The requests answered on this connection. */
+    size_t requestsBeforeFirstRecv;                      /* The requests received before the client first read. */
+    bool hasRecv;                                        /* The client has read from this connection. */
+};
+
+static NetworkContext_t networkContexts[ HTTP_TEST_POOL_SIZE ];
+
+/* Stand-in server configuration set by the tests. */
+static size_t maxRecvLen = 0;       /* The most bytes returned by one read. */
+static size_t closeAfterRequests = 0; /* Answer this many requests per connection then close, 0 for never. */
+static bool failConnect = false;      /* Fail to open connections. */
+static bool dropNewConnections = false; /* Drop connections as soon as they are opened. */
+static size_t connectCalls = 0;
+static size_t disconnectCalls = 0;
+
+static HTTPConnectionPool_t pool;
+static HTTPPooledConnection_t connections[ HTTP_TEST_POOL_SIZE ];
+static HTTPConnectionInterface_t connectionInterface;
+
+static HTTPRequestHeaders_t requestHeaders[ HTTP_TEST_RANGE_COUNT ];
+static uint8_t requestBuffers[ HTTP_TEST_RANGE_COUNT ][ HTTP_TEST_REQUEST_BUFFER_LENGTH ];
+static HTTPResponse_t responses[ HTTP_TEST_RANGE_COUNT ];
+static uint8_t responseBuffers[ HTTP_TEST_RANGE_COUNT ][ HTTP_TEST_RESPONSE_BUFFER_LENGTH ];
+static HTTPPipelinedRequest_t requests[ HTTP_TEST_RANGE_COUNT ];
+
+/* ============================ Helper Functions ============================== */
+
+/* A mocked timer query function that increments on every call. */
+static uint32_t getTestTime( void )
+{
+    static uint32_t entryTime = 0;
+
+    return entryTime++;
+}
+
+/* Answer every complete request the server has received. */
+static void serverProcessRequests( NetworkContext_t * pContext )
+{
+    char * pEnd = NULL;
+    char * pRange = NULL;
+    size_t requestLen = 0;
+    unsigned long first = 0, last = 0;
+    bool isHead = false, shouldClose = false;
+    int written = 0;
+
+    while( ( pContext->isClosedByServer == false ) &&
+           ( ( pEnd = strstr( pContext->requests, "\r\n\r\n" ) ) != NULL ) )
+    {
+        requestLen = ( size_t ) ( pEnd - pContext->requests ) + 4U;
+        isHead = ( strncmp( pContext->requests, "HEAD ", 5 ) == 0 );
+        pRange = strstr( pContext->requests, "Range: bytes=" );
+        first = 0;
+        last = HTTP_TEST_OBJECT_LENGTH - 1U;
+
+        if( ( pRange != NULL ) && ( pRange < pEnd ) )
+        {
+            TEST_ASSERT_EQUAL( 2, sscanf( pRange, "Range: bytes=%lu-%lu", &first, &last ) );
+        }
+
+        pContext->requestsAnswered++;
+        shouldClose = ( closeAfterRequests != 0U ) &&
+                      ( pContext->requestsAnswered == closeAfterRequests );
+
+        written = snprintf( &pContext->responses[ pContext->responsesLen ],
+                            sizeof( pContext->responses ) - pContext->responsesLen,
+                            "HTTP/1.1 206 Partial Content\r\n"
+                            "Content-Length: %lu\r\n"
+                            "Content-Range: bytes %lu-%lu/%lu\r\n"
+                            "%s"
+                            "\r\n",
+                            last - first + 1U,
+                            first,
+                            last,
+                            ( unsigned long ) HTTP_TEST_OBJECT_LENGTH,
+                            shouldClose ? "Connection: close\r\n" : "" );
+        TEST_ASSERT_GREATER_THAN( 0, written );
+        pContext->responsesLen += ( size_t ) written;
+
+        if( isHead == false )
+        {
+            memcpy( &pContext->responses[ pContext->responsesLen ],
+                    &HTTP_TEST_OBJECT[ first ],
+                    last - first + 1U );
+            pContext->responsesLen += last - first + 1U;
+        }
+
+        memmove( pContext->requests,
+                 &pContext->requests[ requestLen ],
+                 pContext->requestsLen - requestLen + 1U );
+        pContext->requestsLen -= requestLen;
+
+        /* The server does not read any request after it closes. */
+        pContext->isClosedByServer = shouldClose;
+    }
+}
+
+/* Stand-in server transport send interface. */
+static int32_t transportSend( NetworkContext_t * pNetworkContext,
+                              const void * pBuffer,
+                              size_t bytesToWrite )
+{
+    int32_t returnStatus = ( int32_t ) bytesToWrite;
+
+    TEST_ASSERT_TRUE( pNetworkContext->isOpen );
+
+    if( pNetworkContext->isDropped == true )
+    {
+        returnStatus = -1;
+    }
+    else if( pNetworkContext->isClosedByServer == true )
+    {
+        /* The data is accepted by the network stack but never answered. */
+    }
+    else
+    {
+        TEST_ASSERT_LESS_THAN( sizeof( pNetworkContext->requests ) - pNetworkContext->requestsLen,
+                               bytesToWrite );
+        memcpy( &pNetworkContext->requests[ pNetworkContext->requestsLen ], pBuffer, bytesToWrite );
+        pNetworkContext->requestsLen += bytesToWrite;
+        pNetworkContext->requests[ pNetworkContext->requestsLen ] = '\0';
+        serverProcessRequests( pNetworkContext );
+    }
+
+    return returnStatus;
+}
+
+/* Stand-in server transport receive interface. */
+static int32_t transportRecv( NetworkContext_t * pNetworkContext,
+                              void * pBuffer,
+                              size_t bytesToRead )
+{
+    size_t bytesToCopy = pNetworkContext->responsesLen;
+
+    TEST_ASSERT_TRUE( pNetworkContext->isOpen );
+
+    if( pNetworkContext->hasRecv == false )
+    {
+        pNetworkContext->hasRecv = true;
+        pNetworkContext->requestsBeforeFirstRecv = pNetworkContext->requestsAnswered;
+    }
+
+    if( pNetworkContext->isDropped == true )
+    {
+        return -1;
+    }
+
+    if( bytesToCopy > bytesToRead )
+    {
+        bytesToCopy = bytesToRead;
+    }
+
+    if( ( maxRecvLen != 0U ) && ( bytesToCopy > maxRecvLen ) )
+    {
+        bytesToCopy = maxRecvLen;
+    }
+
+    memcpy( pBuffer, pNetworkContext->responses, bytesToCopy );
+    memmove( pNetworkContext->responses,
+             &pNetworkContext->responses[ bytesToCopy ],
+             pNetworkContext->responsesLen - bytesToCopy );
+    pNetworkContext->responsesLen -= bytesToCopy;
+
+    return ( int32_t ) bytesToCopy;
+}
+
+/* Connect to the stand-in server on the first closed network context. */
+static int32_t connectToServer( void * pContext,
+                                const char * pHost,
+                                size_t hostLen,
+                                TransportInterface_t * pTransport )
+{
+    NetworkContext_t * pNetworkContext = NULL;
+    size_t i = 0;
+
+    ( void ) pContext;
+
+    connectCalls++;
+
+    if( failConnect == true )
+    {
+        return -1;
+    }
+
+    for( i = 0; ( i < HTTP_TEST_POOL_SIZE ) && ( pNetworkContext == NULL ); i++ )
+    {
+        if( networkContexts[ i ].isOpen == false )
+        {
+            pNetworkContext = &networkContexts[ i ];
+        }
+    }
+
+    TEST_ASSERT_NOT_NULL( pNetworkContext );
+    TEST_ASSERT_LESS_THAN( sizeof( pNetworkContext->host ), hostLen );
+
+    memset( pNetworkContext, 0, sizeof( NetworkContext_t ) );
+    pNetworkContext->isOpen = true;
+    pNetworkContext->isDropped = dropNewConnections;
+    memcpy( pNetworkContext->host, pHost, hostLen );
+
+    pTransport->send = transportSend;
+    pTransport->recv = transportRecv;
+    pTransport->pNetworkContext = pNetworkContext;
+
+    return 0;
+}
+
+/* Close a connection to the stand-in server. */
+static void disconnectFromServer( void * pContext,
+                                  TransportInterface_t * pTransport )
+{
+    ( void ) pContext;
+
+    TEST_ASSERT_TRUE( pTransport->pNetworkContext->isOpen );
+    pTransport->pNetworkContext->isOpen = false;
+    disconnectCalls++;
+}
+
+/* Write a range request for range number index of the test object. */
+static void setUpRangeRequest( size_t index,
+                               const char * pHost,
+                               size_t hostLen )
+{
+    HTTPRequestInfo_t requestInfo = { 0 };
+
+    requestInfo.pMethod = HTTP_METHOD_GET;
+    requestInfo.methodLen = sizeof( HTTP_METHOD_GET ) - 1U;
+    requestInfo.pPath = "/object";
+    requestInfo.pathLen = sizeof( "/object" ) - 1U;
+    requestInfo.pHost = pHost;
+    requestInfo.hostLen = hostLen;
+    requestInfo.reqFlags = HTTP_REQUEST_KEEP_ALIVE_FLAG;
+
+    requestHeaders[ index ].pBuffer = requestBuffers[ index ];
+    requestHeaders[ index ].bufferLen = HTTP_TEST_REQUEST_BUFFER_LENGTH;
+    TEST_ASSERT_EQUAL( HTTPSuccess,
+                       HTTPClient_InitializeRequestHeaders( &requestHeaders[ index ], &requestInfo ) );
+    TEST_ASSERT_EQUAL( HTTPSuccess,
+                       HTTPClient_AddRangeHeader( &requestHeaders[ index ],
+                                                  ( int32_t ) ( index * HTTP_TEST_RANGE_LENGTH ),
+                                                  ( int32_t ) ( ( ( index + 1U ) * HTTP_TEST_RANGE_LENGTH ) - 1U ) ) );
+
+    memset( &responses[ index ], 0, sizeof( HTTPResponse_t ) );
+    responses[ index ].pBuffer = responseBuffers[ index ];
+    responses[ index ].bufferLen = HTTP_TEST_RESPONSE_BUFFER_LENGTH;
+    responses[ index ].getTime = getTestTime;
+
+    memset( &requests[ index ], 0, sizeof( HTTPPipelinedRequest_t ) );
+    requests[ index ].pRequestHeaders = &requestHeaders[ index ];
+    requests[ index ].pResponse = &responses[ index ];
+}
+
+/* Check the response to range number index of the test object. */
+static void verifyRangeResponse( size_t index )
+{
+    TEST_ASSERT_EQUAL( HTTPSuccess, requests[ index ].status );
+    TEST_ASSERT_EQUAL( 206, responses[ index ].statusCode );
+    TEST_ASSERT_EQUAL( HTTP_TEST_RANGE_LENGTH, responses[ index ].bodyLen );
+    TEST_ASSERT_EQUAL_MEMORY( &HTTP_TEST_OBJECT[ index * HTTP_TEST_RANGE_LENGTH ],
+                              responses[ index ].pBody,
+                              HTTP_TEST_RANGE_LENGTH );
+    TEST_ASSERT_GREATER_THAN( 0, requests[ index ].latencyMs );
+}
+
+/* ============================ UNITY FIXTURES ============================== */
+
+/* Called before each test case. */
+void setUp( void )
+{
+    size_t i = 0;
+
+    memset( networkContexts, 0, sizeof( networkContexts ) );
+    maxRecvLen = 0;
+    closeAfterRequests = 0;
+    failConnect = false;
+    dropNewConnections = false;
+    connectCalls = 0;
+    disconnectCalls = 0;
+
+    connectionInterface.connect = connectToServer;
+    connectionInterface.disconnect = disconnectFromServer;
+    connectionInterface.pContext = NULL;
+    TEST_ASSERT_EQUAL( HTTPSuccess,
+                       HTTPConnectionPool_Init( &pool,
+                                                connections,
+                                                HTTP_TEST_POOL_SIZE,
+                                                &connectionInterface ) );
+
+    for( i = 0; i < HTTP_TEST_RANGE_COUNT; i++ )
+    {
+        setUpRangeRequest( i, HTTP_TEST_HOST, HTTP_TEST_HOST_LENGTH );
+    }
+}
+
+/* Called after each test case. */
+void tearDown( void )
+{
+    HTTPConnectionPool_CloseAll( &pool );
+}
+
+/* ==================== Testing HTTPConnectionPool_Send ===================== */
+
+/* Test downloading an object in ranges that are pipelined on one connection.
+ * The server's responses are read as they arrive, so each read returns the
+ * end of one response together with the start of the next. */
+void test_HTTPConnectionPool_Send_pipelined_ranges( void )
+{
+    HTTPStatus_t returnStatus = HTTPSuccess;
+    size_t i = 0;
+
+    returnStatus = HTTPConnectionPool_Send( &pool,
+                                            HTTP_TEST_HOST,
+                                            HTTP_TEST_HOST_LENGTH,
+                                            requests,
+                                            HTTP_TEST_RANGE_COUNT );
+
+    TEST_ASSERT_EQUAL( HTTPSuccess, returnStatus );
+
+    for( i = 0; i < HTTP_TEST_RANGE_COUNT; i++ )
+    {
+        verifyRangeResponse( i );
+    }
+
+    /* One handshake, with a full pipeline sent before the first read. */
+    TEST_ASSERT_EQUAL( 1, connectCalls );
+    TEST_ASSERT_EQUAL( 1, pool.connectCount );
+    TEST_ASSERT_EQUAL( HTTP_CONNECTION_POOL_MAX_PIPELINE_DEPTH,
+                       networkContexts[ 0 ].requestsBeforeFirstRecv );
+    TEST_ASSERT_EQUAL( HTTP_TEST_RANGE_COUNT, connections[ 0 ].requestCount );
+    TEST_ASSERT_TRUE( networkContexts[ 0 ].isOpen );
+}
+
+/*-----------------------------------------------------------*/
+
+/* Test pipelined responses that arrive a few bytes at a time. */
+void test_HTTPConnectionPool_Send_pipelined_ranges_small_reads( void )
+{
+    HTTPStatus_t returnStatus = HTTPSuccess;
+    size_t i = 0;
+
+    maxRecvLen = 7;
+
+    returnStatus = HTTPConnectionPool_Send( &pool,
+                                            HTTP_TEST_HOST,
+                                            HTTP_TEST_HOST_LENGTH,
+                                            requests,
+                                            HTTP_TEST_RANGE_COUNT );
+
+    TEST_ASSERT_EQUAL( HTTPSuccess, returnStatus );
+
+    for( i = 0; i < HTTP_TEST_RANGE_COUNT; i++ )
+    {
+        verifyRangeResponse( i );
+    }
+
+    TEST_ASSERT_EQUAL( 1, connectCalls );
+}
+
+/*-----------------------------------------------------------*/
+
+/* Test that a second download from the same host reuses the connection. */
+void test_HTTPConnectionPool_Send_reuses_connection( void )
+{
+    HTTPStatus_t returnStatus = HTTPSuccess;
+
+    returnStatus = HTTPConnectionPool_Send( &pool,
+                                            HTTP_TEST_HOST,
+                                            HTTP_TEST_HOST_LENGTH,
+                                            &requests[ 0 ],
+                                            1 );
+    TEST_ASSERT_EQUAL( HTTPSuccess, returnStatus );
+    verifyRangeResponse( 0 );
+
+    returnStatus = HTTPConnectionPool_Send( &pool,
+                                            HTTP_TEST_HOST,
+                                            HTTP_TEST_HOST_LENGTH,
+                                            &requests[ 1 ],
+                                            1 );
+    TEST_ASSERT_EQUAL( HTTPSuccess, returnStatus );
+    verifyRangeResponse( 1 );
+
+    TEST_ASSERT_EQUAL( 1, connectCalls );
+    TEST_ASSERT_EQUAL( 0, disconnectCalls );
+    TEST_ASSERT_EQUAL( 2, connections[ 0 ].requestCount );
+}
+
+/*-----------------------------------------------------------*/
+
+/* Test a server that closes the connection part way through a pipeline. The
+ * unanswered requests are sent again on a new connection. */
+void test_HTTPConnectionPool_Send_server_closes_connection( void )
+{
+    HTTPStatus_t returnStatus = HTTPSuccess;
+    size_t i = 0;
+
+    closeAfterRequests = 3;
+
+    returnStatus = HTTPConnectionPool_Send( &pool,
+                                            HTTP_TEST_HOST,
+                                            HTTP_TEST_HOST_LENGTH,
+                                            requests,
+                                            HTTP_TEST_RANGE_COUNT );
+
+    TEST_ASSERT_EQUAL( HTTPSuccess, returnStatus );
+
+    for( i = 0; i < HTTP_TEST_RANGE_COUNT; i++ )
+    {
+        verifyRangeResponse( i );
+    }
+
+    TEST_ASSERT_EQUAL( 3, connectCalls );
+    TEST_ASSERT_EQUAL( 2, disconnectCalls );
+}
+
+/*-----------------------------------------------------------*/
+
+/* Test a kept open connection that the server dropped while it was idle. */
+void test_HTTPConnectionPool_Send_stale_connection( void )
+{
+    HTTPStatus_t returnStatus = HTTPSuccess;
+
+    returnStatus = HTTPConnectionPool_Send( &pool,
+                                            HTTP_TEST_HOST,
+                                            HTTP_TEST_HOST_LENGTH,
+                                            &requests[ 0 ],
+                                            1 );
+    TEST_ASSERT_EQUAL( HTTPSuccess, returnStatus );
+
+    networkContexts[ 0 ].isDropped = true;
+
+    returnStatus = HTTPConnectionPool_Send( &pool,
+                                            HTTP_TEST_HOST,
+                                            HTTP_TEST_HOST_LENGTH,
+                                            &requests[ 1 ],
+                                            1 );
+    TEST_ASSERT_EQUAL( HTTPSuccess, returnStatus );
+    verifyRangeResponse( 1 );
+
+    TEST_ASSERT_EQUAL( 2, connectCalls );
+    TEST_ASSERT_EQUAL( 1, disconnectCalls );
+}
+
+/*-----------------------------------------------------------*/
+
+/* Test that requests are not sent again when a new connection fails. */
+void test_HTTPConnectionPool_Send_new_connection_fails( void )
+{
+    HTTPStatus_t returnStatus = HTTPSuccess;
+
+    dropNewConnections = true;
+
+    returnStatus = HTTPConnectionPool_Send( &pool,
+                                            HTTP_TEST_HOST,
+                                            HTTP_TEST_HOST_LENGTH,
+                                            requests,
+                                            2 );
+    TEST_ASSERT_EQUAL( HTTPNetworkError, returnStatus );
+    TEST_ASSERT_EQUAL( HTTPNetworkError, requests[ 0 ].status );
+    TEST_ASSERT_EQUAL( HTTPNoResponse, requests[ 1 ].status );
+    TEST_ASSERT_EQUAL( 1, connectCalls );
+    TEST_ASSERT_EQUAL( 1, disconnectCalls );
+
+    failConnect = true;
+
+    returnStatus = HTTPConnectionPool_Send( &pool,
+                                            HTTP_TEST_HOST,
+                                            HTTP_TEST_HOST_LENGTH,
+                                            requests,
+                                            1 );
+    TEST_ASSERT_EQUAL( HTTPNetworkError, returnStatus );
+    TEST_ASSERT_EQUAL( 2, connectCalls );
+}
+
+/*-----------------------------------------------------------*/
+
+/* Test that the least recently used connection is closed for a new host when
+ * the pool is full. */
+void test_HTTPConnectionPool_Send_closes_least_recently_used( void )
+{
+    HTTPStatus_t returnStatus = HTTPSuccess;
+
+    setUpRangeRequest( 1, HTTP_TEST_OTHER_HOST, HTTP_TEST_OTHER_HOST_LENGTH );
+    setUpRangeRequest( 2, "third.example.com", sizeof( "third.example.com" ) - 1U );
+
+    returnStatus = HTTPConnectionPool_Send( &pool, HTTP_TEST_HOST, HTTP_TEST_HOST_LENGTH, &requests[ 0 ], 1 );
+    TEST_ASSERT_EQUAL( HTTPSuccess, returnStatus );
+    returnStatus = HTTPConnectionPool_Send( &pool, HTTP_TEST_OTHER_HOST, HTTP_TEST_OTHER_HOST_LENGTH, &requests[ 1 ], 1 );
+    TEST_ASSERT_EQUAL( HTTPSuccess, returnStatus );
+
+    /* Use the first host again so that the second is the least recently used. */
+    setUpRangeRequest( 3, HTTP_TEST_HOST, HTTP_TEST_HOST_LENGTH );
+    returnStatus = HTTPConnectionPool_Send( &pool, HTTP_TEST_HOST, HTTP_TEST_HOST_LENGTH, &requests[ 3 ], 1 );
+    TEST_ASSERT_EQUAL( HTTPSuccess, returnStatus );
+    TEST_ASSERT_EQUAL( 2, connectCalls );
+
+    returnStatus = HTTPConnectionPool_Send( &pool, "third.example.com", sizeof( "third.example.com" ) - 1U, &requests[ 2 ], 1 );
+    TEST_ASSERT_EQUAL( HTTPSuccess, returnStatus );
+    TEST_ASSERT_EQUAL( 3, connectCalls );
+    TEST_ASSERT_EQUAL( 1, disconnectCalls );
+    TEST_ASSERT_TRUE( networkContexts[ 0 ].isOpen );
+    TEST_ASSERT_EQUAL_STRING( "third.example.com", networkContexts[ 1 ].host );
+}
+
+/*-----------------------------------------------------------*/
+
+/* Test the invalid parameters of the connection pool functions. */
+void test_HTTPConnectionPool_invalid_parameters( void )
+{
+    HTTPConnectionPool_t otherPool;
+    HTTPConnectionInterface_t badInterface = { NULL, disconnectFromServer, NULL };
+
+    TEST_ASSERT_EQUAL( HTTPInvalidParameter,
+                       HTTPConnectionPool_Init( NULL, connections, HTTP_TEST_POOL_SIZE, &connectionInterface ) );
+    TEST_ASSERT_EQUAL( HTTPInvalidParameter,
+                       HTTPConnectionPool_Init( &otherPool, NULL, HTTP_TEST_POOL_SIZE, &connectionInterface ) );
+    TEST_ASSERT_EQUAL( HTTPInvalidParameter,
+                       HTTPConnectionPool_Init( &otherPool, connections, 0, &connectionInterface ) );
+    TEST_ASSERT_EQUAL( HTTPInvalidParameter,
+                       HTTPConnectionPool_Init( &otherPool, connections, HTTP_TEST_POOL_SIZE, NULL ) );
+    TEST_ASSERT_EQUAL( HTTPInvalidParameter,
+                       HTTPConnectionPool_Init( &otherPool, connections, HTTP_TEST_POOL_SIZE, &badInterface ) );
+
+    TEST_ASSERT_EQUAL( HTTPInvalidParameter,
+                       HTTPConnectionPool_Send( NULL, HTTP_TEST_HOST, HTTP_TEST_HOST_LENGTH, requests, 1 ) );
+    TEST_ASSERT_EQUAL( HTTPInvalidParameter,
+                       HTTPConnectionPool_Send( &pool, NULL, HTTP_TEST_HOST_LENGTH, requests, 1 ) );
+    TEST_ASSERT_EQUAL( HTTPInvalidParameter,
+                       HTTPConnectionPool_Send( &pool, HTTP_TEST_HOST, HTTP_CONNECTION_POOL_MAX_HOST_LENGTH + 1U, requests, 1 ) );
+    TEST_ASSERT_EQUAL( HTTPInvalidParameter,
+                       HTTPConnectionPool_Send( &pool, HTTP_TEST_HOST, HTTP_TEST_HOST_LENGTH, NULL, 1 ) );
+
+    /* An invalid request is rejected before anything is sent. */
+    requests[ 1 ].pResponse = NULL;
+    TEST_ASSERT_EQUAL( HTTPInvalidParameter,
+                       HTTPConnectionPool_Send( &pool, HTTP_TEST_HOST, HTTP_TEST_HOST_LENGTH, requests, 2 ) );
+    TEST_ASSERT_EQUAL( 0, networkContexts[ 0 ].requestsAnswered );
+}
+
+/* ==================== Testing HTTPClient_SendPipelined ==================== */
+
+/* Test a pipeline that mixes HEAD and GET requests, whose responses all arrive
+ * in one read. */
+void test_HTTPClient_SendPipelined_head_and_get( void )
+{
+    HTTPStatus_t returnStatus = HTTPSuccess;
+    TransportInterface_t transport = { 0 };
+
+    TEST_ASSERT_EQUAL( 0, connectToServer( NULL, HTTP_TEST_HOST, HTTP_TEST_HOST_LENGTH, &transport ) );
+
+    /* Turn the second request into a HEAD request. */
+    memmove( &requestBuffers[ 1 ][ 4 ], &requestBuffers[ 1 ][ 3 ], requestHeaders[ 1 ].headersLen - 3U );
+    memcpy( requestBuffers[ 1 ], "HEAD", 4 );
+    requestHeaders[ 1 ].headersLen++;
+
+    returnStatus = HTTPClient_SendPipelined( &transport, requests, 3 );
+
+    TEST_ASSERT_EQUAL( HTTPSuccess, returnStatus );
+    verifyRangeResponse( 0 );
+    TEST_ASSERT_EQUAL( HTTPSuccess, requests[ 1 ].status );
+    TEST_ASSERT_EQUAL( HTTP_TEST_RANGE_LENGTH, responses[ 1 ].contentLength );
+    TEST_ASSERT_EQUAL( 0, responses[ 1 ].bodyLen );
+    verifyRangeResponse( 2 );
+    TEST_ASSERT_EQUAL( 3, networkContexts[ 0 ].requestsBeforeFirstRecv );
+
+    disconnectFromServer( NULL, &transport );
+}
+
+/*-----------------------------------------------------------*/
+
+/* Test a server that closes the connection part way through a pipeline. */
+void test_HTTPClient_SendPipelined_connection_close( void )
+{
+    HTTPStatus_t returnStatus = HTTPSuccess;
+    TransportInterface_t transport = { 0 };
+
+    TEST_ASSERT_EQUAL( 0, connectToServer( NULL, HTTP_TEST_HOST, HTTP_TEST_HOST_LENGTH, &transport ) );
+    closeAfterRequests = 2;
+
+    returnStatus = HTTPClient_SendPipelined( &transport, requests, 4 );
+
+    TEST_ASSERT_EQUAL( HTTPNoResponse, returnStatus );
+    verifyRangeResponse( 0 );
+    verifyRangeResponse( 1 );
+    TEST_ASSERT_BITS_HIGH( HTTP_RESPONSE_CONNECTION_CLOSE_FLAG, responses[ 1 ].respFlags );
+    TEST_ASSERT_EQUAL( HTTPNoResponse, requests[ 2 ].status );
+    TEST_ASSERT_EQUAL( HTTPNoResponse, requests[ 3 ].status );
+    TEST_ASSERT_EQUAL( 0, requests[ 3 ].latencyMs );
+
+    disconnectFromServer( NULL, &transport );
+}
@@ -171,6 +171,21 @@
 /* Test buffer to share among the test. */
 #define HTTP_TEST_BUFFER_LENGTH                 1024
 
+/* The largest part of the request body the test body source hands out at a
+ * time, so that HTTPClient_SendChunked() sends several chunks. */
+#define HTTP_TEST_REQUEST_CHUNK_LENGTH          10U
+
+/* The chunked request body HTTPClient_SendChunked() is expected to send for
+ * HTTP_TEST_REQUEST_PUT_BODY. */
+#define HTTP_TEST_REQUEST_PUT_BODY_CHUNKED   \
+    "a\r\nabcdefghij\r\n"                   \
+    "a\r\nklmnopqrst\r\n"                   \
+    "6\r\nuvwxyz\r\n"                       \
+    "0\r\n\r\n"
+#define HTTP_TEST_REQUEST_PUT_BODY_CHUNKED_LENGTH    ( sizeof( HTTP_TEST_REQUEST_PUT_BODY_CHUNKED ) - 1U )
+#define HTTP_TEST_REQUEST_TRANSFER_ENCODING_EXPECTED \
+    HTTP_TEST_TRANSFER_ENCODING_CHUNKED_HEADER_LINE HTTP_HEADER_LINE_SEPARATOR
+
 /* Mock a NetworkContext structure for the test. */
 struct NetworkContext
 {
@@ -234,6 +249,23 @@ static TransportInterface_t transportInterface = { 0 };
 static HTTPRequestHeaders_t requestHeaders = { 0 };
 /* Header parsing callback shared among the tests. */
 static HTTPClient_ResponseHeaderParsingCallback_t headerParsingCallback = { 0 };
+/* Body callback shared among the tests that stream the response body. */
+static HTTPClient_ResponseBodyCallback_t bodyCallback = { 0 };
+
+/* The response body passed to onBodyCallback(). */
+static uint8_t streamedBody[ HTTP_TEST_BUFFER_LENGTH ] = { 0 };
+/* The length of the response body passed to onBodyCallback(). */
+static size_t streamedBodyLen = 0;
+
+/* The request body readBodyCallback() hands out. */
+static const uint8_t * pRequestBody = NULL;
+/* The length of the request body left for readBodyCallback() to hand out. */
+static size_t requestBodyLen = 0;
+
+/* The data sent by transportSendCapture(). */
+static uint8_t sentData[ HTTP_TEST_BUFFER_LENGTH ] = { 0 };
+/* The length of the data sent by transportSendCapture(). */
+static size_t sentDataLen = 0;
 
 /* A mocked timer query function that increments on every call. */
 static uint32_t getTestTime( void )
@@ -311,6 +343,74 @@ static int32_t transportSendSuccess( NetworkContext_t * pNetworkContext,
     return retVal;
 }
 
+/* Application transport send interface that records everything sent. */
+static int32_t transportSendCapture( NetworkContext_t * pNetworkContext,
+                                     const void * pBuffer,
+                                     size_t bytesToWrite )
+{
+    ( void ) pNetworkContext;
+
+    TEST_ASSERT_LESS_OR_EQUAL( sizeof( sentData ) - sentDataLen, bytesToWrite );
+    memcpy( &sentData[ sentDataLen ], pBuffer, bytesToWrite );
+    sentDataLen += bytesToWrite;
+
+    return ( int32_t ) bytesToWrite;
+}
+
+/* Application callback for intercepting the body of a response as it is
+ * parsed. */
+static void onBodyCallback( void * pContext,
+                            const uint8_t * pBody,
+                            size_t bodyLen,
+                            uint16_t statusCode )
+{
+    ( void ) pContext;
+
+    TEST_ASSERT_EQUAL( HTTP_STATUS_CODE_OK, statusCode );
+    TEST_ASSERT_LESS_OR_EQUAL( sizeof( streamedBody ) - streamedBodyLen, bodyLen );
+    memcpy( &streamedBody[ streamedBodyLen ], pBody, bodyLen );
+    streamedBodyLen += bodyLen;
+}
+
+/* Application callback that hands out the request body at most
+ * HTTP_TEST_REQUEST_CHUNK_LENGTH bytes at a time. */
+static int32_t readBodyCallback( void * pContext,
+                                 uint8_t * pBuffer,
+                                 size_t bufferLen )
+{
+    size_t bytesToCopy = requestBodyLen;
+
+    ( void ) pContext;
+
+    if( bytesToCopy > HTTP_TEST_REQUEST_CHUNK_LENGTH )
+    {
+        bytesToCopy = HTTP_TEST_REQUEST_CHUNK_LENGTH;
+    }
+
+    if( bytesToCopy > bufferLen )
+    {
+        bytesToCopy = bufferLen;
+    }
+
+    memcpy( pBuffer, pRequestBody, bytesToCopy );
+    pRequestBody += bytesToCopy;
+    requestBodyLen -= bytesToCopy;
+
+    return ( int32_t ) bytesToCopy;
+}
+
+/* Application callback that fails to read the request body. */
+static int32_t readBodyCallbackError( void * pContext,
+                                      uint8_t * pBuffer,
+                                      size_t bufferLen )
+{
+    ( void ) pContext;
+    ( void ) pBuffer;
+    ( void ) bufferLen;
+
+    return -1;
+}
+
 /* Application transport send interface that returns a network error depending
 * on the call count. Set sendErrorCall to 0 to return an error on the
 * first call. Set sendErrorCall to 1 to return an error on the second call. */
@@ -786,6 +886,12 @@ void setUp( void )
     response.pBuffer = httpBuffer;
     response.bufferLen = sizeof( httpBuffer );
     response.pHeaderParsingCallback = &headerParsingCallback;
+    bodyCallback.onBodyCallback = onBodyCallback;
+    bodyCallback.pContext = NULL;
+    streamedBodyLen = 0;
+    pRequestBody = ( const uint8_t * ) HTTP_TEST_REQUEST_PUT_BODY;
+    requestBodyLen = HTTP_TEST_REQUEST_PUT_BODY_LENGTH;
+    sentDataLen = 0;
 
     /* Ignore third-party init functions that return void. */
     llhttp_init_Ignore();
@@ -1728,3 +1834,169 @@ void test_HTTPClient_Send_parsing_errors( void )
                                     0 );
     TEST_ASSERT_EQUAL( HTTPParserInternalError, returnStatus );
 }
+
+/*-----------------------------------------------------------*/
+
+/* Test streaming the body of a response to the body callback when the whole
+ * response does not fit in the response buffer. The first network read fills
+ * the buffer up to the middle of the body; the rest of the body is received
+ * into the space of the body already streamed. */
+void test_HTTPClient_Send_stream_body_larger_than_buffer( void )
+{
+    HTTPStatus_t returnStatus = HTTPSuccess;
+
+    llhttp_execute_Stub( llhttp_execute_partial_body );
+
+    memcpy( requestHeaders.pBuffer,
+            HTTP_TEST_REQUEST_GET_HEADERS,
+            HTTP_TEST_REQUEST_GET_HEADERS_LENGTH );
+    requestHeaders.headersLen = HTTP_TEST_REQUEST_GET_HEADERS_LENGTH;
+    pNetworkData = ( uint8_t * ) HTTP_TEST_RESPONSE_GET;
+    networkDataLen = HTTP_TEST_RESPONSE_GET_LENGTH;
+    firstPartBytes = HTTP_TEST_RESPONSE_GET_PARTIAL_BODY_LENGTH;
+    response.bufferLen = HTTP_TEST_RESPONSE_GET_PARTIAL_BODY_LENGTH;
+    response.pBodyCallback = &bodyCallback;
+
+    returnStatus = HTTPClient_Send( &transportInterface,
+                                    &requestHeaders,
+                                    NULL,
+                                    0,
+                                    &response,
+                                    0 );
+
+    TEST_ASSERT_EQUAL( HTTPSuccess, returnStatus );
+    TEST_ASSERT_EQUAL( 2, recvCurrentCall );
+    TEST_ASSERT_EQUAL( response.pBuffer + ( sizeof( HTTP_STATUS_LINE_OK ) - 1 ), response.pHeaders );
+    TEST_ASSERT_EQUAL( HTTP_TEST_RESPONSE_GET_HEADERS_LENGTH - HTTP_HEADER_END_INDICATOR_LEN,
+                       response.headersLen );
+    TEST_ASSERT_EQUAL( NULL, response.pBody );
+    TEST_ASSERT_EQUAL( HTTP_TEST_RESPONSE_GET_BODY_LENGTH, response.bodyLen );
+    TEST_ASSERT_EQUAL( HTTP_TEST_RESPONSE_GET_BODY_LENGTH, streamedBodyLen );
+    TEST_ASSERT_EQUAL_MEMORY( HTTP_TEST_RESPONSE_GET + HTTP_TEST_RESPONSE_HEAD_LENGTH,
+                              streamedBody,
+                              HTTP_TEST_RESPONSE_GET_BODY_LENGTH );
+    TEST_ASSERT_EQUAL( HTTP_STATUS_CODE_OK, response.statusCode );
+    TEST_ASSERT_EQUAL( HTTP_TEST_RESPONSE_GET_HEADER_COUNT, response.headerCount );
+}
+
+/*-----------------------------------------------------------*/
+
+/* Test that a body callback without a function is rejected. */
+void test_HTTPClient_Send_null_body_callback_function( void )
+{
+    HTTPStatus_t returnStatus = HTTPSuccess;
+
+    bodyCallback.onBodyCallback = NULL;
+    response.pBodyCallback = &bodyCallback;
+
+    returnStatus = HTTPClient_Send( &transportInterface,
+                                    &requestHeaders,
+                                    NULL,
+                                    0,
+                                    &response,
+                                    0 );
+
+    TEST_ASSERT_EQUAL( HTTPInvalidParameter, returnStatus );
+}
+
+/* ==================== Testing HTTPClient_SendChunked ====================== */
+
+/* Test sending a request body in chunks and parsing the response. */
+void test_HTTPClient_SendChunked_PUT_request( void )
+{
+    HTTPStatus_t returnStatus = HTTPSuccess;
+    HTTPClient_RequestBodySource_t bodySource = { readBodyCallback, NULL };
+    size_t headersLen = 0;
+
+    llhttp_execute_Stub( llhttp_execute_whole_response );
+
+    transportInterface.send = transportSendCapture;
+    memcpy( requestHeaders.pBuffer,
+            HTTP_TEST_REQUEST_PUT_HEADERS,
+            HTTP_TEST_REQUEST_PUT_HEADERS_LENGTH );
+    requestHeaders.headersLen = HTTP_TEST_REQUEST_PUT_HEADERS_LENGTH;
+    pNetworkData = ( uint8_t * ) HTTP_TEST_RESPONSE_PUT;
+    networkDataLen = HTTP_TEST_RESPONSE_PUT_LENGTH;
+    firstPartBytes = HTTP_TEST_RESPONSE_PUT_LENGTH;
+
+    returnStatus = HTTPClient_SendChunked( &transportInterface,
+                                           &requestHeaders,
+                                           &bodySource,
+                                           &response );
+
+    TEST_ASSERT_EQUAL( HTTPSuccess, returnStatus );
+
+    /* The request headers end with the Transfer-Encoding header, followed
+     * by each chunk of the body and the last chunk. */
+    headersLen = sentDataLen - HTTP_TEST_REQUEST_PUT_BODY_CHUNKED_LENGTH;
+    TEST_ASSERT_EQUAL( HTTP_TEST_REQUEST_PUT_HEADERS_LENGTH - HTTP_HEADER_LINE_SEPARATOR_LEN +
+                       sizeof( HTTP_TEST_REQUEST_TRANSFER_ENCODING_EXPECTED ) - 1U,
+                       headersLen );
+    TEST_ASSERT_EQUAL_MEMORY( HTTP_TEST_REQUEST_TRANSFER_ENCODING_EXPECTED,
+                              &sentData[ headersLen - ( sizeof( HTTP_TEST_REQUEST_TRANSFER_ENCODING_EXPECTED ) - 1U ) ],
+                              sizeof( HTTP_TEST_REQUEST_TRANSFER_ENCODING_EXPECTED ) - 1U );
+    TEST_ASSERT_EQUAL_MEMORY( HTTP_TEST_REQUEST_PUT_BODY_CHUNKED,
+                              &sentData[ headersLen ],
+                              HTTP_TEST_REQUEST_PUT_BODY_CHUNKED_LENGTH );
+
+    TEST_ASSERT_EQUAL( HTTP_STATUS_CODE_OK, response.statusCode );
+    TEST_ASSERT_EQUAL( HTTP_TEST_RESPONSE_PUT_HEADER_COUNT, response.headerCount );
+}
+
+/*-----------------------------------------------------------*/
+
+/* Test that an error from the body source stops the request. */
+void test_HTTPClient_SendChunked_body_source_error( void )
+{
+    HTTPStatus_t returnStatus = HTTPSuccess;
+    HTTPClient_RequestBodySource_t bodySource = { readBodyCallbackError, NULL };
+
+    transportInterface.send = transportSendCapture;
+    memcpy( requestHeaders.pBuffer,
+            HTTP_TEST_REQUEST_PUT_HEADERS,
+            HTTP_TEST_REQUEST_PUT_HEADERS_LENGTH );
+    requestHeaders.headersLen = HTTP_TEST_REQUEST_PUT_HEADERS_LENGTH;
+
+    returnStatus = HTTPClient_SendChunked( &transportInterface,
+                                           &requestHeaders,
+                                           &bodySource,
+                                           &response );
+
+    TEST_ASSERT_EQUAL( HTTPRequestBodyError, returnStatus );
+    TEST_ASSERT_EQUAL( 0, recvCurrentCall );
+}
+
+/*-----------------------------------------------------------*/
+
+/* Test the invalid parameters of HTTPClient_SendChunked(). */
+void test_HTTPClient_SendChunked_invalid_parameters( void )
+{
+    HTTPStatus_t returnStatus = HTTPSuccess;
+    HTTPClient_RequestBodySource_t bodySource = { NULL, NULL };
+
+    returnStatus = HTTPClient_SendChunked( &transportInterface,
+                                           &requestHeaders,
+                                           NULL,
+                                           &response );
+    TEST_ASSERT_EQUAL( HTTPInvalidParameter, returnStatus );
+
+    returnStatus = HTTPClient_SendChunked( &transportInterface,
+                                           &requestHeaders,
+                                           &bodySource,
+                                           &response );
+    TEST_ASSERT_EQUAL( HTTPInvalidParameter, returnStatus );
+
+    /* A HEAD request cannot have a body. */
+    bodySource.readBodyCallback = readBodyCallback;
+    returnStatus = HTTPClient_SendChunked( &transportInterface,
+                                           &requestHeaders,
+                                           &bodySource,
+                                           &response );
+    TEST_ASSERT_EQUAL( HTTPInvalidParameter, returnStatus );
+
+    returnStatus = HTTPClient_SendChunked( NULL,
+                                           &requestHeaders,
+                                           &bodySource,
+                                           &response );
+    TEST_ASSERT_EQUAL( HTTPInvalidParameter, returnStatus );
+}
@@ -1674,7 +1674,11 @@ void test_HTTPClient_strerror( void )
     str = HTTPClient_strerror( status );
     TEST_ASSERT_EQUAL_STRING( "HTTPInvalidResponse", str );
 
-    status = HTTPInvalidResponse + 1;
+    status = HTTPRequestBodyError;
+    str = HTTPClient_strerror( status );
+    TEST_ASSERT_EQUAL_STRING( "HTTPRequestBodyError", str );
+
+    status = HTTPRequestBodyError + 1;
     str = HTTPClient_strerror( status );
     TEST_ASSERT_EQUAL_STRING( NULL, str );
 }
@@ -294,6 +294,88 @@ static bool validateParams( MQTTAgentCommandType_t commandType,
  */
 static bool isSpaceInPendingAckList( const MQTTAgentContext_t * pAgentContext );
 
+/**
+ * @brief Call MQTT_ProcessLoop() for as long as it receives packets.
+ *
+ * @param[in] pMqttAgentContext Agent context for the MQTT connection.
+ *
+ * @return status of MQTT_ProcessLoop().
+ */
+static MQTTStatus_t runProcessLoop( MQTTAgentContext_t * pMqttAgentContext );
+
+#if ( MQTT_AGENT_PUBLISH_BATCH_MAX_COUNT > 1U )
+
+/**
+ * @brief Transport writev function installed while PUBLISH packets are added
+ * to a batch. The vectors are appended to the batch instead of being sent.
+ *
+ * @param[in] pNetworkContext The agent context of the batch.
+ * @param[in] pIoVec Vectors to append to the batch.
+ * @param[in] ioVecCount Number of vectors in @p pIoVec.
+ *
+ * @return The number of bytes added to the batch, or a negative value if the
+ * batch has no room for the vectors.
+ */
+    static int32_t batchWritev( NetworkContext_t * pNetworkContext,
+                                TransportOutVector_t * pIoVec,
+                                size_t ioVecCount );
+
+/**
+ * @brief Transport send function installed while PUBLISH packets are added
+ * to a batch. The buffer is appended to the batch instead of being sent.
+ *
+ * @param[in] pNetworkContext The agent context of the batch.
+ * @param[in] pBuffer Buffer to append to the batch.
+ * @param[in] bytesToSend Length of @p pBuffer.
+ *
+ * @return The number of bytes added to the batch, or a negative value if the
+ * batch has no room for the buffer.
+ */
+    static int32_t batchSend( NetworkContext_t * pNetworkContext,
+                              const void * pBuffer,
+                              size_t bytesToSend );
+
+/**
+ * @brief Write the PUBLISH packets of a batch to the transport, and conclude
+ * the commands waiting for the batch to be written.
+ *
+ * @param[in] pMqttAgentContext Agent context for the MQTT connection.
+ *
+ * @return #MQTTSuccess if the batch was written, else #MQTTSendFailed.
+ */
+    static MQTTStatus_t writePublishBatch( MQTTAgentContext_t * pMqttAgentContext );
+
+/**
+ * @brief Execute a PUBLISH command, adding the packet to the batch.
+ *
+ * @param[in] pMqttAgentContext Agent context for the MQTT connection.
+ * @param[in] pCommand PUBLISH command to execute.
+ * @param[in,out] pRunProcessLoop Set if the command requests a call to
+ * MQTT_ProcessLoop().
+ *
+ * @return status of the command function.
+ */
+    static MQTTStatus_t addPublishToBatch( MQTTAgentContext_t * pMqttAgentContext,
+                                           MQTTAgentCommand_t * pCommand,
+                                           bool * pRunProcessLoop );
+
+/**
+ * @brief Execute a PUBLISH command and the PUBLISH commands queued after it,
+ * writing their packets to the transport together.
+ *
+ * @param[in] pMqttAgentContext Agent context for the MQTT connection.
+ * @param[in,out] ppCommand The first PUBLISH command. On return, the command
+ * received from the queue that is not part of the batch, or NULL.
+ * @param[out] pEndLoop Whether the command loop should terminate.
+ *
+ * @return status of the batch.
+ */
+    static MQTTStatus_t processPublishBatch( MQTTAgentContext_t * pMqttAgentContext,
+                                             MQTTAgentCommand_t ** ppCommand,
+                                             bool * pEndLoop );
+
+#endif /* if ( MQTT_AGENT_PUBLISH_BATCH_MAX_COUNT > 1U ) */
+
 /*-----------------------------------------------------------*/
 
 static bool isSpaceInPendingAckList( const MQTTAgentContext_t * pAgentContext )
@@ -601,16 +683,7 @@ static MQTTStatus_t processCommand( MQTTAgentContext_t * pMqttAgentContext,
      * still exists. */
     if( ( operationStatus == MQTTSuccess ) && commandOutParams.runProcessLoop )
     {
-        do
-        {
-            pMqttAgentContext->packetReceivedInLoop = false;
-
-            if( ( ( operationStatus == MQTTSuccess ) || ( operationStatus == MQTTNeedMoreBytes ) ) &&
-                ( pMqttAgentContext->mqttContext.connectStatus == MQTTConnected ) )
-            {
-                operationStatus = MQTT_ProcessLoop( &( pMqttAgentContext->mqttContext ) );
-            }
-        } while( pMqttAgentContext->packetReceivedInLoop );
+        operationStatus = runProcessLoop( pMqttAgentContext );
     }
 
     /* Set the flag to break from the command loop. */
@@ -621,6 +694,369 @@ static MQTTStatus_t processCommand( MQTTAgentContext_t * pMqttAgentContext,
 
 /*-----------------------------------------------------------*/
 
+static MQTTStatus_t runProcessLoop( MQTTAgentContext_t * pMqttAgentContext )
+{
+    MQTTStatus_t operationStatus = MQTTSuccess;
+
+    assert( pMqttAgentContext != NULL );
+
+    do
+    {
+        pMqttAgentContext->packetReceivedInLoop = false;
+
+        if( ( ( operationStatus == MQTTSuccess ) || ( operationStatus == MQTTNeedMoreBytes ) ) &&
+            ( pMqttAgentContext->mqttContext.connectStatus == MQTTConnected ) )
+        {
+            operationStatus = MQTT_ProcessLoop( &( pMqttAgentContext->mqttContext ) );
+        }
+    } while( pMqttAgentContext->packetReceivedInLoop );
+
+    return operationStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+#if ( MQTT_AGENT_PUBLISH_BATCH_MAX_COUNT > 1U )
+
+    static int32_t batchWritev( NetworkContext_t * pNetworkContext,
+                                TransportOutVector_t * pIoVec,
+                                size_t ioVecCount )
+    {
+        /* The agent context stands in for the network context while a batch
+         * is gathered, see processPublishBatch(). */
+        MQTTAgentPublishBatch_t * pBatch = &( ( ( MQTTAgentContext_t * ) pNetworkContext )->publishBatch );
+        const size_t ioVectorCount = pBatch->ioVectorCount;
+        const size_t headersLength = pBatch->headersLength;
+        const size_t byteCount = pBatch->byteCount;
+        int32_t bytesAdded = 0;
+        size_t i;
+        size_t length;
+        bool isStable;
+
+        assert( pIoVec != NULL );
+        assert( pBatch->pPublishInfo != NULL );
+
+        for( i = 0; ( i < ioVecCount ) && ( bytesAdded >= 0 ); i++ )
+        {
+            length = pIoVec[ i ].iov_len;
+
+            /* The topic name and payload stay valid until the command is
+             * concluded. Everything else, such as the header serialized on the
+             * stack of MQTT_Publish(), is copied. */
+            isStable = ( pIoVec[ i ].iov_base == pBatch->pPublishInfo->pTopicName ) ||
+                       ( pIoVec[ i ].iov_base == pBatch->pPublishInfo->pPayload );
+
+            if( length == 0U )
+            {
+                /* Nothing to add. */
+            }
+            else if( ( pBatch->ioVectorCount == ( sizeof( pBatch->ioVectors ) / sizeof( pBatch->ioVectors[ 0 ] ) ) ) ||
+                     ( ( isStable == false ) && ( length > ( sizeof( pBatch->headers ) - pBatch->headersLength ) ) ) )
+            {
+                LogError( ( "No room to add %lu bytes to the PUBLISH batch.",
+                            ( unsigned long ) length ) );
+                bytesAdded = -1;
+            }
+            else
+            {
+                if( isStable == true )
+                {
+                    pBatch->ioVectors[ pBatch->ioVectorCount ].iov_base = pIoVec[ i ].iov_base;
+                }
+                else
+                {
+                    ( void ) memcpy( &( pBatch->headers[ pBatch->headersLength ] ), pIoVec[ i ].iov_base, length );
+                    pBatch->ioVectors[ pBatch->ioVectorCount ].iov_base = &( pBatch->headers[ pBatch->headersLength ] );
+                    pBatch->headersLength += length;
+                }
+
+                pBatch->ioVectors[ pBatch->ioVectorCount ].iov_len = length;
+                pBatch->ioVectorCount++;
+                pBatch->byteCount += length;
+                bytesAdded += ( int32_t ) length;
+            }
+        }
+
+        if( bytesAdded < 0 )
+        {
+            /* Drop the vectors of a packet that does not fit as a whole. */
+            pBatch->ioVectorCount = ioVectorCount;
+            pBatch->headersLength = headersLength;
+            pBatch->byteCount = byteCount;
+        }
+
+        return bytesAdded;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static int32_t batchSend( NetworkContext_t * pNetworkContext,
+                              const void * pBuffer,
+                              size_t bytesToSend )
+    {
+        TransportOutVector_t ioVec;
+
+        ioVec.iov_base = pBuffer;
+        ioVec.iov_len = bytesToSend;
+
+        return batchWritev( pNetworkContext, &ioVec, 1U );
+    }
+
+/*-----------------------------------------------------------*/
+
+    static MQTTStatus_t writePublishBatch( MQTTAgentContext_t * pMqttAgentContext )
+    {
+        MQTTAgentPublishBatch_t * pBatch = NULL;
+        MQTTContext_t * pMqttContext = NULL;
+        TransportOutVector_t * pIoVec = NULL;
+        size_t ioVecCount = 0;
+        MQTTStatus_t status = MQTTSuccess;
+        int32_t sendResult = 0;
+        uint32_t startTimeMs = 0;
+        size_t i;
+
+        assert( pMqttAgentContext != NULL );
+
+        pBatch = &( pMqttAgentContext->publishBatch );
+        pMqttContext = &( pMqttAgentContext->mqttContext );
+        pIoVec = pBatch->ioVectors;
+        ioVecCount = pBatch->ioVectorCount;
+        startTimeMs = pMqttContext->getTime();
+
+        while( ( ioVecCount > 0U ) && ( status == MQTTSuccess ) )
+        {
+            sendResult = pBatch->transportInterface.writev( pBatch->transportInterface.pNetworkContext,
+                                                            pIoVec,
+                                                            ioVecCount );
+            pBatch->stats.writeCount++;
+
+            if( sendResult < 0 )
+            {
+                LogError( ( "Failed to write a batch of %lu PUBLISH packets: Network error.",
+                            ( unsigned long ) pBatch->publishCount ) );
+                status = MQTTSendFailed;
+            }
+            else
+            {
+                if( sendResult > 0 )
+                {
+                    pMqttContext->lastPacketTxTime = pMqttContext->getTime();
+                }
+
+                /* Skip the vectors that were written, and the written part of
+                 * the vector after them. */
+                while( ( ioVecCount > 0U ) && ( ( size_t ) sendResult >= pIoVec->iov_len ) )
+                {
+                    sendResult -= ( int32_t ) pIoVec->iov_len;
+                    pIoVec++;
+                    ioVecCount--;
+                }
+
+                if( sendResult > 0 )
+                {
+                    pIoVec->iov_base = &( ( ( const uint8_t * ) pIoVec->iov_base )[ sendResult ] );
+                    pIoVec->iov_len -= ( size_t ) sendResult;
+                }
+
+                if( ( ioVecCount > 0U ) &&
+                    ( ( pMqttContext->getTime() - startTimeMs ) >= MQTT_SEND_TIMEOUT_MS ) )
+                {
+                    LogError( ( "Failed to write a batch of %lu PUBLISH packets: Timed out.",
+                                ( unsigned long ) pBatch->publishCount ) );
+                    status = MQTTSendFailed;
+                }
+            }
+        }
+
+        if( ( status == MQTTSuccess ) && ( pBatch->publishCount > 0U ) )
+        {
+            pBatch->stats.batchCount++;
+            pBatch->stats.publishCount += ( uint32_t ) pBatch->publishCount;
+            pBatch->stats.byteCount += ( uint32_t ) pBatch->byteCount;
+            pBatch->stats.batchSizeCount[ pBatch->publishCount - 1U ]++;
+        }
+
+        /* The publishes that do not wait for an acknowledgment are complete. */
+        for( i = 0; i < pBatch->commandCount; i++ )
+        {
+            concludeCommand( pMqttAgentContext, pBatch->pCommands[ i ], status, NULL );
+        }
+
+        pBatch->ioVectorCount = 0U;
+        pBatch->headersLength = 0U;
+        pBatch->commandCount = 0U;
+        pBatch->publishCount = 0U;
+        pBatch->byteCount = 0U;
+
+        return status;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static MQTTStatus_t addPublishToBatch( MQTTAgentContext_t * pMqttAgentContext,
+                                           MQTTAgentCommand_t * pCommand,
+                                           bool * pRunProcessLoop )
+    {
+        const MQTTAgentCommandFunc_t pCommandFunctionTable[ NUM_COMMANDS ] = MQTT_AGENT_FUNCTION_TABLE;
+        MQTTAgentPublishBatch_t * pBatch = NULL;
+        MQTTStatus_t operationStatus = MQTTSuccess;
+        bool ackAdded = false;
+        MQTTAgentCommandFuncReturns_t commandOutParams = { 0 };
+
+        assert( pMqttAgentContext != NULL );
+        assert( pCommand != NULL );
+        assert( pCommand->commandType == PUBLISH );
+        assert( pRunProcessLoop != NULL );
+
+        pBatch = &( pMqttAgentContext->publishBatch );
+        pBatch->pPublishInfo = ( const MQTTPublishInfo_t * ) pCommand->pArgs;
+
+        operationStatus = pCommandFunctionTable[ PUBLISH ]( pMqttAgentContext, pCommand->pArgs, &commandOutParams );
+
+        pBatch->pPublishInfo = NULL;
+
+        if( operationStatus == MQTTSuccess )
+        {
+            pBatch->publishCount++;
+            *pRunProcessLoop = ( *pRunProcessLoop || commandOutParams.runProcessLoop );
+        }
+
+        if( ( operationStatus == MQTTSuccess ) &&
+            commandOutParams.addAcknowledgment &&
+            ( commandOutParams.packetId != MQTT_PACKET_ID_INVALID ) )
+        {
+            operationStatus = addAwaitingOperation( pMqttAgentContext, commandOutParams.packetId, pCommand );
+            ackAdded = ( operationStatus == MQTTSuccess );
+        }
+
+        if( ackAdded == true )
+        {
+            /* The command is concluded when the acknowledgment arrives. */
+        }
+        else if( operationStatus == MQTTSuccess )
+        {
+            /* The command is concluded when the batch is written. */
+            pBatch->pCommands[ pBatch->commandCount ] = pCommand;
+            pBatch->commandCount++;
+        }
+        else
+        {
+            concludeCommand( pMqttAgentContext, pCommand, operationStatus, NULL );
+        }
+
+        return operationStatus;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static MQTTStatus_t processPublishBatch( MQTTAgentContext_t * pMqttAgentContext,
+                                             MQTTAgentCommand_t ** ppCommand,
+                                             bool * pEndLoop )
+    {
+        MQTTAgentPublishBatch_t * pBatch = NULL;
+        MQTTContext_t * pMqttContext = NULL;
+        MQTTAgentCommand_t * pCommand = NULL;
+        const MQTTPublishInfo_t * pPublishInfo = NULL;
+        MQTTStatus_t operationStatus = MQTTSuccess;
+        MQTTStatus_t writeStatus = MQTTSuccess;
+        bool processLoopRequested = false;
+        size_t commandCount = 0;
+        uint32_t startTimeMs = 0;
+        uint32_t elapsedTimeMs = 0;
+        uint32_t waitTimeMs = MQTT_AGENT_PUBLISH_BATCH_WAIT_TIME_MS;
+
+        /* Largest part of a PUBLISH besides the topic name and payload. */
+        const size_t maxHeaderBytes = MQTT_AGENT_PUBLISH_COPY_MAX_SIZE;
+
+        assert( pMqttAgentContext != NULL );
+        assert( ppCommand != NULL );
+        assert( *ppCommand != NULL );
+        assert( pEndLoop != NULL );
+
+        pBatch = &( pMqttAgentContext->publishBatch );
+        pMqttContext = &( pMqttAgentContext->mqttContext );
+        pCommand = *ppCommand;
+        startTimeMs = pMqttContext->getTime();
+
+        /* Divert the transport to the batch while PUBLISH commands are
+         * executed. The agent context takes the place of the network context
+         * so that the batch functions can find the batch. */
+        pBatch->transportInterface = pMqttContext->transportInterface;
+        pMqttContext->transportInterface.pNetworkContext = ( NetworkContext_t * ) pMqttAgentContext;
+        pMqttContext->transportInterface.send = batchSend;
+        pMqttContext->transportInterface.writev = batchWritev;
+
+        while( ( pCommand != NULL ) && ( pCommand->commandType == PUBLISH ) && ( operationStatus == MQTTSuccess ) )
+        {
+            pPublishInfo = ( const MQTTPublishInfo_t * ) pCommand->pArgs;
+
+            /* Write the batch first if this PUBLISH would take it over the
+             * byte limit. */
+            if( ( pBatch->publishCount > 0U ) &&
+                ( ( pBatch->byteCount + maxHeaderBytes + pPublishInfo->topicNameLength + pPublishInfo->payloadLength ) >
+                  MQTT_AGENT_PUBLISH_BATCH_MAX_BYTES ) )
+            {
+                operationStatus = writePublishBatch( pMqttAgentContext );
+            }
+
+            if( operationStatus == MQTTSuccess )
+            {
+                operationStatus = addPublishToBatch( pMqttAgentContext, pCommand, &processLoopRequested );
+            }
+            else
+            {
+                concludeCommand( pMqttAgentContext, pCommand, operationStatus, NULL );
+            }
+
+            commandCount++;
+            pCommand = NULL;
+
+            if( ( operationStatus == MQTTSuccess ) && ( commandCount < MQTT_AGENT_PUBLISH_BATCH_MAX_COUNT ) )
+            {
+                elapsedTimeMs = pMqttContext->getTime() - startTimeMs;
+                waitTimeMs = ( elapsedTimeMs < waitTimeMs ) ? ( waitTimeMs - elapsedTimeMs ) : 0U;
+                startTimeMs += elapsedTimeMs;
+
+                ( void ) pMqttAgentContext->agentInterface.recv(
+                    pMqttAgentContext->agentInterface.pMsgCtx,
+                    &( pCommand ),
+                    waitTimeMs
+                    );
+            }
+        }
+
+        pMqttContext->transportInterface = pBatch->transportInterface;
+
+        writeStatus = writePublishBatch( pMqttAgentContext );
+
+        if( operationStatus == MQTTSuccess )
+        {
+            operationStatus = writeStatus;
+        }
+
+        if( ( operationStatus == MQTTSuccess ) && processLoopRequested )
+        {
+            operationStatus = runProcessLoop( pMqttAgentContext );
+        }
+
+        if( ( operationStatus != MQTTSuccess ) && ( pCommand != NULL ) )
+        {
+            /* The command loop terminates, so the command that ended the batch
+             * is not executed. */
+            concludeCommand( pMqttAgentContext, pCommand, operationStatus, NULL );
+            pCommand = NULL;
+        }
+
+        *ppCommand = pCommand;
+        *pEndLoop = ( operationStatus != MQTTSuccess );
+
+        return operationStatus;
+    }
+
+#endif /* if ( MQTT_AGENT_PUBLISH_BATCH_MAX_COUNT > 1U ) */
+
+/*-----------------------------------------------------------*/
+
 static void handleAcks( const MQTTAgentContext_t * pAgentContext,
                         const MQTTPacketInfo_t * pPacketInfo,
                         const MQTTDeserializedInfo_t * pDeserializedInfo,
@@ -1039,6 +1475,7 @@ MQTTStatus_t MQTTAgent_CommandLoop( MQTTAgentContext_t * pMqttAgentContext )
     MQTTAgentCommand_t * pCommand;
     MQTTStatus_t operationStatus = MQTTSuccess;
     bool endLoop = false;
+    bool batched = false;
 
     /* The command queue should have been created before this task gets created. */
     if( ( pMqttAgentContext == NULL ) || ( pMqttAgentContext->agentInterface.pMsgCtx == NULL ) )
@@ -1056,7 +1493,27 @@ MQTTStatus_t MQTTAgent_CommandLoop( MQTTAgentContext_t * pMqttAgentContext )
             &( pCommand ),
             MQTT_AGENT_MAX_EVENT_QUEUE_WAIT_TIME
             );
-        operationStatus = processCommand( pMqttAgentContext, pCommand, &endLoop );
+
+        #if ( MQTT_AGENT_PUBLISH_BATCH_MAX_COUNT > 1U )
+            {
+                batched = ( pCommand != NULL ) &&
+                          ( pCommand->commandType == PUBLISH ) &&
+                          ( pMqttAgentContext->mqttContext.transportInterface.writev != NULL );
+
+                if( batched == true )
+                {
+                    /* On return, pCommand is the command that ended the batch,
+                     * if any. */
+                    operationStatus = processPublishBatch( pMqttAgentContext, &pCommand, &endLoop );
+                }
+            }
+        #endif /* if ( MQTT_AGENT_PUBLISH_BATCH_MAX_COUNT > 1U ) */
+
+        /* A batch has already called MQTT_ProcessLoop() if it was needed. */
+        if( ( batched == false ) || ( pCommand != NULL ) )
+        {
+            operationStatus = processCommand( pMqttAgentContext, pCommand, &endLoop );
+        }
 
         if( operationStatus != MQTTSuccess )
         {
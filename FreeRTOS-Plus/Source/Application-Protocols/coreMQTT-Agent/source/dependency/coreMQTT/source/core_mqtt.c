@@ -2548,6 +2548,18 @@ MQTTStatus_t MQTT_InitStatefulQoS( MQTTContext_t * pContext,
                     incomingPublishCount ) );
         status = MQTTBadParameter;
     }
+
+    /* Records link to each other with 16-bit indices, and there can never be
+     * more records in use than there are packet IDs. */
+    else if( ( outgoingPublishCount > UINT16_MAX ) ||
+             ( incomingPublishCount > UINT16_MAX ) )
+    {
+        LogError( ( "Too many publish records: outgoingPublishCount=%lu, "
+                    "incomingPublishCount=%lu",
+                    outgoingPublishCount,
+                    incomingPublishCount ) );
+        status = MQTTBadParameter;
+    }
     else if( pContext->appCallback == NULL )
     {
         LogError( ( "MQTT_InitStatefulQoS must be called only after MQTT_Init has"
@@ -2560,6 +2572,21 @@ MQTTStatus_t MQTT_InitStatefulQoS( MQTTContext_t * pContext,
         pContext->incomingPublishRecords = pIncomingPublishRecords;
         pContext->outgoingPublishRecordMaxCount = outgoingPublishCount;
         pContext->outgoingPublishRecords = pOutgoingPublishRecords;
+
+        /* An all zero array holds no records. */
+        if( outgoingPublishCount > 0U )
+        {
+            ( void ) memset( pOutgoingPublishRecords,
+                             0x00,
+                             outgoingPublishCount * sizeof( *pOutgoingPublishRecords ) );
+        }
+
+        if( incomingPublishCount > 0U )
+        {
+            ( void ) memset( pIncomingPublishRecords,
+                             0x00,
+                             incomingPublishCount * sizeof( *pIncomingPublishRecords ) );
+        }
     }
 
     return status;
@@ -146,12 +146,25 @@ typedef enum MQTTSubAckStatus
 /**
  * @ingroup mqtt_struct_types
  * @brief An element of the state engine records for QoS 1 or Qos 2 publishes.
+ *
+ * The state engine stores each record at a position derived from its packet
+ * ID and chains the records in the order they were added, so the last three
+ * members are maintained by the library and must not be modified by the
+ * application. Links hold one more than the array index of the record they
+ * refer to, so that a zero-initialized array is an empty set of records.
+ *
+ * @note The three link members add 6 bytes to each element. With 4-byte
+ * enums and 4-byte alignment an element takes 20 bytes rather than 12, so
+ * statically sized record arrays need resizing to stay within the same RAM.
  */
 typedef struct MQTTPubAckInfo
 {
     uint16_t packetId;               /**< @brief The packet ID of the original PUBLISH. */
     MQTTQoS_t qos;                   /**< @brief The QoS of the original PUBLISH. */
     MQTTPublishState_t publishState; /**< @brief The current state of the publish process. */
+    uint16_t prevRecord;             /**< @brief Link to the record added before this one; the oldest record links to the newest. */
+    uint16_t nextRecord;             /**< @brief Link to the record added after this one, or 0 for the newest record. */
+    uint16_t oldestRecord;           /**< @brief Link to the oldest record. Only used in the first element of the array. */
 } MQTTPubAckInfo_t;
 
 /**
@@ -345,6 +358,14 @@ MQTTStatus_t MQTT_Init( MQTTContext_t * pContext,
  * @param[in] incomingPublishCount Maximum number of records which can be kept in the memory
  * pointed to by @p pIncomingPublishRecords.
  *
+ * @note Both record arrays are cleared by this function, so any records they
+ * held before the call are discarded. Earlier versions of the library left the
+ * arrays untouched; applications must not fill the arrays before the call or
+ * expect their contents to survive it, for example to carry QoS state across a
+ * re-initialization of the context. The arrays must not be shared with another
+ * context. Each array can hold at most `UINT16_MAX` records, which is also the
+ * number of distinct packet IDs.
+ *
  * @return #MQTTBadParameter if invalid parameters are passed;
  * #MQTTSuccess otherwise.
  *
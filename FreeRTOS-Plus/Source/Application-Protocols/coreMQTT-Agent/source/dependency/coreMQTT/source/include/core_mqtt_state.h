@@ -42,13 +42,23 @@
  * @brief Initializer value for an #MQTTStateCursor_t, indicating a search
  * should start at the beginning of a state record array
  */
-#define MQTT_STATE_CURSOR_INITIALIZER    ( ( size_t ) 0 )
+#define MQTT_STATE_CURSOR_INITIALIZER    ( ( uint32_t ) 0 )
 
 /**
  * @ingroup mqtt_basic_types
  * @brief Cursor for iterating through state records.
+ *
+ * Records are visited in the order they were added. The cursor holds the
+ * packet IDs of the record visited last and of the record after it, so
+ * records may be added or removed between calls that share a cursor; in
+ * particular the record just returned may be removed. Only if both of those
+ * records are removed does the search start over with the oldest record.
+ *
+ * @note This was a `size_t` index into the records array before the records
+ * were indexed by packet ID. Code that only initializes cursors with
+ * #MQTT_STATE_CURSOR_INITIALIZER and passes them back is unaffected.
  */
-typedef size_t MQTTStateCursor_t;
+typedef uint32_t MQTTStateCursor_t;
 
 /**
  * @cond DOXYGEN_IGNORE
@@ -201,7 +211,8 @@ MQTTStatus_t MQTT_UpdateStateAck( const MQTTContext_t * pMqttContext,
  * a PUBREL need to be resent in the correct order.
  *
  * @param[in] pMqttContext Initialized MQTT context.
- * @param[in,out] pCursor Index at which to start searching.
+ * @param[in,out] pCursor Position after which to start searching. Initialize
+ * to #MQTT_STATE_CURSOR_INITIALIZER to start with the oldest record.
  * @param[out] pState State indicating that PUBREL packet need to be sent.
  */
 
@@ -223,7 +234,8 @@ uint16_t MQTT_PubrelToResend( const MQTTContext_t * pMqttContext,
  * a publish need to be resent in the correct order.
  *
  * @param[in] pMqttContext Initialized MQTT context.
- * @param[in,out] pCursor Index at which to start searching.
+ * @param[in,out] pCursor Position after which to start searching. Initialize
+ * to #MQTT_STATE_CURSOR_INITIALIZER to start with the oldest record.
  *
  * <b>Example</b>
  * @code{c}
@@ -2362,8 +2362,8 @@ void test_MQTT_Publish12( void )
     MQTTStatus_t status;
     MQTTPublishState_t expectedState = { 0 };
 
-    MQTTPubAckInfo_t incomingRecords = { 0 };
-    MQTTPubAckInfo_t outgoingRecords = { 0 };
+    MQTTPubAckInfo_t incomingRecords[ 4 ] = { 0 };
+    MQTTPubAckInfo_t outgoingRecords[ 4 ] = { 0 };
 
     const uint16_t PACKET_ID = 1;
 
@@ -2378,8 +2378,8 @@ void test_MQTT_Publish12( void )
     publishInfo.qos = MQTTQoS1;
 
     MQTT_InitStatefulQoS( &mqttContext,
-                          &outgoingRecords, 4,
-                          &incomingRecords, 4 );
+                          outgoingRecords, 4,
+                          incomingRecords, 4 );
 
     mqttContext.outgoingPublishRecords[ 0 ].packetId = 1;
     mqttContext.outgoingPublishRecords[ 0 ].qos = MQTTQoS2;
@@ -2411,8 +2411,8 @@ void test_MQTT_Publish13( void )
     TransportInterface_t transport = { 0 };
     MQTTFixedBuffer_t networkBuffer = { 0 };
     MQTTStatus_t status;
-    MQTTPubAckInfo_t incomingRecords = { 0 };
-    MQTTPubAckInfo_t outgoingRecords = { 0 };
+    MQTTPubAckInfo_t incomingRecords[ 4 ] = { 0 };
+    MQTTPubAckInfo_t outgoingRecords[ 4 ] = { 0 };
 
     const uint16_t PACKET_ID = 1;
 
@@ -2425,8 +2425,8 @@ void test_MQTT_Publish13( void )
     MQTT_Init( &mqttContext, &transport, getTime, eventCallback, &networkBuffer );
 
     MQTT_InitStatefulQoS( &mqttContext,
-                          &outgoingRecords, 4,
-                          &incomingRecords, 4 );
+                          outgoingRecords, 4,
+                          incomingRecords, 4 );
 
     publishInfo.qos = MQTTQoS1;
 
@@ -3104,8 +3104,8 @@ void test_MQTT_ProcessLoop_handleIncomingPublish_Happy_Path3( void )
     MQTTFixedBuffer_t networkBuffer = { 0 };
     MQTTPublishInfo_t pubInfo = { 0 };
     ProcessLoopReturns_t expectParams = { 0 };
-    MQTTPubAckInfo_t incomingRecords = { 0 };
-    MQTTPubAckInfo_t outgoingRecords = { 0 };
+    MQTTPubAckInfo_t incomingRecords[ 4 ] = { 0 };
+    MQTTPubAckInfo_t outgoingRecords[ 4 ] = { 0 };
 
     setupTransportInterface( &transport );
     setupNetworkBuffer( &networkBuffer );
@@ -3118,8 +3118,8 @@ void test_MQTT_ProcessLoop_handleIncomingPublish_Happy_Path3( void )
     TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
 
     MQTT_InitStatefulQoS( &context,
-                          &outgoingRecords, 4,
-                          &incomingRecords, 4 );
+                          outgoingRecords, 4,
+                          incomingRecords, 4 );
 
     modifyIncomingPacketStatus = MQTTSuccess;
 
@@ -3277,8 +3277,8 @@ void test_MQTT_ProcessLoop_handleIncomingPublish_Error_Paths( void )
     MQTTFixedBuffer_t networkBuffer = { 0 };
     MQTTPublishInfo_t publishInfo = { 0 };
     ProcessLoopReturns_t expectParams = { 0 };
-    MQTTPubAckInfo_t incomingRecords = { 0 };
-    MQTTPubAckInfo_t outgoingRecords = { 0 };
+    MQTTPubAckInfo_t incomingRecords[ 4 ] = { 0 };
+    MQTTPubAckInfo_t outgoingRecords[ 4 ] = { 0 };
 
     setupTransportInterface( &transport );
     setupNetworkBuffer( &networkBuffer );
@@ -3287,8 +3287,8 @@ void test_MQTT_ProcessLoop_handleIncomingPublish_Error_Paths( void )
     TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
 
     MQTT_InitStatefulQoS( &context,
-                          &outgoingRecords, 4,
-                          &incomingRecords, 4 );
+                          outgoingRecords, 4,
+                          incomingRecords, 4 );
 
     modifyIncomingPacketStatus = MQTTSuccess;
 
@@ -4204,8 +4204,8 @@ void test_MQTT_Subscribe_happy_path( void )
     MQTTSubscribeInfo_t subscribeInfo = { 0 };
     size_t remainingLength = MQTT_SAMPLE_REMAINING_LENGTH;
     size_t packetSize = MQTT_SAMPLE_REMAINING_LENGTH;
-    MQTTPubAckInfo_t incomingRecords = { 0 };
-    MQTTPubAckInfo_t outgoingRecords = { 0 };
+    MQTTPubAckInfo_t incomingRecords[ 4 ] = { 0 };
+    MQTTPubAckInfo_t outgoingRecords[ 4 ] = { 0 };
 
     setupTransportInterface( &transport );
     setupNetworkBuffer( &networkBuffer );
@@ -4216,8 +4216,8 @@ void test_MQTT_Subscribe_happy_path( void )
     TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
 
     mqttStatus = MQTT_InitStatefulQoS( &context,
-                                       &outgoingRecords, 4,
-                                       &incomingRecords, 4 );
+                                       outgoingRecords, 4,
+                                       incomingRecords, 4 );
     TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
 
     /* Verify MQTTSuccess is returned with the following mocks. */
@@ -4245,8 +4245,8 @@ void test_MQTT_Subscribe_happy_path1( void )
     MQTTSubscribeInfo_t subscribeInfo[ 2 ];
     size_t remainingLength = MQTT_SAMPLE_REMAINING_LENGTH;
     size_t packetSize = MQTT_SAMPLE_REMAINING_LENGTH;
-    MQTTPubAckInfo_t incomingRecords = { 0 };
-    MQTTPubAckInfo_t outgoingRecords = { 0 };
+    MQTTPubAckInfo_t incomingRecords[ 4 ] = { 0 };
+    MQTTPubAckInfo_t outgoingRecords[ 4 ] = { 0 };
 
     setupTransportInterface( &transport );
     setupNetworkBuffer( &networkBuffer );
@@ -4257,8 +4257,8 @@ void test_MQTT_Subscribe_happy_path1( void )
     TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
 
     mqttStatus = MQTT_InitStatefulQoS( &context,
-                                       &outgoingRecords, 4,
-                                       &incomingRecords, 4 );
+                                       outgoingRecords, 4,
+                                       incomingRecords, 4 );
     TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
 
     /* Verify MQTTSuccess is returned with the following mocks. */
@@ -4286,8 +4286,8 @@ void test_MQTT_Subscribe_happy_path2( void )
     MQTTSubscribeInfo_t subscribeInfo[ 2 ];
     size_t remainingLength = MQTT_SAMPLE_REMAINING_LENGTH;
     size_t packetSize = MQTT_SAMPLE_REMAINING_LENGTH;
-    MQTTPubAckInfo_t incomingRecords = { 0 };
-    MQTTPubAckInfo_t outgoingRecords = { 0 };
+    MQTTPubAckInfo_t incomingRecords[ 4 ] = { 0 };
+    MQTTPubAckInfo_t outgoingRecords[ 4 ] = { 0 };
 
     setupTransportInterface( &transport );
     setupNetworkBuffer( &networkBuffer );
@@ -4299,8 +4299,8 @@ void test_MQTT_Subscribe_happy_path2( void )
     TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
 
     mqttStatus = MQTT_InitStatefulQoS( &context,
-                                       &outgoingRecords, 4,
-                                       &incomingRecords, 4 );
+                                       outgoingRecords, 4,
+                                       incomingRecords, 4 );
     TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
 
     /* Verify MQTTSuccess is returned with the following mocks. */
@@ -4474,8 +4474,8 @@ void test_MQTT_Unsubscribe_happy_path1( void )
     MQTTSubscribeInfo_t subscribeInfo[ 2 ];
     size_t remainingLength = MQTT_SAMPLE_REMAINING_LENGTH;
     size_t packetSize = MQTT_SAMPLE_REMAINING_LENGTH;
-    MQTTPubAckInfo_t incomingRecords = { 0 };
-    MQTTPubAckInfo_t outgoingRecords = { 0 };
+    MQTTPubAckInfo_t incomingRecords[ 4 ] = { 0 };
+    MQTTPubAckInfo_t outgoingRecords[ 4 ] = { 0 };
 
     setupTransportInterface( &transport );
     setupNetworkBuffer( &networkBuffer );
@@ -4486,8 +4486,8 @@ void test_MQTT_Unsubscribe_happy_path1( void )
     TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
 
     mqttStatus = MQTT_InitStatefulQoS( &context,
-                                       &outgoingRecords, 4,
-                                       &incomingRecords, 4 );
+                                       outgoingRecords, 4,
+                                       incomingRecords, 4 );
     TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
 
     /* Verify MQTTSuccess is returned with the following mocks. */
@@ -4515,8 +4515,8 @@ void test_MQTT_unsubscribe_happy_path2( void )
     MQTTSubscribeInfo_t subscribeInfo[ 3 ];
     size_t remainingLength = MQTT_SAMPLE_REMAINING_LENGTH;
     size_t packetSize = MQTT_SAMPLE_REMAINING_LENGTH;
-    MQTTPubAckInfo_t incomingRecords = { 0 };
-    MQTTPubAckInfo_t outgoingRecords = { 0 };
+    MQTTPubAckInfo_t incomingRecords[ 4 ] = { 0 };
+    MQTTPubAckInfo_t outgoingRecords[ 4 ] = { 0 };
 
     setupTransportInterface( &transport );
     setupNetworkBuffer( &networkBuffer );
@@ -4529,8 +4529,8 @@ void test_MQTT_unsubscribe_happy_path2( void )
     TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
 
     mqttStatus = MQTT_InitStatefulQoS( &context,
-                                       &outgoingRecords, 4,
-                                       &incomingRecords, 4 );
+                                       outgoingRecords, 4,
+                                       incomingRecords, 4 );
     TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
 
     /* Verify MQTTSuccess is returned with the following mocks. */
@@ -5450,3 +5450,29 @@ void test_MQTT_InitStatefulQoS_callback_is_null( void )
     TEST_ASSERT_EQUAL( MQTTBadParameter, mqttStatus );
 }
 /* ========================================================================== */
+
+void test_MQTT_InitStatefulQoS_too_many_records( void )
+{
+    MQTTStatus_t mqttStatus;
+    MQTTPubAckInfo_t pOutgoingPublishRecords[ 10 ] = { 0 };
+    MQTTPubAckInfo_t pIncomingPublishRecords[ 10 ] = { 0 };
+
+    MQTTContext_t mqttContext = { 0 };
+
+    /* Records link to each other with 16-bit values, so the count is only
+     * checked and the arrays are never accessed. */
+    mqttStatus = MQTT_InitStatefulQoS( &mqttContext,
+                                       pOutgoingPublishRecords,
+                                       ( size_t ) UINT16_MAX + 1U,
+                                       pIncomingPublishRecords,
+                                       10 );
+    TEST_ASSERT_EQUAL( MQTTBadParameter, mqttStatus );
+
+    mqttStatus = MQTT_InitStatefulQoS( &mqttContext,
+                                       pOutgoingPublishRecords,
+                                       10,
+                                       pIncomingPublishRecords,
+                                       ( size_t ) UINT16_MAX + 1U );
+    TEST_ASSERT_EQUAL( MQTTBadParameter, mqttStatus );
+}
+/* ========================================================================== */
@@ -125,6 +125,64 @@ typedef struct MQTTAckInfo
     MQTTAgentCommand_t * pOriginalCommand; /**< Command expecting acknowledgment. */
 } MQTTAgentAckInfo_t;
 
+#if ( MQTT_AGENT_PUBLISH_BATCH_MAX_COUNT > 1U )
+
+/**
+ * @ingroup mqtt_agent_struct_types
+ * @brief Statistics of the PUBLISH batches written by the agent.
+ */
+    typedef struct MQTTAgentPublishBatchStats
+    {
+        uint32_t batchCount;                                           /**< Number of batches written to the transport. */
+        uint32_t publishCount;                                         /**< Number of PUBLISH packets written in batches. */
+        uint32_t byteCount;                                            /**< Number of bytes written in batches. */
+        uint32_t writeCount;                                           /**< Number of calls to the transport `writev` for batches. */
+        uint32_t batchSizeCount[ MQTT_AGENT_PUBLISH_BATCH_MAX_COUNT ]; /**< Number of batches of each size, indexed by number of publishes minus one. */
+    } MQTTAgentPublishBatchStats_t;
+
+/**
+ * @brief The largest number of vectors coreMQTT writes for one PUBLISH packet,
+ * and the largest number of those bytes that the batch copies.
+ *
+ * A PUBLISH is written as its header, topic name, packet ID and payload. The
+ * copied header holds the fixed header, up to 4 bytes of remaining length and
+ * the topic name length, followed by the 2 byte packet ID. With MQTT 5, the
+ * PUBLISH properties are written and copied after the packet ID.
+ */
+    #if defined( MQTT_VERSION_5_ENABLED ) && ( MQTT_VERSION_5_ENABLED != 0 )
+        #define MQTT_AGENT_PUBLISH_VECTOR_MAX_COUNT    ( 5U )
+        #define MQTT_AGENT_PUBLISH_COPY_MAX_SIZE       ( 9U + MQTT_PUBLISH_PROPERTIES_MAX_SIZE )
+    #else
+        #define MQTT_AGENT_PUBLISH_VECTOR_MAX_COUNT    ( 4U )
+        #define MQTT_AGENT_PUBLISH_COPY_MAX_SIZE       ( 9U )
+    #endif
+
+/**
+ * @ingroup mqtt_agent_struct_types
+ * @brief PUBLISH packets gathered by the agent to be written to the transport
+ * in one call.
+ *
+ * @note The serialized header, packet ID and MQTT 5 properties of each PUBLISH
+ * are copied to the batch, while its topic name and payload are referenced in
+ * place.
+ */
+    typedef struct MQTTAgentPublishBatch
+    {
+        TransportInterface_t transportInterface;                                                                    /**< Transport interface the batch is written to. */
+        const MQTTPublishInfo_t * pPublishInfo;                                                                     /**< PUBLISH currently being added to the batch. */
+        TransportOutVector_t ioVectors[ MQTT_AGENT_PUBLISH_BATCH_MAX_COUNT * MQTT_AGENT_PUBLISH_VECTOR_MAX_COUNT ]; /**< Vectors of the batched packets. */
+        uint8_t headers[ MQTT_AGENT_PUBLISH_BATCH_MAX_COUNT * MQTT_AGENT_PUBLISH_COPY_MAX_SIZE ];                   /**< Copies of the serialized headers, packet IDs and properties. */
+        MQTTAgentCommand_t * pCommands[ MQTT_AGENT_PUBLISH_BATCH_MAX_COUNT ];                                       /**< Commands to conclude once the batch is written. */
+        size_t ioVectorCount;                                                                                       /**< Number of used elements of ioVectors. */
+        size_t headersLength;                                                                                       /**< Number of used bytes of headers. */
+        size_t commandCount;                                                                                        /**< Number of used elements of pCommands. */
+        size_t publishCount;                                                                                        /**< Number of PUBLISH packets in the batch. */
+        size_t byteCount;                                                                                           /**< Number of bytes in the batch. */
+        MQTTAgentPublishBatchStats_t stats;                                                                         /**< Statistics of written batches. */
+    } MQTTAgentPublishBatch_t;
+
+#endif /* if ( MQTT_AGENT_PUBLISH_BATCH_MAX_COUNT > 1U ) */
+
 /**
  * @ingroup mqtt_agent_callback_types
  * @brief Callback function called when receiving a publish.
@@ -157,6 +215,9 @@ typedef struct MQTTAgentContext
     MQTTAgentIncomingPublishCallback_t pIncomingCallback;               /**< Callback to invoke for incoming publishes. */
     void * pIncomingCallbackContext;                                    /**< Context for incoming publish callback. */
     bool packetReceivedInLoop;                                          /**< Whether a MQTT_ProcessLoop() call received a packet. */
+    #if ( MQTT_AGENT_PUBLISH_BATCH_MAX_COUNT > 1U )
+        MQTTAgentPublishBatch_t publishBatch;                           /**< PUBLISH packets to write to the transport together. */
+    #endif
 } MQTTAgentContext_t;
 
 /**
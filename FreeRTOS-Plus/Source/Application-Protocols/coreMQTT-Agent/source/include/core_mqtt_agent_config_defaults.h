@@ -110,6 +110,56 @@
     #define MQTT_AGENT_USE_QOS_1_2_PUBLISH    ( 1 )
 #endif
 
+/**
+ * @brief The maximum number of queued PUBLISH commands the agent writes to the
+ * transport in a single call.
+ *
+ * @note When this is greater than 1 and the transport interface implements
+ * `writev`, the agent task drains consecutive PUBLISH commands from its
+ * command queue and sends them with one vectored write, instead of one write
+ * per PUBLISH. Topic names and payloads are not copied. Completion callbacks
+ * of QoS 0 publishes are invoked once the batch has been written, and
+ * MQTT_ProcessLoop() is called once per batch rather than once per PUBLISH.
+ * Each unit adds about 50 bytes to #MQTTAgentContext_t on a 32-bit target.
+ *
+ * <b>Possible values:</b> Any positive integer up to UINT16_MAX. <br>
+ * <b>Default value:</b> `1` (publishes are not batched)
+ */
+#ifndef MQTT_AGENT_PUBLISH_BATCH_MAX_COUNT
+    #define MQTT_AGENT_PUBLISH_BATCH_MAX_COUNT    ( 1U )
+#endif
+
+/**
+ * @brief The number of bytes after which the agent stops adding PUBLISH
+ * commands to a batch.
+ *
+ * @note A PUBLISH larger than this on its own is still sent, in a batch of
+ * one. Only used when #MQTT_AGENT_PUBLISH_BATCH_MAX_COUNT is greater than 1.
+ *
+ * <b>Possible values:</b> Any positive integer up to INT32_MAX. <br>
+ * <b>Default value:</b> `1460`
+ */
+#ifndef MQTT_AGENT_PUBLISH_BATCH_MAX_BYTES
+    #define MQTT_AGENT_PUBLISH_BATCH_MAX_BYTES    ( 1460U )
+#endif
+
+/**
+ * @brief Time in milliseconds that the MQTT agent task waits for another
+ * PUBLISH command to add to a batch, measured from the first PUBLISH of the
+ * batch.
+ *
+ * @note With the default of 0 the agent only batches the PUBLISH commands
+ * that are already queued, and so adds no latency. A larger value trades
+ * latency for fewer transport writes when publishes arrive spread out. Only
+ * used when #MQTT_AGENT_PUBLISH_BATCH_MAX_COUNT is greater than 1.
+ *
+ * <b>Possible values:</b> Any positive 32 bit integer. <br>
+ * <b>Default value:</b> `0`
+ */
+#ifndef MQTT_AGENT_PUBLISH_BATCH_WAIT_TIME_MS
+    #define MQTT_AGENT_PUBLISH_BATCH_WAIT_TIME_MS    ( 0U )
+#endif
+
 /* *INDENT-OFF* */
 #ifdef __cplusplus
     }
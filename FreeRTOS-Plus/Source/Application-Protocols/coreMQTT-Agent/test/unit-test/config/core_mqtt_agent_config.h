@@ -1,2 +1,5 @@
-/* An empty config file for the unit test to compile with the default
- * definitions of configuration macros. */
+/* A config file for the unit test to compile with the default definitions of
+ * configuration macros, except for those set below. */
+
+/* Build the PUBLISH batching so that it is covered by the tests. */
+#define MQTT_AGENT_PUBLISH_BATCH_MAX_COUNT    ( 4U )
@@ -0,0 +1,401 @@
+/*
+ * coreMQTT Agent v1.2.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file mqtt_agent_benchmark.c
+ * @brief Host benchmark for the PUBLISH batching of the agent.
+ *
+ * The benchmark runs the agent and coreMQTT without mocks, with a transport
+ * that writes to /dev/null so that every transport call is a system call. It
+ * checks that every PUBLISH is written and concluded, then prints the timings.
+ * The timings are not asserted, so that the test passes on any host; build
+ * with optimization to get meaningful numbers.
+ *
+ * The PUBLISH commands are batched only with the writev transport. Build with
+ * MQTT_AGENT_PUBLISH_BATCH_MAX_COUNT set to 1 to time the same transport
+ * without batching.
+ */
+#include <string.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+#include "unity.h"
+
+#include "core_mqtt_agent.h"
+
+/**
+ * @brief Number of QoS 0 PUBLISH commands queued before each run of the
+ * command loop.
+ */
+#define PUBLISH_PER_ROUND         ( 16U )
+
+/**
+ * @brief Number of times the commands are queued and the command loop run.
+ */
+#define BENCHMARK_ROUNDS          ( 20000U )
+
+/**
+ * @brief Size of the payload of each PUBLISH.
+ */
+#define PAYLOAD_LENGTH            ( 64U )
+
+/**
+ * @brief Largest number of vectors the transport writes with one call.
+ */
+#define TRANSPORT_VECTOR_COUNT    ( 64U )
+
+/**
+ * @brief The agent messaging context, a queue of the commands of one round.
+ */
+struct MQTTAgentMessageContext
+{
+    MQTTAgentCommand_t * pCommands[ PUBLISH_PER_ROUND + 1U ]; /**< Commands sent to the agent. */
+    size_t sentCount;                                         /**< Number of commands sent. */
+    size_t receivedCount;                                     /**< Number of commands received. */
+};
+
+/**
+ * @brief The network context of the transport, which counts the calls made
+ * to it.
+ */
+struct NetworkContext
+{
+    int fd;                  /**< Descriptor of /dev/null. */
+    size_t sendCallCount;    /**< Number of calls to the transport send. */
+    size_t writevCallCount;  /**< Number of calls to the transport writev. */
+    size_t bytesWritten;     /**< Number of bytes written. */
+};
+
+static MQTTAgentContext_t agentContext;
+static MQTTAgentMessageContext_t messageContext;
+static NetworkContext_t networkContext;
+static MQTTAgentCommand_t commandPool[ PUBLISH_PER_ROUND + 1U ];
+static MQTTAgentCommand_t * pFreeCommands[ PUBLISH_PER_ROUND + 1U ];
+static size_t freeCommandCount;
+static MQTTPublishInfo_t publishInfo[ PUBLISH_PER_ROUND ];
+static char topics[ PUBLISH_PER_ROUND ][ 16 ];
+static uint8_t networkBuffer[ 256 ];
+static const uint8_t payload[ PAYLOAD_LENGTH ] = { 0 };
+static size_t commandCompleteCallbackCount;
+
+/* ============================   UNITY FIXTURES ============================ */
+
+/* Called before each test method. */
+void setUp()
+{
+    size_t i;
+
+    ( void ) memset( &messageContext, 0x00, sizeof( messageContext ) );
+    ( void ) memset( &networkContext, 0x00, sizeof( networkContext ) );
+    networkContext.fd = open( "/dev/null", O_WRONLY );
+    TEST_ASSERT_TRUE( networkContext.fd >= 0 );
+
+    for( i = 0; i < ( PUBLISH_PER_ROUND + 1U ); i++ )
+    {
+        pFreeCommands[ i ] = &commandPool[ i ];
+    }
+
+    freeCommandCount = PUBLISH_PER_ROUND + 1U;
+    commandCompleteCallbackCount = 0U;
+}
+
+/* Called after each test method. */
+void tearDown()
+{
+    ( void ) close( networkContext.fd );
+}
+
+/* Called at the beginning of the whole suite. */
+void suiteSetUp()
+{
+}
+
+/* Called at the end of the whole suite. */
+int suiteTearDown( int numFailures )
+{
+    return numFailures;
+}
+
+/* ========================================================================== */
+
+static bool stubSend( MQTTAgentMessageContext_t * pMsgCtx,
+                      MQTTAgentCommand_t * const * pCommandToSend,
+                      uint32_t blockTimeMs )
+{
+    ( void ) blockTimeMs;
+
+    TEST_ASSERT_LESS_THAN( PUBLISH_PER_ROUND + 1U, pMsgCtx->sentCount );
+    pMsgCtx->pCommands[ pMsgCtx->sentCount ] = *pCommandToSend;
+    pMsgCtx->sentCount++;
+
+    return true;
+}
+
+static bool stubReceive( MQTTAgentMessageContext_t * pMsgCtx,
+                         MQTTAgentCommand_t ** pReceivedCommand,
+                         uint32_t blockTimeMs )
+{
+    bool received = false;
+
+    ( void ) blockTimeMs;
+
+    if( pMsgCtx->receivedCount < pMsgCtx->sentCount )
+    {
+        *pReceivedCommand = pMsgCtx->pCommands[ pMsgCtx->receivedCount ];
+        pMsgCtx->receivedCount++;
+        received = true;
+    }
+
+    return received;
+}
+
+static MQTTAgentCommand_t * stubGetCommand( uint32_t blockTimeMs )
+{
+    MQTTAgentCommand_t * pCommand = NULL;
+
+    ( void ) blockTimeMs;
+
+    if( freeCommandCount > 0U )
+    {
+        freeCommandCount--;
+        pCommand = pFreeCommands[ freeCommandCount ];
+    }
+
+    return pCommand;
+}
+
+static bool stubReleaseCommand( MQTTAgentCommand_t * pCommandToRelease )
+{
+    pFreeCommands[ freeCommandCount ] = pCommandToRelease;
+    freeCommandCount++;
+
+    return true;
+}
+
+static int32_t stubTransportSend( NetworkContext_t * pNetworkContext,
+                                  const void * pBuffer,
+                                  size_t bytesToSend )
+{
+    ssize_t bytesSent;
+
+    pNetworkContext->sendCallCount++;
+    bytesSent = write( pNetworkContext->fd, pBuffer, bytesToSend );
+    pNetworkContext->bytesWritten += ( size_t ) bytesSent;
+
+    return ( int32_t ) bytesSent;
+}
+
+static int32_t stubTransportWritev( NetworkContext_t * pNetworkContext,
+                                    TransportOutVector_t * pIoVec,
+                                    size_t ioVecCount )
+{
+    struct iovec ioVec[ TRANSPORT_VECTOR_COUNT ];
+    ssize_t bytesSent;
+    size_t i;
+
+    TEST_ASSERT_LESS_OR_EQUAL( TRANSPORT_VECTOR_COUNT, ioVecCount );
+
+    for( i = 0; i < ioVecCount; i++ )
+    {
+        ioVec[ i ].iov_base = ( void * ) pIoVec[ i ].iov_base;
+        ioVec[ i ].iov_len = pIoVec[ i ].iov_len;
+    }
+
+    pNetworkContext->writevCallCount++;
+    bytesSent = writev( pNetworkContext->fd, ioVec, ( int ) ioVecCount );
+    pNetworkContext->bytesWritten += ( size_t ) bytesSent;
+
+    return ( int32_t ) bytesSent;
+}
+
+static int32_t stubTransportRecv( NetworkContext_t * pNetworkContext,
+                                  void * pBuffer,
+                                  size_t bytesToRecv )
+{
+    ( void ) pNetworkContext;
+    ( void ) pBuffer;
+    ( void ) bytesToRecv;
+
+    return 0;
+}
+
+static uint32_t stubGetTime( void )
+{
+    return 0U;
+}
+
+static void stubPublishCallback( MQTTAgentContext_t * pMqttAgentContext,
+                                 uint16_t packetId,
+                                 MQTTPublishInfo_t * pPublishInfo )
+{
+    ( void ) pMqttAgentContext;
+    ( void ) packetId;
+    ( void ) pPublishInfo;
+}
+
+static void stubCompletionCallback( MQTTAgentCommandContext_t * pCommandCompletionContext,
+                                    MQTTAgentReturnInfo_t * pReturnInfo )
+{
+    ( void ) pCommandCompletionContext;
+
+    TEST_ASSERT_EQUAL( MQTTSuccess, pReturnInfo->returnCode );
+    commandCompleteCallbackCount++;
+}
+
+/**
+ * @brief Initialize the agent as connected.
+ *
+ * @param[in] useWritev Whether the transport implements writev, so that the
+ * PUBLISH commands are batched.
+ */
+static void setupAgent( bool useWritev )
+{
+    MQTTAgentMessageInterface_t messageInterface = { 0 };
+    TransportInterface_t transport = { 0 };
+    MQTTFixedBuffer_t fixedBuffer = { networkBuffer, sizeof( networkBuffer ) };
+    MQTTStatus_t mqttStatus;
+    size_t i;
+
+    messageInterface.pMsgCtx = &messageContext;
+    messageInterface.send = stubSend;
+    messageInterface.recv = stubReceive;
+    messageInterface.getCommand = stubGetCommand;
+    messageInterface.releaseCommand = stubReleaseCommand;
+
+    transport.pNetworkContext = &networkContext;
+    transport.send = stubTransportSend;
+    transport.recv = stubTransportRecv;
+    transport.writev = useWritev ? stubTransportWritev : NULL;
+
+    mqttStatus = MQTTAgent_Init( &agentContext,
+                                 &messageInterface,
+                                 &fixedBuffer,
+                                 &transport,
+                                 stubGetTime,
+                                 stubPublishCallback,
+                                 NULL );
+    TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
+
+    agentContext.mqttContext.connectStatus = MQTTConnected;
+
+    for( i = 0; i < PUBLISH_PER_ROUND; i++ )
+    {
+        ( void ) sprintf( topics[ i ], "dev/%02u/t", ( unsigned ) i );
+        ( void ) memset( &publishInfo[ i ], 0x00, sizeof( MQTTPublishInfo_t ) );
+        publishInfo[ i ].qos = MQTTQoS0;
+        publishInfo[ i ].pTopicName = topics[ i ];
+        publishInfo[ i ].topicNameLength = ( uint16_t ) strlen( topics[ i ] );
+        publishInfo[ i ].pPayload = payload;
+        publishInfo[ i ].payloadLength = PAYLOAD_LENGTH;
+    }
+}
+
+/**
+ * @brief Queue a round of PUBLISH commands followed by a terminate command,
+ * and run the command loop until it terminates.
+ */
+static void runRound( void )
+{
+    MQTTAgentCommandInfo_t commandInfo = { 0 };
+    MQTTStatus_t mqttStatus;
+    size_t i;
+
+    messageContext.sentCount = 0U;
+    messageContext.receivedCount = 0U;
+    commandInfo.cmdCompleteCallback = stubCompletionCallback;
+
+    for( i = 0; i < PUBLISH_PER_ROUND; i++ )
+    {
+        mqttStatus = MQTTAgent_Publish( &agentContext, &publishInfo[ i ], &commandInfo );
+        TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
+    }
+
+    commandInfo.cmdCompleteCallback = NULL;
+    mqttStatus = MQTTAgent_Terminate( &agentContext, &commandInfo );
+    TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
+
+    mqttStatus = MQTTAgent_CommandLoop( &agentContext );
+    TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
+}
+
+/**
+ * @brief Time the rounds of PUBLISH commands and print the results.
+ *
+ * @param[in] useWritev Whether the transport implements writev.
+ */
+static void benchmarkPublishes( bool useWritev )
+{
+    size_t round;
+    clock_t start;
+    double publishesPerSecond;
+    char message[ 200 ];
+
+    setupAgent( useWritev );
+    start = clock();
+
+    for( round = 0; round < BENCHMARK_ROUNDS; round++ )
+    {
+        runRound();
+    }
+
+    publishesPerSecond = ( ( double ) BENCHMARK_ROUNDS * PUBLISH_PER_ROUND * CLOCKS_PER_SEC ) /
+                         ( double ) ( clock() - start );
+
+    /* Every PUBLISH is written and concluded. Each has a 2 byte fixed header
+     * and an 8 byte topic name. */
+    TEST_ASSERT_EQUAL( BENCHMARK_ROUNDS * PUBLISH_PER_ROUND, commandCompleteCallbackCount );
+    TEST_ASSERT_EQUAL( BENCHMARK_ROUNDS * PUBLISH_PER_ROUND * ( 2U + 2U + 8U + PAYLOAD_LENGTH ),
+                       networkContext.bytesWritten );
+
+    ( void ) sprintf( message,
+                      "%s, batches of up to %u: %.0f publishes/s, %.2f transport calls per publish",
+                      useWritev ? "writev" : "send",
+                      ( unsigned ) MQTT_AGENT_PUBLISH_BATCH_MAX_COUNT,
+                      publishesPerSecond,
+                      ( double ) ( networkContext.sendCallCount + networkContext.writevCallCount ) /
+                      ( ( double ) BENCHMARK_ROUNDS * PUBLISH_PER_ROUND ) );
+    TEST_MESSAGE( message );
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Measure queued QoS 0 PUBLISH commands written with one transport
+ * send call per packet vector.
+ */
+void test_MQTTAgent_Benchmark_Publish_send( void )
+{
+    benchmarkPublishes( false );
+}
+
+/**
+ * @brief Measure queued QoS 0 PUBLISH commands written with the transport
+ * writev, batched when MQTT_AGENT_PUBLISH_BATCH_MAX_COUNT is greater than 1.
+ */
+void test_MQTTAgent_Benchmark_Publish_writev( void )
+{
+    benchmarkPublishes( true );
+}
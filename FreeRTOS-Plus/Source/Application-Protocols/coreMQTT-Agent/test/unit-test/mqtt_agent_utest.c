@@ -103,6 +103,46 @@ static uint32_t receiveCounter;
  */
 static MQTTAgentCommandFuncReturns_t returnFlags;
 
+/**
+ * @brief Commands returned in order by stubReceiveFromList.
+ */
+static MQTTAgentCommand_t * pCommandList[ 8 ];
+
+/**
+ * @brief Number of commands in #pCommandList.
+ */
+static size_t commandListLength;
+
+/**
+ * @brief Index of the next command stubReceiveFromList returns.
+ */
+static size_t commandListIndex;
+
+/**
+ * @brief Bytes written by stubWritev.
+ */
+static uint8_t writtenBytes[ 8192 ];
+
+/**
+ * @brief Number of bytes in #writtenBytes.
+ */
+static size_t writtenLength;
+
+/**
+ * @brief The number of times stubWritev is called.
+ */
+static uint32_t writevCallCount;
+
+/**
+ * @brief The most bytes stubWritev writes in one call, or 0 for no limit.
+ */
+static size_t writevMaxBytes;
+
+/**
+ * @brief Whether stubWritev returns a network error.
+ */
+static bool writevFails;
+
 /* ============================   UNITY FIXTURES ============================ */
 
 /* Called before each test method. */
@@ -119,6 +159,12 @@ void setUp()
     returnFlags.addAcknowledgment = false;
     returnFlags.runProcessLoop = false;
     returnFlags.endLoop = false;
+    commandListLength = 0;
+    commandListIndex = 0;
+    writtenLength = 0;
+    writevCallCount = 0;
+    writevMaxBytes = 0;
+    writevFails = false;
 }
 
 /* Called after each test method. */
@@ -197,6 +243,29 @@ static bool stubReceiveThenFail( MQTTAgentMessageContext_t * pMsgCtx,
     return ret;
 }
 
+/**
+ * @brief A mocked receive function for the agent to receive the commands of
+ * #pCommandList in order.
+ */
+static bool stubReceiveFromList( MQTTAgentMessageContext_t * pMsgCtx,
+                                 MQTTAgentCommand_t ** pReceivedCommand,
+                                 uint32_t blockTimeMs )
+{
+    bool ret = false;
+
+    ( void ) pMsgCtx;
+    ( void ) blockTimeMs;
+
+    if( commandListIndex < commandListLength )
+    {
+        *pReceivedCommand = pCommandList[ commandListIndex ];
+        commandListIndex++;
+        ret = true;
+    }
+
+    return ret;
+}
+
 /**
  * @brief A mocked function to obtain an allocated command.
  */
@@ -249,6 +318,116 @@ static uint32_t stubGetTime( void )
     return globalEntryTime++;
 }
 
+/**
+ * @brief A mocked transport writev function that records the bytes written.
+ */
+static int32_t stubWritev( NetworkContext_t * pNetworkContext,
+                           TransportOutVector_t * pIoVec,
+                           size_t ioVecCount )
+{
+    int32_t bytesWritten = 0;
+    size_t length;
+    size_t i;
+
+    ( void ) pNetworkContext;
+
+    writevCallCount++;
+
+    if( writevFails == true )
+    {
+        bytesWritten = -1;
+    }
+    else
+    {
+        for( i = 0; i < ioVecCount; i++ )
+        {
+            length = pIoVec[ i ].iov_len;
+
+            if( ( writevMaxBytes != 0U ) && ( ( ( size_t ) bytesWritten + length ) > writevMaxBytes ) )
+            {
+                length = writevMaxBytes - ( size_t ) bytesWritten;
+            }
+
+            TEST_ASSERT_LESS_OR_EQUAL( sizeof( writtenBytes ), writtenLength + length );
+            ( void ) memcpy( &writtenBytes[ writtenLength ], pIoVec[ i ].iov_base, length );
+            writtenLength += length;
+            bytesWritten += ( int32_t ) length;
+        }
+    }
+
+    return bytesWritten;
+}
+
+/**
+ * @brief A stub for MQTTAgentCommand_Publish that writes a PUBLISH packet made
+ * of a two byte header, the topic name and the payload to the transport, as
+ * MQTT_Publish() does.
+ */
+static MQTTStatus_t MQTTAgentCommand_Publish_WritevStub( MQTTAgentContext_t * pMqttAgentContext,
+                                                         void * pPublishArg,
+                                                         MQTTAgentCommandFuncReturns_t * pReturnFlags,
+                                                         int numCalls )
+{
+    const MQTTPublishInfo_t * pPublishInfo = ( const MQTTPublishInfo_t * ) pPublishArg;
+    const TransportInterface_t * pTransport = &( pMqttAgentContext->mqttContext.transportInterface );
+    uint8_t header[ 2 ];
+    TransportOutVector_t ioVec[ 3 ];
+    size_t bytesToSend;
+    MQTTStatus_t status = MQTTSuccess;
+
+    ( void ) numCalls;
+
+    header[ 0 ] = MQTT_PACKET_TYPE_PUBLISH;
+    header[ 1 ] = ( uint8_t ) ( pPublishInfo->topicNameLength + pPublishInfo->payloadLength );
+    ioVec[ 0 ].iov_base = header;
+    ioVec[ 0 ].iov_len = sizeof( header );
+    ioVec[ 1 ].iov_base = pPublishInfo->pTopicName;
+    ioVec[ 1 ].iov_len = pPublishInfo->topicNameLength;
+    ioVec[ 2 ].iov_base = pPublishInfo->pPayload;
+    ioVec[ 2 ].iov_len = pPublishInfo->payloadLength;
+    bytesToSend = sizeof( header ) + pPublishInfo->topicNameLength + pPublishInfo->payloadLength;
+
+    if( pTransport->writev( pTransport->pNetworkContext, ioVec, 3U ) != ( int32_t ) bytesToSend )
+    {
+        status = MQTTSendFailed;
+    }
+
+    *pReturnFlags = returnFlags;
+
+    return status;
+}
+
+/**
+ * @brief A stub for MQTTAgentCommand_Publish that writes the first PUBLISH as
+ * MQTTAgentCommand_Publish_WritevStub() does, and then sends a header too
+ * large to be copied into a PUBLISH batch.
+ */
+static MQTTStatus_t MQTTAgentCommand_Publish_LargeHeaderStub( MQTTAgentContext_t * pMqttAgentContext,
+                                                              void * pPublishArg,
+                                                              MQTTAgentCommandFuncReturns_t * pReturnFlags,
+                                                              int numCalls )
+{
+    const TransportInterface_t * pTransport = &( pMqttAgentContext->mqttContext.transportInterface );
+    uint8_t header[ sizeof( pMqttAgentContext->publishBatch.headers ) + 1U ] = { 0 };
+    MQTTStatus_t status = MQTTSuccess;
+
+    if( numCalls == 0 )
+    {
+        status = MQTTAgentCommand_Publish_WritevStub( pMqttAgentContext, pPublishArg, pReturnFlags, numCalls );
+    }
+    else
+    {
+        if( pTransport->send( pTransport->pNetworkContext, header, sizeof( header ) ) < 0 )
+        {
+            status = MQTTSendFailed;
+        }
+
+        *pReturnFlags = returnFlags;
+    }
+
+    return status;
+}
+
 /**
  * @brief A stub for MQTT_Init function to be used to initialize the event callback.
  */
@@ -1827,6 +2006,211 @@ void test_MQTTAgent_CommandLoop_failure_executing_second_command( void )
     TEST_ASSERT_EQUAL( 2, commandCompleteCallbackCount );
 }
 
+/**
+ * @brief Helper function to set up an agent context whose transport
+ * implements writev, so that PUBLISH commands are batched.
+ *
+ * @param[in] pAgentContext Agent context to set up.
+ * @param[in] pCommands PUBLISH commands to set up.
+ * @param[in] pPublishInfo Publish info to use for each command.
+ * @param[in] publishCount Number of PUBLISH commands.
+ * @param[in] payloadLength Payload length of each PUBLISH.
+ */
+static void setupPublishBatch( MQTTAgentContext_t * pAgentContext,
+                               MQTTAgentCommand_t * pCommands,
+                               MQTTPublishInfo_t * pPublishInfo,
+                               size_t publishCount,
+                               size_t payloadLength )
+{
+    static const uint8_t payload[ 700 ] = { 0 };
+    size_t i;
+
+    TEST_ASSERT_LESS_OR_EQUAL( sizeof( payload ), payloadLength );
+    TEST_ASSERT_LESS_OR_EQUAL( sizeof( pCommandList ) / sizeof( pCommandList[ 0 ] ), publishCount );
+
+    setupAgentContext( pAgentContext );
+    pAgentContext->mqttContext.connectStatus = MQTTConnected;
+    pAgentContext->mqttContext.transportInterface.writev = stubWritev;
+    pAgentContext->agentInterface.recv = stubReceiveFromList;
+
+    for( i = 0; i < publishCount; i++ )
+    {
+        ( void ) memset( &pPublishInfo[ i ], 0x00, sizeof( MQTTPublishInfo_t ) );
+        pPublishInfo[ i ].pTopicName = "topic";
+        pPublishInfo[ i ].topicNameLength = 5U;
+        pPublishInfo[ i ].pPayload = payload;
+        pPublishInfo[ i ].payloadLength = payloadLength;
+
+        ( void ) memset( &pCommands[ i ], 0x00, sizeof( MQTTAgentCommand_t ) );
+        pCommands[ i ].commandType = PUBLISH;
+        pCommands[ i ].pCommandCompleteCallback = stubCompletionCallback;
+        pCommands[ i ].pArgs = &pPublishInfo[ i ];
+
+        pCommandList[ i ] = &pCommands[ i ];
+    }
+
+    commandListLength = publishCount;
+}
+
+/**
+ * @brief Test that MQTTAgent_CommandLoop writes queued PUBLISH commands to the
+ * transport with a single call, and concludes them after the write.
+ */
+void test_MQTTAgent_CommandLoop_publish_batch( void )
+{
+    MQTTStatus_t mqttStatus;
+    MQTTAgentContext_t mqttAgentContext;
+    MQTTAgentCommand_t commands[ 4 ];
+    MQTTPublishInfo_t publishInfo[ 4 ];
+    MQTTAgentCommand_t pingCommand = { 0 };
+    MQTTAgentCommandFuncReturns_t pingReturnFlags = { 0 };
+
+    setupPublishBatch( &mqttAgentContext, commands, publishInfo, 3U, 10U );
+
+    /* A PING ends the batch, and then the loop. */
+    pingCommand.commandType = PING;
+    pingCommand.pCommandCompleteCallback = stubCompletionCallback;
+    pCommandList[ commandListLength ] = &pingCommand;
+    commandListLength++;
+    pingReturnFlags.endLoop = true;
+
+    returnFlags.runProcessLoop = true;
+    MQTTAgentCommand_Publish_Stub( MQTTAgentCommand_Publish_WritevStub );
+    MQTT_ProcessLoop_ExpectAnyArgsAndReturn( MQTTSuccess );
+    MQTTAgentCommand_Ping_ExpectAnyArgsAndReturn( MQTTSuccess );
+    MQTTAgentCommand_Ping_ReturnThruPtr_pReturnFlags( &pingReturnFlags );
+
+    mqttStatus = MQTTAgent_CommandLoop( &mqttAgentContext );
+
+    TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
+    TEST_ASSERT_EQUAL( 1, writevCallCount );
+    TEST_ASSERT_EQUAL( 3U * 17U, writtenLength );
+    TEST_ASSERT_EQUAL( MQTT_PACKET_TYPE_PUBLISH, writtenBytes[ 17 ] );
+    TEST_ASSERT_EQUAL_MEMORY( "topic", &writtenBytes[ 36 ], 5U );
+    TEST_ASSERT_EQUAL( 4, commandCompleteCallbackCount );
+
+    /* The transport is restored after the batch. */
+    TEST_ASSERT_EQUAL_PTR( stubWritev, mqttAgentContext.mqttContext.transportInterface.writev );
+    TEST_ASSERT_NULL( mqttAgentContext.mqttContext.transportInterface.pNetworkContext );
+
+    TEST_ASSERT_EQUAL( 1, mqttAgentContext.publishBatch.stats.batchCount );
+    TEST_ASSERT_EQUAL( 3, mqttAgentContext.publishBatch.stats.publishCount );
+    TEST_ASSERT_EQUAL( 3U * 17U, mqttAgentContext.publishBatch.stats.byteCount );
+    TEST_ASSERT_EQUAL( 1, mqttAgentContext.publishBatch.stats.writeCount );
+    TEST_ASSERT_EQUAL( 1, mqttAgentContext.publishBatch.stats.batchSizeCount[ 2 ] );
+}
+
+/**
+ * @brief Test that a batch is written when it reaches the maximum number of
+ * PUBLISH commands or bytes, and that partial writes are completed.
+ */
+void test_MQTTAgent_CommandLoop_publish_batch_limits( void )
+{
+    MQTTStatus_t mqttStatus;
+    MQTTAgentContext_t mqttAgentContext;
+    MQTTAgentCommand_t commands[ 7 ];
+    MQTTPublishInfo_t publishInfo[ 7 ];
+    MQTTAgentCommand_t pingCommand = { 0 };
+    MQTTAgentCommandFuncReturns_t pingReturnFlags = { 0 };
+
+    /* With the nine bytes reserved for each header, a third 707 byte PUBLISH
+     * packet exceeds the default limit of 1460 bytes, so batches hold two. */
+    setupPublishBatch( &mqttAgentContext, commands, publishInfo, 7U, 700U );
+    publishInfo[ 6 ].payloadLength = 1U;
+    writevMaxBytes = 500U;
+
+    pingCommand.commandType = PING;
+    pingCommand.pCommandCompleteCallback = stubCompletionCallback;
+    pCommandList[ commandListLength ] = &pingCommand;
+    commandListLength++;
+    pingReturnFlags.endLoop = true;
+
+    returnFlags.runProcessLoop = false;
+    MQTTAgentCommand_Publish_Stub( MQTTAgentCommand_Publish_WritevStub );
+    MQTTAgentCommand_Ping_ExpectAnyArgsAndReturn( MQTTSuccess );
+    MQTTAgentCommand_Ping_ReturnThruPtr_pReturnFlags( &pingReturnFlags );
+
+    mqttStatus = MQTTAgent_CommandLoop( &mqttAgentContext );
+
+    TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
+    TEST_ASSERT_EQUAL( 6U * 707U + 8U, writtenLength );
+    TEST_ASSERT_EQUAL( 8, commandCompleteCallbackCount );
+
+    /* The first batch call handles four commands and writes two batches of
+     * two. The second handles the last three, where the small PUBLISH still
+     * fits in the batch. Every batch takes three partial writes. */
+    TEST_ASSERT_EQUAL( 3, mqttAgentContext.publishBatch.stats.batchCount );
+    TEST_ASSERT_EQUAL( 2, mqttAgentContext.publishBatch.stats.batchSizeCount[ 1 ] );
+    TEST_ASSERT_EQUAL( 1, mqttAgentContext.publishBatch.stats.batchSizeCount[ 2 ] );
+    TEST_ASSERT_EQUAL( 9, writevCallCount );
+    TEST_ASSERT_EQUAL( writevCallCount, mqttAgentContext.publishBatch.stats.writeCount );
+}
+
+/**
+ * @brief Test that the commands of a batch are concluded with an error if the
+ * batch cannot be written.
+ */
+void test_MQTTAgent_CommandLoop_publish_batch_write_failure( void )
+{
+    MQTTStatus_t mqttStatus;
+    MQTTAgentContext_t mqttAgentContext;
+    MQTTAgentCommand_t commands[ 4 ];
+    MQTTPublishInfo_t publishInfo[ 4 ];
+    MQTTAgentCommandContext_t commandContext = { 0 };
+    MQTTAgentCommand_t pingCommand = { 0 };
+
+    setupPublishBatch( &mqttAgentContext, commands, publishInfo, 2U, 10U );
+    commands[ 1 ].pCmdContext = &commandContext;
+    pingCommand.commandType = PING;
+    pingCommand.pCommandCompleteCallback = stubCompletionCallback;
+    pCommandList[ commandListLength ] = &pingCommand;
+    commandListLength++;
+    writevFails = true;
+
+    returnFlags.runProcessLoop = true;
+    MQTTAgentCommand_Publish_Stub( MQTTAgentCommand_Publish_WritevStub );
+
+    mqttStatus = MQTTAgent_CommandLoop( &mqttAgentContext );
+
+    TEST_ASSERT_EQUAL( MQTTSendFailed, mqttStatus );
+    TEST_ASSERT_EQUAL( MQTTSendFailed, commandContext.returnStatus );
+
+    /* The PING that ended the batch is concluded without being executed. */
+    TEST_ASSERT_EQUAL( 3, commandCompleteCallbackCount );
+    TEST_ASSERT_EQUAL( 0, mqttAgentContext.publishBatch.stats.batchCount );
+    TEST_ASSERT_EQUAL_PTR( stubWritev, mqttAgentContext.mqttContext.transportInterface.writev );
+}
+
+/**
+ * @brief Test that a PUBLISH which does not fit in the batch fails without
+ * affecting the PUBLISH commands already in the batch.
+ */
+void test_MQTTAgent_CommandLoop_publish_batch_no_room( void )
+{
+    MQTTStatus_t mqttStatus;
+    MQTTAgentContext_t mqttAgentContext;
+    MQTTAgentCommand_t commands[ 4 ];
+    MQTTPublishInfo_t publishInfo[ 4 ];
+    MQTTAgentCommandContext_t commandContext = { 0 };
+
+    setupPublishBatch( &mqttAgentContext, commands, publishInfo, 2U, 10U );
+    commands[ 1 ].pCmdContext = &commandContext;
+
+    returnFlags.runProcessLoop = false;
+    MQTTAgentCommand_Publish_Stub( MQTTAgentCommand_Publish_LargeHeaderStub );
+
+    mqttStatus = MQTTAgent_CommandLoop( &mqttAgentContext );
+
+    TEST_ASSERT_EQUAL( MQTTSendFailed, mqttStatus );
+    TEST_ASSERT_EQUAL( MQTTSendFailed, commandContext.returnStatus );
+    TEST_ASSERT_EQUAL( 2, commandCompleteCallbackCount );
+
+    /* The first PUBLISH is written on its own. */
+    TEST_ASSERT_EQUAL( 1, writevCallCount );
+    TEST_ASSERT_EQUAL( 17U, writtenLength );
+    TEST_ASSERT_EQUAL( 1, mqttAgentContext.publishBatch.stats.batchSizeCount[ 0 ] );
+}
+
 void test_MQTTAgent_CancelAll( void )
 {
     MQTTAgentContext_t mqttAgentContext = { 0 };
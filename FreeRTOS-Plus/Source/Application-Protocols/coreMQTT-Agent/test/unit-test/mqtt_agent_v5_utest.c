@@ -0,0 +1,337 @@
+/*
+ * coreMQTT Agent v1.2.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file mqtt_agent_v5_utest.c
+ * @brief Unit tests for the PUBLISH batching of the agent with a coreMQTT
+ * built with MQTT_VERSION_5_ENABLED.
+ *
+ * The tests run the agent and coreMQTT without mocks, and record the bytes the
+ * agent writes to the transport.
+ */
+#include <string.h>
+#include <stdbool.h>
+
+#include "unity.h"
+
+#include "core_mqtt_agent.h"
+
+/**
+ * @brief Number of PUBLISH commands of each test, which fill a batch.
+ */
+#define PUBLISH_COUNT          ( MQTT_AGENT_PUBLISH_BATCH_MAX_COUNT )
+
+/**
+ * @brief Size of the buffer recording the bytes written to the transport.
+ */
+#define WRITTEN_BUFFER_SIZE    ( 1024U )
+
+/**
+ * @brief Size of the payload of each PUBLISH.
+ */
+#define PAYLOAD_LENGTH         ( 20U )
+
+/**
+ * @brief The agent messaging context.
+ */
+struct MQTTAgentMessageContext
+{
+    MQTTAgentCommand_t * pCommands[ PUBLISH_COUNT + 1U ]; /**< Commands sent to the agent. */
+    size_t sentCount;                                     /**< Number of commands sent. */
+    size_t receivedCount;                                 /**< Number of commands received. */
+};
+
+/**
+ * @brief The network context of the transport, which records the written
+ * bytes.
+ */
+struct NetworkContext
+{
+    uint8_t written[ WRITTEN_BUFFER_SIZE ]; /**< Bytes written to the transport. */
+    size_t writtenLength;                   /**< Number of bytes written. */
+    size_t writevCallCount;                 /**< Number of calls to the transport writev. */
+};
+
+static MQTTAgentContext_t agentContext;
+static MQTTAgentMessageContext_t messageContext;
+static NetworkContext_t networkContext;
+static MQTTAgentCommand_t commandPool[ PUBLISH_COUNT + 1U ];
+static size_t commandPoolUsed;
+static MQTTPublishInfo_t publishInfo[ PUBLISH_COUNT ];
+static uint8_t networkBuffer[ 256 ];
+static const uint8_t payload[ PAYLOAD_LENGTH ] = { 0 };
+static size_t commandCompleteCallbackCount;
+
+/* ============================   UNITY FIXTURES ============================ */
+
+/* Called before each test method. */
+void setUp()
+{
+    ( void ) memset( &messageContext, 0x00, sizeof( messageContext ) );
+    ( void ) memset( &networkContext, 0x00, sizeof( networkContext ) );
+    commandPoolUsed = 0U;
+    commandCompleteCallbackCount = 0U;
+}
+
+/* Called after each test method. */
+void tearDown()
+{
+}
+
+/* Called at the beginning of the whole suite. */
+void suiteSetUp()
+{
+}
+
+/* Called at the end of the whole suite. */
+int suiteTearDown( int numFailures )
+{
+    return numFailures;
+}
+
+/* ========================================================================== */
+
+static bool stubSend( MQTTAgentMessageContext_t * pMsgCtx,
+                      MQTTAgentCommand_t * const * pCommandToSend,
+                      uint32_t blockTimeMs )
+{
+    ( void ) blockTimeMs;
+
+    TEST_ASSERT_LESS_THAN( PUBLISH_COUNT + 1U, pMsgCtx->sentCount );
+    pMsgCtx->pCommands[ pMsgCtx->sentCount ] = *pCommandToSend;
+    pMsgCtx->sentCount++;
+
+    return true;
+}
+
+static bool stubReceive( MQTTAgentMessageContext_t * pMsgCtx,
+                         MQTTAgentCommand_t ** pReceivedCommand,
+                         uint32_t blockTimeMs )
+{
+    bool received = false;
+
+    ( void ) blockTimeMs;
+
+    if( pMsgCtx->receivedCount < pMsgCtx->sentCount )
+    {
+        *pReceivedCommand = pMsgCtx->pCommands[ pMsgCtx->receivedCount ];
+        pMsgCtx->receivedCount++;
+        received = true;
+    }
+
+    return received;
+}
+
+static MQTTAgentCommand_t * stubGetCommand( uint32_t blockTimeMs )
+{
+    MQTTAgentCommand_t * pCommand = NULL;
+
+    ( void ) blockTimeMs;
+
+    if( commandPoolUsed < ( sizeof( commandPool ) / sizeof( commandPool[ 0 ] ) ) )
+    {
+        pCommand = &commandPool[ commandPoolUsed ];
+        commandPoolUsed++;
+    }
+
+    return pCommand;
+}
+
+static bool stubReleaseCommand( MQTTAgentCommand_t * pCommandToRelease )
+{
+    ( void ) pCommandToRelease;
+
+    return true;
+}
+
+static int32_t stubTransportSend( NetworkContext_t * pNetworkContext,
+                                  const void * pBuffer,
+                                  size_t bytesToSend )
+{
+    TEST_ASSERT_LESS_OR_EQUAL( WRITTEN_BUFFER_SIZE - pNetworkContext->writtenLength, bytesToSend );
+    ( void ) memcpy( &( pNetworkContext->written[ pNetworkContext->writtenLength ] ), pBuffer, bytesToSend );
+    pNetworkContext->writtenLength += bytesToSend;
+
+    return ( int32_t ) bytesToSend;
+}
+
+static int32_t stubTransportWritev( NetworkContext_t * pNetworkContext,
+                                    TransportOutVector_t * pIoVec,
+                                    size_t ioVecCount )
+{
+    int32_t bytesWritten = 0;
+    size_t i;
+
+    pNetworkContext->writevCallCount++;
+
+    for( i = 0; i < ioVecCount; i++ )
+    {
+        bytesWritten += stubTransportSend( pNetworkContext, pIoVec[ i ].iov_base, pIoVec[ i ].iov_len );
+    }
+
+    return bytesWritten;
+}
+
+static int32_t stubTransportRecv( NetworkContext_t * pNetworkContext,
+                                  void * pBuffer,
+                                  size_t bytesToRecv )
+{
+    ( void ) pNetworkContext;
+    ( void ) pBuffer;
+    ( void ) bytesToRecv;
+
+    return 0;
+}
+
+static uint32_t stubGetTime( void )
+{
+    return 0U;
+}
+
+static void stubPublishCallback( MQTTAgentContext_t * pMqttAgentContext,
+                                 uint16_t packetId,
+                                 MQTTPublishInfo_t * pPublishInfo )
+{
+    ( void ) pMqttAgentContext;
+    ( void ) packetId;
+    ( void ) pPublishInfo;
+}
+
+static void stubCompletionCallback( MQTTAgentCommandContext_t * pCommandCompletionContext,
+                                    MQTTAgentReturnInfo_t * pReturnInfo )
+{
+    ( void ) pCommandCompletionContext;
+    ( void ) pReturnInfo;
+
+    commandCompleteCallbackCount++;
+}
+
+/**
+ * @brief Initialize the agent as connected to a server that accepts QoS 1 and
+ * topic aliases, and queue a batch of QoS 1 PUBLISH commands that each set up a
+ * topic alias. Each PUBLISH has the largest layout: a topic name, a packet ID
+ * and a topic alias property.
+ *
+ * @param[in] useWritev Whether the transport implements writev, so that the
+ * PUBLISH commands are batched.
+ */
+static void setupPublishes( bool useWritev )
+{
+    MQTTAgentMessageInterface_t messageInterface = { 0 };
+    TransportInterface_t transport = { 0 };
+    MQTTFixedBuffer_t fixedBuffer = { networkBuffer, sizeof( networkBuffer ) };
+    MQTTAgentCommandInfo_t commandInfo = { 0 };
+    MQTTStatus_t mqttStatus;
+    size_t i;
+
+    messageInterface.pMsgCtx = &messageContext;
+    messageInterface.send = stubSend;
+    messageInterface.recv = stubReceive;
+    messageInterface.getCommand = stubGetCommand;
+    messageInterface.releaseCommand = stubReleaseCommand;
+
+    transport.pNetworkContext = &networkContext;
+    transport.send = stubTransportSend;
+    transport.recv = stubTransportRecv;
+    transport.writev = useWritev ? stubTransportWritev : NULL;
+
+    mqttStatus = MQTTAgent_Init( &agentContext,
+                                 &messageInterface,
+                                 &fixedBuffer,
+                                 &transport,
+                                 stubGetTime,
+                                 stubPublishCallback,
+                                 NULL );
+    TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
+
+    agentContext.mqttContext.connectStatus = MQTTConnected;
+    agentContext.mqttContext.connackProperties.maximumQoS = MQTTQoS1;
+    agentContext.mqttContext.connackProperties.receiveMaximum = PUBLISH_COUNT;
+    agentContext.mqttContext.connackProperties.maximumPacketSize = WRITTEN_BUFFER_SIZE;
+    agentContext.mqttContext.connackProperties.topicAliasMaximum = PUBLISH_COUNT;
+    agentContext.mqttContext.sendQuota = PUBLISH_COUNT;
+
+    commandInfo.cmdCompleteCallback = stubCompletionCallback;
+
+    for( i = 0; i < PUBLISH_COUNT; i++ )
+    {
+        ( void ) memset( &publishInfo[ i ], 0x00, sizeof( MQTTPublishInfo_t ) );
+        publishInfo[ i ].qos = MQTTQoS1;
+        publishInfo[ i ].pTopicName = "topic";
+        publishInfo[ i ].topicNameLength = 5U;
+        publishInfo[ i ].pPayload = payload;
+        publishInfo[ i ].payloadLength = PAYLOAD_LENGTH;
+        publishInfo[ i ].topicAlias = ( uint16_t ) ( i + 1U );
+
+        mqttStatus = MQTTAgent_Publish( &agentContext, &publishInfo[ i ], &commandInfo );
+        TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
+    }
+
+    commandInfo.cmdCompleteCallback = NULL;
+    mqttStatus = MQTTAgent_Terminate( &agentContext, &commandInfo );
+    TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Test that a full batch of MQTT 5 PUBLISH packets with the largest
+ * layout fits in the batch and is written with one call, with the same bytes
+ * as when every PUBLISH is sent on its own.
+ *
+ * Each PUBLISH takes 5 vectors and 10 copied bytes, more than the 4 vectors and
+ * 9 bytes of an MQTT 3.1.1 PUBLISH.
+ */
+void test_MQTTAgent_CommandLoop_publish_batch_v5( void )
+{
+    MQTTStatus_t mqttStatus;
+    uint8_t unbatched[ WRITTEN_BUFFER_SIZE ];
+    size_t unbatchedLength;
+
+    /* Without writev, each PUBLISH is sent on its own. */
+    setupPublishes( false );
+    mqttStatus = MQTTAgent_CommandLoop( &agentContext );
+    TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
+    TEST_ASSERT_EQUAL( 0, agentContext.publishBatch.stats.batchCount );
+
+    /* Every PUBLISH carries the 4 bytes of the topic alias property. */
+    unbatchedLength = networkContext.writtenLength;
+    TEST_ASSERT_EQUAL( PUBLISH_COUNT * ( 2U + 2U + 5U + 2U + 4U + PAYLOAD_LENGTH ), unbatchedLength );
+    ( void ) memcpy( unbatched, networkContext.written, unbatchedLength );
+
+    setUp();
+    setupPublishes( true );
+    mqttStatus = MQTTAgent_CommandLoop( &agentContext );
+    TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
+
+    TEST_ASSERT_EQUAL( 1, networkContext.writevCallCount );
+    TEST_ASSERT_EQUAL( unbatchedLength, networkContext.writtenLength );
+    TEST_ASSERT_EQUAL_MEMORY( unbatched, networkContext.written, unbatchedLength );
+
+    TEST_ASSERT_EQUAL( 1, agentContext.publishBatch.stats.batchCount );
+    TEST_ASSERT_EQUAL( PUBLISH_COUNT, agentContext.publishBatch.stats.publishCount );
+    TEST_ASSERT_EQUAL( 1, agentContext.publishBatch.stats.batchSizeCount[ PUBLISH_COUNT - 1U ] );
+
+    /* The PUBLISH commands awaiting their PUBACK are concluded when the agent
+     * terminates. */
+    TEST_ASSERT_EQUAL( PUBLISH_COUNT, commandCompleteCallbackCount );
+}
@@ -341,6 +341,27 @@ static MQTTStatus_t handleIncomingPublish( MQTTContext_t * pContext,
 static MQTTStatus_t handlePublishAcks( MQTTContext_t * pContext,
                                        MQTTPacketInfo_t * pIncomingPacket );
 
+#if ( MQTT_VERSION_5_ENABLED != 0 )
+
+/**
+ * @brief Give back a unit of the MQTT 5 send quota when a QoS 1 or QoS 2
+ * publish completes, and drop the state record of a QoS 2 publish that the
+ * server refused in its PUBREC.
+ *
+ * @param[in] pContext MQTT Connection context.
+ * @param[in] packetId Packet identifier of the acknowledged publish.
+ * @param[in] ackType Type of the received acknowledgment.
+ * @param[in] reasonCode Reason code of the received acknowledgment.
+ *
+ * @return #MQTTSuccess, or #MQTTBadParameter if the state record could not be
+ * removed.
+ */
+    static MQTTStatus_t updateSendQuota( MQTTContext_t * pContext,
+                                         uint16_t packetId,
+                                         MQTTPubAckType_t ackType,
+                                         uint8_t reasonCode );
+#endif
+
 /**
  * @brief Handle received MQTT ack.
  *
@@ -399,12 +420,15 @@ static MQTTStatus_t validateSubscribeUnsubscribeParams( const MQTTContext_t * pC
  * @param[out] pSessionPresent Whether a previous session was present.
  * Only relevant if not establishing a clean session.
  *
+ * @note With #MQTT_VERSION_5_ENABLED, the reason code and properties of the
+ * CONNACK are stored in #MQTTContext_t.connackProperties.
+ *
  * @return #MQTTBadResponse if a bad response is received;
  * #MQTTNoDataAvailable if no data available for transport recv;
  * ##MQTTRecvFailed if transport recv failed;
  * #MQTTSuccess otherwise.
  */
-static MQTTStatus_t receiveConnack( const MQTTContext_t * pContext,
+static MQTTStatus_t receiveConnack( MQTTContext_t * pContext,
                                     uint32_t timeoutMs,
                                     bool cleanSession,
                                     MQTTPacketInfo_t * pIncomingPacket,
@@ -1474,6 +1498,10 @@ static MQTTStatus_t handleIncomingPublish( MQTTContext_t * pContext,
         deserializedInfo.pPublishInfo = &publishInfo;
         deserializedInfo.deserializationResult = status;
 
+        #if ( MQTT_VERSION_5_ENABLED != 0 )
+            deserializedInfo.reasonCode = 0U;
+        #endif
+
         /* Invoke application callback to hand the buffer over to application
          * before sending acks.
          * Application callback will be invoked for all publishes, except for
@@ -1496,6 +1524,46 @@ static MQTTStatus_t handleIncomingPublish( MQTTContext_t * pContext,
 
 /*-----------------------------------------------------------*/
 
+#if ( MQTT_VERSION_5_ENABLED != 0 )
+
+    static MQTTStatus_t updateSendQuota( MQTTContext_t * pContext,
+                                         uint16_t packetId,
+                                         MQTTPubAckType_t ackType,
+                                         uint8_t reasonCode )
+    {
+        MQTTStatus_t status = MQTTSuccess;
+        bool publishComplete = ( ackType == MQTTPuback ) || ( ackType == MQTTPubcomp );
+
+        assert( pContext != NULL );
+
+        if( ( ackType == MQTTPubrec ) && ( reasonCode >= MQTT_REASON_CODE_FAILURE ) )
+        {
+            LogWarn( ( "PUBREC for packet id %hu has reason code 0x%02x.",
+                       ( unsigned short ) packetId,
+                       ( unsigned int ) reasonCode ) );
+
+            MQTT_PRE_STATE_UPDATE_HOOK( pContext );
+
+            status = MQTT_RemoveStateRecord( pContext, packetId );
+
+            MQTT_POST_STATE_UPDATE_HOOK( pContext );
+
+            publishComplete = true;
+        }
+
+        if( ( publishComplete == true ) &&
+            ( pContext->sendQuota < pContext->connackProperties.receiveMaximum ) )
+        {
+            pContext->sendQuota++;
+        }
+
+        return status;
+    }
+
+/*-----------------------------------------------------------*/
+
+#endif /* if ( MQTT_VERSION_5_ENABLED != 0 ) */
+
 static MQTTStatus_t handlePublishAcks( MQTTContext_t * pContext,
                                        MQTTPacketInfo_t * pIncomingPacket )
 {
@@ -1506,6 +1574,10 @@ static MQTTStatus_t handlePublishAcks( MQTTContext_t * pContext,
     MQTTEventCallback_t appCallback;
     MQTTDeserializedInfo_t deserializedInfo;
 
+    #if ( MQTT_VERSION_5_ENABLED != 0 )
+        uint8_t reasonCode = 0U;
+    #endif
+
     assert( pContext != NULL );
     assert( pIncomingPacket != NULL );
     assert( pContext->appCallback != NULL );
@@ -1517,6 +1589,13 @@ static MQTTStatus_t handlePublishAcks( MQTTContext_t * pContext,
     LogInfo( ( "Ack packet deserialized with result: %s.",
                MQTT_Status_strerror( status ) ) );
 
+    #if ( MQTT_VERSION_5_ENABLED != 0 )
+        if( status == MQTTSuccess )
+        {
+            status = MQTT_GetReasonCode( pIncomingPacket, &reasonCode );
+        }
+    #endif
+
     if( status == MQTTSuccess )
     {
         MQTT_PRE_STATE_UPDATE_HOOK( pContext );
@@ -1543,6 +1622,20 @@ static MQTTStatus_t handlePublishAcks( MQTTContext_t * pContext,
         }
     }
 
+    #if ( MQTT_VERSION_5_ENABLED != 0 )
+        if( status == MQTTSuccess )
+        {
+            status = updateSendQuota( pContext, packetIdentifier, ackType, reasonCode );
+
+            /* A PUBREC with a failure reason code ends the QoS 2 flow, so no
+             * PUBREL is sent for it. */
+            if( ( ackType == MQTTPubrec ) && ( reasonCode >= MQTT_REASON_CODE_FAILURE ) )
+            {
+                publishRecordState = MQTTStateNull;
+            }
+        }
+    #endif
+
     if( status == MQTTSuccess )
     {
         /* Set fields of deserialized struct. */
@@ -1550,6 +1643,10 @@ static MQTTStatus_t handlePublishAcks( MQTTContext_t * pContext,
         deserializedInfo.deserializationResult = status;
         deserializedInfo.pPublishInfo = NULL;
 
+        #if ( MQTT_VERSION_5_ENABLED != 0 )
+            deserializedInfo.reasonCode = reasonCode;
+        #endif
+
         /* Invoke application callback to hand the buffer over to application
          * before sending acks. */
         appCallback( pContext, pIncomingPacket, &deserializedInfo );
@@ -1581,6 +1678,10 @@ static MQTTStatus_t handleIncomingAck( MQTTContext_t * pContext,
     bool invokeAppCallback = false;
     MQTTEventCallback_t appCallback = NULL;
 
+    #if ( MQTT_VERSION_5_ENABLED != 0 )
+        uint8_t reasonCode = 0U;
+    #endif
+
     assert( pContext != NULL );
     assert( pIncomingPacket != NULL );
     assert( pContext->appCallback != NULL );
@@ -1620,6 +1721,24 @@ static MQTTStatus_t handleIncomingAck( MQTTContext_t * pContext,
             invokeAppCallback = ( status == MQTTSuccess ) || ( status == MQTTServerRefused );
             break;
 
+        #if ( MQTT_VERSION_5_ENABLED != 0 )
+            case MQTT_PACKET_TYPE_DISCONNECT:
+                status = MQTT_DeserializeAck( pIncomingPacket, &packetIdentifier, NULL );
+
+                if( status == MQTTSuccess )
+                {
+                    /* The server closes the network connection after a
+                     * DISCONNECT, so the connection is over either way. */
+                    ( void ) MQTT_GetReasonCode( pIncomingPacket, &reasonCode );
+                    LogWarn( ( "Server sent DISCONNECT with reason code 0x%02x.",
+                               ( unsigned int ) reasonCode ) );
+                    pContext->connectStatus = MQTTNotConnected;
+                    invokeAppCallback = true;
+                }
+
+                break;
+        #endif
+
         default:
             /* Bad response from the server. */
             LogError( ( "Unexpected packet type from server: PacketType=%02x.",
@@ -1634,9 +1753,22 @@ static MQTTStatus_t handleIncomingAck( MQTTContext_t * pContext,
         deserializedInfo.packetIdentifier = packetIdentifier;
         deserializedInfo.deserializationResult = status;
         deserializedInfo.pPublishInfo = NULL;
+
+        #if ( MQTT_VERSION_5_ENABLED != 0 )
+            deserializedInfo.reasonCode = reasonCode;
+        #endif
+
         appCallback( pContext, pIncomingPacket, &deserializedInfo );
         /* In case a SUBACK indicated refusal, reset the status to continue the loop. */
         status = MQTTSuccess;
+
+        #if ( MQTT_VERSION_5_ENABLED != 0 )
+            /* A DISCONNECT from the server ends the receive loop. */
+            if( pIncomingPacket->type == MQTT_PACKET_TYPE_DISCONNECT )
+            {
+                status = MQTTServerRefused;
+            }
+        #endif
     }
 
     return status;
@@ -1877,7 +2009,8 @@ static MQTTStatus_t sendSubscribeWithoutCopy( MQTTContext_t * pContext,
                                               size_t remainingLength )
 {
     MQTTStatus_t status = MQTTSuccess;
-    uint8_t subscribeheader[ 7 ];
+    /* Fixed header, packet identifier and, in MQTT 5, an empty property length. */
+    uint8_t subscribeheader[ 8 ];
     uint8_t * pIndex;
     TransportOutVector_t pIoVector[ MQTT_SUB_UNSUB_MAX_VECTORS ];
     TransportOutVector_t * pIterator;
@@ -1977,7 +2110,8 @@ static MQTTStatus_t sendUnsubscribeWithoutCopy( MQTTContext_t * pContext,
                                                 size_t remainingLength )
 {
     MQTTStatus_t status = MQTTSuccess;
-    uint8_t unsubscribeheader[ 7 ];
+    /* Fixed header, packet identifier and, in MQTT 5, an empty property length. */
+    uint8_t unsubscribeheader[ 8 ];
     uint8_t * pIndex;
     TransportOutVector_t pIoVector[ MQTT_SUB_UNSUB_MAX_VECTORS ];
     TransportOutVector_t * pIterator;
@@ -2065,24 +2199,32 @@ static MQTTStatus_t sendPublishWithoutCopy( MQTTContext_t * pContext,
 {
     MQTTStatus_t status = MQTTSuccess;
     uint8_t serializedPacketID[ 2 ];
-    TransportOutVector_t pIoVector[ 4 ];
+    TransportOutVector_t pIoVector[ 5 ];
     size_t ioVectorLength;
     size_t totalMessageLength;
     const size_t packetIDLength = 2U;
 
+    #if ( MQTT_VERSION_5_ENABLED != 0 )
+        uint8_t serializedProperties[ MQTT_PUBLISH_PROPERTIES_MAX_SIZE ];
+        const uint8_t * pPropertiesEnd = NULL;
+    #endif
+
     /* The header is sent first. */
     pIoVector[ 0U ].iov_base = pMqttHeader;
     pIoVector[ 0U ].iov_len = headerSize;
     totalMessageLength = headerSize;
+    ioVectorLength = 1U;
 
-    /* Then the topic name has to be sent. */
-    pIoVector[ 1U ].iov_base = pPublishInfo->pTopicName;
-    pIoVector[ 1U ].iov_len = pPublishInfo->topicNameLength;
-    totalMessageLength += pPublishInfo->topicNameLength;
+    /* Then the topic name has to be sent. It is empty only for an MQTT 5
+     * PUBLISH that uses a topic alias already set up with the server. */
+    if( pPublishInfo->topicNameLength > 0U )
+    {
+        pIoVector[ ioVectorLength ].iov_base = pPublishInfo->pTopicName;
+        pIoVector[ ioVectorLength ].iov_len = pPublishInfo->topicNameLength;
 
-    /* The next field's index should be 2 as the first two fields
-     * have been filled in. */
-    ioVectorLength = 2U;
+        ioVectorLength++;
+        totalMessageLength += pPublishInfo->topicNameLength;
+    }
 
     if( pPublishInfo->qos > MQTTQoS0 )
     {
@@ -2097,6 +2239,19 @@ static MQTTStatus_t sendPublishWithoutCopy( MQTTContext_t * pContext,
         totalMessageLength += packetIDLength;
     }
 
+    #if ( MQTT_VERSION_5_ENABLED != 0 )
+        /* The MQTT 5 properties end the variable header. */
+        pPropertiesEnd = MQTT_SerializePublishProperties( pPublishInfo, serializedProperties );
+
+        pIoVector[ ioVectorLength ].iov_base = serializedProperties;
+        /* More details at: https://github.com/FreeRTOS/coreMQTT/blob/main/MISRA.md#rule-182 */
+        /* coverity[misra_c_2012_rule_18_2_violation] */
+        pIoVector[ ioVectorLength ].iov_len = ( size_t ) ( pPropertiesEnd - serializedProperties );
+
+        totalMessageLength += pIoVector[ ioVectorLength ].iov_len;
+        ioVectorLength++;
+    #endif
+
     /* Publish packets are allowed to contain no payload. */
     if( pPublishInfo->payloadLength > 0U )
     {
@@ -2128,10 +2283,18 @@ static MQTTStatus_t sendConnectWithoutCopy( MQTTContext_t * pContext,
     size_t totalMessageLength = 0U;
     int32_t bytesSentOrError;
 
-    /* Connect packet header can be of maximum 15 bytes. */
-    uint8_t connectPacketHeader[ 15 ];
+    #if ( MQTT_VERSION_5_ENABLED != 0 )
+        /* The MQTT 5 CONNECT properties follow the 15 byte header. */
+        uint8_t connectPacketHeader[ 15U + MQTT_CONNECT_PROPERTIES_MAX_SIZE ];
+        /* The will properties are always empty. */
+        const uint8_t willPropertiesLength = 0U;
+        TransportOutVector_t pIoVector[ 12 ];
+    #else
+        /* Connect packet header can be of maximum 15 bytes. */
+        uint8_t connectPacketHeader[ 15 ];
+        TransportOutVector_t pIoVector[ 11 ];
+    #endif
     uint8_t * pIndex = connectPacketHeader;
-    TransportOutVector_t pIoVector[ 11 ];
     uint8_t serializedClientIDLength[ 2 ];
     uint8_t serializedTopicLength[ 2 ];
     uint8_t serializedPayloadLength[ 2 ];
@@ -2154,7 +2317,7 @@ static MQTTStatus_t sendConnectWithoutCopy( MQTTContext_t * pContext,
                                                    pWillInfo,
                                                    remainingLength );
 
-        assert( ( pIndex - connectPacketHeader ) <= 15 );
+        assert( ( size_t ) ( pIndex - connectPacketHeader ) <= sizeof( connectPacketHeader ) );
 
         /* The header gets sent first. */
         iterator->iov_base = connectPacketHeader;
@@ -2180,6 +2343,14 @@ static MQTTStatus_t sendConnectWithoutCopy( MQTTContext_t * pContext,
 
         if( pWillInfo != NULL )
         {
+            #if ( MQTT_VERSION_5_ENABLED != 0 )
+                iterator->iov_base = &willPropertiesLength;
+                iterator->iov_len = 1U;
+                totalMessageLength += iterator->iov_len;
+                iterator++;
+                ioVectorLength++;
+            #endif
+
             /* Serialize the topic. */
             vectorsAdded = addEncodedStringToVector( serializedTopicLength,
                                                      pWillInfo->pTopicName,
@@ -2246,7 +2417,7 @@ static MQTTStatus_t sendConnectWithoutCopy( MQTTContext_t * pContext,
 
 /*-----------------------------------------------------------*/
 
-static MQTTStatus_t receiveConnack( const MQTTContext_t * pContext,
+static MQTTStatus_t receiveConnack( MQTTContext_t * pContext,
                                     uint32_t timeoutMs,
                                     bool cleanSession,
                                     MQTTPacketInfo_t * pIncomingPacket,
@@ -2340,7 +2511,13 @@ static MQTTStatus_t receiveConnack( const MQTTContext_t * pContext,
         pIncomingPacket->pRemainingData = pContext->networkBuffer.pBuffer;
 
         /* Deserialize CONNACK. */
-        status = MQTT_DeserializeAck( pIncomingPacket, NULL, pSessionPresent );
+        #if ( MQTT_VERSION_5_ENABLED != 0 )
+            status = MQTT_DeserializeConnack( pIncomingPacket,
+                                              pSessionPresent,
+                                              &( pContext->connackProperties ) );
+        #else
+            status = MQTT_DeserializeAck( pIncomingPacket, NULL, pSessionPresent );
+        #endif
     }
 
     /* If a clean session is requested, a session present should not be set by
@@ -2455,6 +2632,29 @@ static MQTTStatus_t validatePublishParams( const MQTTContext_t * pContext,
                     "to initialize and enable the use of QoS1/QoS2 publishes." ) );
         status = MQTTBadParameter;
     }
+
+    #if ( MQTT_VERSION_5_ENABLED != 0 )
+        else if( pPublishInfo->topicAlias > pContext->connackProperties.topicAliasMaximum )
+        {
+            LogError( ( "Topic alias %hu exceeds the topic alias maximum %hu of the server.",
+                        ( unsigned short ) pPublishInfo->topicAlias,
+                        ( unsigned short ) pContext->connackProperties.topicAliasMaximum ) );
+            status = MQTTBadParameter;
+        }
+        else if( pPublishInfo->qos > pContext->connackProperties.maximumQoS )
+        {
+            LogError( ( "QoS %u exceeds the maximum QoS %u of the server.",
+                        ( unsigned int ) pPublishInfo->qos,
+                        ( unsigned int ) pContext->connackProperties.maximumQoS ) );
+            status = MQTTBadParameter;
+        }
+        else if( ( pPublishInfo->retain == true ) &&
+                 ( pContext->connackProperties.retainAvailable == false ) )
+        {
+            LogError( ( "The server does not support retained messages." ) );
+            status = MQTTBadParameter;
+        }
+    #endif /* if ( MQTT_VERSION_5_ENABLED != 0 ) */
     else
     {
         /* MISRA else */
@@ -2562,6 +2762,18 @@ MQTTStatus_t MQTT_InitStatefulQoS( MQTTContext_t * pContext,
                     incomingPublishCount ) );
         status = MQTTBadParameter;
     }
+
+    /* Records link to each other with 16-bit indices, and there can never be
+     * more records in use than there are packet IDs. */
+    else if( ( outgoingPublishCount > UINT16_MAX ) ||
+             ( incomingPublishCount > UINT16_MAX ) )
+    {
+        LogError( ( "Too many publish records: outgoingPublishCount=%lu, "
+                    "incomingPublishCount=%lu",
+                    outgoingPublishCount,
+                    incomingPublishCount ) );
+        status = MQTTBadParameter;
+    }
     else if( pContext->appCallback == NULL )
     {
         LogError( ( "MQTT_InitStatefulQoS must be called only after MQTT_Init has"
@@ -2574,6 +2786,21 @@ MQTTStatus_t MQTT_InitStatefulQoS( MQTTContext_t * pContext,
         pContext->incomingPublishRecords = pIncomingPublishRecords;
         pContext->outgoingPublishRecordMaxCount = outgoingPublishCount;
         pContext->outgoingPublishRecords = pOutgoingPublishRecords;
+
+        /* An all zero array holds no records. */
+        if( outgoingPublishCount > 0U )
+        {
+            ( void ) memset( pOutgoingPublishRecords,
+                             0x00,
+                             outgoingPublishCount * sizeof( *pOutgoingPublishRecords ) );
+        }
+
+        if( incomingPublishCount > 0U )
+        {
+            ( void ) memset( pIncomingPublishRecords,
+                             0x00,
+                             incomingPublishCount * sizeof( *pIncomingPublishRecords ) );
+        }
     }
 
     return status;
@@ -2662,6 +2889,12 @@ MQTTStatus_t MQTT_Connect( MQTTContext_t * pContext,
     /* Read CONNACK from transport layer. */
     if( status == MQTTSuccess )
     {
+        #if ( MQTT_VERSION_5_ENABLED != 0 )
+            /* The session expiry interval the client requested applies unless
+             * the CONNACK overrides it. */
+            pContext->connackProperties.sessionExpiryInterval = pConnectInfo->sessionExpiryInterval;
+        #endif
+
         status = receiveConnack( pContext,
                                  timeoutMs,
                                  pConnectInfo->cleanSession,
@@ -2683,6 +2916,18 @@ MQTTStatus_t MQTT_Connect( MQTTContext_t * pContext,
         pContext->keepAliveIntervalSec = pConnectInfo->keepAliveSeconds;
         pContext->waitingForPingResp = false;
         pContext->pingReqSendTimeMs = 0U;
+
+        #if ( MQTT_VERSION_5_ENABLED != 0 )
+            /* A server keep alive replaces the one the client requested. */
+            if( pContext->connackProperties.serverKeepAlive != 0U )
+            {
+                pContext->keepAliveIntervalSec = pContext->connackProperties.serverKeepAlive;
+            }
+
+            /* Every QoS 1 and QoS 2 PUBLISH takes a unit of the send quota
+             * until it completes. */
+            pContext->sendQuota = pContext->connackProperties.receiveMaximum;
+        #endif
     }
     else
     {
@@ -2764,6 +3009,18 @@ MQTTStatus_t MQTT_Publish( MQTTContext_t * pContext,
                                             &packetSize );
     }
 
+    #if ( MQTT_VERSION_5_ENABLED != 0 )
+        if( ( status == MQTTSuccess ) &&
+            ( pContext->connackProperties.maximumPacketSize != 0U ) &&
+            ( packetSize > pContext->connackProperties.maximumPacketSize ) )
+        {
+            LogError( ( "PUBLISH packet size %lu exceeds the maximum packet size %lu of the server.",
+                        ( unsigned long ) packetSize,
+                        ( unsigned long ) pContext->connackProperties.maximumPacketSize ) );
+            status = MQTTBadParameter;
+        }
+    #endif
+
     if( status == MQTTSuccess )
     {
         status = MQTT_SerializePublishHeaderWithoutTopic( pPublishInfo,
@@ -2779,16 +3036,39 @@ MQTTStatus_t MQTT_Publish( MQTTContext_t * pContext,
         /* Set the flag so that the corresponding hook can be called later. */
         stateUpdateHookExecuted = true;
 
-        status = MQTT_ReserveState( pContext,
-                                    packetId,
-                                    pPublishInfo->qos );
+        #if ( MQTT_VERSION_5_ENABLED != 0 )
 
-        /* State already exists for a duplicate packet.
-         * If a state doesn't exist, it will be handled as a new publish in
-         * state engine. */
-        if( ( status == MQTTStateCollision ) && ( pPublishInfo->dup == true ) )
+            /* The receive maximum of the server limits the number of QoS 1 and
+             * QoS 2 publishes awaiting acknowledgment. A retransmission already
+             * holds a unit of the send quota. */
+            if( ( pContext->sendQuota == 0U ) && ( pPublishInfo->dup == false ) )
+            {
+                LogError( ( "The receive maximum %hu of the server has been reached.",
+                            ( unsigned short ) pContext->connackProperties.receiveMaximum ) );
+                status = MQTTReceiveMaximumExceeded;
+            }
+        #endif
+
+        if( status == MQTTSuccess )
         {
-            status = MQTTSuccess;
+            status = MQTT_ReserveState( pContext,
+                                        packetId,
+                                        pPublishInfo->qos );
+
+            #if ( MQTT_VERSION_5_ENABLED != 0 )
+                if( ( status == MQTTSuccess ) && ( pContext->sendQuota > 0U ) )
+                {
+                    pContext->sendQuota--;
+                }
+            #endif
+
+            /* State already exists for a duplicate packet.
+             * If a state doesn't exist, it will be handled as a new publish in
+             * state engine. */
+            if( ( status == MQTTStateCollision ) && ( pPublishInfo->dup == true ) )
+            {
+                status = MQTTSuccess;
+            }
         }
     }
 
@@ -3215,7 +3495,14 @@ MQTTStatus_t MQTT_GetSubAckStatusCodes( const MQTTPacketInfo_t * pSubackPacket,
         LogError( ( "Invalid parameter: pPayloadSize is NULL." ) );
         status = MQTTBadParameter;
     }
-    else if( pSubackPacket->type != MQTT_PACKET_TYPE_SUBACK )
+
+    #if ( MQTT_VERSION_5_ENABLED != 0 )
+        /* An MQTT 5 UNSUBACK carries reason codes in the same layout. */
+        else if( ( pSubackPacket->type != MQTT_PACKET_TYPE_SUBACK ) &&
+                 ( pSubackPacket->type != MQTT_PACKET_TYPE_UNSUBACK ) )
+    #else
+        else if( pSubackPacket->type != MQTT_PACKET_TYPE_SUBACK )
+    #endif
     {
         LogError( ( "Invalid parameter: Input packet is not a SUBACK packet: "
                     "ExpectedType=%02x, InputType=%02x",
@@ -3244,8 +3531,30 @@ MQTTStatus_t MQTT_GetSubAckStatusCodes( const MQTTPacketInfo_t * pSubackPacket,
          * length of the variable header (2 bytes) plus the length of the payload.
          * Therefore, we add 2 positions for the starting address of the payload, and
          * subtract 2 bytes from the remaining length for the length of the payload.*/
-        *pPayloadStart = &pSubackPacket->pRemainingData[ sizeof( uint16_t ) ];
-        *pPayloadSize = pSubackPacket->remainingLength - sizeof( uint16_t );
+        size_t variableHeaderSize = sizeof( uint16_t );
+
+        #if ( MQTT_VERSION_5_ENABLED != 0 )
+            /* In MQTT 5 the variable header ends with the properties. */
+            size_t propertiesSize = 0U;
+
+            status = MQTT_SkipProperties( &pSubackPacket->pRemainingData[ sizeof( uint16_t ) ],
+                                          pSubackPacket->remainingLength - sizeof( uint16_t ),
+                                          &propertiesSize );
+            variableHeaderSize += propertiesSize;
+
+            if( ( status != MQTTSuccess ) || ( variableHeaderSize >= pSubackPacket->remainingLength ) )
+            {
+                LogError( ( "Invalid parameter: SUBACK properties are malformed or "
+                            "leave no reason codes." ) );
+                status = MQTTBadParameter;
+            }
+        #endif
+
+        if( status == MQTTSuccess )
+        {
+            *pPayloadStart = &pSubackPacket->pRemainingData[ variableHeaderSize ];
+            *pPayloadSize = pSubackPacket->remainingLength - variableHeaderSize;
+        }
     }
 
     return status;
@@ -3303,6 +3612,10 @@ const char * MQTT_Status_strerror( MQTTStatus_t status )
             str = "MQTTKeepAliveTimeout";
             break;
 
+        case MQTTReceiveMaximumExceeded:
+            str = "MQTTReceiveMaximumExceeded";
+            break;
+
         default:
             str = "Invalid MQTT Status code";
             break;
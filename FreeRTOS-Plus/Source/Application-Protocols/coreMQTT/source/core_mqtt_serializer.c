@@ -144,6 +144,42 @@
  */
 #define MQTT_MIN_PUBLISH_REMAINING_LENGTH_QOS0    ( 3U )
 
+#if ( MQTT_VERSION_5_ENABLED != 0 )
+
+/**
+ * @brief MQTT protocol version 5.0.
+ */
+    #define MQTT_VERSION_5                             ( ( uint8_t ) 5U )
+
+/*
+ * MQTT 5 property identifiers that the library writes or interprets.
+ */
+    #define MQTT_PROPERTY_SESSION_EXPIRY_INTERVAL      ( ( uint8_t ) 0x11U ) /**< @brief Session Expiry Interval. */
+    #define MQTT_PROPERTY_SERVER_KEEP_ALIVE            ( ( uint8_t ) 0x13U ) /**< @brief Server Keep Alive. */
+    #define MQTT_PROPERTY_RECEIVE_MAXIMUM              ( ( uint8_t ) 0x21U ) /**< @brief Receive Maximum. */
+    #define MQTT_PROPERTY_TOPIC_ALIAS_MAXIMUM          ( ( uint8_t ) 0x22U ) /**< @brief Topic Alias Maximum. */
+    #define MQTT_PROPERTY_TOPIC_ALIAS                  ( ( uint8_t ) 0x23U ) /**< @brief Topic Alias. */
+    #define MQTT_PROPERTY_MAXIMUM_QOS                  ( ( uint8_t ) 0x24U ) /**< @brief Maximum QoS. */
+    #define MQTT_PROPERTY_RETAIN_AVAILABLE             ( ( uint8_t ) 0x25U ) /**< @brief Retain Available. */
+    #define MQTT_PROPERTY_MAXIMUM_PACKET_SIZE          ( ( uint8_t ) 0x27U ) /**< @brief Maximum Packet Size. */
+
+/**
+ * @brief The smallest "Remaining length" of an MQTT 5 CONNACK: the acknowledge
+ * flags, the reason code and an empty property length.
+ */
+    #define MQTT_PACKET_CONNACK_V5_MIN_REMAINING_LENGTH    ( 3U )
+
+/**
+ * @brief Iterator over the properties of an incoming MQTT 5 packet.
+ */
+    typedef struct MQTTPropertyCursor
+    {
+        const uint8_t * pProperties; /**< @brief First byte after the property length. */
+        size_t propertiesLength;     /**< @brief Value of the property length. */
+        size_t index;                /**< @brief Offset of the next property. */
+    } MQTTPropertyCursor_t;
+#endif /* if ( MQTT_VERSION_5_ENABLED != 0 ) */
+
 /*-----------------------------------------------------------*/
 
 
@@ -250,13 +286,16 @@ static void serializeConnectPacket( const MQTTConnectInfo_t * pConnectInfo,
                                     size_t remainingLength,
                                     const MQTTFixedBuffer_t * pFixedBuffer );
 
+#if ( MQTT_VERSION_5_ENABLED == 0 )
+
 /**
  * @brief Prints the appropriate message for the CONNACK response code if logs
  * are enabled.
  *
  * @param[in] responseCode MQTT standard CONNACK response code.
  */
-static void logConnackResponse( uint8_t responseCode );
+    static void logConnackResponse( uint8_t responseCode );
+#endif /* if ( MQTT_VERSION_5_ENABLED == 0 ) */
 
 /**
  * @brief Encodes the remaining length of the packet using the variable length
@@ -361,6 +400,8 @@ static MQTTStatus_t checkPublishRemainingLength( size_t remainingLength,
 static MQTTStatus_t processPublishFlags( uint8_t publishFlags,
                                          MQTTPublishInfo_t * pPublishInfo );
 
+#if ( MQTT_VERSION_5_ENABLED == 0 )
+
 /**
  * @brief Deserialize a CONNACK packet.
  *
@@ -374,8 +415,9 @@ static MQTTStatus_t processPublishFlags( uint8_t publishFlags,
  * #MQTTServerRefused if CONNACK specifies that CONNECT was rejected;
  * #MQTTBadResponse if the CONNACK packet doesn't follow MQTT spec.
  */
-static MQTTStatus_t deserializeConnack( const MQTTPacketInfo_t * pConnack,
-                                        bool * pSessionPresent );
+    static MQTTStatus_t deserializeConnack( const MQTTPacketInfo_t * pConnack,
+                                            bool * pSessionPresent );
+#endif /* if ( MQTT_VERSION_5_ENABLED == 0 ) */
 
 /**
  * @brief Decode the status bytes of a SUBACK packet to a #MQTTStatus_t.
@@ -389,7 +431,7 @@ static MQTTStatus_t readSubackStatus( size_t statusCount,
                                       const uint8_t * pStatusStart );
 
 /**
- * @brief Deserialize a SUBACK packet.
+ * @brief Deserialize a SUBACK packet, or with MQTT 5, an UNSUBACK packet.
  *
  * Converts the packet from a stream of bytes to an #MQTTStatus_t and extracts
  * the packet identifier.
@@ -450,6 +492,168 @@ static MQTTStatus_t deserializeSimpleAck( const MQTTPacketInfo_t * pAck,
  */
 static MQTTStatus_t deserializePingresp( const MQTTPacketInfo_t * pPingresp );
 
+/**
+ * @brief Check that a PUBLISH has a topic name to serialize.
+ *
+ * @param[in] pPublishInfo MQTT PUBLISH packet parameters.
+ *
+ * @return `true` if the topic name is set, or with MQTT 5, if it is empty
+ * and a topic alias is used instead; `false` otherwise.
+ */
+static bool publishTopicValid( const MQTTPublishInfo_t * pPublishInfo );
+
+#if ( MQTT_VERSION_5_ENABLED != 0 )
+
+/**
+ * @brief Decode a variable byte integer, such as an MQTT 5 property length,
+ * from a buffer.
+ *
+ * @param[in] pSource The encoded integer.
+ * @param[in] sourceLength Number of bytes available at @p pSource.
+ * @param[out] pValue The decoded value.
+ *
+ * @return The number of bytes the encoding takes, or 0 if it is malformed or
+ * does not fit in @p sourceLength.
+ */
+    static size_t decodeVariableLength( const uint8_t * pSource,
+                                        size_t sourceLength,
+                                        size_t * pValue );
+
+/**
+ * @brief Write an MQTT 5 property with an integer value.
+ *
+ * @param[out] pDestination Destination buffer.
+ * @param[in] propertyId The property identifier.
+ * @param[in] value The value of the property.
+ * @param[in] valueLength Size of the value: 1, 2 or 4 bytes.
+ *
+ * @return A pointer to the end of the encoded property.
+ */
+    static uint8_t * encodeIntegerProperty( uint8_t * pDestination,
+                                            uint8_t propertyId,
+                                            uint32_t value,
+                                            size_t valueLength );
+
+/**
+ * @brief Get the size of the CONNECT properties, excluding the property length.
+ *
+ * @param[in] pConnectInfo MQTT CONNECT packet parameters.
+ *
+ * @return The size of the properties.
+ */
+    static size_t getConnectPropertiesLength( const MQTTConnectInfo_t * pConnectInfo );
+
+/**
+ * @brief Get the size of the PUBLISH properties, including the property length.
+ *
+ * @param[in] pPublishInfo MQTT PUBLISH packet parameters.
+ *
+ * @return The size of the properties.
+ */
+    static size_t getPublishPropertiesSize( const MQTTPublishInfo_t * pPublishInfo );
+
+/**
+ * @brief Start iterating over the properties of an incoming packet.
+ *
+ * @param[in] pSource The property length of the packet.
+ * @param[in] sourceLength Number of bytes left in the packet at @p pSource.
+ * @param[out] pCursor The cursor to initialize.
+ * @param[out] pSize Size of the property length and the properties.
+ *
+ * @return #MQTTSuccess, or #MQTTBadResponse if the properties do not fit in
+ * the packet.
+ */
+    static MQTTStatus_t initPropertyCursor( const uint8_t * pSource,
+                                            size_t sourceLength,
+                                            MQTTPropertyCursor_t * pCursor,
+                                            size_t * pSize );
+
+/**
+ * @brief Read the next property of an incoming packet.
+ *
+ * Properties with a string or binary value are skipped over and reported with
+ * a value of 0.
+ *
+ * @param[in, out] pCursor The property cursor.
+ * @param[out] pPropertyId Identifier of the property.
+ * @param[out] pValue Value of the property if it is an integer.
+ *
+ * @return #MQTTSuccess, #MQTTNoDataAvailable after the last property, or
+ * #MQTTBadResponse if the property is unknown or malformed.
+ */
+    static MQTTStatus_t getNextProperty( MQTTPropertyCursor_t * pCursor,
+                                         uint8_t * pPropertyId,
+                                         uint32_t * pValue );
+
+/**
+ * @brief Validate the properties of an incoming packet that has no properties
+ * the library interprets.
+ *
+ * @param[in] pSource The property length of the packet.
+ * @param[in] sourceLength Number of bytes left in the packet at @p pSource.
+ * @param[out] pSize Size of the property length and the properties.
+ *
+ * @return #MQTTSuccess or #MQTTBadResponse.
+ */
+    static MQTTStatus_t skipProperties( const uint8_t * pSource,
+                                        size_t sourceLength,
+                                        size_t * pSize );
+
+/**
+ * @brief Validate the optional reason code and properties that end an MQTT 5
+ * PUBACK, PUBREC, PUBREL, PUBCOMP or DISCONNECT.
+ *
+ * @param[in] pPacket The incoming packet.
+ * @param[in] reasonCodeOffset Offset of the reason code in the packet.
+ *
+ * @return #MQTTSuccess or #MQTTBadResponse.
+ */
+    static MQTTStatus_t checkReasonCodeAndProperties( const MQTTPacketInfo_t * pPacket,
+                                                      size_t reasonCodeOffset );
+
+/**
+ * @brief Deserialize an MQTT 5 CONNACK packet.
+ *
+ * @param[in] pConnack Pointer to an MQTT packet struct representing a
+ * CONNACK.
+ * @param[out] pSessionPresent Whether a previous session was present.
+ * @param[out] pConnackProperties Reason code and properties of the CONNACK.
+ *
+ * @return #MQTTSuccess if CONNACK specifies that CONNECT was accepted;
+ * #MQTTServerRefused if CONNACK specifies that CONNECT was rejected;
+ * #MQTTBadResponse if the CONNACK packet doesn't follow MQTT spec.
+ */
+    static MQTTStatus_t deserializeConnackV5( const MQTTPacketInfo_t * pConnack,
+                                              bool * pSessionPresent,
+                                              MQTTConnackProperties_t * pConnackProperties );
+
+/**
+ * @brief Store a CONNACK property in #MQTTConnackProperties_t.
+ *
+ * @param[in] propertyId Identifier of the property.
+ * @param[in] value Value of the property.
+ * @param[out] pConnackProperties Where the property is stored.
+ *
+ * @return #MQTTSuccess, or #MQTTBadResponse if the value is not allowed.
+ */
+    static MQTTStatus_t storeConnackProperty( uint8_t propertyId,
+                                              uint32_t value,
+                                              MQTTConnackProperties_t * pConnackProperties );
+
+/**
+ * @brief Validate the properties of an incoming PUBLISH.
+ *
+ * @param[in] pSource The property length of the PUBLISH.
+ * @param[in] sourceLength Number of bytes left in the packet at @p pSource.
+ * @param[out] pSize Size of the property length and the properties.
+ *
+ * @return #MQTTSuccess or #MQTTBadResponse.
+ */
+    static MQTTStatus_t readPublishProperties( const uint8_t * pSource,
+                                               size_t sourceLength,
+                                               size_t * pSize );
+#endif /* if ( MQTT_VERSION_5_ENABLED != 0 ) */
+
 /*-----------------------------------------------------------*/
 
 static size_t remainingLengthEncodedSize( size_t length )
@@ -558,6 +762,536 @@ static uint8_t * encodeString( uint8_t * pDestination,
 
 /*-----------------------------------------------------------*/
 
+static bool publishTopicValid( const MQTTPublishInfo_t * pPublishInfo )
+{
+    bool valid = ( pPublishInfo->pTopicName != NULL ) && ( pPublishInfo->topicNameLength != 0U );
+
+    #if ( MQTT_VERSION_5_ENABLED != 0 )
+
+        /* The topic name may be left out when the server already knows it by
+         * its topic alias. */
+        if( ( pPublishInfo->topicAlias != 0U ) && ( pPublishInfo->topicNameLength == 0U ) )
+        {
+            valid = true;
+        }
+    #endif
+
+    return valid;
+}
+
+/*-----------------------------------------------------------*/
+
+#if ( MQTT_VERSION_5_ENABLED != 0 )
+
+    static size_t decodeVariableLength( const uint8_t * pSource,
+                                        size_t sourceLength,
+                                        size_t * pValue )
+    {
+        size_t value = 0U, multiplier = 1U, bytesDecoded = 0U;
+        uint8_t encodedByte = 0x80U;
+
+        assert( pSource != NULL );
+        assert( pValue != NULL );
+
+        /* A variable byte integer is at most 4 bytes long. The high bit of
+         * each byte tells whether another byte follows. */
+        while( ( ( encodedByte & 0x80U ) != 0U ) &&
+               ( bytesDecoded < sourceLength ) &&
+               ( bytesDecoded < 4U ) )
+        {
+            encodedByte = pSource[ bytesDecoded ];
+            value += ( size_t ) ( encodedByte & 0x7FU ) * multiplier;
+            multiplier *= 128U;
+            bytesDecoded++;
+        }
+
+        if( ( encodedByte & 0x80U ) != 0U )
+        {
+            LogError( ( "Malformed or truncated variable byte integer." ) );
+            bytesDecoded = 0U;
+        }
+        else
+        {
+            *pValue = value;
+        }
+
+        return bytesDecoded;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static uint8_t * encodeIntegerProperty( uint8_t * pDestination,
+                                            uint8_t propertyId,
+                                            uint32_t value,
+                                            size_t valueLength )
+    {
+        uint8_t * pIndex = pDestination;
+        size_t i;
+
+        assert( pDestination != NULL );
+        assert( ( valueLength == 1U ) || ( valueLength == 2U ) || ( valueLength == 4U ) );
+
+        *pIndex = propertyId;
+        pIndex++;
+
+        /* Integer properties are written most significant byte first. */
+        for( i = valueLength; i > 0U; i-- )
+        {
+            *pIndex = ( uint8_t ) ( value >> ( 8U * ( i - 1U ) ) );
+            pIndex++;
+        }
+
+        return pIndex;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static size_t getConnectPropertiesLength( const MQTTConnectInfo_t * pConnectInfo )
+    {
+        size_t length = 0U;
+
+        assert( pConnectInfo != NULL );
+
+        /* Each property is a 1 byte identifier followed by its value. A
+         * property is left out when the client uses the default value. */
+        if( pConnectInfo->sessionExpiryInterval != 0U )
+        {
+            length += 1U + sizeof( uint32_t );
+        }
+
+        if( pConnectInfo->receiveMaximum != 0U )
+        {
+            length += 1U + sizeof( uint16_t );
+        }
+
+        if( pConnectInfo->maximumPacketSize != 0U )
+        {
+            length += 1U + sizeof( uint32_t );
+        }
+
+        return length;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static size_t getPublishPropertiesSize( const MQTTPublishInfo_t * pPublishInfo )
+    {
+        /* The property length always takes 1 byte, as the only property the
+         * library writes is the 3 byte topic alias. */
+        size_t size = 1U;
+
+        assert( pPublishInfo != NULL );
+
+        if( pPublishInfo->topicAlias != 0U )
+        {
+            size += 1U + sizeof( uint16_t );
+        }
+
+        return size;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static MQTTStatus_t initPropertyCursor( const uint8_t * pSource,
+                                            size_t sourceLength,
+                                            MQTTPropertyCursor_t * pCursor,
+                                            size_t * pSize )
+    {
+        MQTTStatus_t status = MQTTSuccess;
+        size_t propertiesLength = 0U;
+        size_t lengthSize;
+
+        assert( pSource != NULL );
+        assert( pCursor != NULL );
+        assert( pSize != NULL );
+
+        lengthSize = decodeVariableLength( pSource, sourceLength, &propertiesLength );
+
+        if( ( lengthSize == 0U ) || ( propertiesLength > ( sourceLength - lengthSize ) ) )
+        {
+            LogError( ( "Property length does not fit in the packet." ) );
+            status = MQTTBadResponse;
+        }
+        else
+        {
+            pCursor->pProperties = &pSource[ lengthSize ];
+            pCursor->propertiesLength = propertiesLength;
+            pCursor->index = 0U;
+            *pSize = lengthSize + propertiesLength;
+        }
+
+        return status;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static MQTTStatus_t getNextProperty( MQTTPropertyCursor_t * pCursor,
+                                         uint8_t * pPropertyId,
+                                         uint32_t * pValue )
+    {
+        MQTTStatus_t status = MQTTSuccess;
+        const uint8_t * pValueStart = NULL;
+        size_t available = 0U, valueLength = 0U, decodedValue = 0U, i;
+        uint32_t value = 0U;
+        bool isInteger = true;
+
+        assert( pCursor != NULL );
+        assert( pPropertyId != NULL );
+        assert( pValue != NULL );
+
+        if( pCursor->index >= pCursor->propertiesLength )
+        {
+            status = MQTTNoDataAvailable;
+        }
+        else
+        {
+            *pPropertyId = pCursor->pProperties[ pCursor->index ];
+            pValueStart = &pCursor->pProperties[ pCursor->index + 1U ];
+            available = pCursor->propertiesLength - pCursor->index - 1U;
+
+            /* The type of a property, and so the size of its value, is fixed
+             * by its identifier. */
+            switch( *pPropertyId )
+            {
+                /* Byte. */
+                case 0x01U: /* Payload Format Indicator. */
+                case 0x17U: /* Request Problem Information. */
+                case 0x19U: /* Request Response Information. */
+                case MQTT_PROPERTY_MAXIMUM_QOS:
+                case MQTT_PROPERTY_RETAIN_AVAILABLE:
+                case 0x28U: /* Wildcard Subscription Available. */
+                case 0x29U: /* Subscription Identifier Available. */
+                case 0x2AU: /* Shared Subscription Available. */
+                    valueLength = 1U;
+                    break;
+
+                /* Two byte integer. */
+                case MQTT_PROPERTY_SERVER_KEEP_ALIVE:
+                case MQTT_PROPERTY_RECEIVE_MAXIMUM:
+                case MQTT_PROPERTY_TOPIC_ALIAS_MAXIMUM:
+                case MQTT_PROPERTY_TOPIC_ALIAS:
+                    valueLength = 2U;
+                    break;
+
+                /* Four byte integer. */
+                case 0x02U: /* Message Expiry Interval. */
+                case MQTT_PROPERTY_SESSION_EXPIRY_INTERVAL:
+                case 0x18U: /* Will Delay Interval. */
+                case MQTT_PROPERTY_MAXIMUM_PACKET_SIZE:
+                    valueLength = 4U;
+                    break;
+
+                /* Variable byte integer. */
+                case 0x0BU: /* Subscription Identifier. */
+                    valueLength = decodeVariableLength( pValueStart, available, &decodedValue );
+                    value = ( uint32_t ) decodedValue;
+                    isInteger = false;
+                    break;
+
+                /* UTF-8 string or binary data, both prefixed by a 2 byte length. */
+                case 0x03U: /* Content Type. */
+                case 0x08U: /* Response Topic. */
+                case 0x09U: /* Correlation Data. */
+                case 0x12U: /* Assigned Client Identifier. */
+                case 0x15U: /* Authentication Method. */
+                case 0x16U: /* Authentication Data. */
+                case 0x1AU: /* Response Information. */
+                case 0x1CU: /* Server Reference. */
+                case 0x1FU: /* Reason String. */
+                    isInteger = false;
+
+                    if( available >= sizeof( uint16_t ) )
+                    {
+                        valueLength = sizeof( uint16_t ) + UINT16_DECODE( pValueStart );
+                    }
+
+                    break;
+
+                /* UTF-8 string pair. */
+                case 0x26U: /* User Property. */
+                    isInteger = false;
+
+                    if( available >= sizeof( uint16_t ) )
+                    {
+                        valueLength = sizeof( uint16_t ) + UINT16_DECODE( pValueStart );
+
+                        if( available >= ( valueLength + sizeof( uint16_t ) ) )
+                        {
+                            valueLength += sizeof( uint16_t ) + UINT16_DECODE( ( &pValueStart[ valueLength ] ) );
+                        }
+                    }
+
+                    break;
+
+                default:
+                    LogError( ( "Unknown property identifier 0x%02x.",
+                                ( unsigned int ) *pPropertyId ) );
+                    break;
+            }
+
+            if( ( valueLength == 0U ) || ( valueLength > available ) )
+            {
+                LogError( ( "Property 0x%02x is malformed or does not fit in the packet.",
+                            ( unsigned int ) *pPropertyId ) );
+                status = MQTTBadResponse;
+            }
+            else
+            {
+                if( isInteger == true )
+                {
+                    for( i = 0U; i < valueLength; i++ )
+                    {
+                        value = ( value << 8 ) | ( uint32_t ) pValueStart[ i ];
+                    }
+                }
+
+                *pValue = value;
+                pCursor->index += 1U + valueLength;
+            }
+        }
+
+        return status;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static MQTTStatus_t skipProperties( const uint8_t * pSource,
+                                        size_t sourceLength,
+                                        size_t * pSize )
+    {
+        MQTTPropertyCursor_t cursor;
+        uint8_t propertyId = 0U;
+        uint32_t value = 0U;
+        MQTTStatus_t status = initPropertyCursor( pSource, sourceLength, &cursor, pSize );
+
+        while( status == MQTTSuccess )
+        {
+            status = getNextProperty( &cursor, &propertyId, &value );
+        }
+
+        if( status == MQTTNoDataAvailable )
+        {
+            status = MQTTSuccess;
+        }
+
+        return status;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static MQTTStatus_t checkReasonCodeAndProperties( const MQTTPacketInfo_t * pPacket,
+                                                      size_t reasonCodeOffset )
+    {
+        MQTTStatus_t status = MQTTSuccess;
+        size_t propertiesOffset = reasonCodeOffset + 1U;
+        size_t propertiesSize = 0U;
+
+        assert( pPacket != NULL );
+
+        /* The reason code may be left out when it is 0, and the properties
+         * when there are none. Otherwise the properties must end the packet. */
+        if( pPacket->remainingLength > propertiesOffset )
+        {
+            status = skipProperties( &pPacket->pRemainingData[ propertiesOffset ],
+                                     pPacket->remainingLength - propertiesOffset,
+                                     &propertiesSize );
+
+            if( ( status == MQTTSuccess ) &&
+                ( ( propertiesOffset + propertiesSize ) != pPacket->remainingLength ) )
+            {
+                LogError( ( "Packet has %lu unexpected bytes after its properties.",
+                            ( unsigned long ) ( pPacket->remainingLength - propertiesOffset - propertiesSize ) ) );
+                status = MQTTBadResponse;
+            }
+        }
+
+        return status;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static MQTTStatus_t storeConnackProperty( uint8_t propertyId,
+                                              uint32_t value,
+                                              MQTTConnackProperties_t * pConnackProperties )
+    {
+        MQTTStatus_t status = MQTTSuccess;
+
+        assert( pConnackProperties != NULL );
+
+        switch( propertyId )
+        {
+            case MQTT_PROPERTY_SESSION_EXPIRY_INTERVAL:
+                pConnackProperties->sessionExpiryInterval = value;
+                break;
+
+            case MQTT_PROPERTY_RECEIVE_MAXIMUM:
+                pConnackProperties->receiveMaximum = ( uint16_t ) value;
+                status = ( value == 0U ) ? MQTTBadResponse : MQTTSuccess;
+                break;
+
+            case MQTT_PROPERTY_TOPIC_ALIAS_MAXIMUM:
+                pConnackProperties->topicAliasMaximum = ( uint16_t ) value;
+                break;
+
+            case MQTT_PROPERTY_MAXIMUM_PACKET_SIZE:
+                pConnackProperties->maximumPacketSize = value;
+                status = ( value == 0U ) ? MQTTBadResponse : MQTTSuccess;
+                break;
+
+            case MQTT_PROPERTY_MAXIMUM_QOS:
+                pConnackProperties->maximumQoS = ( value == 0U ) ? MQTTQoS0 : MQTTQoS1;
+                status = ( value > 1U ) ? MQTTBadResponse : MQTTSuccess;
+                break;
+
+            case MQTT_PROPERTY_RETAIN_AVAILABLE:
+                pConnackProperties->retainAvailable = ( value == 1U );
+                status = ( value > 1U ) ? MQTTBadResponse : MQTTSuccess;
+                break;
+
+            case MQTT_PROPERTY_SERVER_KEEP_ALIVE:
+                pConnackProperties->serverKeepAlive = ( uint16_t ) value;
+                break;
+
+            default:
+                /* Other properties, such as the reason string, are not kept. */
+                break;
+        }
+
+        if( status != MQTTSuccess )
+        {
+            LogError( ( "CONNACK property 0x%02x has invalid value %lu.",
+                        ( unsigned int ) propertyId,
+                        ( unsigned long ) value ) );
+        }
+
+        return status;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static MQTTStatus_t deserializeConnackV5( const MQTTPacketInfo_t * pConnack,
+                                              bool * pSessionPresent,
+                                              MQTTConnackProperties_t * pConnackProperties )
+    {
+        MQTTStatus_t status = MQTTSuccess;
+        const uint8_t * pRemainingData = NULL;
+        MQTTPropertyCursor_t cursor;
+        size_t propertiesSize = 0U;
+        uint8_t propertyId = 0U;
+        uint32_t value = 0U;
+
+        assert( pConnack != NULL );
+        assert( pSessionPresent != NULL );
+        assert( pConnackProperties != NULL );
+        pRemainingData = pConnack->pRemainingData;
+
+        if( pConnack->remainingLength < MQTT_PACKET_CONNACK_V5_MIN_REMAINING_LENGTH )
+        {
+            LogError( ( "CONNACK cannot have a remaining length less than %u.",
+                        ( unsigned int ) MQTT_PACKET_CONNACK_V5_MIN_REMAINING_LENGTH ) );
+            status = MQTTBadResponse;
+        }
+        /* The high 7 bits of the acknowledge flags must be 0. */
+        else if( ( pRemainingData[ 0 ] | 0x01U ) != 0x01U )
+        {
+            LogError( ( "Reserved bits in CONNACK incorrect." ) );
+            status = MQTTBadResponse;
+        }
+        else
+        {
+            *pSessionPresent = ( pRemainingData[ 0 ] & MQTT_PACKET_CONNACK_SESSION_PRESENT_MASK ) != 0U;
+            pConnackProperties->reasonCode = pRemainingData[ 1 ];
+
+            /* The properties must take up the rest of the packet. */
+            status = initPropertyCursor( &pRemainingData[ 2 ],
+                                         pConnack->remainingLength - 2U,
+                                         &cursor,
+                                         &propertiesSize );
+
+            if( ( status == MQTTSuccess ) && ( ( propertiesSize + 2U ) != pConnack->remainingLength ) )
+            {
+                LogError( ( "CONNACK has unexpected bytes after its properties." ) );
+                status = MQTTBadResponse;
+            }
+        }
+
+        while( status == MQTTSuccess )
+        {
+            status = getNextProperty( &cursor, &propertyId, &value );
+
+            if( status == MQTTSuccess )
+            {
+                status = storeConnackProperty( propertyId, value, pConnackProperties );
+            }
+        }
+
+        if( status == MQTTNoDataAvailable )
+        {
+            status = MQTTSuccess;
+        }
+
+        if( status == MQTTSuccess )
+        {
+            if( pConnackProperties->reasonCode >= MQTT_REASON_CODE_FAILURE )
+            {
+                LogError( ( "Connection refused with reason code 0x%02x.",
+                            ( unsigned int ) pConnackProperties->reasonCode ) );
+                status = MQTTServerRefused;
+            }
+            else if( pConnackProperties->reasonCode != 0U )
+            {
+                LogError( ( "CONNACK reason code 0x%02x is invalid.",
+                            ( unsigned int ) pConnackProperties->reasonCode ) );
+                status = MQTTBadResponse;
+            }
+            else
+            {
+                LogDebug( ( "Connection accepted. Session present: %d.",
+                            ( int ) *pSessionPresent ) );
+            }
+        }
+
+        return status;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static MQTTStatus_t readPublishProperties( const uint8_t * pSource,
+                                               size_t sourceLength,
+                                               size_t * pSize )
+    {
+        MQTTPropertyCursor_t cursor;
+        uint8_t propertyId = 0U;
+        uint32_t value = 0U;
+        MQTTStatus_t status = initPropertyCursor( pSource, sourceLength, &cursor, pSize );
+
+        while( status == MQTTSuccess )
+        {
+            status = getNextProperty( &cursor, &propertyId, &value );
+
+            /* The client never sends a topic alias maximum in CONNECT, which
+             * forbids the server from sending topic aliases. */
+            if( ( status == MQTTSuccess ) && ( propertyId == MQTT_PROPERTY_TOPIC_ALIAS ) )
+            {
+                LogError( ( "Incoming PUBLISH uses topic alias %lu, but topic aliases "
+                            "were not enabled towards the client.",
+                            ( unsigned long ) value ) );
+                status = MQTTBadResponse;
+            }
+        }
+
+        if( status == MQTTNoDataAvailable )
+        {
+            status = MQTTSuccess;
+        }
+
+        return status;
+    }
+
+/*-----------------------------------------------------------*/
+
+#endif /* if ( MQTT_VERSION_5_ENABLED != 0 ) */
+
 static bool calculatePublishPacketSize( const MQTTPublishInfo_t * pPublishInfo,
                                         size_t * pRemainingLength,
                                         size_t * pPacketSize )
@@ -581,6 +1315,11 @@ static bool calculatePublishPacketSize( const MQTTPublishInfo_t * pPublishInfo,
         packetSize += sizeof( uint16_t );
     }
 
+    #if ( MQTT_VERSION_5_ENABLED != 0 )
+        /* In MQTT 5 the variable header ends with the PUBLISH properties. */
+        packetSize += getPublishPropertiesSize( pPublishInfo );
+    #endif
+
     /* Calculate the maximum allowed size of the payload for the given parameters.
      * This calculation excludes the "Remaining length" encoding, whose size is not
      * yet known. */
@@ -776,6 +1515,11 @@ static void serializePublishCommon( const MQTTPublishInfo_t * pPublishInfo,
         pIndex = &pIndex[ 2U ];
     }
 
+    #if ( MQTT_VERSION_5_ENABLED != 0 )
+        /* The properties are placed after the packet identifier. */
+        pIndex = MQTT_SerializePublishProperties( pPublishInfo, pIndex );
+    #endif
+
     /* The payload is placed after the packet identifier.
      * Payload is copied over only if required by the flag serializePayload.
      * This will help reduce an unnecessary copy of the payload into the buffer.
@@ -942,6 +1686,13 @@ static bool incomingPacketValid( uint8_t packetType )
             status = true;
             break;
 
+            #if ( MQTT_VERSION_5_ENABLED != 0 )
+                /* An MQTT 5 server may close the connection with a DISCONNECT. */
+                case MQTT_PACKET_TYPE_DISCONNECT:
+                    status = true;
+                    break;
+            #endif
+
         case ( MQTT_PACKET_TYPE_PUBREL & 0xF0U ):
 
             /* The second bit of a PUBREL must be set. */
@@ -1054,121 +1805,125 @@ static MQTTStatus_t processPublishFlags( uint8_t publishFlags,
 
 /*-----------------------------------------------------------*/
 
-static void logConnackResponse( uint8_t responseCode )
-{
-    const char * const pConnackResponses[ 6 ] =
+#if ( MQTT_VERSION_5_ENABLED == 0 )
+
+    static void logConnackResponse( uint8_t responseCode )
     {
-        "Connection accepted.",                               /* 0 */
-        "Connection refused: unacceptable protocol version.", /* 1 */
-        "Connection refused: identifier rejected.",           /* 2 */
-        "Connection refused: server unavailable",             /* 3 */
-        "Connection refused: bad user name or password.",     /* 4 */
-        "Connection refused: not authorized."                 /* 5 */
-    };
+        const char * const pConnackResponses[ 6 ] =
+        {
+            "Connection accepted.",                               /* 0 */
+            "Connection refused: unacceptable protocol version.", /* 1 */
+            "Connection refused: identifier rejected.",           /* 2 */
+            "Connection refused: server unavailable",             /* 3 */
+            "Connection refused: bad user name or password.",     /* 4 */
+            "Connection refused: not authorized."                 /* 5 */
+        };
 
-    /* Avoid unused parameter warning when assert and logs are disabled. */
-    ( void ) responseCode;
-    ( void ) pConnackResponses;
+        /* Avoid unused parameter warning when assert and logs are disabled. */
+        ( void ) responseCode;
+        ( void ) pConnackResponses;
 
-    assert( responseCode <= 5U );
+        assert( responseCode <= 5U );
 
-    if( responseCode == 0u )
-    {
-        /* Log at Debug level for a success CONNACK response. */
-        LogDebug( ( "%s", pConnackResponses[ 0 ] ) );
-    }
-    else
-    {
-        /* Log an error based on the CONNACK response code. */
-        LogError( ( "%s", pConnackResponses[ responseCode ] ) );
+        if( responseCode == 0u )
+        {
+            /* Log at Debug level for a success CONNACK response. */
+            LogDebug( ( "%s", pConnackResponses[ 0 ] ) );
+        }
+        else
+        {
+            /* Log an error based on the CONNACK response code. */
+            LogError( ( "%s", pConnackResponses[ responseCode ] ) );
+        }
     }
-}
 
 /*-----------------------------------------------------------*/
 
-static MQTTStatus_t deserializeConnack( const MQTTPacketInfo_t * pConnack,
-                                        bool * pSessionPresent )
-{
-    MQTTStatus_t status = MQTTSuccess;
-    const uint8_t * pRemainingData = NULL;
-
-    assert( pConnack != NULL );
-    assert( pSessionPresent != NULL );
-    pRemainingData = pConnack->pRemainingData;
-
-    /* According to MQTT 3.1.1, the second byte of CONNACK must specify a
-     * "Remaining length" of 2. */
-    if( pConnack->remainingLength != MQTT_PACKET_CONNACK_REMAINING_LENGTH )
+    static MQTTStatus_t deserializeConnack( const MQTTPacketInfo_t * pConnack,
+                                            bool * pSessionPresent )
     {
-        LogError( ( "CONNACK does not have remaining length of %u.",
-                    ( unsigned int ) MQTT_PACKET_CONNACK_REMAINING_LENGTH ) );
+        MQTTStatus_t status = MQTTSuccess;
+        const uint8_t * pRemainingData = NULL;
 
-        status = MQTTBadResponse;
-    }
-
-    /* Check the reserved bits in CONNACK. The high 7 bits of the third byte
-     * in CONNACK must be 0. */
-    else if( ( pRemainingData[ 0 ] | 0x01U ) != 0x01U )
-    {
-        LogError( ( "Reserved bits in CONNACK incorrect." ) );
+        assert( pConnack != NULL );
+        assert( pSessionPresent != NULL );
+        pRemainingData = pConnack->pRemainingData;
 
-        status = MQTTBadResponse;
-    }
-    else
-    {
-        /* Determine if the "Session Present" bit is set. This is the lowest bit of
-         * the third byte in CONNACK. */
-        if( ( pRemainingData[ 0 ] & MQTT_PACKET_CONNACK_SESSION_PRESENT_MASK )
-            == MQTT_PACKET_CONNACK_SESSION_PRESENT_MASK )
+        /* According to MQTT 3.1.1, the second byte of CONNACK must specify a
+         * "Remaining length" of 2. */
+        if( pConnack->remainingLength != MQTT_PACKET_CONNACK_REMAINING_LENGTH )
         {
-            LogDebug( ( "CONNACK session present bit set." ) );
-            *pSessionPresent = true;
+            LogError( ( "CONNACK does not have remaining length of %u.",
+                        ( unsigned int ) MQTT_PACKET_CONNACK_REMAINING_LENGTH ) );
 
-            /* MQTT 3.1.1 specifies that the fourth byte in CONNACK must be 0 if the
-             * "Session Present" bit is set. */
-            if( pRemainingData[ 1 ] != 0U )
-            {
-                LogError( ( "Session Present bit is set, but connect return code in CONNACK is %u (nonzero).",
-                            ( unsigned int ) pRemainingData[ 1 ] ) );
-                status = MQTTBadResponse;
-            }
-        }
-        else
-        {
-            LogDebug( ( "CONNACK session present bit not set." ) );
-            *pSessionPresent = false;
+            status = MQTTBadResponse;
         }
-    }
 
-    if( status == MQTTSuccess )
-    {
-        /* In MQTT 3.1.1, only values 0 through 5 are valid CONNACK response codes. */
-        if( pRemainingData[ 1 ] > 5U )
+        /* Check the reserved bits in CONNACK. The high 7 bits of the third byte
+         * in CONNACK must be 0. */
+        else if( ( pRemainingData[ 0 ] | 0x01U ) != 0x01U )
         {
-            LogError( ( "CONNACK response %u is invalid.",
-                        ( unsigned int ) pRemainingData[ 1 ] ) );
+            LogError( ( "Reserved bits in CONNACK incorrect." ) );
 
             status = MQTTBadResponse;
         }
         else
         {
-            /* Print the appropriate message for the CONNACK response code if logs are
-             * enabled. */
-            logConnackResponse( pRemainingData[ 1 ] );
+            /* Determine if the "Session Present" bit is set. This is the lowest bit of
+             * the third byte in CONNACK. */
+            if( ( pRemainingData[ 0 ] & MQTT_PACKET_CONNACK_SESSION_PRESENT_MASK )
+                == MQTT_PACKET_CONNACK_SESSION_PRESENT_MASK )
+            {
+                LogDebug( ( "CONNACK session present bit set." ) );
+                *pSessionPresent = true;
+
+                /* MQTT 3.1.1 specifies that the fourth byte in CONNACK must be 0 if the
+                 * "Session Present" bit is set. */
+                if( pRemainingData[ 1 ] != 0U )
+                {
+                    LogError( ( "Session Present bit is set, but connect return code in CONNACK is %u (nonzero).",
+                                ( unsigned int ) pRemainingData[ 1 ] ) );
+                    status = MQTTBadResponse;
+                }
+            }
+            else
+            {
+                LogDebug( ( "CONNACK session present bit not set." ) );
+                *pSessionPresent = false;
+            }
+        }
+
+        if( status == MQTTSuccess )
+        {
+            /* In MQTT 3.1.1, only values 0 through 5 are valid CONNACK response codes. */
+            if( pRemainingData[ 1 ] > 5U )
+            {
+                LogError( ( "CONNACK response %u is invalid.",
+                            ( unsigned int ) pRemainingData[ 1 ] ) );
 
-            /* A nonzero CONNACK response code means the connection was refused. */
-            if( pRemainingData[ 1 ] > 0U )
+                status = MQTTBadResponse;
+            }
+            else
             {
-                status = MQTTServerRefused;
+                /* Print the appropriate message for the CONNACK response code if logs are
+                 * enabled. */
+                logConnackResponse( pRemainingData[ 1 ] );
+
+                /* A nonzero CONNACK response code means the connection was refused. */
+                if( pRemainingData[ 1 ] > 0U )
+                {
+                    status = MQTTServerRefused;
+                }
             }
         }
-    }
 
-    return status;
-}
+        return status;
+    }
 
 /*-----------------------------------------------------------*/
 
+#endif /* if ( MQTT_VERSION_5_ENABLED == 0 ) */
+
 static MQTTStatus_t calculateSubscriptionPacketSize( const MQTTSubscribeInfo_t * pSubscriptionList,
                                                      size_t subscriptionCount,
                                                      size_t * pRemainingLength,
@@ -1187,6 +1942,11 @@ static MQTTStatus_t calculateSubscriptionPacketSize( const MQTTSubscribeInfo_t *
      * identifier. */
     packetSize += sizeof( uint16_t );
 
+    #if ( MQTT_VERSION_5_ENABLED != 0 )
+        /* In MQTT 5 it is followed by an empty property length. */
+        packetSize += 1U;
+    #endif
+
     /* Sum the lengths of all subscription topic filters; add 1 byte for each
      * subscription's QoS if type is MQTT_SUBSCRIBE. */
     for( i = 0; i < subscriptionCount; i++ )
@@ -1269,6 +2029,11 @@ static MQTTStatus_t readSubackStatus( size_t statusCount,
             case 0x01:
             case 0x02:
 
+                #if ( MQTT_VERSION_5_ENABLED != 0 )
+                    /* "No subscription existed" in an MQTT 5 UNSUBACK. */
+                    case 0x11:
+                #endif
+
                 LogDebug( ( "Topic filter %lu accepted, max QoS %u.",
                             ( unsigned long ) i,
                             ( unsigned int ) subscriptionStatus ) );
@@ -1284,11 +2049,26 @@ static MQTTStatus_t readSubackStatus( size_t statusCount,
                 break;
 
             default:
-                LogError( ( "Bad SUBSCRIBE status %u.",
-                            ( unsigned int ) subscriptionStatus ) );
-
                 status = MQTTBadResponse;
 
+                #if ( MQTT_VERSION_5_ENABLED != 0 )
+                    /* MQTT 5 has a reason code for each way a topic filter
+                     * can be refused. */
+                    if( subscriptionStatus >= MQTT_REASON_CODE_FAILURE )
+                    {
+                        LogWarn( ( "Topic filter %lu refused with reason code 0x%02x.",
+                                   ( unsigned long ) i,
+                                   ( unsigned int ) subscriptionStatus ) );
+                        status = MQTTServerRefused;
+                    }
+                #endif
+
+                if( status == MQTTBadResponse )
+                {
+                    LogError( ( "Bad SUBSCRIBE status %u.",
+                                ( unsigned int ) subscriptionStatus ) );
+                }
+
                 break;
         }
 
@@ -1309,6 +2089,7 @@ static MQTTStatus_t deserializeSuback( const MQTTPacketInfo_t * pSuback,
 {
     MQTTStatus_t status = MQTTSuccess;
     size_t remainingLength;
+    size_t propertiesSize = 0U;
     const uint8_t * pVariableHeader = NULL;
 
     assert( pSuback != NULL );
@@ -1338,8 +2119,26 @@ static MQTTStatus_t deserializeSuback( const MQTTPacketInfo_t * pSuback,
         }
         else
         {
-            status = readSubackStatus( remainingLength - sizeof( uint16_t ),
-                                       &pVariableHeader[ sizeof( uint16_t ) ] );
+            #if ( MQTT_VERSION_5_ENABLED != 0 )
+                /* In MQTT 5 the properties sit between the packet identifier
+                 * and the reason codes. */
+                status = skipProperties( &pVariableHeader[ sizeof( uint16_t ) ],
+                                         remainingLength - sizeof( uint16_t ),
+                                         &propertiesSize );
+
+                if( ( status == MQTTSuccess ) &&
+                    ( ( sizeof( uint16_t ) + propertiesSize ) >= remainingLength ) )
+                {
+                    LogError( ( "SUBACK or UNSUBACK has no reason codes." ) );
+                    status = MQTTBadResponse;
+                }
+            #endif
+
+            if( status == MQTTSuccess )
+            {
+                status = readSubackStatus( remainingLength - sizeof( uint16_t ) - propertiesSize,
+                                           &pVariableHeader[ sizeof( uint16_t ) + propertiesSize ] );
+            }
         }
     }
 
@@ -1412,6 +2211,10 @@ static MQTTStatus_t deserializePublish( const MQTTPacketInfo_t * pIncomingPacket
     MQTTStatus_t status = MQTTSuccess;
     const uint8_t * pVariableHeader, * pPacketIdentifierHigh = NULL;
 
+    #if ( MQTT_VERSION_5_ENABLED != 0 )
+        size_t propertiesSize = 0U;
+    #endif
+
     assert( pIncomingPacket != NULL );
     assert( pPacketId != NULL );
     assert( pPublishInfo != NULL );
@@ -1475,6 +2278,29 @@ static MQTTStatus_t deserializePublish( const MQTTPacketInfo_t * pIncomingPacket
         }
     }
 
+    #if ( MQTT_VERSION_5_ENABLED != 0 )
+        if( status == MQTTSuccess )
+        {
+            /* The server cannot use a topic alias, so the topic name must be
+             * present. */
+            if( pPublishInfo->topicNameLength == 0U )
+            {
+                LogError( ( "Incoming PUBLISH has an empty topic name." ) );
+                status = MQTTBadResponse;
+            }
+            else
+            {
+                /* The properties follow the variable header. The checks of
+                 * the remaining length above guarantee that the subtraction
+                 * does not wrap. */
+                status = readPublishProperties( pPacketIdentifierHigh,
+                                                pIncomingPacket->remainingLength -
+                                                ( size_t ) ( pPacketIdentifierHigh - pVariableHeader ),
+                                                &propertiesSize );
+            }
+        }
+    #endif /* if ( MQTT_VERSION_5_ENABLED != 0 ) */
+
     if( status == MQTTSuccess )
     {
         /* Calculate the length of the payload. QoS 1 or 2 PUBLISH packets contain
@@ -1487,6 +2313,13 @@ static MQTTStatus_t deserializePublish( const MQTTPacketInfo_t * pIncomingPacket
             pPublishInfo->payloadLength -= sizeof( uint16_t );
         }
 
+        #if ( MQTT_VERSION_5_ENABLED != 0 )
+            /* The payload follows the properties. */
+            pPublishInfo->payloadLength -= propertiesSize;
+            pPacketIdentifierHigh = &pPacketIdentifierHigh[ propertiesSize ];
+            pPublishInfo->topicAlias = 0U;
+        #endif
+
         /* Set payload if it exists. */
         pPublishInfo->pPayload = ( pPublishInfo->payloadLength != 0U ) ? pPacketIdentifierHigh : NULL;
 
@@ -1507,15 +2340,34 @@ static MQTTStatus_t deserializeSimpleAck( const MQTTPacketInfo_t * pAck,
     assert( pAck != NULL );
     assert( pPacketIdentifier != NULL );
 
-    /* Check that the "Remaining length" of the received ACK is 2. */
-    if( pAck->remainingLength != MQTT_PACKET_SIMPLE_ACK_REMAINING_LENGTH )
-    {
-        LogError( ( "ACK does not have remaining length of %u.",
-                    ( unsigned int ) MQTT_PACKET_SIMPLE_ACK_REMAINING_LENGTH ) );
+    #if ( MQTT_VERSION_5_ENABLED != 0 )
 
-        status = MQTTBadResponse;
-    }
-    else
+        /* An MQTT 5 ACK may follow the packet identifier with a reason code
+         * and properties. */
+        if( pAck->remainingLength < MQTT_PACKET_SIMPLE_ACK_REMAINING_LENGTH )
+        {
+            LogError( ( "ACK cannot have a remaining length less than %u.",
+                        ( unsigned int ) MQTT_PACKET_SIMPLE_ACK_REMAINING_LENGTH ) );
+
+            status = MQTTBadResponse;
+        }
+        else
+        {
+            status = checkReasonCodeAndProperties( pAck, MQTT_PACKET_SIMPLE_ACK_REMAINING_LENGTH );
+        }
+    #else /* if ( MQTT_VERSION_5_ENABLED != 0 ) */
+
+        /* Check that the "Remaining length" of the received ACK is 2. */
+        if( pAck->remainingLength != MQTT_PACKET_SIMPLE_ACK_REMAINING_LENGTH )
+        {
+            LogError( ( "ACK does not have remaining length of %u.",
+                        ( unsigned int ) MQTT_PACKET_SIMPLE_ACK_REMAINING_LENGTH ) );
+
+            status = MQTTBadResponse;
+        }
+    #endif /* if ( MQTT_VERSION_5_ENABLED != 0 ) */
+
+    if( status == MQTTSuccess )
     {
         /* Extract the packet identifier (third and fourth bytes) from ACK. */
         *pPacketIdentifier = UINT16_DECODE( pAck->pRemainingData );
@@ -1576,7 +2428,11 @@ uint8_t * MQTT_SerializeConnectFixedHeader( uint8_t * pIndex,
     pIndexLocal = encodeString( pIndexLocal, "MQTT", 4 );
 
     /* The MQTT protocol version is the second field of the variable header. */
-    *pIndexLocal = MQTT_VERSION_3_1_1;
+    #if ( MQTT_VERSION_5_ENABLED != 0 )
+        *pIndexLocal = MQTT_VERSION_5;
+    #else
+        *pIndexLocal = MQTT_VERSION_3_1_1;
+    #endif
     pIndexLocal++;
 
     /* Set the clean session flag if needed. */
@@ -1629,6 +2485,35 @@ uint8_t * MQTT_SerializeConnectFixedHeader( uint8_t * pIndex,
     pIndexLocal[ 1 ] = UINT16_LOW_BYTE( pConnectInfo->keepAliveSeconds );
     pIndexLocal = &pIndexLocal[ 2 ];
 
+    #if ( MQTT_VERSION_5_ENABLED != 0 )
+        /* The MQTT 5 properties end the variable header. */
+        pIndexLocal = encodeRemainingLength( pIndexLocal, getConnectPropertiesLength( pConnectInfo ) );
+
+        if( pConnectInfo->sessionExpiryInterval != 0U )
+        {
+            pIndexLocal = encodeIntegerProperty( pIndexLocal,
+                                                 MQTT_PROPERTY_SESSION_EXPIRY_INTERVAL,
+                                                 pConnectInfo->sessionExpiryInterval,
+                                                 sizeof( uint32_t ) );
+        }
+
+        if( pConnectInfo->receiveMaximum != 0U )
+        {
+            pIndexLocal = encodeIntegerProperty( pIndexLocal,
+                                                 MQTT_PROPERTY_RECEIVE_MAXIMUM,
+                                                 pConnectInfo->receiveMaximum,
+                                                 sizeof( uint16_t ) );
+        }
+
+        if( pConnectInfo->maximumPacketSize != 0U )
+        {
+            pIndexLocal = encodeIntegerProperty( pIndexLocal,
+                                                 MQTT_PROPERTY_MAXIMUM_PACKET_SIZE,
+                                                 pConnectInfo->maximumPacketSize,
+                                                 sizeof( uint32_t ) );
+        }
+    #endif /* if ( MQTT_VERSION_5_ENABLED != 0 ) */
+
     return pIndexLocal;
 }
 /*-----------------------------------------------------------*/
@@ -1660,6 +2545,12 @@ static void serializeConnectPacket( const MQTTConnectInfo_t * pConnectInfo,
     /* Write the will topic name and message into the CONNECT packet if provided. */
     if( pWillInfo != NULL )
     {
+        #if ( MQTT_VERSION_5_ENABLED != 0 )
+            /* The will properties come first. The library sends none. */
+            *pIndex = 0U;
+            pIndex++;
+        #endif
+
         pIndex = encodeString( pIndex,
                                pWillInfo->pTopicName,
                                pWillInfo->topicNameLength );
@@ -1743,6 +2634,21 @@ MQTTStatus_t MQTT_GetConnectPacketSize( const MQTTConnectInfo_t * pConnectInfo,
                                  pWillInfo->payloadLength + sizeof( uint16_t );
         }
 
+        #if ( MQTT_VERSION_5_ENABLED != 0 )
+        {
+            /* Add the CONNECT properties and their length, and the length of
+             * the will properties, which are always empty. */
+            size_t propertiesLength = getConnectPropertiesLength( pConnectInfo );
+
+            connectPacketSize += remainingLengthEncodedSize( propertiesLength ) + propertiesLength;
+
+            if( pWillInfo != NULL )
+            {
+                connectPacketSize += 1U;
+            }
+        }
+        #endif /* if ( MQTT_VERSION_5_ENABLED != 0 ) */
+
         /* Add the lengths of the user name and password if provided. */
         if( pConnectInfo->pUserName != NULL )
         {
@@ -1906,6 +2812,12 @@ uint8_t * MQTT_SerializeSubscribeHeader( size_t remainingLength,
     /* Advance the pointer. */
     pIterator = &pIterator[ 2 ];
 
+    #if ( MQTT_VERSION_5_ENABLED != 0 )
+        /* The library sends no SUBSCRIBE properties. */
+        *pIterator = 0U;
+        pIterator++;
+    #endif
+
     return pIterator;
 }
 
@@ -1930,6 +2842,12 @@ uint8_t * MQTT_SerializeUnsubscribeHeader( size_t remainingLength,
     /* Increment the pointer. */
     pIterator = &pIterator[ 2 ];
 
+    #if ( MQTT_VERSION_5_ENABLED != 0 )
+        /* The library sends no UNSUBSCRIBE properties. */
+        *pIterator = 0U;
+        pIterator++;
+    #endif
+
     return pIterator;
 }
 
@@ -2073,7 +2991,7 @@ MQTTStatus_t MQTT_GetPublishPacketSize( const MQTTPublishInfo_t * pPublishInfo,
                     ( void * ) pPacketSize ) );
         status = MQTTBadParameter;
     }
-    else if( ( pPublishInfo->pTopicName == NULL ) || ( pPublishInfo->topicNameLength == 0U ) )
+    else if( publishTopicValid( pPublishInfo ) == false )
     {
         LogError( ( "Invalid topic name for PUBLISH: pTopicName=%p, "
                     "topicNameLength=%hu.",
@@ -2132,7 +3050,7 @@ MQTTStatus_t MQTT_SerializePublish( const MQTTPublishInfo_t * pPublishInfo,
                     pPublishInfo->pPayload ) );
         status = MQTTBadParameter;
     }
-    else if( ( pPublishInfo->pTopicName == NULL ) || ( pPublishInfo->topicNameLength == 0U ) )
+    else if( publishTopicValid( pPublishInfo ) == false )
     {
         LogError( ( "Invalid topic name for PUBLISH: pTopicName=%p, "
                     "topicNameLength=%hu.",
@@ -2209,7 +3127,7 @@ MQTTStatus_t MQTT_SerializePublishHeader( const MQTTPublishInfo_t * pPublishInfo
         LogError( ( "Argument cannot be NULL: pFixedBuffer->pBuffer is NULL." ) );
         status = MQTTBadParameter;
     }
-    else if( ( pPublishInfo->pTopicName == NULL ) || ( pPublishInfo->topicNameLength == 0U ) )
+    else if( publishTopicValid( pPublishInfo ) == false )
     {
         LogError( ( "Invalid topic name for publish: pTopicName=%p, "
                     "topicNameLength=%hu.",
@@ -2491,6 +3409,10 @@ MQTTStatus_t MQTT_DeserializeAck( const MQTTPacketInfo_t * pIncomingPacket,
 {
     MQTTStatus_t status = MQTTSuccess;
 
+    #if ( MQTT_VERSION_5_ENABLED != 0 )
+        MQTTConnackProperties_t connackProperties = { 0 };
+    #endif
+
     if( pIncomingPacket == NULL )
     {
         LogError( ( "pIncomingPacket cannot be NULL." ) );
@@ -2498,10 +3420,11 @@ MQTTStatus_t MQTT_DeserializeAck( const MQTTPacketInfo_t * pIncomingPacket,
     }
 
     /* Pointer for packet identifier cannot be NULL for packets other than
-     * CONNACK and PINGRESP. */
+     * CONNACK, PINGRESP and DISCONNECT. */
     else if( ( pPacketId == NULL ) &&
              ( ( pIncomingPacket->type != MQTT_PACKET_TYPE_CONNACK ) &&
-               ( pIncomingPacket->type != MQTT_PACKET_TYPE_PINGRESP ) ) )
+               ( pIncomingPacket->type != MQTT_PACKET_TYPE_PINGRESP ) &&
+               ( pIncomingPacket->type != MQTT_PACKET_TYPE_DISCONNECT ) ) )
     {
         LogError( ( "pPacketId cannot be NULL for packet type %02x.",
                     ( unsigned int ) pIncomingPacket->type ) );
@@ -2529,10 +3452,18 @@ MQTTStatus_t MQTT_DeserializeAck( const MQTTPacketInfo_t * pIncomingPacket,
         switch( pIncomingPacket->type )
         {
             case MQTT_PACKET_TYPE_CONNACK:
-                status = deserializeConnack( pIncomingPacket, pSessionPresent );
+                #if ( MQTT_VERSION_5_ENABLED != 0 )
+                    status = deserializeConnackV5( pIncomingPacket, pSessionPresent, &connackProperties );
+                #else
+                    status = deserializeConnack( pIncomingPacket, pSessionPresent );
+                #endif
                 break;
 
             case MQTT_PACKET_TYPE_SUBACK:
+            #if ( MQTT_VERSION_5_ENABLED != 0 )
+                /* An MQTT 5 UNSUBACK has the same layout as a SUBACK. */
+                case MQTT_PACKET_TYPE_UNSUBACK:
+            #endif
                 status = deserializeSuback( pIncomingPacket, pPacketId );
                 break;
 
@@ -2540,7 +3471,9 @@ MQTTStatus_t MQTT_DeserializeAck( const MQTTPacketInfo_t * pIncomingPacket,
                 status = deserializePingresp( pIncomingPacket );
                 break;
 
-            case MQTT_PACKET_TYPE_UNSUBACK:
+            #if ( MQTT_VERSION_5_ENABLED == 0 )
+                case MQTT_PACKET_TYPE_UNSUBACK:
+            #endif
             case MQTT_PACKET_TYPE_PUBACK:
             case MQTT_PACKET_TYPE_PUBREC:
             case MQTT_PACKET_TYPE_PUBREL:
@@ -2548,6 +3481,12 @@ MQTTStatus_t MQTT_DeserializeAck( const MQTTPacketInfo_t * pIncomingPacket,
                 status = deserializeSimpleAck( pIncomingPacket, pPacketId );
                 break;
 
+            #if ( MQTT_VERSION_5_ENABLED != 0 )
+                case MQTT_PACKET_TYPE_DISCONNECT:
+                    status = checkReasonCodeAndProperties( pIncomingPacket, 0U );
+                    break;
+            #endif
+
             /* Any other packet type is invalid. */
             default:
                 LogError( ( "IotMqtt_DeserializeResponse() called with unknown packet type:(%02x).",
@@ -2682,3 +3621,152 @@ MQTTStatus_t MQTT_ProcessIncomingPacketTypeAndLength( const uint8_t * pBuffer,
 }
 
 /*-----------------------------------------------------------*/
+
+#if ( MQTT_VERSION_5_ENABLED != 0 )
+
+    MQTTStatus_t MQTT_DeserializeConnack( const MQTTPacketInfo_t * pIncomingPacket,
+                                          bool * pSessionPresent,
+                                          MQTTConnackProperties_t * pConnackProperties )
+    {
+        MQTTStatus_t status = MQTTSuccess;
+
+        if( ( pIncomingPacket == NULL ) || ( pSessionPresent == NULL ) ||
+            ( pConnackProperties == NULL ) )
+        {
+            LogError( ( "Argument cannot be NULL: pIncomingPacket=%p, "
+                        "pSessionPresent=%p, pConnackProperties=%p.",
+                        ( void * ) pIncomingPacket,
+                        ( void * ) pSessionPresent,
+                        ( void * ) pConnackProperties ) );
+            status = MQTTBadParameter;
+        }
+        else if( pIncomingPacket->type != MQTT_PACKET_TYPE_CONNACK )
+        {
+            LogError( ( "Packet type %02x is not a CONNACK.",
+                        ( unsigned int ) pIncomingPacket->type ) );
+            status = MQTTBadParameter;
+        }
+        else if( pIncomingPacket->pRemainingData == NULL )
+        {
+            LogError( ( "Remaining data of incoming packet is NULL." ) );
+            status = MQTTBadParameter;
+        }
+        else
+        {
+            /* Set the values the server implies by leaving a property out. The
+             * session expiry interval defaults to the one the client sent. */
+            pConnackProperties->reasonCode = 0U;
+            pConnackProperties->receiveMaximum = UINT16_MAX;
+            pConnackProperties->topicAliasMaximum = 0U;
+            pConnackProperties->maximumPacketSize = 0U;
+            pConnackProperties->maximumQoS = MQTTQoS2;
+            pConnackProperties->retainAvailable = true;
+            pConnackProperties->serverKeepAlive = 0U;
+
+            status = deserializeConnackV5( pIncomingPacket, pSessionPresent, pConnackProperties );
+        }
+
+        return status;
+    }
+
+/*-----------------------------------------------------------*/
+
+    MQTTStatus_t MQTT_GetReasonCode( const MQTTPacketInfo_t * pIncomingPacket,
+                                     uint8_t * pReasonCode )
+    {
+        MQTTStatus_t status = MQTTSuccess;
+        size_t reasonCodeOffset = 0U;
+
+        if( ( pIncomingPacket == NULL ) || ( pReasonCode == NULL ) )
+        {
+            LogError( ( "Argument cannot be NULL: pIncomingPacket=%p, pReasonCode=%p.",
+                        ( void * ) pIncomingPacket,
+                        ( void * ) pReasonCode ) );
+            status = MQTTBadParameter;
+        }
+        else
+        {
+            /* The reason code follows the acknowledge flags of a CONNACK and
+             * the packet identifier of a publish acknowledgment. */
+            switch( pIncomingPacket->type )
+            {
+                case MQTT_PACKET_TYPE_CONNACK:
+                    reasonCodeOffset = 1U;
+                    break;
+
+                case MQTT_PACKET_TYPE_PUBACK:
+                case MQTT_PACKET_TYPE_PUBREC:
+                case MQTT_PACKET_TYPE_PUBREL:
+                case MQTT_PACKET_TYPE_PUBCOMP:
+                    reasonCodeOffset = sizeof( uint16_t );
+                    break;
+
+                case MQTT_PACKET_TYPE_DISCONNECT:
+                    reasonCodeOffset = 0U;
+                    break;
+
+                default:
+                    LogError( ( "Packet type %02x does not have a single reason code.",
+                                ( unsigned int ) pIncomingPacket->type ) );
+                    status = MQTTBadParameter;
+                    break;
+            }
+        }
+
+        if( status == MQTTSuccess )
+        {
+            if( pIncomingPacket->remainingLength > reasonCodeOffset )
+            {
+                assert( pIncomingPacket->pRemainingData != NULL );
+                *pReasonCode = pIncomingPacket->pRemainingData[ reasonCodeOffset ];
+            }
+            else
+            {
+                /* A left out reason code means Success. */
+                *pReasonCode = 0U;
+            }
+        }
+
+        return status;
+    }
+
+/*-----------------------------------------------------------*/
+
+    uint8_t * MQTT_SerializePublishProperties( const MQTTPublishInfo_t * pPublishInfo,
+                                               uint8_t * pIndex )
+    {
+        uint8_t * pIndexLocal = pIndex;
+
+        assert( pPublishInfo != NULL );
+        assert( pIndex != NULL );
+
+        /* The property length is followed by the topic alias, if one is set. */
+        *pIndexLocal = ( uint8_t ) ( getPublishPropertiesSize( pPublishInfo ) - 1U );
+        pIndexLocal++;
+
+        if( pPublishInfo->topicAlias != 0U )
+        {
+            pIndexLocal = encodeIntegerProperty( pIndexLocal,
+                                                 MQTT_PROPERTY_TOPIC_ALIAS,
+                                                 pPublishInfo->topicAlias,
+                                                 sizeof( uint16_t ) );
+        }
+
+        return pIndexLocal;
+    }
+
+/*-----------------------------------------------------------*/
+
+    MQTTStatus_t MQTT_SkipProperties( const uint8_t * pSource,
+                                      size_t sourceLength,
+                                      size_t * pSize )
+    {
+        assert( pSource != NULL );
+        assert( pSize != NULL );
+
+        return skipProperties( pSource, sourceLength, pSize );
+    }
+
+/*-----------------------------------------------------------*/
+
+#endif /* if ( MQTT_VERSION_5_ENABLED != 0 ) */
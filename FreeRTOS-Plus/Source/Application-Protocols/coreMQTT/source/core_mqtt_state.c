@@ -71,6 +71,64 @@ static const size_t ZERO_SIZE_T = 0U;
  */
 #define UINT16_CHECK_BIT( x, position )         ( ( ( x ) & ( UINT16_BITMAP_BIT_SET_AT( position ) ) ) == ( UINT16_BITMAP_BIT_SET_AT( position ) ) )
 
+/**
+ * @brief Link value stored in a record to refer to the record at an index.
+ *
+ * @param[in] index Index of the record in the records array.
+ */
+#define RECORD_LINK( index )                    ( ( uint16_t ) ( ( index ) + 1U ) )
+
+/**
+ * @brief Index in the records array of the record a non-zero link refers to.
+ *
+ * @param[in] link Link to the record.
+ */
+#define RECORD_INDEX( link )                    ( ( size_t ) ( link ) - 1U )
+
+/**
+ * @brief Index at which the search for a packet ID in a records array starts.
+ *
+ * Packet IDs are usually allocated in sequence, so consecutive IDs land in
+ * consecutive slots and rarely have to be moved past each other.
+ *
+ * @param[in] packetId The packet ID.
+ * @param[in] recordCount Length of the records array. Must be non-zero.
+ */
+#define RECORD_HOME( packetId, recordCount )    ( ( size_t ) ( packetId ) % ( recordCount ) )
+
+/**
+ * @brief Number of slots a record is stored after its home index.
+ *
+ * @param[in] index Index of the record in the records array.
+ * @param[in] packetId The packet ID of the record.
+ * @param[in] recordCount Length of the records array. Must be non-zero.
+ */
+#define RECORD_DISTANCE( index, packetId, recordCount ) \
+    ( ( ( index ) + ( recordCount ) - RECORD_HOME( packetId, recordCount ) ) % ( recordCount ) )
+
+/**
+ * @brief Cursor value for the record visited last and the record after it.
+ *
+ * @param[in] lastId Packet ID of the record visited last.
+ * @param[in] nextId Packet ID of the record after it, or
+ * #MQTT_PACKET_ID_INVALID if there is none.
+ */
+#define CURSOR_VALUE( lastId, nextId )          ( ( ( MQTTStateCursor_t ) ( nextId ) << 16U ) | ( MQTTStateCursor_t ) ( lastId ) )
+
+/**
+ * @brief Packet ID of the record a cursor visited last.
+ *
+ * @param[in] cursor The cursor.
+ */
+#define CURSOR_LAST_ID( cursor )                ( ( uint16_t ) ( ( cursor ) & 0xFFFFU ) )
+
+/**
+ * @brief Packet ID of the record after the one a cursor visited last.
+ *
+ * @param[in] cursor The cursor.
+ */
+#define CURSOR_NEXT_ID( cursor )                ( ( uint16_t ) ( ( cursor ) >> 16U ) )
+
 /*-----------------------------------------------------------*/
 
 /**
@@ -115,6 +173,25 @@ static bool validateTransitionAck( MQTTPublishState_t currentState,
 static bool isPublishOutgoing( MQTTPubAckType_t packetType,
                                MQTTStateOperation_t opType );
 
+/**
+ * @brief Find the slot at which a packet ID is, or would be, stored.
+ *
+ * Records are stored in an open-addressed hash table, starting at
+ * #RECORD_HOME. Within each run of used slots the records are ordered by
+ * their distance from their home index, so the search stops at a free slot or
+ * at a record closer to its home than the packet ID would be at that slot.
+ *
+ * @param[in] records State record array.
+ * @param[in] recordCount Length of record array.
+ * @param[in] packetId packet ID to search for.
+ *
+ * @return Index of the slot holding the packet ID or of the slot it belongs
+ * in, else #MQTT_INVALID_STATE_COUNT if no such slot exists.
+ */
+static size_t probeRecords( const MQTTPubAckInfo_t * records,
+                            size_t recordCount,
+                            uint16_t packetId );
+
 /**
  * @brief Find a packet ID in the state record.
  *
@@ -124,7 +201,7 @@ static bool isPublishOutgoing( MQTTPubAckType_t packetType,
  * @param[out] pQos QoS retrieved from record.
  * @param[out] pCurrentState state retrieved from record.
  *
- * @return index of the packet id in the record if it exists, else the record length.
+ * @return index of the packet id in the record if it exists, else #MQTT_INVALID_STATE_COUNT.
  */
 static size_t findInRecord( const MQTTPubAckInfo_t * records,
                             size_t recordCount,
@@ -133,21 +210,57 @@ static size_t findInRecord( const MQTTPubAckInfo_t * records,
                             MQTTPublishState_t * pCurrentState );
 
 /**
- * @brief Compact records.
+ * @brief Append a record to the list of records in the order they were added.
+ *
+ * The order is kept to meet the message ordering requirement of MQTT spec
+ * 3.1.1 when publishes and PUBRELs are resent.
+ *
+ * @param[in] records State record array.
+ * @param[in] recordIndex Index of the record to append.
+ */
+static void linkRecord( MQTTPubAckInfo_t * records,
+                        size_t recordIndex );
+
+/**
+ * @brief Remove a record from the list of records in the order they were added.
+ *
+ * @param[in] records State record array.
+ * @param[in] recordIndex Index of the record to remove.
+ */
+static void unlinkRecord( MQTTPubAckInfo_t * records,
+                          size_t recordIndex );
+
+/**
+ * @brief Move a record to a free slot, keeping its place in the order.
+ *
+ * @param[in] records State record array.
+ * @param[in] fromIndex Index of the record to move.
+ * @param[in] toIndex Index of the free slot.
+ */
+static void relocateRecord( MQTTPubAckInfo_t * records,
+                            size_t fromIndex,
+                            size_t toIndex );
+
+/**
+ * @brief Delete an entry from the state record.
  *
- * Records are arranged in the relative order to maintain message ordering.
- * This will lead to fragmentation and this function will help in defragmenting
- * the records array.
+ * Records following the freed slot are shifted back by one slot until one
+ * at its home index is reached, so that no tombstones are needed.
  *
  * @param[in] records State record array.
  * @param[in] recordCount Length of record array.
+ * @param[in] recordIndex Index of the record to delete.
  */
-static void compactRecords( MQTTPubAckInfo_t * records,
-                            size_t recordCount );
+static void deleteRecord( MQTTPubAckInfo_t * records,
+                          size_t recordCount,
+                          size_t recordIndex );
 
 /**
  * @brief Store a new entry in the state record.
  *
+ * Records at and after the slot of the new entry are shifted forward by one
+ * slot up to the next free slot.
+ *
  * @param[in] records State record array.
  * @param[in] recordCount Length of record array.
  * @param[in] packetId Packet ID of new entry.
@@ -166,22 +279,37 @@ static MQTTStatus_t addRecord( MQTTPubAckInfo_t * records,
  * @brief Update and possibly delete an entry in the state record.
  *
  * @param[in] records State record array.
+ * @param[in] recordCount Length of record array.
  * @param[in] recordIndex index of record to update.
  * @param[in] newState New state to update.
  * @param[in] shouldDelete Whether an existing entry should be deleted.
  */
 static void updateRecord( MQTTPubAckInfo_t * records,
+                          size_t recordCount,
                           size_t recordIndex,
                           MQTTPublishState_t newState,
                           bool shouldDelete );
 
 /**
- * @brief Get the packet ID and index of an outgoing publish in specified
- * states.
+ * @brief Find the record a search with a cursor resumes with.
+ *
+ * @param[in] records State record array.
+ * @param[in] recordCount Length of record array. Must be non-zero.
+ * @param[in] cursor Cursor of the search.
+ *
+ * @return Link to the record, or 0 if no records are left to visit.
+ */
+static uint16_t cursorResumeLink( const MQTTPubAckInfo_t * records,
+                                  size_t recordCount,
+                                  MQTTStateCursor_t cursor );
+
+/**
+ * @brief Get the packet ID of the next outgoing publish, in the order the
+ * publishes were added, that is in one of the specified states.
  *
  * @param[in] pMqttContext Initialized MQTT context.
  * @param[in] searchStates The states to search for in 2-byte bit map.
- * @param[in,out] pCursor Index at which to start searching.
+ * @param[in,out] pCursor Position after which to start searching.
  *
  * @return Packet ID of the outgoing publish.
  */
@@ -196,7 +324,6 @@ static uint16_t stateSelect( const MQTTContext_t * pMqttContext,
  * @param[in] records State records pointer.
  * @param[in] maxRecordCount The maximum number of records.
  * @param[in] recordIndex Index at which the record is stored.
- * @param[in] packetId Packet id of the packet.
  * @param[in] currentState Current state of the publish record.
  * @param[in] newState New state of the publish.
  *
@@ -205,7 +332,6 @@ static uint16_t stateSelect( const MQTTContext_t * pMqttContext,
 static MQTTStatus_t updateStateAck( MQTTPubAckInfo_t * records,
                                     size_t maxRecordCount,
                                     size_t recordIndex,
-                                    uint16_t packetId,
                                     MQTTPublishState_t currentState,
                                     MQTTPublishState_t newState );
 
@@ -445,29 +571,57 @@ static bool isPublishOutgoing( MQTTPubAckType_t packetType,
 
 /*-----------------------------------------------------------*/
 
-static size_t findInRecord( const MQTTPubAckInfo_t * records,
+static size_t probeRecords( const MQTTPubAckInfo_t * records,
                             size_t recordCount,
-                            uint16_t packetId,
-                            MQTTQoS_t * pQos,
-                            MQTTPublishState_t * pCurrentState )
+                            uint16_t packetId )
 {
-    size_t index = 0;
+    size_t index = MQTT_INVALID_STATE_COUNT;
+    size_t probe = 0;
+    size_t distance = 0;
 
     assert( packetId != MQTT_PACKET_ID_INVALID );
 
-    *pCurrentState = MQTTStateNull;
+    if( recordCount > 0U )
+    {
+        probe = RECORD_HOME( packetId, recordCount );
+    }
 
-    for( index = 0; index < recordCount; index++ )
+    for( distance = 0; ( distance < recordCount ) && ( index == MQTT_INVALID_STATE_COUNT ); distance++ )
     {
-        if( records[ index ].packetId == packetId )
+        if( ( records[ probe ].packetId == packetId ) ||
+            ( records[ probe ].packetId == MQTT_PACKET_ID_INVALID ) ||
+            ( RECORD_DISTANCE( probe, records[ probe ].packetId, recordCount ) < distance ) )
         {
-            *pQos = records[ index ].qos;
-            *pCurrentState = records[ index ].publishState;
-            break;
+            index = probe;
+        }
+        else
+        {
+            probe = ( probe + 1U ) % recordCount;
         }
     }
 
-    if( index == recordCount )
+    return index;
+}
+
+/*-----------------------------------------------------------*/
+
+static size_t findInRecord( const MQTTPubAckInfo_t * records,
+                            size_t recordCount,
+                            uint16_t packetId,
+                            MQTTQoS_t * pQos,
+                            MQTTPublishState_t * pCurrentState )
+{
+    size_t index = probeRecords( records, recordCount, packetId );
+
+    *pCurrentState = MQTTStateNull;
+
+    if( ( index != MQTT_INVALID_STATE_COUNT ) &&
+        ( records[ index ].packetId == packetId ) )
+    {
+        *pQos = records[ index ].qos;
+        *pCurrentState = records[ index ].publishState;
+    }
+    else
     {
         index = MQTT_INVALID_STATE_COUNT;
     }
@@ -477,43 +631,151 @@ static size_t findInRecord( const MQTTPubAckInfo_t * records,
 
 /*-----------------------------------------------------------*/
 
-static void compactRecords( MQTTPubAckInfo_t * records,
-                            size_t recordCount )
+static void linkRecord( MQTTPubAckInfo_t * records,
+                        size_t recordIndex )
 {
-    size_t index = 0;
-    size_t emptyIndex = MQTT_INVALID_STATE_COUNT;
+    size_t oldestIndex = 0;
+    uint16_t newestLink = 0U;
 
     assert( records != NULL );
 
-    /* Find the empty spots and fill those with non empty values. */
-    for( ; index < recordCount; index++ )
+    if( records[ 0 ].oldestRecord == 0U )
     {
-        /* Find the first empty spot. */
-        if( records[ index ].packetId == MQTT_PACKET_ID_INVALID )
-        {
-            if( emptyIndex == MQTT_INVALID_STATE_COUNT )
-            {
-                emptyIndex = index;
-            }
-        }
-        else
-        {
-            if( emptyIndex != MQTT_INVALID_STATE_COUNT )
-            {
-                /* Copy over the contents at non empty index to empty index. */
-                records[ emptyIndex ].packetId = records[ index ].packetId;
-                records[ emptyIndex ].qos = records[ index ].qos;
-                records[ emptyIndex ].publishState = records[ index ].publishState;
-
-                /* Mark the record at current non empty index as invalid. */
-                records[ index ].packetId = MQTT_PACKET_ID_INVALID;
-                records[ index ].qos = MQTTQoS0;
-                records[ index ].publishState = MQTTStateNull;
-
-                /* Advance the emptyIndex. */
-                emptyIndex++;
-            }
-        }
+        /* The only record is both the oldest and the newest. */
+        records[ 0 ].oldestRecord = RECORD_LINK( recordIndex );
+        records[ recordIndex ].prevRecord = RECORD_LINK( recordIndex );
+    }
+    else
+    {
+        oldestIndex = RECORD_INDEX( records[ 0 ].oldestRecord );
+        newestLink = records[ oldestIndex ].prevRecord;
+
+        records[ RECORD_INDEX( newestLink ) ].nextRecord = RECORD_LINK( recordIndex );
+        records[ recordIndex ].prevRecord = newestLink;
+        records[ oldestIndex ].prevRecord = RECORD_LINK( recordIndex );
+    }
+
+    records[ recordIndex ].nextRecord = 0U;
+}
+
+/*-----------------------------------------------------------*/
+
+static void unlinkRecord( MQTTPubAckInfo_t * records,
+                          size_t recordIndex )
+{
+    uint16_t prevLink = 0U;
+    uint16_t nextLink = 0U;
+
+    assert( records != NULL );
+
+    prevLink = records[ recordIndex ].prevRecord;
+    nextLink = records[ recordIndex ].nextRecord;
+
+    if( records[ 0 ].oldestRecord == RECORD_LINK( recordIndex ) )
+    {
+        records[ 0 ].oldestRecord = nextLink;
+    }
+    else
+    {
+        records[ RECORD_INDEX( prevLink ) ].nextRecord = nextLink;
+    }
+
+    if( nextLink != 0U )
+    {
+        records[ RECORD_INDEX( nextLink ) ].prevRecord = prevLink;
+    }
+    else if( records[ 0 ].oldestRecord != 0U )
+    {
+        /* The newest record was removed, so the oldest record links to the
+         * one added before it. */
+        records[ RECORD_INDEX( records[ 0 ].oldestRecord ) ].prevRecord = prevLink;
+    }
+    else
+    {
+        /* No records are left. */
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static void relocateRecord( MQTTPubAckInfo_t * records,
+                            size_t fromIndex,
+                            size_t toIndex )
+{
+    uint16_t prevLink = 0U;
+    uint16_t nextLink = 0U;
+
+    assert( records != NULL );
+    assert( records[ toIndex ].packetId == MQTT_PACKET_ID_INVALID );
+
+    prevLink = records[ fromIndex ].prevRecord;
+    nextLink = records[ fromIndex ].nextRecord;
+
+    records[ toIndex ].packetId = records[ fromIndex ].packetId;
+    records[ toIndex ].qos = records[ fromIndex ].qos;
+    records[ toIndex ].publishState = records[ fromIndex ].publishState;
+    records[ toIndex ].prevRecord = prevLink;
+    records[ toIndex ].nextRecord = nextLink;
+
+    /* Point the neighbours in the order at the new slot. */
+    if( records[ 0 ].oldestRecord == RECORD_LINK( fromIndex ) )
+    {
+        records[ 0 ].oldestRecord = RECORD_LINK( toIndex );
+    }
+    else
+    {
+        records[ RECORD_INDEX( prevLink ) ].nextRecord = RECORD_LINK( toIndex );
+    }
+
+    if( nextLink != 0U )
+    {
+        records[ RECORD_INDEX( nextLink ) ].prevRecord = RECORD_LINK( toIndex );
+    }
+    else
+    {
+        records[ RECORD_INDEX( records[ 0 ].oldestRecord ) ].prevRecord = RECORD_LINK( toIndex );
+    }
+
+    /* Mark the record at the old slot as invalid. */
+    records[ fromIndex ].packetId = MQTT_PACKET_ID_INVALID;
+    records[ fromIndex ].qos = MQTTQoS0;
+    records[ fromIndex ].publishState = MQTTStateNull;
+    records[ fromIndex ].prevRecord = 0U;
+    records[ fromIndex ].nextRecord = 0U;
+}
+
+/*-----------------------------------------------------------*/
+
+static void deleteRecord( MQTTPubAckInfo_t * records,
+                          size_t recordCount,
+                          size_t recordIndex )
+{
+    size_t freeIndex = recordIndex;
+    size_t index = recordIndex;
+
+    assert( records != NULL );
+    assert( recordIndex < recordCount );
+
+    unlinkRecord( records, recordIndex );
+
+    /* Mark the record as invalid. */
+    records[ recordIndex ].packetId = MQTT_PACKET_ID_INVALID;
+    records[ recordIndex ].qos = MQTTQoS0;
+    records[ recordIndex ].publishState = MQTTStateNull;
+    records[ recordIndex ].prevRecord = 0U;
+    records[ recordIndex ].nextRecord = 0U;
+
+    /* Move the following records back by one slot. A record at its home
+     * index was never probed past the freed slot, and neither were the
+     * records after it, so the shift stops there. */
+    index = ( index + 1U ) % recordCount;
+
+    while( ( records[ index ].packetId != MQTT_PACKET_ID_INVALID ) &&
+           ( RECORD_DISTANCE( index, records[ index ].packetId, recordCount ) > 0U ) )
+    {
+        relocateRecord( records, index, freeIndex );
+        freeIndex = index;
+        index = ( index + 1U ) % recordCount;
     }
 }
 
@@ -526,59 +788,55 @@ static MQTTStatus_t addRecord( MQTTPubAckInfo_t * records,
                                MQTTPublishState_t publishState )
 {
     MQTTStatus_t status = MQTTNoMemory;
-    int32_t index = 0;
-    size_t availableIndex = recordCount;
-    bool validEntryFound = false;
+    size_t index = 0;
+    size_t freeIndex = 0;
+    size_t probeCount = 0;
 
     assert( packetId != MQTT_PACKET_ID_INVALID );
     assert( qos != MQTTQoS0 );
+    assert( recordCount <= UINT16_MAX );
 
-    /* Check if we have to compact the records. This is known by checking if
-     * the last spot in the array is filled. */
-    if( records[ recordCount - 1U ].packetId != MQTT_PACKET_ID_INVALID )
+    index = probeRecords( records, recordCount, packetId );
+
+    if( index == MQTT_INVALID_STATE_COUNT )
     {
-        compactRecords( records, recordCount );
+        /* Every slot is in use. */
     }
+    else if( records[ index ].packetId == packetId )
+    {
+        /* Collision. */
+        LogError( ( "Collision when adding PacketID=%u at index=%lu.",
+                    ( unsigned int ) packetId,
+                    ( unsigned long ) index ) );
 
-    /* Start from end so first available index will be populated.
-     * Available index is always found after the last element in the records.
-     * This is to make sure the relative order of the records in order to meet
-     * the message ordering requirement of MQTT spec 3.1.1. */
-    for( index = ( ( int32_t ) recordCount - 1 ); index >= 0; index-- )
+        status = MQTTStateCollision;
+    }
+    else
     {
-        /* Available index is only found after packet at the highest index. */
-        if( records[ index ].packetId == MQTT_PACKET_ID_INVALID )
+        /* Find the free slot that ends the run of records to shift. */
+        freeIndex = index;
+
+        for( probeCount = 0;
+             ( probeCount < recordCount ) && ( records[ freeIndex ].packetId != MQTT_PACKET_ID_INVALID );
+             probeCount++ )
         {
-            if( validEntryFound == false )
-            {
-                availableIndex = ( size_t ) index;
-            }
+            freeIndex = ( freeIndex + 1U ) % recordCount;
         }
-        else
-        {
-            /* A non-empty spot found in the records. */
-            validEntryFound = true;
 
-            if( records[ index ].packetId == packetId )
+        if( probeCount < recordCount )
+        {
+            while( freeIndex != index )
             {
-                /* Collision. */
-                LogError( ( "Collision when adding PacketID=%u at index=%d.",
-                            ( unsigned int ) packetId,
-                            ( int ) index ) );
-
-                status = MQTTStateCollision;
-                availableIndex = recordCount;
-                break;
+                relocateRecord( records, ( freeIndex + recordCount - 1U ) % recordCount, freeIndex );
+                freeIndex = ( freeIndex + recordCount - 1U ) % recordCount;
             }
-        }
-    }
 
-    if( availableIndex < recordCount )
-    {
-        records[ availableIndex ].packetId = packetId;
-        records[ availableIndex ].qos = qos;
-        records[ availableIndex ].publishState = publishState;
-        status = MQTTSuccess;
+            records[ index ].packetId = packetId;
+            records[ index ].qos = qos;
+            records[ index ].publishState = publishState;
+            linkRecord( records, index );
+            status = MQTTSuccess;
+        }
     }
 
     return status;
@@ -587,6 +845,7 @@ static MQTTStatus_t addRecord( MQTTPubAckInfo_t * records,
 /*-----------------------------------------------------------*/
 
 static void updateRecord( MQTTPubAckInfo_t * records,
+                          size_t recordCount,
                           size_t recordIndex,
                           MQTTPublishState_t newState,
                           bool shouldDelete )
@@ -595,10 +854,7 @@ static void updateRecord( MQTTPubAckInfo_t * records,
 
     if( shouldDelete == true )
     {
-        /* Mark the record as invalid. */
-        records[ recordIndex ].packetId = MQTT_PACKET_ID_INVALID;
-        records[ recordIndex ].qos = MQTTQoS0;
-        records[ recordIndex ].publishState = MQTTStateNull;
+        deleteRecord( records, recordCount, recordIndex );
     }
     else
     {
@@ -608,6 +864,62 @@ static void updateRecord( MQTTPubAckInfo_t * records,
 
 /*-----------------------------------------------------------*/
 
+static uint16_t cursorResumeLink( const MQTTPubAckInfo_t * records,
+                                  size_t recordCount,
+                                  MQTTStateCursor_t cursor )
+{
+    uint16_t link = 0U;
+    uint16_t lastId = CURSOR_LAST_ID( cursor );
+    uint16_t nextId = CURSOR_NEXT_ID( cursor );
+    size_t index = MQTT_INVALID_STATE_COUNT;
+
+    assert( records != NULL );
+    assert( recordCount > 0U );
+
+    if( cursor == MQTT_STATE_CURSOR_INITIALIZER )
+    {
+        link = records[ 0 ].oldestRecord;
+    }
+    else
+    {
+        /* Records move between slots when others are added or removed, so
+         * the cursor holds packet IDs and the records are looked up again. */
+        index = probeRecords( records, recordCount, lastId );
+
+        if( ( index != MQTT_INVALID_STATE_COUNT ) &&
+            ( records[ index ].packetId == lastId ) )
+        {
+            link = records[ index ].nextRecord;
+        }
+        else if( nextId != MQTT_PACKET_ID_INVALID )
+        {
+            /* The record visited last was removed, so the search resumes
+             * with the record that followed it. */
+            index = probeRecords( records, recordCount, nextId );
+
+            if( ( index != MQTT_INVALID_STATE_COUNT ) &&
+                ( records[ index ].packetId == nextId ) )
+            {
+                link = RECORD_LINK( index );
+            }
+            else
+            {
+                /* Both records were removed, so the place in the order is
+                 * lost. Start over rather than skip records. */
+                link = records[ 0 ].oldestRecord;
+            }
+        }
+        else
+        {
+            /* The newest record was visited last and has been removed. */
+        }
+    }
+
+    return link;
+}
+
+/*-----------------------------------------------------------*/
+
 static uint16_t stateSelect( const MQTTContext_t * pMqttContext,
                              uint16_t searchStates,
                              MQTTStateCursor_t * pCursor )
@@ -616,6 +928,9 @@ static uint16_t stateSelect( const MQTTContext_t * pMqttContext,
     uint16_t outgoingStates = 0U;
     const MQTTPubAckInfo_t * records = NULL;
     size_t maxCount;
+    uint16_t link = 0U;
+    uint16_t nextLink = 0U;
+    uint16_t nextId = MQTT_PACKET_ID_INVALID;
     bool stateCheck = false;
 
     assert( pMqttContext != NULL );
@@ -636,19 +951,33 @@ static uint16_t stateSelect( const MQTTContext_t * pMqttContext,
     records = pMqttContext->outgoingPublishRecords;
     maxCount = pMqttContext->outgoingPublishRecordMaxCount;
 
-    while( *pCursor < maxCount )
+    if( maxCount > 0U )
     {
+        link = cursorResumeLink( records, maxCount, *pCursor );
+    }
+
+    while( link != 0U )
+    {
+        nextLink = records[ RECORD_INDEX( link ) ].nextRecord;
+        nextId = MQTT_PACKET_ID_INVALID;
+
+        if( nextLink != 0U )
+        {
+            nextId = records[ RECORD_INDEX( nextLink ) ].packetId;
+        }
+
+        *pCursor = CURSOR_VALUE( records[ RECORD_INDEX( link ) ].packetId, nextId );
+
         /* Check if any of the search states are present. */
-        stateCheck = UINT16_CHECK_BIT( searchStates, records[ *pCursor ].publishState );
+        stateCheck = UINT16_CHECK_BIT( searchStates, records[ RECORD_INDEX( link ) ].publishState );
 
         if( stateCheck == true )
         {
-            packetId = records[ *pCursor ].packetId;
-            ( *pCursor )++;
+            packetId = records[ RECORD_INDEX( link ) ].packetId;
             break;
         }
 
-        ( *pCursor )++;
+        link = nextLink;
     }
 
     return packetId;
@@ -708,7 +1037,6 @@ MQTTPublishState_t MQTT_CalculateStateAck( MQTTPubAckType_t packetType,
 static MQTTStatus_t updateStateAck( MQTTPubAckInfo_t * records,
                                     size_t maxRecordCount,
                                     size_t recordIndex,
-                                    uint16_t packetId,
                                     MQTTPublishState_t currentState,
                                     MQTTPublishState_t newState )
 {
@@ -718,11 +1046,8 @@ static MQTTStatus_t updateStateAck( MQTTPubAckInfo_t * records,
 
     assert( records != NULL );
 
-    /* Record to be deleted if the state transition is completed or if a PUBREC
-     * is received for an outgoing QoS2 publish. When a PUBREC is received,
-     * record is deleted and added back to the end of the records to maintain
-     * ordering for PUBRELs. */
-    shouldDeleteRecord = ( newState == MQTTPublishDone ) || ( newState == MQTTPubRelSend );
+    /* Record to be deleted if the state transition is completed. */
+    shouldDeleteRecord = ( newState == MQTTPublishDone );
     isTransitionValid = validateTransitionAck( currentState, newState );
 
     if( isTransitionValid == true )
@@ -735,6 +1060,7 @@ static MQTTStatus_t updateStateAck( MQTTPubAckInfo_t * records,
         if( currentState != newState )
         {
             updateRecord( records,
+                          maxRecordCount,
                           recordIndex,
                           newState,
                           shouldDeleteRecord );
@@ -745,11 +1071,8 @@ static MQTTStatus_t updateStateAck( MQTTPubAckInfo_t * records,
              * a PUBREL needs to be resent in case of a session reestablishment. */
             if( newState == MQTTPubRelSend )
             {
-                status = addRecord( records,
-                                    maxRecordCount,
-                                    packetId,
-                                    MQTTQoS2,
-                                    MQTTPubRelSend );
+                unlinkRecord( records, recordIndex );
+                linkRecord( records, recordIndex );
             }
         }
     }
@@ -805,6 +1128,7 @@ static MQTTStatus_t updateStatePublish( const MQTTContext_t * pMqttContext,
             if( currentState != newState )
             {
                 updateRecord( pMqttContext->outgoingPublishRecords,
+                              pMqttContext->outgoingPublishRecordMaxCount,
                               recordIndex,
                               newState,
                               false );
@@ -993,6 +1317,7 @@ MQTTStatus_t MQTT_RemoveStateRecord( const MQTTContext_t * pMqttContext,
         {
             /* Delete the record. */
             updateRecord( records,
+                          pMqttContext->outgoingPublishRecordMaxCount,
                           recordIndex,
                           MQTTStateNull,
                           true );
@@ -1065,7 +1390,6 @@ MQTTStatus_t MQTT_UpdateStateAck( const MQTTContext_t * pMqttContext,
         status = updateStateAck( records,
                                  maxRecordCount,
                                  recordIndex,
-                                 packetId,
                                  currentState,
                                  newState );
 
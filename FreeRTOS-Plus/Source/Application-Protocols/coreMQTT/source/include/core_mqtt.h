@@ -146,12 +146,25 @@ typedef enum MQTTSubAckStatus
 /**
  * @ingroup mqtt_struct_types
  * @brief An element of the state engine records for QoS 1 or Qos 2 publishes.
+ *
+ * The state engine stores each record at a position derived from its packet
+ * ID and chains the records in the order they were added, so the last three
+ * members are maintained by the library and must not be modified by the
+ * application. Links hold one more than the array index of the record they
+ * refer to, so that a zero-initialized array is an empty set of records.
+ *
+ * @note The three link members add 6 bytes to each element. With 4-byte
+ * enums and 4-byte alignment an element takes 20 bytes rather than 12, so
+ * statically sized record arrays need resizing to stay within the same RAM.
  */
 typedef struct MQTTPubAckInfo
 {
     uint16_t packetId;               /**< @brief The packet ID of the original PUBLISH. */
     MQTTQoS_t qos;                   /**< @brief The QoS of the original PUBLISH. */
     MQTTPublishState_t publishState; /**< @brief The current state of the publish process. */
+    uint16_t prevRecord;             /**< @brief Link to the record added before this one; the oldest record links to the newest. */
+    uint16_t nextRecord;             /**< @brief Link to the record added after this one, or 0 for the newest record. */
+    uint16_t oldestRecord;           /**< @brief Link to the oldest record. Only used in the first element of the array. */
 } MQTTPubAckInfo_t;
 
 /**
@@ -235,6 +248,20 @@ typedef struct MQTTContext
     uint16_t keepAliveIntervalSec; /**< @brief Keep Alive interval. */
     uint32_t pingReqSendTimeMs;    /**< @brief Timestamp of the last sent PINGREQ. */
     bool waitingForPingResp;       /**< @brief If the library is currently awaiting a PINGRESP. */
+
+    #if ( MQTT_VERSION_5_ENABLED != 0 )
+
+        /**
+         * @brief The reason code and server limits from the last CONNACK.
+         */
+        MQTTConnackProperties_t connackProperties;
+
+        /**
+         * @brief The number of QoS 1 and QoS 2 PUBLISH packets that can still be
+         * sent before the server's receive maximum is reached.
+         */
+        uint16_t sendQuota;
+    #endif
 } MQTTContext_t;
 
 /**
@@ -247,6 +274,9 @@ typedef struct MQTTDeserializedInfo
     uint16_t packetIdentifier;          /**< @brief Packet ID of deserialized packet. */
     MQTTPublishInfo_t * pPublishInfo;   /**< @brief Pointer to deserialized publish info. */
     MQTTStatus_t deserializationResult; /**< @brief Return code of deserialization. */
+    #if ( MQTT_VERSION_5_ENABLED != 0 )
+        uint8_t reasonCode;             /**< @brief MQTT 5 reason code of a publish acknowledgment or DISCONNECT. */
+    #endif
 } MQTTDeserializedInfo_t;
 
 /**
@@ -345,6 +375,14 @@ MQTTStatus_t MQTT_Init( MQTTContext_t * pContext,
  * @param[in] incomingPublishCount Maximum number of records which can be kept in the memory
  * pointed to by @p pIncomingPublishRecords.
  *
+ * @note Both record arrays are cleared by this function, so any records they
+ * held before the call are discarded. Earlier versions of the library left the
+ * arrays untouched; applications must not fill the arrays before the call or
+ * expect their contents to survive it, for example to carry QoS state across a
+ * re-initialization of the context. The arrays must not be shared with another
+ * context. Each array can hold at most `UINT16_MAX` records, which is also the
+ * number of distinct packet IDs.
+ *
  * @return #MQTTBadParameter if invalid parameters are passed;
  * #MQTTSuccess otherwise.
  *
@@ -578,8 +616,14 @@ MQTTStatus_t MQTT_Subscribe( MQTTContext_t * pContext,
  * @param[in] pPublishInfo MQTT PUBLISH packet parameters.
  * @param[in] packetId packet ID generated by #MQTT_GetPacketId.
  *
+ * With #MQTT_VERSION_5_ENABLED, a PUBLISH that the server announced it does
+ * not accept, by QoS, retain flag, size or topic alias, is rejected with
+ * #MQTTBadParameter before it is sent.
+ *
  * @return #MQTTNoMemory if pBuffer is too small to hold the MQTT packet;
  * #MQTTBadParameter if invalid parameters are passed;
+ * #MQTTReceiveMaximumExceeded if the QoS 1 or QoS 2 publishes awaiting
+ * acknowledgment already reach the MQTT 5 receive maximum of the server;
  * #MQTTSendFailed if transport write failed;
  * #MQTTSuccess otherwise.
  *
@@ -750,6 +794,8 @@ MQTTStatus_t MQTT_Disconnect( MQTTContext_t * pContext );
  * #MQTT_PINGRESP_TIMEOUT_MS milliseconds;
  * #MQTTIllegalState if an incoming QoS 1/2 publish or ack causes an
  * invalid transition for the internal state machine;
+ * #MQTTServerRefused if the server sent an MQTT 5 DISCONNECT, after it has
+ * been passed to the application callback;
  * #MQTTNeedMoreBytes if MQTT_ProcessLoop has received
  * incomplete data; it should be called again (probably after a delay);
  * #MQTTSuccess on success.
@@ -806,6 +852,8 @@ MQTTStatus_t MQTT_ProcessLoop( MQTTContext_t * pContext );
  * #MQTTBadResponse if an invalid packet is received;
  * #MQTTIllegalState if an incoming QoS 1/2 publish or ack causes an
  * invalid transition for the internal state machine;
+ * #MQTTServerRefused if the server sent an MQTT 5 DISCONNECT, after it has
+ * been passed to the application callback;
  * #MQTTNeedMoreBytes if MQTT_ReceiveLoop has received
  * incomplete data; it should be called again (probably after a delay);
  * #MQTTSuccess on success.
@@ -921,6 +969,9 @@ MQTTStatus_t MQTT_MatchTopic( const char * pTopicName,
  *  - 0x80 - Failure
  * Refer to #MQTTSubAckStatus_t for the status codes.
  *
+ * With #MQTT_VERSION_5_ENABLED, the properties of the SUBACK are skipped, and
+ * the reason codes of an UNSUBACK can be parsed the same way.
+ *
  * @param[in] pSubackPacket The SUBACK packet whose payload is to be parsed.
  * @param[out] pPayloadStart This is populated with the starting address
  * of the payload (or return codes for topic filters) in the SUBACK packet.
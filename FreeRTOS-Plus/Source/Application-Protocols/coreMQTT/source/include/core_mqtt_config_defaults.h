@@ -195,6 +195,29 @@
     #error MQTT_SEND_RETRY_TIMEOUT_MS is deprecated. Instead use MQTT_SEND_TIMEOUT_MS.
 #endif
 
+/**
+ * @brief Build the library to speak MQTT 5.0 instead of MQTT 3.1.1.
+ *
+ * When enabled, CONNECT requests protocol level 5 and every packet is
+ * serialized and deserialized with MQTT 5 properties and reason codes. The
+ * session expiry interval, receive maximum and maximum packet size of the
+ * client are sent from #MQTTConnectInfo_t, and the limits the server returns
+ * in CONNACK are kept in #MQTTContext_t.connackProperties. #MQTT_Publish then
+ * enforces the server's receive maximum, maximum QoS, maximum packet size and
+ * topic alias maximum. Topic aliases are assigned by the application through
+ * #MQTTPublishInfo_t.topicAlias; the library never asks the server to use
+ * topic aliases towards the client.
+ *
+ * @note The serialized form of most packets changes, so both ends of the
+ * connection must use MQTT 5.0 when this is enabled.
+ *
+ * <b>Possible values:</b> 0 or 1 <br>
+ * <b>Default value:</b> `0`
+ */
+#ifndef MQTT_VERSION_5_ENABLED
+    #define MQTT_VERSION_5_ENABLED    ( 0 )
+#endif
+
 /* *INDENT-OFF* */
 #ifdef __cplusplus
     }
@@ -75,7 +75,7 @@
 #define MQTT_PACKET_TYPE_UNSUBACK       ( ( uint8_t ) 0xB0U )  /**< @brief UNSUBACK (server-to-client). */
 #define MQTT_PACKET_TYPE_PINGREQ        ( ( uint8_t ) 0xC0U )  /**< @brief PINGREQ (client-to-server). */
 #define MQTT_PACKET_TYPE_PINGRESP       ( ( uint8_t ) 0xD0U )  /**< @brief PINGRESP (server-to-client). */
-#define MQTT_PACKET_TYPE_DISCONNECT     ( ( uint8_t ) 0xE0U )  /**< @brief DISCONNECT (client-to-server). */
+#define MQTT_PACKET_TYPE_DISCONNECT     ( ( uint8_t ) 0xE0U )  /**< @brief DISCONNECT (client-to-server; bidirectional in MQTT 5). */
 /** @} */
 
 /**
@@ -84,6 +84,12 @@
  */
 #define MQTT_PUBLISH_ACK_PACKET_SIZE    ( 4UL )
 
+/**
+ * @ingroup mqtt_constants
+ * @brief MQTT 5 reason codes of this value and above indicate a failure.
+ */
+#define MQTT_REASON_CODE_FAILURE        ( ( uint8_t ) 0x80U )
+
 /* Structures defined in this file. */
 struct MQTTFixedBuffer;
 struct MQTTConnectInfo;
@@ -97,20 +103,23 @@ struct MQTTPacketInfo;
  */
 typedef enum MQTTStatus
 {
-    MQTTSuccess = 0,      /**< Function completed successfully. */
-    MQTTBadParameter,     /**< At least one parameter was invalid. */
-    MQTTNoMemory,         /**< A provided buffer was too small. */
-    MQTTSendFailed,       /**< The transport send function failed. */
-    MQTTRecvFailed,       /**< The transport receive function failed. */
-    MQTTBadResponse,      /**< An invalid packet was received from the server. */
-    MQTTServerRefused,    /**< The server refused a CONNECT or SUBSCRIBE. */
-    MQTTNoDataAvailable,  /**< No data available from the transport interface. */
-    MQTTIllegalState,     /**< An illegal state in the state record. */
-    MQTTStateCollision,   /**< A collision with an existing state record entry. */
-    MQTTKeepAliveTimeout, /**< Timeout while waiting for PINGRESP. */
-    MQTTNeedMoreBytes     /**< MQTT_ProcessLoop/MQTT_ReceiveLoop has received
-                          incomplete data; it should be called again (probably after
-                          a delay). */
+    MQTTSuccess = 0,           /**< Function completed successfully. */
+    MQTTBadParameter,          /**< At least one parameter was invalid. */
+    MQTTNoMemory,              /**< A provided buffer was too small. */
+    MQTTSendFailed,            /**< The transport send function failed. */
+    MQTTRecvFailed,            /**< The transport receive function failed. */
+    MQTTBadResponse,           /**< An invalid packet was received from the server. */
+    MQTTServerRefused,         /**< The server refused a CONNECT or SUBSCRIBE, or sent an MQTT 5 DISCONNECT. */
+    MQTTNoDataAvailable,       /**< No data available from the transport interface. */
+    MQTTIllegalState,          /**< An illegal state in the state record. */
+    MQTTStateCollision,        /**< A collision with an existing state record entry. */
+    MQTTKeepAliveTimeout,      /**< Timeout while waiting for PINGRESP. */
+    MQTTNeedMoreBytes,         /**< MQTT_ProcessLoop/MQTT_ReceiveLoop has received
+                               incomplete data; it should be called again (probably after
+                               a delay). */
+    MQTTReceiveMaximumExceeded /**< A QoS 1 or QoS 2 PUBLISH would exceed the MQTT 5
+                               receive maximum of the server; retry once an
+                               acknowledgment has been received. */
 } MQTTStatus_t;
 
 /**
@@ -182,6 +191,31 @@ typedef struct MQTTConnectInfo
      * @brief Length of MQTT password. Set to 0 if not used.
      */
     uint16_t passwordLength;
+
+    #if ( MQTT_VERSION_5_ENABLED != 0 )
+
+        /**
+         * @brief Seconds the server keeps the session after the network
+         * connection closes. Set to 0 to end the session with the connection.
+         *
+         * With MQTT 5, #MQTTConnectInfo_t.cleanSession only controls whether
+         * an existing session is discarded when connecting.
+         */
+        uint32_t sessionExpiryInterval;
+
+        /**
+         * @brief Maximum number of QoS 1 and QoS 2 publishes the client
+         * processes concurrently. Set to 0 to leave the server default of
+         * 65,535.
+         */
+        uint16_t receiveMaximum;
+
+        /**
+         * @brief Largest packet the client accepts, such as the size of the
+         * network buffer. Set to 0 for no limit.
+         */
+        uint32_t maximumPacketSize;
+    #endif
 } MQTTConnectInfo_t;
 
 /**
@@ -246,6 +280,21 @@ typedef struct MQTTPublishInfo
      * @brief Message payload length.
      */
     size_t payloadLength;
+
+    #if ( MQTT_VERSION_5_ENABLED != 0 )
+
+        /**
+         * @brief MQTT 5 topic alias of the topic name. Set to 0 if not used.
+         *
+         * The first PUBLISH with an alias must also carry the topic name,
+         * which maps the alias on the server. Later publishes may set
+         * #MQTTPublishInfo_t.topicNameLength to 0 to send only the alias. The
+         * alias must not exceed the topic alias maximum in
+         * #MQTTConnackProperties_t, and mappings are forgotten when the
+         * connection closes. Always 0 in deserialized publishes.
+         */
+        uint16_t topicAlias;
+    #endif
 } MQTTPublishInfo_t;
 
 /**
@@ -275,6 +324,63 @@ typedef struct MQTTPacketInfo
     size_t headerLength;
 } MQTTPacketInfo_t;
 
+#if ( MQTT_VERSION_5_ENABLED != 0 )
+
+/**
+ * @ingroup mqtt_struct_types
+ * @brief MQTT 5 CONNACK reason code and the server limits it carries.
+ *
+ * Properties absent from the CONNACK hold their MQTT 5 default values.
+ */
+    typedef struct MQTTConnackProperties
+    {
+        /**
+         * @brief CONNACK reason code. 0 on success; 0x80 or above if the
+         * connection was refused.
+         */
+        uint8_t reasonCode;
+
+        /**
+         * @brief Session expiry interval in seconds. The server only sends
+         * this when it differs from the one requested in CONNECT.
+         */
+        uint32_t sessionExpiryInterval;
+
+        /**
+         * @brief Maximum number of QoS 1 and QoS 2 publishes the server
+         * processes concurrently. Default 65,535.
+         */
+        uint16_t receiveMaximum;
+
+        /**
+         * @brief Highest topic alias the server accepts. Default 0, which
+         * disables topic aliases.
+         */
+        uint16_t topicAliasMaximum;
+
+        /**
+         * @brief Largest packet the server accepts. Default 0, for no limit.
+         */
+        uint32_t maximumPacketSize;
+
+        /**
+         * @brief Highest QoS the server supports. Default #MQTTQoS2.
+         */
+        MQTTQoS_t maximumQoS;
+
+        /**
+         * @brief Whether the server supports retained messages. Default true.
+         */
+        bool retainAvailable;
+
+        /**
+         * @brief Keep alive in seconds that the server requires instead of the
+         * one sent in CONNECT. Default 0, meaning none was sent.
+         */
+        uint16_t serverKeepAlive;
+    } MQTTConnackProperties_t;
+#endif /* if ( MQTT_VERSION_5_ENABLED != 0 ) */
+
 /**
  * @brief Get the size and Remaining Length of an MQTT CONNECT packet.
  *
@@ -1097,11 +1203,18 @@ MQTTStatus_t MQTT_DeserializePublish( const MQTTPacketInfo_t * pIncomingPacket,
 
 /**
  * @brief Deserialize an MQTT CONNACK, SUBACK, UNSUBACK, PUBACK, PUBREC, PUBREL,
- * PUBCOMP, or PINGRESP.
+ * PUBCOMP, or PINGRESP, and with #MQTT_VERSION_5_ENABLED, a DISCONNECT from the
+ * server.
+ *
+ * With #MQTT_VERSION_5_ENABLED, the properties of the packet are validated but
+ * not returned. Use #MQTT_DeserializeConnack to read the properties of a
+ * CONNACK, and #MQTT_GetReasonCode to read the reason code of a publish
+ * acknowledgment or DISCONNECT. A refusal reason code in a SUBACK or UNSUBACK
+ * results in #MQTTServerRefused.
  *
  * @param[in] pIncomingPacket #MQTTPacketInfo_t containing the buffer.
  * @param[out] pPacketId The packet ID of obtained from the buffer. Not used
- * in CONNACK or PINGRESP.
+ * in CONNACK, PINGRESP or DISCONNECT.
  * @param[out] pSessionPresent Boolean flag from a CONNACK indicating present session.
  *
  * @return #MQTTBadParameter, #MQTTBadResponse, #MQTTServerRefused, or #MQTTSuccess.
@@ -1139,6 +1252,54 @@ MQTTStatus_t MQTT_DeserializeAck( const MQTTPacketInfo_t * pIncomingPacket,
                                   bool * pSessionPresent );
 /* @[declare_mqtt_deserializeack] */
 
+#if ( MQTT_VERSION_5_ENABLED != 0 )
+
+/**
+ * @brief Deserialize an MQTT 5 CONNACK along with its reason code and
+ * properties.
+ *
+ * Properties that the CONNACK does not carry are set to their default values,
+ * except for #MQTTConnackProperties_t.sessionExpiryInterval, which is left
+ * unchanged so that the caller can preset it to the interval it requested.
+ * Properties that are not kept in #MQTTConnackProperties_t, such as a reason
+ * string or user properties, are validated and skipped.
+ *
+ * @param[in] pIncomingPacket #MQTTPacketInfo_t containing the CONNACK.
+ * @param[out] pSessionPresent Whether the server resumed a session.
+ * @param[out] pConnackProperties Reason code and server limits of the CONNACK.
+ *
+ * @return #MQTTBadParameter, #MQTTBadResponse, #MQTTServerRefused if the
+ * reason code is a refusal, or #MQTTSuccess.
+ */
+/* @[declare_mqtt_deserializeconnack] */
+    MQTTStatus_t MQTT_DeserializeConnack( const MQTTPacketInfo_t * pIncomingPacket,
+                                          bool * pSessionPresent,
+                                          MQTTConnackProperties_t * pConnackProperties );
+/* @[declare_mqtt_deserializeconnack] */
+
+/**
+ * @brief Get the MQTT 5 reason code of a CONNACK, PUBACK, PUBREC, PUBREL,
+ * PUBCOMP or DISCONNECT.
+ *
+ * The packet must have been validated with #MQTT_DeserializeAck first. A
+ * publish acknowledgment or DISCONNECT without a reason code has the reason
+ * code 0x00 (Success or Normal disconnection). Reason codes of 0x80 and above
+ * are errors. The reason codes of a SUBACK or UNSUBACK are read with
+ * #MQTT_GetSubAckStatusCodes.
+ *
+ * @param[in] pIncomingPacket #MQTTPacketInfo_t containing the packet.
+ * @param[out] pReasonCode The reason code of the packet.
+ *
+ * @return #MQTTBadParameter if the packet is not one of the above types;
+ * #MQTTSuccess otherwise.
+ */
+/* @[declare_mqtt_getreasoncode] */
+    MQTTStatus_t MQTT_GetReasonCode( const MQTTPacketInfo_t * pIncomingPacket,
+                                     uint8_t * pReasonCode );
+/* @[declare_mqtt_getreasoncode] */
+
+#endif /* if ( MQTT_VERSION_5_ENABLED != 0 ) */
+
 /**
  * @brief Extract the MQTT packet type and length from incoming packet.
  *
@@ -1297,6 +1458,70 @@ uint8_t * MQTT_SerializeUnsubscribeHeader( size_t remainingLength,
                                            uint16_t packetId );
 /** @endcond */
 
+#if ( MQTT_VERSION_5_ENABLED != 0 )
+
+/**
+ * @brief The largest size of the MQTT 5 properties serialized by
+ * #MQTT_SerializePublishProperties.
+ *
+ * One byte for the property length, one for the topic alias identifier, and
+ * two for the topic alias.
+ */
+    #define MQTT_PUBLISH_PROPERTIES_MAX_SIZE    ( 4U )
+
+/**
+ * @brief The largest size of the MQTT 5 properties that
+ * #MQTT_SerializeConnectFixedHeader adds to the CONNECT variable header.
+ *
+ * One byte for the property length, five each for the session expiry interval
+ * and maximum packet size, and three for the receive maximum.
+ */
+    #define MQTT_CONNECT_PROPERTIES_MAX_SIZE    ( 14U )
+
+/**
+ * @fn uint8_t * MQTT_SerializePublishProperties( const MQTTPublishInfo_t * pPublishInfo, uint8_t * pIndex );
+ * @brief Serialize the MQTT 5 properties of a PUBLISH packet, which follow
+ * the packet identifier.
+ *
+ * @param[in] pPublishInfo MQTT PUBLISH packet parameters.
+ * @param[in] pIndex Pointer to a buffer of at least
+ * #MQTT_PUBLISH_PROPERTIES_MAX_SIZE bytes.
+ *
+ * @return A pointer to the end of the encoded properties.
+ */
+
+/**
+ * @cond DOXYGEN_IGNORE
+ * Doxygen should ignore this definition, this function is private.
+ */
+    uint8_t * MQTT_SerializePublishProperties( const MQTTPublishInfo_t * pPublishInfo,
+                                               uint8_t * pIndex );
+/** @endcond */
+
+/**
+ * @fn MQTTStatus_t MQTT_SkipProperties( const uint8_t * pSource, size_t sourceLength, size_t * pSize );
+ * @brief Get the size of the MQTT 5 properties, including their length, at
+ * the start of a buffer.
+ *
+ * @param[in] pSource The property length of an incoming packet.
+ * @param[in] sourceLength Number of bytes available at @p pSource.
+ * @param[out] pSize Size of the property length and the properties.
+ *
+ * @return #MQTTBadResponse if the properties are malformed or do not fit in
+ * @p sourceLength; #MQTTSuccess otherwise.
+ */
+
+/**
+ * @cond DOXYGEN_IGNORE
+ * Doxygen should ignore this definition, this function is private.
+ */
+    MQTTStatus_t MQTT_SkipProperties( const uint8_t * pSource,
+                                      size_t sourceLength,
+                                      size_t * pSize );
+/** @endcond */
+
+#endif /* if ( MQTT_VERSION_5_ENABLED != 0 ) */
+
 /* *INDENT-OFF* */
 #ifdef __cplusplus
     }
@@ -103,31 +103,64 @@ static void eventCallback( MQTTContext_t * pContext,
 
 static void resetPublishRecords( MQTTContext_t * pMqttContext )
 {
-    uint32_t i = 0;
+    /* An all zero array holds no records. */
+    ( void ) memset( pMqttContext->outgoingPublishRecords, 0x00,
+                     MQTT_STATE_ARRAY_MAX_COUNT * sizeof( MQTTPubAckInfo_t ) );
+    ( void ) memset( pMqttContext->incomingPublishRecords, 0x00,
+                     MQTT_STATE_ARRAY_MAX_COUNT * sizeof( MQTTPubAckInfo_t ) );
+}
+
+static size_t findRecord( const MQTTPubAckInfo_t * records,
+                          size_t recordCount,
+                          uint16_t packetId )
+{
+    size_t i;
 
-    for( ; i < MQTT_STATE_ARRAY_MAX_COUNT; i++ )
+    for( i = 0; i < recordCount; i++ )
     {
-        pMqttContext->outgoingPublishRecords[ i ].packetId = MQTT_PACKET_ID_INVALID;
-        pMqttContext->outgoingPublishRecords[ i ].qos = MQTTQoS0;
-        pMqttContext->outgoingPublishRecords[ i ].publishState = MQTTStateNull;
-        pMqttContext->incomingPublishRecords[ i ].packetId = MQTT_PACKET_ID_INVALID;
-        pMqttContext->incomingPublishRecords[ i ].qos = MQTTQoS0;
-        pMqttContext->incomingPublishRecords[ i ].publishState = MQTTStateNull;
+        if( records[ i ].packetId == packetId )
+        {
+            break;
+        }
     }
+
+    return i;
 }
 
-static void addToRecord( MQTTPubAckInfo_t * records,
-                         size_t index,
-                         uint16_t packetId,
-                         MQTTQoS_t qos,
-                         MQTTPublishState_t state )
+static size_t addToRecord( MQTTContext_t * pMqttContext,
+                           MQTTPubAckInfo_t * records,
+                           uint16_t packetId,
+                           MQTTQoS_t qos,
+                           MQTTPublishState_t state )
 {
-    records[ index ].packetId = packetId;
+    MQTTPublishState_t newState;
+    size_t index = findRecord( records, MQTT_STATE_ARRAY_MAX_COUNT, packetId );
+
+    /* Let the state engine store a new record, so that it is indexed, and
+     * then overwrite its QoS and state. */
+    if( index == MQTT_STATE_ARRAY_MAX_COUNT )
+    {
+        if( records == pMqttContext->outgoingPublishRecords )
+        {
+            TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_ReserveState( pMqttContext, packetId, MQTTQoS1 ) );
+        }
+        else
+        {
+            TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_UpdateStatePublish( pMqttContext, packetId, MQTT_RECEIVE,
+                                                                     MQTTQoS1, &newState ) );
+        }
+
+        index = findRecord( records, MQTT_STATE_ARRAY_MAX_COUNT, packetId );
+    }
+
     records[ index ].qos = qos;
     records[ index ].publishState = state;
+
+    return index;
 }
 
-static void fillRecord( MQTTPubAckInfo_t * records,
+static void fillRecord( MQTTContext_t * pMqttContext,
+                        MQTTPubAckInfo_t * records,
                         uint16_t startingId,
                         MQTTQoS_t qos,
                         MQTTPublishState_t state )
@@ -136,23 +169,30 @@ static void fillRecord( MQTTPubAckInfo_t * records,
 
     for( i = 0; i < MQTT_STATE_ARRAY_MAX_COUNT; i++ )
     {
-        records[ i ].packetId = startingId + i;
-        records[ i ].qos = qos;
-        records[ i ].publishState = state;
+        ( void ) addToRecord( pMqttContext, records, startingId + i, qos, state );
     }
 }
 
-static void validateRecordAt( MQTTPubAckInfo_t * records,
-                              size_t index,
-                              uint16_t packetId,
-                              MQTTQoS_t qos,
-                              MQTTPublishState_t state )
+static void validateRecord( const MQTTPubAckInfo_t * records,
+                            uint16_t packetId,
+                            MQTTQoS_t qos,
+                            MQTTPublishState_t state )
 {
-    TEST_ASSERT_EQUAL( packetId, records[ index ].packetId );
+    size_t index = findRecord( records, MQTT_STATE_ARRAY_MAX_COUNT, packetId );
+
+    TEST_ASSERT_LESS_THAN( MQTT_STATE_ARRAY_MAX_COUNT, index );
     TEST_ASSERT_EQUAL( qos, records[ index ].qos );
     TEST_ASSERT_EQUAL( state, records[ index ].publishState );
 }
 
+static MQTTPublishState_t recordState( const MQTTPubAckInfo_t * records,
+                                       uint16_t packetId )
+{
+    size_t index = findRecord( records, MQTT_STATE_ARRAY_MAX_COUNT, packetId );
+
+    return ( index < MQTT_STATE_ARRAY_MAX_COUNT ) ? records[ index ].publishState : MQTTStateNull;
+}
+
 /* ========================================================================== */
 
 void test_MQTT_ReserveState( void )
@@ -160,8 +200,8 @@ void test_MQTT_ReserveState( void )
     MQTTContext_t mqttContext = { 0 };
     MQTTStatus_t status;
     const uint16_t PACKET_ID = 1;
-    const uint16_t PACKET_ID2 = 2;
-    const uint16_t PACKET_ID3 = 3;
+    const uint16_t PACKET_ID2 = MQTT_STATE_ARRAY_MAX_COUNT / 2;
+    const uint16_t PACKET_ID3 = PACKET_ID2 + MQTT_STATE_ARRAY_MAX_COUNT;
     const size_t index = MQTT_STATE_ARRAY_MAX_COUNT / 2;
     TransportInterface_t transport;
     MQTTFixedBuffer_t networkBuffer;
@@ -191,16 +231,15 @@ void test_MQTT_ReserveState( void )
     TEST_ASSERT_EQUAL( MQTTBadParameter, status );
 
     /* Test for collisions. */
-    mqttContext.outgoingPublishRecords[ 0 ].packetId = PACKET_ID;
-    mqttContext.outgoingPublishRecords[ 0 ].qos = MQTTQoS1;
-    mqttContext.outgoingPublishRecords[ 0 ].publishState = MQTTPublishSend;
+    addToRecord( &mqttContext, mqttContext.outgoingPublishRecords, PACKET_ID, MQTTQoS1, MQTTPublishSend );
 
     status = MQTT_ReserveState( &mqttContext, PACKET_ID, MQTTQoS1 );
     TEST_ASSERT_EQUAL( MQTTStateCollision, status );
 
 
     /* Test for no memory. */
-    fillRecord( mqttContext.outgoingPublishRecords, 2, MQTTQoS1, MQTTPublishSend );
+    resetPublishRecords( &mqttContext );
+    fillRecord( &mqttContext, mqttContext.outgoingPublishRecords, 2, MQTTQoS1, MQTTPublishSend );
     status = MQTT_ReserveState( &mqttContext, PACKET_ID, MQTTQoS1 );
     TEST_ASSERT_EQUAL( MQTTNoMemory, status );
 
@@ -208,16 +247,17 @@ void test_MQTT_ReserveState( void )
     resetPublishRecords( &mqttContext );
     status = MQTT_ReserveState( &mqttContext, PACKET_ID, MQTTQoS1 );
     TEST_ASSERT_EQUAL( MQTTSuccess, status );
-    /* Reserve uses first available entry. */
-    TEST_ASSERT_EQUAL( PACKET_ID, mqttContext.outgoingPublishRecords[ 0 ].packetId );
-    TEST_ASSERT_EQUAL( MQTTQoS1, mqttContext.outgoingPublishRecords[ 0 ].qos );
-    TEST_ASSERT_EQUAL( MQTTPublishSend, mqttContext.outgoingPublishRecords[ 0 ].publishState );
+    /* Reserve uses the entry at the packet ID modulo the record count. */
+    TEST_ASSERT_EQUAL( PACKET_ID, mqttContext.outgoingPublishRecords[ PACKET_ID ].packetId );
+    TEST_ASSERT_EQUAL( MQTTQoS1, mqttContext.outgoingPublishRecords[ PACKET_ID ].qos );
+    TEST_ASSERT_EQUAL( MQTTPublishSend, mqttContext.outgoingPublishRecords[ PACKET_ID ].publishState );
 
     /* Success.
-     * Add record after the highest non empty index.
-     * Already an entry exists at index 0. Adding 1 more entry at index 5.
-     * The new index used should be 6. */
-    addToRecord( mqttContext.outgoingPublishRecords, index, PACKET_ID2, MQTTQoS2, MQTTPubRelSend );
+     * When that entry is in use, the next free entry is used. An entry
+     * exists at index 5. Adding another record whose packet ID maps to
+     * index 5 should use index 6. */
+    addToRecord( &mqttContext, mqttContext.outgoingPublishRecords, PACKET_ID2, MQTTQoS2, MQTTPubRelSend );
+    TEST_ASSERT_EQUAL( PACKET_ID2, mqttContext.outgoingPublishRecords[ index ].packetId );
     status = MQTT_ReserveState( &mqttContext, PACKET_ID3, MQTTQoS1 );
     TEST_ASSERT_EQUAL( MQTTSuccess, status );
     TEST_ASSERT_EQUAL( PACKET_ID3, mqttContext.outgoingPublishRecords[ index + 1 ].packetId );
@@ -281,6 +321,7 @@ void test_MQTT_RemoveStateRecord_RecordFoundIncorrectQoS( void )
     const uint16_t packetID = 12;
     /* Any state except null state. */
     const MQTTPublishState_t state = MQTTPubRelSend;
+    size_t index;
 
     memset( &context, 0, sizeof( MQTTContext_t ) );
 
@@ -289,9 +330,10 @@ void test_MQTT_RemoveStateRecord_RecordFoundIncorrectQoS( void )
 
     memset( context.outgoingPublishRecords, 0, sizeof( outgoingRecords ) );
 
-    context.outgoingPublishRecords[ 0 ].packetId = packetID;
-    context.outgoingPublishRecords[ 0 ].publishState = state;
-    context.outgoingPublishRecords[ 0 ].qos = MQTTQoS0;
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_ReserveState( &context, packetID, MQTTQoS1 ) );
+    index = findRecord( context.outgoingPublishRecords, 5, packetID );
+    context.outgoingPublishRecords[ index ].publishState = state;
+    context.outgoingPublishRecords[ index ].qos = MQTTQoS0;
 
     /* Any non-zero packet ID. */
     status = MQTT_RemoveStateRecord( &context, packetID );
@@ -309,6 +351,7 @@ void test_MQTT_RemoveStateRecord_RemoveQoS1Record( void )
     const uint16_t packetID = 12;
     /* Any state except null state. */
     const MQTTPublishState_t state = MQTTPubRelSend;
+    size_t index;
 
     memset( &context, 0, sizeof( MQTTContext_t ) );
 
@@ -317,17 +360,19 @@ void test_MQTT_RemoveStateRecord_RemoveQoS1Record( void )
 
     memset( context.outgoingPublishRecords, 0, sizeof( outgoingRecords ) );
 
-    context.outgoingPublishRecords[ 1 ].packetId = packetID;
-    context.outgoingPublishRecords[ 1 ].publishState = state;
-    context.outgoingPublishRecords[ 1 ].qos = MQTTQoS1;
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_ReserveState( &context, packetID, MQTTQoS1 ) );
+    index = findRecord( context.outgoingPublishRecords, 5, packetID );
+    context.outgoingPublishRecords[ index ].publishState = state;
 
     /* Any non-zero packet ID. */
     status = MQTT_RemoveStateRecord( &context, packetID );
 
     TEST_ASSERT_EQUAL( MQTTSuccess, status );
-    TEST_ASSERT_EQUAL( context.outgoingPublishRecords[ 1 ].packetId, MQTT_PACKET_ID_INVALID );
-    TEST_ASSERT_EQUAL( context.outgoingPublishRecords[ 1 ].publishState, MQTTStateNull );
-    TEST_ASSERT_EQUAL( context.outgoingPublishRecords[ 1 ].qos, MQTTQoS0 );
+    TEST_ASSERT_EQUAL( context.outgoingPublishRecords[ index ].packetId, MQTT_PACKET_ID_INVALID );
+    TEST_ASSERT_EQUAL( context.outgoingPublishRecords[ index ].publishState, MQTTStateNull );
+    TEST_ASSERT_EQUAL( context.outgoingPublishRecords[ index ].qos, MQTTQoS0 );
+    /* The record is no longer found. */
+    TEST_ASSERT_EQUAL( MQTTBadParameter, MQTT_RemoveStateRecord( &context, packetID ) );
 }
 
 /* ========================================================================== */
@@ -340,6 +385,7 @@ void test_MQTT_RemoveStateRecord_RemoveQoS2Record( void )
     const uint16_t packetID = 12;
     /* Any state except null state. */
     const MQTTPublishState_t state = MQTTPubRelSend;
+    size_t index;
 
     memset( &context, 0, sizeof( MQTTContext_t ) );
 
@@ -348,27 +394,31 @@ void test_MQTT_RemoveStateRecord_RemoveQoS2Record( void )
 
     memset( context.outgoingPublishRecords, 0, sizeof( outgoingRecords ) );
 
-    context.outgoingPublishRecords[ 1 ].packetId = packetID;
-    context.outgoingPublishRecords[ 1 ].publishState = state;
-    context.outgoingPublishRecords[ 1 ].qos = MQTTQoS2;
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_ReserveState( &context, packetID, MQTTQoS2 ) );
+    index = findRecord( context.outgoingPublishRecords, 5, packetID );
+    context.outgoingPublishRecords[ index ].publishState = state;
 
     /* Any non-zero packet ID. */
     status = MQTT_RemoveStateRecord( &context, packetID );
 
     TEST_ASSERT_EQUAL( MQTTSuccess, status );
-    TEST_ASSERT_EQUAL( context.outgoingPublishRecords[ 1 ].packetId, MQTT_PACKET_ID_INVALID );
-    TEST_ASSERT_EQUAL( context.outgoingPublishRecords[ 1 ].publishState, MQTTStateNull );
-    TEST_ASSERT_EQUAL( context.outgoingPublishRecords[ 1 ].qos, MQTTQoS0 );
+    TEST_ASSERT_EQUAL( context.outgoingPublishRecords[ index ].packetId, MQTT_PACKET_ID_INVALID );
+    TEST_ASSERT_EQUAL( context.outgoingPublishRecords[ index ].publishState, MQTTStateNull );
+    TEST_ASSERT_EQUAL( context.outgoingPublishRecords[ index ].qos, MQTTQoS0 );
+    /* The record is no longer found. */
+    TEST_ASSERT_EQUAL( MQTTBadParameter, MQTT_RemoveStateRecord( &context, packetID ) );
 }
 
 /* ========================================================================== */
 
-void test_MQTT_ReserveState_compactRecords( void )
+void test_MQTT_ReserveState_indexedRecords( void )
 {
     MQTTContext_t mqttContext = { 0 };
+    MQTTStateCursor_t cursor = MQTT_STATE_CURSOR_INITIALIZER;
+    MQTTPublishState_t state;
     MQTTStatus_t status;
-    const uint16_t PACKET_ID = 1;
-    const uint16_t PACKET_ID2 = 2;
+    uint16_t packetId;
+    uint16_t i;
 
     TransportInterface_t transport;
     MQTTFixedBuffer_t networkBuffer;
@@ -376,143 +426,116 @@ void test_MQTT_ReserveState_compactRecords( void )
     transport.recv = transportRecvSuccess;
     transport.send = transportSendSuccess;
 
-    MQTTPubAckInfo_t incomingRecords[ MQTT_STATE_ARRAY_MAX_COUNT ] = { 0 };
-    MQTTPubAckInfo_t outgoingRecords[ MQTT_STATE_ARRAY_MAX_COUNT ] = { 0 };
+    MQTTPubAckInfo_t incomingRecords[ MQTT_STATE_ARRAY_MAX_COUNT ];
+    MQTTPubAckInfo_t outgoingRecords[ MQTT_STATE_ARRAY_MAX_COUNT ];
 
     status = MQTT_Init( &mqttContext, &transport,
                         getTime, eventCallback, &networkBuffer );
     TEST_ASSERT_EQUAL( MQTTSuccess, status );
 
+    /* The records are cleared by the initialization. */
+    ( void ) memset( outgoingRecords, 0xA5, sizeof( outgoingRecords ) );
+    ( void ) memset( incomingRecords, 0xA5, sizeof( incomingRecords ) );
     status = MQTT_InitStatefulQoS( &mqttContext,
                                    outgoingRecords, MQTT_STATE_ARRAY_MAX_COUNT,
                                    incomingRecords, MQTT_STATE_ARRAY_MAX_COUNT );
     TEST_ASSERT_EQUAL( MQTTSuccess, status );
-
-    /* Consider the state of the array with 2 states. 1 indicates a non empty
-     * spot and 0 an empty spot. Size of the array is 10.
-     * Pre condition - 0 0 0 0 0 0 0 0 0 1.
-     * Add an element will try to compact the array and the resulting state
-     * should be - 1 1 0 0 0 0 0 0 0 0. */
-    addToRecord( mqttContext.outgoingPublishRecords,
-                 MQTT_STATE_ARRAY_MAX_COUNT - 1,
-                 PACKET_ID,
-                 MQTTQoS1,
-                 MQTTPubRelSend );
-    status = MQTT_ReserveState( &mqttContext, PACKET_ID2, MQTTQoS1 );
-    TEST_ASSERT_EQUAL( MQTTSuccess, status );
-    /* The existing record should be at index 0. */
-    validateRecordAt( mqttContext.outgoingPublishRecords,
-                      0,
-                      PACKET_ID,
-                      MQTTQoS1,
-                      MQTTPubRelSend );
-    /* New record should be added to index 1. */
-    validateRecordAt( mqttContext.outgoingPublishRecords,
-                      1,
-                      PACKET_ID2,
-                      MQTTQoS1,
-                      MQTTPublishSend );
-
-    /* One free spot.
-     * Pre condition - 1 1 1 0 1 1 1 1 1 1.
-     * Add an element will try to compact the array and the resulting state
-     * should be - 1 1 1 1 1 1 1 1 1 1. */
-    fillRecord( mqttContext.outgoingPublishRecords, PACKET_ID2 + 1, MQTTQoS2, MQTTPubRelSend );
-    /* Invalid record at index 3. */
-    mqttContext.outgoingPublishRecords[ 3 ].packetId = MQTT_PACKET_ID_INVALID;
-    status = MQTT_ReserveState( &mqttContext, PACKET_ID, MQTTQoS1 );
-    TEST_ASSERT_EQUAL( MQTTSuccess, status );
-    /* The new record should be added to the end. */
-    validateRecordAt( mqttContext.outgoingPublishRecords,
-                      MQTT_STATE_ARRAY_MAX_COUNT - 1,
-                      PACKET_ID,
-                      MQTTQoS1,
-                      MQTTPublishSend );
-    /* Any new add should result in no memory error. */
-    status = MQTT_ReserveState( &mqttContext, PACKET_ID2, MQTTQoS1 );
-    TEST_ASSERT_EQUAL( MQTTNoMemory, status );
-
-    /* Alternate free spots.
-     * Pre condition - 1 0 1 0 1 0 1 0 1 0.
-     * Add an element will skip to compact the array and the resulting state
-     * should be - 1 0 1 0 1 0 1 0 1 1. */
-    fillRecord( mqttContext.outgoingPublishRecords, PACKET_ID2 + 1, MQTTQoS2, MQTTPubRelSend );
-    /* Invalidate record at alternate indexes starting from 1. */
-    mqttContext.outgoingPublishRecords[ 1 ].packetId = MQTT_PACKET_ID_INVALID;
-    mqttContext.outgoingPublishRecords[ 3 ].packetId = MQTT_PACKET_ID_INVALID;
-    mqttContext.outgoingPublishRecords[ 5 ].packetId = MQTT_PACKET_ID_INVALID;
-    mqttContext.outgoingPublishRecords[ 7 ].packetId = MQTT_PACKET_ID_INVALID;
-    mqttContext.outgoingPublishRecords[ 9 ].packetId = MQTT_PACKET_ID_INVALID;
-    status = MQTT_ReserveState( &mqttContext, PACKET_ID, MQTTQoS1 );
-    TEST_ASSERT_EQUAL( MQTTSuccess, status );
-    /* The new record should be added to the end. */
-    validateRecordAt( mqttContext.outgoingPublishRecords,
-                      MQTT_STATE_ARRAY_MAX_COUNT - 1,
-                      PACKET_ID,
-                      MQTTQoS1,
-                      MQTTPublishSend );
-
-    /* Array is in state 1 0 1 0 1 0 1 0 1 1.
-     * Adding one more element should result in array in state
-     * 1 1 1 1 1 1 1 0 0 0. */
-    status = MQTT_ReserveState( &mqttContext, PACKET_ID2, MQTTQoS1 );
-    TEST_ASSERT_EQUAL( MQTTSuccess, status );
-    validateRecordAt( mqttContext.outgoingPublishRecords, 6, PACKET_ID2, MQTTQoS1, MQTTPublishSend );
-    /* Remaining records should be invalid. */
-    TEST_ASSERT_EQUAL( MQTT_PACKET_ID_INVALID, mqttContext.outgoingPublishRecords[ 7 ].packetId );
-    TEST_ASSERT_EQUAL( MQTT_PACKET_ID_INVALID, mqttContext.outgoingPublishRecords[ 8 ].packetId );
-    TEST_ASSERT_EQUAL( MQTT_PACKET_ID_INVALID, mqttContext.outgoingPublishRecords[ 9 ].packetId );
-
-    /* Free spots only in the beginning.
-     * Pre condition - 0 0 0 0 0 1 1 1 1 1.
-     * Add an element will compact the array and the resulting state
-     * should be - 1 1 1 1 1 1 0 0 0 0. */
-    fillRecord( mqttContext.outgoingPublishRecords, PACKET_ID2 + 1, MQTTQoS2, MQTTPubRelSend );
-    /* Clear record from 0 to 4. */
-    ( void ) memset( &mqttContext.outgoingPublishRecords[ 0 ], 0x00, 5 * sizeof( MQTTPubAckInfo_t ) );
-
-    /* Adding one element should result in array in state
-     * 1 1 1 1 1 1 0 0 0 0. */
-    status = MQTT_ReserveState( &mqttContext, PACKET_ID2, MQTTQoS1 );
-    TEST_ASSERT_EQUAL( MQTTSuccess, status );
-    validateRecordAt( mqttContext.outgoingPublishRecords, 5, PACKET_ID2, MQTTQoS1, MQTTPublishSend );
-    /* Remaining records should be cleared. */
+    TEST_ASSERT_EQUAL( MQTT_PACKET_ID_INVALID, MQTT_PublishToResend( &mqttContext, &cursor ) );
+
+    /* Records are stored at their packet ID modulo the record count, or at
+     * the next free index, wrapping around at the end of the array.
+     * State of the array - 19 0 0 0 0 5 15 0 0 9. */
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_ReserveState( &mqttContext, 5, MQTTQoS1 ) );
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_ReserveState( &mqttContext, 15, MQTTQoS1 ) );
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_ReserveState( &mqttContext, 9, MQTTQoS1 ) );
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_ReserveState( &mqttContext, 19, MQTTQoS1 ) );
+    TEST_ASSERT_EQUAL( 5, mqttContext.outgoingPublishRecords[ 5 ].packetId );
+    TEST_ASSERT_EQUAL( 15, mqttContext.outgoingPublishRecords[ 6 ].packetId );
+    TEST_ASSERT_EQUAL( 9, mqttContext.outgoingPublishRecords[ 9 ].packetId );
+    TEST_ASSERT_EQUAL( 19, mqttContext.outgoingPublishRecords[ 0 ].packetId );
+
+    /* A collision is found with a record that is not at its packet ID's index. */
+    TEST_ASSERT_EQUAL( MQTTStateCollision, MQTT_ReserveState( &mqttContext, 19, MQTTQoS1 ) );
+
+    /* Removing a record moves back the following records that would
+     * otherwise not be found.
+     * State of the array - 0 0 0 0 0 15 0 0 0 19. */
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_RemoveStateRecord( &mqttContext, 5 ) );
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_RemoveStateRecord( &mqttContext, 9 ) );
+    TEST_ASSERT_EQUAL( 15, mqttContext.outgoingPublishRecords[ 5 ].packetId );
     TEST_ASSERT_EQUAL( MQTT_PACKET_ID_INVALID, mqttContext.outgoingPublishRecords[ 6 ].packetId );
+    TEST_ASSERT_EQUAL( 19, mqttContext.outgoingPublishRecords[ 9 ].packetId );
+    TEST_ASSERT_EQUAL( MQTT_PACKET_ID_INVALID, mqttContext.outgoingPublishRecords[ 0 ].packetId );
+
+    /* A new record is stored ahead of records that are closer to their
+     * packet ID's index, which move forward.
+     * State of the array - 0 0 0 0 0 15 25 6 0 19. */
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_ReserveState( &mqttContext, 6, MQTTQoS1 ) );
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_ReserveState( &mqttContext, 25, MQTTQoS1 ) );
+    TEST_ASSERT_EQUAL( 25, mqttContext.outgoingPublishRecords[ 6 ].packetId );
+    TEST_ASSERT_EQUAL( 6, mqttContext.outgoingPublishRecords[ 7 ].packetId );
+
+    /* Removing a record moves back the following records until one that is
+     * at its packet ID's index.
+     * State of the array - 0 0 0 0 0 25 6 0 0 19. */
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_RemoveStateRecord( &mqttContext, 15 ) );
+    TEST_ASSERT_EQUAL( 25, mqttContext.outgoingPublishRecords[ 5 ].packetId );
+    TEST_ASSERT_EQUAL( 6, mqttContext.outgoingPublishRecords[ 6 ].packetId );
     TEST_ASSERT_EQUAL( MQTT_PACKET_ID_INVALID, mqttContext.outgoingPublishRecords[ 7 ].packetId );
-    TEST_ASSERT_EQUAL( MQTT_PACKET_ID_INVALID, mqttContext.outgoingPublishRecords[ 8 ].packetId );
-    TEST_ASSERT_EQUAL( MQTT_PACKET_ID_INVALID, mqttContext.outgoingPublishRecords[ 9 ].packetId );
-
-    /* Fragmented array.
-     * Pre condition - 1 0 0 1 1 1 1 0 0 1.
-     * Add an element will compact the array and the resulting state
-     * should be - 1 1 1 1 1 1 1 0 0 0. */
-    fillRecord( mqttContext.outgoingPublishRecords, PACKET_ID2 + 1, MQTTQoS2, MQTTPubRelSend );
-    /* Clear record at index 1,2,7 and 8. */
-    mqttContext.outgoingPublishRecords[ 1 ].packetId = MQTT_PACKET_ID_INVALID;
-    mqttContext.outgoingPublishRecords[ 2 ].packetId = MQTT_PACKET_ID_INVALID;
-    mqttContext.outgoingPublishRecords[ 7 ].packetId = MQTT_PACKET_ID_INVALID;
-    mqttContext.outgoingPublishRecords[ 8 ].packetId = MQTT_PACKET_ID_INVALID;
-    status = MQTT_ReserveState( &mqttContext, PACKET_ID2, MQTTQoS1 );
-    TEST_ASSERT_EQUAL( MQTTSuccess, status );
-    validateRecordAt( mqttContext.outgoingPublishRecords, 6, PACKET_ID2, MQTTQoS1, MQTTPublishSend );
-    /* Remaining records should be cleared. */
-    TEST_ASSERT_EQUAL( MQTT_PACKET_ID_INVALID, mqttContext.outgoingPublishRecords[ 7 ].packetId );
-    TEST_ASSERT_EQUAL( MQTT_PACKET_ID_INVALID, mqttContext.outgoingPublishRecords[ 8 ].packetId );
-    TEST_ASSERT_EQUAL( MQTT_PACKET_ID_INVALID, mqttContext.outgoingPublishRecords[ 9 ].packetId );
 
-    /* Fragmented array.
-     * Pre condition - 1 0 0 0 0 0 0 0 0 1.
-     * Add an element will compact the array and the resulting state
-     * should be - 1 1 1 0 0 0 0 0 0 0. */
-    resetPublishRecords( &mqttContext );
-    addToRecord( mqttContext.outgoingPublishRecords, 0, PACKET_ID, MQTTQoS2, MQTTPubRecPending );
-    addToRecord( mqttContext.outgoingPublishRecords, 9, PACKET_ID2 + 1, MQTTQoS2, MQTTPubCompPending );
-    status = MQTT_ReserveState( &mqttContext, PACKET_ID2, MQTTQoS1 );
-    TEST_ASSERT_EQUAL( MQTTSuccess, status );
-    validateRecordAt( mqttContext.outgoingPublishRecords, 2, PACKET_ID2, MQTTQoS1, MQTTPublishSend );
-    /* Validate existing records. */
-    validateRecordAt( mqttContext.outgoingPublishRecords, 0, PACKET_ID, MQTTQoS2, MQTTPubRecPending );
-    validateRecordAt( mqttContext.outgoingPublishRecords, 1, PACKET_ID2 + 1, MQTTQoS2, MQTTPubCompPending );
+    /* Moving records does not change the order in which they were added. */
+    cursor = MQTT_STATE_CURSOR_INITIALIZER;
+    TEST_ASSERT_EQUAL( 19, MQTT_PublishToResend( &mqttContext, &cursor ) );
+    TEST_ASSERT_EQUAL( 6, MQTT_PublishToResend( &mqttContext, &cursor ) );
+    TEST_ASSERT_EQUAL( 25, MQTT_PublishToResend( &mqttContext, &cursor ) );
+    TEST_ASSERT_EQUAL( MQTT_PACKET_ID_INVALID, MQTT_PublishToResend( &mqttContext, &cursor ) );
+
+    /* Fill the remaining records. */
+    for( i = 0; i < ( MQTT_STATE_ARRAY_MAX_COUNT - 3 ); i++ )
+    {
+        TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_ReserveState( &mqttContext, 100 + i, MQTTQoS1 ) );
+    }
+
+    TEST_ASSERT_EQUAL( MQTTNoMemory, MQTT_ReserveState( &mqttContext, 200, MQTTQoS1 ) );
+    TEST_ASSERT_EQUAL( MQTTStateCollision, MQTT_ReserveState( &mqttContext, 106, MQTTQoS1 ) );
+
+    /* Completing a publish frees its record for a new one, which is the
+     * last to be resent. */
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_UpdateStatePublish( &mqttContext, 6, MQTT_SEND, MQTTQoS1, &state ) );
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_UpdateStateAck( &mqttContext, 6, MQTTPuback, MQTT_RECEIVE, &state ) );
+    TEST_ASSERT_EQUAL( MQTTPublishDone, state );
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_ReserveState( &mqttContext, 200, MQTTQoS1 ) );
+
+    cursor = MQTT_STATE_CURSOR_INITIALIZER;
+    TEST_ASSERT_EQUAL( 19, MQTT_PublishToResend( &mqttContext, &cursor ) );
+    TEST_ASSERT_EQUAL( 25, MQTT_PublishToResend( &mqttContext, &cursor ) );
+
+    for( i = 0; i < ( MQTT_STATE_ARRAY_MAX_COUNT - 3 ); i++ )
+    {
+        TEST_ASSERT_EQUAL( 100 + i, MQTT_PublishToResend( &mqttContext, &cursor ) );
+    }
+
+    packetId = MQTT_PublishToResend( &mqttContext, &cursor );
+    TEST_ASSERT_EQUAL( 200, packetId );
+    TEST_ASSERT_EQUAL( MQTT_PACKET_ID_INVALID, MQTT_PublishToResend( &mqttContext, &cursor ) );
+
+    /* Removing every record leaves an empty array. */
+    cursor = MQTT_STATE_CURSOR_INITIALIZER;
+
+    while( ( packetId = MQTT_PublishToResend( &mqttContext, &cursor ) ) != MQTT_PACKET_ID_INVALID )
+    {
+        TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_RemoveStateRecord( &mqttContext, packetId ) );
+        cursor = MQTT_STATE_CURSOR_INITIALIZER;
+    }
+
+    for( i = 0; i < MQTT_STATE_ARRAY_MAX_COUNT; i++ )
+    {
+        TEST_ASSERT_EQUAL( MQTT_PACKET_ID_INVALID, mqttContext.outgoingPublishRecords[ i ].packetId );
+        TEST_ASSERT_EQUAL( 0, mqttContext.outgoingPublishRecords[ i ].prevRecord );
+        TEST_ASSERT_EQUAL( 0, mqttContext.outgoingPublishRecords[ i ].nextRecord );
+    }
+
+    TEST_ASSERT_EQUAL( 0, mqttContext.outgoingPublishRecords[ 0 ].oldestRecord );
 }
 
 /* ========================================================================== */
@@ -584,18 +607,18 @@ void test_MQTT_UpdateStatePublish( void )
     status = MQTT_UpdateStatePublish( &mqttContext, PACKET_ID, operation, qos, &state );
     TEST_ASSERT_EQUAL( MQTTBadParameter, status );
     /* QoS mismatch. */
-    addToRecord( mqttContext.outgoingPublishRecords, 0, PACKET_ID, MQTTQoS2, MQTTPublishSend );
+    addToRecord( &mqttContext, mqttContext.outgoingPublishRecords, PACKET_ID, MQTTQoS2, MQTTPublishSend );
     status = MQTT_UpdateStatePublish( &mqttContext, PACKET_ID, operation, qos, &state );
     TEST_ASSERT_EQUAL( MQTTBadParameter, status );
 
     /* Invalid state transition. */
-    addToRecord( mqttContext.outgoingPublishRecords, 0, PACKET_ID, MQTTQoS1, MQTTPubRelPending );
+    addToRecord( &mqttContext, mqttContext.outgoingPublishRecords, PACKET_ID, MQTTQoS1, MQTTPubRelPending );
     status = MQTT_UpdateStatePublish( &mqttContext, PACKET_ID, operation, qos, &state );
     TEST_ASSERT_EQUAL( MQTTIllegalState, status );
 
     /* Invalid QoS. */
     operation = MQTT_SEND;
-    addToRecord( mqttContext.outgoingPublishRecords, 0, PACKET_ID, 3, MQTTPublishSend );
+    addToRecord( &mqttContext, mqttContext.outgoingPublishRecords, PACKET_ID, 3, MQTTPublishSend );
     status = MQTT_UpdateStatePublish( &mqttContext, PACKET_ID, operation, 3, &state );
     TEST_ASSERT_EQUAL( MQTTIllegalState, status );
     operation = MQTT_RECEIVE;
@@ -604,19 +627,20 @@ void test_MQTT_UpdateStatePublish( void )
 
     /* Invalid current state. */
     operation = MQTT_SEND;
-    addToRecord( mqttContext.outgoingPublishRecords, 0, PACKET_ID, qos, MQTTStateNull );
+    addToRecord( &mqttContext, mqttContext.outgoingPublishRecords, PACKET_ID, qos, MQTTStateNull );
     status = MQTT_UpdateStatePublish( &mqttContext, PACKET_ID, operation, qos, &state );
     TEST_ASSERT_EQUAL( MQTTIllegalState, status );
 
     /* Collision. */
     operation = MQTT_RECEIVE;
-    addToRecord( mqttContext.incomingPublishRecords, 0, PACKET_ID, MQTTQoS1, MQTTPubAckSend );
+    addToRecord( &mqttContext, mqttContext.incomingPublishRecords, PACKET_ID, MQTTQoS1, MQTTPubAckSend );
     status = MQTT_UpdateStatePublish( &mqttContext, PACKET_ID, operation, qos, &state );
     TEST_ASSERT_EQUAL( MQTTStateCollision, status );
 
     /* No memory. */
     operation = MQTT_RECEIVE;
-    fillRecord( mqttContext.incomingPublishRecords, 2, MQTTQoS1, MQTTPublishSend );
+    resetPublishRecords( &mqttContext );
+    fillRecord( &mqttContext, mqttContext.incomingPublishRecords, 2, MQTTQoS1, MQTTPublishSend );
     status = MQTT_UpdateStatePublish( &mqttContext, PACKET_ID, operation, qos, &state );
     TEST_ASSERT_EQUAL( MQTTNoMemory, status );
 
@@ -626,27 +650,27 @@ void test_MQTT_UpdateStatePublish( void )
     qos = MQTTQoS1;
     /* Send. */
     operation = MQTT_SEND;
-    addToRecord( mqttContext.outgoingPublishRecords, 0, PACKET_ID, MQTTQoS1, MQTTPublishSend );
+    addToRecord( &mqttContext, mqttContext.outgoingPublishRecords, PACKET_ID, MQTTQoS1, MQTTPublishSend );
     status = MQTT_UpdateStatePublish( &mqttContext, PACKET_ID, operation, qos, &state );
     TEST_ASSERT_EQUAL( MQTTSuccess, status );
     TEST_ASSERT_EQUAL( MQTTPubAckPending, state );
-    TEST_ASSERT_EQUAL( MQTTPubAckPending, mqttContext.outgoingPublishRecords[ 0 ].publishState );
+    TEST_ASSERT_EQUAL( MQTTPubAckPending, recordState( mqttContext.outgoingPublishRecords, PACKET_ID ) );
     /* Resend when record already exists. */
     status = MQTT_UpdateStatePublish( &mqttContext, PACKET_ID, operation, qos, &state );
     TEST_ASSERT_EQUAL( MQTTSuccess, status );
     TEST_ASSERT_EQUAL( MQTTPubAckPending, state );
-    TEST_ASSERT_EQUAL( MQTTPubAckPending, mqttContext.outgoingPublishRecords[ 0 ].publishState );
+    TEST_ASSERT_EQUAL( MQTTPubAckPending, recordState( mqttContext.outgoingPublishRecords, PACKET_ID ) );
     /* Receive. */
     operation = MQTT_RECEIVE;
     status = MQTT_UpdateStatePublish( &mqttContext, PACKET_ID, operation, qos, &state );
     TEST_ASSERT_EQUAL( MQTTSuccess, status );
     TEST_ASSERT_EQUAL( MQTTPubAckSend, state );
-    TEST_ASSERT_EQUAL( MQTTPubAckSend, mqttContext.incomingPublishRecords[ 0 ].publishState );
+    TEST_ASSERT_EQUAL( MQTTPubAckSend, recordState( mqttContext.incomingPublishRecords, PACKET_ID ) );
     /* Receive duplicate incoming publish. */
     status = MQTT_UpdateStatePublish( &mqttContext, PACKET_ID, operation, qos, &state );
     TEST_ASSERT_EQUAL( MQTTStateCollision, status );
     TEST_ASSERT_EQUAL( MQTTPubAckSend, state );
-    TEST_ASSERT_EQUAL( MQTTPubAckSend, mqttContext.incomingPublishRecords[ 0 ].publishState );
+    TEST_ASSERT_EQUAL( MQTTPubAckSend, recordState( mqttContext.incomingPublishRecords, PACKET_ID ) );
 
     resetPublishRecords( &mqttContext );
 
@@ -654,34 +678,34 @@ void test_MQTT_UpdateStatePublish( void )
     qos = MQTTQoS2;
     /* Send. */
     operation = MQTT_SEND;
-    addToRecord( mqttContext.outgoingPublishRecords, 0, PACKET_ID, MQTTQoS2, MQTTPublishSend );
+    addToRecord( &mqttContext, mqttContext.outgoingPublishRecords, PACKET_ID, MQTTQoS2, MQTTPublishSend );
     status = MQTT_UpdateStatePublish( &mqttContext, PACKET_ID, operation, qos, &state );
     TEST_ASSERT_EQUAL( MQTTSuccess, status );
     TEST_ASSERT_EQUAL( MQTTPubRecPending, state );
-    TEST_ASSERT_EQUAL( MQTTPubRecPending, mqttContext.outgoingPublishRecords[ 0 ].publishState );
+    TEST_ASSERT_EQUAL( MQTTPubRecPending, recordState( mqttContext.outgoingPublishRecords, PACKET_ID ) );
     /* Resend when record already exists. */
     status = MQTT_UpdateStatePublish( &mqttContext, PACKET_ID, operation, qos, &state );
     TEST_ASSERT_EQUAL( MQTTSuccess, status );
     TEST_ASSERT_EQUAL( MQTTPubRecPending, state );
-    TEST_ASSERT_EQUAL( MQTTPubRecPending, mqttContext.outgoingPublishRecords[ 0 ].publishState );
+    TEST_ASSERT_EQUAL( MQTTPubRecPending, recordState( mqttContext.outgoingPublishRecords, PACKET_ID ) );
     /* Receive. */
     operation = MQTT_RECEIVE;
     status = MQTT_UpdateStatePublish( &mqttContext, PACKET_ID, operation, qos, &state );
     TEST_ASSERT_EQUAL( MQTTSuccess, status );
     TEST_ASSERT_EQUAL( MQTTPubRecSend, state );
-    TEST_ASSERT_EQUAL( MQTTPubRecSend, mqttContext.incomingPublishRecords[ 0 ].publishState );
+    TEST_ASSERT_EQUAL( MQTTPubRecSend, recordState( mqttContext.incomingPublishRecords, PACKET_ID ) );
     /* Receive incoming publish when the packet record is in state #MQTTPubRecSend. */
     status = MQTT_UpdateStatePublish( &mqttContext, PACKET_ID, operation, qos, &state );
     TEST_ASSERT_EQUAL( MQTTStateCollision, status );
     TEST_ASSERT_EQUAL( MQTTPubRecSend, state );
-    TEST_ASSERT_EQUAL( MQTTPubRecSend, mqttContext.incomingPublishRecords[ 0 ].publishState );
+    TEST_ASSERT_EQUAL( MQTTPubRecSend, recordState( mqttContext.incomingPublishRecords, PACKET_ID ) );
     /* Receive incoming publish when the packet record is in state #MQTTPubRelPending. */
-    addToRecord( mqttContext.incomingPublishRecords, 0, PACKET_ID, MQTTQoS2, MQTTPubRelPending );
+    addToRecord( &mqttContext, mqttContext.incomingPublishRecords, PACKET_ID, MQTTQoS2, MQTTPubRelPending );
     status = MQTT_UpdateStatePublish( &mqttContext, PACKET_ID, operation, qos, &state );
     TEST_ASSERT_EQUAL( MQTTStateCollision, status );
     /* The returned state will always be #MQTTPubRecSend as a PUBREC need to be sent. */
     TEST_ASSERT_EQUAL( MQTTPubRecSend, state );
-    TEST_ASSERT_EQUAL( MQTTPubRelPending, mqttContext.incomingPublishRecords[ 0 ].publishState );
+    TEST_ASSERT_EQUAL( MQTTPubRelPending, recordState( mqttContext.incomingPublishRecords, PACKET_ID ) );
 }
 
 /* ========================================================================== */
@@ -753,6 +777,7 @@ void test_MQTT_UpdateStateAck( void )
     MQTTPubAckType_t ack = MQTTPuback;
     MQTTStateOperation_t operation = MQTT_RECEIVE;
     MQTTPublishState_t state = MQTTStateNull;
+    MQTTStateCursor_t cursor;
     MQTTStatus_t status;
 
     const uint16_t PACKET_ID = 1;
@@ -788,23 +813,23 @@ void test_MQTT_UpdateStateAck( void )
 
     /* Invalid transitions. */
     /* Invalid transition from #MQTTPubRelPending. */
-    addToRecord( mqttContext.outgoingPublishRecords, 0, PACKET_ID, MQTTQoS2, MQTTPubRelPending );
+    addToRecord( &mqttContext, mqttContext.outgoingPublishRecords, PACKET_ID, MQTTQoS2, MQTTPubRelPending );
     ack = MQTTPubrel;
     operation = MQTT_SEND;
     status = MQTT_UpdateStateAck( &mqttContext, PACKET_ID, ack, operation, &state );
     TEST_ASSERT_EQUAL( MQTTIllegalState, status );
     /* Invalid transition from #MQTTPubCompSend. */
-    addToRecord( mqttContext.outgoingPublishRecords, 0, PACKET_ID, MQTTQoS2, MQTTPubCompSend );
+    addToRecord( &mqttContext, mqttContext.outgoingPublishRecords, PACKET_ID, MQTTQoS2, MQTTPubCompSend );
     status = MQTT_UpdateStateAck( &mqttContext, PACKET_ID, ack, operation, &state );
     TEST_ASSERT_EQUAL( MQTTIllegalState, status );
     /* Invalid transition from #MQTTPubCompPending. */
-    addToRecord( mqttContext.outgoingPublishRecords, 0, PACKET_ID, MQTTQoS2, MQTTPubCompPending );
+    addToRecord( &mqttContext, mqttContext.outgoingPublishRecords, PACKET_ID, MQTTQoS2, MQTTPubCompPending );
     ack = MQTTPubrec;
     operation = MQTT_RECEIVE;
     status = MQTT_UpdateStateAck( &mqttContext, PACKET_ID, ack, operation, &state );
     TEST_ASSERT_EQUAL( MQTTIllegalState, status );
     /* Invalid transition from #MQTTPubRecPending. */
-    addToRecord( mqttContext.outgoingPublishRecords, 0, PACKET_ID, MQTTQoS2, MQTTPubRecPending );
+    addToRecord( &mqttContext, mqttContext.outgoingPublishRecords, PACKET_ID, MQTTQoS2, MQTTPubRecPending );
     ack = MQTTPubcomp;
     status = MQTT_UpdateStateAck( &mqttContext, 1, ack, operation, &state );
     TEST_ASSERT_EQUAL( MQTTIllegalState, status );
@@ -814,20 +839,20 @@ void test_MQTT_UpdateStateAck( void )
     TEST_ASSERT_EQUAL( MQTTBadParameter, status );
 
     /* Invalid current state. */
-    addToRecord( mqttContext.outgoingPublishRecords, 0, PACKET_ID, MQTTQoS2, MQTTPublishDone );
+    addToRecord( &mqttContext, mqttContext.outgoingPublishRecords, PACKET_ID, MQTTQoS2, MQTTPublishDone );
     status = MQTT_UpdateStateAck( &mqttContext, PACKET_ID, ack, operation, &state );
     TEST_ASSERT_EQUAL( MQTTIllegalState, status );
-    addToRecord( mqttContext.outgoingPublishRecords, 0, PACKET_ID, MQTTQoS2, MQTTPublishSend );
+    addToRecord( &mqttContext, mqttContext.outgoingPublishRecords, PACKET_ID, MQTTQoS2, MQTTPublishSend );
     status = MQTT_UpdateStateAck( &mqttContext, PACKET_ID, ack, operation, &state );
     TEST_ASSERT_EQUAL( MQTTIllegalState, status );
-    addToRecord( mqttContext.outgoingPublishRecords, 0, PACKET_ID, MQTTQoS2, MQTTStateNull );
+    addToRecord( &mqttContext, mqttContext.outgoingPublishRecords, PACKET_ID, MQTTQoS2, MQTTStateNull );
     status = MQTT_UpdateStateAck( &mqttContext, PACKET_ID, ack, operation, &state );
     TEST_ASSERT_EQUAL( MQTTIllegalState, status );
 
     resetPublishRecords( &mqttContext );
 
     /* QoS 1, receive PUBACK for outgoing publish. */
-    addToRecord( mqttContext.outgoingPublishRecords, 0, PACKET_ID, MQTTQoS1, MQTTPubAckPending );
+    addToRecord( &mqttContext, mqttContext.outgoingPublishRecords, PACKET_ID, MQTTQoS1, MQTTPubAckPending );
     operation = MQTT_RECEIVE;
     ack = MQTTPuback;
     status = MQTT_UpdateStateAck( &mqttContext, PACKET_ID, ack, operation, &state );
@@ -835,10 +860,11 @@ void test_MQTT_UpdateStateAck( void )
     TEST_ASSERT_EQUAL( MQTTPublishDone, state );
 
     /* Test for deletion. */
-    TEST_ASSERT_EQUAL( MQTT_PACKET_ID_INVALID, mqttContext.outgoingPublishRecords[ 0 ].packetId );
+    TEST_ASSERT_EQUAL( MQTT_STATE_ARRAY_MAX_COUNT,
+                       findRecord( mqttContext.outgoingPublishRecords, MQTT_STATE_ARRAY_MAX_COUNT, PACKET_ID ) );
     /* Send PUBACK for incoming publish. */
     operation = MQTT_SEND;
-    addToRecord( mqttContext.incomingPublishRecords, 0, PACKET_ID, MQTTQoS1, MQTTPubAckSend );
+    addToRecord( &mqttContext, mqttContext.incomingPublishRecords, PACKET_ID, MQTTQoS1, MQTTPubAckSend );
     status = MQTT_UpdateStateAck( &mqttContext, PACKET_ID, ack, operation, &state );
     TEST_ASSERT_EQUAL( MQTTSuccess, status );
     TEST_ASSERT_EQUAL( MQTTPublishDone, state );
@@ -847,7 +873,7 @@ void test_MQTT_UpdateStateAck( void )
 
     /* QoS 2, PUBREL. */
     /* Outgoing. */
-    addToRecord( mqttContext.outgoingPublishRecords, 0, PACKET_ID, MQTTQoS2, MQTTPubRelSend );
+    addToRecord( &mqttContext, mqttContext.outgoingPublishRecords, PACKET_ID, MQTTQoS2, MQTTPubRelSend );
     operation = MQTT_SEND;
     ack = MQTTPubrel;
     status = MQTT_UpdateStateAck( &mqttContext, PACKET_ID, ack, operation, &state );
@@ -860,13 +886,13 @@ void test_MQTT_UpdateStateAck( void )
     TEST_ASSERT_EQUAL( MQTTSuccess, status );
     TEST_ASSERT_EQUAL( MQTTPubCompPending, state );
     /* Incoming. */
-    addToRecord( mqttContext.incomingPublishRecords, 0, PACKET_ID, MQTTQoS2, MQTTPubRelPending );
+    addToRecord( &mqttContext, mqttContext.incomingPublishRecords, PACKET_ID, MQTTQoS2, MQTTPubRelPending );
     operation = MQTT_RECEIVE;
     status = MQTT_UpdateStateAck( &mqttContext, PACKET_ID, ack, operation, &state );
     TEST_ASSERT_EQUAL( MQTTSuccess, status );
     TEST_ASSERT_EQUAL( MQTTPubCompSend, state );
     /* Test for update. */
-    TEST_ASSERT_EQUAL( MQTTPubCompSend, mqttContext.incomingPublishRecords[ 0 ].publishState );
+    TEST_ASSERT_EQUAL( MQTTPubCompSend, recordState( mqttContext.incomingPublishRecords, PACKET_ID ) );
     /* Incoming. Duplicate PUBREL is received when record is in state #MQTTPubRelPending. */
     status = MQTT_UpdateStateAck( &mqttContext, PACKET_ID, ack, operation, &state );
     TEST_ASSERT_EQUAL( MQTTSuccess, status );
@@ -874,7 +900,7 @@ void test_MQTT_UpdateStateAck( void )
 
     /* QoS 2, PUBREC. */
     /* Outgoing. */
-    addToRecord( mqttContext.outgoingPublishRecords, 0, PACKET_ID, MQTTQoS2, MQTTPubRecPending );
+    addToRecord( &mqttContext, mqttContext.outgoingPublishRecords, PACKET_ID, MQTTQoS2, MQTTPubRecPending );
     operation = MQTT_RECEIVE;
     ack = MQTTPubrec;
     status = MQTT_UpdateStateAck( &mqttContext, PACKET_ID, ack, operation, &state );
@@ -883,50 +909,48 @@ void test_MQTT_UpdateStateAck( void )
 
     /* Receiving a PUBREC will move the record to the end.
      * In this case, only one record exists, no moving is required. */
-    TEST_ASSERT_EQUAL( PACKET_ID, mqttContext.outgoingPublishRecords[ 0 ].packetId );
-    TEST_ASSERT_EQUAL( MQTTQoS2, mqttContext.outgoingPublishRecords[ 0 ].qos );
-    TEST_ASSERT_EQUAL( MQTTPubRelSend, mqttContext.outgoingPublishRecords[ 0 ].publishState );
+    validateRecord( mqttContext.outgoingPublishRecords, PACKET_ID, MQTTQoS2, MQTTPubRelSend );
 
     /* Outgoing.
      * Test if the record moves to the end of the records when PUBREC is
      * received. */
     resetPublishRecords( &mqttContext );
-    addToRecord( mqttContext.outgoingPublishRecords, 0, PACKET_ID, MQTTQoS2, MQTTPubRecPending );
-    addToRecord( mqttContext.outgoingPublishRecords, 1, PACKET_ID + 1, MQTTQoS2, MQTTPubRelSend );
+    addToRecord( &mqttContext, mqttContext.outgoingPublishRecords, PACKET_ID, MQTTQoS2, MQTTPubRecPending );
+    addToRecord( &mqttContext, mqttContext.outgoingPublishRecords, PACKET_ID + 1, MQTTQoS2, MQTTPubRelSend );
     status = MQTT_UpdateStateAck( &mqttContext, PACKET_ID, ack, operation, &state );
     TEST_ASSERT_EQUAL( MQTTSuccess, status );
     TEST_ASSERT_EQUAL( MQTTPubRelSend, state );
 
     /* Receiving a PUBREC will move the record to the end.
-     * In this case, the record will be moved to index 2. */
-    TEST_ASSERT_EQUAL( PACKET_ID, mqttContext.outgoingPublishRecords[ 2 ].packetId );
-    TEST_ASSERT_EQUAL( MQTTQoS2, mqttContext.outgoingPublishRecords[ 2 ].qos );
-    TEST_ASSERT_EQUAL( MQTTPubRelSend, mqttContext.outgoingPublishRecords[ 2 ].publishState );
-    /* Record at the current index will be marked as invalid. */
-    TEST_ASSERT_EQUAL( MQTT_PACKET_ID_INVALID, mqttContext.outgoingPublishRecords[ 0 ].packetId );
+     * In this case, the record will be resent after the other one. */
+    validateRecord( mqttContext.outgoingPublishRecords, PACKET_ID, MQTTQoS2, MQTTPubRelSend );
+    cursor = MQTT_STATE_CURSOR_INITIALIZER;
+    TEST_ASSERT_EQUAL( PACKET_ID + 1, MQTT_PubrelToResend( &mqttContext, &cursor, &state ) );
+    TEST_ASSERT_EQUAL( PACKET_ID, MQTT_PubrelToResend( &mqttContext, &cursor, &state ) );
+    TEST_ASSERT_EQUAL( MQTT_PACKET_ID_INVALID, MQTT_PubrelToResend( &mqttContext, &cursor, &state ) );
 
     /* Incoming. */
-    addToRecord( mqttContext.incomingPublishRecords, 0, PACKET_ID, MQTTQoS2, MQTTPubRecSend );
+    addToRecord( &mqttContext, mqttContext.incomingPublishRecords, PACKET_ID, MQTTQoS2, MQTTPubRecSend );
     operation = MQTT_SEND;
     status = MQTT_UpdateStateAck( &mqttContext, PACKET_ID, ack, operation, &state );
     TEST_ASSERT_EQUAL( MQTTSuccess, status );
     TEST_ASSERT_EQUAL( MQTTPubRelPending, state );
     /* Incoming. Duplicate publish received and record is in state #MQTTPubRelPending. */
-    addToRecord( mqttContext.incomingPublishRecords, 0, PACKET_ID, MQTTQoS2, MQTTPubRelPending );
+    addToRecord( &mqttContext, mqttContext.incomingPublishRecords, PACKET_ID, MQTTQoS2, MQTTPubRelPending );
     status = MQTT_UpdateStateAck( &mqttContext, PACKET_ID, ack, operation, &state );
     TEST_ASSERT_EQUAL( MQTTSuccess, status );
     TEST_ASSERT_EQUAL( MQTTPubRelPending, state );
 
     /* QoS 2, PUBCOMP. */
     /* Outgoing. */
-    addToRecord( mqttContext.outgoingPublishRecords, 0, PACKET_ID, MQTTQoS2, MQTTPubCompPending );
+    addToRecord( &mqttContext, mqttContext.outgoingPublishRecords, PACKET_ID, MQTTQoS2, MQTTPubCompPending );
     operation = MQTT_RECEIVE;
     ack = MQTTPubcomp;
     status = MQTT_UpdateStateAck( &mqttContext, PACKET_ID, ack, operation, &state );
     TEST_ASSERT_EQUAL( MQTTSuccess, status );
     TEST_ASSERT_EQUAL( MQTTPublishDone, state );
     /* Incoming. */
-    addToRecord( mqttContext.incomingPublishRecords, 0, PACKET_ID, MQTTQoS2, MQTTPubCompSend );
+    addToRecord( &mqttContext, mqttContext.incomingPublishRecords, PACKET_ID, MQTTQoS2, MQTTPubCompSend );
     operation = MQTT_SEND;
     status = MQTT_UpdateStateAck( &mqttContext, PACKET_ID, ack, operation, &state );
     TEST_ASSERT_EQUAL( MQTTSuccess, status );
@@ -945,10 +969,7 @@ void test_MQTT_AckToResend( void )
     const uint16_t PACKET_ID2 = 2;
     const uint16_t PACKET_ID3 = 3;
     const uint16_t PACKET_ID4 = 4;
-    const size_t index = 0;
-    const size_t index2 = 1;
-    const size_t index3 = MQTT_STATE_ARRAY_MAX_COUNT / 2;
-    const size_t index4 = index3 + 2;
+    const uint16_t PACKET_ID5 = 5;
 
     MQTTPubAckInfo_t incomingRecords[ MQTT_STATE_ARRAY_MAX_COUNT ] = { 0 };
     MQTTPubAckInfo_t outgoingRecords[ MQTT_STATE_ARRAY_MAX_COUNT ] = { 0 };
@@ -981,46 +1002,48 @@ void test_MQTT_AckToResend( void )
     packetId = MQTT_PubrelToResend( &mqttContext, &cursor, &state );
     TEST_ASSERT_EQUAL( MQTT_PACKET_ID_INVALID, packetId );
     TEST_ASSERT_EQUAL( MQTTStateNull, state );
-    TEST_ASSERT_EQUAL( MQTT_STATE_ARRAY_MAX_COUNT, cursor );
+    TEST_ASSERT_EQUAL( MQTT_STATE_CURSOR_INITIALIZER, cursor );
 
-    /* No packet exists in state #MQTTPubCompPending or #MQTTPubCompPending states. */
+    /* No packet exists in state #MQTTPubCompPending or #MQTTPubCompPending states.
+     * The cursor holds the packet ID of the record visited last, which is
+     * the newest record throughout this test. */
     cursor = MQTT_STATE_CURSOR_INITIALIZER;
-    addToRecord( mqttContext.outgoingPublishRecords, index, PACKET_ID3, MQTTQoS2, MQTTPubRelPending );
-    addToRecord( mqttContext.outgoingPublishRecords, index2, PACKET_ID4, MQTTQoS2, MQTTPubCompSend );
+    addToRecord( &mqttContext, mqttContext.outgoingPublishRecords, PACKET_ID3, MQTTQoS2, MQTTPubRelPending );
+    addToRecord( &mqttContext, mqttContext.outgoingPublishRecords, PACKET_ID4, MQTTQoS2, MQTTPubCompSend );
     packetId = MQTT_PubrelToResend( &mqttContext, &cursor, &state );
     TEST_ASSERT_EQUAL( MQTT_PACKET_ID_INVALID, packetId );
     TEST_ASSERT_EQUAL( MQTTStateNull, state );
-    TEST_ASSERT_EQUAL( MQTT_STATE_ARRAY_MAX_COUNT, cursor );
+    TEST_ASSERT_EQUAL( PACKET_ID4, cursor );
 
     /* Add a record in #MQTTPubCompPending state. */
     cursor = MQTT_STATE_CURSOR_INITIALIZER;
-    addToRecord( mqttContext.outgoingPublishRecords, index3, PACKET_ID, MQTTQoS2, MQTTPubCompPending );
+    addToRecord( &mqttContext, mqttContext.outgoingPublishRecords, PACKET_ID, MQTTQoS2, MQTTPubCompPending );
     packetId = MQTT_PubrelToResend( &mqttContext, &cursor, &state );
     TEST_ASSERT_EQUAL( PACKET_ID, packetId );
-    TEST_ASSERT_EQUAL( index3 + 1, cursor );
+    TEST_ASSERT_EQUAL( PACKET_ID, cursor );
     TEST_ASSERT_EQUAL( MQTTPubRelSend, state );
 
     /* Add another record in #MQTTPubCompPending state. */
-    addToRecord( mqttContext.outgoingPublishRecords, index4, PACKET_ID2, MQTTQoS2, MQTTPubCompPending );
+    addToRecord( &mqttContext, mqttContext.outgoingPublishRecords, PACKET_ID2, MQTTQoS2, MQTTPubCompPending );
     packetId = MQTT_PubrelToResend( &mqttContext, &cursor, &state );
     TEST_ASSERT_EQUAL( PACKET_ID2, packetId );
-    TEST_ASSERT_EQUAL( index4 + 1, cursor );
+    TEST_ASSERT_EQUAL( PACKET_ID2, cursor );
     TEST_ASSERT_EQUAL( MQTTPubRelSend, state );
 
     /* Add another record in #MQTTPubRelSend state. */
-    addToRecord( mqttContext.outgoingPublishRecords, index4 + 1, PACKET_ID2 + 1, MQTTQoS2, MQTTPubRelSend );
+    addToRecord( &mqttContext, mqttContext.outgoingPublishRecords, PACKET_ID5, MQTTQoS2, MQTTPubRelSend );
     packetId = MQTT_PubrelToResend( &mqttContext, &cursor, &state );
-    TEST_ASSERT_EQUAL( PACKET_ID2 + 1, packetId );
-    TEST_ASSERT_EQUAL( index4 + 2, cursor );
+    TEST_ASSERT_EQUAL( PACKET_ID5, packetId );
+    TEST_ASSERT_EQUAL( PACKET_ID5, cursor );
     TEST_ASSERT_EQUAL( MQTTPubRelSend, state );
 
     /* Only one record in #MQTTPubRelSend state. */
     resetPublishRecords( &mqttContext );
     cursor = MQTT_STATE_CURSOR_INITIALIZER;
-    addToRecord( mqttContext.outgoingPublishRecords, index3, PACKET_ID, MQTTQoS2, MQTTPubRelSend );
+    addToRecord( &mqttContext, mqttContext.outgoingPublishRecords, PACKET_ID, MQTTQoS2, MQTTPubRelSend );
     packetId = MQTT_PubrelToResend( &mqttContext, &cursor, &state );
     TEST_ASSERT_EQUAL( PACKET_ID, packetId );
-    TEST_ASSERT_EQUAL( index3 + 1, cursor );
+    TEST_ASSERT_EQUAL( PACKET_ID, cursor );
     TEST_ASSERT_EQUAL( MQTTPubRelSend, state );
 
     /* Further search should be return no valid packets. */
@@ -1028,7 +1051,7 @@ void test_MQTT_AckToResend( void )
     packetId = MQTT_PubrelToResend( &mqttContext, &cursor, &state );
     TEST_ASSERT_EQUAL( MQTT_PACKET_ID_INVALID, packetId );
     TEST_ASSERT_EQUAL( MQTTStateNull, state );
-    TEST_ASSERT_EQUAL( MQTT_STATE_ARRAY_MAX_COUNT, cursor );
+    TEST_ASSERT_EQUAL( PACKET_ID, cursor );
 }
 
 void test_MQTT_PublishToResend( void )
@@ -1040,10 +1063,7 @@ void test_MQTT_PublishToResend( void )
     const uint16_t PACKET_ID2 = 2;
     const uint16_t PACKET_ID3 = 3;
     const uint16_t PACKET_ID4 = 4;
-    const size_t index = 0;
-    const size_t index2 = 1;
-    const size_t index3 = MQTT_STATE_ARRAY_MAX_COUNT / 2;
-    const size_t index4 = index3 + 2;
+    const uint16_t PACKET_ID5 = 5;
 
     MQTTPubAckInfo_t incomingRecords[ MQTT_STATE_ARRAY_MAX_COUNT ] = { 0 };
     MQTTPubAckInfo_t outgoingRecords[ MQTT_STATE_ARRAY_MAX_COUNT ] = { 0 };
@@ -1075,40 +1095,120 @@ void test_MQTT_PublishToResend( void )
     cursor = MQTT_STATE_CURSOR_INITIALIZER;
     packetId = MQTT_PublishToResend( &mqttContext, &cursor );
     TEST_ASSERT_EQUAL( MQTT_PACKET_ID_INVALID, packetId );
-    TEST_ASSERT_EQUAL( MQTT_STATE_ARRAY_MAX_COUNT, cursor );
+    TEST_ASSERT_EQUAL( MQTT_STATE_CURSOR_INITIALIZER, cursor );
 
     /* No packet exists in state #MQTTPublishSend, #MQTTPubAckPending and
-     * #MQTTPubRecPending states. */
+     * #MQTTPubRecPending states. The cursor holds the packet ID of the record
+     * visited last, which is the newest record throughout this test. */
     cursor = MQTT_STATE_CURSOR_INITIALIZER;
-    addToRecord( mqttContext.outgoingPublishRecords, index, PACKET_ID3, MQTTQoS2, MQTTPubCompPending );
-    addToRecord( mqttContext.outgoingPublishRecords, index2, PACKET_ID4, MQTTQoS2, MQTTPubRelSend );
+    addToRecord( &mqttContext, mqttContext.outgoingPublishRecords, PACKET_ID3, MQTTQoS2, MQTTPubCompPending );
+    addToRecord( &mqttContext, mqttContext.outgoingPublishRecords, PACKET_ID4, MQTTQoS2, MQTTPubRelSend );
     packetId = MQTT_PublishToResend( &mqttContext, &cursor );
     TEST_ASSERT_EQUAL( MQTT_PACKET_ID_INVALID, packetId );
-    TEST_ASSERT_EQUAL( MQTT_STATE_ARRAY_MAX_COUNT, cursor );
+    TEST_ASSERT_EQUAL( PACKET_ID4, cursor );
 
     /* Add a record in #MQTTPublishSend state. */
     cursor = MQTT_STATE_CURSOR_INITIALIZER;
-    addToRecord( mqttContext.outgoingPublishRecords, index3, PACKET_ID, MQTTQoS2, MQTTPublishSend );
+    addToRecord( &mqttContext, mqttContext.outgoingPublishRecords, PACKET_ID, MQTTQoS2, MQTTPublishSend );
     packetId = MQTT_PublishToResend( &mqttContext, &cursor );
     TEST_ASSERT_EQUAL( PACKET_ID, packetId );
-    TEST_ASSERT_EQUAL( index3 + 1, cursor );
+    TEST_ASSERT_EQUAL( PACKET_ID, cursor );
 
     /* Add another record in #MQTTPubAckPending state. */
-    addToRecord( mqttContext.outgoingPublishRecords, index4, PACKET_ID2, MQTTQoS1, MQTTPubAckPending );
+    addToRecord( &mqttContext, mqttContext.outgoingPublishRecords, PACKET_ID2, MQTTQoS1, MQTTPubAckPending );
     packetId = MQTT_PublishToResend( &mqttContext, &cursor );
     TEST_ASSERT_EQUAL( PACKET_ID2, packetId );
-    TEST_ASSERT_EQUAL( index4 + 1, cursor );
+    TEST_ASSERT_EQUAL( PACKET_ID2, cursor );
 
     /* Add another record in #MQTTPubRecPending state. */
-    addToRecord( mqttContext.outgoingPublishRecords, index4 + 1, PACKET_ID2 + 1, MQTTQoS2, MQTTPubRecPending );
+    addToRecord( &mqttContext, mqttContext.outgoingPublishRecords, PACKET_ID5, MQTTQoS2, MQTTPubRecPending );
     packetId = MQTT_PublishToResend( &mqttContext, &cursor );
-    TEST_ASSERT_EQUAL( PACKET_ID2 + 1, packetId );
-    TEST_ASSERT_EQUAL( index4 + 2, cursor );
+    TEST_ASSERT_EQUAL( PACKET_ID5, packetId );
+    TEST_ASSERT_EQUAL( PACKET_ID5, cursor );
 
     /* Further search should find no packets. */
     packetId = MQTT_PublishToResend( &mqttContext, &cursor );
     TEST_ASSERT_EQUAL( MQTT_PACKET_ID_INVALID, packetId );
-    TEST_ASSERT_EQUAL( MQTT_STATE_ARRAY_MAX_COUNT, cursor );
+    TEST_ASSERT_EQUAL( PACKET_ID5, cursor );
+}
+
+/* ========================================================================== */
+
+void test_MQTT_PublishToResend_removeDuringSearch( void )
+{
+    MQTTContext_t mqttContext = { 0 };
+    MQTTStateCursor_t cursor = MQTT_STATE_CURSOR_INITIALIZER;
+    uint16_t packetId;
+    uint16_t i;
+
+    MQTTPubAckInfo_t incomingRecords[ MQTT_STATE_ARRAY_MAX_COUNT ] = { 0 };
+    MQTTPubAckInfo_t outgoingRecords[ MQTT_STATE_ARRAY_MAX_COUNT ] = { 0 };
+    MQTTStatus_t status;
+    TransportInterface_t transport = { 0 };
+
+    transport.recv = transportRecvSuccess;
+    transport.send = transportSendSuccess;
+
+    MQTTFixedBuffer_t networkBuffer = { 0 };
+
+    status = MQTT_Init( &mqttContext, &transport,
+                        getTime, eventCallback, &networkBuffer );
+    TEST_ASSERT_EQUAL( MQTTSuccess, status );
+
+    status = MQTT_InitStatefulQoS( &mqttContext,
+                                   outgoingRecords, MQTT_STATE_ARRAY_MAX_COUNT,
+                                   incomingRecords, MQTT_STATE_ARRAY_MAX_COUNT );
+    TEST_ASSERT_EQUAL( MQTTSuccess, status );
+
+    /* Packet IDs sharing a home index, so that removing one moves the
+     * following records back over the slot the cursor was at.
+     * State of the array - 0 0 0 1 11 21 31 0 0 0. */
+    for( i = 0; i < 4U; i++ )
+    {
+        TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_ReserveState( &mqttContext, 1U + ( 10U * i ), MQTTQoS1 ) );
+    }
+
+    /* Removing the record just returned does not end the search. */
+    for( i = 0; i < 4U; i++ )
+    {
+        packetId = MQTT_PublishToResend( &mqttContext, &cursor );
+        TEST_ASSERT_EQUAL( 1U + ( 10U * i ), packetId );
+        TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_RemoveStateRecord( &mqttContext, packetId ) );
+    }
+
+    TEST_ASSERT_EQUAL( MQTT_PACKET_ID_INVALID, MQTT_PublishToResend( &mqttContext, &cursor ) );
+
+    /* Removing the record after the one just returned skips it. */
+    for( i = 0; i < 4U; i++ )
+    {
+        TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_ReserveState( &mqttContext, 1U + ( 10U * i ), MQTTQoS1 ) );
+    }
+
+    cursor = MQTT_STATE_CURSOR_INITIALIZER;
+    TEST_ASSERT_EQUAL( 1, MQTT_PublishToResend( &mqttContext, &cursor ) );
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_RemoveStateRecord( &mqttContext, 11 ) );
+    TEST_ASSERT_EQUAL( 21, MQTT_PublishToResend( &mqttContext, &cursor ) );
+
+    /* Records added during the search are visited after the others. */
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_ReserveState( &mqttContext, 11, MQTTQoS1 ) );
+    TEST_ASSERT_EQUAL( 31, MQTT_PublishToResend( &mqttContext, &cursor ) );
+    TEST_ASSERT_EQUAL( 11, MQTT_PublishToResend( &mqttContext, &cursor ) );
+    TEST_ASSERT_EQUAL( MQTT_PACKET_ID_INVALID, MQTT_PublishToResend( &mqttContext, &cursor ) );
+
+    /* When both the record just returned and the one after it are removed,
+     * the search starts over rather than skipping records.
+     * Order of the records - 1 21 31 11. */
+    cursor = MQTT_STATE_CURSOR_INITIALIZER;
+    TEST_ASSERT_EQUAL( 1, MQTT_PublishToResend( &mqttContext, &cursor ) );
+    TEST_ASSERT_EQUAL( 21, MQTT_PublishToResend( &mqttContext, &cursor ) );
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_RemoveStateRecord( &mqttContext, 21 ) );
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_RemoveStateRecord( &mqttContext, 31 ) );
+    TEST_ASSERT_EQUAL( 1, MQTT_PublishToResend( &mqttContext, &cursor ) );
+    TEST_ASSERT_EQUAL( 11, MQTT_PublishToResend( &mqttContext, &cursor ) );
+
+    /* Removing the newest record after it was returned ends the search. */
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_RemoveStateRecord( &mqttContext, 11 ) );
+    TEST_ASSERT_EQUAL( MQTT_PACKET_ID_INVALID, MQTT_PublishToResend( &mqttContext, &cursor ) );
 }
 
 /* ========================================================================== */
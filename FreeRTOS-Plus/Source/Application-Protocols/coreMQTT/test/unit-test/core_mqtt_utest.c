@@ -2645,8 +2645,8 @@ void test_MQTT_Publish12( void )
     MQTTStatus_t status;
     MQTTPublishState_t expectedState = { 0 };
 
-    MQTTPubAckInfo_t incomingRecords = { 0 };
-    MQTTPubAckInfo_t outgoingRecords = { 0 };
+    MQTTPubAckInfo_t incomingRecords[ 4 ] = { 0 };
+    MQTTPubAckInfo_t outgoingRecords[ 4 ] = { 0 };
 
     const uint16_t PACKET_ID = 1;
 
@@ -2661,8 +2661,8 @@ void test_MQTT_Publish12( void )
     publishInfo.qos = MQTTQoS1;
 
     MQTT_InitStatefulQoS( &mqttContext,
-                          &outgoingRecords, 4,
-                          &incomingRecords, 4 );
+                          outgoingRecords, 4,
+                          incomingRecords, 4 );
 
     mqttContext.outgoingPublishRecords[ 0 ].packetId = 1;
     mqttContext.outgoingPublishRecords[ 0 ].qos = MQTTQoS2;
@@ -2694,8 +2694,8 @@ void test_MQTT_Publish13( void )
     TransportInterface_t transport = { 0 };
     MQTTFixedBuffer_t networkBuffer = { 0 };
     MQTTStatus_t status;
-    MQTTPubAckInfo_t incomingRecords = { 0 };
-    MQTTPubAckInfo_t outgoingRecords = { 0 };
+    MQTTPubAckInfo_t incomingRecords[ 4 ] = { 0 };
+    MQTTPubAckInfo_t outgoingRecords[ 4 ] = { 0 };
 
     const uint16_t PACKET_ID = 1;
 
@@ -2708,8 +2708,8 @@ void test_MQTT_Publish13( void )
     MQTT_Init( &mqttContext, &transport, getTime, eventCallback, &networkBuffer );
 
     MQTT_InitStatefulQoS( &mqttContext,
-                          &outgoingRecords, 4,
-                          &incomingRecords, 4 );
+                          outgoingRecords, 4,
+                          incomingRecords, 4 );
 
     publishInfo.qos = MQTTQoS1;
 
@@ -3387,8 +3387,8 @@ void test_MQTT_ProcessLoop_handleIncomingPublish_Happy_Path3( void )
     MQTTFixedBuffer_t networkBuffer = { 0 };
     MQTTPublishInfo_t pubInfo = { 0 };
     ProcessLoopReturns_t expectParams = { 0 };
-    MQTTPubAckInfo_t incomingRecords = { 0 };
-    MQTTPubAckInfo_t outgoingRecords = { 0 };
+    MQTTPubAckInfo_t incomingRecords[ 4 ] = { 0 };
+    MQTTPubAckInfo_t outgoingRecords[ 4 ] = { 0 };
 
     setupTransportInterface( &transport );
     setupNetworkBuffer( &networkBuffer );
@@ -3401,8 +3401,8 @@ void test_MQTT_ProcessLoop_handleIncomingPublish_Happy_Path3( void )
     TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
 
     MQTT_InitStatefulQoS( &context,
-                          &outgoingRecords, 4,
-                          &incomingRecords, 4 );
+                          outgoingRecords, 4,
+                          incomingRecords, 4 );
 
     modifyIncomingPacketStatus = MQTTSuccess;
 
@@ -3560,8 +3560,8 @@ void test_MQTT_ProcessLoop_handleIncomingPublish_Error_Paths( void )
     MQTTFixedBuffer_t networkBuffer = { 0 };
     MQTTPublishInfo_t publishInfo = { 0 };
     ProcessLoopReturns_t expectParams = { 0 };
-    MQTTPubAckInfo_t incomingRecords = { 0 };
-    MQTTPubAckInfo_t outgoingRecords = { 0 };
+    MQTTPubAckInfo_t incomingRecords[ 4 ] = { 0 };
+    MQTTPubAckInfo_t outgoingRecords[ 4 ] = { 0 };
 
     setupTransportInterface( &transport );
     setupNetworkBuffer( &networkBuffer );
@@ -3570,8 +3570,8 @@ void test_MQTT_ProcessLoop_handleIncomingPublish_Error_Paths( void )
     TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
 
     MQTT_InitStatefulQoS( &context,
-                          &outgoingRecords, 4,
-                          &incomingRecords, 4 );
+                          outgoingRecords, 4,
+                          incomingRecords, 4 );
 
     modifyIncomingPacketStatus = MQTTSuccess;
 
@@ -4517,8 +4517,8 @@ void test_MQTT_Subscribe_happy_path( void )
     MQTTSubscribeInfo_t subscribeInfo = { 0 };
     size_t remainingLength = MQTT_SAMPLE_REMAINING_LENGTH;
     size_t packetSize = MQTT_SAMPLE_REMAINING_LENGTH;
-    MQTTPubAckInfo_t incomingRecords = { 0 };
-    MQTTPubAckInfo_t outgoingRecords = { 0 };
+    MQTTPubAckInfo_t incomingRecords[ 4 ] = { 0 };
+    MQTTPubAckInfo_t outgoingRecords[ 4 ] = { 0 };
 
     setupTransportInterface( &transport );
     setupNetworkBuffer( &networkBuffer );
@@ -4529,8 +4529,8 @@ void test_MQTT_Subscribe_happy_path( void )
     TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
 
     mqttStatus = MQTT_InitStatefulQoS( &context,
-                                       &outgoingRecords, 4,
-                                       &incomingRecords, 4 );
+                                       outgoingRecords, 4,
+                                       incomingRecords, 4 );
     TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
 
     /* Verify MQTTSuccess is returned with the following mocks. */
@@ -4558,8 +4558,8 @@ void test_MQTT_Subscribe_happy_path1( void )
     MQTTSubscribeInfo_t subscribeInfo[ 2 ];
     size_t remainingLength = MQTT_SAMPLE_REMAINING_LENGTH;
     size_t packetSize = MQTT_SAMPLE_REMAINING_LENGTH;
-    MQTTPubAckInfo_t incomingRecords = { 0 };
-    MQTTPubAckInfo_t outgoingRecords = { 0 };
+    MQTTPubAckInfo_t incomingRecords[ 4 ] = { 0 };
+    MQTTPubAckInfo_t outgoingRecords[ 4 ] = { 0 };
 
     setupTransportInterface( &transport );
     setupNetworkBuffer( &networkBuffer );
@@ -4570,8 +4570,8 @@ void test_MQTT_Subscribe_happy_path1( void )
     TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
 
     mqttStatus = MQTT_InitStatefulQoS( &context,
-                                       &outgoingRecords, 4,
-                                       &incomingRecords, 4 );
+                                       outgoingRecords, 4,
+                                       incomingRecords, 4 );
     TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
 
     /* Verify MQTTSuccess is returned with the following mocks. */
@@ -4599,8 +4599,8 @@ void test_MQTT_Subscribe_happy_path2( void )
     MQTTSubscribeInfo_t subscribeInfo[ 2 ];
     size_t remainingLength = MQTT_SAMPLE_REMAINING_LENGTH;
     size_t packetSize = MQTT_SAMPLE_REMAINING_LENGTH;
-    MQTTPubAckInfo_t incomingRecords = { 0 };
-    MQTTPubAckInfo_t outgoingRecords = { 0 };
+    MQTTPubAckInfo_t incomingRecords[ 4 ] = { 0 };
+    MQTTPubAckInfo_t outgoingRecords[ 4 ] = { 0 };
 
     setupTransportInterface( &transport );
     setupNetworkBuffer( &networkBuffer );
@@ -4612,8 +4612,8 @@ void test_MQTT_Subscribe_happy_path2( void )
     TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
 
     mqttStatus = MQTT_InitStatefulQoS( &context,
-                                       &outgoingRecords, 4,
-                                       &incomingRecords, 4 );
+                                       outgoingRecords, 4,
+                                       incomingRecords, 4 );
     TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
 
     /* Verify MQTTSuccess is returned with the following mocks. */
@@ -4637,8 +4637,8 @@ void test_MQTT_Subscribe_MultipleSubscriptions( void )
     MQTTSubscribeInfo_t subscribeInfo[ 5 ];
     size_t remainingLength = MQTT_SAMPLE_REMAINING_LENGTH;
     size_t packetSize = MQTT_SAMPLE_REMAINING_LENGTH;
-    MQTTPubAckInfo_t incomingRecords = { 0 };
-    MQTTPubAckInfo_t outgoingRecords = { 0 };
+    MQTTPubAckInfo_t incomingRecords[ 4 ] = { 0 };
+    MQTTPubAckInfo_t outgoingRecords[ 4 ] = { 0 };
 
     TEST_ASSERT_EQUAL_MESSAGE( 6U, MQTT_SUB_UNSUB_MAX_VECTORS,
                                "This test is configured to work with MQTT_SUB_UNSUB_MAX_VECTORS defined as 6." );
@@ -4669,8 +4669,8 @@ void test_MQTT_Subscribe_MultipleSubscriptions( void )
     TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
 
     mqttStatus = MQTT_InitStatefulQoS( &context,
-                                       &outgoingRecords, 4,
-                                       &incomingRecords, 4 );
+                                       outgoingRecords, 4,
+                                       incomingRecords, 4 );
     TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
 
     /* Verify MQTTSuccess is returned with the following mocks. */
@@ -4844,8 +4844,8 @@ void test_MQTT_Unsubscribe_happy_path1( void )
     MQTTSubscribeInfo_t subscribeInfo[ 2 ];
     size_t remainingLength = MQTT_SAMPLE_REMAINING_LENGTH;
     size_t packetSize = MQTT_SAMPLE_REMAINING_LENGTH;
-    MQTTPubAckInfo_t incomingRecords = { 0 };
-    MQTTPubAckInfo_t outgoingRecords = { 0 };
+    MQTTPubAckInfo_t incomingRecords[ 4 ] = { 0 };
+    MQTTPubAckInfo_t outgoingRecords[ 4 ] = { 0 };
 
     setupTransportInterface( &transport );
     setupNetworkBuffer( &networkBuffer );
@@ -4856,8 +4856,8 @@ void test_MQTT_Unsubscribe_happy_path1( void )
     TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
 
     mqttStatus = MQTT_InitStatefulQoS( &context,
-                                       &outgoingRecords, 4,
-                                       &incomingRecords, 4 );
+                                       outgoingRecords, 4,
+                                       incomingRecords, 4 );
     TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
 
     /* Verify MQTTSuccess is returned with the following mocks. */
@@ -4885,8 +4885,8 @@ void test_MQTT_unsubscribe_happy_path2( void )
     MQTTSubscribeInfo_t subscribeInfo[ 3 ];
     size_t remainingLength = MQTT_SAMPLE_REMAINING_LENGTH;
     size_t packetSize = MQTT_SAMPLE_REMAINING_LENGTH;
-    MQTTPubAckInfo_t incomingRecords = { 0 };
-    MQTTPubAckInfo_t outgoingRecords = { 0 };
+    MQTTPubAckInfo_t incomingRecords[ 4 ] = { 0 };
+    MQTTPubAckInfo_t outgoingRecords[ 4 ] = { 0 };
 
     setupTransportInterface( &transport );
     setupNetworkBuffer( &networkBuffer );
@@ -4899,8 +4899,8 @@ void test_MQTT_unsubscribe_happy_path2( void )
     TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
 
     mqttStatus = MQTT_InitStatefulQoS( &context,
-                                       &outgoingRecords, 4,
-                                       &incomingRecords, 4 );
+                                       outgoingRecords, 4,
+                                       incomingRecords, 4 );
     TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
 
     /* Verify MQTTSuccess is returned with the following mocks. */
@@ -4924,8 +4924,8 @@ void test_MQTT_Unsubscribe_MultipleSubscriptions( void )
     MQTTSubscribeInfo_t subscribeInfo[ 5 ];
     size_t remainingLength = MQTT_SAMPLE_REMAINING_LENGTH;
     size_t packetSize = MQTT_SAMPLE_REMAINING_LENGTH;
-    MQTTPubAckInfo_t incomingRecords = { 0 };
-    MQTTPubAckInfo_t outgoingRecords = { 0 };
+    MQTTPubAckInfo_t incomingRecords[ 4 ] = { 0 };
+    MQTTPubAckInfo_t outgoingRecords[ 4 ] = { 0 };
 
     TEST_ASSERT_EQUAL_MESSAGE( 6U, MQTT_SUB_UNSUB_MAX_VECTORS,
                                "This test is configured to work with MQTT_SUB_UNSUB_MAX_VECTORS defined as 6." );
@@ -4956,8 +4956,8 @@ void test_MQTT_Unsubscribe_MultipleSubscriptions( void )
     TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
 
     mqttStatus = MQTT_InitStatefulQoS( &context,
-                                       &outgoingRecords, 4,
-                                       &incomingRecords, 4 );
+                                       outgoingRecords, 4,
+                                       incomingRecords, 4 );
     TEST_ASSERT_EQUAL( MQTTSuccess, mqttStatus );
 
     /* Verify MQTTSuccess is returned with the following mocks. */
@@ -5877,3 +5877,29 @@ void test_MQTT_InitStatefulQoS_callback_is_null( void )
     TEST_ASSERT_EQUAL( MQTTBadParameter, mqttStatus );
 }
 /* ========================================================================== */
+
+void test_MQTT_InitStatefulQoS_too_many_records( void )
+{
+    MQTTStatus_t mqttStatus;
+    MQTTPubAckInfo_t pOutgoingPublishRecords[ 10 ] = { 0 };
+    MQTTPubAckInfo_t pIncomingPublishRecords[ 10 ] = { 0 };
+
+    MQTTContext_t mqttContext = { 0 };
+
+    /* Records link to each other with 16-bit values, so the count is only
+     * checked and the arrays are never accessed. */
+    mqttStatus = MQTT_InitStatefulQoS( &mqttContext,
+                                       pOutgoingPublishRecords,
+                                       ( size_t ) UINT16_MAX + 1U,
+                                       pIncomingPublishRecords,
+                                       10 );
+    TEST_ASSERT_EQUAL( MQTTBadParameter, mqttStatus );
+
+    mqttStatus = MQTT_InitStatefulQoS( &mqttContext,
+                                       pOutgoingPublishRecords,
+                                       10,
+                                       pIncomingPublishRecords,
+                                       ( size_t ) UINT16_MAX + 1U );
+    TEST_ASSERT_EQUAL( MQTTBadParameter, mqttStatus );
+}
+/* ========================================================================== */
@@ -0,0 +1,908 @@
+/*
+ * coreMQTT v2.1.1
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_mqtt_v5_utest.c
+ * @brief Unit tests for the MQTT 5 support enabled by MQTT_VERSION_5_ENABLED.
+ *
+ * The tests run the library against a minimal MQTT 5 broker stand-in that is
+ * implemented by the transport functions below.
+ */
+#include <string.h>
+#include "unity.h"
+
+#include "core_mqtt.h"
+#include "core_mqtt_state.h"
+
+/**
+ * @brief Size of the buffers of the broker stand-in and the network buffer.
+ */
+#define BUFFER_SIZE                  ( 512U )
+
+/**
+ * @brief Number of state records for outgoing and incoming publishes.
+ */
+#define STATE_RECORD_COUNT           ( 4U )
+
+/**
+ * @brief Largest topic alias the broker stand-in keeps.
+ */
+#define BROKER_TOPIC_ALIAS_MAXIMUM   ( 4U )
+
+/**
+ * @brief Largest topic name the broker stand-in keeps.
+ */
+#define BROKER_TOPIC_LENGTH_MAXIMUM  ( 32U )
+
+#define TEST_CLIENT_ID               "v5-client"
+#define TEST_CLIENT_ID_LENGTH        ( sizeof( TEST_CLIENT_ID ) - 1U )
+
+/* ============================   BROKER STAND-IN ============================ */
+
+/* Bytes the broker has sent and the client has not read yet. */
+static uint8_t brokerToClient[ BUFFER_SIZE ];
+static size_t brokerToClientLength;
+static size_t brokerToClientIndex;
+
+/* Bytes the client has sent that do not make up a whole packet yet. */
+static uint8_t clientToBroker[ BUFFER_SIZE ];
+static size_t clientToBrokerLength;
+
+/* The CONNACK the broker answers a CONNECT with. */
+static uint8_t connackReply[ 64 ];
+static size_t connackReplyLength;
+
+/* What the broker learned from the client. */
+static uint8_t connectProtocolLevel;
+static uint32_t connectSessionExpiry;
+static uint16_t connectReceiveMaximum;
+static uint32_t connectMaximumPacketSize;
+static char aliasTopics[ BROKER_TOPIC_ALIAS_MAXIMUM + 1U ][ BROKER_TOPIC_LENGTH_MAXIMUM ];
+static size_t aliasTopicLengths[ BROKER_TOPIC_ALIAS_MAXIMUM + 1U ];
+static char publishTopic[ BROKER_TOPIC_LENGTH_MAXIMUM ];
+static size_t publishTopicLength;
+static size_t publishCount;
+static size_t pubrelCount;
+static uint8_t subscribePropertiesLength;
+static uint8_t unsubscribePropertiesLength;
+
+/* ============================   CLIENT STATE ============================== */
+
+static MQTTContext_t context;
+static uint8_t networkBuffer[ BUFFER_SIZE ];
+static MQTTPubAckInfo_t outgoingRecords[ STATE_RECORD_COUNT ];
+static MQTTPubAckInfo_t incomingRecords[ STATE_RECORD_COUNT ];
+static uint32_t globalEntryTime;
+
+/* What the application callback received. */
+static size_t callbackCount;
+static uint8_t callbackPacketType;
+static uint8_t callbackReasonCode;
+static MQTTStatus_t callbackDeserializationResult;
+static MQTTStatus_t callbackStatusCodesResult;
+static uint8_t callbackStatusCodes[ 4 ];
+static size_t callbackStatusCodeCount;
+static char callbackTopic[ BROKER_TOPIC_LENGTH_MAXIMUM ];
+static size_t callbackTopicLength;
+
+/* ========================================================================== */
+
+/**
+ * @brief Queue bytes for the client to receive.
+ */
+static void brokerQueue( const uint8_t * pBytes,
+                         size_t length )
+{
+    TEST_ASSERT_LESS_OR_EQUAL( BUFFER_SIZE - brokerToClientLength, length );
+    ( void ) memcpy( &brokerToClient[ brokerToClientLength ], pBytes, length );
+    brokerToClientLength += length;
+}
+
+/**
+ * @brief Queue a PUBACK, PUBREC or PUBCOMP with a reason code.
+ */
+static void brokerQueueAck( uint8_t packetType,
+                            uint16_t packetId,
+                            uint8_t reasonCode )
+{
+    uint8_t ack[ 5 ];
+
+    ack[ 0 ] = packetType;
+    ack[ 1 ] = 3U;
+    ack[ 2 ] = ( uint8_t ) ( packetId >> 8 );
+    ack[ 3 ] = ( uint8_t ) ( packetId & 0xFFU );
+    ack[ 4 ] = reasonCode;
+    brokerQueue( ack, sizeof( ack ) );
+}
+
+/**
+ * @brief Decode a remaining length that fits in one or two bytes.
+ */
+static size_t decodeLength( const uint8_t * pBytes,
+                            size_t available,
+                            size_t * pLength )
+{
+    size_t size = 0U;
+
+    if( available >= 1U )
+    {
+        if( ( pBytes[ 0 ] & 0x80U ) == 0U )
+        {
+            *pLength = pBytes[ 0 ];
+            size = 1U;
+        }
+        else if( available >= 2U )
+        {
+            *pLength = ( pBytes[ 0 ] & 0x7FU ) + ( ( size_t ) pBytes[ 1 ] << 7 );
+            size = 2U;
+        }
+    }
+
+    return size;
+}
+
+static void brokerHandleConnect( const uint8_t * pData )
+{
+    size_t propertiesLength = pData[ 10 ];
+    const uint8_t * pProperty = &pData[ 11 ];
+    const uint8_t * pEnd = &pProperty[ propertiesLength ];
+
+    connectProtocolLevel = pData[ 6 ];
+
+    while( pProperty < pEnd )
+    {
+        switch( pProperty[ 0 ] )
+        {
+            case 0x11U:
+                connectSessionExpiry = ( ( uint32_t ) pProperty[ 1 ] << 24 ) | ( ( uint32_t ) pProperty[ 2 ] << 16 ) |
+                                       ( ( uint32_t ) pProperty[ 3 ] << 8 ) | pProperty[ 4 ];
+                pProperty += 5;
+                break;
+
+            case 0x21U:
+                connectReceiveMaximum = ( uint16_t ) ( ( pProperty[ 1 ] << 8 ) | pProperty[ 2 ] );
+                pProperty += 3;
+                break;
+
+            case 0x27U:
+                connectMaximumPacketSize = ( ( uint32_t ) pProperty[ 1 ] << 24 ) | ( ( uint32_t ) pProperty[ 2 ] << 16 ) |
+                                           ( ( uint32_t ) pProperty[ 3 ] << 8 ) | pProperty[ 4 ];
+                pProperty += 5;
+                break;
+
+            default:
+                TEST_FAIL_MESSAGE( "Unexpected CONNECT property." );
+                break;
+        }
+    }
+
+    brokerQueue( connackReply, connackReplyLength );
+}
+
+static void brokerHandlePublish( uint8_t firstByte,
+                                 const uint8_t * pData )
+{
+    uint8_t qos = ( firstByte >> 1 ) & 0x03U;
+    size_t topicLength = ( ( size_t ) pData[ 0 ] << 8 ) | pData[ 1 ];
+    size_t index = 2U + topicLength;
+    size_t propertiesEnd;
+    uint16_t topicAlias = 0U;
+
+    TEST_ASSERT_LESS_THAN( BROKER_TOPIC_LENGTH_MAXIMUM, topicLength );
+
+    if( qos > 0U )
+    {
+        index += 2U;
+    }
+
+    propertiesEnd = index + 1U + pData[ index ];
+
+    for( index = index + 1U; index < propertiesEnd; index += 3U )
+    {
+        TEST_ASSERT_EQUAL_HEX8( 0x23U, pData[ index ] );
+        topicAlias = ( uint16_t ) ( ( pData[ index + 1U ] << 8 ) | pData[ index + 2U ] );
+        TEST_ASSERT_LESS_OR_EQUAL( BROKER_TOPIC_ALIAS_MAXIMUM, topicAlias );
+    }
+
+    if( topicLength > 0U )
+    {
+        ( void ) memcpy( publishTopic, &pData[ 2 ], topicLength );
+        publishTopicLength = topicLength;
+
+        if( topicAlias != 0U )
+        {
+            ( void ) memcpy( aliasTopics[ topicAlias ], &pData[ 2 ], topicLength );
+            aliasTopicLengths[ topicAlias ] = topicLength;
+        }
+    }
+    else
+    {
+        /* An empty topic must use an alias the client set up before. */
+        TEST_ASSERT_NOT_EQUAL( 0U, topicAlias );
+        TEST_ASSERT_NOT_EQUAL( 0U, aliasTopicLengths[ topicAlias ] );
+        ( void ) memcpy( publishTopic, aliasTopics[ topicAlias ], aliasTopicLengths[ topicAlias ] );
+        publishTopicLength = aliasTopicLengths[ topicAlias ];
+    }
+
+    publishCount++;
+}
+
+static void brokerHandlePacket( uint8_t firstByte,
+                                const uint8_t * pData,
+                                size_t remainingLength )
+{
+    uint8_t reply[ 12 ];
+
+    ( void ) remainingLength;
+
+    switch( firstByte & 0xF0U )
+    {
+        case MQTT_PACKET_TYPE_CONNECT:
+            brokerHandleConnect( pData );
+            break;
+
+        case MQTT_PACKET_TYPE_PUBLISH:
+            brokerHandlePublish( firstByte, pData );
+            break;
+
+        case ( MQTT_PACKET_TYPE_PUBREL & 0xF0U ):
+            pubrelCount++;
+            break;
+
+        case ( MQTT_PACKET_TYPE_SUBSCRIBE & 0xF0U ):
+            subscribePropertiesLength = pData[ 2 ];
+
+            /* SUBACK with a reason string and one reason code. */
+            reply[ 0 ] = MQTT_PACKET_TYPE_SUBACK;
+            reply[ 1 ] = 9U;
+            reply[ 2 ] = pData[ 0 ];
+            reply[ 3 ] = pData[ 1 ];
+            reply[ 4 ] = 5U;
+            reply[ 5 ] = 0x1FU;
+            reply[ 6 ] = 0U;
+            reply[ 7 ] = 2U;
+            reply[ 8 ] = ( uint8_t ) 'o';
+            reply[ 9 ] = ( uint8_t ) 'k';
+            reply[ 10 ] = 0x01U;
+            brokerQueue( reply, 11U );
+            break;
+
+        case ( MQTT_PACKET_TYPE_UNSUBSCRIBE & 0xF0U ):
+            unsubscribePropertiesLength = pData[ 2 ];
+
+            /* UNSUBACK reporting that no subscription existed. */
+            reply[ 0 ] = MQTT_PACKET_TYPE_UNSUBACK;
+            reply[ 1 ] = 4U;
+            reply[ 2 ] = pData[ 0 ];
+            reply[ 3 ] = pData[ 1 ];
+            reply[ 4 ] = 0U;
+            reply[ 5 ] = 0x11U;
+            brokerQueue( reply, 6U );
+            break;
+
+        default:
+            break;
+    }
+}
+
+static int32_t brokerSend( NetworkContext_t * pNetworkContext,
+                           const void * pBuffer,
+                           size_t bytesToSend )
+{
+    size_t remainingLength = 0U, lengthSize, packetSize;
+
+    ( void ) pNetworkContext;
+
+    TEST_ASSERT_LESS_OR_EQUAL( BUFFER_SIZE - clientToBrokerLength, bytesToSend );
+    ( void ) memcpy( &clientToBroker[ clientToBrokerLength ], pBuffer, bytesToSend );
+    clientToBrokerLength += bytesToSend;
+
+    /* Handle every whole packet received so far. */
+    lengthSize = decodeLength( &clientToBroker[ 1 ], clientToBrokerLength - 1U, &remainingLength );
+
+    while( ( lengthSize > 0U ) &&
+           ( clientToBrokerLength >= ( 1U + lengthSize + remainingLength ) ) )
+    {
+        packetSize = 1U + lengthSize + remainingLength;
+        brokerHandlePacket( clientToBroker[ 0 ], &clientToBroker[ 1U + lengthSize ], remainingLength );
+
+        clientToBrokerLength -= packetSize;
+        ( void ) memmove( clientToBroker, &clientToBroker[ packetSize ], clientToBrokerLength );
+
+        lengthSize = ( clientToBrokerLength > 1U ) ?
+                     decodeLength( &clientToBroker[ 1 ], clientToBrokerLength - 1U, &remainingLength ) : 0U;
+    }
+
+    return ( int32_t ) bytesToSend;
+}
+
+static int32_t brokerRecv( NetworkContext_t * pNetworkContext,
+                           void * pBuffer,
+                           size_t bytesToRecv )
+{
+    size_t available = brokerToClientLength - brokerToClientIndex;
+    size_t bytesRead = ( bytesToRecv < available ) ? bytesToRecv : available;
+
+    ( void ) pNetworkContext;
+
+    ( void ) memcpy( pBuffer, &brokerToClient[ brokerToClientIndex ], bytesRead );
+    brokerToClientIndex += bytesRead;
+
+    return ( int32_t ) bytesRead;
+}
+
+static uint32_t getTime( void )
+{
+    return globalEntryTime++;
+}
+
+static void eventCallback( MQTTContext_t * pContext,
+                           MQTTPacketInfo_t * pPacketInfo,
+                           MQTTDeserializedInfo_t * pDeserializedInfo )
+{
+    uint8_t * pCodes = NULL;
+
+    ( void ) pContext;
+
+    callbackCount++;
+    callbackPacketType = pPacketInfo->type;
+    callbackReasonCode = pDeserializedInfo->reasonCode;
+    callbackDeserializationResult = pDeserializedInfo->deserializationResult;
+
+    if( ( pPacketInfo->type == MQTT_PACKET_TYPE_SUBACK ) ||
+        ( pPacketInfo->type == MQTT_PACKET_TYPE_UNSUBACK ) )
+    {
+        callbackStatusCodesResult = MQTT_GetSubAckStatusCodes( pPacketInfo, &pCodes, &callbackStatusCodeCount );
+
+        if( callbackStatusCodesResult == MQTTSuccess )
+        {
+            TEST_ASSERT_LESS_OR_EQUAL( sizeof( callbackStatusCodes ), callbackStatusCodeCount );
+            ( void ) memcpy( callbackStatusCodes, pCodes, callbackStatusCodeCount );
+        }
+    }
+    else if( ( pPacketInfo->type & 0xF0U ) == MQTT_PACKET_TYPE_PUBLISH )
+    {
+        callbackTopicLength = pDeserializedInfo->pPublishInfo->topicNameLength;
+        ( void ) memcpy( callbackTopic, pDeserializedInfo->pPublishInfo->pTopicName, callbackTopicLength );
+    }
+    else
+    {
+        /* Nothing else to record. */
+    }
+}
+
+/**
+ * @brief Set the CONNACK the broker answers with: reason code 0, receive
+ * maximum 2, topic alias maximum 4, maximum QoS 1, no retained messages,
+ * server keep alive 30 and maximum packet size 128.
+ */
+static void setDefaultConnack( void )
+{
+    static const uint8_t defaultConnack[] =
+    {
+        MQTT_PACKET_TYPE_CONNACK, 21U,
+        0x00U,                            /* Acknowledge flags. */
+        0x00U,                            /* Reason code. */
+        18U,                              /* Property length. */
+        0x21U, 0x00U, 0x02U,              /* Receive Maximum. */
+        0x22U, 0x00U, 0x04U,              /* Topic Alias Maximum. */
+        0x24U, 0x01U,                     /* Maximum QoS. */
+        0x25U, 0x00U,                     /* Retain Available. */
+        0x13U, 0x00U, 0x1EU,              /* Server Keep Alive. */
+        0x27U, 0x00U, 0x00U, 0x00U, 0x80U /* Maximum Packet Size. */
+    };
+
+    ( void ) memcpy( connackReply, defaultConnack, sizeof( defaultConnack ) );
+    connackReplyLength = sizeof( defaultConnack );
+}
+
+static MQTTStatus_t connectToBroker( void )
+{
+    MQTTConnectInfo_t connectInfo = { 0 };
+    bool sessionPresent = false;
+
+    connectInfo.cleanSession = true;
+    connectInfo.keepAliveSeconds = 60U;
+    connectInfo.pClientIdentifier = TEST_CLIENT_ID;
+    connectInfo.clientIdentifierLength = TEST_CLIENT_ID_LENGTH;
+    connectInfo.sessionExpiryInterval = 600U;
+    connectInfo.receiveMaximum = 10U;
+    connectInfo.maximumPacketSize = 1024U;
+
+    return MQTT_Connect( &context, &connectInfo, NULL, 0U, &sessionPresent );
+}
+
+static MQTTStatus_t publishMessage( const char * pTopic,
+                                    uint16_t topicAlias,
+                                    MQTTQoS_t qos,
+                                    uint16_t packetId )
+{
+    MQTTPublishInfo_t publishInfo = { 0 };
+
+    publishInfo.qos = qos;
+    publishInfo.pTopicName = pTopic;
+    publishInfo.topicNameLength = ( uint16_t ) strlen( pTopic );
+    publishInfo.topicAlias = topicAlias;
+    publishInfo.pPayload = "payload";
+    publishInfo.payloadLength = 7U;
+
+    return MQTT_Publish( &context, &publishInfo, packetId );
+}
+
+/* ============================   UNITY FIXTURES ============================ */
+
+/* Called before each test method. */
+void setUp( void )
+{
+    TransportInterface_t transport = { 0 };
+    MQTTFixedBuffer_t fixedBuffer;
+
+    brokerToClientLength = 0U;
+    brokerToClientIndex = 0U;
+    clientToBrokerLength = 0U;
+    connectProtocolLevel = 0U;
+    connectSessionExpiry = 0U;
+    connectReceiveMaximum = 0U;
+    connectMaximumPacketSize = 0U;
+    ( void ) memset( aliasTopicLengths, 0, sizeof( aliasTopicLengths ) );
+    publishTopicLength = 0U;
+    publishCount = 0U;
+    pubrelCount = 0U;
+    subscribePropertiesLength = 0xFFU;
+    unsubscribePropertiesLength = 0xFFU;
+    callbackCount = 0U;
+    callbackPacketType = 0U;
+    callbackReasonCode = 0U;
+    callbackDeserializationResult = MQTTSuccess;
+    callbackStatusCodesResult = MQTTBadParameter;
+    callbackStatusCodeCount = 0U;
+    callbackTopicLength = 0U;
+    globalEntryTime = 0U;
+    setDefaultConnack();
+
+    transport.send = brokerSend;
+    transport.recv = brokerRecv;
+    fixedBuffer.pBuffer = networkBuffer;
+    fixedBuffer.size = sizeof( networkBuffer );
+
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_Init( &context, &transport, getTime, eventCallback, &fixedBuffer ) );
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_InitStatefulQoS( &context,
+                                                          outgoingRecords, STATE_RECORD_COUNT,
+                                                          incomingRecords, STATE_RECORD_COUNT ) );
+}
+
+/* Called after each test method. */
+void tearDown( void )
+{
+}
+
+/* Called at the beginning of the whole suite. */
+void suiteSetUp()
+{
+}
+
+/* Called at the end of the whole suite. */
+int suiteTearDown( int numFailures )
+{
+    return numFailures;
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief The CONNECT carries protocol level 5 and the client limits, and the
+ * server limits from the CONNACK are kept in the context.
+ */
+void test_MQTT_Connect_ExchangesProperties( void )
+{
+    TEST_ASSERT_EQUAL( MQTTSuccess, connectToBroker() );
+
+    TEST_ASSERT_EQUAL_UINT8( 5U, connectProtocolLevel );
+    TEST_ASSERT_EQUAL_UINT32( 600U, connectSessionExpiry );
+    TEST_ASSERT_EQUAL_UINT16( 10U, connectReceiveMaximum );
+    TEST_ASSERT_EQUAL_UINT32( 1024U, connectMaximumPacketSize );
+
+    TEST_ASSERT_EQUAL( MQTTConnected, context.connectStatus );
+    TEST_ASSERT_EQUAL_UINT16( 2U, context.connackProperties.receiveMaximum );
+    TEST_ASSERT_EQUAL_UINT16( 4U, context.connackProperties.topicAliasMaximum );
+    TEST_ASSERT_EQUAL( MQTTQoS1, context.connackProperties.maximumQoS );
+    TEST_ASSERT_FALSE( context.connackProperties.retainAvailable );
+    TEST_ASSERT_EQUAL_UINT32( 128U, context.connackProperties.maximumPacketSize );
+    /* The CONNACK does not override the session expiry interval. */
+    TEST_ASSERT_EQUAL_UINT32( 600U, context.connackProperties.sessionExpiryInterval );
+    /* The server keep alive replaces the one the client asked for. */
+    TEST_ASSERT_EQUAL_UINT16( 30U, context.keepAliveIntervalSec );
+    TEST_ASSERT_EQUAL_UINT16( 2U, context.sendQuota );
+}
+
+/**
+ * @brief A CONNACK with a failure reason code refuses the connection.
+ */
+void test_MQTT_Connect_RefusedWithReasonCode( void )
+{
+    /* 0x87 is Not authorized. */
+    static const uint8_t refusal[] = { MQTT_PACKET_TYPE_CONNACK, 3U, 0x00U, 0x87U, 0x00U };
+
+    ( void ) memcpy( connackReply, refusal, sizeof( refusal ) );
+    connackReplyLength = sizeof( refusal );
+
+    TEST_ASSERT_EQUAL( MQTTServerRefused, connectToBroker() );
+    TEST_ASSERT_EQUAL_HEX8( 0x87U, context.connackProperties.reasonCode );
+    TEST_ASSERT_EQUAL( MQTTNotConnected, context.connectStatus );
+}
+
+/**
+ * @brief QoS 1 publishes stop at the receive maximum of the server until a
+ * PUBACK returns a unit of the send quota.
+ */
+void test_MQTT_Publish_ReceiveMaximum( void )
+{
+    TEST_ASSERT_EQUAL( MQTTSuccess, connectToBroker() );
+
+    TEST_ASSERT_EQUAL( MQTTSuccess, publishMessage( "a/b", 0U, MQTTQoS1, 1U ) );
+    TEST_ASSERT_EQUAL( MQTTSuccess, publishMessage( "a/b", 0U, MQTTQoS1, 2U ) );
+    TEST_ASSERT_EQUAL( MQTTReceiveMaximumExceeded, publishMessage( "a/b", 0U, MQTTQoS1, 3U ) );
+    /* QoS 0 publishes do not count against the receive maximum. */
+    TEST_ASSERT_EQUAL( MQTTSuccess, publishMessage( "a/b", 0U, MQTTQoS0, 0U ) );
+    TEST_ASSERT_EQUAL_size_t( 3U, publishCount );
+
+    /* 0x10 is No matching subscribers, which still completes the publish. */
+    brokerQueueAck( MQTT_PACKET_TYPE_PUBACK, 1U, 0x10U );
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_ProcessLoop( &context ) );
+    TEST_ASSERT_EQUAL_size_t( 1U, callbackCount );
+    TEST_ASSERT_EQUAL_HEX8( MQTT_PACKET_TYPE_PUBACK, callbackPacketType );
+    TEST_ASSERT_EQUAL_HEX8( 0x10U, callbackReasonCode );
+    TEST_ASSERT_EQUAL_UINT16( 1U, context.sendQuota );
+
+    TEST_ASSERT_EQUAL( MQTTSuccess, publishMessage( "a/b", 0U, MQTTQoS1, 3U ) );
+    TEST_ASSERT_EQUAL_UINT16( 0U, context.sendQuota );
+}
+
+/**
+ * @brief Publishes that the server announced it does not accept are rejected
+ * before they are sent.
+ */
+void test_MQTT_Publish_ServerLimits( void )
+{
+    MQTTPublishInfo_t publishInfo = { 0 };
+    uint8_t payload[ 128 ] = { 0 };
+
+    TEST_ASSERT_EQUAL( MQTTSuccess, connectToBroker() );
+
+    /* Maximum QoS is 1. */
+    TEST_ASSERT_EQUAL( MQTTBadParameter, publishMessage( "a/b", 0U, MQTTQoS2, 1U ) );
+
+    /* Topic alias maximum is 4. */
+    TEST_ASSERT_EQUAL( MQTTBadParameter, publishMessage( "a/b", 5U, MQTTQoS0, 0U ) );
+
+    /* Retained messages are not available. */
+    publishInfo.qos = MQTTQoS0;
+    publishInfo.retain = true;
+    publishInfo.pTopicName = "a/b";
+    publishInfo.topicNameLength = 3U;
+    TEST_ASSERT_EQUAL( MQTTBadParameter, MQTT_Publish( &context, &publishInfo, 0U ) );
+
+    /* Maximum packet size is 128. */
+    publishInfo.retain = false;
+    publishInfo.pPayload = payload;
+    publishInfo.payloadLength = sizeof( payload );
+    TEST_ASSERT_EQUAL( MQTTBadParameter, MQTT_Publish( &context, &publishInfo, 0U ) );
+
+    /* An empty topic needs a topic alias. */
+    TEST_ASSERT_EQUAL( MQTTBadParameter, publishMessage( "", 0U, MQTTQoS0, 0U ) );
+
+    TEST_ASSERT_EQUAL_size_t( 0U, publishCount );
+    TEST_ASSERT_EQUAL_UINT16( 2U, context.sendQuota );
+}
+
+/**
+ * @brief A topic alias set up by one publish replaces the topic of the next.
+ */
+void test_MQTT_Publish_TopicAlias( void )
+{
+    TEST_ASSERT_EQUAL( MQTTSuccess, connectToBroker() );
+
+    TEST_ASSERT_EQUAL( MQTTSuccess, publishMessage( "sensors/temperature", 1U, MQTTQoS0, 0U ) );
+    TEST_ASSERT_EQUAL( MQTTSuccess, publishMessage( "", 1U, MQTTQoS1, 1U ) );
+
+    TEST_ASSERT_EQUAL_size_t( 2U, publishCount );
+    TEST_ASSERT_EQUAL_size_t( strlen( "sensors/temperature" ), publishTopicLength );
+    TEST_ASSERT_EQUAL_MEMORY( "sensors/temperature", publishTopic, publishTopicLength );
+}
+
+/**
+ * @brief A PUBREC with a failure reason code ends a QoS 2 publish without a
+ * PUBREL.
+ */
+void test_MQTT_Publish_PubrecFailureEndsFlow( void )
+{
+    /* Drop the Maximum QoS property from the default CONNACK so that QoS 2
+     * is allowed. */
+    ( void ) memmove( &connackReply[ 11 ], &connackReply[ 13 ], connackReplyLength - 13U );
+    connackReplyLength -= 2U;
+    connackReply[ 1 ] -= 2U;
+    connackReply[ 4 ] -= 2U;
+
+    TEST_ASSERT_EQUAL( MQTTSuccess, connectToBroker() );
+    TEST_ASSERT_EQUAL( MQTTQoS2, context.connackProperties.maximumQoS );
+
+    TEST_ASSERT_EQUAL( MQTTSuccess, publishMessage( "a/b", 0U, MQTTQoS2, 7U ) );
+    TEST_ASSERT_EQUAL_UINT16( 1U, context.sendQuota );
+
+    /* 0x97 is Quota exceeded. */
+    brokerQueueAck( MQTT_PACKET_TYPE_PUBREC, 7U, 0x97U );
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_ProcessLoop( &context ) );
+    TEST_ASSERT_EQUAL_HEX8( MQTT_PACKET_TYPE_PUBREC, callbackPacketType );
+    TEST_ASSERT_EQUAL_HEX8( 0x97U, callbackReasonCode );
+    TEST_ASSERT_EQUAL_size_t( 0U, pubrelCount );
+    TEST_ASSERT_EQUAL_UINT16( 2U, context.sendQuota );
+
+    /* The state record is gone, so the packet ID can be used again. */
+    TEST_ASSERT_EQUAL( MQTTSuccess, publishMessage( "a/b", 0U, MQTTQoS2, 7U ) );
+
+    /* A successful PUBREC is still answered with a PUBREL. */
+    brokerQueueAck( MQTT_PACKET_TYPE_PUBREC, 7U, 0x00U );
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_ProcessLoop( &context ) );
+    TEST_ASSERT_EQUAL_size_t( 1U, pubrelCount );
+    TEST_ASSERT_EQUAL_UINT16( 1U, context.sendQuota );
+
+    brokerQueueAck( MQTT_PACKET_TYPE_PUBCOMP, 7U, 0x00U );
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_ProcessLoop( &context ) );
+    TEST_ASSERT_EQUAL_UINT16( 2U, context.sendQuota );
+}
+
+/**
+ * @brief SUBSCRIBE and UNSUBSCRIBE carry an empty property length, and the
+ * reason codes of their acknowledgments follow the properties.
+ */
+void test_MQTT_Subscribe_Unsubscribe( void )
+{
+    MQTTSubscribeInfo_t subscription = { 0 };
+
+    subscription.qos = MQTTQoS1;
+    subscription.pTopicFilter = "a/#";
+    subscription.topicFilterLength = 3U;
+
+    TEST_ASSERT_EQUAL( MQTTSuccess, connectToBroker() );
+
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_Subscribe( &context, &subscription, 1U, 1U ) );
+    TEST_ASSERT_EQUAL_UINT8( 0U, subscribePropertiesLength );
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_ProcessLoop( &context ) );
+    TEST_ASSERT_EQUAL_HEX8( MQTT_PACKET_TYPE_SUBACK, callbackPacketType );
+    TEST_ASSERT_EQUAL( MQTTSuccess, callbackDeserializationResult );
+    TEST_ASSERT_EQUAL( MQTTSuccess, callbackStatusCodesResult );
+    TEST_ASSERT_EQUAL_size_t( 1U, callbackStatusCodeCount );
+    TEST_ASSERT_EQUAL_HEX8( 0x01U, callbackStatusCodes[ 0 ] );
+
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_Unsubscribe( &context, &subscription, 1U, 2U ) );
+    TEST_ASSERT_EQUAL_UINT8( 0U, unsubscribePropertiesLength );
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_ProcessLoop( &context ) );
+    TEST_ASSERT_EQUAL_HEX8( MQTT_PACKET_TYPE_UNSUBACK, callbackPacketType );
+    TEST_ASSERT_EQUAL( MQTTSuccess, callbackStatusCodesResult );
+    TEST_ASSERT_EQUAL_size_t( 1U, callbackStatusCodeCount );
+    TEST_ASSERT_EQUAL_HEX8( 0x11U, callbackStatusCodes[ 0 ] );
+}
+
+/**
+ * @brief An incoming PUBLISH with properties reaches the application, and one
+ * that uses a topic alias is a protocol error.
+ */
+void test_MQTT_ProcessLoop_IncomingPublish( void )
+{
+    static const uint8_t publishWithProperties[] =
+    {
+        MQTT_PACKET_TYPE_PUBLISH, 20U,
+        0x00U, 0x03U, ( uint8_t ) 'x', ( uint8_t ) '/', ( uint8_t ) 'y',
+        12U,                                                   /* Property length. */
+        0x02U, 0x00U, 0x00U, 0x00U, 0x3CU,                     /* Message Expiry Interval. */
+        0x26U, 0x00U, 0x01U, ( uint8_t ) 'k', 0x00U, 0x01U, ( uint8_t ) 'v', /* User Property. */
+        ( uint8_t ) 'h', ( uint8_t ) 'i'
+    };
+    static const uint8_t publishWithAlias[] =
+    {
+        MQTT_PACKET_TYPE_PUBLISH, 6U,
+        0x00U, 0x00U,
+        3U, 0x23U, 0x00U, 0x01U
+    };
+
+    TEST_ASSERT_EQUAL( MQTTSuccess, connectToBroker() );
+
+    brokerQueue( publishWithProperties, sizeof( publishWithProperties ) );
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_ProcessLoop( &context ) );
+    TEST_ASSERT_EQUAL_size_t( 1U, callbackCount );
+    TEST_ASSERT_EQUAL_size_t( 3U, callbackTopicLength );
+    TEST_ASSERT_EQUAL_MEMORY( "x/y", callbackTopic, 3U );
+
+    brokerQueue( publishWithAlias, sizeof( publishWithAlias ) );
+    TEST_ASSERT_EQUAL( MQTTBadResponse, MQTT_ProcessLoop( &context ) );
+    TEST_ASSERT_EQUAL_size_t( 1U, callbackCount );
+}
+
+/**
+ * @brief A DISCONNECT from the server is passed to the application and ends
+ * the connection.
+ */
+void test_MQTT_ProcessLoop_ServerDisconnect( void )
+{
+    /* 0x8E is Session taken over, followed by a reason string. */
+    static const uint8_t disconnect[] =
+    {
+        MQTT_PACKET_TYPE_DISCONNECT, 6U,
+        0x8EU,
+        4U, 0x1FU, 0x00U, 0x01U, ( uint8_t ) '!'
+    };
+
+    TEST_ASSERT_EQUAL( MQTTSuccess, connectToBroker() );
+
+    brokerQueue( disconnect, sizeof( disconnect ) );
+    TEST_ASSERT_EQUAL( MQTTServerRefused, MQTT_ProcessLoop( &context ) );
+    TEST_ASSERT_EQUAL_HEX8( MQTT_PACKET_TYPE_DISCONNECT, callbackPacketType );
+    TEST_ASSERT_EQUAL_HEX8( 0x8EU, callbackReasonCode );
+    TEST_ASSERT_EQUAL( MQTTNotConnected, context.connectStatus );
+}
+
+/* ============================   SERIALIZER  ============================== */
+
+/**
+ * @brief The CONNECT size accounts for the properties and the will properties.
+ */
+void test_MQTT_SerializeConnect_Properties( void )
+{
+    MQTTConnectInfo_t connectInfo = { 0 };
+    MQTTPublishInfo_t willInfo = { 0 };
+    MQTTFixedBuffer_t fixedBuffer;
+    size_t remainingLength = 0U, packetSize = 0U;
+    uint8_t buffer[ 64 ];
+    static const uint8_t expected[] =
+    {
+        MQTT_PACKET_TYPE_CONNECT, 33U,
+        0x00U, 0x04U, ( uint8_t ) 'M', ( uint8_t ) 'Q', ( uint8_t ) 'T', ( uint8_t ) 'T',
+        0x05U,                                  /* Protocol level. */
+        0x06U,                                  /* Clean session and will flags. */
+        0x00U, 0x3CU,                           /* Keep alive. */
+        13U,                                    /* Property length. */
+        0x11U, 0x00U, 0x00U, 0x02U, 0x58U,      /* Session Expiry Interval. */
+        0x21U, 0x00U, 0x0AU,                    /* Receive Maximum. */
+        0x27U, 0x00U, 0x00U, 0x04U, 0x00U,      /* Maximum Packet Size. */
+        0x00U, 0x01U, ( uint8_t ) 'c',          /* Client identifier. */
+        0x00U,                                  /* Will property length. */
+        0x00U, 0x01U, ( uint8_t ) 'w',          /* Will topic. */
+        0x00U, 0x00U                            /* Will payload. */
+    };
+
+    connectInfo.cleanSession = true;
+    connectInfo.keepAliveSeconds = 60U;
+    connectInfo.pClientIdentifier = "c";
+    connectInfo.clientIdentifierLength = 1U;
+    connectInfo.sessionExpiryInterval = 600U;
+    connectInfo.receiveMaximum = 10U;
+    connectInfo.maximumPacketSize = 1024U;
+    willInfo.pTopicName = "w";
+    willInfo.topicNameLength = 1U;
+
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_GetConnectPacketSize( &connectInfo, &willInfo,
+                                                               &remainingLength, &packetSize ) );
+    TEST_ASSERT_EQUAL_size_t( sizeof( expected ), packetSize );
+
+    fixedBuffer.pBuffer = buffer;
+    fixedBuffer.size = sizeof( buffer );
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_SerializeConnect( &connectInfo, &willInfo,
+                                                           remainingLength, &fixedBuffer ) );
+    TEST_ASSERT_EQUAL_HEX8_ARRAY( expected, buffer, sizeof( expected ) );
+}
+
+/**
+ * @brief A publish acknowledgment may leave out its reason code and
+ * properties, but the properties must be well formed.
+ */
+void test_MQTT_DeserializeAck_PublishAckForms( void )
+{
+    MQTTPacketInfo_t packetInfo = { 0 };
+    uint16_t packetId = 0U;
+    uint8_t reasonCode = 0xFFU;
+    uint8_t buffer[ 8 ] = { 0x00U, 0x05U, 0x10U, 0x03U, 0x1FU, 0x00U, 0x00U, 0x00U };
+
+    packetInfo.type = MQTT_PACKET_TYPE_PUBACK;
+    packetInfo.pRemainingData = buffer;
+
+    /* Packet identifier only: the reason code is Success. */
+    packetInfo.remainingLength = 2U;
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_DeserializeAck( &packetInfo, &packetId, NULL ) );
+    TEST_ASSERT_EQUAL_UINT16( 5U, packetId );
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_GetReasonCode( &packetInfo, &reasonCode ) );
+    TEST_ASSERT_EQUAL_HEX8( 0x00U, reasonCode );
+
+    /* Reason code without properties. */
+    packetInfo.remainingLength = 3U;
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_DeserializeAck( &packetInfo, &packetId, NULL ) );
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_GetReasonCode( &packetInfo, &reasonCode ) );
+    TEST_ASSERT_EQUAL_HEX8( 0x10U, reasonCode );
+
+    /* Reason code and an empty reason string. */
+    packetInfo.remainingLength = 7U;
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_DeserializeAck( &packetInfo, &packetId, NULL ) );
+
+    /* Property length longer than the packet. */
+    packetInfo.remainingLength = 6U;
+    TEST_ASSERT_EQUAL( MQTTBadResponse, MQTT_DeserializeAck( &packetInfo, &packetId, NULL ) );
+
+    /* Bytes after the properties. */
+    packetInfo.remainingLength = 8U;
+    TEST_ASSERT_EQUAL( MQTTBadResponse, MQTT_DeserializeAck( &packetInfo, &packetId, NULL ) );
+
+    /* Unknown property identifier. */
+    buffer[ 3 ] = 1U;
+    buffer[ 4 ] = 0x7FU;
+    packetInfo.remainingLength = 5U;
+    TEST_ASSERT_EQUAL( MQTTBadResponse, MQTT_DeserializeAck( &packetInfo, &packetId, NULL ) );
+
+    /* SUBACK and UNSUBACK have no single reason code. */
+    packetInfo.type = MQTT_PACKET_TYPE_SUBACK;
+    TEST_ASSERT_EQUAL( MQTTBadParameter, MQTT_GetReasonCode( &packetInfo, &reasonCode ) );
+    TEST_ASSERT_EQUAL( MQTTBadParameter, MQTT_GetReasonCode( NULL, &reasonCode ) );
+}
+
+/**
+ * @brief Properties left out of a CONNACK take their default values, and
+ * invalid values are rejected.
+ */
+void test_MQTT_DeserializeConnack_Defaults( void )
+{
+    MQTTPacketInfo_t packetInfo = { 0 };
+    MQTTConnackProperties_t properties;
+    bool sessionPresent = false;
+    uint8_t buffer[ 6 ] = { 0x01U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U };
+
+    ( void ) memset( &properties, 0xA5, sizeof( properties ) );
+    properties.sessionExpiryInterval = 30U;
+
+    packetInfo.type = MQTT_PACKET_TYPE_CONNACK;
+    packetInfo.pRemainingData = buffer;
+    packetInfo.remainingLength = 3U;
+
+    TEST_ASSERT_EQUAL( MQTTSuccess, MQTT_DeserializeConnack( &packetInfo, &sessionPresent, &properties ) );
+    TEST_ASSERT_TRUE( sessionPresent );
+    TEST_ASSERT_EQUAL_HEX8( 0x00U, properties.reasonCode );
+    TEST_ASSERT_EQUAL_UINT32( 30U, properties.sessionExpiryInterval );
+    TEST_ASSERT_EQUAL_UINT16( UINT16_MAX, properties.receiveMaximum );
+    TEST_ASSERT_EQUAL_UINT16( 0U, properties.topicAliasMaximum );
+    TEST_ASSERT_EQUAL_UINT32( 0U, properties.maximumPacketSize );
+    TEST_ASSERT_EQUAL( MQTTQoS2, properties.maximumQoS );
+    TEST_ASSERT_TRUE( properties.retainAvailable );
+    TEST_ASSERT_EQUAL_UINT16( 0U, properties.serverKeepAlive );
+
+    /* A receive maximum of 0 is a protocol error. */
+    buffer[ 2 ] = 3U;
+    buffer[ 3 ] = 0x21U;
+    packetInfo.remainingLength = 6U;
+    TEST_ASSERT_EQUAL( MQTTBadResponse, MQTT_DeserializeConnack( &packetInfo, &sessionPresent, &properties ) );
+
+    /* The v3.1.1 CONNACK form is too short. */
+    packetInfo.remainingLength = 2U;
+    TEST_ASSERT_EQUAL( MQTTBadResponse, MQTT_DeserializeConnack( &packetInfo, &sessionPresent, &properties ) );
+
+    packetInfo.type = MQTT_PACKET_TYPE_PUBACK;
+    TEST_ASSERT_EQUAL( MQTTBadParameter, MQTT_DeserializeConnack( &packetInfo, &sessionPresent, &properties ) );
+    TEST_ASSERT_EQUAL( MQTTBadParameter, MQTT_DeserializeConnack( &packetInfo, NULL, &properties ) );
+}
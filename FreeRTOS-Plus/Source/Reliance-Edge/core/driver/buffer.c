@@ -29,8 +29,15 @@
     sized buffers which are used to store data from a given block (identified
     by both block number and volume number: this cache is shared among all
     volumes).  Block buffers may be either dirty or clean.  Most I/O passes
-    through this module.  When a buffer is needed for a block which is not in
-    the cache, a "victim" is selected via a simple LRU scheme.
+    through this module.  Buffered blocks are found through a hash table keyed
+    by volume and block number.  When a buffer is needed for a block which is
+    not in the cache, an invalid buffer is used if there is one; otherwise a
+    "victim" is selected via the CLOCK (second chance) algorithm.
+
+    Dirty buffers are written in order of block number, and runs of contiguous
+    dirty blocks are written with a single multi-block request, since block
+    devices such as flash and SD cards are much faster at a few large writes
+    than at many small ones.
 */
 #include <redfs.h>
 #include <redcore.h>
@@ -87,6 +94,19 @@
 #endif
 
 
+/*  The number of blocks in the staging buffer, through which runs of
+    contiguous blocks whose buffers are not adjacent in memory are written back
+    (at most REDCONF_WRITEBACK_BLOCKS at a time) and read ahead (at most
+    REDCONF_READAHEAD_BLOCKS at a time).  There is no staging buffer if this is
+    one or less.
+*/
+#if (REDCONF_READ_ONLY == 0) && (REDCONF_WRITEBACK_BLOCKS > REDCONF_READAHEAD_BLOCKS)
+  #define STAGING_BLOCKS REDCONF_WRITEBACK_BLOCKS
+#else
+  #define STAGING_BLOCKS REDCONF_READAHEAD_BLOCKS
+#endif
+
+
 /*  A note on the typecasts in the below macros: Operands to bitwise operators
     are subject to the "usual arithmetic conversions".  This means that the
     flags, which have uint16_t values, are promoted to int.  MISRA-C:2012 R10.1
@@ -104,6 +124,19 @@
 #define BBLK_INVALID UINT32_MAX
 
 
+/*  An invalid buffer index.  Used to terminate the hash chains and the free
+    list.
+*/
+#define BIDX_INVALID ((uint16_t)REDCONF_BUFFER_COUNT)
+
+
+/*  Number of hash buckets.  With one bucket per buffer, the hash chains are
+    one buffer long on average, and sequential block numbers -- the common case
+    -- never collide.
+*/
+#define BUFFER_HASH_SIZE REDCONF_BUFFER_COUNT
+
+
 /** @brief Metadata stored for each block buffer.
 
     To make better use of CPU caching when searching the BUFFERHEAD array, this
@@ -115,6 +148,8 @@ typedef struct
     uint8_t     bVolNum;    /**< Volume the block resides on. */
     uint8_t     bRefCount;  /**< Number of references. */
     uint16_t    uFlags;     /**< Buffer flags: mask of BFLAG_* values. */
+    uint16_t    uNext;      /**< Next buffer in the hash chain, or in the free list if the buffer is invalid. */
+    uint8_t     bAccessed;  /**< Nonzero if the buffer was accessed again since the clock hand last passed it. */
 } BUFFERHEAD;
 
 
@@ -126,13 +161,32 @@ typedef struct
     */
     uint16_t    uNumUsed;
 
-    /** MRU array.  Each element of the array stores a buffer index; each buffer
-        index appears in the array once and only once.  The first element of the
-        array is the most-recently-used (MRU) buffer, followed by the next most
-        recently used, and so on, till the last element, which is the least-
-        recently-used (LRU) buffer.
+    /** First buffer in the list of invalid buffers, which are used before any
+        valid buffer is evicted; BIDX_INVALID if the list is empty.  The list
+        is linked through BUFFERHEAD::uNext.
+    */
+    uint16_t    uFreeHead;
+
+    /** The clock hand: the next buffer considered for eviction.
+    */
+    uint16_t    uClockHand;
+
+    /** Bitmap of the buffers which are dirty, so that flushing every dirty
+        buffer, as a transaction does, need not look at every buffer head.
+    */
+    uint8_t     abDirty[(REDCONF_BUFFER_COUNT + 7U) / 8U];
+
+    /** Hash table.  Each element is the first buffer of a chain of valid
+        buffers, linked through BUFFERHEAD::uNext, whose volume and block
+        number hash to the element; BIDX_INVALID if the chain is empty.
+    */
+    uint16_t    auHash[BUFFER_HASH_SIZE];
+
+  #if REDCONF_READ_ONLY == 0
+    /** The dirty buffers being written back, sorted by block number.
     */
-    uint8_t     abMRU[REDCONF_BUFFER_COUNT];
+    uint16_t    auWriteBack[REDCONF_BUFFER_COUNT];
+  #endif
 
     /** Buffer heads, storing metadata for each buffer.
     */
@@ -144,18 +198,43 @@ typedef struct
         to cast buffer pointers to node structure pointers.
     */
     ALIGNED_2D_BYTE_ARRAY(b, aabBuffer, REDCONF_BUFFER_COUNT, REDCONF_BLOCK_SIZE);
+
+  #if STAGING_BLOCKS > 1U
+    /** The buffers being filled by a readahead.
+    */
+    uint16_t    auReadAhead[STAGING_BLOCKS];
+
+    /** Staging buffer for writing, or reading ahead, contiguous blocks whose
+        buffers are not adjacent in memory.
+    */
+    ALIGNED_2D_BYTE_ARRAY(s, aabStaging, STAGING_BLOCKS, REDCONF_BLOCK_SIZE);
+  #endif
 } BUFFERCTX;
 
 
 static bool BufferIsValid(const uint8_t  *pbBuffer, uint16_t uFlags);
-static bool BufferToIdx(const void *pBuffer, uint8_t *pbIdx);
+static bool BufferToIdx(const void *pBuffer, uint16_t *puIdx);
 #if REDCONF_READ_ONLY == 0
-static REDSTATUS BufferWrite(uint8_t bIdx);
+static REDSTATUS BufferWriteRun(const uint16_t *pauIdx, uint32_t ulCount);
 static REDSTATUS BufferFinalize(uint8_t *pbBuffer, uint16_t uFlags);
+static uint32_t BufferGatherRun(uint16_t uIdx);
+static bool BufferFindIdleDirty(uint32_t ulBlock, uint16_t *puIdx);
+static void BufferSort(uint16_t *pauIdx, uint32_t ulCount);
+static void BufferSiftDown(uint16_t *pauIdx, uint32_t ulRoot, uint32_t ulCount);
+#endif
+static REDSTATUS BufferReclaim(uint16_t *puIdx);
+#if REDCONF_READAHEAD_BLOCKS > 0U
+static REDSTATUS BufferReadRun(uint32_t ulBlockStart, uint32_t ulCount);
 #endif
-static void BufferMakeLRU(uint8_t bIdx);
-static void BufferMakeMRU(uint8_t bIdx);
-static bool BufferFind(uint32_t ulBlock, uint8_t *pbIdx);
+static uint16_t BufferVictim(void);
+static void BufferInvalidate(uint16_t uIdx);
+static void BufferMarkDirty(uint16_t uIdx);
+static void BufferMarkClean(uint16_t uIdx);
+static uint32_t BufferHash(uint8_t bVolNum, uint32_t ulBlock);
+static void BufferHashInsert(uint16_t uIdx);
+static void BufferHashRemove(uint16_t uIdx);
+static bool BufferFind(uint32_t ulBlock, uint16_t *puIdx);
+static bool BufferRangeNext(uint32_t ulBlockStart, uint32_t ulBlockCount, bool fDirtyOnly, uint32_t *pulCursor, uint16_t *puIdx);
 
 #ifdef REDCONF_ENDIAN_SWAP
 static void BufferEndianSwap(const void *pBuffer, uint16_t uFlags);
@@ -174,18 +253,25 @@ static BUFFERCTX gBufCtx;
 */
 void RedBufferInit(void)
 {
-    uint8_t bIdx;
+    uint32_t ulIdx;
 
     RedMemSet(&gBufCtx, 0U, sizeof(gBufCtx));
 
-    for(bIdx = 0U; bIdx < REDCONF_BUFFER_COUNT; bIdx++)
+    for(ulIdx = 0U; ulIdx < BUFFER_HASH_SIZE; ulIdx++)
+    {
+        gBufCtx.auHash[ulIdx] = BIDX_INVALID;
+    }
+
+    for(ulIdx = 0U; ulIdx < REDCONF_BUFFER_COUNT; ulIdx++)
     {
         /*  When the buffers have been freshly initialized, acquire the buffers
             in the order in which they appear in the array.
         */
-        gBufCtx.abMRU[bIdx] = (uint8_t)((REDCONF_BUFFER_COUNT - bIdx) - 1U);
-        gBufCtx.aHead[bIdx].ulBlock = BBLK_INVALID;
+        gBufCtx.aHead[ulIdx].ulBlock = BBLK_INVALID;
+        gBufCtx.aHead[ulIdx].uNext = (uint16_t)(ulIdx + 1U);
     }
+
+    gBufCtx.uFreeHead = 0U;
 }
 
 
@@ -208,7 +294,7 @@ REDSTATUS RedBufferGet(
     void      **ppBuffer)
 {
     REDSTATUS   ret = 0;
-    uint8_t     bIdx;
+    uint16_t    uIdx;
 
     if((ulBlock >= gpRedVolume->ulBlockCount) || ((uFlags & BFLAG_MASK) != uFlags) || (ppBuffer == NULL))
     {
@@ -217,7 +303,7 @@ REDSTATUS RedBufferGet(
     }
     else
     {
-        if(BufferFind(ulBlock, &bIdx))
+        if(BufferFind(ulBlock, &uIdx))
         {
             /*  Error if the buffer exists and BFLAG_NEW was specified, since
                 the new flag is used when a block is newly allocated/created, so
@@ -228,11 +314,18 @@ REDSTATUS RedBufferGet(
                 was requested.
             */
             if(    ((uFlags & BFLAG_NEW) != 0U)
-                || ((uFlags & BFLAG_META_MASK) != (gBufCtx.aHead[bIdx].uFlags & BFLAG_META_MASK)))
+                || ((uFlags & BFLAG_META_MASK) != (gBufCtx.aHead[uIdx].uFlags & BFLAG_META_MASK)))
             {
                 CRITICAL_ERROR();
                 ret = -RED_EFUBAR;
             }
+            else
+            {
+                /*  The block was used again while it was cached: give it a
+                    second chance when the clock hand reaches it.
+                */
+                gBufCtx.aHead[uIdx].bAccessed = 1U;
+            }
         }
         else if(gBufCtx.uNumUsed == REDCONF_BUFFER_COUNT)
         {
@@ -244,66 +337,21 @@ REDSTATUS RedBufferGet(
         }
         else
         {
-            BUFFERHEAD *pHead;
-
-            /*  Search for the least recently used buffer which is not
-                referenced.
-            */
-            for(bIdx = (uint8_t)(REDCONF_BUFFER_COUNT - 1U); bIdx > 0U; bIdx--)
-            {
-                if(gBufCtx.aHead[gBufCtx.abMRU[bIdx]].bRefCount == 0U)
-                {
-                    break;
-                }
-            }
+            BUFFERHEAD *pHead = NULL;
 
-            bIdx = gBufCtx.abMRU[bIdx];
-            pHead = &gBufCtx.aHead[bIdx];
-
-            if(pHead->bRefCount == 0U)
-            {
-                /*  If the LRU buffer is valid and dirty, write it out before
-                    repurposing it.
-                */
-                if(((pHead->uFlags & BFLAG_DIRTY) != 0U) && (pHead->ulBlock != BBLK_INVALID))
-                {
-                  #if REDCONF_READ_ONLY == 1
-                    CRITICAL_ERROR();
-                    ret = -RED_EFUBAR;
-                  #else
-                    ret = BufferWrite(bIdx);
-                  #endif
-                }
-            }
-            else
-            {
-                /*  All the buffers are used, which should have been caught by
-                    checking gBufCtx.uNumUsed.
-                */
-                CRITICAL_ERROR();
-                ret = -RED_EBUSY;
-            }
+            ret = BufferReclaim(&uIdx);
 
             if(ret == 0)
             {
+                pHead = &gBufCtx.aHead[uIdx];
+
                 if((uFlags & BFLAG_NEW) == 0U)
                 {
-                    /*  Invalidate the LRU buffer.  If the read fails, we do not
-                        want the buffer head to continue to refer to the old
-                        block number, since the read, even if it fails, may have
-                        partially overwritten the buffer data (consider the case
-                        where block size exceeds sector size, and some but not
-                        all of the sectors are read successfully), and if the
-                        buffer were to be used subsequently with its partially
-                        erroneous contents, bad things could happen.
-                    */
-                    pHead->ulBlock = BBLK_INVALID;
-
-                    ret = RedIoRead(gbRedVolNum, ulBlock, 1U, gBufCtx.b.aabBuffer[bIdx]);
+                    ret = RedIoRead(gbRedVolNum, ulBlock, 1U, gBufCtx.b.aabBuffer[uIdx]);
 
                     if((ret == 0) && ((uFlags & BFLAG_META) != 0U))
                     {
-                        if(!BufferIsValid(gBufCtx.b.aabBuffer[bIdx], uFlags))
+                        if(!BufferIsValid(gBufCtx.b.aabBuffer[uIdx], uFlags))
                         {
                             /*  A corrupt metadata node is usually a critical
                                 error.  The master block is an exception since
@@ -319,32 +367,37 @@ REDSTATUS RedBufferGet(
                   #ifdef REDCONF_ENDIAN_SWAP
                     if(ret == 0)
                     {
-                        BufferEndianSwap(gBufCtx.b.aabBuffer[bIdx], uFlags);
+                        BufferEndianSwap(gBufCtx.b.aabBuffer[uIdx], uFlags);
                     }
                   #endif
                 }
                 else
                 {
-                    RedMemSet(gBufCtx.b.aabBuffer[bIdx], 0U, REDCONF_BLOCK_SIZE);
+                    RedMemSet(gBufCtx.b.aabBuffer[uIdx], 0U, REDCONF_BLOCK_SIZE);
                 }
-            }
 
-            if(ret == 0)
-            {
-                pHead->bVolNum = gbRedVolNum;
-                pHead->ulBlock = ulBlock;
-                pHead->uFlags = 0U;
+                if(ret == 0)
+                {
+                    pHead->bVolNum = gbRedVolNum;
+                    pHead->ulBlock = ulBlock;
+                    pHead->uFlags = 0U;
+                    pHead->bAccessed = 0U;
+                    BufferHashInsert(uIdx);
+                }
+                else
+                {
+                    BufferInvalidate(uIdx);
+                }
             }
         }
 
-        /*  Reference the buffer, update its flags, and promote it to MRU.  This
-            happens both when BufferFind() found an existing buffer for the
-            block and when the LRU buffer was repurposed to create a buffer for
-            the block.
+        /*  Reference the buffer and update its flags.  This happens both when
+            BufferFind() found an existing buffer for the block and when a
+            victim buffer was repurposed to create a buffer for the block.
         */
         if(ret == 0)
         {
-            BUFFERHEAD *pHead = &gBufCtx.aHead[bIdx];
+            BUFFERHEAD *pHead = &gBufCtx.aHead[uIdx];
 
             pHead->bRefCount++;
 
@@ -359,9 +412,12 @@ REDSTATUS RedBufferGet(
             */
             pHead->uFlags |= (uFlags & (~BFLAG_NEW));
 
-            BufferMakeMRU(bIdx);
+            if((uFlags & BFLAG_DIRTY) != 0U)
+            {
+                BufferMarkDirty(uIdx);
+            }
 
-            *ppBuffer = gBufCtx.b.aabBuffer[bIdx];
+            *ppBuffer = gBufCtx.b.aabBuffer[uIdx];
         }
     }
 
@@ -376,18 +432,18 @@ REDSTATUS RedBufferGet(
 void RedBufferPut(
     const void *pBuffer)
 {
-    uint8_t     bIdx;
+    uint16_t    uIdx;
 
-    if(!BufferToIdx(pBuffer, &bIdx))
+    if(!BufferToIdx(pBuffer, &uIdx))
     {
         REDERROR();
     }
     else
     {
-        REDASSERT(gBufCtx.aHead[bIdx].bRefCount > 0U);
-        gBufCtx.aHead[bIdx].bRefCount--;
+        REDASSERT(gBufCtx.aHead[uIdx].bRefCount > 0U);
+        gBufCtx.aHead[uIdx].bRefCount--;
 
-        if(gBufCtx.aHead[bIdx].bRefCount == 0U)
+        if(gBufCtx.aHead[uIdx].bRefCount == 0U)
         {
             REDASSERT(gBufCtx.uNumUsed > 0U);
             gBufCtx.uNumUsed--;
@@ -396,6 +452,83 @@ void RedBufferPut(
 }
 
 
+#if REDCONF_READAHEAD_BLOCKS > 0U
+/** @brief Read blocks into the buffers before they are needed.
+
+    The blocks in the range which are not buffered are read, several at a time
+    where they are contiguous, into buffers which are left clean and
+    unreferenced.  Their accessed flag is clear, so if they turn out not to be
+    needed, they are the first buffers to be evicted.  No more than half of the
+    unreferenced buffers are used, so that the read ahead blocks do not crowd
+    out everything else.
+
+    @param ulBlockStart The first block to read ahead.
+    @param ulBlockCount The number of blocks, starting at @p ulBlockStart, to
+                        read ahead.  Must not be zero.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EIO    A disk I/O error occurred.
+    @retval -RED_EINVAL Invalid parameters.
+    @retval -RED_EBUSY  All buffers are referenced.
+*/
+REDSTATUS RedBufferReadAhead(
+    uint32_t    ulBlockStart,
+    uint32_t    ulBlockCount)
+{
+    REDSTATUS   ret = 0;
+
+    if(    (ulBlockStart >= gpRedVolume->ulBlockCount)
+        || ((gpRedVolume->ulBlockCount - ulBlockStart) < ulBlockCount)
+        || (ulBlockCount == 0U))
+    {
+        REDERROR();
+        ret = -RED_EINVAL;
+    }
+    else
+    {
+        uint32_t ulBlock = ulBlockStart;
+        uint32_t ulBlockEnd = ulBlockStart + ulBlockCount;
+        uint32_t ulBudget = (REDCONF_BUFFER_COUNT - (uint32_t)gBufCtx.uNumUsed) / 2U;
+
+        while((ret == 0) && (ulBlock < ulBlockEnd) && (ulBudget > 0U))
+        {
+            uint32_t ulRunLen = 0U;
+            uint16_t uIdx;
+
+            /*  Find the run of blocks starting at ulBlock which are not
+                buffered.
+            */
+            while(    (ulRunLen < STAGING_BLOCKS)
+                   && (ulRunLen < ulBudget)
+                   && ((ulBlock + ulRunLen) < ulBlockEnd)
+                   && !BufferFind(ulBlock + ulRunLen, &uIdx))
+            {
+                ulRunLen++;
+            }
+
+            if(ulRunLen == 0U)
+            {
+                /*  The block is already buffered.
+                */
+                ulBlock++;
+            }
+            else
+            {
+                ret = BufferReadRun(ulBlock, ulRunLen);
+
+                ulBlock += ulRunLen;
+                ulBudget -= ulRunLen;
+            }
+        }
+    }
+
+    return ret;
+}
+#endif /* REDCONF_READAHEAD_BLOCKS > 0U */
+
+
 #if REDCONF_READ_ONLY == 0
 /** @brief Flush all buffers for the active volume in the given range of blocks.
 
@@ -424,29 +557,37 @@ REDSTATUS RedBufferFlush(
     }
     else
     {
-        uint8_t bIdx;
+        uint32_t ulCursor = 0U;
+        uint32_t ulCount = 0U;
+        uint32_t ulRunStart = 0U;
+        uint16_t uIdx;
 
-        for(bIdx = 0U; bIdx < REDCONF_BUFFER_COUNT; bIdx++)
+        while(BufferRangeNext(ulBlockStart, ulBlockCount, true, &ulCursor, &uIdx))
         {
-            BUFFERHEAD *pHead = &gBufCtx.aHead[bIdx];
+            gBufCtx.auWriteBack[ulCount] = uIdx;
+            ulCount++;
+        }
 
-            if(    (pHead->bVolNum == gbRedVolNum)
-                && (pHead->ulBlock != BBLK_INVALID)
-                && ((pHead->uFlags & BFLAG_DIRTY) != 0U)
-                && (pHead->ulBlock >= ulBlockStart)
-                && (pHead->ulBlock < (ulBlockStart + ulBlockCount)))
-            {
-                ret = BufferWrite(bIdx);
+        /*  Write the buffers in order of block number, so that the device sees
+            ascending addresses and contiguous blocks can be written together.
+        */
+        BufferSort(gBufCtx.auWriteBack, ulCount);
 
-                if(ret == 0)
-                {
-                    pHead->uFlags &= (~BFLAG_DIRTY);
-                }
-                else
-                {
-                    break;
-                }
+        while((ret == 0) && (ulRunStart < ulCount))
+        {
+            const uint16_t *pauRun = &gBufCtx.auWriteBack[ulRunStart];
+            uint32_t        ulRunLen = 1U;
+
+            while(    ((ulRunStart + ulRunLen) < ulCount)
+                   && (ulRunLen < REDCONF_WRITEBACK_BLOCKS)
+                   && (gBufCtx.aHead[pauRun[ulRunLen]].ulBlock == (gBufCtx.aHead[pauRun[0U]].ulBlock + ulRunLen)))
+            {
+                ulRunLen++;
             }
+
+            ret = BufferWriteRun(pauRun, ulRunLen);
+
+            ulRunStart += ulRunLen;
         }
     }
 
@@ -461,17 +602,17 @@ REDSTATUS RedBufferFlush(
 void RedBufferDirty(
     const void *pBuffer)
 {
-    uint8_t     bIdx;
+    uint16_t    uIdx;
 
-    if(!BufferToIdx(pBuffer, &bIdx))
+    if(!BufferToIdx(pBuffer, &uIdx))
     {
         REDERROR();
     }
     else
     {
-        REDASSERT(gBufCtx.aHead[bIdx].bRefCount > 0U);
+        REDASSERT(gBufCtx.aHead[uIdx].bRefCount > 0U);
 
-        gBufCtx.aHead[bIdx].uFlags |= BFLAG_DIRTY;
+        BufferMarkDirty(uIdx);
     }
 }
 
@@ -485,22 +626,35 @@ void RedBufferBranch(
     const void *pBuffer,
     uint32_t    ulBlockNew)
 {
-    uint8_t     bIdx;
+    uint16_t    uIdx;
 
-    if(    !BufferToIdx(pBuffer, &bIdx)
+    if(    !BufferToIdx(pBuffer, &uIdx)
         || (ulBlockNew >= gpRedVolume->ulBlockCount))
     {
         REDERROR();
     }
     else
     {
-        BUFFERHEAD *pHead = &gBufCtx.aHead[bIdx];
+        BUFFERHEAD *pHead = &gBufCtx.aHead[uIdx];
+        uint16_t    uExistingIdx;
 
         REDASSERT(pHead->bRefCount > 0U);
         REDASSERT((pHead->uFlags & BFLAG_DIRTY) == 0U);
 
-        pHead->uFlags |= BFLAG_DIRTY;
+        /*  The new block was free, so it should not be buffered.
+        */
+        REDASSERT(!BufferFind(ulBlockNew, &uExistingIdx));
+        (void)uExistingIdx;
+
+        /*  The block number is part of the hash key, so move the buffer to the
+            hash chain for its new block number.
+        */
+        BufferHashRemove(uIdx);
+
         pHead->ulBlock = ulBlockNew;
+        BufferMarkDirty(uIdx);
+
+        BufferHashInsert(uIdx);
     }
 }
 
@@ -513,23 +667,22 @@ void RedBufferBranch(
 void RedBufferDiscard(
     const void *pBuffer)
 {
-    uint8_t     bIdx;
+    uint16_t    uIdx;
 
-    if(!BufferToIdx(pBuffer, &bIdx))
+    if(!BufferToIdx(pBuffer, &uIdx))
     {
         REDERROR();
     }
     else
     {
-        REDASSERT(gBufCtx.aHead[bIdx].bRefCount == 1U);
+        REDASSERT(gBufCtx.aHead[uIdx].bRefCount == 1U);
         REDASSERT(gBufCtx.uNumUsed > 0U);
 
-        gBufCtx.aHead[bIdx].bRefCount = 0U;
-        gBufCtx.aHead[bIdx].ulBlock = BBLK_INVALID;
+        gBufCtx.aHead[uIdx].bRefCount = 0U;
 
         gBufCtx.uNumUsed--;
 
-        BufferMakeLRU(bIdx);
+        BufferInvalidate(uIdx);
     }
 }
 #endif
@@ -563,43 +716,34 @@ REDSTATUS RedBufferDiscardRange(
     }
     else
     {
-        uint8_t bIdx;
+        uint32_t ulCursor = 0U;
+        uint16_t uIdx;
 
-        for(bIdx = 0U; bIdx < REDCONF_BUFFER_COUNT; bIdx++)
+        while(BufferRangeNext(ulBlockStart, ulBlockCount, false, &ulCursor, &uIdx))
         {
-            BUFFERHEAD *pHead = &gBufCtx.aHead[bIdx];
-
-            if(    (pHead->bVolNum == gbRedVolNum)
-                && (pHead->ulBlock != BBLK_INVALID)
-                && (pHead->ulBlock >= ulBlockStart)
-                && (pHead->ulBlock < (ulBlockStart + ulBlockCount)))
+            if(gBufCtx.aHead[uIdx].bRefCount == 0U)
             {
-                if(pHead->bRefCount == 0U)
-                {
-                    pHead->ulBlock = BBLK_INVALID;
-
-                    BufferMakeLRU(bIdx);
-                }
-                else
-                {
-                    /*  This should never happen.  There are three general cases
-                        when this function is used:
-
-                        1) Discarding every block, as happens during unmount
-                           and at the end of format.  There should no longer be
-                           any referenced buffers at those points.
-                        2) Discarding a block which has become free.  All
-                           buffers for such blocks should be put or branched
-                           beforehand.
-                        3) Discarding of blocks that were just written straight
-                           to disk, leaving stale data in the buffer.  The write
-                           code should never reference buffers for these blocks,
-                           since they would not be needed or used.
-                    */
-                    CRITICAL_ERROR();
-                    ret = -RED_EBUSY;
-                    break;
-                }
+                BufferInvalidate(uIdx);
+            }
+            else
+            {
+                /*  This should never happen.  There are three general cases
+                    when this function is used:
+
+                    1) Discarding every block, as happens during unmount
+                       and at the end of format.  There should no longer be
+                       any referenced buffers at those points.
+                    2) Discarding a block which has become free.  All
+                       buffers for such blocks should be put or branched
+                       beforehand.
+                    3) Discarding of blocks that were just written straight
+                       to disk, leaving stale data in the buffer.  The write
+                       code should never reference buffers for these blocks,
+                       since they would not be needed or used.
+                */
+                CRITICAL_ERROR();
+                ret = -RED_EBUSY;
+                break;
             }
         }
     }
@@ -718,7 +862,7 @@ static bool BufferIsValid(
 /** @brief Derive the index of the buffer.
 
     @param pBuffer  The buffer to derive the index of.
-    @param pbIdx    On success, populated with the index of the buffer.
+    @param puIdx    On success, populated with the index of the buffer.
 
     @return Boolean indicating result.
 
@@ -727,35 +871,36 @@ static bool BufferIsValid(
 */
 static bool BufferToIdx(
     const void *pBuffer,
-    uint8_t    *pbIdx)
+    uint16_t   *puIdx)
 {
     bool        fRet = false;
 
-    if((pBuffer != NULL) && (pbIdx != NULL))
+    if((pBuffer != NULL) && (puIdx != NULL))
     {
-        uint8_t bIdx;
-
-        /*  pBuffer should be a pointer to one of the block buffers.
-
-            A good compiler should optimize this loop into a bounds check and an
-            alignment check, although GCC has been observed to not do so; if the
-            number of buffers is small, it should not make much difference.  The
-            alternative is to use pointer comparisons, but this both deviates
-            from MISRA-C:2012 and involves undefined behavior.
+        uintptr_t   ulOffset = PTR_BYTE_OFFSET(pBuffer, &gBufCtx.b.aabBuffer[0U][0U]);
+        uint32_t    ulIdx = REDCONF_BUFFER_COUNT;
+
+        /*  pBuffer should be a pointer to one of the block buffers.  Computing
+            its index from its offset takes constant time, however many buffers
+            there are.  A pointer before the first buffer yields a huge offset,
+            and a pointer into the middle of a buffer fails the comparison, so
+            neither is mistaken for a buffer.
         */
-        for(bIdx = 0U; bIdx < REDCONF_BUFFER_COUNT; bIdx++)
+        if(ulOffset < ((uintptr_t)REDCONF_BUFFER_COUNT * REDCONF_BLOCK_SIZE))
         {
-            if(pBuffer == &gBufCtx.b.aabBuffer[bIdx][0U])
+            ulIdx = (uint32_t)(ulOffset / REDCONF_BLOCK_SIZE);
+
+            if(pBuffer != &gBufCtx.b.aabBuffer[ulIdx][0U])
             {
-                break;
+                ulIdx = REDCONF_BUFFER_COUNT;
             }
         }
 
-        if(    (bIdx < REDCONF_BUFFER_COUNT)
-            && (gBufCtx.aHead[bIdx].ulBlock != BBLK_INVALID)
-            && (gBufCtx.aHead[bIdx].bVolNum == gbRedVolNum))
+        if(    (ulIdx < REDCONF_BUFFER_COUNT)
+            && (gBufCtx.aHead[ulIdx].ulBlock != BBLK_INVALID)
+            && (gBufCtx.aHead[ulIdx].bVolNum == gbRedVolNum))
         {
-            *pbIdx = bIdx;
+            *puIdx = (uint16_t)ulIdx;
             fRet = true;
         }
     }
@@ -765,9 +910,17 @@ static bool BufferToIdx(
 
 
 #if REDCONF_READ_ONLY == 0
-/** @brief Write out a dirty buffer.
+/** @brief Write out the dirty buffers for a run of contiguous blocks.
 
-    @param bIdx The index of the buffer to write.
+    The run is written with one request: directly from the buffers if they are
+    adjacent in memory, otherwise by way of the staging buffer.  If the write
+    succeeds, the buffers are marked clean.
+
+    @param pauIdx   The indexes of the buffers to write, in order of block
+                    number.  The buffers must be dirty and must buffer
+                    contiguous blocks of one volume.
+    @param ulCount  The number of buffers in @p pauIdx.  Must be between one
+                    and REDCONF_WRITEBACK_BLOCKS.
 
     @return A negated ::REDSTATUS code indicating the operation result.
 
@@ -775,35 +928,84 @@ static bool BufferToIdx(
     @retval -RED_EIO    A disk I/O error occurred.
     @retval -RED_EINVAL Invalid parameters.
 */
-static REDSTATUS BufferWrite(
-    uint8_t     bIdx)
+static REDSTATUS BufferWriteRun(
+    const uint16_t *pauIdx,
+    uint32_t        ulCount)
 {
-    REDSTATUS   ret = 0;
+    REDSTATUS       ret = 0;
 
-    if(bIdx < REDCONF_BUFFER_COUNT)
+    if((pauIdx == NULL) || (ulCount == 0U) || (ulCount > REDCONF_WRITEBACK_BLOCKS) || (pauIdx[0U] >= REDCONF_BUFFER_COUNT))
     {
-        const BUFFERHEAD *pHead = &gBufCtx.aHead[bIdx];
-
-        REDASSERT((pHead->uFlags & BFLAG_DIRTY) != 0U);
+        REDERROR();
+        ret = -RED_EINVAL;
+    }
+    else
+    {
+        const BUFFERHEAD   *pFirst = &gBufCtx.aHead[pauIdx[0U]];
+        bool                fInPlace = true;
+        uint32_t            ulFinalized;
+        uint32_t            ulIdx;
 
-        if((pHead->uFlags & BFLAG_META) != 0U)
+        for(ulFinalized = 0U; ulFinalized < ulCount; ulFinalized++)
         {
-            ret = BufferFinalize(gBufCtx.b.aabBuffer[bIdx], pHead->uFlags);
+            uint16_t            uIdx = pauIdx[ulFinalized];
+            const BUFFERHEAD   *pHead = &gBufCtx.aHead[uIdx];
+
+            REDASSERT((pHead->uFlags & BFLAG_DIRTY) != 0U);
+            REDASSERT(pHead->bVolNum == pFirst->bVolNum);
+            REDASSERT(pHead->ulBlock == (pFirst->ulBlock + ulFinalized));
+
+            if((pHead->uFlags & BFLAG_META) != 0U)
+            {
+                ret = BufferFinalize(gBufCtx.b.aabBuffer[uIdx], pHead->uFlags);
+                if(ret != 0)
+                {
+                    break;
+                }
+            }
+
+            if(uIdx != (pauIdx[0U] + ulFinalized))
+            {
+                fInPlace = false;
+            }
         }
 
         if(ret == 0)
         {
-            ret = RedIoWrite(pHead->bVolNum, pHead->ulBlock, 1U, gBufCtx.b.aabBuffer[bIdx]);
+            if(fInPlace)
+            {
+                ret = RedIoWrite(pFirst->bVolNum, pFirst->ulBlock, ulCount, gBufCtx.b.aabBuffer[pauIdx[0U]]);
+            }
+          #if STAGING_BLOCKS > 1U
+            else
+            {
+                for(ulIdx = 0U; ulIdx < ulCount; ulIdx++)
+                {
+                    RedMemCpy(gBufCtx.s.aabStaging[ulIdx], gBufCtx.b.aabBuffer[pauIdx[ulIdx]], REDCONF_BLOCK_SIZE);
+                }
 
-          #ifdef REDCONF_ENDIAN_SWAP
-            BufferEndianSwap(gBufCtx.b.aabBuffer[bIdx], pHead->uFlags);
+                ret = RedIoWrite(pFirst->bVolNum, pFirst->ulBlock, ulCount, gBufCtx.s.aabStaging[0U]);
+            }
           #endif
         }
-    }
-    else
-    {
-        REDERROR();
-        ret = -RED_EINVAL;
+
+      #ifdef REDCONF_ENDIAN_SWAP
+        /*  Finalizing swapped the metadata buffers to on-disk byte order; swap
+            them back, whether or not they were written.
+        */
+        for(ulIdx = 0U; ulIdx < ulFinalized; ulIdx++)
+        {
+            BufferEndianSwap(gBufCtx.b.aabBuffer[pauIdx[ulIdx]], gBufCtx.aHead[pauIdx[ulIdx]].uFlags);
+        }
+      #endif
+
+        if(ret == 0)
+        {
+            for(ulIdx = 0U; ulIdx < ulCount; ulIdx++)
+            {
+                BufferMarkClean(pauIdx[ulIdx]);
+            }
+        }
     }
 
     return ret;
@@ -899,6 +1101,174 @@ static REDSTATUS BufferFinalize(
 
     return ret;
 }
+
+
+/** @brief Gather the run of dirty blocks to write out with an evicted buffer.
+
+    The run is the dirty buffer being evicted plus the idle dirty buffers for
+    the blocks on either side of it, up to REDCONF_WRITEBACK_BLOCKS blocks in
+    all.  Referenced buffers are left out, since their holders may still be
+    changing them.
+
+    @param uIdx The index of the dirty buffer being evicted.
+
+    @return The number of buffers in the run, which is stored in
+            gBufCtx.auWriteBack in order of block number.
+*/
+static uint32_t BufferGatherRun(
+    uint16_t    uIdx)
+{
+    const BUFFERHEAD   *pHead = &gBufCtx.aHead[uIdx];
+    uint32_t            ulCount = 0U;
+
+    if(pHead->bVolNum != gbRedVolNum)
+    {
+        /*  Blocks are only found on the active volume, so a buffer for another
+            volume is written on its own.
+        */
+        gBufCtx.auWriteBack[0U] = uIdx;
+        ulCount = 1U;
+    }
+    else
+    {
+        uint32_t    ulBlock = pHead->ulBlock;
+        uint16_t    uRunIdx;
+
+        /*  Back up to the first block of the run...
+        */
+        while(    (ulBlock > 0U)
+               && (((pHead->ulBlock - ulBlock) + 1U) < REDCONF_WRITEBACK_BLOCKS)
+               && BufferFindIdleDirty(ulBlock - 1U, &uRunIdx))
+        {
+            ulBlock--;
+        }
+
+        /*  ...and gather forward from there.
+        */
+        while(ulCount < REDCONF_WRITEBACK_BLOCKS)
+        {
+            if(ulBlock == pHead->ulBlock)
+            {
+                uRunIdx = uIdx;
+            }
+            else if((ulBlock >= gpRedVolume->ulBlockCount) || !BufferFindIdleDirty(ulBlock, &uRunIdx))
+            {
+                break;
+            }
+            else
+            {
+                /*  uRunIdx was populated by BufferFindIdleDirty().
+                */
+            }
+
+            gBufCtx.auWriteBack[ulCount] = uRunIdx;
+            ulCount++;
+            ulBlock++;
+        }
+    }
+
+    return ulCount;
+}
+
+
+/** @brief Find a dirty buffer which is not referenced.
+
+    @param ulBlock  The block number to find.
+    @param puIdx    If the block has an idle dirty buffer (true is returned),
+                    populated with the index of the buffer.
+
+    @return Boolean indicating whether @p ulBlock has a buffer which is dirty
+            and not referenced.
+*/
+static bool BufferFindIdleDirty(
+    uint32_t    ulBlock,
+    uint16_t   *puIdx)
+{
+    bool        fFound = BufferFind(ulBlock, puIdx);
+
+    if(fFound)
+    {
+        const BUFFERHEAD *pHead = &gBufCtx.aHead[*puIdx];
+
+        fFound = ((pHead->uFlags & BFLAG_DIRTY) != 0U) && (pHead->bRefCount == 0U);
+    }
+
+    return fFound;
+}
+
+
+/** @brief Sort buffer indexes by block number.
+
+    A heapsort is used: it needs neither recursion nor extra memory, and its
+    running time does not degrade when the buffers are already in order, as is
+    common.
+
+    @param pauIdx   The buffer indexes to sort.  The buffers must be valid and
+                    belong to one volume.
+    @param ulCount  The number of buffer indexes in @p pauIdx.
+*/
+static void BufferSort(
+    uint16_t   *pauIdx,
+    uint32_t    ulCount)
+{
+    uint32_t    ulIdx;
+
+    for(ulIdx = ulCount / 2U; ulIdx > 0U; ulIdx--)
+    {
+        BufferSiftDown(pauIdx, ulIdx - 1U, ulCount);
+    }
+
+    for(ulIdx = ulCount; ulIdx > 1U; ulIdx--)
+    {
+        uint16_t uTmp = pauIdx[0U];
+
+        pauIdx[0U] = pauIdx[ulIdx - 1U];
+        pauIdx[ulIdx - 1U] = uTmp;
+
+        BufferSiftDown(pauIdx, 0U, ulIdx - 1U);
+    }
+}
+
+
+/** @brief Restore the heap property below an element of a heap of buffer
+           indexes, in which the buffer with the highest block number is the
+           root.
+
+    @param pauIdx   The heap of buffer indexes.
+    @param ulRoot   The element which may be out of place.
+    @param ulCount  The number of elements in the heap.
+*/
+static void BufferSiftDown(
+    uint16_t   *pauIdx,
+    uint32_t    ulRoot,
+    uint32_t    ulCount)
+{
+    uint32_t    ulParent = ulRoot;
+
+    while(((2U * ulParent) + 1U) < ulCount)
+    {
+        uint32_t ulChild = (2U * ulParent) + 1U;
+
+        if(    ((ulChild + 1U) < ulCount)
+            && (gBufCtx.aHead[pauIdx[ulChild + 1U]].ulBlock > gBufCtx.aHead[pauIdx[ulChild]].ulBlock))
+        {
+            ulChild++;
+        }
+
+        if(gBufCtx.aHead[pauIdx[ulChild]].ulBlock > gBufCtx.aHead[pauIdx[ulParent]].ulBlock)
+        {
+            uint16_t uTmp = pauIdx[ulParent];
+
+            pauIdx[ulParent] = pauIdx[ulChild];
+            pauIdx[ulChild] = uTmp;
+            ulParent = ulChild;
+        }
+        else
+        {
+            break;
+        }
+    }
+}
 #endif /* REDCONF_READ_ONLY == 0 */
 
 
@@ -1072,141 +1442,519 @@ static void BufferEndianSwapIndir(
 #endif /* #ifdef REDCONF_ENDIAN_SWAP */
 
 
-/** @brief Mark a buffer as least recently used.
+/** @brief Take a buffer to hold a block which is not buffered.
+
+    If the buffer selected by BufferVictim() is dirty, it is written out first.
+    The buffer is then removed from the hash table, so the caller must either
+    give it a block number and put it back in the table, or invalidate it.
+
+    @param puIdx    On success, populated with the index of the buffer.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
 
-    @param bIdx The index of the buffer to make LRU.
+    @retval 0           Operation was successful.
+    @retval -RED_EIO    A disk I/O error occurred.
+    @retval -RED_EBUSY  All buffers are referenced.
 */
-static void BufferMakeLRU(
-    uint8_t bIdx)
+static REDSTATUS BufferReclaim(
+    uint16_t   *puIdx)
 {
-    if(bIdx >= REDCONF_BUFFER_COUNT)
+    REDSTATUS   ret = 0;
+
+    /*  Take an invalid buffer if there is one, otherwise a buffer which is not
+        referenced and was not recently used.
+    */
+    uint16_t    uIdx = BufferVictim();
+
+    if(uIdx == BIDX_INVALID)
     {
-        REDERROR();
+        /*  All the buffers are referenced, which the callers should have
+            ruled out.
+        */
+        CRITICAL_ERROR();
+        ret = -RED_EBUSY;
     }
-    else if(bIdx != gBufCtx.abMRU[REDCONF_BUFFER_COUNT - 1U])
+    else
     {
-        uint8_t bMruIdx;
+        BUFFERHEAD *pHead = &gBufCtx.aHead[uIdx];
+
+        if(pHead->ulBlock != BBLK_INVALID)
+        {
+            /*  If the victim buffer is dirty, write it out before repurposing
+                it, along with any idle dirty buffers for the blocks around it,
+                which will have to be written sooner or later and cost little
+                extra to write now.
+            */
+            if((pHead->uFlags & BFLAG_DIRTY) != 0U)
+            {
+              #if REDCONF_READ_ONLY == 1
+                CRITICAL_ERROR();
+                ret = -RED_EFUBAR;
+              #else
+                ret = BufferWriteRun(gBufCtx.auWriteBack, BufferGatherRun(uIdx));
+              #endif
+            }
+
+            /*  Invalidate the victim buffer.  If the caller's read fails, we do
+                not want the buffer head to continue to refer to the old block
+                number, since the read, even if it fails, may have partially
+                overwritten the buffer data (consider the case where block size
+                exceeds sector size, and some but not all of the sectors are
+                read successfully), and if the buffer were to be used
+                subsequently with its partially erroneous contents, bad things
+                could happen.
+            */
+            if(ret == 0)
+            {
+                BufferHashRemove(uIdx);
+                pHead->ulBlock = BBLK_INVALID;
+            }
+        }
+
+        if(ret == 0)
+        {
+            *puIdx = uIdx;
+        }
+    }
+
+    return ret;
+}
+
+
+#if REDCONF_READAHEAD_BLOCKS > 0U
+/** @brief Read a run of contiguous blocks which are not buffered into clean,
+           unreferenced buffers.
+
+    @param ulBlockStart The first block of the run.
+    @param ulCount      The number of blocks in the run.  Must be between one
+                        and STAGING_BLOCKS, and no more than half of the
+                        unreferenced buffers.
 
-        /*  Find the current position of the buffer in the MRU array.  We do not
-            need to check the last slot, since we already know from the above
-            check that the index is not there.
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EIO    A disk I/O error occurred.
+    @retval -RED_EBUSY  All buffers are referenced.
+*/
+static REDSTATUS BufferReadRun(
+    uint32_t    ulBlockStart,
+    uint32_t    ulCount)
+{
+    REDSTATUS   ret = 0;
+    uint16_t    uIdx = BIDX_INVALID;
+
+  #if STAGING_BLOCKS > 1U
+    if(ulCount > 1U)
+    {
+        uint32_t ulReclaimed;
+        uint32_t ulIdx;
+
+        /*  Take all the buffers first, since writing out a dirty victim may use
+            the staging buffer.  The buffers are referenced until they are
+            filled, so that the clock does not select any of them twice.
         */
-        for(bMruIdx = 0U; bMruIdx < (REDCONF_BUFFER_COUNT - 1U); bMruIdx++)
+        for(ulReclaimed = 0U; ulReclaimed < ulCount; ulReclaimed++)
         {
-            if(bIdx == gBufCtx.abMRU[bMruIdx])
+            ret = BufferReclaim(&uIdx);
+            if(ret != 0)
             {
                 break;
             }
+
+            gBufCtx.auReadAhead[ulReclaimed] = uIdx;
+            gBufCtx.aHead[uIdx].bRefCount = 1U;
+            gBufCtx.uNumUsed++;
         }
 
-        if(bMruIdx < (REDCONF_BUFFER_COUNT - 1U))
+        if(ret == 0)
         {
-            /*  Move the buffer index to the back of the MRU array, making it
-                the LRU buffer.
-            */
-            RedMemMove(&gBufCtx.abMRU[bMruIdx], &gBufCtx.abMRU[bMruIdx + 1U], REDCONF_BUFFER_COUNT - ((uint32_t)bMruIdx + 1U));
-            gBufCtx.abMRU[REDCONF_BUFFER_COUNT - 1U] = bIdx;
+            ret = RedIoRead(gbRedVolNum, ulBlockStart, ulCount, gBufCtx.s.aabStaging[0U]);
         }
-        else
+
+        for(ulIdx = 0U; ulIdx < ulReclaimed; ulIdx++)
         {
-            REDERROR();
+            BUFFERHEAD *pHead = &gBufCtx.aHead[gBufCtx.auReadAhead[ulIdx]];
+
+            pHead->bRefCount = 0U;
+            gBufCtx.uNumUsed--;
+
+            if(ret == 0)
+            {
+                RedMemCpy(gBufCtx.b.aabBuffer[gBufCtx.auReadAhead[ulIdx]], gBufCtx.s.aabStaging[ulIdx], REDCONF_BLOCK_SIZE);
+
+                pHead->bVolNum = gbRedVolNum;
+                pHead->ulBlock = ulBlockStart + ulIdx;
+                pHead->uFlags = 0U;
+                pHead->bAccessed = 0U;
+                BufferHashInsert(gBufCtx.auReadAhead[ulIdx]);
+            }
+            else
+            {
+                BufferInvalidate(gBufCtx.auReadAhead[ulIdx]);
+            }
         }
     }
     else
+  #endif
     {
-        /*  Buffer already LRU, nothing to do.
-        */
+        REDASSERT(ulCount == 1U);
+
+        ret = BufferReclaim(&uIdx);
+
+        if(ret == 0)
+        {
+            ret = RedIoRead(gbRedVolNum, ulBlockStart, 1U, gBufCtx.b.aabBuffer[uIdx]);
+
+            if(ret == 0)
+            {
+                BUFFERHEAD *pHead = &gBufCtx.aHead[uIdx];
+
+                pHead->bVolNum = gbRedVolNum;
+                pHead->ulBlock = ulBlockStart;
+                pHead->uFlags = 0U;
+                pHead->bAccessed = 0U;
+                BufferHashInsert(uIdx);
+            }
+            else
+            {
+                BufferInvalidate(uIdx);
+            }
+        }
     }
+
+    return ret;
 }
+#endif /* REDCONF_READAHEAD_BLOCKS > 0U */
+
+
+/** @brief Select a buffer to hold a block which is not buffered.
 
+    An invalid buffer is taken from the free list if there is one.  Otherwise
+    the clock hand sweeps the buffers, skipping referenced buffers and clearing
+    the accessed flag of buffers which have one, until it reaches a buffer which
+    is neither.  Thus a buffer which was used again while it was cached survives
+    one more sweep, and blocks which are only used once, as when a large file is
+    read or written sequentially, are the first to go.
 
-/** @brief Mark a buffer as most recently used.
+    The caller must have checked that not every buffer is referenced.
 
-    @param bIdx The index of the buffer to make MRU.
+    @return The index of the selected buffer.  If the buffer is valid, it is
+            still buffering its block, and may be dirty.
 */
-static void BufferMakeMRU(
-    uint8_t bIdx)
+static uint16_t BufferVictim(void)
 {
-    if(bIdx >= REDCONF_BUFFER_COUNT)
+    uint16_t    uIdx = gBufCtx.uFreeHead;
+
+    if(uIdx != BIDX_INVALID)
     {
-        REDERROR();
+        gBufCtx.uFreeHead = gBufCtx.aHead[uIdx].uNext;
+        gBufCtx.aHead[uIdx].uNext = BIDX_INVALID;
     }
-    else if(bIdx != gBufCtx.abMRU[0U])
+    else
     {
-        uint8_t bMruIdx;
+        uint32_t ulStep;
 
-        /*  Find the current position of the buffer in the MRU array.  We do not
-            need to check the first slot, since we already know from the above
-            check that the index is not there.
+        /*  Every buffer which is not referenced is found with its accessed flag
+            clear within two sweeps.
         */
-        for(bMruIdx = 1U; bMruIdx < REDCONF_BUFFER_COUNT; bMruIdx++)
+        for(ulStep = 0U; ulStep < (2U * REDCONF_BUFFER_COUNT); ulStep++)
         {
-            if(bIdx == gBufCtx.abMRU[bMruIdx])
+            BUFFERHEAD *pHead = &gBufCtx.aHead[gBufCtx.uClockHand];
+            uint16_t    uHand = gBufCtx.uClockHand;
+
+            gBufCtx.uClockHand++;
+            if(gBufCtx.uClockHand == REDCONF_BUFFER_COUNT)
             {
-                break;
+                gBufCtx.uClockHand = 0U;
+            }
+
+            if(pHead->bRefCount == 0U)
+            {
+                if(pHead->bAccessed == 0U)
+                {
+                    uIdx = uHand;
+                    break;
+                }
+
+                pHead->bAccessed = 0U;
             }
         }
 
-        if(bMruIdx < REDCONF_BUFFER_COUNT)
+        /*  All the buffers are referenced, which should have been caught by
+            checking gBufCtx.uNumUsed.
+        */
+        REDASSERT(uIdx != BIDX_INVALID);
+    }
+
+    return uIdx;
+}
+
+
+/** @brief Mark a buffer invalid and put it on the free list.
+
+    Invalid buffers are used before any valid buffer is evicted.
+
+    @param uIdx The index of the buffer to invalidate.  The buffer must not be
+                referenced.
+*/
+static void BufferInvalidate(
+    uint16_t    uIdx)
+{
+    if(uIdx >= REDCONF_BUFFER_COUNT)
+    {
+        REDERROR();
+    }
+    else
+    {
+        BUFFERHEAD *pHead = &gBufCtx.aHead[uIdx];
+
+        REDASSERT(pHead->bRefCount == 0U);
+
+        if(pHead->ulBlock != BBLK_INVALID)
         {
-            /*  Move the buffer index to the front of the MRU array, making it
-                the MRU buffer.
-            */
-            RedMemMove(&gBufCtx.abMRU[1U], &gBufCtx.abMRU[0U], bMruIdx);
-            gBufCtx.abMRU[0U] = bIdx;
+            BufferHashRemove(uIdx);
+            pHead->ulBlock = BBLK_INVALID;
+        }
+
+        /*  Whatever the buffer held is no longer wanted, so it must not be
+            written out.
+        */
+        BufferMarkClean(uIdx);
+
+        pHead->uNext = gBufCtx.uFreeHead;
+        gBufCtx.uFreeHead = uIdx;
+    }
+}
+
+
+/** @brief Mark a buffer dirty.
+
+    @param uIdx The index of the buffer to mark dirty.
+*/
+static void BufferMarkDirty(
+    uint16_t    uIdx)
+{
+    if(uIdx >= REDCONF_BUFFER_COUNT)
+    {
+        REDERROR();
+    }
+    else
+    {
+        gBufCtx.aHead[uIdx].uFlags |= BFLAG_DIRTY;
+        RedBitSet(gBufCtx.abDirty, uIdx);
+    }
+}
+
+
+/** @brief Mark a buffer clean.
+
+    @param uIdx The index of the buffer to mark clean.
+*/
+static void BufferMarkClean(
+    uint16_t    uIdx)
+{
+    if(uIdx >= REDCONF_BUFFER_COUNT)
+    {
+        REDERROR();
+    }
+    else
+    {
+        gBufCtx.aHead[uIdx].uFlags &= (~BFLAG_DIRTY);
+        RedBitClear(gBufCtx.abDirty, uIdx);
+    }
+}
+
+
+/** @brief Compute the hash bucket of a block.
+
+    @param bVolNum  The volume the block resides on.
+    @param ulBlock  The block number.
+
+    @return The index of the hash bucket for the block.
+*/
+static uint32_t BufferHash(
+    uint8_t     bVolNum,
+    uint32_t    ulBlock)
+{
+    /*  Volume numbers go in the top bits, which block numbers rarely use, so
+        that the same block on different volumes usually hashes differently.
+    */
+    return (ulBlock ^ ((uint32_t)bVolNum << 24U)) % BUFFER_HASH_SIZE;
+}
+
+
+/** @brief Add a valid buffer to the hash table.
+
+    @param uIdx The index of the buffer to add.
+*/
+static void BufferHashInsert(
+    uint16_t    uIdx)
+{
+    if(uIdx >= REDCONF_BUFFER_COUNT)
+    {
+        REDERROR();
+    }
+    else
+    {
+        BUFFERHEAD *pHead = &gBufCtx.aHead[uIdx];
+        uint32_t    ulBucket = BufferHash(pHead->bVolNum, pHead->ulBlock);
+
+        pHead->uNext = gBufCtx.auHash[ulBucket];
+        gBufCtx.auHash[ulBucket] = uIdx;
+    }
+}
+
+
+/** @brief Remove a valid buffer from the hash table.
+
+    @param uIdx The index of the buffer to remove.
+*/
+static void BufferHashRemove(
+    uint16_t    uIdx)
+{
+    if(uIdx >= REDCONF_BUFFER_COUNT)
+    {
+        REDERROR();
+    }
+    else
+    {
+        BUFFERHEAD *pHead = &gBufCtx.aHead[uIdx];
+        uint16_t   *puLink = &gBufCtx.auHash[BufferHash(pHead->bVolNum, pHead->ulBlock)];
+
+        while((*puLink != uIdx) && (*puLink != BIDX_INVALID))
+        {
+            puLink = &gBufCtx.aHead[*puLink].uNext;
+        }
+
+        if(*puLink == uIdx)
+        {
+            *puLink = pHead->uNext;
+            pHead->uNext = BIDX_INVALID;
         }
         else
         {
             REDERROR();
         }
     }
-    else
-    {
-        /*  Buffer already MRU, nothing to do.
-        */
-    }
 }
 
 
 /** @brief Find a block in the buffers.
 
     @param ulBlock  The block number to find.
-    @param pbIdx    If the block is buffered (true is returned), populated with
+    @param puIdx    If the block is buffered (true is returned), populated with
                     the index of the buffer.
 
     @return Boolean indicating whether or not the block is buffered.
 
     @retval true    @p ulBlock is buffered, and its index has been stored in
-                    @p pbIdx.
+                    @p puIdx.
     @retval false   @p ulBlock is not buffered.
 */
 static bool BufferFind(
-    uint32_t ulBlock,
-    uint8_t *pbIdx)
+    uint32_t    ulBlock,
+    uint16_t   *puIdx)
 {
-    bool     ret = false;
+    bool        ret = false;
 
-    if((ulBlock >= gpRedVolume->ulBlockCount) || (pbIdx == NULL))
+    if((ulBlock >= gpRedVolume->ulBlockCount) || (puIdx == NULL))
     {
         REDERROR();
     }
     else
     {
-        uint8_t bIdx;
+        uint16_t uIdx = gBufCtx.auHash[BufferHash(gbRedVolNum, ulBlock)];
 
-        for(bIdx = 0U; bIdx < REDCONF_BUFFER_COUNT; bIdx++)
+        while(uIdx != BIDX_INVALID)
         {
-            const BUFFERHEAD *pHead = &gBufCtx.aHead[bIdx];
+            const BUFFERHEAD *pHead = &gBufCtx.aHead[uIdx];
 
             if((pHead->bVolNum == gbRedVolNum) && (pHead->ulBlock == ulBlock))
             {
-                *pbIdx = bIdx;
+                *puIdx = uIdx;
                 ret = true;
                 break;
             }
+
+            uIdx = pHead->uNext;
         }
     }
 
     return ret;
 }
 
+
+/** @brief Find the next buffered block of the active volume in a range.
+
+    Short ranges, such as a freed block or a file extent, are looked up in the
+    hash table block by block; longer ranges, such as the whole volume, are
+    found by scanning the buffers, or only the dirty buffers if that is all the
+    caller wants.  Either way, the cost is bounded by the smaller of the range
+    length and the buffer count.
+
+    @param ulBlockStart The first block number of the range.
+    @param ulBlockCount The number of blocks in the range.
+    @param fDirtyOnly   Whether to find only dirty buffers.
+    @param pulCursor    Iteration state.  Must be zero before the first call,
+                        and must not be modified by the caller between calls.
+    @param puIdx        If a buffered block was found (true is returned),
+                        populated with the index of its buffer.
+
+    @return Boolean indicating whether another buffered block was found.  The
+            buffer found may be cleaned or invalidated by the caller before the
+            next call.
+*/
+static bool BufferRangeNext(
+    uint32_t    ulBlockStart,
+    uint32_t    ulBlockCount,
+    bool        fDirtyOnly,
+    uint32_t   *pulCursor,
+    uint16_t   *puIdx)
+{
+    bool        fFound = false;
+
+    if(ulBlockCount <= REDCONF_BUFFER_COUNT)
+    {
+        while(!fFound && (*pulCursor < ulBlockCount))
+        {
+            fFound = BufferFind(ulBlockStart + *pulCursor, puIdx);
+
+            if(fFound && fDirtyOnly)
+            {
+                fFound = (gBufCtx.aHead[*puIdx].uFlags & BFLAG_DIRTY) != 0U;
+            }
+
+            (*pulCursor)++;
+        }
+    }
+    else
+    {
+        while(!fFound && (*pulCursor < REDCONF_BUFFER_COUNT))
+        {
+            const BUFFERHEAD *pHead = &gBufCtx.aHead[*pulCursor];
+
+            if(fDirtyOnly && (gBufCtx.abDirty[*pulCursor >> 3U] == 0U))
+            {
+                /*  Skip the rest of a byte of the bitmap with no dirty buffers.
+                */
+                *pulCursor = (*pulCursor | 7U) + 1U;
+            }
+            else
+            {
+                if(    (!fDirtyOnly || ((pHead->uFlags & BFLAG_DIRTY) != 0U))
+                    && (pHead->bVolNum == gbRedVolNum)
+                    && (pHead->ulBlock != BBLK_INVALID)
+                    && (pHead->ulBlock >= ulBlockStart)
+                    && ((pHead->ulBlock - ulBlockStart) < ulBlockCount))
+                {
+                    *puIdx = (uint16_t)*pulCursor;
+                    fFound = true;
+                }
+
+                (*pulCursor)++;
+            }
+        }
+    }
+
+    return fFound;
+}
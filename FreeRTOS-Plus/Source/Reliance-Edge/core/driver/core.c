@@ -213,6 +213,11 @@ REDSTATUS RedCoreInit(void)
                         ((pVol->ulBlockCount - 3U) + ((IMAPNODE_ENTRIES + 2U) - 1U)) / (IMAPNODE_ENTRIES + 2U);
 
                     pCoreVol->ulInodeTableStartBN = pCoreVol->ulImapStartBN + (pCoreVol->ulImapNodeCount * 2U);
+
+                  #if IMAP_SUMMARY_ENTRIES > 0U
+                    pCoreVol->ulImapNodesPerSummary =
+                        (pCoreVol->ulImapNodeCount + (IMAP_SUMMARY_ENTRIES - 1U)) / IMAP_SUMMARY_ENTRIES;
+                  #endif
                   #else
                     ret = -RED_EINVAL;
                   #endif
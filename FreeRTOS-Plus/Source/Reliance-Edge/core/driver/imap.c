@@ -33,6 +33,11 @@
 #include <redcore.h>
 
 
+#if REDCONF_READ_ONLY == 0
+static REDSTATUS ImapFindFree(uint32_t ulBlockStart, uint32_t ulBlockEnd, uint32_t *pulBlock);
+#endif
+
+
 /** @brief Get the allocation bit of a block from either metaroot.
 
     Will pass the call down either to the inline imap or to the external imap
@@ -162,14 +167,14 @@ REDSTATUS RedImapBlockSet(
     */
     if((ret == 0) && (ulBlock >= gpRedCoreVol->ulFirstAllocableBN))
     {
+        bool fWasAllocated = false;
+
         if(fAllocated)
         {
             gpRedMR->ulFreeBlocks--;
         }
         else
         {
-            bool fWasAllocated;
-
             /*  Whether the block became free or almost free depends on its
                 previous allocation state.  If it was used, then it is now
                 almost free.  Otherwise, it was new and is now free.
@@ -189,6 +194,28 @@ REDSTATUS RedImapBlockSet(
                 }
             }
         }
+
+      #if IMAP_SUMMARY_ENTRIES > 0U
+        if((ret == 0) && !gpRedCoreVol->fImapInline)
+        {
+            ALLOCSTATE state;
+
+            if(fAllocated)
+            {
+                state = ALLOCSTATE_NEW;
+            }
+            else if(fWasAllocated)
+            {
+                state = ALLOCSTATE_AFREE;
+            }
+            else
+            {
+                state = ALLOCSTATE_FREE;
+            }
+
+            RedImapESummaryUpdate(ulBlock, state);
+        }
+      #endif
     }
 
     return ret;
@@ -223,52 +250,97 @@ REDSTATUS RedImapAllocBlock(
     }
     else
     {
-        uint32_t ulStopBlock = gpRedMR->ulAllocNextBlock;
-        bool     fAllocated = false;
+        uint32_t ulNextBlock = gpRedMR->ulAllocNextBlock;
+        uint32_t ulBlock;
 
-        do
-        {
-            ALLOCSTATE state;
+        /*  Look for a free block from the next block to the end of the volume,
+            then wrap around and look from the first allocable block.
+        */
+        ret = ImapFindFree(ulNextBlock, gpRedVolume->ulBlockCount, &ulBlock);
+        CRITICAL_ASSERT(ret == 0);
 
-            ret = RedImapBlockState(gpRedMR->ulAllocNextBlock, &state);
+        if((ret == 0) && (ulBlock == gpRedVolume->ulBlockCount))
+        {
+            ret = ImapFindFree(gpRedCoreVol->ulFirstAllocableBN, ulNextBlock, &ulBlock);
             CRITICAL_ASSERT(ret == 0);
 
-            if(ret == 0)
+            if((ret == 0) && (ulBlock == ulNextBlock))
             {
-                if(state == ALLOCSTATE_FREE)
-                {
-                    ret = RedImapBlockSet(gpRedMR->ulAllocNextBlock, true);
-                    CRITICAL_ASSERT(ret == 0);
-
-                    *pulBlock = gpRedMR->ulAllocNextBlock;
-                    fAllocated = true;
-                }
-
-                /*  Increment the next block number, wrapping it when the end of
-                    the volume is reached.
+                /*  The free block count was already determined to be non-zero,
+                    no error occurred while looking for free blocks, but no free
+                    blocks were found.  This indicates metadata corruption.
                 */
-                gpRedMR->ulAllocNextBlock++;
-                if(gpRedMR->ulAllocNextBlock == gpRedVolume->ulBlockCount)
-                {
-                    gpRedMR->ulAllocNextBlock = gpRedCoreVol->ulFirstAllocableBN;
-                }
+                CRITICAL_ERROR();
+                ret = -RED_EFUBAR;
             }
         }
-        while((ret == 0) && !fAllocated && (gpRedMR->ulAllocNextBlock != ulStopBlock));
 
-        if((ret == 0) && !fAllocated)
+        if(ret == 0)
         {
-            /*  The free block count was already determined to be non-zero, no
-                error occurred while looking for free blocks, but no free blocks
-                were found.  This indicates metadata corruption.
+            ret = RedImapBlockSet(ulBlock, true);
+            CRITICAL_ASSERT(ret == 0);
+        }
+
+        if(ret == 0)
+        {
+            *pulBlock = ulBlock;
+
+            /*  Advance the next block number, wrapping it when the end of the
+                volume is reached.
             */
-            CRITICAL_ERROR();
-            ret = -RED_EFUBAR;
+            gpRedMR->ulAllocNextBlock = ulBlock + 1U;
+            if(gpRedMR->ulAllocNextBlock == gpRedVolume->ulBlockCount)
+            {
+                gpRedMR->ulAllocNextBlock = gpRedCoreVol->ulFirstAllocableBN;
+            }
         }
     }
 
     return ret;
 }
+
+
+/** @brief Find the first free block in a range.
+
+    Will pass the call down either to the inline imap or to the external imap
+    implementation, whichever is appropriate for the current volume.
+
+    @param ulBlockStart The first block to examine.
+    @param ulBlockEnd   One past the last block to examine.
+    @param pulBlock     On successful return, populated with the first free
+                        block in the range, or with @p ulBlockEnd if there are
+                        no free blocks in the range.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EINVAL The range is invalid; or @p pulBlock is `NULL`.
+    @retval -RED_EIO    A disk I/O error occurred.
+*/
+static REDSTATUS ImapFindFree(
+    uint32_t    ulBlockStart,
+    uint32_t    ulBlockEnd,
+    uint32_t   *pulBlock)
+{
+    REDSTATUS   ret;
+
+  #if (REDCONF_IMAP_INLINE == 1) && (REDCONF_IMAP_EXTERNAL == 1)
+    if(gpRedCoreVol->fImapInline)
+    {
+        ret = RedImapIFindFree(ulBlockStart, ulBlockEnd, pulBlock);
+    }
+    else
+    {
+        ret = RedImapEFindFree(ulBlockStart, ulBlockEnd, pulBlock);
+    }
+  #elif REDCONF_IMAP_INLINE == 1
+    ret = RedImapIFindFree(ulBlockStart, ulBlockEnd, pulBlock);
+  #else
+    ret = RedImapEFindFree(ulBlockStart, ulBlockEnd, pulBlock);
+  #endif
+
+    return ret;
+}
 #endif /* REDCONF_READ_ONLY == 0 */
 
 
@@ -37,9 +37,20 @@
 #include <redcore.h>
 
 
+/*  Number of bytes of the committed state copy of a branched imap node which
+    ImapNodeScan() examines at a time.  Only one imap node buffer may be held at
+    once, so the committed state bits are copied out a piece at a time.
+*/
+#define IMAP_SCAN_BYTES 64U
+
+
 #if REDCONF_READ_ONLY == 0
 static REDSTATUS ImapNodeBranch(uint32_t ulImapNode, IMAPNODE **ppImap);
 static bool ImapNodeIsBranched(uint32_t ulImapNode);
+static REDSTATUS ImapNodeScan(uint32_t ulImapNode, uint32_t ulEntryStart, uint32_t ulEntryEnd, uint32_t *pulEntry, uint32_t *pulFree, uint32_t *pulAlmostFree);
+#endif
+#if IMAP_SUMMARY_ENTRIES > 0U
+static REDSTATUS ImapSummaryCount(uint32_t ulSummary);
 #endif
 
 
@@ -173,6 +184,249 @@ REDSTATUS RedImapEBlockSet(
 }
 
 
+/** @brief Find the first free block in a range of the external imap.
+
+    A block is free if it is clear in both the working state and the committed
+    state imap.  The imap nodes are examined a word at a time, and when the free
+    block summary is enabled, groups of imap nodes without any free blocks are
+    skipped without being read.
+
+    @param ulBlockStart The first block to examine.
+    @param ulBlockEnd   One past the last block to examine.
+    @param pulBlock     On successful return, populated with the first free
+                        block in the range, or with @p ulBlockEnd if there are
+                        no free blocks in the range.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EINVAL The range is invalid; @p pulBlock is `NULL`; or the
+                        current volume does not use the external imap.
+    @retval -RED_EIO    A disk I/O error occurred.
+*/
+REDSTATUS RedImapEFindFree(
+    uint32_t    ulBlockStart,
+    uint32_t    ulBlockEnd,
+    uint32_t   *pulBlock)
+{
+    REDSTATUS   ret = 0;
+
+    if(    gpRedCoreVol->fImapInline
+        || (ulBlockStart < gpRedCoreVol->ulInodeTableStartBN)
+        || (ulBlockStart > ulBlockEnd)
+        || (ulBlockEnd > gpRedVolume->ulBlockCount)
+        || (pulBlock == NULL))
+    {
+        REDERROR();
+        ret = -RED_EINVAL;
+    }
+    else
+    {
+        uint32_t    ulBlock = ulBlockStart;
+        bool        fFound = false;
+
+        while((ret == 0) && !fFound && (ulBlock < ulBlockEnd))
+        {
+            uint32_t    ulOffset = ulBlock - gpRedCoreVol->ulInodeTableStartBN;
+            uint32_t    ulImapNode = ulOffset / IMAPNODE_ENTRIES;
+            uint32_t    ulNodeStart = ulBlock - (ulOffset % IMAPNODE_ENTRIES);
+            uint32_t    ulNodeEnd = ulNodeStart + REDMIN(ulBlockEnd - ulNodeStart, IMAPNODE_ENTRIES);
+            bool        fSkip = false;
+
+          #if IMAP_SUMMARY_ENTRIES > 0U
+            uint32_t    ulSummary = ulImapNode / gpRedCoreVol->ulImapNodesPerSummary;
+
+            if(gpRedCoreVol->aulSummaryFree[ulSummary] == IMAP_SUMMARY_UNKNOWN)
+            {
+                ret = ImapSummaryCount(ulSummary);
+            }
+
+            if((ret == 0) && (gpRedCoreVol->aulSummaryFree[ulSummary] == 0U))
+            {
+                uint64_t ullGroupEnd = gpRedCoreVol->ulInodeTableStartBN +
+                    ((uint64_t)(ulSummary + 1U) * gpRedCoreVol->ulImapNodesPerSummary * IMAPNODE_ENTRIES);
+
+                /*  No free blocks in this group of imap nodes, so move on to
+                    the next group.
+                */
+                ulNodeEnd = (uint32_t)REDMIN(ullGroupEnd, ulBlockEnd);
+                fSkip = true;
+            }
+          #endif
+
+            if((ret == 0) && !fSkip)
+            {
+                uint32_t ulEntry;
+
+                ret = ImapNodeScan(ulImapNode, ulBlock - ulNodeStart, ulNodeEnd - ulNodeStart, &ulEntry, NULL, NULL);
+
+                if((ret == 0) && (ulEntry < (ulNodeEnd - ulNodeStart)))
+                {
+                    *pulBlock = ulNodeStart + ulEntry;
+                    fFound = true;
+                }
+            }
+
+            ulBlock = ulNodeEnd;
+        }
+
+        if((ret == 0) && !fFound)
+        {
+            *pulBlock = ulBlockEnd;
+        }
+    }
+
+    return ret;
+}
+
+
+#if IMAP_SUMMARY_ENTRIES > 0U
+/** @brief Forget the free block summary.
+
+    Called when a volume is mounted.  Each summary entry is counted from the
+    imap the first time the allocator needs it.
+*/
+void RedImapESummaryReset(void)
+{
+    uint32_t ulSummary;
+
+    for(ulSummary = 0U; ulSummary < IMAP_SUMMARY_ENTRIES; ulSummary++)
+    {
+        gpRedCoreVol->aulSummaryFree[ulSummary] = IMAP_SUMMARY_UNKNOWN;
+        gpRedCoreVol->aulSummaryAlmostFree[ulSummary] = 0U;
+    }
+}
+
+
+/** @brief Update the free block summary for a change in the allocation state
+           of an allocable block.
+
+    @param ulBlock  The block whose allocation state changed.
+    @param state    The new allocation state of the block: ::ALLOCSTATE_NEW if
+                    it was free and has been allocated, ::ALLOCSTATE_FREE if it
+                    was new and has been freed, or ::ALLOCSTATE_AFREE if it was
+                    in use and has been freed.
+*/
+void RedImapESummaryUpdate(
+    uint32_t    ulBlock,
+    ALLOCSTATE  state)
+{
+    uint32_t    ulImapNode;
+    uint32_t    ulSummary;
+
+    REDASSERT(!gpRedCoreVol->fImapInline);
+    REDASSERT((ulBlock >= gpRedCoreVol->ulFirstAllocableBN) && (ulBlock < gpRedVolume->ulBlockCount));
+
+    ulImapNode = (ulBlock - gpRedCoreVol->ulInodeTableStartBN) / IMAPNODE_ENTRIES;
+    ulSummary = ulImapNode / gpRedCoreVol->ulImapNodesPerSummary;
+
+    if(gpRedCoreVol->aulSummaryFree[ulSummary] == IMAP_SUMMARY_UNKNOWN)
+    {
+        /*  Not counted yet; the count will include this change when it is.
+        */
+    }
+    else if(state == ALLOCSTATE_NEW)
+    {
+        REDASSERT(gpRedCoreVol->aulSummaryFree[ulSummary] > 0U);
+        gpRedCoreVol->aulSummaryFree[ulSummary]--;
+    }
+    else if(state == ALLOCSTATE_FREE)
+    {
+        gpRedCoreVol->aulSummaryFree[ulSummary]++;
+    }
+    else if(state == ALLOCSTATE_AFREE)
+    {
+        gpRedCoreVol->aulSummaryAlmostFree[ulSummary]++;
+    }
+    else
+    {
+        REDERROR();
+    }
+}
+
+
+/** @brief Update the free block summary for a transaction point.
+
+    Blocks which were almost free become free once the transaction point has
+    made their old contents unreachable.
+*/
+void RedImapESummaryTransact(void)
+{
+    uint32_t ulSummary;
+
+    for(ulSummary = 0U; ulSummary < IMAP_SUMMARY_ENTRIES; ulSummary++)
+    {
+        if(gpRedCoreVol->aulSummaryFree[ulSummary] != IMAP_SUMMARY_UNKNOWN)
+        {
+            gpRedCoreVol->aulSummaryFree[ulSummary] += gpRedCoreVol->aulSummaryAlmostFree[ulSummary];
+            gpRedCoreVol->aulSummaryAlmostFree[ulSummary] = 0U;
+        }
+    }
+}
+
+
+/** @brief Count the free and almost free blocks for an entry of the free block
+           summary.
+
+    @param ulSummary    The summary entry to count.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EIO    A disk I/O error occurred.
+*/
+static REDSTATUS ImapSummaryCount(
+    uint32_t    ulSummary)
+{
+    REDSTATUS   ret = 0;
+    uint32_t    ulImapNode = ulSummary * gpRedCoreVol->ulImapNodesPerSummary;
+    uint32_t    ulImapNodeEnd = REDMIN(ulImapNode + gpRedCoreVol->ulImapNodesPerSummary, gpRedCoreVol->ulImapNodeCount);
+    uint32_t    ulFree = 0U;
+    uint32_t    ulAlmostFree = 0U;
+
+    REDASSERT(ulSummary < IMAP_SUMMARY_ENTRIES);
+
+    while((ret == 0) && (ulImapNode < ulImapNodeEnd))
+    {
+        uint32_t ulNodeStart = gpRedCoreVol->ulInodeTableStartBN + (ulImapNode * IMAPNODE_ENTRIES);
+        uint32_t ulEntryStart = 0U;
+        uint32_t ulEntryEnd = REDMIN(gpRedVolume->ulBlockCount - ulNodeStart, IMAPNODE_ENTRIES);
+
+        /*  Only allocable blocks are counted, so skip the inode table.
+        */
+        if(ulNodeStart < gpRedCoreVol->ulFirstAllocableBN)
+        {
+            ulEntryStart = REDMIN(gpRedCoreVol->ulFirstAllocableBN - ulNodeStart, ulEntryEnd);
+        }
+
+        if(ulEntryStart < ulEntryEnd)
+        {
+            uint32_t ulNodeFree;
+            uint32_t ulNodeAlmostFree;
+
+            ret = ImapNodeScan(ulImapNode, ulEntryStart, ulEntryEnd, NULL, &ulNodeFree, &ulNodeAlmostFree);
+
+            if(ret == 0)
+            {
+                ulFree += ulNodeFree;
+                ulAlmostFree += ulNodeAlmostFree;
+            }
+        }
+
+        ulImapNode++;
+    }
+
+    if(ret == 0)
+    {
+        gpRedCoreVol->aulSummaryFree[ulSummary] = ulFree;
+        gpRedCoreVol->aulSummaryAlmostFree[ulSummary] = ulAlmostFree;
+    }
+
+    return ret;
+}
+#endif /* IMAP_SUMMARY_ENTRIES > 0U */
+
+
 /** @brief Branch an imap node and get a buffer for it.
 
     If the imap node is already branched, it can be overwritten in its current
@@ -267,6 +521,126 @@ static bool ImapNodeIsBranched(
     */
     return fNodeBitSetInMetaroot0 != fNodeBitSetInMetaroot1;
 }
+
+
+/** @brief Find or count the free blocks in a range of an imap node.
+
+    Either finds the first free block, if @p pulEntry is non-`NULL`; or counts
+    the free and almost free blocks, if @p pulFree and @p pulAlmostFree are
+    non-`NULL`.
+
+    @param ulImapNode       The imap node to examine.
+    @param ulEntryStart     The first entry of the imap node to examine.
+    @param ulEntryEnd       One past the last entry of the imap node to examine.
+    @param pulEntry         If non-`NULL`, populated with the first free entry
+                            in the range, or with @p ulEntryEnd if there are no
+                            free entries in the range.
+    @param pulFree          If non-`NULL`, populated with the number of free
+                            entries in the range.
+    @param pulAlmostFree    If non-`NULL`, populated with the number of almost
+                            free entries in the range.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EIO    A disk I/O error occurred.
+*/
+static REDSTATUS ImapNodeScan(
+    uint32_t    ulImapNode,
+    uint32_t    ulEntryStart,
+    uint32_t    ulEntryEnd,
+    uint32_t   *pulEntry,
+    uint32_t   *pulFree,
+    uint32_t   *pulAlmostFree)
+{
+    REDSTATUS   ret = 0;
+    bool        fBranched = ImapNodeIsBranched(ulImapNode);
+    uint32_t    ulEntry = ulEntryStart;
+
+    REDASSERT((ulEntryStart <= ulEntryEnd) && (ulEntryEnd <= IMAPNODE_ENTRIES));
+    REDASSERT((pulEntry != NULL) || ((pulFree != NULL) && (pulAlmostFree != NULL)));
+
+    if(pulEntry != NULL)
+    {
+        *pulEntry = ulEntryEnd;
+    }
+    else
+    {
+        *pulFree = 0U;
+        *pulAlmostFree = 0U;
+    }
+
+    while((ret == 0) && (ulEntry < ulEntryEnd))
+    {
+        uint32_t    ulByte = ulEntry >> 3U;
+        uint32_t    ulChunkEnd = ulEntryEnd;
+        uint8_t     abCommitted[IMAP_SCAN_BYTES];
+        IMAPNODE   *pImap;
+
+        /*  If the node is branched, copy out part of the committed state copy,
+            to be combined with the same part of the working state copy.
+        */
+        if(fBranched)
+        {
+            uint32_t ulByteEnd = REDMIN(ulByte + IMAP_SCAN_BYTES, (ulEntryEnd + 7U) >> 3U);
+
+            ulChunkEnd = REDMIN(ulEntryEnd, ulByteEnd << 3U);
+
+            ret = RedBufferGet(RedImapNodeBlock(1U - gpRedCoreVol->bCurMR, ulImapNode), BFLAG_META_IMAP, CAST_VOID_PTR_PTR(&pImap));
+
+            if(ret == 0)
+            {
+                RedMemCpy(abCommitted, &pImap->abEntries[ulByte], ulByteEnd - ulByte);
+
+                RedBufferPut(pImap);
+            }
+        }
+
+        if(ret == 0)
+        {
+            ret = RedBufferGet(RedImapNodeBlock(gpRedCoreVol->bCurMR, ulImapNode), BFLAG_META_IMAP, CAST_VOID_PTR_PTR(&pImap));
+        }
+
+        if(ret == 0)
+        {
+            const uint8_t  *pbWorking = &pImap->abEntries[ulByte];
+            const uint8_t  *pbCommitted = fBranched ? abCommitted : pbWorking;
+            uint32_t        ulBitStart = ulEntry - (ulByte << 3U);
+            uint32_t        ulBitEnd = ulChunkEnd - (ulByte << 3U);
+
+            if(pulEntry != NULL)
+            {
+                uint32_t ulBit = RedBitFindClear(pbWorking, pbCommitted, ulBitStart, ulBitEnd);
+
+                if(ulBit < ulBitEnd)
+                {
+                    *pulEntry = (ulByte << 3U) + ulBit;
+                    ulChunkEnd = ulEntryEnd;
+                }
+            }
+            else
+            {
+                uint32_t ulFree = RedBitCountClear(pbWorking, pbCommitted, ulBitStart, ulBitEnd);
+
+                *pulFree += ulFree;
+
+                /*  Almost free blocks are clear in the working state but not
+                    in the committed state; unbranched nodes have none.
+                */
+                if(fBranched)
+                {
+                    *pulAlmostFree += RedBitCountClear(pbWorking, pbWorking, ulBitStart, ulBitEnd) - ulFree;
+                }
+            }
+
+            RedBufferPut(pImap);
+
+            ulEntry = ulChunkEnd;
+        }
+    }
+
+    return ret;
+}
 #endif /* REDCONF_READ_ONLY == 0 */
 
 
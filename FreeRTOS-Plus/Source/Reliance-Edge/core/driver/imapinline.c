@@ -127,6 +127,50 @@ REDSTATUS RedImapIBlockSet(
 
     return ret;
 }
+
+
+/** @brief Find the first free block in a range of the inline imap.
+
+    A block is free if it is clear in both metaroots.
+
+    @param ulBlockStart The first block to examine.
+    @param ulBlockEnd   One past the last block to examine.
+    @param pulBlock     On successful return, populated with the first free
+                        block in the range, or with @p ulBlockEnd if there are
+                        no free blocks in the range.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EINVAL The range is invalid; @p pulBlock is `NULL`; or the
+                        current volume does not use the inline imap.
+*/
+REDSTATUS RedImapIFindFree(
+    uint32_t    ulBlockStart,
+    uint32_t    ulBlockEnd,
+    uint32_t   *pulBlock)
+{
+    REDSTATUS   ret;
+
+    if(    (!gpRedCoreVol->fImapInline)
+        || (ulBlockStart < gpRedCoreVol->ulInodeTableStartBN)
+        || (ulBlockStart > ulBlockEnd)
+        || (ulBlockEnd > gpRedVolume->ulBlockCount)
+        || (pulBlock == NULL))
+    {
+        REDERROR();
+        ret = -RED_EINVAL;
+    }
+    else
+    {
+        uint32_t ulOffset = gpRedCoreVol->ulInodeTableStartBN;
+
+        *pulBlock = ulOffset + RedBitFindClear(gpRedCoreVol->aMR[0U].abEntries, gpRedCoreVol->aMR[1U].abEntries, ulBlockStart - ulOffset, ulBlockEnd - ulOffset);
+        ret = 0;
+    }
+
+    return ret;
+}
 #endif
 
 #endif /* REDCONF_IMAP_INLINE == 1 */
@@ -53,6 +53,33 @@ typedef enum
 } BRANCHDEPTH;
 
 
+#if REDCONF_READAHEAD_BLOCKS > 0U
+/*  The number of files whose reads are followed to detect sequential access.
+    When more files than this are being read, the one read least recently is
+    forgotten.
+*/
+#define READ_STREAM_COUNT 4U
+
+/*  The initial readahead window, in blocks.  The window doubles each time the
+    reader catches up with it, up to REDCONF_READAHEAD_BLOCKS.
+*/
+#define READ_WINDOW_INITIAL 2U
+
+
+/** @brief Sequential access state of a file being read.
+*/
+typedef struct
+{
+    uint32_t    ulInode;        /**< Inode number of the file; INODE_INVALID if the slot is unused. */
+    uint8_t     bVolNum;        /**< Volume the file resides on. */
+    uint64_t    ullNextOffset;  /**< Offset of the next read, if the file is read sequentially. */
+    uint32_t    ulAheadEnd;     /**< File block offset after the last block read ahead. */
+    uint32_t    ulWindow;       /**< Number of blocks to read ahead next time. */
+    uint32_t    ulLastUse;      /**< Value of gulReadStreamTick when the file was last read. */
+} READSTREAM;
+#endif
+
+
 #if REDCONF_READ_ONLY == 0
 #if DELETE_SUPPORTED || TRUNCATE_SUPPORTED
 static REDSTATUS Shrink(CINODE *pInode, uint64_t ullSize);
@@ -74,6 +101,10 @@ static REDSTATUS WriteUnaligned(CINODE *pInode, uint64_t ullStart, uint32_t ulLe
 static REDSTATUS WriteAligned(CINODE *pInode, uint32_t ulBlockStart, uint32_t *pulBlockCount, const uint8_t *pbBuffer);
 #endif
 static REDSTATUS GetExtent(CINODE *pInode, uint32_t ulBlockStart, uint32_t *pulExtentStart, uint32_t *pulExtentLen);
+#if REDCONF_READAHEAD_BLOCKS > 0U
+static void ReadAhead(CINODE *pInode, uint64_t ullStart, uint32_t ulLen);
+static READSTREAM *ReadStreamFind(uint32_t ulInode);
+#endif
 #if REDCONF_READ_ONLY == 0
 static REDSTATUS BranchBlock(CINODE *pInode, BRANCHDEPTH depth, bool fBuffer);
 static REDSTATUS BranchOneBlock(uint32_t *pulBlock, void **ppBuffer, uint16_t uBFlag);
@@ -82,6 +113,12 @@ static uint32_t FreeBlockCount(void);
 #endif
 
 
+#if REDCONF_READAHEAD_BLOCKS > 0U
+static READSTREAM gaReadStream[READ_STREAM_COUNT];
+static uint32_t gulReadStreamTick;
+#endif
+
+
 /** @brief Read data from an inode.
 
     @param pInode   A pointer to the cached inode structure of the inode from
@@ -138,6 +175,10 @@ REDSTATUS RedInodeDataRead(
 
         ulRemaining = ulLen;
 
+      #if REDCONF_READAHEAD_BLOCKS > 0U
+        ReadAhead(pInode, ullStart, ulLen);
+      #endif
+
         /*  Unaligned partial block at start.
         */
         if((ullStart & (REDCONF_BLOCK_SIZE - 1U)) != 0U)
@@ -1493,6 +1534,143 @@ static REDSTATUS GetExtent(
 }
 
 
+#if REDCONF_READAHEAD_BLOCKS > 0U
+/** @brief Read file data into the buffers ahead of a sequential reader.
+
+    Reads of less than a block are read through the buffers one block at a
+    time, so a file read that way in small pieces, such as a log file read a
+    line at a time, would otherwise wait on the disk once per block.  When
+    such a read starts where the previous read of the file left off, and needs
+    a block which has not been read ahead, that block and the ones after it, up
+    to the readahead window, are read with as few disk reads as their layout
+    on disk permits.  A read anywhere else is a seek, which cancels the
+    readahead until the reads are sequential again.
+
+    Longer reads are not read ahead: their whole blocks are read straight from
+    disk, an extent at a time, and do not go through the buffers.
+
+    The readahead is done synchronously, since the block device interface has
+    no asynchronous reads.  Errors are ignored: the blocks are read again when
+    they are needed, and any error is reported then.
+
+    @param pInode   A pointer to the cached inode structure of the file.
+    @param ullStart The file offset at which the read starts.
+    @param ulLen    The length of the read, which must not extend beyond the end
+                    of the file.
+*/
+static void ReadAhead(
+    CINODE     *pInode,
+    uint64_t    ullStart,
+    uint32_t    ulLen)
+{
+    READSTREAM *pStream = ReadStreamFind(pInode->ulInode);
+    uint64_t    ullEnd = ullStart + ulLen;
+
+    if(ullStart != pStream->ullNextOffset)
+    {
+        pStream->ulAheadEnd = 0U;
+        pStream->ulWindow = READ_WINDOW_INITIAL;
+    }
+    else if(ulLen < REDCONF_BLOCK_SIZE)
+    {
+        uint32_t ulBlock = (uint32_t)((ullEnd - 1U) >> BLOCK_SIZE_P2);
+
+        if(ulBlock >= pStream->ulAheadEnd)
+        {
+            uint32_t ulFileBlocks = (uint32_t)((pInode->pInodeBuf->ullSize + (REDCONF_BLOCK_SIZE - 1U)) >> BLOCK_SIZE_P2);
+            uint32_t ulWindow = REDMIN(pStream->ulWindow, REDCONF_READAHEAD_BLOCKS);
+            uint32_t ulAheadEnd = ulBlock + REDMIN(ulWindow, ulFileBlocks - ulBlock);
+            REDSTATUS ret = 0;
+
+            pStream->ulAheadEnd = ulAheadEnd;
+            pStream->ulWindow = ulWindow * 2U;
+
+            /*  Read the window an extent at a time.  Sparse blocks are skipped;
+                they read as zeros, without going to the disk.
+            */
+            while((ret == 0) && (ulBlock < ulAheadEnd))
+            {
+                uint32_t ulExtentStart;
+                uint32_t ulExtentLen = ulAheadEnd - ulBlock;
+
+                ret = GetExtent(pInode, ulBlock, &ulExtentStart, &ulExtentLen);
+
+                if(ret == 0)
+                {
+                    ret = RedBufferReadAhead(ulExtentStart, ulExtentLen);
+                    ulBlock += ulExtentLen;
+                }
+                else if(ret == -RED_ENODATA)
+                {
+                    ret = 0;
+                    ulBlock++;
+                }
+                else
+                {
+                    /*  An unexpected error occurred; the loop will terminate.
+                    */
+                }
+            }
+        }
+    }
+    else
+    {
+        /*  Long sequential read, no readahead.
+        */
+    }
+
+    pStream->ullNextOffset = ullEnd;
+}
+
+
+/** @brief Find the sequential access state of a file being read.
+
+    @param ulInode  The inode number of the file, on the active volume.
+
+    @return The state of the file.  If the file was not being followed, the
+            state of the file read least recently is taken over for it, and
+            the next read is expected at offset zero, so that a file read from
+            the beginning is read ahead straight away.
+*/
+static READSTREAM *ReadStreamFind(
+    uint32_t    ulInode)
+{
+    READSTREAM *pStream = &gaReadStream[0U];
+    uint32_t    ulIdx;
+
+    for(ulIdx = 0U; ulIdx < READ_STREAM_COUNT; ulIdx++)
+    {
+        READSTREAM *pThis = &gaReadStream[ulIdx];
+
+        if((pThis->ulInode == ulInode) && (pThis->bVolNum == gbRedVolNum))
+        {
+            pStream = pThis;
+            break;
+        }
+
+        if((pThis->ulInode == INODE_INVALID) || ((pStream->ulInode != INODE_INVALID) && (pThis->ulLastUse < pStream->ulLastUse)))
+        {
+            pStream = pThis;
+        }
+    }
+
+    if(ulIdx == READ_STREAM_COUNT)
+    {
+        pStream->ulInode = ulInode;
+        pStream->bVolNum = gbRedVolNum;
+        pStream->ullNextOffset = 0U;
+        pStream->ulAheadEnd = 0U;
+        pStream->ulWindow = READ_WINDOW_INITIAL;
+    }
+
+    gulReadStreamTick++;
+    pStream->ulLastUse = gulReadStreamTick;
+
+    return pStream;
+}
+#endif /* REDCONF_READAHEAD_BLOCKS > 0U */
+
+
 #if REDCONF_READ_ONLY == 0
 /** @brief Allocate or branch the file metadata path and data block if necessary.
 
@@ -261,6 +261,10 @@ REDSTATUS RedVolMountMetaroot(void)
       #endif
         gpRedCoreVol->ulAlmostFreeBlocks = 0U;
 
+      #if IMAP_SUMMARY_ENTRIES > 0U
+        RedImapESummaryReset();
+      #endif
+
         gpRedCoreVol->aMR[1U - gpRedCoreVol->bCurMR] = *gpRedMR;
         gpRedCoreVol->bCurMR = 1U - gpRedCoreVol->bCurMR;
         gpRedMR = &gpRedCoreVol->aMR[gpRedCoreVol->bCurMR];
@@ -362,6 +366,10 @@ REDSTATUS RedVolTransact(void)
         gpRedMR->ulFreeBlocks += gpRedCoreVol->ulAlmostFreeBlocks;
         gpRedCoreVol->ulAlmostFreeBlocks = 0U;
 
+      #if IMAP_SUMMARY_ENTRIES > 0U
+        RedImapESummaryTransact();
+      #endif
+
         ret = RedBufferFlush(0U, gpRedVolume->ulBlockCount);
 
         if(ret == 0)
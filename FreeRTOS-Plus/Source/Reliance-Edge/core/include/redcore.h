@@ -91,6 +91,9 @@ REDSTATUS RedIoFlush(uint8_t bVolNum);
 void RedBufferInit(void);
 REDSTATUS RedBufferGet(uint32_t ulBlock, uint16_t uFlags, void **ppBuffer);
 void RedBufferPut(const void *pBuffer);
+#if REDCONF_READAHEAD_BLOCKS > 0U
+REDSTATUS RedBufferReadAhead(uint32_t ulBlockStart, uint32_t ulBlockCount);
+#endif
 #if REDCONF_READ_ONLY == 0
 REDSTATUS RedBufferFlush(uint32_t ulBlockStart, uint32_t ulBlockCount);
 void RedBufferDirty(const void *pBuffer);
@@ -122,11 +125,22 @@ REDSTATUS RedImapBlockState(uint32_t ulBlock, ALLOCSTATE *pState);
 #if REDCONF_IMAP_INLINE == 1
 REDSTATUS RedImapIBlockGet(uint8_t bMR, uint32_t ulBlock, bool *pfAllocated);
 REDSTATUS RedImapIBlockSet(uint32_t ulBlock, bool fAllocated);
+#if REDCONF_READ_ONLY == 0
+REDSTATUS RedImapIFindFree(uint32_t ulBlockStart, uint32_t ulBlockEnd, uint32_t *pulBlock);
+#endif
 #endif
 
 #if REDCONF_IMAP_EXTERNAL == 1
 REDSTATUS RedImapEBlockGet(uint8_t bMR, uint32_t ulBlock, bool *pfAllocated);
 REDSTATUS RedImapEBlockSet(uint32_t ulBlock, bool fAllocated);
+#if REDCONF_READ_ONLY == 0
+REDSTATUS RedImapEFindFree(uint32_t ulBlockStart, uint32_t ulBlockEnd, uint32_t *pulBlock);
+#endif
+#if IMAP_SUMMARY_ENTRIES > 0U
+void RedImapESummaryReset(void);
+void RedImapESummaryUpdate(uint32_t ulBlock, ALLOCSTATE state);
+void RedImapESummaryTransact(void);
+#endif
 uint32_t RedImapNodeBlock(uint8_t bMR, uint32_t ulImapNode);
 #endif
 
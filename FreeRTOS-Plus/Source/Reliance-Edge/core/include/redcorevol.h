@@ -28,6 +28,21 @@
 #define REDCOREVOL_H
 
 
+/*  The free block summary is only needed to allocate blocks, and only helps
+    when the imap is spread over many imap nodes.
+*/
+#if (REDCONF_READ_ONLY == 0) && (REDCONF_IMAP_EXTERNAL == 1)
+  #define IMAP_SUMMARY_ENTRIES REDCONF_IMAP_SUMMARY_ENTRIES
+#else
+  #define IMAP_SUMMARY_ENTRIES 0U
+#endif
+
+/*  Value of a free block summary entry which has not been counted since the
+    volume was mounted.
+*/
+#define IMAP_SUMMARY_UNKNOWN UINT32_MAX
+
+
 /** @brief Per-volume run-time data specific to the core.
 */
 typedef struct
@@ -48,6 +63,24 @@ typedef struct
     uint32_t    ulImapNodeCount;
 #endif
 
+#if IMAP_SUMMARY_ENTRIES > 0U
+    /** The number of consecutive imap nodes covered by each entry of the free
+        block summary.  Valid only when fImapInline is false.
+    */
+    uint32_t    ulImapNodesPerSummary;
+
+    /** For each group of imap nodes, the number of allocable blocks which are
+        free, or #IMAP_SUMMARY_UNKNOWN if they have not been counted since the
+        volume was mounted.  Lets the allocator skip groups with no free blocks.
+    */
+    uint32_t    aulSummaryFree[IMAP_SUMMARY_ENTRIES];
+
+    /** For each group of imap nodes whose entry in aulSummaryFree[] is known,
+        the number of blocks which will become free after the next transaction.
+    */
+    uint32_t    aulSummaryAlmostFree[IMAP_SUMMARY_ENTRIES];
+#endif
+
     /** Block number where the inode table starts.
     */
     uint32_t    ulInodeTableStartBN;
@@ -305,6 +305,17 @@
   #error "Configuration error: At least one of REDCONF_IMAP_INLINE and REDCONF_IMAP_EXTERNAL must be set"
 #endif
 
+/*  REDCONF_IMAP_SUMMARY_ENTRIES is optional.  It is the number of free block
+    counts kept in RAM for each volume with an external imap, which let block
+    allocation skip over full imap nodes; zero disables them.
+*/
+#ifndef REDCONF_IMAP_SUMMARY_ENTRIES
+  #define REDCONF_IMAP_SUMMARY_ENTRIES 32U
+#endif
+#if REDCONF_IMAP_SUMMARY_ENTRIES > 65535U
+  #error "REDCONF_IMAP_SUMMARY_ENTRIES cannot be greater than 65535"
+#endif
+
 #if (REDCONF_OUTPUT != 0) && (REDCONF_OUTPUT != 1)
   #error "Configuration error: REDCONF_OUTPUT must be either 0 or 1."
 #endif
@@ -326,8 +337,34 @@
 
 /*  REDCONF_BUFFER_COUNT lower limit checked in buffer.c
 */
-#if REDCONF_BUFFER_COUNT > 255U
-  #error "REDCONF_BUFFER_COUNT cannot be greater than 255"
+#if REDCONF_BUFFER_COUNT > 65535U
+  #error "REDCONF_BUFFER_COUNT cannot be greater than 65535"
+#endif
+
+/*  REDCONF_WRITEBACK_BLOCKS and REDCONF_READAHEAD_BLOCKS are optional, so that
+    existing configurations need not be changed; when they are not defined,
+    both are limited to a small fraction of the buffers.
+*/
+#ifndef REDCONF_WRITEBACK_BLOCKS
+  #if REDCONF_BUFFER_COUNT < 8U
+    #define REDCONF_WRITEBACK_BLOCKS REDCONF_BUFFER_COUNT
+  #else
+    #define REDCONF_WRITEBACK_BLOCKS 8U
+  #endif
+#endif
+#if (REDCONF_WRITEBACK_BLOCKS < 1U) || (REDCONF_WRITEBACK_BLOCKS > REDCONF_BUFFER_COUNT) || (REDCONF_WRITEBACK_BLOCKS > 255U)
+  #error "REDCONF_WRITEBACK_BLOCKS must be between 1 and the lesser of REDCONF_BUFFER_COUNT and 255"
+#endif
+
+#ifndef REDCONF_READAHEAD_BLOCKS
+  #if REDCONF_BUFFER_COUNT < 32U
+    #define REDCONF_READAHEAD_BLOCKS (REDCONF_BUFFER_COUNT / 4U)
+  #else
+    #define REDCONF_READAHEAD_BLOCKS 8U
+  #endif
+#endif
+#if (REDCONF_READAHEAD_BLOCKS > (REDCONF_BUFFER_COUNT / 2U)) || (REDCONF_READAHEAD_BLOCKS > 255U)
+  #error "REDCONF_READAHEAD_BLOCKS cannot be greater than half of REDCONF_BUFFER_COUNT, or than 255"
 #endif
 
 #if (REDCONF_IMAGE_BUILDER != 0) && (REDCONF_IMAGE_BUILDER != 1)
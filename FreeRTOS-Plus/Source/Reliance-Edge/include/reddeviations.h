@@ -220,5 +220,27 @@
 #define IS_ALIGNED_PTR(ptr) (((uintptr_t)(ptr) & (REDCONF_ALIGNMENT_SIZE - 1U)) == 0U)
 
 
+/** @brief Compute the distance in bytes from one pointer to another.
+
+    This is used by the block buffer module to derive the index of a buffer from
+    a buffer pointer in constant time, rather than by comparing the pointer with
+    every buffer in turn, which is slow when there are many buffers.
+
+    Subtracting the pointers themselves would deviate from MISRA C:2012 Rule
+    18.2 (required) and be undefined unless both pointed into the same array,
+    which is exactly what the caller is trying to find out.  Instead the
+    pointers are converted to integers, so usage of this macro deviates from
+    MISRA C:2012 Rule 11.4 (advisory), for the same reasons and with the same
+    justification as IS_ALIGNED_PTR(): the integer values are not converted back
+    into pointers, and the caller confirms any result by comparing the original
+    pointer with the buffer pointer at the derived index.
+
+    As Rule 11.4 is advisory, a deviation record is not required.  This notice
+    and the PC-Lint error inhibition option are the only records of the
+    deviation.
+*/
+#define PTR_BYTE_OFFSET(ptr, base) ((uintptr_t)(ptr) - (uintptr_t)(base))
+
+
 #endif
 
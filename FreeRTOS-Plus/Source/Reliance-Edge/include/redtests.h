@@ -45,6 +45,11 @@
       && (REDCONF_API_POSIX_RMDIR == 1) && (REDCONF_API_POSIX_RENAME == 1) && (REDCONF_API_POSIX_LINK == 1) \
       && (REDCONF_API_POSIX_FTRUNCATE == 1) && (REDCONF_API_POSIX_READDIR == 1))
 
+#define FSBENCH_SUPPORTED \
+    (    ((RED_KIT == RED_KIT_GPL) || (RED_KIT == RED_KIT_SANDBOX)) \
+      && (REDCONF_OUTPUT == 1) && (REDCONF_READ_ONLY == 0) && (REDCONF_API_POSIX == 1) \
+      && (REDCONF_API_POSIX_UNLINK == 1) && (REDCONF_API_POSIX_MKDIR == 1) && (REDCONF_API_POSIX_RMDIR == 1))
+
 #define FSE_STRESS_TEST_SUPPORTED \
     (    ((RED_KIT == RED_KIT_COMMERCIAL) || (RED_KIT == RED_KIT_SANDBOX)) \
       && (REDCONF_OUTPUT == 1) && (REDCONF_READ_ONLY == 0) && (REDCONF_API_FSE == 1) \
@@ -106,6 +111,23 @@ void FsstressDefaultParams(FSSTRESSPARAM *pParam);
 int FsstressStart(const FSSTRESSPARAM *pParam);
 #endif
 
+#if FSBENCH_SUPPORTED
+typedef struct
+{
+    const char *pszVolume;      /**< Volume path prefix. */
+    uint32_t    ulFileSize;     /**< --size */
+    uint32_t    ulIoSize;       /**< --io-size */
+    uint32_t    ulRandomOps;    /**< --rand */
+    uint32_t    ulFileCount;    /**< --files */
+    uint32_t    ulSeed;         /**< --seed */
+    uint32_t    ulFillPercent;  /**< --fill */
+} FSBENCHPARAM;
+
+PARAMSTATUS FsBenchParseParams(int argc, char *argv[], FSBENCHPARAM *pParam, uint8_t *pbVolNum, const char **ppszDevice);
+void FsBenchDefaultParams(FSBENCHPARAM *pParam);
+int FsBenchStart(const FSBENCHPARAM *pParam);
+#endif
+
 #if STOCH_POSIX_TEST_SUPPORTED
 typedef struct
 {
@@ -102,6 +102,22 @@
 */
 #define BDEV_RAM_DISK       (4U)
 
+/** @brief The memory-mapped disk image example implementation.
+
+    This implementation is for FreeRTOS running as a process on a POSIX host,
+    such as the FreeRTOS Linux simulator, and for host tools which build or
+    check disk images.  Each volume is a disk image file which is mapped into
+    memory, so reads and writes are memory copies rather than system calls, and
+    a flush is an msync() of the range written since the last flush.  Unlike
+    the RAM disk, the data survives the process, and the image can be copied to
+    real storage.
+
+    Since errors accessing a mapped file are reported by signals rather than by
+    return values, this implementation is meant for testing and tooling, not
+    for storage whose errors the file system must handle.
+*/
+#define BDEV_MMAP_FILE      (5U)
+
 /** @brief Pick which example implementation is compiled.
 
     Must be one of:
@@ -110,6 +126,7 @@
     - #BDEV_ATMEL_SDMMC
     - #BDEV_STM32_SDIO
     - #BDEV_RAM_DISK
+    - #BDEV_MMAP_FILE
 */
 #define BDEV_EXAMPLE_IMPLEMENTATION BDEV_RAM_DISK
 
@@ -1545,6 +1562,322 @@ static REDSTATUS DiskFlush(
 }
 #endif /* REDCONF_READ_ONLY == 0 */
 
+#elif BDEV_EXAMPLE_IMPLEMENTATION == BDEV_MMAP_FILE
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdint.h> /* For SIZE_MAX. */
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+/*  Name of the disk image file of a volume, relative to the current directory.
+    The %u is replaced by the volume number.
+*/
+#define MMAP_IMAGE_NAME "redvol%u.img"
+
+
+/** @brief A disk image mapped into memory.
+*/
+typedef struct
+{
+    uint8_t    *pbMap;          /**< The mapped disk image; `NULL` if the disk is closed. */
+    size_t      nSize;          /**< The size of the disk image, in bytes. */
+    uint64_t    ullDirtyStart;  /**< Offset of the first byte written since the last flush. */
+    uint64_t    ullDirtyEnd;    /**< Offset after the last byte written since the last flush; zero if none. */
+} MMAPDISK;
+
+
+static MMAPDISK gaMmapDisk[REDCONF_VOLUME_COUNT];
+
+
+/** @brief Initialize a disk.
+
+    The disk image file is created if it does not exist, and extended if it is
+    smaller than the volume, unless the disk is opened read-only.
+
+    @param bVolNum  The volume number of the volume whose block device is being
+                    initialized.
+    @param mode     The open mode, indicating the type of access required.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EINVAL The volume is too large to be mapped into memory.
+    @retval -RED_EIO    A disk I/O error occurred.
+*/
+static REDSTATUS DiskOpen(
+    uint8_t         bVolNum,
+    BDEVOPENMODE    mode)
+{
+    REDSTATUS       ret = 0;
+    MMAPDISK       *pDisk = &gaMmapDisk[bVolNum];
+    uint64_t        ullSize = gaRedVolConf[bVolNum].ullSectorCount * gaRedVolConf[bVolNum].ulSectorSize;
+    bool            fReadOnly = (mode == BDEV_O_RDONLY);
+
+    if(ullSize > (uint64_t)SIZE_MAX)
+    {
+        ret = -RED_EINVAL;
+    }
+    else
+    {
+        char    szName[sizeof(MMAP_IMAGE_NAME) + 3U];
+        int     iFd;
+
+        (void)snprintf(szName, sizeof(szName), MMAP_IMAGE_NAME, (unsigned)bVolNum);
+
+        /*  A shared writable mapping needs a file opened for both reading and
+            writing, so write-only is opened the same as read-write.
+        */
+        iFd = open(szName, fReadOnly ? O_RDONLY : (O_RDWR | O_CREAT), 0644);
+        if(iFd < 0)
+        {
+            ret = -RED_EIO;
+        }
+        else
+        {
+            struct stat st;
+
+            if(fstat(iFd, &st) != 0)
+            {
+                ret = -RED_EIO;
+            }
+            else if((uint64_t)st.st_size < ullSize)
+            {
+                /*  Extending the file leaves a sparse file, so a new image
+                    takes no more space on the host than the data written to
+                    it.
+                */
+                if(fReadOnly || (ftruncate(iFd, (off_t)ullSize) != 0))
+                {
+                    ret = -RED_EIO;
+                }
+            }
+            else
+            {
+                /*  The image is large enough.
+                */
+            }
+
+            if(ret == 0)
+            {
+                void *pMap = mmap(NULL, (size_t)ullSize, fReadOnly ? PROT_READ : (PROT_READ | PROT_WRITE), MAP_SHARED, iFd, 0);
+
+                if(pMap == MAP_FAILED)
+                {
+                    ret = -RED_EIO;
+                }
+                else
+                {
+                    pDisk->pbMap = CAST_VOID_PTR_TO_UINT8_PTR(pMap);
+                    pDisk->nSize = (size_t)ullSize;
+                    pDisk->ullDirtyStart = 0U;
+                    pDisk->ullDirtyEnd = 0U;
+                }
+            }
+
+            /*  The mapping does not need the file descriptor to stay open.
+            */
+            (void)close(iFd);
+        }
+    }
+
+    return ret;
+}
+
+
+/** @brief Uninitialize a disk.
+
+    @param bVolNum  The volume number of the volume whose block device is being
+                    uninitialized.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EINVAL The disk is not open.
+    @retval -RED_EIO    A disk I/O error occurred.
+*/
+static REDSTATUS DiskClose(
+    uint8_t     bVolNum)
+{
+    REDSTATUS   ret = 0;
+    MMAPDISK   *pDisk = &gaMmapDisk[bVolNum];
+
+    if(pDisk->pbMap == NULL)
+    {
+        ret = -RED_EINVAL;
+    }
+    else
+    {
+        /*  Data written but not flushed is not lost by unmapping: it is in the
+            host's page cache, which writes it to the image in due course.
+        */
+        if(munmap(pDisk->pbMap, pDisk->nSize) != 0)
+        {
+            ret = -RED_EIO;
+        }
+
+        pDisk->pbMap = NULL;
+    }
+
+    return ret;
+}
+
+
+/** @brief Read sectors from a disk.
+
+    @param bVolNum          The volume number of the volume whose block device
+                            is being read from.
+    @param ullSectorStart   The starting sector number.
+    @param ulSectorCount    The number of sectors to read.
+    @param pBuffer          The buffer into which to read the sector data.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EINVAL The disk is not open.
+*/
+static REDSTATUS DiskRead(
+    uint8_t     bVolNum,
+    uint64_t    ullSectorStart,
+    uint32_t    ulSectorCount,
+    void       *pBuffer)
+{
+    REDSTATUS   ret;
+    MMAPDISK   *pDisk = &gaMmapDisk[bVolNum];
+
+    if(pDisk->pbMap == NULL)
+    {
+        ret = -RED_EINVAL;
+    }
+    else
+    {
+        uint64_t ullByteOffset = ullSectorStart * gaRedVolConf[bVolNum].ulSectorSize;
+        uint32_t ulByteCount = ulSectorCount * gaRedVolConf[bVolNum].ulSectorSize;
+
+        RedMemCpy(pBuffer, &pDisk->pbMap[ullByteOffset], ulByteCount);
+
+        ret = 0;
+    }
+
+    return ret;
+}
+
+
+#if REDCONF_READ_ONLY == 0
+/** @brief Write sectors to a disk.
+
+    @param bVolNum          The volume number of the volume whose block device
+                            is being written to.
+    @param ullSectorStart   The starting sector number.
+    @param ulSectorCount    The number of sectors to write.
+    @param pBuffer          The buffer from which to write the sector data.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EINVAL The disk is not open.
+*/
+static REDSTATUS DiskWrite(
+    uint8_t     bVolNum,
+    uint64_t    ullSectorStart,
+    uint32_t    ulSectorCount,
+    const void *pBuffer)
+{
+    REDSTATUS   ret;
+    MMAPDISK   *pDisk = &gaMmapDisk[bVolNum];
+
+    if(pDisk->pbMap == NULL)
+    {
+        ret = -RED_EINVAL;
+    }
+    else
+    {
+        uint64_t ullByteOffset = ullSectorStart * gaRedVolConf[bVolNum].ulSectorSize;
+        uint32_t ulByteCount = ulSectorCount * gaRedVolConf[bVolNum].ulSectorSize;
+
+        RedMemCpy(&pDisk->pbMap[ullByteOffset], pBuffer, ulByteCount);
+
+        /*  Remember the range written, so that a flush only has to sync that
+            part of the image.
+        */
+        if(pDisk->ullDirtyEnd == 0U)
+        {
+            pDisk->ullDirtyStart = ullByteOffset;
+            pDisk->ullDirtyEnd = ullByteOffset + ulByteCount;
+        }
+        else
+        {
+            if(ullByteOffset < pDisk->ullDirtyStart)
+            {
+                pDisk->ullDirtyStart = ullByteOffset;
+            }
+
+            if((ullByteOffset + ulByteCount) > pDisk->ullDirtyEnd)
+            {
+                pDisk->ullDirtyEnd = ullByteOffset + ulByteCount;
+            }
+        }
+
+        ret = 0;
+    }
+
+    return ret;
+}
+
+
+/** @brief Flush any caches beneath the file system.
+
+    The part of the image written since the last flush is synchronously written
+    to the image file.
+
+    @param bVolNum  The volume number of the volume whose block device is being
+                    flushed.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EINVAL The disk is not open.
+    @retval -RED_EIO    A disk I/O error occurred.
+*/
+static REDSTATUS DiskFlush(
+    uint8_t     bVolNum)
+{
+    REDSTATUS   ret = 0;
+    MMAPDISK   *pDisk = &gaMmapDisk[bVolNum];
+
+    if(pDisk->pbMap == NULL)
+    {
+        ret = -RED_EINVAL;
+    }
+    else if(pDisk->ullDirtyEnd != 0U)
+    {
+        /*  msync() needs a page aligned address.
+        */
+        uint64_t ullPageSize = (uint64_t)sysconf(_SC_PAGESIZE);
+        uint64_t ullStart = pDisk->ullDirtyStart - (pDisk->ullDirtyStart % ullPageSize);
+
+        if(msync(&pDisk->pbMap[ullStart], (size_t)(pDisk->ullDirtyEnd - ullStart), MS_SYNC) != 0)
+        {
+            ret = -RED_EIO;
+        }
+        else
+        {
+            pDisk->ullDirtyStart = 0U;
+            pDisk->ullDirtyEnd = 0U;
+        }
+    }
+    else
+    {
+        /*  Nothing was written since the last flush.
+        */
+    }
+
+    return ret;
+}
+#endif /* REDCONF_READ_ONLY == 0 */
+
 #else
 
 #error "Invalid BDEV_EXAMPLE_IMPLEMENTATION value"
@@ -0,0 +1,885 @@
+/*             ----> DO NOT REMOVE THE FOLLOWING NOTICE <----
+
+                   Copyright (c) 2014-2015 Datalight, Inc.
+                       All Rights Reserved Worldwide.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; use version 2 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but "AS-IS," WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+/*  Businesses and individuals that for commercial or other reasons cannot
+    comply with the terms of the GPLv2 license may obtain a commercial license
+    before incorporating Reliance Edge into proprietary software for
+    distribution in any form.  Visit http://www.datalight.com/reliance-edge for
+    more information.
+*/
+/** @file
+    @brief File system throughput benchmark.
+
+    Measures the throughput of the POSIX-like API for sequential writes and
+    reads of a large file, random reads and rewrites within that file, and the
+    creation, lookup, and deletion of many small files.  The file size and the
+    number of random operations are parameters, so the benchmark can be run
+    with a working set which fits in the block buffers and again with one which
+    does not, to measure the buffer cache.  The volume can also be filled with a
+    ballast file before the benchmark runs, to measure block allocation on a
+    nearly full volume.
+*/
+#include <stdlib.h>
+
+#include <redposix.h>
+#include <redtests.h>
+
+#if FSBENCH_SUPPORTED
+
+#include <redosserv.h>
+#include <redutils.h>
+#include <redmacs.h>
+#include <redvolume.h>
+#include <redgetopt.h>
+#include <redtoolcmn.h>
+
+
+#define FSBENCH_FILE_NAME   "fsbench.dat"
+#define FSBENCH_DIR_NAME    "fsbench.dir"
+#define FSBENCH_FILL_NAME   "fsbench.fil"
+
+/*  Maximum length of a path constructed by the benchmark: the volume prefix,
+    the directory name, a file name, and separators.
+*/
+#define FSBENCH_PATH_MAX    (REDCONF_NAME_MAX + 64U)
+
+
+/** @brief State of a benchmark run.
+*/
+typedef struct
+{
+    const FSBENCHPARAM *pParam;     /**< Benchmark parameters. */
+    uint8_t            *pbBuffer;   /**< I/O buffer, FSBENCHPARAM::ulIoSize bytes. */
+    uint32_t            ulSeed;     /**< Random number generator state. */
+    char                szFile[FSBENCH_PATH_MAX];   /**< Path of the large file. */
+    char                szDir[FSBENCH_PATH_MAX];    /**< Path of the small file directory. */
+    char                szFill[FSBENCH_PATH_MAX];   /**< Path of the ballast file. */
+} FSBENCHCTX;
+
+
+static int32_t BenchFill(FSBENCHCTX *pCtx);
+static int32_t BenchSeqWrite(FSBENCHCTX *pCtx);
+static int32_t BenchSeqRead(FSBENCHCTX *pCtx);
+static int32_t BenchRandRead(FSBENCHCTX *pCtx);
+static int32_t BenchRandWrite(FSBENCHCTX *pCtx);
+static int32_t BenchSmallFiles(FSBENCHCTX *pCtx);
+static uint64_t BenchRandOffset(FSBENCHCTX *pCtx);
+static void BenchSmallFilePath(const FSBENCHCTX *pCtx, uint32_t ulFile, char *pszPath);
+static void BenchReport(const char *pszName, uint64_t ullBytes, uint32_t ulOps, uint64_t ullMicrosecs);
+static void usage(const char *pszProgName);
+
+
+/** @brief Parse parameters for the file system benchmark.
+
+    @param argc         The number of arguments from main().
+    @param argv         The vector of arguments from main().
+    @param pParam       Populated with the benchmark parameters.
+    @param pbVolNum     If non-NULL, populated with the volume number.
+    @param ppszDevice   If non-NULL, populated with the device name argument or
+                        NULL if no device argument is provided.
+
+    @return The result of parsing the parameters.
+*/
+PARAMSTATUS FsBenchParseParams(
+    int             argc,
+    char           *argv[],
+    FSBENCHPARAM   *pParam,
+    uint8_t        *pbVolNum,
+    const char    **ppszDevice)
+{
+    int             c;
+    uint8_t         bVolNum;
+    const REDOPTION aLongopts[] =
+    {
+        { "size", red_required_argument, NULL, 'z' },
+        { "io-size", red_required_argument, NULL, 'i' },
+        { "rand", red_required_argument, NULL, 'r' },
+        { "files", red_required_argument, NULL, 'f' },
+        { "seed", red_required_argument, NULL, 's' },
+        { "fill", red_required_argument, NULL, 'F' },
+        { "dev", red_required_argument, NULL, 'D' },
+        { "help", red_no_argument, NULL, 'H' },
+        { NULL }
+    };
+
+    /*  If run without parameters, treat as a help request.
+    */
+    if(argc <= 1)
+    {
+        goto Help;
+    }
+
+    /*  Assume no device argument to start with.
+    */
+    if(ppszDevice != NULL)
+    {
+        *ppszDevice = NULL;
+    }
+
+    /*  Set default parameters.
+    */
+    FsBenchDefaultParams(pParam);
+
+    while((c = RedGetoptLong(argc, argv, "z:i:r:f:s:F:D:H", aLongopts, NULL)) != -1)
+    {
+        switch(c)
+        {
+            case 'z': /* --size */
+                if((RedSizeToUL(red_optarg, &pParam->ulFileSize) == NULL) || (pParam->ulFileSize == 0U))
+                {
+                    RedPrintf("Bad file size \"%s\"\n", red_optarg);
+                    goto BadOpt;
+                }
+                break;
+            case 'i': /* --io-size */
+                if((RedSizeToUL(red_optarg, &pParam->ulIoSize) == NULL) || (pParam->ulIoSize == 0U))
+                {
+                    RedPrintf("Bad I/O size \"%s\"\n", red_optarg);
+                    goto BadOpt;
+                }
+                break;
+            case 'r': /* --rand */
+                pParam->ulRandomOps = (uint32_t)RedAtoI(red_optarg);
+                break;
+            case 'f': /* --files */
+                pParam->ulFileCount = (uint32_t)RedAtoI(red_optarg);
+                break;
+            case 's': /* --seed */
+                pParam->ulSeed = (uint32_t)RedAtoI(red_optarg);
+                break;
+            case 'F': /* --fill */
+                pParam->ulFillPercent = (uint32_t)RedAtoI(red_optarg);
+                if(pParam->ulFillPercent >= 100U)
+                {
+                    RedPrintf("Bad fill percentage \"%s\"\n", red_optarg);
+                    goto BadOpt;
+                }
+                break;
+            case 'D': /* --dev */
+                if(ppszDevice != NULL)
+                {
+                    *ppszDevice = red_optarg;
+                }
+                break;
+            case 'H': /* --help */
+                goto Help;
+            case '?': /* Unknown or ambiguous option */
+            case ':': /* Option missing required argument */
+            default:
+                goto BadOpt;
+        }
+    }
+
+    if(pParam->ulIoSize > pParam->ulFileSize)
+    {
+        RedPrintf("The I/O size cannot be larger than the file size\n");
+        goto BadOpt;
+    }
+
+    /*  RedGetoptLong() has permuted argv to move all non-option arguments to
+        the end.  We expect to find a volume identifier.
+    */
+    if(red_optind >= argc)
+    {
+        RedPrintf("Missing volume argument\n");
+        goto BadOpt;
+    }
+
+    bVolNum = RedFindVolumeNumber(argv[red_optind]);
+    if(bVolNum == REDCONF_VOLUME_COUNT)
+    {
+        RedPrintf("Error: \"%s\" is not a valid volume identifier.\n", argv[red_optind]);
+        goto BadOpt;
+    }
+
+    pParam->pszVolume = gaRedVolConf[bVolNum].pszPathPrefix;
+
+    if(pbVolNum != NULL)
+    {
+        *pbVolNum = bVolNum;
+    }
+
+    red_optind++; /* Move past volume parameter. */
+    if(red_optind < argc)
+    {
+        int32_t ii;
+
+        for(ii = red_optind; ii < argc; ii++)
+        {
+            RedPrintf("Error: Unexpected command-line argument \"%s\".\n", argv[ii]);
+        }
+
+        goto BadOpt;
+    }
+
+    return PARAMSTATUS_OK;
+
+  BadOpt:
+
+    RedPrintf("%s - invalid parameters\n", argv[0U]);
+    usage(argv[0U]);
+    return PARAMSTATUS_BAD;
+
+  Help:
+
+    usage(argv[0U]);
+    return PARAMSTATUS_HELP;
+}
+
+
+/** @brief Set default file system benchmark parameters.
+
+    @param pParam   Populated with the default benchmark parameters.
+*/
+void FsBenchDefaultParams(
+    FSBENCHPARAM *pParam)
+{
+    RedMemSet(pParam, 0U, sizeof(*pParam));
+    pParam->pszVolume = gaRedVolConf[0U].pszPathPrefix;
+    pParam->ulFileSize = 1024U * 1024U;
+    pParam->ulIoSize = 4096U;
+    pParam->ulRandomOps = 1000U;
+    pParam->ulFileCount = 100U;
+    pParam->ulSeed = 1U;
+    pParam->ulFillPercent = 0U;
+}
+
+
+/** @brief Start the file system benchmark.
+
+    The volume must be mounted.  Files created by the benchmark are deleted
+    when it finishes.
+
+    @param pParam   Benchmark parameters, either from FsBenchParseParams() or
+                    constructed programatically.
+
+    @return Zero on success, otherwise nonzero.
+*/
+int FsBenchStart(
+    const FSBENCHPARAM *pParam)
+{
+    FSBENCHCTX          ctx;
+    int32_t             ret;
+
+    RedMemSet(&ctx, 0U, sizeof(ctx));
+    ctx.pParam = pParam;
+    ctx.ulSeed = pParam->ulSeed;
+
+    (void)RedSNPrintf(ctx.szFile, sizeof(ctx.szFile), "%s%c%s", pParam->pszVolume, REDCONF_PATH_SEPARATOR, FSBENCH_FILE_NAME);
+    (void)RedSNPrintf(ctx.szDir, sizeof(ctx.szDir), "%s%c%s", pParam->pszVolume, REDCONF_PATH_SEPARATOR, FSBENCH_DIR_NAME);
+    (void)RedSNPrintf(ctx.szFill, sizeof(ctx.szFill), "%s%c%s", pParam->pszVolume, REDCONF_PATH_SEPARATOR, FSBENCH_FILL_NAME);
+
+    ctx.pbBuffer = malloc(pParam->ulIoSize);
+    if(ctx.pbBuffer == NULL)
+    {
+        RedPrintf("Failed to allocate a %u byte I/O buffer\n", (unsigned)pParam->ulIoSize);
+        ret = -1;
+    }
+    else
+    {
+        uint32_t ulIdx;
+
+        for(ulIdx = 0U; ulIdx < pParam->ulIoSize; ulIdx++)
+        {
+            ctx.pbBuffer[ulIdx] = (uint8_t)ulIdx;
+        }
+
+        RedPrintf("File size %u bytes, I/O size %u bytes, %u random operations, %u small files\n",
+            (unsigned)pParam->ulFileSize, (unsigned)pParam->ulIoSize, (unsigned)pParam->ulRandomOps, (unsigned)pParam->ulFileCount);
+
+        ret = BenchFill(&ctx);
+
+        if(ret == 0)
+        {
+            ret = BenchSeqWrite(&ctx);
+        }
+
+        if(ret == 0)
+        {
+            ret = BenchSeqRead(&ctx);
+        }
+
+        if(ret == 0)
+        {
+            ret = BenchRandRead(&ctx);
+        }
+
+        if(ret == 0)
+        {
+            ret = BenchRandWrite(&ctx);
+        }
+
+        (void)red_unlink(ctx.szFile);
+
+        if(ret == 0)
+        {
+            ret = BenchSmallFiles(&ctx);
+        }
+
+        if(pParam->ulFillPercent > 0U)
+        {
+            (void)red_unlink(ctx.szFill);
+            (void)red_transact(pParam->pszVolume);
+        }
+
+        if(ret != 0)
+        {
+            RedPrintf("Benchmark failed, errno %d\n", (int)red_errno);
+        }
+
+        free(ctx.pbBuffer);
+    }
+
+    return (ret == 0) ? 0 : 1;
+}
+
+
+/** @brief Fill the volume with a ballast file.
+
+    The ballast file is sized so that the volume will be about
+    FSBENCHPARAM::ulFillPercent full once the large file has been written, so
+    that the benchmark phases allocate blocks from what little space remains.
+    Nothing is done if the fill percentage is zero.
+
+    @param pCtx The benchmark state.
+
+    @return Zero on success, otherwise -1.
+*/
+static int32_t BenchFill(
+    FSBENCHCTX     *pCtx)
+{
+    const FSBENCHPARAM *pParam = pCtx->pParam;
+    REDSTATFS       sfs;
+    int32_t         ret = 0;
+
+    if(pParam->ulFillPercent == 0U)
+    {
+        /*  No ballast requested.
+        */
+    }
+    else if(red_statvfs(pParam->pszVolume, &sfs) != 0)
+    {
+        ret = -1;
+    }
+    else
+    {
+        uint32_t    ulFileBlocks = (pParam->ulFileSize + (REDCONF_BLOCK_SIZE - 1U)) / REDCONF_BLOCK_SIZE;
+        uint32_t    ulUsedBlocks = (uint32_t)RedMulDiv64(sfs.f_blocks, pParam->ulFillPercent, 100U);
+        uint32_t    ulFillBlocks;
+        uint8_t    *pbBlock;
+        int32_t     iFildes = -1;
+
+        /*  Subtract the blocks already in use and those the large file will
+            need.  The ballast's own indirect nodes are not accounted for, so
+            the volume ends up slightly fuller than requested.
+        */
+        ulUsedBlocks -= REDMIN(ulUsedBlocks, sfs.f_blocks - sfs.f_bfree);
+        ulFillBlocks = ulUsedBlocks - REDMIN(ulUsedBlocks, ulFileBlocks);
+
+        pbBlock = malloc(REDCONF_BLOCK_SIZE);
+        if(pbBlock == NULL)
+        {
+            RedPrintf("Failed to allocate a %u byte ballast buffer\n", (unsigned)REDCONF_BLOCK_SIZE);
+        }
+        else
+        {
+            iFildes = red_open(pCtx->szFill, RED_O_WRONLY | RED_O_CREAT | RED_O_TRUNC);
+        }
+
+        if(iFildes >= 0)
+        {
+            uint32_t    ulBlock;
+
+            RedMemSet(pbBlock, 0xA5U, REDCONF_BLOCK_SIZE);
+
+            for(ulBlock = 0U; (ret == 0) && (ulBlock < ulFillBlocks); ulBlock++)
+            {
+                if(red_write(iFildes, pbBlock, REDCONF_BLOCK_SIZE) != (int32_t)REDCONF_BLOCK_SIZE)
+                {
+                    ret = -1;
+                }
+            }
+
+            if(red_close(iFildes) != 0)
+            {
+                ret = -1;
+            }
+        }
+        else
+        {
+            ret = -1;
+        }
+
+        free(pbBlock);
+
+        if((ret == 0) && (red_transact(pParam->pszVolume) != 0))
+        {
+            ret = -1;
+        }
+
+        if((ret == 0) && (red_statvfs(pParam->pszVolume, &sfs) == 0))
+        {
+            uint32_t ulFinalBlocks = REDMIN((sfs.f_blocks - sfs.f_bfree) + ulFileBlocks, sfs.f_blocks);
+
+            RedPrintf("Ballast %u KB, volume %u%% full once the large file is written\n",
+                (unsigned)(((uint64_t)ulFillBlocks * REDCONF_BLOCK_SIZE) / 1024U),
+                (unsigned)RedMulDiv64(ulFinalBlocks, 100U, sfs.f_blocks));
+        }
+    }
+
+    return ret;
+}
+
+
+/** @brief Write the large file sequentially and commit it.
+
+    @param pCtx The benchmark state.
+
+    @return Zero on success, otherwise -1.
+*/
+static int32_t BenchSeqWrite(
+    FSBENCHCTX     *pCtx)
+{
+    const FSBENCHPARAM *pParam = pCtx->pParam;
+    REDTIMESTAMP    ts = RedOsTimestamp();
+    int32_t         iFildes;
+    int32_t         ret = 0;
+
+    iFildes = red_open(pCtx->szFile, RED_O_WRONLY | RED_O_CREAT | RED_O_TRUNC);
+    if(iFildes < 0)
+    {
+        ret = -1;
+    }
+    else
+    {
+        uint32_t ulDone = 0U;
+        uint32_t ulOps = 0U;
+
+        while((ret == 0) && (ulDone < pParam->ulFileSize))
+        {
+            uint32_t ulLen = REDMIN(pParam->ulIoSize, pParam->ulFileSize - ulDone);
+
+            if(red_write(iFildes, pCtx->pbBuffer, ulLen) != (int32_t)ulLen)
+            {
+                ret = -1;
+            }
+            else
+            {
+                ulDone += ulLen;
+                ulOps++;
+            }
+        }
+
+        if((ret == 0) && (red_fsync(iFildes) != 0))
+        {
+            ret = -1;
+        }
+
+        if(red_close(iFildes) != 0)
+        {
+            ret = -1;
+        }
+
+        if(ret == 0)
+        {
+            BenchReport("seq write", ulDone, ulOps, RedOsTimePassed(ts));
+        }
+    }
+
+    return ret;
+}
+
+
+/** @brief Read the large file sequentially.
+
+    @param pCtx The benchmark state.
+
+    @return Zero on success, otherwise -1.
+*/
+static int32_t BenchSeqRead(
+    FSBENCHCTX     *pCtx)
+{
+    const FSBENCHPARAM *pParam = pCtx->pParam;
+    REDTIMESTAMP    ts = RedOsTimestamp();
+    int32_t         iFildes;
+    int32_t         ret = 0;
+
+    iFildes = red_open(pCtx->szFile, RED_O_RDONLY);
+    if(iFildes < 0)
+    {
+        ret = -1;
+    }
+    else
+    {
+        uint32_t ulDone = 0U;
+        uint32_t ulOps = 0U;
+
+        while((ret == 0) && (ulDone < pParam->ulFileSize))
+        {
+            uint32_t ulLen = REDMIN(pParam->ulIoSize, pParam->ulFileSize - ulDone);
+
+            if(red_read(iFildes, pCtx->pbBuffer, ulLen) != (int32_t)ulLen)
+            {
+                ret = -1;
+            }
+            else
+            {
+                ulDone += ulLen;
+                ulOps++;
+            }
+        }
+
+        if(red_close(iFildes) != 0)
+        {
+            ret = -1;
+        }
+
+        if(ret == 0)
+        {
+            BenchReport("seq read", ulDone, ulOps, RedOsTimePassed(ts));
+        }
+    }
+
+    return ret;
+}
+
+
+/** @brief Read the large file at random offsets.
+
+    @param pCtx The benchmark state.
+
+    @return Zero on success, otherwise -1.
+*/
+static int32_t BenchRandRead(
+    FSBENCHCTX     *pCtx)
+{
+    const FSBENCHPARAM *pParam = pCtx->pParam;
+    REDTIMESTAMP    ts = RedOsTimestamp();
+    int32_t         iFildes;
+    int32_t         ret = 0;
+
+    iFildes = red_open(pCtx->szFile, RED_O_RDONLY);
+    if(iFildes < 0)
+    {
+        ret = -1;
+    }
+    else
+    {
+        uint32_t ulOps;
+
+        for(ulOps = 0U; (ret == 0) && (ulOps < pParam->ulRandomOps); ulOps++)
+        {
+            if(    (red_lseek(iFildes, (int64_t)BenchRandOffset(pCtx), RED_SEEK_SET) < 0)
+                || (red_read(iFildes, pCtx->pbBuffer, pParam->ulIoSize) != (int32_t)pParam->ulIoSize))
+            {
+                ret = -1;
+            }
+        }
+
+        if(red_close(iFildes) != 0)
+        {
+            ret = -1;
+        }
+
+        if(ret == 0)
+        {
+            BenchReport("rand read", (uint64_t)ulOps * pParam->ulIoSize, ulOps, RedOsTimePassed(ts));
+        }
+    }
+
+    return ret;
+}
+
+
+/** @brief Rewrite the large file at random offsets and commit it.
+
+    @param pCtx The benchmark state.
+
+    @return Zero on success, otherwise -1.
+*/
+static int32_t BenchRandWrite(
+    FSBENCHCTX     *pCtx)
+{
+    const FSBENCHPARAM *pParam = pCtx->pParam;
+    REDTIMESTAMP    ts = RedOsTimestamp();
+    int32_t         iFildes;
+    int32_t         ret = 0;
+
+    iFildes = red_open(pCtx->szFile, RED_O_WRONLY);
+    if(iFildes < 0)
+    {
+        ret = -1;
+    }
+    else
+    {
+        uint32_t ulOps;
+
+        for(ulOps = 0U; (ret == 0) && (ulOps < pParam->ulRandomOps); ulOps++)
+        {
+            if(    (red_lseek(iFildes, (int64_t)BenchRandOffset(pCtx), RED_SEEK_SET) < 0)
+                || (red_write(iFildes, pCtx->pbBuffer, pParam->ulIoSize) != (int32_t)pParam->ulIoSize))
+            {
+                ret = -1;
+            }
+        }
+
+        if((ret == 0) && (red_fsync(iFildes) != 0))
+        {
+            ret = -1;
+        }
+
+        if(red_close(iFildes) != 0)
+        {
+            ret = -1;
+        }
+
+        if(ret == 0)
+        {
+            BenchReport("rand write", (uint64_t)ulOps * pParam->ulIoSize, ulOps, RedOsTimePassed(ts));
+        }
+    }
+
+    return ret;
+}
+
+
+/** @brief Create, look up, and delete many small files.
+
+    Each phase is reported in operations per second; the throughput reported
+    for the create phase counts the data written.
+
+    @param pCtx The benchmark state.
+
+    @return Zero on success, otherwise -1.
+*/
+static int32_t BenchSmallFiles(
+    FSBENCHCTX     *pCtx)
+{
+    const FSBENCHPARAM *pParam = pCtx->pParam;
+    char            szPath[FSBENCH_PATH_MAX];
+    REDTIMESTAMP    ts;
+    uint32_t        ulFile;
+    uint32_t        ulLen = REDMIN(pParam->ulIoSize, REDCONF_BLOCK_SIZE);
+    int32_t         ret = 0;
+
+    if(red_mkdir(pCtx->szDir) != 0)
+    {
+        ret = -1;
+    }
+
+    ts = RedOsTimestamp();
+    for(ulFile = 0U; (ret == 0) && (ulFile < pParam->ulFileCount); ulFile++)
+    {
+        int32_t iFildes;
+
+        BenchSmallFilePath(pCtx, ulFile, szPath);
+
+        iFildes = red_open(szPath, RED_O_WRONLY | RED_O_CREAT | RED_O_EXCL);
+        if(iFildes < 0)
+        {
+            ret = -1;
+        }
+        else
+        {
+            if(red_write(iFildes, pCtx->pbBuffer, ulLen) != (int32_t)ulLen)
+            {
+                ret = -1;
+            }
+
+            if(red_close(iFildes) != 0)
+            {
+                ret = -1;
+            }
+        }
+    }
+
+    if((ret == 0) && (red_transact(pParam->pszVolume) != 0))
+    {
+        ret = -1;
+    }
+
+    if(ret == 0)
+    {
+        BenchReport("create", (uint64_t)ulFile * ulLen, ulFile, RedOsTimePassed(ts));
+
+        ts = RedOsTimestamp();
+        for(ulFile = 0U; (ret == 0) && (ulFile < pParam->ulFileCount); ulFile++)
+        {
+            int32_t iFildes;
+
+            BenchSmallFilePath(pCtx, ulFile, szPath);
+
+            iFildes = red_open(szPath, RED_O_RDONLY);
+            if(iFildes < 0)
+            {
+                ret = -1;
+            }
+            else
+            {
+                REDSTAT st;
+
+                if(red_fstat(iFildes, &st) != 0)
+                {
+                    ret = -1;
+                }
+
+                if(red_close(iFildes) != 0)
+                {
+                    ret = -1;
+                }
+            }
+        }
+
+        if(ret == 0)
+        {
+            BenchReport("open+stat", 0U, ulFile, RedOsTimePassed(ts));
+        }
+    }
+
+    /*  Delete the files even if an earlier phase failed.
+    */
+    ts = RedOsTimestamp();
+    for(ulFile = 0U; ulFile < pParam->ulFileCount; ulFile++)
+    {
+        BenchSmallFilePath(pCtx, ulFile, szPath);
+
+        if((red_unlink(szPath) != 0) && (ret == 0))
+        {
+            ret = -1;
+        }
+    }
+
+    if((ret == 0) && (red_transact(pParam->pszVolume) != 0))
+    {
+        ret = -1;
+    }
+
+    if(ret == 0)
+    {
+        BenchReport("unlink", 0U, ulFile, RedOsTimePassed(ts));
+    }
+
+    (void)red_rmdir(pCtx->szDir);
+
+    return ret;
+}
+
+
+/** @brief Pick a random offset for an I/O within the large file.
+
+    Offsets are multiples of the I/O size, so that every random I/O touches the
+    same number of blocks as a sequential one.
+
+    @param pCtx The benchmark state.
+
+    @return A random offset at which a whole I/O fits in the file.
+*/
+static uint64_t BenchRandOffset(
+    FSBENCHCTX     *pCtx)
+{
+    uint32_t        ulSlots = pCtx->pParam->ulFileSize / pCtx->pParam->ulIoSize;
+
+    return (uint64_t)(RedRand32(&pCtx->ulSeed) % ulSlots) * pCtx->pParam->ulIoSize;
+}
+
+
+/** @brief Construct the path of a small file.
+
+    @param pCtx     The benchmark state.
+    @param ulFile   The number of the small file.
+    @param pszPath  Populated with the path; FSBENCH_PATH_MAX bytes.
+*/
+static void BenchSmallFilePath(
+    const FSBENCHCTX   *pCtx,
+    uint32_t            ulFile,
+    char               *pszPath)
+{
+    (void)RedSNPrintf(pszPath, FSBENCH_PATH_MAX, "%s%cf%06u", pCtx->szDir, REDCONF_PATH_SEPARATOR, (unsigned)ulFile);
+}
+
+
+/** @brief Print the result of a benchmark phase.
+
+    @param pszName      The name of the phase.
+    @param ullBytes     Bytes transferred by the phase, or zero if the phase is
+                        measured only in operations.
+    @param ulOps        Operations done by the phase.
+    @param ullMicrosecs Duration of the phase.
+*/
+static void BenchReport(
+    const char *pszName,
+    uint64_t    ullBytes,
+    uint32_t    ulOps,
+    uint64_t    ullMicrosecs)
+{
+    /*  Avoid dividing by zero when the timestamp is too coarse to measure a
+        short phase.
+    */
+    uint64_t    ullTime = (ullMicrosecs == 0U) ? 1U : ullMicrosecs;
+    uint64_t    ullOpsPerSec = RedMulDiv64(ulOps, 1000000U, ullTime);
+
+    if(ullBytes == 0U)
+    {
+        RedPrintf("%-10s %8u ops %10llu us %10llu ops/s\n", pszName, (unsigned)ulOps,
+            (unsigned long long)ullMicrosecs, (unsigned long long)ullOpsPerSec);
+    }
+    else
+    {
+        uint64_t ullKBPerSec = RedMulDiv64(ullBytes / 1024U, 1000000U, ullTime);
+
+        RedPrintf("%-10s %8u ops %10llu us %10llu ops/s %10llu KB/s\n", pszName, (unsigned)ulOps,
+            (unsigned long long)ullMicrosecs, (unsigned long long)ullOpsPerSec, (unsigned long long)ullKBPerSec);
+    }
+}
+
+
+static void usage(
+    const char *pszProgName)
+{
+    RedPrintf("usage: %s VolumeID [Options]\n", pszProgName);
+    RedPrintf("File system throughput benchmark.\n\n");
+    RedPrintf("Where:\n");
+    RedPrintf("  VolumeID\n");
+    RedPrintf("      A volume number (e.g., 2) or a volume path prefix (e.g., VOL1: or /data)\n");
+    RedPrintf("      of the volume to test.\n");
+    RedPrintf("And 'Options' are any of the following:\n");
+    RedPrintf("  --size=size, -z size\n");
+    RedPrintf("      Size of the file for the sequential and random tests.  Sizes are in KB\n");
+    RedPrintf("      unless a B or MB suffix is given.  Default 1MB.\n");
+    RedPrintf("  --io-size=size, -i size\n");
+    RedPrintf("      Size of each read and write.  Default 4KB.\n");
+    RedPrintf("  --rand=count, -r count\n");
+    RedPrintf("      Number of random reads, and of random writes (default 1000).\n");
+    RedPrintf("  --files=count, -f count\n");
+    RedPrintf("      Number of small files to create, stat, and delete (default 100).\n");
+    RedPrintf("  --seed=value, -s value\n");
+    RedPrintf("      Seed for the random offsets (default 1).\n");
+    RedPrintf("  --fill=percent, -F percent\n");
+    RedPrintf("      Before the benchmark, fill the volume with a ballast file such that it\n");
+    RedPrintf("      will be this percent full once the large file is written (default 0).\n");
+    RedPrintf("  --dev=devname, -D devname\n");
+    RedPrintf("      Specifies the device name.  This is typically only meaningful when\n");
+    RedPrintf("      running the test on a host machine.  This can be \"ram\" to test on a RAM\n");
+    RedPrintf("      disk, the path and name of a file disk (e.g., red.bin); or an OS-specific\n");
+    RedPrintf("      reference to a device (on Windows, a drive letter like G: or a device name\n");
+    RedPrintf("      like \\\\.\\PhysicalDrive7).\n");
+    RedPrintf("  --help, -H\n");
+    RedPrintf("      Prints this usage text and exits.\n\n");
+}
+
+#endif /* FSBENCH_SUPPORTED */
@@ -28,6 +28,11 @@
 #include <redfs.h>
 
 
+static uint32_t BitWord(const uint8_t *pbBitmap1, const uint8_t *pbBitmap2, uint32_t ulBit);
+static uint32_t BitLeadingZeros(uint32_t ulValue);
+static uint32_t BitPopCount(uint32_t ulValue);
+
+
 /** @brief Query the state of a bit in a bitmap.
 
     Bits are counted from most significant to least significant.  Thus, the mask
@@ -99,3 +104,201 @@ void RedBitClear(
     }
 }
 
+
+/** @brief Find the first bit which is clear in both of two bitmaps.
+
+    Bits are counted from most significant to least significant, as with
+    RedBitGet().  Aligned groups of 32 bits are examined a word at a time, so
+    runs of set bits are skipped quickly.  The two bitmaps may be the same.
+
+    @param pbBitmap1    Pointer to the first bitmap.
+    @param pbBitmap2    Pointer to the second bitmap.
+    @param ulStartBit   The first bit to examine.
+    @param ulEndBit     One past the last bit to examine.
+
+    @return The number of the first bit in the range [@p ulStartBit,
+            @p ulEndBit) which is clear in both bitmaps, or @p ulEndBit if
+            there is no such bit.
+*/
+uint32_t RedBitFindClear(
+    const uint8_t  *pbBitmap1,
+    const uint8_t  *pbBitmap2,
+    uint32_t        ulStartBit,
+    uint32_t        ulEndBit)
+{
+    uint32_t        ulBit = ulStartBit;
+    uint32_t        ulFound = ulEndBit;
+
+    REDASSERT((pbBitmap1 != NULL) && (pbBitmap2 != NULL));
+
+    while((ulBit < ulEndBit) && (ulFound == ulEndBit))
+    {
+        if(((ulBit & 31U) == 0U) && ((ulEndBit - ulBit) >= 32U))
+        {
+            uint32_t ulClear = ~BitWord(pbBitmap1, pbBitmap2, ulBit);
+
+            if(ulClear == 0U)
+            {
+                ulBit += 32U;
+            }
+            else
+            {
+                ulFound = ulBit + BitLeadingZeros(ulClear);
+            }
+        }
+        else if(!RedBitGet(pbBitmap1, ulBit) && !RedBitGet(pbBitmap2, ulBit))
+        {
+            ulFound = ulBit;
+        }
+        else
+        {
+            ulBit++;
+        }
+    }
+
+    return ulFound;
+}
+
+
+/** @brief Count the bits which are clear in both of two bitmaps.
+
+    Bits are counted from most significant to least significant, as with
+    RedBitGet().  The two bitmaps may be the same.
+
+    @param pbBitmap1    Pointer to the first bitmap.
+    @param pbBitmap2    Pointer to the second bitmap.
+    @param ulStartBit   The first bit to examine.
+    @param ulEndBit     One past the last bit to examine.
+
+    @return The number of bits in the range [@p ulStartBit, @p ulEndBit) which
+            are clear in both bitmaps.
+*/
+uint32_t RedBitCountClear(
+    const uint8_t  *pbBitmap1,
+    const uint8_t  *pbBitmap2,
+    uint32_t        ulStartBit,
+    uint32_t        ulEndBit)
+{
+    uint32_t        ulBit = ulStartBit;
+    uint32_t        ulCount = 0U;
+
+    REDASSERT((pbBitmap1 != NULL) && (pbBitmap2 != NULL));
+
+    while(ulBit < ulEndBit)
+    {
+        if(((ulBit & 31U) == 0U) && ((ulEndBit - ulBit) >= 32U))
+        {
+            ulCount += BitPopCount(~BitWord(pbBitmap1, pbBitmap2, ulBit));
+            ulBit += 32U;
+        }
+        else
+        {
+            if(!RedBitGet(pbBitmap1, ulBit) && !RedBitGet(pbBitmap2, ulBit))
+            {
+                ulCount++;
+            }
+
+            ulBit++;
+        }
+    }
+
+    return ulCount;
+}
+
+
+/** @brief Combine 32 bits from two bitmaps.
+
+    The bytes are assembled most significant first, so that bit @p ulBit of the
+    bitmaps becomes the most significant bit of the word.
+
+    @param pbBitmap1    Pointer to the first bitmap.
+    @param pbBitmap2    Pointer to the second bitmap.
+    @param ulBit        The first bit to combine; must be a multiple of 8.
+
+    @return The bitwise OR of the 32 bits from each bitmap.
+*/
+static uint32_t BitWord(
+    const uint8_t  *pbBitmap1,
+    const uint8_t  *pbBitmap2,
+    uint32_t        ulBit)
+{
+    uint32_t        ulByte = ulBit >> 3U;
+    uint32_t        ulWord = 0U;
+    uint32_t        ulIdx;
+
+    for(ulIdx = 0U; ulIdx < 4U; ulIdx++)
+    {
+        ulWord = (ulWord << 8U) | (uint32_t)pbBitmap1[ulByte + ulIdx] | (uint32_t)pbBitmap2[ulByte + ulIdx];
+    }
+
+    return ulWord;
+}
+
+
+/** @brief Count the leading zero bits of a word.
+
+    Since bitmaps count bits from the most significant, this finds the first
+    set bit of a word returned by BitWord().
+
+    @param ulValue  The value to examine; must be nonzero.
+
+    @return The number of zero bits above the most significant set bit.
+*/
+static uint32_t BitLeadingZeros(
+    uint32_t    ulValue)
+{
+    uint32_t    ulVal = ulValue;
+    uint32_t    ulCount = 0U;
+
+    REDASSERT(ulValue != 0U);
+
+    if((ulVal & 0xFFFF0000U) == 0U)
+    {
+        ulCount += 16U;
+        ulVal <<= 16U;
+    }
+
+    if((ulVal & 0xFF000000U) == 0U)
+    {
+        ulCount += 8U;
+        ulVal <<= 8U;
+    }
+
+    if((ulVal & 0xF0000000U) == 0U)
+    {
+        ulCount += 4U;
+        ulVal <<= 4U;
+    }
+
+    if((ulVal & 0xC0000000U) == 0U)
+    {
+        ulCount += 2U;
+        ulVal <<= 2U;
+    }
+
+    if((ulVal & 0x80000000U) == 0U)
+    {
+        ulCount++;
+    }
+
+    return ulCount;
+}
+
+
+/** @brief Count the set bits of a word.
+
+    @param ulValue  The value to examine.
+
+    @return The number of set bits in @p ulValue.
+*/
+static uint32_t BitPopCount(
+    uint32_t    ulValue)
+{
+    uint32_t    ulVal = ulValue;
+
+    ulVal = ulVal - ((ulVal >> 1U) & 0x55555555U);
+    ulVal = (ulVal & 0x33333333U) + ((ulVal >> 2U) & 0x33333333U);
+    ulVal = (ulVal + (ulVal >> 4U)) & 0x0F0F0F0FU;
+
+    return (ulVal * 0x01010101U) >> 24U;
+}
@@ -0,0 +1,465 @@
+#!/usr/bin/env python3
+#
+# FreeRTOS V202212.01
+# Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy of
+# this software and associated documentation files (the "Software"), to deal in
+# the Software without restriction, including without limitation the rights to
+# use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+# the Software, and to permit persons to whom the Software is furnished to do so,
+# subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+# FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+# COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+# IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+# CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#
+# https://www.FreeRTOS.org
+# https://github.com/FreeRTOS
+#
+"""Expand the output of the binary mode of logging_deferred.h back into text.
+
+The binary frames in the log only carry the offset of their format string in
+the log_strings section of the application and the raw bytes of the
+arguments.  This script reads that section from the ELF file the log was
+produced with, walks each format string with the same rules as
+logging_deferred.c to unpack the arguments, and formats them.  Text between
+the frames is copied as it is.
+
+    python3 logging_decoder.py application.elf log.bin > log.txt
+
+The sizes of the C types are derived from the ELF file class (ILP32 or LP64).
+Use --long-double-size when the default for the target machine is wrong.
+"""
+
+import argparse
+import math
+import re
+import struct
+import sys
+
+SECTION_NAME = "log_strings"
+FRAME_MARKER = 0x00
+
+# ELF identification and machines with a long double wider than double.
+ELF_MAGIC = b"\x7fELF"
+ELFCLASS64 = 2
+ELFDATA2MSB = 2
+EM_386 = 3
+EM_X86_64 = 62
+EM_AARCH64 = 183
+EM_RISCV = 243
+
+FLAGS = "-+ #0123456789.*"
+MODIFIERS = "hlzjtL"
+
+
+class DecodeError(Exception):
+    pass
+
+
+class Target:
+    """Byte order and C type sizes of the target, taken from its ELF file."""
+
+    def __init__(self, elf_class, elf_data, machine, long_double_size=None):
+        self.endian = ">" if elf_data == ELFDATA2MSB else "<"
+        self.pointer_size = 8 if elf_class == ELFCLASS64 else 4
+        self.long_size = self.pointer_size
+
+        if long_double_size is not None:
+            self.long_double_size = long_double_size
+        elif machine in (EM_X86_64, EM_AARCH64) or (
+            machine == EM_RISCV and elf_class == ELFCLASS64
+        ):
+            self.long_double_size = 16
+        elif machine == EM_386:
+            self.long_double_size = 12
+        else:
+            self.long_double_size = 8
+
+        self.machine = machine
+
+
+def read_elf_section(path, name):
+    """Return the Target described by the ELF file and the contents of the
+    named section."""
+    with open(path, "rb") as elf_file:
+        data = elf_file.read()
+
+    if data[:4] != ELF_MAGIC:
+        raise DecodeError("%s is not an ELF file" % path)
+
+    elf_class = data[4]
+    elf_data = data[5]
+    endian = ">" if elf_data == ELFDATA2MSB else "<"
+
+    if elf_class == ELFCLASS64:
+        (machine,) = struct.unpack_from(endian + "H", data, 18)
+        (shoff,) = struct.unpack_from(endian + "Q", data, 40)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + "HHH", data, 58)
+        header_format = endian + "IIQQQQIIQQ"
+    else:
+        (machine,) = struct.unpack_from(endian + "H", data, 18)
+        (shoff,) = struct.unpack_from(endian + "I", data, 32)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + "HHH", data, 46)
+        header_format = endian + "IIIIIIIIII"
+
+    sections = [
+        struct.unpack_from(header_format, data, shoff + index * shentsize)
+        for index in range(shnum)
+    ]
+    names = sections[shstrndx]
+    names_offset = names[4]
+
+    for section in sections:
+        name_start = names_offset + section[0]
+        name_end = data.index(b"\0", name_start)
+
+        if data[name_start:name_end].decode("ascii", "replace") == name:
+            offset, size = section[4], section[5]
+            return (elf_class, elf_data, machine), data[offset : offset + size]
+
+    raise DecodeError("%s has no %s section" % (path, name))
+
+
+def next_conversion(format_string, start):
+    """Find the next conversion specification from start, returning its
+    position, length, number of '*' and argument type, or None."""
+    percent = format_string.find("%", start)
+
+    if percent < 0:
+        return None
+
+    current = percent + 1
+    stars = 0
+
+    while current < len(format_string) and format_string[current] in FLAGS:
+        if format_string[current] == "*":
+            stars += 1
+        current += 1
+
+    modifier = ""
+
+    while current < len(format_string) and format_string[current] in MODIFIERS:
+        modifier += format_string[current]
+        current += 1
+
+    conversion = format_string[current] if current < len(format_string) else ""
+
+    if conversion in "diuoxX" and conversion:
+        arg_type = {
+            "": "int",
+            "h": "int",
+            "hh": "int",
+            "l": "long",
+            "z": "size",
+            "j": "intmax",
+            "t": "ptrdiff",
+        }.get(modifier, "long long" if modifier.startswith("l") else None)
+        if modifier == "L":
+            arg_type = None
+    elif conversion == "c":
+        arg_type = "int" if modifier == "" else None
+    elif conversion == "s":
+        arg_type = "string" if modifier == "" else None
+    elif conversion == "p":
+        arg_type = "pointer"
+    elif conversion and conversion in "fFeEgGaA":
+        arg_type = "long double" if modifier.endswith("L") else "double"
+    elif conversion == "%":
+        arg_type = "none"
+    else:
+        # "%n", wide characters and malformed specifications.
+        arg_type = None
+
+    if conversion:
+        current += 1
+
+    return percent, current - percent, stars, arg_type
+
+
+class ArgumentReader:
+    def __init__(self, target, payload):
+        self.target = target
+        self.payload = payload
+        self.offset = 0
+
+    def take(self, size):
+        if self.offset + size > len(self.payload):
+            raise DecodeError("frame is shorter than its format string requires")
+
+        value = self.payload[self.offset : self.offset + size]
+        self.offset += size
+        return value
+
+    def integer(self, size, signed):
+        value = int.from_bytes(
+            self.take(size),
+            "big" if self.target.endian == ">" else "little",
+            signed=signed,
+        )
+        return value
+
+    def read(self, arg_type):
+        target = self.target
+
+        if arg_type == "int":
+            return self.integer(4, True)
+        if arg_type == "long":
+            return self.integer(target.long_size, True)
+        if arg_type in ("long long", "intmax"):
+            return self.integer(8, True)
+        if arg_type == "size":
+            return self.integer(target.pointer_size, False)
+        if arg_type == "ptrdiff":
+            return self.integer(target.pointer_size, True)
+        if arg_type == "pointer":
+            return self.integer(target.pointer_size, False)
+        if arg_type == "string":
+            length = self.take(1)[0]
+            return self.take(length).decode("utf-8", "replace")
+        if arg_type == "double":
+            return struct.unpack(target.endian + "d", self.take(8))[0]
+        if arg_type == "long double":
+            return self.long_double(self.take(target.long_double_size))
+
+        raise DecodeError("unexpected argument type %s" % arg_type)
+
+    def long_double(self, raw):
+        target = self.target
+
+        if len(raw) == 8:
+            return struct.unpack(target.endian + "d", raw)[0]
+
+        if target.endian == ">":
+            raw = raw[::-1]
+
+        if target.machine in (EM_386, EM_X86_64):
+            # x87 extended precision: 64 bit mantissa with an explicit integer
+            # bit, then a 15 bit exponent and the sign.
+            mantissa = int.from_bytes(raw[0:8], "little")
+            exponent_sign = int.from_bytes(raw[8:10], "little")
+            exponent = exponent_sign & 0x7FFF
+            fraction_bits = 63
+        else:
+            # IEEE 754 quadruple precision with an implicit integer bit.
+            value = int.from_bytes(raw[0:16], "little")
+            mantissa = value & ((1 << 112) - 1)
+            exponent_sign = value >> 112
+            exponent = exponent_sign & 0x7FFF
+
+            if exponent != 0:
+                mantissa |= 1 << 112
+
+            fraction_bits = 112
+
+        sign = -1.0 if exponent_sign & 0x8000 else 1.0
+
+        if exponent == 0x7FFF:
+            if mantissa & ((1 << fraction_bits) - 1):
+                return math.nan
+            return sign * math.inf
+
+        if exponent == 0:
+            exponent = 1
+
+        try:
+            return sign * math.ldexp(mantissa, exponent - 16383 - fraction_bits)
+        except OverflowError:
+            return sign * math.inf
+
+
+def format_argument(target, specification, conversion, value):
+    """Format one argument with a C conversion specification, whose '*' have
+    already been replaced with their values."""
+    flags_end = len(specification) - 1
+
+    while specification[flags_end - 1] in MODIFIERS:
+        flags_end -= 1
+
+    flags = specification[1:flags_end]
+
+    # A negative precision is taken as if it was omitted.
+    if ".-" in flags:
+        flags = flags[: flags.index(".-")]
+
+    if conversion == "p":
+        # Only the "-" flag and the field width apply to "%p".
+        flags = re.sub(r"^[-+ #0]*", lambda match: "-" if "-" in match.group(0) else "", flags)
+        return ("%" + flags.split(".")[0] + "s") % ("0x%x" % value if value else "(nil)")
+
+    if conversion == "c":
+        return ("%" + flags + "c") % chr(value & 0xFF)
+
+    if conversion in "uoxX":
+        size = 4
+        modifier = specification[flags_end : len(specification) - 1]
+
+        if modifier == "hh":
+            size = 1
+        elif modifier == "h":
+            size = 2
+        elif modifier == "l":
+            size = target.long_size
+        elif modifier in ("ll", "j"):
+            size = 8
+        elif modifier in ("z", "t"):
+            size = target.pointer_size
+
+        value &= (1 << (8 * size)) - 1
+
+        if conversion == "o" and "#" in flags:
+            # Python prefixes "0o" where C only prefixes "0".
+            width = int(re.match(r"[-+ #0]*(\d*)", flags).group(1) or 0)
+            octal = (("%" + flags + "o") % value).strip().replace("0o", "0" if value else "", 1)
+            return octal.ljust(width) if "-" in flags else octal.rjust(width)
+
+        return ("%" + flags + ("d" if conversion == "u" else conversion)) % value
+
+    if conversion in "di":
+        modifier = specification[flags_end : len(specification) - 1]
+
+        if modifier in ("hh", "h"):
+            bits = 8 if modifier == "hh" else 16
+            value &= (1 << bits) - 1
+            if value >= 1 << (bits - 1):
+                value -= 1 << bits
+
+        return ("%" + flags + "d") % value
+
+    if conversion in "aA":
+        # Python keeps trailing zeros in the mantissa, which C drops.
+        text = float(value).hex()
+
+        if "p" in text:
+            mantissa, exponent = text.split("p")
+            text = mantissa.rstrip("0").rstrip(".") + "p" + exponent
+
+        text = ("%" + flags.split(".")[0].replace("#", "") + "s") % text
+        return text.upper() if conversion == "A" else text
+
+    if conversion == "F":
+        return ("%" + flags + "f") % value
+
+    return ("%" + flags + conversion) % value
+
+
+def expand(target, strings, format_offset, payload):
+    end = strings.find(b"\0", format_offset)
+
+    if format_offset >= len(strings) or end < 0:
+        raise DecodeError("format offset %d is outside the section" % format_offset)
+
+    format_string = strings[format_offset:end].decode("utf-8", "replace")
+    reader = ArgumentReader(target, payload)
+    output = []
+    current = 0
+
+    while True:
+        conversion = next_conversion(format_string, current)
+
+        if conversion is None or conversion[3] is None:
+            break
+
+        start, length, stars, arg_type = conversion
+        output.append(format_string[current:start])
+        current = start + length
+        specification = format_string[start:current]
+
+        if arg_type == "none":
+            output.append("%")
+            continue
+
+        for _ in range(stars):
+            star = str(reader.integer(4, True))
+            specification = specification.replace("*", star, 1)
+
+        output.append(
+            format_argument(target, specification, specification[-1], reader.read(arg_type))
+        )
+
+    # The rest of the format string, which is also where output stops being
+    # interpreted after an unsupported conversion.
+    output.append(format_string[current:])
+
+    return "".join(output)
+
+
+def decode(target, strings, log, out):
+    position = 0
+
+    while position < len(log):
+        marker = log.find(bytes([FRAME_MARKER]), position)
+
+        if marker < 0:
+            marker = len(log)
+
+        out.write(log[position:marker].decode("utf-8", "replace"))
+        position = marker
+
+        if position >= len(log):
+            break
+
+        header_end = position + 1 + 4
+
+        if header_end > len(log):
+            sys.stderr.write("Truncated frame at offset %d.\n" % position)
+            break
+
+        frame_length, format_offset = struct.unpack_from(
+            target.endian + "HH", log, position + 1
+        )
+        frame_end = position + 1 + 2 + frame_length
+
+        if frame_end > len(log) or frame_length < 2:
+            sys.stderr.write("Truncated frame at offset %d.\n" % position)
+            break
+
+        try:
+            out.write(expand(target, strings, format_offset, log[header_end:frame_end]))
+        except DecodeError as error:
+            out.write("[Logging] Undecodable frame at offset %d: %s.\r\n" % (position, error))
+
+        position = frame_end
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="ELF file of the application that produced the log")
+    parser.add_argument(
+        "log",
+        nargs="?",
+        help="binary log to decode, read from standard input if omitted",
+    )
+    parser.add_argument(
+        "--long-double-size",
+        type=int,
+        choices=(8, 12, 16),
+        help="size of long double on the target, in bytes",
+    )
+    args = parser.parse_args()
+
+    try:
+        (elf_class, elf_data, machine), strings = read_elf_section(args.elf, SECTION_NAME)
+    except (OSError, DecodeError) as error:
+        sys.exit("Error: %s" % error)
+
+    target = Target(elf_class, elf_data, machine, args.long_double_size)
+
+    if args.log is None:
+        log = sys.stdin.buffer.read()
+    else:
+        with open(args.log, "rb") as log_file:
+            log = log_file.read()
+
+    decode(target, strings, log, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,1048 @@
+/*
+ * FreeRTOS V202212.01
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * Deferred logging backend.  See logging_deferred.h for a description.
+ *
+ * Each record in a ring is laid out as follows, without any padding:
+ *
+ *   uint16_t     Length of the whole record in bytes.
+ *   const char * The format string.
+ *   ...          The arguments in the order they are consumed by the format
+ *                string.  '*' widths and precisions are stored as int, numbers
+ *                and pointers in their promoted type, and strings as a one
+ *                byte length followed by the characters.
+ *
+ * The logger task walks the format string the same way the recording task
+ * did to know the type of each stored argument, then formats the message one
+ * conversion at a time.  In binary mode, records whose format string is in
+ * the binary section are output as they are instead, behind a frame header
+ * that replaces the format string pointer with its offset in the section.
+ */
+
+/* Standard includes. */
+#include <stdarg.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "logging_deferred.h"
+
+#if ( INCLUDE_xTaskGetSchedulerState != 1 )
+    #error "INCLUDE_xTaskGetSchedulerState must be set to 1 to use the deferred logging backend."
+#endif
+
+#if ( ( loggingDEFERRED_RING_SIZE & ( loggingDEFERRED_RING_SIZE - 1U ) ) != 0U )
+    #error "loggingDEFERRED_RING_SIZE must be a power of two."
+#endif
+
+#if ( loggingDEFERRED_MAX_STRING_LENGTH > 255U )
+    #error "loggingDEFERRED_MAX_STRING_LENGTH must fit in one byte."
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* Masks a free running ring index down to an offset into the ring buffer. */
+#define ldRING_INDEX_MASK            ( ( size_t ) loggingDEFERRED_RING_SIZE - 1U )
+
+/* Records are limited by the width of their length field. */
+#define ldMAX_RECORD_LENGTH          ( ( size_t ) UINT16_MAX )
+
+/* Dimensions the buffer into which a single conversion specification is
+ * copied, with any '*' replaced by the recorded value. */
+#define ldMAX_SPECIFICATION_LENGTH   32U
+
+#if ( loggingDEFERRED_BINARY_ENABLED == 1 )
+
+/* Marks the start of a binary frame in the output. */
+    #define ldBINARY_FRAME_MARKER    ( ( uint8_t ) 0x00U )
+
+/* The frame header is the marker, the frame length and the format offset. */
+    #define ldBINARY_HEADER_LENGTH   ( sizeof( uint8_t ) + ( 2U * sizeof( uint16_t ) ) )
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* The type of argument consumed by a conversion specification. */
+typedef enum LoggingArgType
+{
+    eLoggingArgNone = 0,   /* "%%", which consumes no argument. */
+    eLoggingArgInt,
+    eLoggingArgLong,
+    eLoggingArgLongLong,
+    eLoggingArgSize,
+    eLoggingArgIntMax,
+    eLoggingArgPtrDiff,
+    eLoggingArgPointer,
+    eLoggingArgString,
+    eLoggingArgDouble,
+    eLoggingArgLongDouble,
+    eLoggingArgUnsupported /* Arguments are not interpreted past this point. */
+} LoggingArgType_t;
+
+/* A conversion specification found in a format string. */
+typedef struct LoggingConversion
+{
+    const char * pcStart;      /* Points to the '%' character. */
+    size_t xLength;            /* Length of the specification, including the '%'. */
+    UBaseType_t uxStarCount;   /* Number of '*' widths and precisions. */
+    LoggingArgType_t eType;    /* Type of the converted argument. */
+} LoggingConversion_t;
+
+/* Storage for any argument value, so that it can be copied to and from a ring
+ * as bytes. */
+typedef union LoggingArgValue
+{
+    int iValue;
+    long lValue;
+    long long llValue;
+    size_t xSize;
+    intmax_t xIntMax;
+    ptrdiff_t xPtrDiff;
+    void * pvValue;
+    double dValue;
+    long double ldValue;
+} LoggingArgValue_t;
+
+/* A single producer, single consumer ring.  xHead is only written by the task
+ * that owns the ring and xTail only by the logger task.  Both are free running
+ * and are masked when used as offsets into ucBuffer. */
+typedef struct LoggingRing
+{
+    TaskHandle_t xOwner;
+    volatile size_t xHead;
+    volatile size_t xTail;
+    volatile uint32_t ulDropped;
+    uint32_t ulDroppedReported;
+    uint8_t ucBuffer[ loggingDEFERRED_RING_SIZE ];
+} LoggingRing_t;
+
+/* Tracks a record while it is being written to a ring. */
+typedef struct LoggingRecordWriter
+{
+    LoggingRing_t * pxRing;
+    size_t xStart;
+    size_t xUsed;
+    size_t xAvailable;
+} LoggingRecordWriter_t;
+
+/* A message being formatted by the logger task. */
+typedef struct LoggingMessage
+{
+    char cBuffer[ loggingDEFERRED_MAX_MESSAGE_LENGTH ];
+    size_t xLength;
+} LoggingMessage_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Find the next conversion specification in pcFormat.  Returns pdTRUE and
+ * fills pxConversion if one was found, pdFALSE otherwise.
+ */
+static BaseType_t prvNextConversion( const char * pcFormat,
+                                     LoggingConversion_t * pxConversion );
+
+/*
+ * Return the ring owned by the calling task, assigning a free one if the task
+ * has none yet.  Returns NULL if all the rings are taken.
+ */
+static LoggingRing_t * prvGetRing( void );
+
+/*
+ * Copy bytes into or out of a ring at a free running index, wrapping around
+ * the end of the buffer if necessary.
+ */
+static void prvRingCopyIn( LoggingRing_t * pxRing,
+                           size_t xIndex,
+                           const void * pvData,
+                           size_t xLength );
+static void prvRingCopyOut( const LoggingRing_t * pxRing,
+                            size_t xIndex,
+                            void * pvData,
+                            size_t xLength );
+
+/*
+ * Append bytes to the record being written.  Returns pdFAIL, without writing
+ * anything, if the record would no longer fit in the ring.
+ */
+static BaseType_t prvRecordWrite( LoggingRecordWriter_t * pxWriter,
+                                  const void * pvData,
+                                  size_t xLength );
+
+/*
+ * Record a message into the ring of the calling task, or count it as dropped
+ * if it does not fit.
+ */
+static void prvRecordMessage( LoggingRing_t * pxRing,
+                              const char * pcFormat,
+                              va_list xArgs );
+
+/*
+ * Append text to a message, truncating it if the message buffer is full.
+ */
+static void prvMessageAppend( LoggingMessage_t * pxMessage,
+                              const char * pcText,
+                              size_t xLength );
+
+/*
+ * Account for the return value of snprintf() after it wrote at the end of a
+ * message.
+ */
+static void prvMessageCommit( LoggingMessage_t * pxMessage,
+                              int iWritten );
+
+/*
+ * Format the argument of a single conversion at the end of a message, reading
+ * it and any '*' width and precision from the ring at *pxRead.
+ */
+static void prvFormatArgument( const LoggingRing_t * pxRing,
+                               const LoggingConversion_t * pxConversion,
+                               size_t * pxRead,
+                               LoggingMessage_t * pxMessage );
+
+/*
+ * Format the oldest record of a ring into pxMessage and release it.
+ */
+static void prvFormatRecord( LoggingRing_t * pxRing,
+                             LoggingMessage_t * pxMessage );
+
+#if ( loggingDEFERRED_BINARY_ENABLED == 1 )
+
+/*
+ * Output the oldest record of a ring as a binary frame and release it, if its
+ * format string is in the binary section.  Returns pdFALSE, without consuming
+ * the record, otherwise.
+ */
+    static BaseType_t prvOutputBinaryRecord( LoggingRing_t * pxRing );
+#endif
+
+/*
+ * Output the oldest record of a ring and release it.
+ */
+static void prvOutputRecord( LoggingRing_t * pxRing,
+                             LoggingMessage_t * pxMessage );
+
+/*
+ * The task that formats and outputs the recorded messages.
+ */
+static void prvLoggingTask( void * pvParameters );
+
+/*-----------------------------------------------------------*/
+
+/* One ring per logging task. */
+static LoggingRing_t xRings[ loggingDEFERRED_RING_COUNT ];
+
+/* Messages dropped because all the rings were already taken. */
+static volatile uint32_t ulUnassignedDropped = 0U;
+static uint32_t ulUnassignedDroppedReported = 0U;
+
+#if ( loggingDEFERRED_BINARY_ENABLED == 1 )
+
+/* Bounds of the binary section, defined by the linker after the section name
+ * (loggingDEFERRED_BINARY_SECTION).  They are weak so that an application
+ * without any binary message still links. */
+    extern const char __start_log_strings[] __attribute__( ( weak ) );
+    extern const char __stop_log_strings[] __attribute__( ( weak ) );
+#endif
+
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvNextConversion( const char * pcFormat,
+                                     LoggingConversion_t * pxConversion )
+{
+    const char * pcCurrent = strchr( pcFormat, '%' );
+    char cModifier = '\0';
+    UBaseType_t uxModifierCount = 0U;
+    BaseType_t xFound = pdFALSE;
+
+    if( pcCurrent != NULL )
+    {
+        xFound = pdTRUE;
+        pxConversion->pcStart = pcCurrent;
+        pxConversion->uxStarCount = 0U;
+        pcCurrent++;
+
+        /* Flags, field width and precision. */
+        while( ( *pcCurrent != '\0' ) && ( strchr( "-+ #0123456789.*", *pcCurrent ) != NULL ) )
+        {
+            if( *pcCurrent == '*' )
+            {
+                pxConversion->uxStarCount++;
+            }
+
+            pcCurrent++;
+        }
+
+        /* Length modifier. */
+        while( ( *pcCurrent != '\0' ) && ( strchr( "hlzjtL", *pcCurrent ) != NULL ) )
+        {
+            cModifier = *pcCurrent;
+            uxModifierCount++;
+            pcCurrent++;
+        }
+
+        switch( *pcCurrent )
+        {
+            case 'd':
+            case 'i':
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+
+                if( ( cModifier == 'l' ) && ( uxModifierCount == 1U ) )
+                {
+                    pxConversion->eType = eLoggingArgLong;
+                }
+                else if( cModifier == 'l' )
+                {
+                    pxConversion->eType = eLoggingArgLongLong;
+                }
+                else if( cModifier == 'z' )
+                {
+                    pxConversion->eType = eLoggingArgSize;
+                }
+                else if( cModifier == 'j' )
+                {
+                    pxConversion->eType = eLoggingArgIntMax;
+                }
+                else if( cModifier == 't' )
+                {
+                    pxConversion->eType = eLoggingArgPtrDiff;
+                }
+                else if( cModifier == 'L' )
+                {
+                    pxConversion->eType = eLoggingArgUnsupported;
+                }
+                else
+                {
+                    /* No modifier, or "h" and "hh" which are promoted to int. */
+                    pxConversion->eType = eLoggingArgInt;
+                }
+
+                break;
+
+            case 'c':
+                pxConversion->eType = ( cModifier == '\0' ) ? eLoggingArgInt : eLoggingArgUnsupported;
+                break;
+
+            case 's':
+                pxConversion->eType = ( cModifier == '\0' ) ? eLoggingArgString : eLoggingArgUnsupported;
+                break;
+
+            case 'p':
+                pxConversion->eType = eLoggingArgPointer;
+                break;
+
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+                pxConversion->eType = ( cModifier == 'L' ) ? eLoggingArgLongDouble : eLoggingArgDouble;
+                break;
+
+            case '%':
+                pxConversion->eType = eLoggingArgNone;
+                break;
+
+            default:
+                /* "%n", wide characters and malformed specifications. */
+                pxConversion->eType = eLoggingArgUnsupported;
+                break;
+        }
+
+        if( *pcCurrent != '\0' )
+        {
+            pcCurrent++;
+        }
+
+        pxConversion->xLength = ( size_t ) ( pcCurrent - pxConversion->pcStart );
+    }
+
+    return xFound;
+}
+/*-----------------------------------------------------------*/
+
+static LoggingRing_t * prvGetRing( void )
+{
+    TaskHandle_t xTask = xTaskGetCurrentTaskHandle();
+    LoggingRing_t * pxRing = NULL;
+    UBaseType_t ux;
+
+    for( ux = 0U; ux < loggingDEFERRED_RING_COUNT; ux++ )
+    {
+        if( xRings[ ux ].xOwner == xTask )
+        {
+            pxRing = &( xRings[ ux ] );
+            break;
+        }
+    }
+
+    if( pxRing == NULL )
+    {
+        /* This is the first message from this task.  Claiming a ring is the
+         * only time a task enters a critical section to log. */
+        taskENTER_CRITICAL();
+        {
+            for( ux = 0U; ux < loggingDEFERRED_RING_COUNT; ux++ )
+            {
+                if( xRings[ ux ].xOwner == NULL )
+                {
+                    xRings[ ux ].xOwner = xTask;
+                    pxRing = &( xRings[ ux ] );
+                    break;
+                }
+            }
+
+            if( pxRing == NULL )
+            {
+                ulUnassignedDropped++;
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+
+    return pxRing;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRingCopyIn( LoggingRing_t * pxRing,
+                           size_t xIndex,
+                           const void * pvData,
+                           size_t xLength )
+{
+    size_t xOffset = xIndex & ldRING_INDEX_MASK;
+    size_t xFirstLength = loggingDEFERRED_RING_SIZE - xOffset;
+
+    if( xFirstLength > xLength )
+    {
+        xFirstLength = xLength;
+    }
+
+    ( void ) memcpy( &( pxRing->ucBuffer[ xOffset ] ), pvData, xFirstLength );
+    ( void ) memcpy( pxRing->ucBuffer, &( ( ( const uint8_t * ) pvData )[ xFirstLength ] ), xLength - xFirstLength );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRingCopyOut( const LoggingRing_t * pxRing,
+                            size_t xIndex,
+                            void * pvData,
+                            size_t xLength )
+{
+    size_t xOffset = xIndex & ldRING_INDEX_MASK;
+    size_t xFirstLength = loggingDEFERRED_RING_SIZE - xOffset;
+
+    if( xFirstLength > xLength )
+    {
+        xFirstLength = xLength;
+    }
+
+    ( void ) memcpy( pvData, &( pxRing->ucBuffer[ xOffset ] ), xFirstLength );
+    ( void ) memcpy( &( ( ( uint8_t * ) pvData )[ xFirstLength ] ), pxRing->ucBuffer, xLength - xFirstLength );
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvRecordWrite( LoggingRecordWriter_t * pxWriter,
+                                  const void * pvData,
+                                  size_t xLength )
+{
+    BaseType_t xReturn = pdFAIL;
+
+    if( xLength <= ( pxWriter->xAvailable - pxWriter->xUsed ) )
+    {
+        prvRingCopyIn( pxWriter->pxRing, pxWriter->xStart + pxWriter->xUsed, pvData, xLength );
+        pxWriter->xUsed += xLength;
+        xReturn = pdPASS;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRecordMessage( LoggingRing_t * pxRing,
+                              const char * pcFormat,
+                              va_list xArgs )
+{
+    LoggingRecordWriter_t xWriter;
+    LoggingConversion_t xConversion;
+    LoggingArgValue_t xValue;
+    const char * pcCurrent = pcFormat;
+    const char * pcString;
+    size_t xFree;
+    uint8_t ucStringLength;
+    uint16_t usRecordLength;
+    UBaseType_t ux;
+    int iStar;
+    BaseType_t xStatus = pdPASS;
+
+    xWriter.pxRing = pxRing;
+    xWriter.xStart = pxRing->xHead;
+    xFree = loggingDEFERRED_RING_SIZE - ( xWriter.xStart - pxRing->xTail );
+    xWriter.xAvailable = ( xFree < ldMAX_RECORD_LENGTH ) ? xFree : ldMAX_RECORD_LENGTH;
+
+    /* The length is written last, once the record is known to fit. */
+    xWriter.xUsed = 0U;
+
+    if( xWriter.xAvailable < sizeof( usRecordLength ) )
+    {
+        xStatus = pdFAIL;
+    }
+    else
+    {
+        xWriter.xUsed = sizeof( usRecordLength );
+        xStatus = prvRecordWrite( &xWriter, &pcFormat, sizeof( pcFormat ) );
+    }
+
+    while( ( xStatus == pdPASS ) && ( prvNextConversion( pcCurrent, &xConversion ) == pdTRUE ) )
+    {
+        if( xConversion.eType == eLoggingArgUnsupported )
+        {
+            /* The layout of the remaining arguments is unknown. */
+            break;
+        }
+
+        for( ux = 0U; ( ux < xConversion.uxStarCount ) && ( xStatus == pdPASS ); ux++ )
+        {
+            iStar = va_arg( xArgs, int );
+            xStatus = prvRecordWrite( &xWriter, &iStar, sizeof( iStar ) );
+        }
+
+        if( xStatus == pdPASS )
+        {
+            switch( xConversion.eType )
+            {
+                case eLoggingArgInt:
+                    xValue.iValue = va_arg( xArgs, int );
+                    xStatus = prvRecordWrite( &xWriter, &xValue.iValue, sizeof( xValue.iValue ) );
+                    break;
+
+                case eLoggingArgLong:
+                    xValue.lValue = va_arg( xArgs, long );
+                    xStatus = prvRecordWrite( &xWriter, &xValue.lValue, sizeof( xValue.lValue ) );
+                    break;
+
+                case eLoggingArgLongLong:
+                    xValue.llValue = va_arg( xArgs, long long );
+                    xStatus = prvRecordWrite( &xWriter, &xValue.llValue, sizeof( xValue.llValue ) );
+                    break;
+
+                case eLoggingArgSize:
+                    xValue.xSize = va_arg( xArgs, size_t );
+                    xStatus = prvRecordWrite( &xWriter, &xValue.xSize, sizeof( xValue.xSize ) );
+                    break;
+
+                case eLoggingArgIntMax:
+                    xValue.xIntMax = va_arg( xArgs, intmax_t );
+                    xStatus = prvRecordWrite( &xWriter, &xValue.xIntMax, sizeof( xValue.xIntMax ) );
+                    break;
+
+                case eLoggingArgPtrDiff:
+                    xValue.xPtrDiff = va_arg( xArgs, ptrdiff_t );
+                    xStatus = prvRecordWrite( &xWriter, &xValue.xPtrDiff, sizeof( xValue.xPtrDiff ) );
+                    break;
+
+                case eLoggingArgPointer:
+                    xValue.pvValue = va_arg( xArgs, void * );
+                    xStatus = prvRecordWrite( &xWriter, &xValue.pvValue, sizeof( xValue.pvValue ) );
+                    break;
+
+                case eLoggingArgString:
+                    pcString = va_arg( xArgs, const char * );
+
+                    if( pcString == NULL )
+                    {
+                        pcString = "(null)";
+                    }
+
+                    /* The string may not outlive the call, so its characters
+                     * are copied rather than its address. */
+                    ucStringLength = 0U;
+
+                    while( ( ucStringLength < loggingDEFERRED_MAX_STRING_LENGTH ) && ( pcString[ ucStringLength ] != '\0' ) )
+                    {
+                        ucStringLength++;
+                    }
+
+                    xStatus = prvRecordWrite( &xWriter, &ucStringLength, sizeof( ucStringLength ) );
+
+                    if( xStatus == pdPASS )
+                    {
+                        xStatus = prvRecordWrite( &xWriter, pcString, ucStringLength );
+                    }
+
+                    break;
+
+                case eLoggingArgDouble:
+                    xValue.dValue = va_arg( xArgs, double );
+                    xStatus = prvRecordWrite( &xWriter, &xValue.dValue, sizeof( xValue.dValue ) );
+                    break;
+
+                case eLoggingArgLongDouble:
+                    xValue.ldValue = va_arg( xArgs, long double );
+                    xStatus = prvRecordWrite( &xWriter, &xValue.ldValue, sizeof( xValue.ldValue ) );
+                    break;
+
+                default:
+                    /* "%%" consumes no argument. */
+                    break;
+            }
+        }
+
+        pcCurrent = xConversion.pcStart + xConversion.xLength;
+    }
+
+    if( xStatus == pdPASS )
+    {
+        usRecordLength = ( uint16_t ) xWriter.xUsed;
+        prvRingCopyIn( pxRing, xWriter.xStart, &usRecordLength, sizeof( usRecordLength ) );
+
+        /* The logger task must not see the new head before the record is
+         * complete. */
+        portMEMORY_BARRIER();
+        pxRing->xHead = xWriter.xStart + xWriter.xUsed;
+    }
+    else
+    {
+        pxRing->ulDropped++;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvMessageAppend( LoggingMessage_t * pxMessage,
+                              const char * pcText,
+                              size_t xLength )
+{
+    /* One byte is kept for the terminating NULL written by snprintf(). */
+    size_t xSpace = sizeof( pxMessage->cBuffer ) - 1U - pxMessage->xLength;
+
+    if( xLength > xSpace )
+    {
+        xLength = xSpace;
+    }
+
+    ( void ) memcpy( &( pxMessage->cBuffer[ pxMessage->xLength ] ), pcText, xLength );
+    pxMessage->xLength += xLength;
+}
+/*-----------------------------------------------------------*/
+
+static void prvMessageCommit( LoggingMessage_t * pxMessage,
+                              int iWritten )
+{
+    size_t xSpace = sizeof( pxMessage->cBuffer ) - 1U - pxMessage->xLength;
+
+    if( iWritten > 0 )
+    {
+        /* snprintf() returns the length the output would have had, so clamp
+         * it to what was actually written. */
+        pxMessage->xLength += ( ( size_t ) iWritten < xSpace ) ? ( size_t ) iWritten : xSpace;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvFormatArgument( const LoggingRing_t * pxRing,
+                               const LoggingConversion_t * pxConversion,
+                               size_t * pxRead,
+                               LoggingMessage_t * pxMessage )
+{
+    LoggingArgValue_t xValue;
+    char cSpecification[ ldMAX_SPECIFICATION_LENGTH ];
+    char cString[ loggingDEFERRED_MAX_STRING_LENGTH + 1U ];
+    size_t xSpecificationLength;
+    size_t xIndex;
+    uint8_t ucStringLength;
+    int iStar;
+    int iWritten;
+    char * pcOutput;
+    size_t xOutputSize;
+
+    /* Copy the specification, replacing each '*' with the recorded
+     * value so that exactly one argument is left to pass to snprintf(). */
+    xSpecificationLength = 0U;
+
+    for( xIndex = 0U; xIndex < pxConversion->xLength; xIndex++ )
+    {
+        if( pxConversion->pcStart[ xIndex ] == '*' )
+        {
+            prvRingCopyOut( pxRing, *pxRead, &iStar, sizeof( iStar ) );
+            *pxRead += sizeof( iStar );
+            iWritten = snprintf( &( cSpecification[ xSpecificationLength ] ),
+                                 sizeof( cSpecification ) - xSpecificationLength,
+                                 "%d", iStar );
+
+            if( iWritten > 0 )
+            {
+                xSpecificationLength += ( size_t ) iWritten;
+            }
+        }
+        else if( xSpecificationLength < ( sizeof( cSpecification ) - 1U ) )
+        {
+            cSpecification[ xSpecificationLength ] = pxConversion->pcStart[ xIndex ];
+            xSpecificationLength++;
+        }
+        else
+        {
+            /* Over-long specifications are truncated. */
+        }
+
+        if( xSpecificationLength >= ( sizeof( cSpecification ) - 1U ) )
+        {
+            xSpecificationLength = sizeof( cSpecification ) - 1U;
+        }
+    }
+
+    cSpecification[ xSpecificationLength ] = '\0';
+
+    pcOutput = &( pxMessage->cBuffer[ pxMessage->xLength ] );
+    xOutputSize = sizeof( pxMessage->cBuffer ) - pxMessage->xLength;
+
+    switch( pxConversion->eType )
+    {
+        case eLoggingArgInt:
+            prvRingCopyOut( pxRing, *pxRead, &xValue.iValue, sizeof( xValue.iValue ) );
+            *pxRead += sizeof( xValue.iValue );
+            iWritten = snprintf( pcOutput, xOutputSize, cSpecification, xValue.iValue );
+            break;
+
+        case eLoggingArgLong:
+            prvRingCopyOut( pxRing, *pxRead, &xValue.lValue, sizeof( xValue.lValue ) );
+            *pxRead += sizeof( xValue.lValue );
+            iWritten = snprintf( pcOutput, xOutputSize, cSpecification, xValue.lValue );
+            break;
+
+        case eLoggingArgLongLong:
+            prvRingCopyOut( pxRing, *pxRead, &xValue.llValue, sizeof( xValue.llValue ) );
+            *pxRead += sizeof( xValue.llValue );
+            iWritten = snprintf( pcOutput, xOutputSize, cSpecification, xValue.llValue );
+            break;
+
+        case eLoggingArgSize:
+            prvRingCopyOut( pxRing, *pxRead, &xValue.xSize, sizeof( xValue.xSize ) );
+            *pxRead += sizeof( xValue.xSize );
+            iWritten = snprintf( pcOutput, xOutputSize, cSpecification, xValue.xSize );
+            break;
+
+        case eLoggingArgIntMax:
+            prvRingCopyOut( pxRing, *pxRead, &xValue.xIntMax, sizeof( xValue.xIntMax ) );
+            *pxRead += sizeof( xValue.xIntMax );
+            iWritten = snprintf( pcOutput, xOutputSize, cSpecification, xValue.xIntMax );
+            break;
+
+        case eLoggingArgPtrDiff:
+            prvRingCopyOut( pxRing, *pxRead, &xValue.xPtrDiff, sizeof( xValue.xPtrDiff ) );
+            *pxRead += sizeof( xValue.xPtrDiff );
+            iWritten = snprintf( pcOutput, xOutputSize, cSpecification, xValue.xPtrDiff );
+            break;
+
+        case eLoggingArgPointer:
+            prvRingCopyOut( pxRing, *pxRead, &xValue.pvValue, sizeof( xValue.pvValue ) );
+            *pxRead += sizeof( xValue.pvValue );
+            iWritten = snprintf( pcOutput, xOutputSize, cSpecification, xValue.pvValue );
+            break;
+
+        case eLoggingArgString:
+            prvRingCopyOut( pxRing, *pxRead, &ucStringLength, sizeof( ucStringLength ) );
+            *pxRead += sizeof( ucStringLength );
+            prvRingCopyOut( pxRing, *pxRead, cString, ucStringLength );
+            *pxRead += ucStringLength;
+            cString[ ucStringLength ] = '\0';
+            iWritten = snprintf( pcOutput, xOutputSize, cSpecification, cString );
+            break;
+
+        case eLoggingArgDouble:
+            prvRingCopyOut( pxRing, *pxRead, &xValue.dValue, sizeof( xValue.dValue ) );
+            *pxRead += sizeof( xValue.dValue );
+            iWritten = snprintf( pcOutput, xOutputSize, cSpecification, xValue.dValue );
+            break;
+
+        case eLoggingArgLongDouble:
+            prvRingCopyOut( pxRing, *pxRead, &xValue.ldValue, sizeof( xValue.ldValue ) );
+            *pxRead += sizeof( xValue.ldValue );
+            iWritten = snprintf( pcOutput, xOutputSize, cSpecification, xValue.ldValue );
+            break;
+
+        default:
+            iWritten = 0;
+            break;
+    }
+
+    prvMessageCommit( pxMessage, iWritten );
+}
+/*-----------------------------------------------------------*/
+
+static void prvFormatRecord( LoggingRing_t * pxRing,
+                             LoggingMessage_t * pxMessage )
+{
+    LoggingConversion_t xConversion;
+    const char * pcFormat;
+    const char * pcCurrent;
+    size_t xTail = pxRing->xTail;
+    size_t xRead;
+    uint16_t usRecordLength;
+
+    prvRingCopyOut( pxRing, xTail, &usRecordLength, sizeof( usRecordLength ) );
+    prvRingCopyOut( pxRing, xTail + sizeof( usRecordLength ), &pcFormat, sizeof( pcFormat ) );
+    xRead = xTail + sizeof( usRecordLength ) + sizeof( pcFormat );
+
+    pxMessage->xLength = 0U;
+    pcCurrent = pcFormat;
+
+    while( ( prvNextConversion( pcCurrent, &xConversion ) == pdTRUE ) &&
+           ( xConversion.eType != eLoggingArgUnsupported ) )
+    {
+        /* Literal text up to the conversion. */
+        prvMessageAppend( pxMessage, pcCurrent, ( size_t ) ( xConversion.pcStart - pcCurrent ) );
+        pcCurrent = xConversion.pcStart + xConversion.xLength;
+
+        if( xConversion.eType == eLoggingArgNone )
+        {
+            prvMessageAppend( pxMessage, "%", 1U );
+        }
+        else
+        {
+            prvFormatArgument( pxRing, &xConversion, &xRead, pxMessage );
+        }
+    }
+
+    /* The rest of the format string, which is also where output stops being
+     * interpreted after an unsupported conversion. */
+    prvMessageAppend( pxMessage, pcCurrent, strlen( pcCurrent ) );
+
+    configASSERT( xRead <= ( xTail + usRecordLength ) );
+
+    /* Only release the record once it has been read completely. */
+    portMEMORY_BARRIER();
+    pxRing->xTail = xTail + usRecordLength;
+}
+/*-----------------------------------------------------------*/
+
+#if ( loggingDEFERRED_BINARY_ENABLED == 1 )
+
+    static BaseType_t prvOutputBinaryRecord( LoggingRing_t * pxRing )
+    {
+        uint8_t ucHeader[ ldBINARY_HEADER_LENGTH ];
+        const char * pcFormat;
+        uintptr_t uxFormat;
+        uintptr_t uxSectionStart = ( uintptr_t ) __start_log_strings;
+        uintptr_t uxSectionEnd = ( uintptr_t ) __stop_log_strings;
+        size_t xTail = pxRing->xTail;
+        size_t xArgs;
+        size_t xArgsLength;
+        size_t xOffset;
+        size_t xFirstLength;
+        uint16_t usRecordLength;
+        uint16_t usFrameLength;
+        uint16_t usFormatOffset;
+        BaseType_t xReturn = pdFALSE;
+
+        prvRingCopyOut( pxRing, xTail, &usRecordLength, sizeof( usRecordLength ) );
+        prvRingCopyOut( pxRing, xTail + sizeof( usRecordLength ), &pcFormat, sizeof( pcFormat ) );
+        uxFormat = ( uintptr_t ) pcFormat;
+
+        if( ( uxFormat >= uxSectionStart ) &&
+            ( uxFormat < uxSectionEnd ) &&
+            ( ( uxFormat - uxSectionStart ) <= UINT16_MAX ) )
+        {
+            xArgs = xTail + sizeof( usRecordLength ) + sizeof( pcFormat );
+            xArgsLength = ( size_t ) usRecordLength - sizeof( usRecordLength ) - sizeof( pcFormat );
+
+            /* The format string pointer is at least as wide as the offset that
+             * replaces it, so the frame length always fits. */
+            usFrameLength = ( uint16_t ) ( sizeof( usFormatOffset ) + xArgsLength );
+            usFormatOffset = ( uint16_t ) ( uxFormat - uxSectionStart );
+
+            ucHeader[ 0 ] = ldBINARY_FRAME_MARKER;
+            ( void ) memcpy( &( ucHeader[ 1 ] ), &usFrameLength, sizeof( usFrameLength ) );
+            ( void ) memcpy( &( ucHeader[ 1U + sizeof( usFrameLength ) ] ), &usFormatOffset, sizeof( usFormatOffset ) );
+            loggingDEFERRED_OUTPUT( ( const char * ) ucHeader, sizeof( ucHeader ) );
+
+            /* The arguments are output straight from the ring, in up to two
+             * pieces if they wrap around its end. */
+            xOffset = xArgs & ldRING_INDEX_MASK;
+            xFirstLength = loggingDEFERRED_RING_SIZE - xOffset;
+
+            if( xFirstLength > xArgsLength )
+            {
+                xFirstLength = xArgsLength;
+            }
+
+            if( xFirstLength > 0U )
+            {
+                loggingDEFERRED_OUTPUT( ( const char * ) &( pxRing->ucBuffer[ xOffset ] ), xFirstLength );
+            }
+
+            if( xArgsLength > xFirstLength )
+            {
+                loggingDEFERRED_OUTPUT( ( const char * ) pxRing->ucBuffer, xArgsLength - xFirstLength );
+            }
+
+            /* Only release the record once it has been output. */
+            portMEMORY_BARRIER();
+            pxRing->xTail = xTail + usRecordLength;
+            xReturn = pdTRUE;
+        }
+
+        return xReturn;
+    }
+
+#endif /* if ( loggingDEFERRED_BINARY_ENABLED == 1 ) */
+/*-----------------------------------------------------------*/
+
+static void prvOutputRecord( LoggingRing_t * pxRing,
+                             LoggingMessage_t * pxMessage )
+{
+    BaseType_t xOutput = pdFALSE;
+
+    #if ( loggingDEFERRED_BINARY_ENABLED == 1 )
+    {
+        xOutput = prvOutputBinaryRecord( pxRing );
+    }
+    #endif
+
+    if( xOutput == pdFALSE )
+    {
+        prvFormatRecord( pxRing, pxMessage );
+        loggingDEFERRED_OUTPUT( pxMessage->cBuffer, pxMessage->xLength );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvLoggingTask( void * pvParameters )
+{
+    static LoggingMessage_t xMessage;
+    LoggingRing_t * pxRing;
+    TickType_t xPollPeriod = pdMS_TO_TICKS( loggingDEFERRED_POLL_PERIOD_MS );
+    uint32_t ulDropped;
+    UBaseType_t ux;
+
+    ( void ) pvParameters;
+
+    if( xPollPeriod == 0U )
+    {
+        xPollPeriod = 1U;
+    }
+
+    for( ; ; )
+    {
+        for( ux = 0U; ux < loggingDEFERRED_RING_COUNT; ux++ )
+        {
+            pxRing = &( xRings[ ux ] );
+
+            while( pxRing->xTail != pxRing->xHead )
+            {
+                /* Do not read the record before its head was seen. */
+                portMEMORY_BARRIER();
+                prvOutputRecord( pxRing, &xMessage );
+            }
+
+            ulDropped = pxRing->ulDropped;
+
+            if( ulDropped != pxRing->ulDroppedReported )
+            {
+                xMessage.xLength = 0U;
+                prvMessageCommit( &xMessage,
+                                  snprintf( xMessage.cBuffer, sizeof( xMessage.cBuffer ),
+                                            "[Logging] %lu message(s) from %s dropped.\r\n",
+                                            ( unsigned long ) ( ulDropped - pxRing->ulDroppedReported ),
+                                            pcTaskGetName( pxRing->xOwner ) ) );
+                loggingDEFERRED_OUTPUT( xMessage.cBuffer, xMessage.xLength );
+                pxRing->ulDroppedReported = ulDropped;
+            }
+        }
+
+        ulDropped = ulUnassignedDropped;
+
+        if( ulDropped != ulUnassignedDroppedReported )
+        {
+            xMessage.xLength = 0U;
+            prvMessageCommit( &xMessage,
+                              snprintf( xMessage.cBuffer, sizeof( xMessage.cBuffer ),
+                                        "[Logging] %lu message(s) dropped, increase loggingDEFERRED_RING_COUNT.\r\n",
+                                        ( unsigned long ) ( ulDropped - ulUnassignedDroppedReported ) ) );
+            loggingDEFERRED_OUTPUT( xMessage.cBuffer, xMessage.xLength );
+            ulUnassignedDroppedReported = ulDropped;
+        }
+
+        vTaskDelay( xPollPeriod );
+    }
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xLoggingDeferredInit( UBaseType_t uxPriority,
+                                 configSTACK_DEPTH_TYPE usStackDepth )
+{
+    /* Can only be called before the scheduler has started. */
+    configASSERT( xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED );
+
+    return xTaskCreate( prvLoggingTask, "Logger", usStackDepth, NULL, uxPriority, NULL );
+}
+/*-----------------------------------------------------------*/
+
+void vLoggingDeferredPrintf( const char * pcFormat,
+                             ... )
+{
+    static LoggingMessage_t xDirectMessage;
+    LoggingRing_t * pxRing;
+    va_list xArgs;
+
+    va_start( xArgs, pcFormat );
+
+    if( xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED )
+    {
+        /* There is no task to defer to yet, and nothing to disturb either. */
+        xDirectMessage.xLength = 0U;
+        prvMessageCommit( &xDirectMessage, vsnprintf( xDirectMessage.cBuffer, sizeof( xDirectMessage.cBuffer ), pcFormat, xArgs ) );
+        loggingDEFERRED_OUTPUT( xDirectMessage.cBuffer, xDirectMessage.xLength );
+    }
+    else
+    {
+        pxRing = prvGetRing();
+
+        if( pxRing != NULL )
+        {
+            prvRecordMessage( pxRing, pcFormat, xArgs );
+        }
+    }
+
+    va_end( xArgs );
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulLoggingDeferredGetDroppedCount( void )
+{
+    uint32_t ulDropped = ulUnassignedDropped;
+    UBaseType_t ux;
+
+    for( ux = 0U; ux < loggingDEFERRED_RING_COUNT; ux++ )
+    {
+        ulDropped += xRings[ ux ].ulDropped;
+    }
+
+    return ulDropped;
+}
+/*-----------------------------------------------------------*/
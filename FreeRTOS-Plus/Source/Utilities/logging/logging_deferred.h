@@ -0,0 +1,189 @@
+/*
+ * FreeRTOS V202212.01
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/**
+ * @file logging_deferred.h
+ * @brief Deferred logging backend for the logging interface macros (LogError,
+ * LogWarn, LogInfo, LogDebug).
+ *
+ * vLoggingDeferredPrintf() does not format anything in the context of the
+ * calling task.  It records the format string pointer and the binary values of
+ * the arguments into a ring buffer owned by the calling task, and a low
+ * priority logger task formats and outputs the records later.  Each ring has a
+ * single producer (its task) and a single consumer (the logger task), so
+ * recording a message takes no lock and makes no kernel call.  Messages that
+ * do not fit in the ring are dropped and counted instead of blocking the
+ * caller.
+ *
+ * To route the logging interface macros through this backend, define SdkLog
+ * as follows before including logging_stack.h:
+ *
+ * @code{c}
+ * #define SdkLog( message )    vLoggingDeferredPrintf message
+ * @endcode
+ *
+ * The format string must remain valid until the message is output, which is
+ * always the case for string literals.  String arguments ("%s") are copied, up
+ * to loggingDEFERRED_MAX_STRING_LENGTH characters.  The supported conversions
+ * are d, i, u, o, x, X, c, s, p, f, F, e, E, g, G, a and A with the hh, h, l,
+ * ll, z, j, t and L length modifiers, '*' field widths and precisions, and
+ * "%%".  vLoggingDeferredPrintf() must only be called from tasks, never from
+ * interrupts.
+ *
+ * INCLUDE_xTaskGetSchedulerState must be set to 1 in FreeRTOSConfig.h.
+ */
+
+#ifndef LOGGING_DEFERRED_H
+#define LOGGING_DEFERRED_H
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdint.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/**
+ * @brief The number of tasks that can log through the deferred backend.  A
+ * ring is assigned to a task the first time it logs, and stays assigned to it.
+ * Messages from tasks that log once all the rings are taken are dropped.
+ */
+#ifndef loggingDEFERRED_RING_COUNT
+    #define loggingDEFERRED_RING_COUNT    8U
+#endif
+
+/**
+ * @brief The size of each per-task ring in bytes.  Must be a power of two.
+ */
+#ifndef loggingDEFERRED_RING_SIZE
+    #define loggingDEFERRED_RING_SIZE    1024U
+#endif
+
+/**
+ * @brief The maximum number of characters of a "%s" argument copied into a
+ * ring.  Longer strings are truncated.
+ */
+#ifndef loggingDEFERRED_MAX_STRING_LENGTH
+    #define loggingDEFERRED_MAX_STRING_LENGTH    64U
+#endif
+
+/**
+ * @brief The size of the buffer into which the logger task formats each
+ * message.  Longer messages are truncated.
+ */
+#ifndef loggingDEFERRED_MAX_MESSAGE_LENGTH
+    #define loggingDEFERRED_MAX_MESSAGE_LENGTH    256U
+#endif
+
+/**
+ * @brief The period at which the logger task polls the rings for messages.
+ * Polling keeps the logging tasks free of kernel calls.
+ */
+#ifndef loggingDEFERRED_POLL_PERIOD_MS
+    #define loggingDEFERRED_POLL_PERIOD_MS    10U
+#endif
+
+/**
+ * @brief Writes a formatted message to the log output.  Called from the logger
+ * task, or directly from vLoggingDeferredPrintf() before the scheduler starts.
+ */
+#ifndef loggingDEFERRED_OUTPUT
+    #define loggingDEFERRED_OUTPUT( pcMessage, xLength )    ( void ) fwrite( ( pcMessage ), 1, ( xLength ), stdout )
+#endif
+
+/**
+ * @brief Set to 1 to output the messages of the logging interface macros
+ * (LogError, LogWarn, LogInfo, LogDebug) as binary frames instead of text.
+ *
+ * In binary mode logging_stack.h places the format string of each macro,
+ * prefixed with its level, library name, file and line, in the
+ * #loggingDEFERRED_BINARY_SECTION linker section.  The logger task then
+ * outputs each of their records as a frame holding the offset of the format
+ * string in that section and the recorded argument bytes, without formatting
+ * anything.  A frame is laid out as follows, in the byte order of the target
+ * and without any padding:
+ *
+ *   uint8_t  0x00, which marks the start of a frame in the text output.
+ *   uint16_t Length of the rest of the frame.
+ *   uint16_t Offset of the format string in the section.
+ *   ...      The arguments, encoded as in the rings (see logging_deferred.c).
+ *
+ * Messages from other callers of vLoggingDeferredPrintf() are still output as
+ * text, in the same stream.  logging_decoder.py expands the frames back into
+ * text using the section contents of the ELF file of the application.
+ *
+ * The format strings are still read on the target to find the arguments to
+ * record, so binary mode saves formatting time and output bandwidth, not
+ * flash.  It requires a GCC compatible compiler and a GNU compatible linker,
+ * which provides the __start_ and __stop_ symbols of the section.  Linker
+ * scripts that garbage collect sections must KEEP() it, and the section must
+ * stay under 64KB since format strings past that offset are output as text.
+ */
+#ifndef loggingDEFERRED_BINARY_ENABLED
+    #define loggingDEFERRED_BINARY_ENABLED    0
+#endif
+
+/**
+ * @brief The linker section holding the format strings of binary mode.  It
+ * must be a valid C identifier for the linker to define its __start_ and
+ * __stop_ symbols.
+ */
+#define loggingDEFERRED_BINARY_SECTION    "log_strings"
+
+/**
+ * @brief Create the logger task that formats and outputs the recorded
+ * messages.  Must be called before the scheduler is started.
+ *
+ * @param[in] uxPriority The priority of the logger task.  It should be lower
+ * than that of every task whose timing must not be disturbed by logging.
+ * @param[in] usStackDepth The stack depth of the logger task, in words.
+ *
+ * @return pdPASS if the logger task was created, pdFAIL otherwise.
+ */
+BaseType_t xLoggingDeferredInit( UBaseType_t uxPriority,
+                                 configSTACK_DEPTH_TYPE usStackDepth );
+
+/**
+ * @brief Record a printf-style message for deferred output.
+ *
+ * Before the scheduler is started the message is formatted and output
+ * directly.
+ *
+ * @param[in] pcFormat The format string, which must outlive the message.
+ */
+void vLoggingDeferredPrintf( const char * pcFormat,
+                             ... );
+
+/**
+ * @brief Get the number of messages dropped so far, either because the ring
+ * of the calling task was full or because no ring was left for it.
+ *
+ * @return The total number of dropped messages.
+ */
+uint32_t ulLoggingDeferredGetDroppedCount( void );
+
+#endif /* LOGGING_DEFERRED_H */
@@ -72,12 +72,57 @@
  * function.
  *
  * @note The default definition of this macro generates logging via a printf-like
- * vLoggingPrintf function.
+ * vLoggingPrintf function.  To keep formatting and output out of the logging
+ * task, it can instead be mapped to vLoggingDeferredPrintf from
+ * logging_deferred.h.
  */
 #ifndef SdkLog
     #define SdkLog( message )    vLoggingPrintf message
 #endif
 
+#if defined( loggingDEFERRED_BINARY_ENABLED ) && ( loggingDEFERRED_BINARY_ENABLED == 1 )
+    #include "logging_deferred.h"
+
+/**
+ * @brief Emit one message of a logging interface macro in the binary mode of
+ * logging_deferred.h.
+ *
+ * The metadata and the message format are joined at compile time into a
+ * single format string placed in the #loggingDEFERRED_BINARY_SECTION section,
+ * whose offset in that section identifies the message on the wire.  The
+ * metadata is therefore `[<LEVEL>] [<LIBRARY-NAME>] [<file>:<line>] `, and
+ * both LIBRARY_LOG_NAME and the message format must be string literals.
+ * SdkLog, #LOG_METADATA_FORMAT and #LOG_METADATA_ARGS are not used.
+ */
+    #define LOG_MESSAGE( level, message )                                                       \
+    do                                                                                          \
+    {                                                                                           \
+        static const char pcLogFormat[]                                                         \
+        __attribute__( ( section( loggingDEFERRED_BINARY_SECTION ), used ) ) =                  \
+            "[" level "] [" LIBRARY_LOG_NAME "] [" __FILE__ ":" LOG_STRINGIFY( __LINE__ ) "] "  \
+            LOG_BINARY_FORMAT message "\r\n";                                                   \
+        vLoggingDeferredPrintf( pcLogFormat, LOG_BINARY_ARGS message );                         \
+    } while( 0 )
+
+    #define LOG_STRINGIFY_( x )    #x
+    #define LOG_STRINGIFY( x )     LOG_STRINGIFY_( x )
+
+/* Split the parenthesized message into its format and its arguments.  A
+ * trailing 0 is appended so that a message without arguments is still valid;
+ * vLoggingDeferredPrintf() ignores the extra argument. */
+    #define LOG_BINARY_FIRST( pcFormat, ... )    pcFormat
+    #define LOG_BINARY_REST( pcFormat, ... )     __VA_ARGS__
+    #define LOG_BINARY_FORMAT( ... )             LOG_BINARY_FIRST( __VA_ARGS__, 0 )
+    #define LOG_BINARY_ARGS( ... )               LOG_BINARY_REST( __VA_ARGS__, 0 )
+#else
+
+/**
+ * @brief Emit one message of a logging interface macro through SdkLog, with
+ * its metadata prefix and a line ending.
+ */
+    #define LOG_MESSAGE( level, message )    SdkLog( ( "[" level "] [%s] "LOG_METADATA_FORMAT, LIBRARY_LOG_NAME, LOG_METADATA_ARGS ) ); SdkLog( message ); SdkLog( ( "\r\n" ) )
+#endif
+
 /**
  * Disable definition of logging interface macros when generating doxygen output,
  * to avoid conflict with documentation of macros at the end of the file.
@@ -93,28 +138,28 @@
 #else
     #if LIBRARY_LOG_LEVEL == LOG_DEBUG
         /* All log level messages will logged. */
-        #define LogError( message )    SdkLog( ( "[ERROR] [%s] "LOG_METADATA_FORMAT, LIBRARY_LOG_NAME, LOG_METADATA_ARGS ) ); SdkLog( message ); SdkLog( ( "\r\n" ) )
-        #define LogWarn( message )     SdkLog( ( "[WARN] [%s] "LOG_METADATA_FORMAT, LIBRARY_LOG_NAME, LOG_METADATA_ARGS ) ); SdkLog( message ); SdkLog( ( "\r\n" ) )
-        #define LogInfo( message )     SdkLog( ( "[INFO] [%s] "LOG_METADATA_FORMAT, LIBRARY_LOG_NAME, LOG_METADATA_ARGS ) ); SdkLog( message ); SdkLog( ( "\r\n" ) )
-        #define LogDebug( message )    SdkLog( ( "[DEBUG] [%s] "LOG_METADATA_FORMAT, LIBRARY_LOG_NAME, LOG_METADATA_ARGS ) ); SdkLog( message ); SdkLog( ( "\r\n" ) )
+        #define LogError( message )    LOG_MESSAGE( "ERROR", message )
+        #define LogWarn( message )     LOG_MESSAGE( "WARN", message )
+        #define LogInfo( message )     LOG_MESSAGE( "INFO", message )
+        #define LogDebug( message )    LOG_MESSAGE( "DEBUG", message )
 
     #elif LIBRARY_LOG_LEVEL == LOG_INFO
         /* Only INFO, WARNING and ERROR messages will be logged. */
-        #define LogError( message )    SdkLog( ( "[ERROR] [%s] "LOG_METADATA_FORMAT, LIBRARY_LOG_NAME, LOG_METADATA_ARGS ) ); SdkLog( message ); SdkLog( ( "\r\n" ) )
-        #define LogWarn( message )     SdkLog( ( "[WARN] [%s] "LOG_METADATA_FORMAT, LIBRARY_LOG_NAME, LOG_METADATA_ARGS ) ); SdkLog( message ); SdkLog( ( "\r\n" ) )
-        #define LogInfo( message )     SdkLog( ( "[INFO] [%s] "LOG_METADATA_FORMAT, LIBRARY_LOG_NAME, LOG_METADATA_ARGS ) ); SdkLog( message ); SdkLog( ( "\r\n" ) )
+        #define LogError( message )    LOG_MESSAGE( "ERROR", message )
+        #define LogWarn( message )     LOG_MESSAGE( "WARN", message )
+        #define LogInfo( message )     LOG_MESSAGE( "INFO", message )
         #define LogDebug( message )
 
     #elif LIBRARY_LOG_LEVEL == LOG_WARN
         /* Only WARNING and ERROR messages will be logged.*/
-        #define LogError( message )    SdkLog( ( "[ERROR] [%s] "LOG_METADATA_FORMAT, LIBRARY_LOG_NAME, LOG_METADATA_ARGS ) ); SdkLog( message ); SdkLog( ( "\r\n" ) )
-        #define LogWarn( message )     SdkLog( ( "[WARN] [%s] "LOG_METADATA_FORMAT, LIBRARY_LOG_NAME, LOG_METADATA_ARGS ) ); SdkLog( message ); SdkLog( ( "\r\n" ) )
+        #define LogError( message )    LOG_MESSAGE( "ERROR", message )
+        #define LogWarn( message )     LOG_MESSAGE( "WARN", message )
         #define LogInfo( message )
         #define LogDebug( message )
 
     #elif LIBRARY_LOG_LEVEL == LOG_ERROR
         /* Only ERROR messages will be logged. */
-        #define LogError( message )    SdkLog( ( "[ERROR] [%s] "LOG_METADATA_FORMAT, LIBRARY_LOG_NAME, LOG_METADATA_ARGS ) ); SdkLog( message ); SdkLog( ( "\r\n" ) )
+        #define LogError( message )    LOG_MESSAGE( "ERROR", message )
         #define LogWarn( message )
         #define LogInfo( message )
         #define LogDebug( message )
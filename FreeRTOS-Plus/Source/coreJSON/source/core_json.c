@@ -62,6 +62,154 @@ typedef union
 #define isSquareOpen_( x )            ( ( x ) == '[' )
 #define isSquareClose_( x )           ( ( x ) == ']' )
 
+/* When JSON_ENABLE_SIMD is defined, runs of whitespace and of plain
+ * string characters are skipped a block at a time.  Every other byte
+ * is still checked by the scalar code below, so the accepted grammar
+ * is identical with or without it. */
+#ifdef JSON_ENABLE_SIMD
+    #if defined( __AVX2__ )
+        #include <immintrin.h>
+        #define JSON_SIMD_WIDTH    ( 32U )
+    #elif defined( __SSE2__ )
+        #include <emmintrin.h>
+        #define JSON_SIMD_WIDTH    ( 16U )
+    #elif defined( __ARM_NEON ) && defined( __aarch64__ )
+        #include <arm_neon.h>
+        #define JSON_SIMD_WIDTH    ( 16U )
+    #endif
+#endif
+
+#ifdef JSON_SIMD_WIDTH
+
+/**
+ * @brief Count the leading bytes of a block which are JSON whitespace
+ * or, when @p inString is true, plain string characters.
+ *
+ * A plain string character is printable ASCII other than a double quote
+ * or a backslash, i.e., a byte needing no further validation in a string.
+ *
+ * @param[in] p  The block; JSON_SIMD_WIDTH bytes must be readable.
+ * @param[in] inString  Whether to count plain string characters or whitespace.
+ *
+ * @return the count, from 0 to JSON_SIMD_WIDTH.
+ */
+static size_t leadingRun( const char * p,
+                          bool inString )
+{
+    size_t ret;
+
+    #if defined( __AVX2__ )
+        __m256i v = _mm256_loadu_si256( ( const __m256i * ) p );
+        __m256i match;
+        uint32_t mask;
+
+        if( inString == true )
+        {
+            /* Signed compare: bytes 0x80 and above are negative. */
+            match = _mm256_andnot_si256( _mm256_or_si256( _mm256_cmpeq_epi8( v, _mm256_set1_epi8( '"' ) ),
+                                                          _mm256_cmpeq_epi8( v, _mm256_set1_epi8( '\\' ) ) ),
+                                         _mm256_cmpgt_epi8( v, _mm256_set1_epi8( 0x1F ) ) );
+        }
+        else
+        {
+            match = _mm256_or_si256( _mm256_or_si256( _mm256_cmpeq_epi8( v, _mm256_set1_epi8( ' ' ) ),
+                                                      _mm256_cmpeq_epi8( v, _mm256_set1_epi8( '\t' ) ) ),
+                                     _mm256_or_si256( _mm256_cmpeq_epi8( v, _mm256_set1_epi8( '\n' ) ),
+                                                      _mm256_cmpeq_epi8( v, _mm256_set1_epi8( '\r' ) ) ) );
+        }
+
+        mask = ~( uint32_t ) _mm256_movemask_epi8( match );
+        ret = ( mask == 0U ) ? JSON_SIMD_WIDTH : ( size_t ) __builtin_ctz( mask );
+    #elif defined( __SSE2__ )
+        __m128i v = _mm_loadu_si128( ( const __m128i * ) p );
+        __m128i match;
+        uint32_t mask;
+
+        if( inString == true )
+        {
+            /* Signed compare: bytes 0x80 and above are negative. */
+            match = _mm_andnot_si128( _mm_or_si128( _mm_cmpeq_epi8( v, _mm_set1_epi8( '"' ) ),
+                                                    _mm_cmpeq_epi8( v, _mm_set1_epi8( '\\' ) ) ),
+                                      _mm_cmpgt_epi8( v, _mm_set1_epi8( 0x1F ) ) );
+        }
+        else
+        {
+            match = _mm_or_si128( _mm_or_si128( _mm_cmpeq_epi8( v, _mm_set1_epi8( ' ' ) ),
+                                                _mm_cmpeq_epi8( v, _mm_set1_epi8( '\t' ) ) ),
+                                  _mm_or_si128( _mm_cmpeq_epi8( v, _mm_set1_epi8( '\n' ) ),
+                                                _mm_cmpeq_epi8( v, _mm_set1_epi8( '\r' ) ) ) );
+        }
+
+        /* The upper 16 bits of the inverted mask are always set. */
+        mask = ~( uint32_t ) _mm_movemask_epi8( match );
+        ret = ( size_t ) __builtin_ctz( mask );
+    #else /* AArch64 NEON */
+        int8x16_t v = vld1q_s8( ( const int8_t * ) p );
+        uint8x16_t match;
+        uint64_t mask;
+
+        if( inString == true )
+        {
+            /* Signed compare: bytes 0x80 and above are negative. */
+            match = vbicq_u8( vcgtq_s8( v, vdupq_n_s8( 0x1F ) ),
+                              vorrq_u8( vceqq_s8( v, vdupq_n_s8( '"' ) ),
+                                        vceqq_s8( v, vdupq_n_s8( '\\' ) ) ) );
+        }
+        else
+        {
+            match = vorrq_u8( vorrq_u8( vceqq_s8( v, vdupq_n_s8( ' ' ) ),
+                                        vceqq_s8( v, vdupq_n_s8( '\t' ) ) ),
+                              vorrq_u8( vceqq_s8( v, vdupq_n_s8( '\n' ) ),
+                                        vceqq_s8( v, vdupq_n_s8( '\r' ) ) ) );
+        }
+
+        /* Narrow each byte of the comparison to a nibble of a 64-bit mask. */
+        mask = ~vget_lane_u64( vreinterpret_u64_u8( vshrn_n_u16( vreinterpretq_u16_u8( match ), 4 ) ), 0 );
+        ret = ( mask == 0U ) ? JSON_SIMD_WIDTH : ( ( size_t ) __builtin_ctzll( mask ) >> 2U );
+    #endif /* if defined( __AVX2__ ) */
+
+    return ret;
+}
+
+/**
+ * @brief Advance buffer index beyond whole blocks of whitespace or plain
+ * string characters.
+ *
+ * @param[in] buf  The buffer to parse.
+ * @param[in,out] start  The index at which to begin.
+ * @param[in] max  The size of the buffer.
+ * @param[in] inString  Whether to skip plain string characters or whitespace.
+ *
+ * @note Fewer than JSON_SIMD_WIDTH bytes at the end of the buffer are
+ * left for the scalar code.
+ */
+static void skipRun( const char * buf,
+                     size_t * start,
+                     size_t max,
+                     bool inString )
+{
+    size_t i, n;
+
+    assert( ( buf != NULL ) && ( start != NULL ) );
+
+    i = *start;
+
+    while( ( i < max ) && ( ( max - i ) >= JSON_SIMD_WIDTH ) )
+    {
+        n = leadingRun( &buf[ i ], inString );
+        i += n;
+
+        if( n < JSON_SIMD_WIDTH )
+        {
+            break;
+        }
+    }
+
+    *start = i;
+}
+
+#endif /* ifdef JSON_SIMD_WIDTH */
+
 /**
  * @brief Advance buffer index beyond whitespace.
  *
@@ -77,7 +225,13 @@ static void skipSpace( const char * buf,
 
     assert( ( buf != NULL ) && ( start != NULL ) && ( max > 0U ) );
 
-    for( i = *start; i < max; i++ )
+    i = *start;
+
+    #ifdef JSON_SIMD_WIDTH
+        skipRun( buf, &i, max, false );
+    #endif
+
+    for( ; i < max; i++ )
     {
         if( !isspace_( buf[ i ] ) )
         {
@@ -523,6 +677,15 @@ static bool skipString( const char * buf,
 
         while( i < max )
         {
+            #ifdef JSON_SIMD_WIDTH
+                skipRun( buf, &i, max, true );
+
+                if( i == max )
+                {
+                    break;
+                }
+            #endif
+
             if( buf[ i ] == '"' )
             {
                 ret = true;
@@ -1043,9 +1206,6 @@ static void skipScalars( const char * buf,
  * #JSONMaxDepthExceeded if object and array nesting exceeds a threshold;
  * #JSONPartial if the buffer contents are potentially valid but incomplete.
  */
-#ifndef JSON_MAX_DEPTH
-    #define JSON_MAX_DEPTH    32
-#endif
 static JSONStatus_t skipCollection( const char * buf,
                                     size_t * start,
                                     size_t max )
@@ -1480,6 +1640,82 @@ static bool skipQueryPart( const char * buf,
     return ret;
 }
 
+/**
+ * @brief Advance query index beyond the next part of a query.
+ *
+ * A part is either an array index in square brackets or an object key.
+ * A separator following the part is also skipped.
+ *
+ * @param[in] query  The object keys and array indexes to search for.
+ * @param[in,out] start  The index at which to begin.
+ * @param[in] queryLength  Length of the query.
+ * @param[out] outIndex  The array index, or -1 if the part is a key.
+ * @param[out] outKey  The index of the key within the query.
+ * @param[out] outKeyLength  The length of the key.
+ *
+ * @return #JSONSuccess if a part was present;
+ * #JSONBadParameter if the part is empty, or an index is too large
+ * to convert, or the query ends with a separator.
+ */
+static JSONStatus_t nextQueryPart( const char * query,
+                                   size_t * start,
+                                   size_t queryLength,
+                                   int32_t * outIndex,
+                                   size_t * outKey,
+                                   size_t * outKeyLength )
+{
+    JSONStatus_t ret = JSONSuccess;
+    size_t i;
+
+    assert( ( query != NULL ) && ( start != NULL ) && ( queryLength > 0U ) );
+    assert( ( outIndex != NULL ) && ( outKey != NULL ) && ( outKeyLength != NULL ) );
+
+    i = *start;
+    *outIndex = -1;
+
+    if( isSquareOpen_( query[ i ] ) )
+    {
+        int32_t queryIndex = -1;
+        i++;
+
+        ( void ) skipDigits( query, &i, queryLength, &queryIndex );
+
+        if( ( queryIndex < 0 ) ||
+            ( i >= queryLength ) || !isSquareClose_( query[ i ] ) )
+        {
+            ret = JSONBadParameter;
+        }
+        else
+        {
+            i++;
+            *outIndex = queryIndex;
+        }
+    }
+    else
+    {
+        *outKey = i;
+
+        if( ( skipQueryPart( query, &i, queryLength, outKeyLength ) != true ) ||
+            /* catch an empty key part or a trailing separator */
+            ( i == ( queryLength - 1U ) ) )
+        {
+            ret = JSONBadParameter;
+        }
+    }
+
+    if( ret == JSONSuccess )
+    {
+        if( ( i < queryLength ) && isSeparator_( query[ i ] ) )
+        {
+            i++;
+        }
+
+        *start = i;
+    }
+
+    return ret;
+}
+
 /**
  * @brief Handle a nested search by iterating over the parts of the query.
  *
@@ -1505,7 +1741,7 @@ static JSONStatus_t multiSearch( const char * buf,
                                  size_t * outValueLength )
 {
     JSONStatus_t ret = JSONSuccess;
-    size_t i = 0, start = 0, queryStart = 0, value = 0, length = max;
+    size_t i = 0, start = 0, value = 0, length = max;
 
     assert( ( buf != NULL ) && ( query != NULL ) );
     assert( ( outValue != NULL ) && ( outValueLength != NULL ) );
@@ -1514,39 +1750,22 @@ static JSONStatus_t multiSearch( const char * buf,
     while( i < queryLength )
     {
         bool found = false;
+        int32_t queryIndex = -1;
+        size_t queryStart = 0, keyLength = 0;
 
-        if( isSquareOpen_( query[ i ] ) )
-        {
-            int32_t queryIndex = -1;
-            i++;
-
-            ( void ) skipDigits( query, &i, queryLength, &queryIndex );
-
-            if( ( queryIndex < 0 ) ||
-                ( i >= queryLength ) || !isSquareClose_( query[ i ] ) )
-            {
-                ret = JSONBadParameter;
-                break;
-            }
+        ret = nextQueryPart( query, &i, queryLength, &queryIndex, &queryStart, &keyLength );
 
-            i++;
+        if( ret != JSONSuccess )
+        {
+            break;
+        }
 
+        if( queryIndex >= 0 )
+        {
             found = arraySearch( &buf[ start ], length, ( uint32_t ) queryIndex, &value, &length );
         }
         else
         {
-            size_t keyLength = 0;
-
-            queryStart = i;
-
-            if( ( skipQueryPart( query, &i, queryLength, &keyLength ) != true ) ||
-                /* catch an empty key part or a trailing separator */
-                ( i == ( queryLength - 1U ) ) )
-            {
-                ret = JSONBadParameter;
-                break;
-            }
-
             found = objectSearch( &buf[ start ], length, &query[ queryStart ], keyLength, &value, &length );
         }
 
@@ -1557,11 +1776,6 @@ static JSONStatus_t multiSearch( const char * buf,
         }
 
         start += value;
-
-        if( ( i < queryLength ) && isSeparator_( query[ i ] ) )
-        {
-            i++;
-        }
     }
 
     if( ret == JSONSuccess )
@@ -1816,3 +2030,1389 @@ JSONStatus_t JSON_Iterate( const char * buf,
 
     return ret;
 }
+
+/** @cond DO_NOT_DOCUMENT */
+
+/**
+ * @brief Append a value to a structural index, advancing the buffer
+ * index beyond a scalar or beyond the opening bracket of a collection.
+ *
+ * @param[in] buf  The buffer to parse.
+ * @param[in,out] start  The index at which to begin.
+ * @param[in] max  The size of the buffer.
+ * @param[in,out] index  The index being built.
+ * @param[in] key  The index of the key of the value, or 0 if there is none.
+ * @param[in] keyLength  The length of the key.
+ * @param[out] isCollection  Set to true if the value is an object or array.
+ *
+ * @return #JSONSuccess if a value was appended;
+ * #JSONIndexFull if there is no space left in the index;
+ * #JSONIllegalDocument if the buffer does not contain a valid value;
+ * #JSONPartial if the buffer ends before the value.
+ *
+ * @note The length and sibling link of a collection are filled in by the
+ * caller once its closing bracket is reached.
+ */
+static JSONStatus_t indexValue( const char * buf,
+                                size_t * start,
+                                size_t max,
+                                JSONIndex_t * index,
+                                size_t key,
+                                size_t keyLength,
+                                bool * isCollection )
+{
+    JSONStatus_t ret = JSONSuccess;
+    size_t i;
+    JSONIndexEntry_t * entry;
+
+    assert( ( buf != NULL ) && ( start != NULL ) && ( max > 0U ) );
+    assert( ( index != NULL ) && ( isCollection != NULL ) );
+
+    i = *start;
+    *isCollection = false;
+
+    if( i >= max )
+    {
+        ret = JSONPartial;
+    }
+    else if( index->entryCount >= index->maxEntries )
+    {
+        ret = JSONIndexFull;
+    }
+    else
+    {
+        entry = &index->entries[ index->entryCount ];
+        entry->key = key;
+        entry->keyLength = keyLength;
+        entry->value = i;
+
+        if( isOpenBracket_( buf[ i ] ) )
+        {
+            *isCollection = true;
+            i++;
+        }
+        else if( skipAnyScalar( buf, &i, max ) == true )
+        {
+            entry->valueLength = i - entry->value;
+            entry->next = index->entryCount + 1U;
+        }
+        else
+        {
+            ret = JSONIllegalDocument;
+        }
+    }
+
+    if( ret == JSONSuccess )
+    {
+        index->entryCount++;
+        *start = i;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Advance buffer index beyond an object key and the colon that follows it.
+ *
+ * @param[in] buf  The buffer to parse.
+ * @param[in,out] start  The index at which to begin.
+ * @param[in] max  The size of the buffer.
+ * @param[out] key  A pointer to receive the index of the key.
+ * @param[out] keyLength  A pointer to receive the length of the key.
+ *
+ * @return true if a key and colon were present;
+ * false otherwise.
+ */
+static bool skipKeyAndColon( const char * buf,
+                             size_t * start,
+                             size_t max,
+                             size_t * key,
+                             size_t * keyLength )
+{
+    bool ret = false;
+    size_t i, keyStart;
+
+    assert( ( buf != NULL ) && ( start != NULL ) && ( max > 0U ) );
+    assert( ( key != NULL ) && ( keyLength != NULL ) );
+
+    i = *start;
+    keyStart = i;
+
+    if( skipString( buf, &i, max ) == true )
+    {
+        *key = keyStart + 1U;
+        *keyLength = i - keyStart - 2U;
+        skipSpace( buf, &i, max );
+
+        if( ( i < max ) && ( buf[ i ] == ':' ) )
+        {
+            i++;
+            skipSpace( buf, &i, max );
+            ret = true;
+        }
+    }
+
+    if( ret == true )
+    {
+        *start = i;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Build a structural index of a collection in a single pass.
+ *
+ * The first entry of the index, for the root collection, must already
+ * have been appended.  A stack of entry indexes is used to fill in the
+ * length and sibling link of each collection when it is closed.
+ *
+ * @param[in] buf  The buffer to parse.
+ * @param[in,out] start  The index just beyond the opening bracket of the root.
+ * @param[in] max  The size of the buffer.
+ * @param[in,out] index  The index being built.
+ *
+ * @return #JSONSuccess if the buffer contents are a valid JSON collection;
+ * #JSONIndexFull if there is no space left in the index;
+ * #JSONIllegalDocument if the buffer contents are NOT valid JSON;
+ * #JSONMaxDepthExceeded if object and array nesting exceeds a threshold;
+ * #JSONPartial if the buffer contents are potentially valid but incomplete.
+ */
+#define INDEX_AFTER_OPEN     ( 0U ) /* a value or closing bracket may follow */
+#define INDEX_AFTER_COMMA    ( 1U ) /* a value must follow */
+#define INDEX_AFTER_VALUE    ( 2U ) /* a comma or closing bracket must follow */
+static JSONStatus_t indexCollection( const char * buf,
+                                     size_t * start,
+                                     size_t max,
+                                     JSONIndex_t * index )
+{
+    JSONStatus_t ret = JSONPartial;
+    size_t stack[ JSON_MAX_DEPTH ];
+    int16_t depth = 0;
+    uint8_t state = INDEX_AFTER_OPEN;
+    size_t i;
+
+    assert( ( buf != NULL ) && ( start != NULL ) && ( max > 0U ) );
+    assert( ( index != NULL ) && ( index->entryCount == 1U ) );
+
+    i = *start;
+    stack[ 0 ] = 0U;
+
+    while( ( ret == JSONPartial ) && ( depth >= 0 ) )
+    {
+        JSONIndexEntry_t * parent = &index->entries[ stack[ depth ] ];
+        char mode = buf[ parent->value ];
+
+        skipSpace( buf, &i, max );
+
+        if( i >= max )
+        {
+            /* JSON does not permit a trailing comma. */
+            if( state == INDEX_AFTER_COMMA )
+            {
+                ret = JSONIllegalDocument;
+            }
+
+            break;
+        }
+
+        if( ( state != INDEX_AFTER_COMMA ) && isCloseBracket_( buf[ i ] ) )
+        {
+            if( !isMatchingBracket_( mode, buf[ i ] ) )
+            {
+                ret = JSONIllegalDocument;
+            }
+            else
+            {
+                i++;
+                parent->valueLength = i - parent->value;
+                parent->next = index->entryCount;
+                depth--;
+                state = INDEX_AFTER_VALUE;
+            }
+        }
+        else if( state == INDEX_AFTER_VALUE )
+        {
+            if( buf[ i ] == ',' )
+            {
+                i++;
+                state = INDEX_AFTER_COMMA;
+            }
+            else
+            {
+                ret = JSONIllegalDocument;
+            }
+        }
+        else
+        {
+            size_t key = 0U, keyLength = 0U;
+            bool isCollection = false;
+
+            if( ( mode == '{' ) &&
+                ( skipKeyAndColon( buf, &i, max, &key, &keyLength ) != true ) )
+            {
+                ret = JSONIllegalDocument;
+            }
+            else
+            {
+                ret = indexValue( buf, &i, max, index, key, keyLength, &isCollection );
+            }
+
+            if( ret == JSONSuccess )
+            {
+                ret = JSONPartial;
+                state = INDEX_AFTER_VALUE;
+
+                if( isCollection == true )
+                {
+                    depth++;
+
+                    if( depth == JSON_MAX_DEPTH )
+                    {
+                        ret = JSONMaxDepthExceeded;
+                    }
+                    else
+                    {
+                        stack[ depth ] = index->entryCount - 1U;
+                        state = INDEX_AFTER_OPEN;
+                    }
+                }
+            }
+        }
+    }
+
+    if( depth < 0 )
+    {
+        ret = JSONSuccess;
+        *start = i;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Find the index entry for a query by walking the sibling links
+ * of the structural index.
+ *
+ * @param[in] index  The structural index to search.
+ * @param[in] query  The object keys and array indexes to search for.
+ * @param[in] queryLength  Length of the key.
+ * @param[out] outEntry  A pointer to receive the entry of the value found.
+ *
+ * @return #JSONSuccess if the query is matched and the entry output;
+ * #JSONBadParameter if the query is empty, or any part is empty,
+ * or an index is too large to convert;
+ * #JSONNotFound if the query is NOT found.
+ */
+static JSONStatus_t indexSearch( const JSONIndex_t * index,
+                                 const char * query,
+                                 size_t queryLength,
+                                 size_t * outEntry )
+{
+    JSONStatus_t ret = JSONSuccess;
+    size_t i = 0, current = 0;
+
+    assert( ( index != NULL ) && ( query != NULL ) && ( outEntry != NULL ) );
+    assert( ( index->entryCount > 0U ) && ( queryLength > 0U ) );
+
+    while( i < queryLength )
+    {
+        const JSONIndexEntry_t * entries = index->entries;
+        char mode = index->buf[ entries[ current ].value ];
+        size_t child = current + 1U, queryStart = 0, keyLength = 0;
+        int32_t queryIndex = -1;
+        bool found = false;
+
+        ret = nextQueryPart( query, &i, queryLength, &queryIndex, &queryStart, &keyLength );
+
+        if( ret != JSONSuccess )
+        {
+            break;
+        }
+
+        if( ( queryIndex >= 0 ) && ( mode == '[' ) )
+        {
+            uint32_t currentIndex = 0;
+
+            while( child < entries[ current ].next )
+            {
+                if( currentIndex == ( uint32_t ) queryIndex )
+                {
+                    found = true;
+                    break;
+                }
+
+                child = entries[ child ].next;
+                currentIndex++;
+            }
+        }
+        else if( ( queryIndex < 0 ) && ( mode == '{' ) )
+        {
+            while( child < entries[ current ].next )
+            {
+                if( ( entries[ child ].keyLength == keyLength ) &&
+                    ( strnEq( &query[ queryStart ], &index->buf[ entries[ child ].key ], keyLength ) == true ) )
+                {
+                    found = true;
+                    break;
+                }
+
+                child = entries[ child ].next;
+            }
+        }
+        else
+        {
+            /* MISRA 15.7 */
+        }
+
+        if( found == false )
+        {
+            ret = JSONNotFound;
+            break;
+        }
+
+        current = child;
+    }
+
+    if( ret == JSONSuccess )
+    {
+        *outEntry = current;
+    }
+
+    return ret;
+}
+
+/** @endcond */
+
+/**
+ * See core_json.h for docs.
+ *
+ * Validate the buffer while recording every value in document order.
+ */
+JSONStatus_t JSON_BuildIndex( const char * buf,
+                              size_t max,
+                              JSONIndexEntry_t * entries,
+                              size_t maxEntries,
+                              JSONIndex_t * outIndex )
+{
+    JSONStatus_t ret;
+    size_t i = 0;
+    bool isCollection = false;
+
+    if( ( buf == NULL ) || ( entries == NULL ) || ( outIndex == NULL ) )
+    {
+        ret = JSONNullParameter;
+    }
+    else if( ( max == 0U ) || ( maxEntries == 0U ) )
+    {
+        ret = JSONBadParameter;
+    }
+    else
+    {
+        outIndex->buf = buf;
+        outIndex->entries = entries;
+        outIndex->entryCount = 0U;
+        outIndex->maxEntries = maxEntries;
+
+        skipSpace( buf, &i, max );
+        ret = indexValue( buf, &i, max, outIndex, 0U, 0U, &isCollection );
+
+        if( ( ret == JSONSuccess ) && ( isCollection == true ) )
+        {
+            ret = indexCollection( buf, &i, max, outIndex );
+        }
+
+        /** @cond DO_NOT_DOCUMENT */
+        #ifdef JSON_VALIDATE_COLLECTIONS_ONLY
+            else if( ret == JSONSuccess )
+            {
+                ret = JSONIllegalDocument;
+            }
+            else
+            {
+                /* MISRA 15.7 */
+            }
+        #endif
+        /** @endcond */
+    }
+
+    if( ( ret == JSONSuccess ) && ( i < max ) )
+    {
+        skipSpace( buf, &i, max );
+
+        if( i != max )
+        {
+            ret = JSONIllegalDocument;
+        }
+    }
+
+    if( ( ret != JSONSuccess ) && ( outIndex != NULL ) )
+    {
+        outIndex->entryCount = 0U;
+    }
+
+    return ret;
+}
+
+/**
+ * See core_json.h for docs.
+ */
+JSONStatus_t JSON_SearchIndex( const JSONIndex_t * index,
+                               const char * query,
+                               size_t queryLength,
+                               const char ** outValue,
+                               size_t * outValueLength,
+                               JSONTypes_t * outType )
+{
+    JSONStatus_t ret;
+    size_t entry = 0U, value = 0U;
+
+    if( ( index == NULL ) || ( query == NULL ) ||
+        ( outValue == NULL ) || ( outValueLength == NULL ) )
+    {
+        ret = JSONNullParameter;
+    }
+    else if( ( index->entryCount == 0U ) || ( queryLength == 0U ) )
+    {
+        ret = JSONBadParameter;
+    }
+    else
+    {
+        ret = indexSearch( index, query, queryLength, &entry );
+    }
+
+    if( ret == JSONSuccess )
+    {
+        JSONTypes_t t;
+
+        value = index->entries[ entry ].value;
+        *outValueLength = index->entries[ entry ].valueLength;
+        t = getType( index->buf[ value ] );
+
+        if( t == JSONString )
+        {
+            /* strip the surrounding quotes */
+            value++;
+            *outValueLength -= 2U;
+        }
+
+        *outValue = &index->buf[ value ];
+
+        if( outType != NULL )
+        {
+            *outType = t;
+        }
+    }
+
+    return ret;
+}
+
+/** @cond DO_NOT_DOCUMENT */
+
+/* The states of a JSONStream_t, naming what the next byte may be.
+ * The first group is between tokens, the rest are within one. */
+#define STREAM_VALUE             ( 0U )  /* a value, at the top level or after ':' or ',' */
+#define STREAM_VALUE_OR_CLOSE    ( 1U )  /* a value or ']', after '[' */
+#define STREAM_KEY_OR_CLOSE      ( 2U )  /* a key or '}', after '{' */
+#define STREAM_KEY               ( 3U )  /* a key, after ',' in an object */
+#define STREAM_COLON             ( 4U )  /* ':', after a key */
+#define STREAM_COMMA_OR_CLOSE    ( 5U )  /* ',' or a close bracket, after a value */
+#define STREAM_DONE              ( 6U )  /* only whitespace, after the top-level value */
+#define STREAM_STRING            ( 7U )  /* a string character or '"' */
+#define STREAM_ESCAPE            ( 8U )  /* the character after '\' */
+#define STREAM_HEX               ( 9U )  /* a hex digit of \uXXXX */
+#define STREAM_LOW_BACKSLASH     ( 10U ) /* '\' of the low surrogate escape */
+#define STREAM_LOW_U             ( 11U ) /* 'u' of the low surrogate escape */
+#define STREAM_LOW_HEX           ( 12U ) /* a hex digit of the low surrogate */
+#define STREAM_UTF8              ( 13U ) /* a UTF-8 continuation byte */
+#define STREAM_MINUS             ( 14U ) /* a digit, after '-' */
+#define STREAM_ZERO              ( 15U ) /* '.', 'e' or the end, after a leading '0' */
+#define STREAM_INT               ( 16U ) /* a digit, '.', 'e' or the end */
+#define STREAM_DOT               ( 17U ) /* a digit, after '.' */
+#define STREAM_FRAC              ( 18U ) /* a digit, 'e' or the end */
+#define STREAM_EXP               ( 19U ) /* a sign or digit, after 'e' */
+#define STREAM_EXP_SIGN          ( 20U ) /* a digit, after the exponent sign */
+#define STREAM_EXP_DIGITS        ( 21U ) /* a digit or the end */
+#define STREAM_LITERAL           ( 22U ) /* the next character of true, false or null */
+
+#define isNumberEnd_( x )                                     \
+    ( ( ( x ) == STREAM_ZERO ) || ( ( x ) == STREAM_INT ) ||  \
+      ( ( x ) == STREAM_FRAC ) || ( ( x ) == STREAM_EXP_DIGITS ) )
+
+/**
+ * @brief Test whether the innermost open collection is an object.
+ *
+ * @param[in] stream  The validation state.
+ *
+ * @return true if it is an object;
+ * false if it is an array.
+ */
+static bool streamInObject( const JSONStream_t * stream )
+{
+    size_t i;
+
+    assert( ( stream != NULL ) && ( stream->depth > 0 ) );
+
+    i = ( size_t ) stream->depth - 1U;
+
+    return ( ( ( uint32_t ) stream->stack[ i / 8U ] >> ( i % 8U ) ) & 1U ) == 1U;
+}
+
+/**
+ * @brief Move past a completed value.
+ *
+ * @param[in,out] stream  The validation state.
+ */
+static void streamEndValue( JSONStream_t * stream )
+{
+    assert( stream != NULL );
+
+    stream->state = ( stream->depth == 0 ) ? STREAM_DONE : STREAM_COMMA_OR_CLOSE;
+}
+
+/**
+ * @brief Handle the first byte of a value.
+ *
+ * @param[in,out] stream  The validation state.
+ * @param[in] c  The byte.
+ *
+ * @return #JSONPartial if the byte may begin a value;
+ * #JSONIllegalDocument if it may not;
+ * #JSONMaxDepthExceeded if it opens one collection too many.
+ */
+static JSONStatus_t streamBeginValue( JSONStream_t * stream,
+                                      char c )
+{
+    JSONStatus_t ret = JSONPartial;
+
+    assert( stream != NULL );
+
+    switch( c )
+    {
+        case '{':
+        case '[':
+
+            if( stream->depth == JSON_MAX_DEPTH )
+            {
+                ret = JSONMaxDepthExceeded;
+            }
+            else
+            {
+                size_t i = ( size_t ) stream->depth;
+                uint8_t bit = ( uint8_t ) ( 1U << ( i % 8U ) );
+
+                if( c == '{' )
+                {
+                    stream->stack[ i / 8U ] |= bit;
+                    stream->state = STREAM_KEY_OR_CLOSE;
+                }
+                else
+                {
+                    stream->stack[ i / 8U ] &= ( uint8_t ) ~bit;
+                    stream->state = STREAM_VALUE_OR_CLOSE;
+                }
+
+                stream->depth++;
+            }
+
+            break;
+
+        case '"':
+            stream->key = false;
+            stream->state = STREAM_STRING;
+            break;
+
+        case 't':
+        case 'f':
+        case 'n':
+            stream->literal = ( c == 't' ) ? "true" : ( ( c == 'f' ) ? "false" : "null" );
+            stream->count = 1U;
+            stream->state = STREAM_LITERAL;
+            break;
+
+        case '-':
+            stream->state = STREAM_MINUS;
+            break;
+
+        case '0':
+            stream->state = STREAM_ZERO;
+            break;
+
+        default:
+
+            if( isdigit_( c ) )
+            {
+                stream->state = STREAM_INT;
+            }
+            else
+            {
+                ret = JSONIllegalDocument;
+            }
+
+            break;
+    }
+
+    #ifdef JSON_VALIDATE_COLLECTIONS_ONLY
+        if( ( stream->depth == 0 ) && ( ret == JSONPartial ) )
+        {
+            ret = JSONIllegalDocument;
+        }
+    #endif
+
+    return ret;
+}
+
+/**
+ * @brief Handle a close bracket.
+ *
+ * @param[in,out] stream  The validation state.
+ * @param[in] c  The byte.
+ *
+ * @return #JSONPartial if the byte closes the innermost collection;
+ * #JSONIllegalDocument otherwise.
+ */
+static JSONStatus_t streamClose( JSONStream_t * stream,
+                                 char c )
+{
+    JSONStatus_t ret = JSONIllegalDocument;
+
+    assert( ( stream != NULL ) && ( stream->depth > 0 ) );
+
+    if( isMatchingBracket_( streamInObject( stream ) ? '{' : '[', c ) )
+    {
+        stream->depth--;
+        streamEndValue( stream );
+        ret = JSONPartial;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Handle a byte between tokens.
+ *
+ * @param[in,out] stream  The validation state.
+ * @param[in] c  The byte.
+ *
+ * @return #JSONPartial if the byte is acceptable;
+ * #JSONIllegalDocument if it is not;
+ * #JSONMaxDepthExceeded if it opens one collection too many.
+ */
+static JSONStatus_t streamStructural( JSONStream_t * stream,
+                                      char c )
+{
+    JSONStatus_t ret = JSONPartial;
+
+    assert( stream != NULL );
+
+    if( isspace_( c ) )
+    {
+        /* MISRA 15.7 */
+    }
+    else
+    {
+        switch( stream->state )
+        {
+            case STREAM_VALUE:
+                ret = streamBeginValue( stream, c );
+                break;
+
+            case STREAM_VALUE_OR_CLOSE:
+                ret = isSquareClose_( c ) ? streamClose( stream, c ) :
+                      streamBeginValue( stream, c );
+                break;
+
+            case STREAM_KEY_OR_CLOSE:
+            case STREAM_KEY:
+
+                if( c == '"' )
+                {
+                    stream->key = true;
+                    stream->state = STREAM_STRING;
+                }
+                else if( ( c == '}' ) && ( stream->state == STREAM_KEY_OR_CLOSE ) )
+                {
+                    ret = streamClose( stream, c );
+                }
+                else
+                {
+                    ret = JSONIllegalDocument;
+                }
+
+                break;
+
+            case STREAM_COLON:
+
+                if( c == ':' )
+                {
+                    stream->state = STREAM_VALUE;
+                }
+                else
+                {
+                    ret = JSONIllegalDocument;
+                }
+
+                break;
+
+            case STREAM_COMMA_OR_CLOSE:
+
+                if( c == ',' )
+                {
+                    stream->state = streamInObject( stream ) ? STREAM_KEY : STREAM_VALUE;
+                }
+                else
+                {
+                    ret = streamClose( stream, c );
+                }
+
+                break;
+
+            default:
+                ret = JSONIllegalDocument;
+                break;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Handle the next hex digit of a \\u escape.
+ *
+ * @param[in,out] stream  The validation state.
+ * @param[in] c  The byte.
+ *
+ * @return #JSONPartial if the byte is acceptable;
+ * #JSONIllegalDocument if it is not.
+ */
+static JSONStatus_t streamHex( JSONStream_t * stream,
+                               char c )
+{
+    JSONStatus_t ret = JSONPartial;
+    uint8_t n = hexToInt( c );
+
+    assert( ( stream != NULL ) && ( stream->count > 0U ) );
+
+    if( n == NOT_A_HEX_CHAR )
+    {
+        ret = JSONIllegalDocument;
+    }
+    else
+    {
+        stream->value = ( stream->value << 4U ) | n;
+        stream->count--;
+    }
+
+    if( ( ret == JSONPartial ) && ( stream->count == 0U ) )
+    {
+        if( stream->state == STREAM_LOW_HEX )
+        {
+            ret = isLowSurrogate( stream->value ) ? JSONPartial : JSONIllegalDocument;
+            stream->state = STREAM_STRING;
+        }
+        else if( isHighSurrogate( stream->value ) )
+        {
+            stream->state = STREAM_LOW_BACKSLASH;
+        }
+        else if( ( stream->value == 0U ) || isLowSurrogate( stream->value ) )
+        {
+            ret = JSONIllegalDocument;
+        }
+        else
+        {
+            stream->state = STREAM_STRING;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Handle the byte after a backslash.
+ *
+ * @param[in,out] stream  The validation state.
+ * @param[in] c  The byte.
+ *
+ * @return #JSONPartial if the byte is acceptable;
+ * #JSONIllegalDocument if it is not.
+ */
+static JSONStatus_t streamEscape( JSONStream_t * stream,
+                                  char c )
+{
+    JSONStatus_t ret = JSONPartial;
+
+    assert( stream != NULL );
+
+    switch( c )
+    {
+        case 'u':
+            stream->value = 0U;
+            stream->count = 4U;
+            stream->state = STREAM_HEX;
+            break;
+
+        case '"':
+        case '\\':
+        case '/':
+        case 'b':
+        case 'f':
+        case 'n':
+        case 'r':
+        case 't':
+            stream->state = STREAM_STRING;
+            break;
+
+        default:
+
+            /* As in skipEscape(), a control character other than NUL
+             * may be escaped. */
+            if( iscntrl_( c ) && ( c != '\0' ) )
+            {
+                stream->state = STREAM_STRING;
+            }
+            else
+            {
+                ret = JSONIllegalDocument;
+            }
+
+            break;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Handle a byte within a string.
+ *
+ * @param[in,out] stream  The validation state.
+ * @param[in] c  The byte.
+ *
+ * @return #JSONPartial if the byte is acceptable;
+ * #JSONIllegalDocument if it is not.
+ */
+static JSONStatus_t streamString( JSONStream_t * stream,
+                                  char c )
+{
+    JSONStatus_t ret = JSONPartial;
+    char_ b;
+
+    assert( stream != NULL );
+
+    b.c = c;
+
+    switch( stream->state )
+    {
+        case STREAM_STRING:
+
+            if( c == '"' )
+            {
+                if( stream->key == true )
+                {
+                    stream->state = STREAM_COLON;
+                }
+                else
+                {
+                    streamEndValue( stream );
+                }
+            }
+            else if( c == '\\' )
+            {
+                stream->state = STREAM_ESCAPE;
+            }
+            else if( iscntrl_( c ) )
+            {
+                ret = JSONIllegalDocument;
+            }
+            else if( isascii_( c ) )
+            {
+                /* MISRA 15.7 */
+            }
+            /* The same lead bytes as skipUTF8MultiByte() accepts. */
+            else if( ( b.u > 0xC1U ) && ( b.u < 0xF5U ) )
+            {
+                stream->length = ( uint8_t ) countHighBits( b.u );
+                stream->count = stream->length - 1U;
+                stream->value = ( uint32_t ) b.u & ( ( 1UL << ( 8U - stream->length ) ) - 1U );
+                stream->state = STREAM_UTF8;
+            }
+            else
+            {
+                ret = JSONIllegalDocument;
+            }
+
+            break;
+
+        case STREAM_UTF8:
+
+            if( ( b.u & 0xC0U ) == 0x80U )
+            {
+                stream->value = ( stream->value << 6U ) | ( b.u & 0x3FU );
+                stream->count--;
+
+                if( stream->count == 0U )
+                {
+                    ret = shortestUTF8( stream->length, stream->value ) ?
+                          JSONPartial : JSONIllegalDocument;
+                    stream->state = STREAM_STRING;
+                }
+            }
+            else
+            {
+                ret = JSONIllegalDocument;
+            }
+
+            break;
+
+        case STREAM_ESCAPE:
+            ret = streamEscape( stream, c );
+            break;
+
+        case STREAM_LOW_BACKSLASH:
+        case STREAM_LOW_U:
+
+            if( ( stream->state == STREAM_LOW_BACKSLASH ) && ( c == '\\' ) )
+            {
+                stream->state = STREAM_LOW_U;
+            }
+            else if( ( stream->state == STREAM_LOW_U ) && ( c == 'u' ) )
+            {
+                stream->value = 0U;
+                stream->count = 4U;
+                stream->state = STREAM_LOW_HEX;
+            }
+            else
+            {
+                ret = JSONIllegalDocument;
+            }
+
+            break;
+
+        default:
+            ret = streamHex( stream, c );
+            break;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Handle a byte within a literal.
+ *
+ * @param[in,out] stream  The validation state.
+ * @param[in] c  The byte.
+ *
+ * @return #JSONPartial if the byte is acceptable;
+ * #JSONIllegalDocument if it is not.
+ */
+static JSONStatus_t streamLiteral( JSONStream_t * stream,
+                                   char c )
+{
+    JSONStatus_t ret = JSONIllegalDocument;
+
+    assert( ( stream != NULL ) && ( stream->literal != NULL ) );
+
+    if( c == stream->literal[ stream->count ] )
+    {
+        stream->count++;
+
+        if( stream->literal[ stream->count ] == '\0' )
+        {
+            streamEndValue( stream );
+        }
+
+        ret = JSONPartial;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Handle a byte within a number.
+ *
+ * A byte that cannot continue a complete number ends it, and is then
+ * handled as a byte between tokens.
+ *
+ * @param[in,out] stream  The validation state.
+ * @param[in] c  The byte.
+ *
+ * @return #JSONPartial if the byte is acceptable;
+ * #JSONIllegalDocument if it is not;
+ * #JSONMaxDepthExceeded if it opens one collection too many.
+ */
+static JSONStatus_t streamNumber( JSONStream_t * stream,
+                                  char c )
+{
+    JSONStatus_t ret = JSONPartial;
+    uint8_t state;
+
+    assert( stream != NULL );
+
+    state = stream->state;
+
+    if( isdigit_( c ) && ( state != STREAM_ZERO ) )
+    {
+        if( state == STREAM_MINUS )
+        {
+            state = ( c == '0' ) ? STREAM_ZERO : STREAM_INT;
+        }
+        else if( state == STREAM_DOT )
+        {
+            state = STREAM_FRAC;
+        }
+        else if( ( state == STREAM_EXP ) || ( state == STREAM_EXP_SIGN ) )
+        {
+            state = STREAM_EXP_DIGITS;
+        }
+        else
+        {
+            /* INT, FRAC and EXP_DIGITS continue */
+        }
+    }
+    else if( ( c == '.' ) && ( ( state == STREAM_ZERO ) || ( state == STREAM_INT ) ) )
+    {
+        state = STREAM_DOT;
+    }
+    else if( ( ( c == 'e' ) || ( c == 'E' ) ) &&
+             ( ( state == STREAM_ZERO ) || ( state == STREAM_INT ) ||
+               ( state == STREAM_FRAC ) ) )
+    {
+        state = STREAM_EXP;
+    }
+    else if( ( ( c == '+' ) || ( c == '-' ) ) && ( state == STREAM_EXP ) )
+    {
+        state = STREAM_EXP_SIGN;
+    }
+    else if( isNumberEnd_( state ) )
+    {
+        /* A leading zero followed by a digit ends up here too, and the
+         * digit is then rejected as the byte after a value. */
+        streamEndValue( stream );
+        ret = streamStructural( stream, c );
+        state = stream->state;
+    }
+    else
+    {
+        ret = JSONIllegalDocument;
+    }
+
+    if( ret == JSONPartial )
+    {
+        stream->state = state;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Handle the next byte of a document.
+ *
+ * @param[in,out] stream  The validation state.
+ * @param[in] c  The byte.
+ *
+ * @return #JSONPartial if the byte is acceptable;
+ * #JSONIllegalDocument if it is not;
+ * #JSONMaxDepthExceeded if it opens one collection too many.
+ */
+static JSONStatus_t streamByte( JSONStream_t * stream,
+                                char c )
+{
+    JSONStatus_t ret;
+
+    assert( stream != NULL );
+
+    if( stream->state <= STREAM_DONE )
+    {
+        ret = streamStructural( stream, c );
+    }
+    else if( stream->state <= STREAM_UTF8 )
+    {
+        ret = streamString( stream, c );
+    }
+    else if( stream->state == STREAM_LITERAL )
+    {
+        ret = streamLiteral( stream, c );
+    }
+    else
+    {
+        ret = streamNumber( stream, c );
+    }
+
+    return ret;
+}
+
+/** @endcond */
+
+/**
+ * See core_json.h for docs.
+ */
+JSONStatus_t JSON_StreamInit( JSONStream_t * stream )
+{
+    JSONStatus_t ret = JSONNullParameter;
+
+    if( stream != NULL )
+    {
+        /* The stack bits are written as each collection is opened. */
+        stream->offset = 0U;
+        stream->status = JSONPartial;
+        stream->literal = NULL;
+        stream->value = 0U;
+        stream->depth = 0;
+        stream->state = STREAM_VALUE;
+        stream->count = 0U;
+        stream->length = 0U;
+        stream->key = false;
+        stream->member = JSONInvalid;
+        stream->memberKey = false;
+        ret = JSONSuccess;
+    }
+
+    return ret;
+}
+
+/**
+ * See core_json.h for docs.
+ */
+JSONStatus_t JSON_StreamValidate( JSONStream_t * stream,
+                                  const char * buf,
+                                  size_t length )
+{
+    JSONStatus_t ret;
+    size_t i = 0U;
+
+    if( ( stream == NULL ) || ( ( buf == NULL ) && ( length > 0U ) ) )
+    {
+        ret = JSONNullParameter;
+    }
+    else if( ( stream->status != JSONPartial ) && ( stream->status != JSONSuccess ) )
+    {
+        ret = stream->status;
+    }
+    else
+    {
+        ret = JSONPartial;
+
+        while( ( i < length ) && ( ret == JSONPartial ) )
+        {
+            ret = streamByte( stream, buf[ i ] );
+
+            if( ret == JSONPartial )
+            {
+                i++;
+            }
+        }
+
+        stream->offset += i;
+
+        if( ret == JSONPartial )
+        {
+            /* A top-level number is complete once it has a digit. */
+            if( ( stream->state == STREAM_DONE ) ||
+                ( ( stream->depth == 0 ) && isNumberEnd_( stream->state ) ) )
+            {
+                ret = JSONSuccess;
+            }
+        }
+
+        stream->status = ret;
+    }
+
+    return ret;
+}
+
+/** @cond DO_NOT_DOCUMENT */
+
+/**
+ * @brief Test whether the byte just handled began a key or value of the
+ * top-level collection, and if so note which.
+ *
+ * @param[in,out] stream  The iteration state.
+ * @param[in] state  The state before the byte.
+ * @param[in] depth  The depth before the byte.
+ * @param[in] c  The byte.
+ *
+ * @return true if a key or value began;
+ * false otherwise.
+ */
+static bool streamMemberBegins( JSONStream_t * stream,
+                                uint8_t state,
+                                int16_t depth,
+                                char c )
+{
+    bool ret = false;
+
+    assert( ( stream != NULL ) && ( stream->member == JSONInvalid ) );
+
+    /* Between the tokens of the top-level collection, any byte that is
+     * neither whitespace nor its close bracket begins a key or value. */
+    if( ( depth == 1 ) && ( stream->depth > 0 ) &&
+        ( state <= STREAM_KEY ) && !isspace_( c ) )
+    {
+        stream->member = getType( c );
+        stream->memberKey = ( state >= STREAM_KEY_OR_CLOSE );
+        ret = true;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Test whether the byte just handled ended the key or value being
+ * iterated.
+ *
+ * @param[in] stream  The iteration state.
+ *
+ * @return true if the key or value ended;
+ * false otherwise.
+ */
+static bool streamMemberEnds( const JSONStream_t * stream )
+{
+    bool ret;
+
+    assert( ( stream != NULL ) && ( stream->member != JSONInvalid ) );
+
+    if( stream->memberKey == true )
+    {
+        ret = ( stream->state == STREAM_COLON );
+    }
+    else
+    {
+        ret = ( stream->depth <= 1 ) && ( stream->state <= STREAM_DONE );
+    }
+
+    return ret;
+}
+
+/** @endcond */
+
+/**
+ * See core_json.h for docs.
+ */
+JSONStatus_t JSON_StreamIterate( JSONStream_t * stream,
+                                 const char * buf,
+                                 size_t length,
+                                 size_t * start,
+                                 JSONFragment_t * outFragment )
+{
+    JSONStatus_t ret;
+    size_t i = 0U, fragmentStart = 0U, fragmentEnd = 0U;
+    uint8_t state;
+    int16_t depth;
+    bool found = false;
+
+    if( ( stream == NULL ) || ( ( buf == NULL ) && ( length > 0U ) ) ||
+        ( start == NULL ) || ( outFragment == NULL ) )
+    {
+        ret = JSONNullParameter;
+    }
+    else if( *start > length )
+    {
+        ret = JSONBadParameter;
+    }
+    else if( ( stream->status != JSONPartial ) && ( stream->status != JSONSuccess ) )
+    {
+        ret = stream->status;
+    }
+    else if( stream->state == STREAM_DONE )
+    {
+        ret = JSONNotFound;
+    }
+    else
+    {
+        ret = JSONPartial;
+        i = *start;
+        fragmentStart = i;
+
+        while( ( i < length ) && ( ret == JSONPartial ) && ( found == false ) )
+        {
+            state = stream->state;
+            depth = stream->depth;
+
+            /* Before the collection only whitespace may come, as the
+             * state cannot be STREAM_DONE here. */
+            if( ( depth == 0 ) && !isspace_( buf[ i ] ) && !isOpenBracket_( buf[ i ] ) )
+            {
+                ret = JSONIllegalDocument;
+            }
+            else
+            {
+                ret = streamByte( stream, buf[ i ] );
+            }
+
+            if( ret == JSONPartial )
+            {
+                if( stream->member == JSONInvalid )
+                {
+                    /* The quote of a string is not part of it. */
+                    if( streamMemberBegins( stream, state, depth, buf[ i ] ) &&
+                        ( stream->member == JSONString ) )
+                    {
+                        fragmentStart = i + 1U;
+                    }
+                    else
+                    {
+                        fragmentStart = i;
+                    }
+                }
+                else if( streamMemberEnds( stream ) )
+                {
+                    /* A string ends with a quote, which is not part of it,
+                     * and a number with the byte after it. */
+                    fragmentEnd = ( ( stream->member == JSONString ) ||
+                                    ( stream->member == JSONNumber ) ) ? i : ( i + 1U );
+                    found = true;
+                }
+                else
+                {
+                    /* MISRA 15.7 */
+                }
+
+                /* The collection has closed. */
+                if( ( depth == 1 ) && ( stream->depth == 0 ) && ( found == false ) )
+                {
+                    ret = JSONNotFound;
+                }
+
+                i++;
+            }
+        }
+
+        stream->offset += i - *start;
+        *start = i;
+
+        if( found == true )
+        {
+            outFragment->fragment = &buf[ fragmentStart ];
+            outFragment->fragmentLength = fragmentEnd - fragmentStart;
+            outFragment->jsonType = stream->member;
+            outFragment->isKey = stream->memberKey;
+            outFragment->isLast = true;
+            stream->member = JSONInvalid;
+            ret = JSONSuccess;
+        }
+        else if( ( ret == JSONPartial ) && ( stream->member != JSONInvalid ) &&
+                 ( i > fragmentStart ) )
+        {
+            outFragment->fragment = &buf[ fragmentStart ];
+            outFragment->fragmentLength = i - fragmentStart;
+            outFragment->jsonType = stream->member;
+            outFragment->isKey = stream->memberKey;
+            outFragment->isLast = false;
+            ret = JSONSuccess;
+        }
+        else
+        {
+            /* MISRA 15.7 */
+        }
+
+        if( ( ret == JSONIllegalDocument ) || ( ret == JSONMaxDepthExceeded ) )
+        {
+            stream->status = ret;
+        }
+        else
+        {
+            stream->status = ( stream->state == STREAM_DONE ) ? JSONSuccess : JSONPartial;
+        }
+    }
+
+    return ret;
+}
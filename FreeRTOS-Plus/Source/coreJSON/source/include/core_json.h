@@ -32,6 +32,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 /* *INDENT-OFF* */
 #ifdef __cplusplus
@@ -51,7 +52,8 @@ typedef enum
     JSONMaxDepthExceeded, /**< @brief JSON document has nesting that exceeds JSON_MAX_DEPTH. */
     JSONNotFound,         /**< @brief Query key could not be found in the JSON document. */
     JSONNullParameter,    /**< @brief Pointer parameter passed to a function is NULL. */
-    JSONBadParameter      /**< @brief Query key is empty, or any subpart is empty, or max is 0. */
+    JSONBadParameter,     /**< @brief Query key is empty, or any subpart is empty, or max is 0. */
+    JSONIndexFull         /**< @brief Structural index storage is too small for the JSON document. */
 } JSONStatus_t;
 
 /**
@@ -61,12 +63,16 @@ typedef enum
  * @param[in] max  The size of the buffer.
  *
  * @note The maximum nesting depth may be specified by defining the macro
- * JSON_MAX_DEPTH.  The default is 32 of sizeof(char).
+ * JSON_MAX_DEPTH.  The default is 32.
  *
  * @note By default, a valid JSON document may contain a single element
  * (e.g., string, boolean, number).  To require that a valid document
  * contain an object or array, define JSON_VALIDATE_COLLECTIONS_ONLY.
  *
+ * @note Define JSON_ENABLE_SIMD to skip whitespace and plain ASCII string
+ * characters 16 or 32 bytes at a time when the compiler targets SSE2, AVX2
+ * or AArch64 NEON.  The documents accepted are the same either way.
+ *
  * @return #JSONSuccess if the buffer contents are valid JSON;
  * #JSONNullParameter if buf is NULL;
  * #JSONBadParameter if max is 0;
@@ -122,7 +128,7 @@ JSONStatus_t JSON_Validate( const char * buf,
  * @param[out] outValueLength  A pointer to receive the length of the value found.
  *
  * @note The maximum nesting depth may be specified by defining the macro
- * JSON_MAX_DEPTH.  The default is 32 of sizeof(char).
+ * JSON_MAX_DEPTH.  The default is 32.
  *
  * @note JSON_Search() performs validation, but stops upon finding a matching
  * key and its value. To validate the entire JSON document, use JSON_Validate().
@@ -330,6 +336,341 @@ JSONStatus_t JSON_Iterate( const char * buf,
                            JSONPair_t * outPair );
 /* @[declare_json_iterate] */
 
+/**
+ * @ingroup json_struct_types
+ * @brief One value recorded in a structural index.
+ *
+ * Entries are stored in document order, so the values of a collection
+ * immediately follow the entry of the collection itself.
+ */
+typedef struct
+{
+    size_t key;         /**< @brief Index of the key in the buffer, or 0 if the value has no key. */
+    size_t keyLength;   /**< @brief Length of the key, excluding the quotes. */
+    size_t value;       /**< @brief Index of the value in the buffer. */
+    size_t valueLength; /**< @brief Length of the value, including any quotes. */
+    size_t next;        /**< @brief Index of the first entry after this value and everything nested in it. */
+} JSONIndexEntry_t;
+
+/**
+ * @ingroup json_struct_types
+ * @brief A structural index of a JSON document, built by JSON_BuildIndex().
+ *
+ * @note The fields of this structure are for internal use only.
+ */
+typedef struct
+{
+    const char * buf;           /**< @brief The indexed buffer. */
+    JSONIndexEntry_t * entries; /**< @brief Caller-supplied entry storage. */
+    size_t entryCount;          /**< @brief The number of entries in use. */
+    size_t maxEntries;          /**< @brief The number of entries available. */
+} JSONIndex_t;
+
+/**
+ * @brief Validate a JSON document and record the location of every value
+ * in a caller-supplied array, so that it may be searched repeatedly with
+ * JSON_SearchIndex() without parsing the document again.
+ *
+ * Each scalar, object and array in the document uses one entry.
+ *
+ * @param[in] buf  The buffer to index.
+ * @param[in] max  The size of the buffer.
+ * @param[in] entries  Storage for the index entries.
+ * @param[in] maxEntries  The number of elements in @p entries.
+ * @param[out] outIndex  The index to initialize.
+ *
+ * @note The maximum nesting depth may be specified by defining the macro
+ * JSON_MAX_DEPTH.  The default is 32.
+ *
+ * @note The buffer and the entries must not be modified while the index is
+ * in use.
+ *
+ * @return #JSONSuccess if the buffer contents are valid JSON and were indexed;
+ * #JSONNullParameter if any pointer parameters are NULL;
+ * #JSONBadParameter if max or maxEntries is 0;
+ * #JSONIndexFull if the document has more values than maxEntries;
+ * #JSONIllegalDocument if the buffer contents are NOT valid JSON;
+ * #JSONMaxDepthExceeded if object and array nesting exceeds a threshold;
+ * #JSONPartial if the buffer contents are potentially valid but incomplete.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *     // Variables used in this example.
+ *     JSONStatus_t result;
+ *     JSONIndexEntry_t entries[ 8 ];
+ *     JSONIndex_t index;
+ *     char buffer[] = "{\"foo\":\"abc\",\"bar\":{\"foo\":\"xyz\"}}";
+ *     size_t bufferLength = sizeof( buffer ) - 1;
+ *     const char * value;
+ *     size_t valueLength;
+ *
+ *     result = JSON_BuildIndex( buffer, bufferLength, entries, 8, &index );
+ *
+ *     if( result == JSONSuccess )
+ *     {
+ *         result = JSON_SearchIndex( &index, "bar.foo", 7,
+ *                                    &value, &valueLength, NULL );
+ *     }
+ *
+ *     if( result == JSONSuccess )
+ *     {
+ *         // "Found: bar.foo -> xyz" will be printed.
+ *         printf( "Found: bar.foo -> %.*s\n", ( int ) valueLength, value );
+ *     }
+ * @endcode
+ */
+/* @[declare_json_buildindex] */
+JSONStatus_t JSON_BuildIndex( const char * buf,
+                              size_t max,
+                              JSONIndexEntry_t * entries,
+                              size_t maxEntries,
+                              JSONIndex_t * outIndex );
+/* @[declare_json_buildindex] */
+
+/**
+ * @brief Same as JSON_SearchConst(), but resolves the query against a
+ * structural index built by JSON_BuildIndex().
+ *
+ * Only the values of the collections named in the query are visited, and
+ * nested collections are skipped in a single step, so the document is not
+ * parsed again.
+ *
+ * See @ref JSON_Search for documentation of common behavior.
+ *
+ * @param[in] index  The structural index to search.
+ * @param[in] query  The object keys and array indexes to search for.
+ * @param[in] queryLength  Length of the key.
+ * @param[out] outValue  A pointer to receive the address of the value found.
+ * @param[out] outValueLength  A pointer to receive the length of the value found.
+ * @param[out] outType  An enum indicating the JSON-specific type of the value.
+ *
+ * @return #JSONSuccess if the query is matched and the value output;
+ * #JSONNullParameter if any pointer parameters are NULL;
+ * #JSONBadParameter if the query is empty, or the portion after a separator is empty,
+ * or the index is empty, or an index is too large to convert to a signed 32-bit integer;
+ * #JSONNotFound if the query has no match.
+ */
+/* @[declare_json_searchindex] */
+JSONStatus_t JSON_SearchIndex( const JSONIndex_t * index,
+                               const char * query,
+                               size_t queryLength,
+                               const char ** outValue,
+                               size_t * outValueLength,
+                               JSONTypes_t * outType );
+/* @[declare_json_searchindex] */
+
+/**
+ * @brief The maximum nesting depth of a JSON document.
+ *
+ * @note This sizes the stack of #JSONStream_t, so it must have the same
+ * value wherever core_json.h is included.
+ */
+#ifndef JSON_MAX_DEPTH
+    #define JSON_MAX_DEPTH    32
+#endif
+
+/**
+ * @ingroup json_struct_types
+ * @brief State of an incremental validation, see JSON_StreamValidate()
+ * and JSON_StreamIterate().
+ *
+ * @note The fields of this structure are for internal use only, except
+ * for offset, which may be read.
+ */
+typedef struct
+{
+    size_t offset;        /**< @brief The number of bytes accepted so far, or the offset of the offending byte after an error. */
+    JSONStatus_t status;  /**< @brief The result so far. */
+    const char * literal; /**< @brief The literal being matched. */
+    uint32_t value;       /**< @brief The code point being decoded. */
+    int16_t depth;        /**< @brief The number of open collections. */
+    uint8_t state;        /**< @brief What the next byte may be. */
+    uint8_t count;        /**< @brief Bytes remaining in the current escape, UTF-8 sequence or literal. */
+    uint8_t length;       /**< @brief The length of the current UTF-8 sequence. */
+    bool key;             /**< @brief The current string is an object key. */
+    JSONTypes_t member;   /**< @brief The type of the member being iterated, or #JSONInvalid between members. */
+    bool memberKey;       /**< @brief The member being iterated is an object key. */
+    uint8_t stack[ ( JSON_MAX_DEPTH + 7 ) / 8 ]; /**< @brief One bit per open collection, set for an object. */
+} JSONStream_t;
+
+/**
+ * @brief Prepare a #JSONStream_t to validate a new document.
+ *
+ * @param[out] stream  The validation state to initialize.
+ *
+ * @return #JSONSuccess if the state was initialized;
+ * #JSONNullParameter if stream is NULL.
+ */
+/* @[declare_json_streaminit] */
+JSONStatus_t JSON_StreamInit( JSONStream_t * stream );
+/* @[declare_json_streaminit] */
+
+/**
+ * @brief Continue validating a JSON document with the next chunk of it.
+ *
+ * The document may be split at any byte, including within a string,
+ * escape, UTF-8 sequence, number or literal, and chunks need not be kept
+ * once this returns.  Memory use is the size of #JSONStream_t whatever
+ * the size of the document, so a document may be checked as it is
+ * received without buffering it.
+ *
+ * The grammar is the same as that of JSON_Validate(), except that a
+ * collection is rejected where a key or a comma is required.
+ *
+ * @param[in,out] stream  The state initialized by JSON_StreamInit().
+ * @param[in] buf  The next chunk of the document.
+ * @param[in] length  The size of the chunk, which may be 0.
+ *
+ * @note A top-level number is valid once it has a digit, but may be
+ * continued by the next chunk; the document is known to be complete only
+ * when the caller has no more input.
+ *
+ * @note Once an error is returned, the same error is returned for any
+ * further chunk until JSON_StreamInit() is called again.
+ *
+ * @return #JSONSuccess if the bytes so far are a complete, valid JSON
+ * document, perhaps followed by whitespace;
+ * #JSONNullParameter if stream is NULL, or buf is NULL and length is not 0;
+ * #JSONIllegalDocument if the bytes so far can NOT begin a valid JSON document;
+ * #JSONMaxDepthExceeded if object and array nesting exceeds a threshold;
+ * #JSONPartial if the bytes so far are potentially valid but incomplete.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *     // Variables used in this example.
+ *     JSONStatus_t result;
+ *     JSONStream_t stream;
+ *     char chunk[ 64 ];
+ *     size_t chunkLength;
+ *
+ *     result = JSON_StreamInit( &stream );
+ *
+ *     // readChunk() is a placeholder for a transport receive.
+ *     while( ( result == JSONSuccess ) || ( result == JSONPartial ) )
+ *     {
+ *         chunkLength = readChunk( chunk, sizeof( chunk ) );
+ *
+ *         if( chunkLength == 0 )
+ *         {
+ *             break;
+ *         }
+ *
+ *         result = JSON_StreamValidate( &stream, chunk, chunkLength );
+ *     }
+ *
+ *     if( result == JSONSuccess )
+ *     {
+ *         printf( "Received a valid document of %lu bytes.\n",
+ *                 ( unsigned long ) stream.offset );
+ *     }
+ * @endcode
+ */
+/* @[declare_json_streamvalidate] */
+JSONStatus_t JSON_StreamValidate( JSONStream_t * stream,
+                                  const char * buf,
+                                  size_t length );
+/* @[declare_json_streamvalidate] */
+
+/**
+ * @ingroup json_struct_types
+ * @brief Structure to represent the part of a key or value within a chunk.
+ */
+typedef struct
+{
+    const char * fragment; /**< @brief Pointer to the part of the key or value in the chunk. */
+    size_t fragmentLength; /**< @brief Length of the part of the key or value in the chunk. */
+    JSONTypes_t jsonType;  /**< @brief JSON-specific type of the value, or #JSONString for a key. */
+    bool isKey;            /**< @brief The fragment is part of an object key. */
+    bool isLast;           /**< @brief The fragment ends the key or value. */
+} JSONFragment_t;
+
+/**
+ * @brief Output the next key or value of a collection from the next chunk of it.
+ *
+ * This is JSON_Iterate() for a document that arrives in chunks, as
+ * JSON_StreamValidate() is for JSON_Validate().  Each key and value in
+ * the top-level collection is output as one fragment per chunk it spans,
+ * pointing into that chunk, so it may be copied or compared as it arrives
+ * without buffering the document.  As with JSON_Iterate(), the quotes of a
+ * string are not included, escapes are not decoded, and a nested
+ * collection is output whole, including its brackets.
+ *
+ * For each chunk, the integer pointed to by start should be initialized
+ * to 0; it is updated by the function.  Call this with the same chunk
+ * while it returns #JSONSuccess.  A fragment may be empty when the end of
+ * a key or value is only found in the next chunk.
+ *
+ * The whole document is validated as JSON_StreamValidate() would.
+ *
+ * @param[in,out] stream  The state initialized by JSON_StreamInit().
+ * @param[in] buf  The next chunk of the document.
+ * @param[in] length  The size of the chunk, which may be 0.
+ * @param[in,out] start  The index in the chunk at which to continue.
+ * @param[out] outFragment  A pointer to receive the next fragment.
+ *
+ * @note Once an error is returned, the same error is returned for any
+ * further chunk until JSON_StreamInit() is called again.
+ *
+ * @return #JSONSuccess if a fragment is output;
+ * #JSONPartial if the rest of the chunk holds no fragment;
+ * #JSONNotFound if the collection has ended;
+ * #JSONNullParameter if a pointer is NULL, except buf when length is 0;
+ * #JSONBadParameter if start is beyond the end of the chunk;
+ * #JSONIllegalDocument if the bytes so far can NOT begin a valid JSON
+ * document or the document is not a collection;
+ * #JSONMaxDepthExceeded if object and array nesting exceeds a threshold.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *     // Variables used in this example.
+ *     JSONStatus_t result;
+ *     JSONStream_t stream;
+ *     JSONFragment_t fragment;
+ *     char chunk[ 64 ];
+ *     size_t chunkLength, start;
+ *
+ *     result = JSON_StreamInit( &stream );
+ *
+ *     // readChunk() is a placeholder for a transport receive.
+ *     while( result == JSONSuccess )
+ *     {
+ *         chunkLength = readChunk( chunk, sizeof( chunk ) );
+ *         start = 0;
+ *
+ *         if( chunkLength == 0 )
+ *         {
+ *             break;
+ *         }
+ *
+ *         do
+ *         {
+ *             result = JSON_StreamIterate( &stream, chunk, chunkLength,
+ *                                          &start, &fragment );
+ *
+ *             if( result == JSONSuccess )
+ *             {
+ *                 printf( "%s%.*s%s", fragment.isKey ? "key: " : "",
+ *                         ( int ) fragment.fragmentLength, fragment.fragment,
+ *                         fragment.isLast ? "\n" : "" );
+ *             }
+ *         } while( result == JSONSuccess );
+ *
+ *         // Ask for the next chunk.
+ *         if( result == JSONPartial )
+ *         {
+ *             result = JSONSuccess;
+ *         }
+ *     }
+ * @endcode
+ */
+/* @[declare_json_streamiterate] */
+JSONStatus_t JSON_StreamIterate( JSONStream_t * stream,
+                                 const char * buf,
+                                 size_t length,
+                                 size_t * start,
+                                 JSONFragment_t * outFragment );
+/* @[declare_json_streamiterate] */
+
 /* *INDENT-OFF* */
 #ifdef __cplusplus
     }
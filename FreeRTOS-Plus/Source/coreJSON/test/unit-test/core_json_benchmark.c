@@ -0,0 +1,243 @@
+/*
+ * coreJSON v3.2.0
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_json_benchmark.c
+ * @brief Host benchmarks for the coreJSON library.
+ *
+ * Each test checks that the paths it compares agree, then prints their
+ * timings. The timings are not asserted, so that the tests pass on any
+ * host; build with optimization to get meaningful numbers.
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "unity.h"
+
+/* Include paths for public enums, structures, and macros. */
+#include "core_json.h"
+
+/* A shadow document with this many reported fields of three values each. */
+#define SHADOW_FIELD_COUNT        40
+
+/* Sized for SHADOW_FIELD_COUNT fields. */
+#define SHADOW_DOCUMENT_SIZE      4096
+#define SHADOW_INDEX_ENTRIES      512
+
+/* A jobs document with this many pretty-printed entries. */
+#define JOBS_ENTRY_COUNT          120
+
+/* Sized for JOBS_ENTRY_COUNT entries. */
+#define JOBS_DOCUMENT_SIZE        32768
+
+/* Times each measured loop is run. */
+#define BENCHMARK_ITERATIONS      2000
+
+static char shadowDocument[ SHADOW_DOCUMENT_SIZE ];
+static size_t shadowDocumentLength;
+static char shadowQueries[ SHADOW_FIELD_COUNT ][ 48 ];
+static char jobsDocument[ JOBS_DOCUMENT_SIZE ];
+static size_t jobsDocumentLength;
+
+/* ============================   UNITY FIXTURES ============================ */
+
+/* Called before each test method. */
+void setUp()
+{
+    size_t i;
+
+    if( shadowDocumentLength == 0U )
+    {
+        shadowDocumentLength += ( size_t ) sprintf( shadowDocument, "{\"state\":{\"reported\":{" );
+
+        for( i = 0; i < SHADOW_FIELD_COUNT; i++ )
+        {
+            shadowDocumentLength += ( size_t ) sprintf( &shadowDocument[ shadowDocumentLength ],
+                                                        "%s\"field%02u\":{\"value\":%u,\"unit\":\"u%u\",\"hist\":[1,2,3,4,5,6,7,8]}",
+                                                        ( i == 0U ) ? "" : ",",
+                                                        ( unsigned ) i,
+                                                        ( unsigned ) ( i * 13U ),
+                                                        ( unsigned ) i );
+            ( void ) sprintf( shadowQueries[ i ], "state.reported.field%02u.value", ( unsigned ) i );
+        }
+
+        shadowDocumentLength += ( size_t ) sprintf( &shadowDocument[ shadowDocumentLength ],
+                                                    "}},\"version\":42,\"timestamp\":1700000000}" );
+        TEST_ASSERT_TRUE( shadowDocumentLength < SHADOW_DOCUMENT_SIZE );
+    }
+
+    if( jobsDocumentLength == 0U )
+    {
+        jobsDocumentLength += ( size_t ) sprintf( jobsDocument, "{\n  \"jobs\": [\n" );
+
+        for( i = 0; i < JOBS_ENTRY_COUNT; i++ )
+        {
+            jobsDocumentLength += ( size_t ) sprintf( &jobsDocument[ jobsDocumentLength ],
+                                                      "%s    {\n"
+                                                      "      \"jobId\": \"ota-update-job-%04u\",\n"
+                                                      "      \"status\": \"IN_PROGRESS\",\n"
+                                                      "      \"description\": \"Firmware update for sensor gateway, staged rollout group %u\",\n"
+                                                      "      \"url\": \"https://example-bucket.s3.amazonaws.com/firmware/v%u/image.bin\"\n"
+                                                      "    }",
+                                                      ( i == 0U ) ? "" : ",\n",
+                                                      ( unsigned ) i,
+                                                      ( unsigned ) ( i % 7U ),
+                                                      ( unsigned ) i );
+        }
+
+        jobsDocumentLength += ( size_t ) sprintf( &jobsDocument[ jobsDocumentLength ], "\n  ]\n}\n" );
+        TEST_ASSERT_TRUE( jobsDocumentLength < JOBS_DOCUMENT_SIZE );
+    }
+}
+
+/* Called after each test method. */
+void tearDown()
+{
+}
+
+/* Called at the beginning of the whole suite. */
+void suiteSetUp()
+{
+}
+
+/* Called at the end of the whole suite. */
+int suiteTearDown( int numFailures )
+{
+    return numFailures;
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Microseconds per iteration since a clock() reading.
+ */
+static double usPerIteration( clock_t start )
+{
+    return ( ( double ) ( clock() - start ) * 1e6 ) /
+           ( ( double ) CLOCKS_PER_SEC * BENCHMARK_ITERATIONS );
+}
+
+/**
+ * @brief Compare looking up every field of a shadow document with
+ * JSON_SearchConst against building a structural index once and looking
+ * them up with JSON_SearchIndex.
+ */
+void test_JSON_Benchmark_SearchIndex( void )
+{
+    static JSONIndexEntry_t entries[ SHADOW_INDEX_ENTRIES ];
+    JSONIndex_t index;
+    const char * value, * indexValue;
+    size_t valueLength, indexValueLength, i, n;
+    clock_t start;
+    double searchUs, indexUs;
+    char message[ 200 ];
+
+    /* Both paths find the same values. */
+    TEST_ASSERT_EQUAL( JSONSuccess, JSON_BuildIndex( shadowDocument, shadowDocumentLength,
+                                                     entries, SHADOW_INDEX_ENTRIES, &index ) );
+
+    for( i = 0; i < SHADOW_FIELD_COUNT; i++ )
+    {
+        TEST_ASSERT_EQUAL( JSONSuccess, JSON_SearchConst( shadowDocument, shadowDocumentLength,
+                                                          shadowQueries[ i ], strlen( shadowQueries[ i ] ),
+                                                          &value, &valueLength, NULL ) );
+        TEST_ASSERT_EQUAL( JSONSuccess, JSON_SearchIndex( &index, shadowQueries[ i ], strlen( shadowQueries[ i ] ),
+                                                          &indexValue, &indexValueLength, NULL ) );
+        TEST_ASSERT_EQUAL_PTR( value, indexValue );
+        TEST_ASSERT_EQUAL( valueLength, indexValueLength );
+    }
+
+    start = clock();
+
+    for( n = 0; n < BENCHMARK_ITERATIONS; n++ )
+    {
+        TEST_ASSERT_EQUAL( JSONSuccess, JSON_Validate( shadowDocument, shadowDocumentLength ) );
+
+        for( i = 0; i < SHADOW_FIELD_COUNT; i++ )
+        {
+            ( void ) JSON_SearchConst( shadowDocument, shadowDocumentLength,
+                                       shadowQueries[ i ], strlen( shadowQueries[ i ] ),
+                                       &value, &valueLength, NULL );
+        }
+    }
+
+    searchUs = usPerIteration( start );
+    start = clock();
+
+    for( n = 0; n < BENCHMARK_ITERATIONS; n++ )
+    {
+        TEST_ASSERT_EQUAL( JSONSuccess, JSON_BuildIndex( shadowDocument, shadowDocumentLength,
+                                                         entries, SHADOW_INDEX_ENTRIES, &index ) );
+
+        for( i = 0; i < SHADOW_FIELD_COUNT; i++ )
+        {
+            ( void ) JSON_SearchIndex( &index, shadowQueries[ i ], strlen( shadowQueries[ i ] ),
+                                       &value, &valueLength, NULL );
+        }
+    }
+
+    indexUs = usPerIteration( start );
+
+    ( void ) sprintf( message,
+                      "%lu byte document, %d lookups: JSON_Validate + JSON_SearchConst %.1f us, "
+                      "JSON_BuildIndex + JSON_SearchIndex %.1f us",
+                      ( unsigned long ) shadowDocumentLength, SHADOW_FIELD_COUNT, searchUs, indexUs );
+    TEST_MESSAGE( message );
+}
+
+/**
+ * @brief Measure the throughput of JSON_Validate on a pretty-printed jobs
+ * document, which is mostly whitespace and plain string characters.
+ *
+ * Build with and without JSON_ENABLE_SIMD to compare the scanning paths.
+ */
+void test_JSON_Benchmark_Validate( void )
+{
+    size_t n;
+    clock_t start;
+    double us;
+    char message[ 200 ];
+
+    start = clock();
+
+    for( n = 0; n < BENCHMARK_ITERATIONS; n++ )
+    {
+        TEST_ASSERT_EQUAL( JSONSuccess, JSON_Validate( jobsDocument, jobsDocumentLength ) );
+    }
+
+    us = usPerIteration( start );
+
+    ( void ) sprintf( message,
+                      "%lu byte document: JSON_Validate %.1f us, %.0f MB/s (%s)",
+                      ( unsigned long ) jobsDocumentLength, us, ( double ) jobsDocumentLength / us,
+                      #ifdef JSON_ENABLE_SIMD
+                          "JSON_ENABLE_SIMD"
+                      #else
+                          "scalar"
+                      #endif
+                      );
+    TEST_MESSAGE( message );
+}
@@ -527,6 +527,109 @@ char * allocateMaxDepthObject( void )
     return nestedObject;
 }
 
+/**
+ * @brief Validate a document with JSON_StreamValidate, chunkSize bytes at a time.
+ */
+JSONStatus_t streamValidate( const char * buf,
+                             size_t max,
+                             size_t chunkSize,
+                             JSONStream_t * stream )
+{
+    JSONStatus_t jsonStatus;
+    size_t i = 0, n;
+
+    jsonStatus = JSON_StreamInit( stream );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+
+    while( i < max )
+    {
+        n = ( ( max - i ) < chunkSize ) ? ( max - i ) : chunkSize;
+        jsonStatus = JSON_StreamValidate( stream, &buf[ i ], n );
+        i += n;
+    }
+
+    return jsonStatus;
+}
+
+/**
+ * @brief Check that JSON_StreamIterate outputs the keys and values that
+ * JSON_Iterate does, when a document is fed as a chunk of firstChunk bytes
+ * followed by chunks of chunkSize bytes.
+ */
+void streamIterateMatches( const char * buf,
+                           size_t max,
+                           size_t firstChunk,
+                           size_t chunkSize )
+{
+    JSONStatus_t jsonStatus = JSONPartial, iterateStatus;
+    JSONStream_t stream;
+    JSONFragment_t fragment;
+    JSONPair_t pair = { 0 };
+    size_t start, i = 0, n = firstChunk;
+    size_t iterateStart = 0, iterateNext = 0;
+    char key[ 256 ], value[ 256 ];
+    size_t keyLength = 0, valueLength = 0;
+
+    ( void ) JSON_StreamInit( &stream );
+    iterateStatus = JSON_Iterate( buf, max, &iterateStart, &iterateNext, &pair );
+
+    while( i < max )
+    {
+        n = ( ( max - i ) < n ) ? ( max - i ) : n;
+        start = 0;
+        jsonStatus = JSON_StreamIterate( &stream, &buf[ i ], n, &start, &fragment );
+
+        while( jsonStatus == JSONSuccess )
+        {
+            TEST_ASSERT_TRUE( fragment.fragment >= &buf[ i ] );
+            TEST_ASSERT_TRUE( ( fragment.fragment + fragment.fragmentLength ) <= &buf[ i + n ] );
+
+            if( fragment.isKey == true )
+            {
+                TEST_ASSERT_TRUE( ( keyLength + fragment.fragmentLength ) <= sizeof( key ) );
+                ( void ) memcpy( &key[ keyLength ], fragment.fragment, fragment.fragmentLength );
+                keyLength += fragment.fragmentLength;
+            }
+            else
+            {
+                TEST_ASSERT_TRUE( ( valueLength + fragment.fragmentLength ) <= sizeof( value ) );
+                ( void ) memcpy( &value[ valueLength ], fragment.fragment, fragment.fragmentLength );
+                valueLength += fragment.fragmentLength;
+            }
+
+            if( ( fragment.isKey == false ) && ( fragment.isLast == true ) )
+            {
+                TEST_ASSERT_EQUAL( JSONSuccess, iterateStatus );
+                TEST_ASSERT_EQUAL( pair.keyLength, keyLength );
+
+                if( pair.key != NULL )
+                {
+                    TEST_ASSERT_EQUAL_STRING_LEN( pair.key, key, keyLength );
+                }
+
+                TEST_ASSERT_EQUAL( pair.jsonType, fragment.jsonType );
+                TEST_ASSERT_EQUAL( pair.valueLength, valueLength );
+                TEST_ASSERT_EQUAL_STRING_LEN( pair.value, value, valueLength );
+
+                keyLength = 0;
+                valueLength = 0;
+                iterateStatus = JSON_Iterate( buf, max, &iterateStart, &iterateNext, &pair );
+            }
+
+            jsonStatus = JSON_StreamIterate( &stream, &buf[ i ], n, &start, &fragment );
+        }
+
+        TEST_ASSERT_TRUE( ( jsonStatus == JSONPartial ) || ( jsonStatus == JSONNotFound ) );
+        TEST_ASSERT_EQUAL( ( jsonStatus == JSONPartial ) ? n : start, start );
+
+        i += n;
+        n = chunkSize;
+    }
+
+    TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
+    TEST_ASSERT_EQUAL( JSONNotFound, iterateStatus );
+}
+
 /**
  * @brief Test that JSON_Validate is able to classify any null or bad parameters.
  */
@@ -809,6 +912,63 @@ void test_JSON_Validate_Partial_Documents( void )
     TEST_ASSERT_EQUAL( JSONPartial, jsonStatus );
 }
 
+/**
+ * @brief Test that JSON_Validate checks every byte of strings and whitespace
+ * runs longer than a vector block, whatever the alignment of the byte.
+ */
+void test_JSON_Validate_Long_Strings( void )
+{
+    char doc[ 256 ];
+    size_t offset, i, length;
+
+#define LONG_STRING_LENGTH    ( 80U )
+#define checkLongString( insert, expected )                                    \
+    for( offset = 0; offset < LONG_STRING_LENGTH; offset++ )                  \
+    {                                                                          \
+        length = 0;                                                            \
+        doc[ length++ ] = '[';                                                 \
+        doc[ length++ ] = '"';                                                 \
+                                                                               \
+        for( i = 0; i < offset; i++ )                                          \
+        {                                                                      \
+            doc[ length++ ] = 'a';                                             \
+        }                                                                      \
+                                                                               \
+        memcpy( &doc[ length ], ( insert ), sizeof( insert ) - 1 );            \
+        length += sizeof( insert ) - 1;                                        \
+                                                                               \
+        for( i = offset; i < LONG_STRING_LENGTH; i++ )                         \
+        {                                                                      \
+            doc[ length++ ] = 'b';                                             \
+        }                                                                      \
+                                                                               \
+        doc[ length++ ] = '"';                                                 \
+                                                                               \
+        /* whitespace long enough to span blocks before the closing bracket */ \
+        for( i = 0; i < offset; i++ )                                          \
+        {                                                                      \
+            doc[ length++ ] = " \t\r\n"[ i % 4U ];                              \
+        }                                                                      \
+                                                                               \
+        doc[ length++ ] = ']';                                                 \
+        TEST_ASSERT_EQUAL( ( expected ), JSON_Validate( doc, length ) );       \
+    }
+
+    checkLongString( "", JSONSuccess );
+    checkLongString( MULTIPLE_VALID_ESCAPES, JSONSuccess );
+    checkLongString( LEGAL_UTF8_BYTE_SEQUENCES, JSONSuccess );
+    checkLongString( LEGAL_UNICODE_ESCAPE_SURROGATES, JSONSuccess );
+    checkLongString( "\x7F", JSONSuccess );
+    checkLongString( "\x01", JSONIllegalDocument );
+    checkLongString( "\x1F", JSONIllegalDocument );
+    checkLongString( "\xC0\x80", JSONIllegalDocument );
+    checkLongString( "\xED\xA0\x80", JSONIllegalDocument );
+    checkLongString( "\xFF", JSONIllegalDocument );
+    checkLongString( "\\x", JSONIllegalDocument );
+    checkLongString( "\\u0000", JSONIllegalDocument );
+    checkLongString( "\"", JSONIllegalDocument );
+}
+
 /**
  * @brief Test that JSON_Search can find the right value given a query key.
  */
@@ -1716,6 +1876,598 @@ void test_JSON_Max_Depth( void )
     free( maxNestedObject );
 }
 
+/**
+ * @brief Test that JSON_SearchIndex finds the same values as JSON_Search.
+ */
+void test_JSON_SearchIndex_Legal_Documents( void )
+{
+    JSONStatus_t jsonStatus;
+    JSONIndexEntry_t entries[ 32 ];
+    JSONIndex_t index;
+    const char * outValue;
+    size_t outValueLength;
+    JSONTypes_t outType;
+
+    jsonStatus = JSON_BuildIndex( JSON_DOC_LEGAL_ARRAY,
+                                  JSON_DOC_LEGAL_ARRAY_LENGTH,
+                                  entries,
+                                  32,
+                                  &index );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    /* The root array, its six elements, and the four values nested in element 2. */
+    TEST_ASSERT_EQUAL( 11, index.entryCount );
+
+#define doIndexSearch( query, type, answer )                           \
+    jsonStatus = JSON_SearchIndex( &index,                             \
+                                   ( query ),                          \
+                                   ( sizeof( query ) - 1 ),            \
+                                   &outValue,                          \
+                                   &outValueLength,                    \
+                                   &outType );                         \
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );                      \
+    TEST_ASSERT_EQUAL( type, outType );                                \
+    TEST_ASSERT_EQUAL( outValueLength, ( sizeof( answer ) - 1 ) );     \
+    TEST_ASSERT_EQUAL_STRING_LEN( ( answer ),                          \
+                                  outValue,                            \
+                                  outValueLength );
+
+    doIndexSearch( "[0]", ARRAY_ELEMENT_0_TYPE, ARRAY_ELEMENT_0 );
+    doIndexSearch( "[1]", ARRAY_ELEMENT_1_TYPE, ARRAY_ELEMENT_1 );
+    doIndexSearch( "[2]", ARRAY_ELEMENT_2_TYPE, ARRAY_ELEMENT_2 );
+    doIndexSearch( "[2]." FIRST_QUERY_KEY, ARRAY_ELEMENT_2_SUB_0_TYPE, ARRAY_ELEMENT_2_SUB_0 );
+    doIndexSearch( "[2]." SECOND_QUERY_KEY, ARRAY_ELEMENT_2_SUB_1_TYPE, ARRAY_ELEMENT_2_SUB_1 );
+    doIndexSearch( "[2]." SECOND_QUERY_KEY "[0]", ARRAY_ELEMENT_2_SUB_1_SUB_0_TYPE, ARRAY_ELEMENT_2_SUB_1_SUB_0 );
+    doIndexSearch( "[2]." SECOND_QUERY_KEY "[1]", ARRAY_ELEMENT_2_SUB_1_SUB_1_TYPE, ARRAY_ELEMENT_2_SUB_1_SUB_1 );
+    doIndexSearch( "[3]", ARRAY_ELEMENT_3_TYPE, ARRAY_ELEMENT_3 );
+    doIndexSearch( "[4]", ARRAY_ELEMENT_4_TYPE, ARRAY_ELEMENT_4 );
+    doIndexSearch( "[5]", ARRAY_ELEMENT_5_TYPE, ARRAY_ELEMENT_5 );
+
+    jsonStatus = JSON_BuildIndex( JSON_DOC_VARIED_SCALARS,
+                                  JSON_DOC_VARIED_SCALARS_LENGTH,
+                                  entries,
+                                  32,
+                                  &index );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+
+    doIndexSearch( COMPLETE_QUERY_KEY, COMPLETE_QUERY_KEY_ANSWER_TYPE, COMPLETE_QUERY_KEY_ANSWER );
+    doIndexSearch( FIRST_QUERY_KEY, FIRST_QUERY_KEY_ANSWER_TYPE, FIRST_QUERY_KEY_ANSWER );
+    doIndexSearch( "more_exponents[3]", JSONNumber, "128E-6" );
+    doIndexSearch( "more_literals.literal3", JSONNull, "null" );
+
+    jsonStatus = JSON_BuildIndex( JSON_DOC_LEGAL_TRAILING_SPACE,
+                                  JSON_DOC_LEGAL_TRAILING_SPACE_LENGTH,
+                                  entries,
+                                  32,
+                                  &index );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+
+    doIndexSearch( COMPLETE_QUERY_KEY, COMPLETE_QUERY_KEY_ANSWER_TYPE, COMPLETE_QUERY_KEY_ANSWER );
+
+    jsonStatus = JSON_BuildIndex( JSON_DOC_MULTIPLE_VALID_ESCAPES,
+                                  JSON_DOC_MULTIPLE_VALID_ESCAPES_LENGTH,
+                                  entries,
+                                  32,
+                                  &index );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+
+    doIndexSearch( COMPLETE_QUERY_KEY, JSONString, MULTIPLE_VALID_ESCAPES );
+
+    /* A scalar document has a single entry. */
+    jsonStatus = JSON_BuildIndex( " 123 ", 5, entries, 1, &index );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( 1, index.entryCount );
+}
+
+/**
+ * @brief Test that JSON_SearchIndex returns JSONNotFound for queries that
+ * do not apply to the indexed document.
+ */
+void test_JSON_SearchIndex_Query_Not_Found( void )
+{
+    JSONStatus_t jsonStatus;
+    JSONIndexEntry_t entries[ 32 ];
+    JSONIndex_t index;
+    const char * outValue;
+    size_t outValueLength;
+
+    jsonStatus = JSON_BuildIndex( JSON_DOC_LEGAL_ARRAY,
+                                  JSON_DOC_LEGAL_ARRAY_LENGTH,
+                                  entries,
+                                  32,
+                                  &index );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+
+#define notFoundIndexSearch( query )                                          \
+    jsonStatus = JSON_SearchIndex( &index, ( query ), ( sizeof( query ) - 1 ), \
+                                   &outValue, &outValueLength, NULL );         \
+    TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
+
+    notFoundIndexSearch( "[6]" );
+    notFoundIndexSearch( FIRST_QUERY_KEY );
+    notFoundIndexSearch( "[2][0]" );
+    notFoundIndexSearch( "[2].missing" );
+    notFoundIndexSearch( "[0][0]" );
+    notFoundIndexSearch( "[2]." FIRST_QUERY_KEY "." SECOND_QUERY_KEY );
+
+    jsonStatus = JSON_SearchIndex( &index, "[2]..x", 6, &outValue, &outValueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
+
+    jsonStatus = JSON_SearchIndex( &index, "[-1]", 4, &outValue, &outValueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
+}
+
+/**
+ * @brief Test that JSON_BuildIndex accepts and rejects the same documents
+ * as JSON_Validate.
+ */
+void test_JSON_BuildIndex_Matches_Validate( void )
+{
+    JSONIndexEntry_t entries[ 64 ];
+    JSONIndex_t index;
+    size_t i;
+    char * maxNestedArray, * maxNestedObject;
+    static const char * docs[] =
+    {
+        JSON_DOC_LEGAL_TRAILING_SPACE,
+        JSON_DOC_VARIED_SCALARS,
+        JSON_DOC_LEGAL_ARRAY,
+        JSON_DOC_LEGAL_UTF8_BYTE_SEQUENCES,
+        JSON_DOC_LEGAL_UNICODE_ESCAPE_SURROGATES,
+        INCORRECT_OBJECT_SEPARATOR,
+        ILLEGAL_KEY_NOT_STRING,
+        WRONG_KEY_VALUE_SEPARATOR,
+        TRAILING_COMMA_IN_ARRAY,
+        CUT_AFTER_COMMA_SEPARATOR,
+        CUT_AFTER_KEY,
+        TRAILING_COMMA_AFTER_VALUE,
+        MISSING_COMMA_AFTER_VALUE,
+        MISSING_VALUE_AFTER_KEY,
+        MISMATCHED_BRACKETS,
+        MISMATCHED_BRACKETS2,
+        MISMATCHED_BRACKETS3,
+        MISMATCHED_BRACKETS4,
+        NUL_ESCAPE,
+        OPENING_CURLY_BRACKET,
+        WHITE_SPACE,
+        CUT_AFTER_OBJECT_OPEN_BRACE,
+        CUT_AFTER_NUMBER,
+        CUT_AFTER_ARRAY_START_MARKER,
+        CUT_AFTER_OBJECT_START_MARKER,
+        "[] x",
+        "[[],{},[{}]]"
+    };
+
+    for( i = 0; i < ( sizeof( docs ) / sizeof( docs[ 0 ] ) ); i++ )
+    {
+        TEST_ASSERT_EQUAL( JSON_Validate( docs[ i ], strlen( docs[ i ] ) ),
+                           JSON_BuildIndex( docs[ i ], strlen( docs[ i ] ), entries, 64, &index ) );
+    }
+
+    maxNestedArray = allocateMaxDepthArray();
+    TEST_ASSERT_EQUAL( JSONMaxDepthExceeded,
+                       JSON_BuildIndex( maxNestedArray, strlen( maxNestedArray ), entries, 64, &index ) );
+
+    maxNestedObject = allocateMaxDepthObject();
+    TEST_ASSERT_EQUAL( JSONMaxDepthExceeded,
+                       JSON_BuildIndex( maxNestedObject, strlen( maxNestedObject ), entries, 64, &index ) );
+
+    free( maxNestedArray );
+    free( maxNestedObject );
+}
+
+/**
+ * @brief Test JSON_BuildIndex and JSON_SearchIndex with invalid parameters.
+ */
+void test_JSON_Index_Invalid_Params( void )
+{
+    JSONStatus_t jsonStatus;
+    JSONIndexEntry_t entries[ 32 ];
+    JSONIndex_t index = { 0 };
+    const char * outValue;
+    size_t outValueLength;
+
+    jsonStatus = JSON_BuildIndex( NULL, 0, entries, 32, &index );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+
+    jsonStatus = JSON_BuildIndex( JSON_DOC_LEGAL_ARRAY, JSON_DOC_LEGAL_ARRAY_LENGTH, NULL, 32, &index );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+
+    jsonStatus = JSON_BuildIndex( JSON_DOC_LEGAL_ARRAY, JSON_DOC_LEGAL_ARRAY_LENGTH, entries, 32, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+
+    jsonStatus = JSON_BuildIndex( JSON_DOC_LEGAL_ARRAY, 0, entries, 32, &index );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
+
+    jsonStatus = JSON_BuildIndex( JSON_DOC_LEGAL_ARRAY, JSON_DOC_LEGAL_ARRAY_LENGTH, entries, 0, &index );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
+
+    /* Not enough entries for the whole document. */
+    jsonStatus = JSON_BuildIndex( JSON_DOC_LEGAL_ARRAY, JSON_DOC_LEGAL_ARRAY_LENGTH, entries, 10, &index );
+    TEST_ASSERT_EQUAL( JSONIndexFull, jsonStatus );
+    TEST_ASSERT_EQUAL( 0, index.entryCount );
+
+    /* An index that failed to build is empty. */
+    jsonStatus = JSON_SearchIndex( &index, "[0]", 3, &outValue, &outValueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
+
+    jsonStatus = JSON_BuildIndex( JSON_DOC_LEGAL_ARRAY, JSON_DOC_LEGAL_ARRAY_LENGTH, entries, 32, &index );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+
+    jsonStatus = JSON_SearchIndex( NULL, "[0]", 3, &outValue, &outValueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+
+    jsonStatus = JSON_SearchIndex( &index, NULL, 3, &outValue, &outValueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+
+    jsonStatus = JSON_SearchIndex( &index, "[0]", 3, NULL, &outValueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+
+    jsonStatus = JSON_SearchIndex( &index, "[0]", 3, &outValue, NULL, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+
+    jsonStatus = JSON_SearchIndex( &index, "[0]", 0, &outValue, &outValueLength, NULL );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
+}
+
+/**
+ * @brief Test that JSON_StreamInit and JSON_StreamValidate are able to classify any null parameters.
+ */
+void test_JSON_StreamValidate_Invalid_Params( void )
+{
+    JSONStatus_t jsonStatus;
+    JSONStream_t stream;
+
+    jsonStatus = JSON_StreamInit( NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+
+    jsonStatus = JSON_StreamInit( &stream );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+
+    jsonStatus = JSON_StreamValidate( NULL, SINGLE_SCALAR, SINGLE_SCALAR_LENGTH );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+
+    jsonStatus = JSON_StreamValidate( &stream, NULL, 1 );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+
+    /* An empty chunk is allowed. */
+    jsonStatus = JSON_StreamValidate( &stream, NULL, 0 );
+    TEST_ASSERT_EQUAL( JSONPartial, jsonStatus );
+    TEST_ASSERT_EQUAL( 0, stream.offset );
+}
+
+/**
+ * @brief Test that JSON_StreamValidate classifies documents as JSON_Validate does,
+ * however they are split into chunks.
+ */
+void test_JSON_StreamValidate_Matches_Validate( void )
+{
+    JSONStatus_t jsonStatus;
+    JSONStream_t stream;
+    size_t i, chunkSize;
+
+    static const struct
+    {
+        const char * buf;
+        size_t max;
+        JSONStatus_t expected;
+    }
+    documents[] =
+    {
+        { JSON_DOC_VARIED_SCALARS,                   JSON_DOC_VARIED_SCALARS_LENGTH,                   JSONSuccess         },
+        { JSON_DOC_LEGAL_TRAILING_SPACE,             JSON_DOC_LEGAL_TRAILING_SPACE_LENGTH,             JSONSuccess         },
+        { JSON_DOC_MULTIPLE_VALID_ESCAPES,           JSON_DOC_MULTIPLE_VALID_ESCAPES_LENGTH,           JSONSuccess         },
+        { JSON_DOC_LEGAL_UTF8_BYTE_SEQUENCES,        JSON_DOC_LEGAL_UTF8_BYTE_SEQUENCES_LENGTH,        JSONSuccess         },
+        { JSON_DOC_LEGAL_UNICODE_ESCAPE_SURROGATES,  JSON_DOC_LEGAL_UNICODE_ESCAPE_SURROGATES_LENGTH,  JSONSuccess         },
+        { JSON_DOC_UNICODE_ESCAPE_SEQUENCES_BMP,     JSON_DOC_UNICODE_ESCAPE_SEQUENCES_BMP_LENGTH,     JSONSuccess         },
+        { JSON_DOC_LEGAL_ARRAY,                      JSON_DOC_LEGAL_ARRAY_LENGTH,                      JSONSuccess         },
+        { INCORRECT_OBJECT_SEPARATOR,                INCORRECT_OBJECT_SEPARATOR_LENGTH,                JSONIllegalDocument },
+        { ILLEGAL_KEY_NOT_STRING,                    ILLEGAL_KEY_NOT_STRING_LENGTH,                    JSONIllegalDocument },
+        { WRONG_KEY_VALUE_SEPARATOR,                 WRONG_KEY_VALUE_SEPARATOR_LENGTH,                 JSONIllegalDocument },
+        { TRAILING_COMMA_IN_ARRAY,                   TRAILING_COMMA_IN_ARRAY_LENGTH,                   JSONIllegalDocument },
+        { TRAILING_COMMA_AFTER_VALUE,                TRAILING_COMMA_AFTER_VALUE_LENGTH,                JSONIllegalDocument },
+        { MISSING_COMMA_AFTER_VALUE,                 MISSING_COMMA_AFTER_VALUE_LENGTH,                 JSONIllegalDocument },
+        { MISSING_VALUE_AFTER_KEY,                   MISSING_VALUE_AFTER_KEY_LENGTH,                   JSONIllegalDocument },
+        { MISMATCHED_BRACKETS,                       MISMATCHED_BRACKETS_LENGTH,                       JSONIllegalDocument },
+        { MISMATCHED_BRACKETS2,                      MISMATCHED_BRACKETS2_LENGTH,                      JSONIllegalDocument },
+        { MISMATCHED_BRACKETS3,                      MISMATCHED_BRACKETS3_LENGTH,                      JSONIllegalDocument },
+        { MISMATCHED_BRACKETS4,                      MISMATCHED_BRACKETS4_LENGTH,                      JSONIllegalDocument },
+        { NUL_ESCAPE,                                NUL_ESCAPE_LENGTH,                                JSONIllegalDocument },
+        { SPACE_CONTROL_CHAR,                        SPACE_CONTROL_CHAR_LENGTH,                        JSONIllegalDocument },
+        { LT_ZERO_CONTROL_CHAR,                      LT_ZERO_CONTROL_CHAR_LENGTH,                      JSONIllegalDocument },
+        { CLOSING_SQUARE_BRACKET,                    CLOSING_SQUARE_BRACKET_LENGTH,                    JSONIllegalDocument },
+        { CLOSING_CURLY_BRACKET,                     CLOSING_CURLY_BRACKET_LENGTH,                     JSONIllegalDocument },
+        { MISSING_ENCLOSING_ARRAY_MARKER,            MISSING_ENCLOSING_ARRAY_MARKER_LENGTH,            JSONIllegalDocument },
+        { LETTER_AS_EXPONENT,                        LETTER_AS_EXPONENT_LENGTH,                        JSONIllegalDocument },
+        { LEADING_ZEROS_IN_NUMBER,                   LEADING_ZEROS_IN_NUMBER_LENGTH,                   JSONIllegalDocument },
+        { ILLEGAL_SCALAR_IN_ARRAY,                   ILLEGAL_SCALAR_IN_ARRAY_LENGTH,                   JSONIllegalDocument },
+        { UNESCAPED_CONTROL_CHAR,                    UNESCAPED_CONTROL_CHAR_LENGTH,                    JSONIllegalDocument },
+        { ILLEGAL_UTF8_NEXT_BYTE,                    ILLEGAL_UTF8_NEXT_BYTE_LENGTH,                    JSONIllegalDocument },
+        { ILLEGAL_UTF8_START_C1,                     ILLEGAL_UTF8_START_C1_LENGTH,                     JSONIllegalDocument },
+        { ILLEGAL_UTF8_START_F5,                     ILLEGAL_UTF8_START_F5_LENGTH,                     JSONIllegalDocument },
+        { ILLEGAL_UTF8_NEXT_BYTES,                   ILLEGAL_UTF8_NEXT_BYTES_LENGTH,                   JSONIllegalDocument },
+        { ILLEGAL_UTF8_GT_MIN_CP_FOUR_BYTES,         ILLEGAL_UTF8_GT_MIN_CP_FOUR_BYTES_LENGTH,         JSONIllegalDocument },
+        { ILLEGAL_UTF8_GT_MIN_CP_THREE_BYTES,        ILLEGAL_UTF8_GT_MIN_CP_THREE_BYTES_LENGTH,        JSONIllegalDocument },
+        { ILLEGAL_UTF8_LT_MAX_CP_FOUR_BYTES,         ILLEGAL_UTF8_LT_MAX_CP_FOUR_BYTES_LENGTH,         JSONIllegalDocument },
+        { ILLEGAL_UTF8_SURROGATE_RANGE_MIN,          ILLEGAL_UTF8_SURROGATE_RANGE_MIN_LENGTH,          JSONIllegalDocument },
+        { ILLEGAL_UTF8_SURROGATE_RANGE_MAX,          ILLEGAL_UTF8_SURROGATE_RANGE_MAX_LENGTH,          JSONIllegalDocument },
+        { ILLEGAL_UNICODE_LITERAL_HEX,               ILLEGAL_UNICODE_LITERAL_HEX_LENGTH,               JSONIllegalDocument },
+        { UNICODE_VALID_HIGH_NO_LOW_SURROGATE,       UNICODE_VALID_HIGH_NO_LOW_SURROGATE_LENGTH,       JSONIllegalDocument },
+        { UNICODE_WRONG_ESCAPE_AFTER_HIGH_SURROGATE, UNICODE_WRONG_ESCAPE_AFTER_HIGH_SURROGATE_LENGTH, JSONIllegalDocument },
+        { UNICODE_STRING_END_AFTER_HIGH_SURROGATE,   UNICODE_STRING_END_AFTER_HIGH_SURROGATE_LENGTH,   JSONIllegalDocument },
+        { UNICODE_PREMATURE_LOW_SURROGATE,           UNICODE_PREMATURE_LOW_SURROGATE_LENGTH,           JSONIllegalDocument },
+        { UNICODE_INVALID_LOWERCASE_HEX,             UNICODE_INVALID_LOWERCASE_HEX_LENGTH,             JSONIllegalDocument },
+        { UNICODE_INVALID_UPPERCASE_HEX,             UNICODE_INVALID_UPPERCASE_HEX_LENGTH,             JSONIllegalDocument },
+        { UNICODE_NON_LETTER_OR_DIGIT_HEX,           UNICODE_NON_LETTER_OR_DIGIT_HEX_LENGTH,           JSONIllegalDocument },
+        { UNICODE_BOTH_SURROGATES_HIGH,              UNICODE_BOTH_SURROGATES_HIGH_LENGTH,              JSONIllegalDocument },
+        { UNICODE_ESCAPE_SEQUENCE_ZERO_CP,           UNICODE_ESCAPE_SEQUENCE_ZERO_CP_LENGTH,           JSONIllegalDocument },
+        { UNICODE_VALID_HIGH_INVALID_LOW_SURROGATE,  UNICODE_VALID_HIGH_INVALID_LOW_SURROGATE_LENGTH,  JSONIllegalDocument },
+        /* JSON_Validate reports these as illegal since the buffer ends,
+         * but the next chunk could complete them. */
+        { CUT_AFTER_COMMA_SEPARATOR,                 CUT_AFTER_COMMA_SEPARATOR_LENGTH,                 JSONPartial         },
+        { CUT_AFTER_KEY,                             CUT_AFTER_KEY_LENGTH,                             JSONPartial         },
+        { CUT_AFTER_EXPONENT_MARKER,                 CUT_AFTER_EXPONENT_MARKER_LENGTH,                 JSONPartial         },
+        { CUT_AFTER_DECIMAL_POINT,                   CUT_AFTER_DECIMAL_POINT_LENGTH,                   JSONPartial         },
+        { CUT_AFTER_UTF8_FIRST_BYTE,                 CUT_AFTER_UTF8_FIRST_BYTE_LENGTH,                 JSONPartial         },
+        { ESCAPE_CHAR_ALONE,                         ESCAPE_CHAR_ALONE_LENGTH,                         JSONPartial         },
+        { ESCAPE_CHAR_ALONE_NOT_ENCLOSED,            ESCAPE_CHAR_ALONE_NOT_ENCLOSED_LENGTH,            JSONPartial         },
+        { OPENING_CURLY_BRACKET,                     OPENING_CURLY_BRACKET_LENGTH,                     JSONPartial         },
+        { WHITE_SPACE,                               WHITE_SPACE_LENGTH,                               JSONPartial         },
+        { CUT_AFTER_OBJECT_OPEN_BRACE,               CUT_AFTER_OBJECT_OPEN_BRACE_LENGTH,               JSONPartial         },
+        { CUT_AFTER_NUMBER,                          CUT_AFTER_NUMBER_LENGTH,                          JSONPartial         },
+        { CUT_AFTER_ARRAY_START_MARKER,              CUT_AFTER_ARRAY_START_MARKER_LENGTH,              JSONPartial         },
+        { CUT_AFTER_OBJECT_START_MARKER,             CUT_AFTER_OBJECT_START_MARKER_LENGTH,             JSONPartial         },
+    };
+
+    for( i = 0; i < ( sizeof( documents ) / sizeof( documents[ 0 ] ) ); i++ )
+    {
+        for( chunkSize = 1; chunkSize <= documents[ i ].max; chunkSize++ )
+        {
+            jsonStatus = streamValidate( documents[ i ].buf, documents[ i ].max, chunkSize, &stream );
+            TEST_ASSERT_EQUAL( documents[ i ].expected, jsonStatus );
+
+            if( jsonStatus != JSONIllegalDocument )
+            {
+                TEST_ASSERT_EQUAL( documents[ i ].max, stream.offset );
+            }
+        }
+    }
+}
+
+/**
+ * @brief Test the result of JSON_StreamValidate as a document arrives.
+ */
+void test_JSON_StreamValidate_Chunks( void )
+{
+    JSONStatus_t jsonStatus;
+    JSONStream_t stream;
+    char * maxNestedObject, * maxNestedArray;
+
+    /* A top-level number is complete after every digit. */
+    ( void ) JSON_StreamInit( &stream );
+    jsonStatus = JSON_StreamValidate( &stream, "-", 1 );
+    TEST_ASSERT_EQUAL( JSONPartial, jsonStatus );
+    jsonStatus = JSON_StreamValidate( &stream, "12", 2 );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    jsonStatus = JSON_StreamValidate( &stream, ".", 1 );
+    TEST_ASSERT_EQUAL( JSONPartial, jsonStatus );
+    jsonStatus = JSON_StreamValidate( &stream, "5E+", 3 );
+    TEST_ASSERT_EQUAL( JSONPartial, jsonStatus );
+    jsonStatus = JSON_StreamValidate( &stream, "3 ", 2 );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    jsonStatus = JSON_StreamValidate( &stream, "4", 1 );
+    TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+    TEST_ASSERT_EQUAL( 9, stream.offset );
+
+    /* Errors are sticky. */
+    jsonStatus = JSON_StreamValidate( &stream, " ", 1 );
+    TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+    TEST_ASSERT_EQUAL( 9, stream.offset );
+
+    /* A collection is complete at its close bracket, and may be followed
+     * by whitespace only. */
+    ( void ) JSON_StreamInit( &stream );
+    jsonStatus = JSON_StreamValidate( &stream, "[tr", 3 );
+    TEST_ASSERT_EQUAL( JSONPartial, jsonStatus );
+    jsonStatus = JSON_StreamValidate( &stream, "ue,0]", 5 );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    jsonStatus = JSON_StreamValidate( &stream, " \n", 2 );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    jsonStatus = JSON_StreamValidate( &stream, "[]", 2 );
+    TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+    TEST_ASSERT_EQUAL( 10, stream.offset );
+
+    /* A collection must be separated from a preceding value by a comma,
+     * and may not stand in for a key. */
+    jsonStatus = streamValidate( "[[] []]", 7, 7, &stream );
+    TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+    TEST_ASSERT_EQUAL( 4, stream.offset );
+
+    jsonStatus = streamValidate( "{\"a\":1,{}}", 10, 10, &stream );
+    TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+    TEST_ASSERT_EQUAL( 7, stream.offset );
+
+    maxNestedArray = allocateMaxDepthArray();
+    jsonStatus = streamValidate( maxNestedArray, strlen( maxNestedArray ), 5, &stream );
+    TEST_ASSERT_EQUAL( JSONMaxDepthExceeded, jsonStatus );
+    TEST_ASSERT_EQUAL( JSON_MAX_DEPTH, stream.offset );
+
+    maxNestedObject = allocateMaxDepthObject();
+    jsonStatus = streamValidate( maxNestedObject, strlen( maxNestedObject ), 5, &stream );
+    TEST_ASSERT_EQUAL( JSONMaxDepthExceeded, jsonStatus );
+
+    /* One level less is accepted. */
+    jsonStatus = streamValidate( &maxNestedArray[ 1 ], strlen( maxNestedArray ) - 2, 5, &stream );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+
+    free( maxNestedArray );
+    free( maxNestedObject );
+}
+
+/**
+ * @brief Test that JSON_StreamIterate is able to classify any null or bad parameters.
+ */
+void test_JSON_StreamIterate_Invalid_Params( void )
+{
+    JSONStatus_t jsonStatus;
+    JSONStream_t stream;
+    JSONFragment_t fragment;
+    size_t start = 0;
+
+    ( void ) JSON_StreamInit( &stream );
+
+    jsonStatus = JSON_StreamIterate( NULL, JSON_NESTED_OBJECT, JSON_NESTED_OBJECT_LENGTH, &start, &fragment );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+
+    jsonStatus = JSON_StreamIterate( &stream, NULL, JSON_NESTED_OBJECT_LENGTH, &start, &fragment );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+
+    jsonStatus = JSON_StreamIterate( &stream, JSON_NESTED_OBJECT, JSON_NESTED_OBJECT_LENGTH, NULL, &fragment );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+
+    jsonStatus = JSON_StreamIterate( &stream, JSON_NESTED_OBJECT, JSON_NESTED_OBJECT_LENGTH, &start, NULL );
+    TEST_ASSERT_EQUAL( JSONNullParameter, jsonStatus );
+
+    start = JSON_NESTED_OBJECT_LENGTH + 1;
+    jsonStatus = JSON_StreamIterate( &stream, JSON_NESTED_OBJECT, JSON_NESTED_OBJECT_LENGTH, &start, &fragment );
+    TEST_ASSERT_EQUAL( JSONBadParameter, jsonStatus );
+
+    /* An empty chunk is allowed. */
+    start = 0;
+    jsonStatus = JSON_StreamIterate( &stream, NULL, 0, &start, &fragment );
+    TEST_ASSERT_EQUAL( JSONPartial, jsonStatus );
+    TEST_ASSERT_EQUAL( 0, stream.offset );
+}
+
+/**
+ * @brief Test that JSON_StreamIterate outputs what JSON_Iterate does, however
+ * a document is split into chunks.
+ */
+void test_JSON_StreamIterate_Matches_Iterate( void )
+{
+    size_t i, split, chunkSize;
+
+    static const struct
+    {
+        const char * buf;
+        size_t max;
+    }
+    documents[] =
+    {
+        { JSON_NESTED_OBJECT,                       JSON_NESTED_OBJECT_LENGTH                       },
+        { JSON_DOC_LEGAL_ARRAY,                     JSON_DOC_LEGAL_ARRAY_LENGTH                     },
+        { JSON_DOC_VARIED_SCALARS,                  JSON_DOC_VARIED_SCALARS_LENGTH                  },
+        { JSON_DOC_LEGAL_TRAILING_SPACE,            JSON_DOC_LEGAL_TRAILING_SPACE_LENGTH            },
+        { JSON_DOC_MULTIPLE_VALID_ESCAPES,          JSON_DOC_MULTIPLE_VALID_ESCAPES_LENGTH          },
+        { JSON_DOC_LEGAL_UTF8_BYTE_SEQUENCES,       JSON_DOC_LEGAL_UTF8_BYTE_SEQUENCES_LENGTH       },
+        { JSON_DOC_LEGAL_UNICODE_ESCAPE_SURROGATES, JSON_DOC_LEGAL_UNICODE_ESCAPE_SURROGATES_LENGTH },
+        { "[ \"\", {}, [], 0 ]",                    18                                              },
+    };
+
+    for( i = 0; i < ( sizeof( documents ) / sizeof( documents[ 0 ] ) ); i++ )
+    {
+        /* Chunks of every size. */
+        for( chunkSize = 1; chunkSize <= documents[ i ].max; chunkSize++ )
+        {
+            streamIterateMatches( documents[ i ].buf, documents[ i ].max, chunkSize, chunkSize );
+        }
+
+        /* Two chunks, split at every byte. */
+        for( split = 0; split <= documents[ i ].max; split++ )
+        {
+            streamIterateMatches( documents[ i ].buf, documents[ i ].max, split, documents[ i ].max );
+        }
+    }
+}
+
+/**
+ * @brief Test the output of JSON_StreamIterate as a document arrives.
+ */
+void test_JSON_StreamIterate_Chunks( void )
+{
+    JSONStatus_t jsonStatus;
+    JSONStream_t stream;
+    JSONFragment_t fragment;
+    size_t start;
+    char * maxNestedArray;
+
+    /* A key is output separately from its value, and a value that spans
+     * chunks is output a fragment per chunk. */
+    ( void ) JSON_StreamInit( &stream );
+    start = 0;
+    jsonStatus = JSON_StreamIterate( &stream, "{\"ke", 4, &start, &fragment );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL_STRING_LEN( "ke", fragment.fragment, fragment.fragmentLength );
+    TEST_ASSERT_TRUE( fragment.isKey );
+    TEST_ASSERT_FALSE( fragment.isLast );
+    jsonStatus = JSON_StreamIterate( &stream, "{\"ke", 4, &start, &fragment );
+    TEST_ASSERT_EQUAL( JSONPartial, jsonStatus );
+    TEST_ASSERT_EQUAL( 4, start );
+
+    start = 0;
+    jsonStatus = JSON_StreamIterate( &stream, "y\": 12", 6, &start, &fragment );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL_STRING_LEN( "y", fragment.fragment, fragment.fragmentLength );
+    TEST_ASSERT_EQUAL( JSONString, fragment.jsonType );
+    TEST_ASSERT_TRUE( fragment.isKey );
+    TEST_ASSERT_TRUE( fragment.isLast );
+    jsonStatus = JSON_StreamIterate( &stream, "y\": 12", 6, &start, &fragment );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL_STRING_LEN( "12", fragment.fragment, fragment.fragmentLength );
+    TEST_ASSERT_EQUAL( JSONNumber, fragment.jsonType );
+    TEST_ASSERT_FALSE( fragment.isKey );
+    TEST_ASSERT_FALSE( fragment.isLast );
+
+    /* The end of a number is only known from the byte after it, so the
+     * last fragment is empty. */
+    start = 0;
+    jsonStatus = JSON_StreamIterate( &stream, "}  ", 3, &start, &fragment );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL( 0, fragment.fragmentLength );
+    TEST_ASSERT_EQUAL( JSONNumber, fragment.jsonType );
+    TEST_ASSERT_TRUE( fragment.isLast );
+    TEST_ASSERT_EQUAL( 1, start );
+    jsonStatus = JSON_StreamIterate( &stream, "}  ", 3, &start, &fragment );
+    TEST_ASSERT_EQUAL( JSONNotFound, jsonStatus );
+    TEST_ASSERT_EQUAL( 11, stream.offset );
+
+    /* The document must be a collection. */
+    ( void ) JSON_StreamInit( &stream );
+    start = 0;
+    jsonStatus = JSON_StreamIterate( &stream, " \"a\"", 4, &start, &fragment );
+    TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+    TEST_ASSERT_EQUAL( 1, stream.offset );
+
+    /* Errors are sticky, and the offending byte is reported. */
+    ( void ) JSON_StreamInit( &stream );
+    start = 0;
+    jsonStatus = JSON_StreamIterate( &stream, "[tru", 4, &start, &fragment );
+    TEST_ASSERT_EQUAL( JSONSuccess, jsonStatus );
+    TEST_ASSERT_EQUAL_STRING_LEN( "tru", fragment.fragment, fragment.fragmentLength );
+    TEST_ASSERT_EQUAL( JSONTrue, fragment.jsonType );
+    start = 0;
+    jsonStatus = JSON_StreamIterate( &stream, "x]", 2, &start, &fragment );
+    TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+    TEST_ASSERT_EQUAL( 4, stream.offset );
+    start = 0;
+    jsonStatus = JSON_StreamIterate( &stream, "e]", 2, &start, &fragment );
+    TEST_ASSERT_EQUAL( JSONIllegalDocument, jsonStatus );
+
+    /* The nesting of a value is limited as when validating. */
+    maxNestedArray = allocateMaxDepthArray();
+    ( void ) JSON_StreamInit( &stream );
+    start = 0;
+
+    do
+    {
+        jsonStatus = JSON_StreamIterate( &stream, maxNestedArray, strlen( maxNestedArray ), &start, &fragment );
+    } while( jsonStatus == JSONSuccess );
+
+    TEST_ASSERT_EQUAL( JSONMaxDepthExceeded, jsonStatus );
+    TEST_ASSERT_EQUAL( JSON_MAX_DEPTH, stream.offset );
+
+    free( maxNestedArray );
+}
+
 /**
  * @brief Trip all asserts in internal functions.
  */
@@ -1851,6 +2603,76 @@ void test_JSON_asserts( void )
     catch_assert( iterate( buf, max, &start, &next, &key, NULL, &value, &valueLength ) );
     catch_assert( iterate( buf, max, &start, &next, &key, &keyLength, NULL, &valueLength ) );
     catch_assert( iterate( buf, max, &start, &next, &key, &keyLength, &value, NULL ) );
+
+    catch_assert( nextQueryPart( NULL, &start, max, &queryIndex, &key, &keyLength ) );
+    catch_assert( nextQueryPart( queryKey, NULL, max, &queryIndex, &key, &keyLength ) );
+    catch_assert( nextQueryPart( queryKey, &start, 0, &queryIndex, &key, &keyLength ) );
+    catch_assert( nextQueryPart( queryKey, &start, max, NULL, &key, &keyLength ) );
+    catch_assert( nextQueryPart( queryKey, &start, max, &queryIndex, NULL, &keyLength ) );
+    catch_assert( nextQueryPart( queryKey, &start, max, &queryIndex, &key, NULL ) );
+
+    {
+        JSONIndexEntry_t entries[ 1 ];
+        JSONIndex_t index = { buf, entries, 0, 1 };
+        bool isCollection;
+
+        catch_assert( indexValue( NULL, &start, max, &index, key, keyLength, &isCollection ) );
+        catch_assert( indexValue( buf, NULL, max, &index, key, keyLength, &isCollection ) );
+        catch_assert( indexValue( buf, &start, 0, &index, key, keyLength, &isCollection ) );
+        catch_assert( indexValue( buf, &start, max, NULL, key, keyLength, &isCollection ) );
+        catch_assert( indexValue( buf, &start, max, &index, key, keyLength, NULL ) );
+
+        catch_assert( skipKeyAndColon( NULL, &start, max, &key, &keyLength ) );
+        catch_assert( skipKeyAndColon( buf, NULL, max, &key, &keyLength ) );
+        catch_assert( skipKeyAndColon( buf, &start, 0, &key, &keyLength ) );
+        catch_assert( skipKeyAndColon( buf, &start, max, NULL, &keyLength ) );
+        catch_assert( skipKeyAndColon( buf, &start, max, &key, NULL ) );
+
+        catch_assert( indexCollection( NULL, &start, max, &index ) );
+        catch_assert( indexCollection( buf, NULL, max, &index ) );
+        catch_assert( indexCollection( buf, &start, 0, &index ) );
+        catch_assert( indexCollection( buf, &start, max, NULL ) );
+        /* assert: the root entry has been appended */
+        catch_assert( indexCollection( buf, &start, max, &index ) );
+
+        catch_assert( indexSearch( NULL, queryKey, length, &value ) );
+        catch_assert( indexSearch( &index, NULL, length, &value ) );
+        catch_assert( indexSearch( &index, queryKey, length, NULL ) );
+        /* assert: the index is not empty */
+        catch_assert( indexSearch( &index, queryKey, length, &value ) );
+    }
+
+    {
+        JSONStream_t stream;
+
+        ( void ) JSON_StreamInit( &stream );
+
+        /* assert: a collection is open */
+        catch_assert( streamInObject( &stream ) );
+        catch_assert( streamClose( &stream, ']' ) );
+
+        catch_assert( streamInObject( NULL ) );
+        catch_assert( streamEndValue( NULL ) );
+        catch_assert( streamBeginValue( NULL, 'x' ) );
+        catch_assert( streamClose( NULL, ']' ) );
+        catch_assert( streamStructural( NULL, 'x' ) );
+        catch_assert( streamEscape( NULL, 'x' ) );
+        catch_assert( streamString( NULL, 'x' ) );
+        catch_assert( streamNumber( NULL, 'x' ) );
+        catch_assert( streamByte( NULL, 'x' ) );
+        /* assert: a literal is being matched */
+        catch_assert( streamLiteral( NULL, 'x' ) );
+        catch_assert( streamLiteral( &stream, 'x' ) );
+        /* assert: hex digits remain */
+        catch_assert( streamHex( NULL, 'x' ) );
+        catch_assert( streamHex( &stream, 'x' ) );
+        catch_assert( streamMemberBegins( NULL, 0, 0, 'x' ) );
+        catch_assert( streamMemberEnds( NULL ) );
+        /* assert: a member is being iterated */
+        catch_assert( streamMemberEnds( &stream ) );
+        stream.member = JSONString;
+        catch_assert( streamMemberBegins( &stream, 0, 0, 'x' ) );
+    }
 }
 
 /**
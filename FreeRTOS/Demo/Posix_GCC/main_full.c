@@ -106,6 +106,7 @@
 #include "StreamBufferDemo.h"
 #include "StreamBufferInterrupt.h"
 #include "MessageBufferAMP.h"
+#include "freertos_agent_message_ring_test.h"
 #include "console.h"
 
 /* Priorities at which the tasks are created. */
@@ -119,6 +120,7 @@
 #define mainGEN_QUEUE_TASK_PRIORITY     ( tskIDLE_PRIORITY )
 #define mainFLOP_TASK_PRIORITY          ( tskIDLE_PRIORITY )
 #define mainQUEUE_OVERWRITE_PRIORITY    ( tskIDLE_PRIORITY )
+#define mainAGENT_RING_PRIORITY         ( tskIDLE_PRIORITY )
 
 #define mainTIMER_TEST_PERIOD           ( 50 )
 
@@ -224,6 +226,7 @@ int main_full( void )
     vStartStreamBufferTasks();
     vStartStreamBufferInterruptDemo();
     vStartMessageBufferAMPTasks( configMINIMAL_STACK_SIZE );
+    vStartAgentMessageRingTasks( mainAGENT_RING_PRIORITY );
 
     #if ( configUSE_QUEUE_SETS == 1 )
         {
@@ -404,6 +407,11 @@ static void prvCheckTask( void * pvParameters )
             pcStatusMessage = "Error: Message buffer AMP";
             xErrorCount++;
         }
+        else if( xAreAgentMessageRingTasksStillRunning() != pdPASS )
+        {
+            pcStatusMessage = "Error: Agent message ring";
+            xErrorCount++;
+        }
 
         #if ( configUSE_QUEUE_SETS == 1 )
             else if( xAreQueueSetTasksStillRunning() != pdPASS )
@@ -7,6 +7,7 @@
  #include <stdlib.h>
  #include <math.h>
  #include <string.h>
+ #include <ctype.h>
  #include <unistd.h>    // for getcwd debug
  #include <limits.h>    // for PATH_MAX
  #include "FreeRTOS.h"  
@@ -15,6 +16,10 @@
  #define MAX_TASKS 50
  #define MAX_JOBS  5000
  
+ #define MAX_CRIT_LEVELS 8
+ 
+ /* Levels run from 0 (least critical) to g_numLevels-1; 'L' and 'H' map to
+  * the two lowest. */
  typedef enum { CRIT_LOW = 0, CRIT_HIGH } CritLevel_t;
  
  typedef struct {
@@ -23,8 +28,9 @@
      double period;
      double wcet;
      double deadline;
-     CritLevel_t critLevel;
-     double virtualDeadline;
+     int critLevel;
+     double levelWcet[MAX_CRIT_LEVELS]; /* budget at each system level up to critLevel */
+     double virtualDeadline;            /* at system level 0 */
      int jobCount;
  } TaskInfo_t;
  
@@ -40,6 +46,7 @@
      double  startTime;
      double  finishTime;
      int     finished;
+     int     dropped;   /* discarded by a criticality mode switch */
  } Job_t;
  
  /* Global arrays, static file scope */
@@ -50,6 +57,13 @@
  static int g_numTasks = 0;
  static int g_numJobs  = 0;
  
+ /* Criticality levels, EDF-VD scaling factor of each, current system level
+  * and the number of times it was raised. */
+ static int    g_numLevels = 1;
+ static double g_scaling[MAX_CRIT_LEVELS];
+ static int    g_mode = 0;
+ static int    g_numModeSwitches = 0;
+ 
  /* local function prototypes */
  static void parseTaskFile(const char* filename);
  static void computeHyperPeriodAndJobCounts(double* hyperPeriod);
@@ -58,6 +72,12 @@
  static void scheduleEDFVD(double hyperPeriod);
  static void writeScheduleToFile(const char* schedFile);
  static void analyzeSchedule(const char* analysisFile);
+ static int parseCritLevel(const char* token);
+ static int parseLevelWcets(const char* token, TaskInfo_t* task);
+ static double taskDeadlineInMode(int tIndex, int mode);
+ static void setSystemMode(int mode, double now);
+ static double budgetExhaustionTime(int jobIndex, double now);
+ static void checkBudgetOverrun(int jobIndex, double now);
  
  /* For capturing scheduling slices. */
  typedef struct {
@@ -92,6 +112,9 @@
     g_numTasks = 0;
     g_numJobs  = 0;
     g_numSlices = 0;
+    g_numLevels = 1;
+    g_mode = 0;
+    g_numModeSwitches = 0;
   
     // Debug: print working directory
     char cwd[PATH_MAX];
@@ -161,27 +184,41 @@
      printf("DEBUG: parseTaskFile => Read g_numTasks = %d\n", g_numTasks);
  
      for(int i=0; i<g_numTasks; i++){
-         char c;
-         /* Example line: T1 0 10 3 10 H */
-         int ret = fscanf(fp, "%s %lf %lf %lf %lf %c",
+         char wcetToken[128];
+         char critToken[16];
+         /* Example line: T1 0 10 3 10 H
+          * The criticality is L/H, a level number (0 is the least critical) or a
+          * DAL letter A..E, and the wcet a comma separated list of the budgets at
+          * levels 0..crit (e.g. 2,3.5) whose last value repeats. */
+         int ret = fscanf(fp, "%31s %lf %lf %127s %lf %15s",
                           tasks[i].name,
                           &tasks[i].phase,
                           &tasks[i].period,
-                          &tasks[i].wcet,
+                          wcetToken,
                           &tasks[i].deadline,
-                          &c);
+                          critToken);
          if(ret != 6) {
              printf("ERROR: Malformed task line %d in %s. ret=%d\n", i, filename, ret);
              g_numTasks = i; // only i tasks read so far
              break;
          }
  
-         tasks[i].critLevel = (c=='H' || c=='h') ? CRIT_HIGH : CRIT_LOW;
+         tasks[i].critLevel = parseCritLevel(critToken);
+         if(tasks[i].critLevel < 0 || !parseLevelWcets(wcetToken, &tasks[i])) {
+             printf("ERROR: Bad criticality '%s' or wcet '%s' on task line %d in %s.\n",
+                    critToken, wcetToken, i, filename);
+             g_numTasks = i;
+             break;
+         }
+         if(tasks[i].critLevel >= g_numLevels) {
+             g_numLevels = tasks[i].critLevel + 1;
+         }
+ 
          tasks[i].virtualDeadline = tasks[i].deadline; /* Will be scaled for high crit if needed */
          tasks[i].jobCount = 0;
  
-         printf("DEBUG: Task[%d]: name=%s, phase=%.2f, period=%.2f, wcet=%.2f, deadline=%.2f, crit=%c\n",
-                i, tasks[i].name, tasks[i].phase, tasks[i].period, tasks[i].wcet, tasks[i].deadline, c);
+         printf("DEBUG: Task[%d]: name=%s, phase=%.2f, period=%.2f, wcet=%.2f, deadline=%.2f, crit=%d\n",
+                i, tasks[i].name, tasks[i].phase, tasks[i].period, tasks[i].wcet, tasks[i].deadline, tasks[i].critLevel);
      }
  
      fclose(fp);
@@ -238,27 +275,61 @@
   *-----------------------------------------------------------*/
  static void computeEDFVDParameters(void)
  {
-     double U_H = 0.0, U_L = 0.0;
+     /* Two-level EDF-VD applied at each mode switch. At system level m the
+      * tasks at level m keep their deadlines (U_lo[m]) and the tasks above it
+      * are scaled by x[m] (U_hi[m]), both at their level-m budgets. Level m
+      * needs a density V[m] = U_lo[m] + U_hi[m]/x[m] <= 1, and the switch to
+      * m+1 needs x[m]*U_lo[m] + V[m+1] <= 1. Levels above 0 take the largest
+      * x[m] the switch allows; level 0 keeps x = U_H / (1 - U_L). */
+     double U_lo[MAX_CRIT_LEVELS] = { 0.0 };
+     double U_hi[MAX_CRIT_LEVELS] = { 0.0 };
      for(int i=0; i<g_numTasks; i++){
-         double util = tasks[i].wcet / tasks[i].period;
-         if(tasks[i].critLevel == CRIT_HIGH) {
-             U_H += util;
-         } else {
-             U_L += util;
+         for(int m=0; m<=tasks[i].critLevel; m++){
+             double util = tasks[i].levelWcet[m] / tasks[i].period;
+             if(m == tasks[i].critLevel) {
+                 U_lo[m] += util;
+             } else {
+                 U_hi[m] += util;
+             }
          }
      }
-     printf("DEBUG: U_H=%.2f, U_L=%.2f\n", U_H, U_L);
  
-     double x = 1.0;
-     if(U_L < 1.0){
-         x = U_H / (1.0 - U_L);
+     int top = g_numLevels - 1;
+     double density = U_lo[top];
+     int feasible = (density <= 1.0 + 1e-9);
+     g_scaling[top] = 1.0;
+ 
+     for(int m=top-1; m>=0; m--){
+         printf("DEBUG: level %d: U_lo=%.2f, U_hi=%.2f\n", m, U_lo[m], U_hi[m]);
+ 
+         double x = 1.0;
+         if(m == 0){
+             if(U_lo[0] < 1.0) {
+                 x = U_hi[0] / (1.0 - U_lo[0]);
+             }
+         } else if(U_lo[m] > 0.0){
+             x = (1.0 - density) / U_lo[m];
+         }
          if(x > 1.0) x = 1.0;
+         if(x <= 0.0){
+             x = 1.0;
+             feasible = 0;
+         }
+ 
+         if(x * U_lo[m] + density > 1.0 + 1e-9) feasible = 0;
+         density = U_lo[m] + U_hi[m] / x;
+         if(density > 1.0 + 1e-9) feasible = 0;
+         g_scaling[m] = x;
+         printf("DEBUG: scaling factor x[%d]=%.2f\n", m, x);
+     }
+ 
+     if(!feasible) {
+         printf("DEBUG: task set fails the EDF-VD test for %d criticality levels\n", g_numLevels);
      }
-     printf("DEBUG: scaling factor x=%.2f\n", x);
  
      for(int i=0; i<g_numTasks; i++){
-         if(tasks[i].critLevel == CRIT_HIGH){
-             tasks[i].virtualDeadline = tasks[i].deadline * x;
+         tasks[i].virtualDeadline = taskDeadlineInMode(i, 0);
+         if(tasks[i].critLevel > 0){
              printf("DEBUG: Task[%d]=%s => scaled vDL=%.2f\n", i, tasks[i].name, tasks[i].virtualDeadline);
          }
      }
@@ -320,6 +391,7 @@
              jobs[g_numJobs].actualExecTime  = actualETs[j];
              jobs[g_numJobs].remainingTime   = actualETs[j];
              jobs[g_numJobs].finished        = 0;
+             jobs[g_numJobs].dropped         = 0;
  
              double realDL = arrival + tasks[t].deadline;
              double vDL    = arrival + tasks[t].virtualDeadline;
@@ -381,10 +453,15 @@
          int activeIndices[2000];
          int activeCount = 0;
          for(int i = 0; i < g_numJobs; i++){
-             if(!jobs[i].finished &&
+             if(!jobs[i].finished && !jobs[i].dropped &&
                 jobs[i].arrivalTime <= now &&
                 jobs[i].remainingTime > 0.0)
              {
+                 if(tasks[jobs[i].taskIndex].critLevel < g_mode){
+                     /* Released while the system is above its level. */
+                     jobs[i].dropped = 1;
+                     continue;
+                 }
                  activeIndices[activeCount++] = i;
              }
          }
@@ -392,6 +469,10 @@
          printf("DEBUG: activeCount=%d\n", activeCount);
   
          if(activeCount == 0) {
+             /* Idle instant => the system returns to level 0 */
+             if(g_mode != 0) {
+                 setSystemMode(0, now);
+             }
              /* No active jobs => jump to the next arrival */
              double nextArrival = simulationLimit;  // default to simulationLimit
              for(int i = 0; i < g_numJobs; i++){
@@ -452,6 +533,8 @@
          }
          double finishIfUninterrupted = now + remain;
          double nextDecision = (nextArrival < finishIfUninterrupted) ? nextArrival : finishIfUninterrupted;
+         double budgetEnd = budgetExhaustionTime(chosenIndex, now);
+         if(budgetEnd < nextDecision) nextDecision = budgetEnd;
   
          /* Record a new scheduling slice if the job changes. */
          if(chosenIndex != lastJobIndex){
@@ -483,6 +566,9 @@
              printf("DEBUG: Job finished => T=%d, jobId=%d at time=%.2f\n",
                     jobs[chosenIndex].taskIndex, jobs[chosenIndex].jobId, now);
          }
+         else {
+             checkBudgetOverrun(chosenIndex, now);
+         }
      }
  }
  
@@ -532,6 +618,7 @@
      double totalWait = 0.0;
      double totalResp = 0.0;
      int finishedJobs = 0;
+     int droppedJobs = 0;
  
      for(int i=0; i<g_numJobs; i++){
          if(jobs[i].finished){
@@ -541,6 +628,9 @@
              totalResp += resp;
              finishedJobs++;
          }
+         if(jobs[i].dropped){
+             droppedJobs++;
+         }
      }
  
      double avgWait = 0.0;
@@ -557,7 +647,112 @@
      fprintf(fp, "Preemptions     : %d\n", preemptions);
      fprintf(fp, "Avg Wait        : %.2f\n", avgWait);
      fprintf(fp, "Avg Response    : %.2f\n", avgResp);
+     fprintf(fp, "Mode switches   : %d\n", g_numModeSwitches);
+     fprintf(fp, "Dropped jobs    : %d\n", droppedJobs);
  
      fclose(fp);
  }
- 
\ No newline at end of file
+ 
+ /*-----------------------------------------------------------
+  * Criticality level helpers
+  *-----------------------------------------------------------*/
+ static int parseCritLevel(const char* token)
+ {
+     /* L/H, a DAL letter (A is the most critical) or a level number */
+     if(token[0] != '\0' && token[1] == '\0'){
+         char c = (char) toupper((unsigned char) token[0]);
+         if(c == 'L') return CRIT_LOW;
+         if(c == 'H') return CRIT_HIGH;
+         if(c >= 'A' && c <= 'E') return 'E' - c;
+     }
+ 
+     char* end;
+     long level = strtol(token, &end, 10);
+     if(end == token || *end != '\0' || level < 0 || level >= MAX_CRIT_LEVELS) {
+         return -1;
+     }
+     return (int) level;
+ }
+ 
+ static int parseLevelWcets(const char* token, TaskInfo_t* task)
+ {
+     /* "3" is the same budget at every level, "2,3" is C(0)=2 and C(1)=3 */
+     const char* p = token;
+     int count = 0;
+     while(*p != '\0'){
+         char* end;
+         double value = strtod(p, &end);
+         if(end == p || value < 0.0 || count > task->critLevel) return 0;
+         if(count > 0 && value < task->levelWcet[count-1]) return 0; /* budgets only grow */
+         task->levelWcet[count++] = value;
+         if(*end == ',') end++;
+         else if(*end != '\0') return 0;
+         p = end;
+     }
+     if(count == 0) return 0;
+ 
+     for(int m=count; m<MAX_CRIT_LEVELS; m++){
+         task->levelWcet[m] = task->levelWcet[count-1];
+     }
+     task->wcet = task->levelWcet[task->critLevel];
+     return 1;
+ }
+ 
+ static double taskDeadlineInMode(int tIndex, int mode)
+ {
+     /* Relative deadline EDF-VD uses at system level 'mode' */
+     if(tasks[tIndex].critLevel > mode){
+         return tasks[tIndex].deadline * g_scaling[mode];
+     }
+     return tasks[tIndex].deadline;
+ }
+ 
+ static void setSystemMode(int mode, double now)
+ {
+     /* Released jobs below the new level are dropped; the others switch to
+      * the virtual deadlines of the new level. */
+     printf("DEBUG: system criticality level %d -> %d at time=%.2f\n", g_mode, mode, now);
+     if(mode > g_mode) g_numModeSwitches++;
+     g_mode = mode;
+ 
+     for(int i=0; i<g_numJobs; i++){
+         if(jobs[i].finished || jobs[i].dropped) continue;
+         int t = jobs[i].taskIndex;
+         if(tasks[t].critLevel < mode){
+             if(jobs[i].arrivalTime <= now) jobs[i].dropped = 1;
+             continue;
+         }
+         jobs[i].virtualDeadline = jobs[i].arrivalTime + taskDeadlineInMode(t, mode);
+     }
+ }
+ 
+ static double budgetExhaustionTime(int jobIndex, double now)
+ {
+     /* When the job would use up its budget at the current level and raise
+      * the system level, or HUGE_VAL if it completes within it. */
+     int t = jobs[jobIndex].taskIndex;
+     double budget = tasks[t].levelWcet[g_mode];
+     if(tasks[t].critLevel <= g_mode || jobs[jobIndex].actualExecTime <= budget + 1e-9){
+         return HUGE_VAL;
+     }
+     double executed = jobs[jobIndex].actualExecTime - jobs[jobIndex].remainingTime;
+     return now + (budget - executed);
+ }
+ 
+ static void checkBudgetOverrun(int jobIndex, double now)
+ {
+     /* Raise the system level past every budget the job has used up; equal
+      * budgets on consecutive levels make one overrun skip several. */
+     int t = jobs[jobIndex].taskIndex;
+     double executed = jobs[jobIndex].actualExecTime - jobs[jobIndex].remainingTime;
+     int mode = g_mode;
+     while(mode < tasks[t].critLevel &&
+           executed >= tasks[t].levelWcet[mode] - 1e-9 &&
+           jobs[jobIndex].actualExecTime > tasks[t].levelWcet[mode] + 1e-9)
+     {
+         mode++;
+     }
+     if(mode != g_mode){
+         setSystemMode(mode, now);
+     }
+ }
@@ -28,15 +28,44 @@
 */
 #define INCLUDE_vTaskDelay                1
 #define INCLUDE_vTaskPrioritySet          1
+#define INCLUDE_xTaskGetSchedulerState    1  /* Needed by the deferred logging backend. */
+#define INCLUDE_eTaskGetState             1  /* Needed by the EDF slack reclamation. */
 /* (Other API inclusion macros can be added here as needed.) */
 
+/* Run time stats, used by the EDF slack reclamation to measure how long a
+   task ran on slack. The Posix port counts process CPU time in 10 ms steps,
+   too coarse for these jobs, so a microsecond clock from posix_events.c is
+   used instead. */
+#define configGENERATE_RUN_TIME_STATS       1
+#define configUSE_TRACE_FACILITY            1  /* Needed by vTaskGetInfo(). */
+#define EDF_RUN_TIME_COUNTER_HZ             1000000UL
+unsigned long ulGetRunTimeCounterValue(void);
+#define portALT_GET_RUN_TIME_COUNTER_VALUE(ulCountValue) \
+    ((ulCountValue) = ulGetRunTimeCounterValue())
+
 /* Application-specific definitions */
 #define TEMP_TASK_PERIOD_MS                 500U
 #define PRESSURE_TASK_PERIOD_MS             1000U
 #define HEIGHT_TASK_PERIOD_MS               2000U
 
+/* Level-0 budgets of the temperature and pressure jobs, as in edfvd/tasks.txt.
+   What a job leaves unused is donated as slack to the height task (see
+   vDonateSlackEDF()), and a job that overruns raises the system level. */
+#define TEMP_TASK_BUDGET_MS                 50U
+#define PRESSURE_TASK_BUDGET_MS             100U
+
 #define TEMP_TASK_PRIORITY                  1
 #define PRESSURE_TASK_PRIORITY              1
 #define HEIGHT_TASK_PRIORITY                1
 
+/* The logger task formats and prints the messages the tasks above record, so
+   it runs below all of them. */
+#define LOGGER_TASK_PRIORITY                tskIDLE_PRIORITY
+#define LOGGER_TASK_STACK_SIZE              ( configMINIMAL_STACK_SIZE * 4U )
+
+/* Set to 1 to measure the time a task spends in printf() compared to the
+   deferred logging backend, instead of running the sensor tasks. */
+#define LOGGING_BENCHMARK_ENABLED           0
+#define LOGGING_BENCHMARK_ITERATIONS        200U
+
 #endif /* FREERTOS_CONFIG_H */
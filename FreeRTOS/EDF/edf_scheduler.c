@@ -6,21 +6,107 @@ typedef struct
 {
     TaskHandle_t xHandle;
     TickType_t   xPeriod;
+    TickType_t   xRelease;         /* release of its current or next job */
     TickType_t   xNextDeadline;
+    TickType_t   xModeDeadline[EDF_MAX_LEVELS]; /* relative deadline at each system level */
+    BaseType_t   xSlackConsumer;   /* pdTRUE if it may run on donated slack */
+    configRUN_TIME_COUNTER_TYPE ulSlack; /* run time donated by its last early job */
+    TickType_t   xSlackDeadline;   /* deadline of that job, when the slack expires */
 } EDFTask_t;
 
 /* Adjust if you have more tasks; for this assignment, we have 3. */
 #define NUM_EDF_TASKS (3)
 
+/* Run-time counter units per tick, the units slack is kept in. */
+#define EDF_RUN_TIME_PER_TICK (EDF_RUN_TIME_COUNTER_HZ / configTICK_RATE_HZ)
+
 static EDFTask_t xTasksEDF[NUM_EDF_TASKS];
 
+/* The system level, whose deadlines the tasks are scheduled by. */
+static int systemLevel = 0;
+
+/* The consumer last run on slack, the task whose slack it used, and its run
+ * time counter when it was picked, or -1 if none. */
+static int slackConsumerIndex = -1;
+static int slackDonorIndex    = -1;
+static configRUN_TIME_COUNTER_TYPE ulConsumerRunTime = 0;
+
+static configRUN_TIME_COUNTER_TYPE ulGetTaskRunTimeEDF(int index)
+{
+    TaskStatus_t xStatus;
+
+    /* Skip the stack high water mark and the state, which are not needed. */
+    vTaskGetInfo(xTasksEDF[index].xHandle, &xStatus, pdFALSE, eInvalid);
+    return xStatus.ulRunTimeCounter;
+}
+
 void vRegisterTaskEDF(TaskHandle_t handle, TickType_t period, int index)
 {
     if(index < NUM_EDF_TASKS)
     {
         xTasksEDF[index].xHandle       = handle;
         xTasksEDF[index].xPeriod       = period;
-        xTasksEDF[index].xNextDeadline = xTaskGetTickCount() + period;
+        xTasksEDF[index].xRelease      = xTaskGetTickCount();
+        xTasksEDF[index].xNextDeadline = xTasksEDF[index].xRelease + period;
+        for(int m = 0; m < EDF_MAX_LEVELS; m++)
+        {
+            xTasksEDF[index].xModeDeadline[m] = period;
+        }
+        xTasksEDF[index].xSlackConsumer = pdFALSE;
+        xTasksEDF[index].ulSlack        = 0;
+    }
+}
+
+void vSetTaskDeadlinesEDF(int index, const TickType_t *pxModeDeadlines, int numLevels)
+{
+    if(index < NUM_EDF_TASKS && numLevels > 0)
+    {
+        /* Levels above the last given one keep its deadline. */
+        taskENTER_CRITICAL();
+        for(int m = 0; m < EDF_MAX_LEVELS; m++)
+        {
+            xTasksEDF[index].xModeDeadline[m] = pxModeDeadlines[(m < numLevels) ? m : numLevels - 1];
+        }
+        xTasksEDF[index].xNextDeadline = xTasksEDF[index].xRelease +
+                                         xTasksEDF[index].xModeDeadline[systemLevel];
+        taskEXIT_CRITICAL();
+    }
+}
+
+void vSetSystemLevelEDF(int level)
+{
+    if(level >= 0 && level < EDF_MAX_LEVELS)
+    {
+        /* Released jobs switch to the deadlines of the new level, as in
+         * setSystemMode() of edfvd/edfvdsim.c. */
+        taskENTER_CRITICAL();
+        systemLevel = level;
+        for(int i = 0; i < NUM_EDF_TASKS; i++)
+        {
+            xTasksEDF[i].xNextDeadline = xTasksEDF[i].xRelease + xTasksEDF[i].xModeDeadline[level];
+        }
+        taskEXIT_CRITICAL();
+    }
+}
+
+void vSetSlackConsumerEDF(int index, BaseType_t consumer)
+{
+    if(index < NUM_EDF_TASKS)
+    {
+        xTasksEDF[index].xSlackConsumer = consumer;
+    }
+}
+
+void vDonateSlackEDF(int index, TickType_t unusedTicks)
+{
+    if(index < NUM_EDF_TASKS)
+    {
+        /* Called before the deadline is pushed, so the slack expires at the
+         * deadline of the job that left it. */
+        taskENTER_CRITICAL();
+        xTasksEDF[index].ulSlack        = (configRUN_TIME_COUNTER_TYPE)unusedTicks * EDF_RUN_TIME_PER_TICK;
+        xTasksEDF[index].xSlackDeadline = xTasksEDF[index].xNextDeadline;
+        taskEXIT_CRITICAL();
     }
 }
 
@@ -29,7 +115,11 @@ void vUpdateTaskDeadline(int index)
     if(index < NUM_EDF_TASKS)
     {
         /* Once a task finishes its job, push its next deadline by +period. */
-        xTasksEDF[index].xNextDeadline += xTasksEDF[index].xPeriod;
+        taskENTER_CRITICAL();
+        xTasksEDF[index].xRelease     += xTasksEDF[index].xPeriod;
+        xTasksEDF[index].xNextDeadline = xTasksEDF[index].xRelease +
+                                         xTasksEDF[index].xModeDeadline[systemLevel];
+        taskEXIT_CRITICAL();
     }
 }
 
@@ -43,6 +133,46 @@ static void vScheduleEDF(void *pvParameters)
 
     for(;;)
     {
+        /* 0. Debit the slack used since the last pass by the time its
+         *    consumer actually ran, which may be none if it blocked. This
+         *    task runs strictly above the consumer, so the consumer has been
+         *    switched out and its counter is up to date. */
+        if(slackConsumerIndex != -1)
+        {
+            configRUN_TIME_COUNTER_TYPE ulRan = ulGetTaskRunTimeEDF(slackConsumerIndex) - ulConsumerRunTime;
+
+            taskENTER_CRITICAL();
+            if(xTasksEDF[slackDonorIndex].ulSlack > ulRan)
+            {
+                xTasksEDF[slackDonorIndex].ulSlack -= ulRan;
+            }
+            else
+            {
+                xTasksEDF[slackDonorIndex].ulSlack = 0;
+            }
+            taskEXIT_CRITICAL();
+
+            slackConsumerIndex = -1;
+        }
+
+        /* The system returns to level 0 once every task waits for its next
+         * release, the idle instant at which EDF-VD resets its level. */
+        if(systemLevel > 0)
+        {
+            BaseType_t xAllBlocked = pdTRUE;
+            for(int i = 0; i < NUM_EDF_TASKS; i++)
+            {
+                if(eTaskGetState(xTasksEDF[i].xHandle) != eBlocked)
+                {
+                    xAllBlocked = pdFALSE;
+                }
+            }
+            if(xAllBlocked == pdTRUE)
+            {
+                vSetSystemLevelEDF(0);
+            }
+        }
+
         TickType_t earliestDeadline = (TickType_t)-1; /* Largest possible. */
         int earliestIndex = -1;
 
@@ -56,15 +186,53 @@ static void vScheduleEDF(void *pvParameters)
             }
         }
 
-        /* 2. Set that task's priority to the highest, others to lower. */
+        /* 2. Slack reclamation: while slack with an earlier deadline is left,
+         *    the ready slack consumer with the earliest deadline runs at that
+         *    deadline instead. The slack is debited on the next pass. */
+        TickType_t xNow = xTaskGetTickCount();
+        int slackIndex = -1;
+        for(int i = 0; i < NUM_EDF_TASKS; i++)
+        {
+            if(xTasksEDF[i].ulSlack > 0 && xTasksEDF[i].xSlackDeadline > xNow &&
+               (slackIndex == -1 || xTasksEDF[i].xSlackDeadline < xTasksEDF[slackIndex].xSlackDeadline))
+            {
+                slackIndex = i;
+            }
+        }
+
+        if(slackIndex != -1 && xTasksEDF[slackIndex].xSlackDeadline < earliestDeadline)
+        {
+            int consumerIndex = -1;
+            for(int i = 0; i < NUM_EDF_TASKS; i++)
+            {
+                if(xTasksEDF[i].xSlackConsumer == pdTRUE &&
+                   eTaskGetState(xTasksEDF[i].xHandle) == eReady &&
+                   (consumerIndex == -1 || xTasksEDF[i].xNextDeadline < xTasksEDF[consumerIndex].xNextDeadline))
+                {
+                    consumerIndex = i;
+                }
+            }
+
+            if(consumerIndex != -1)
+            {
+                earliestIndex = consumerIndex;
+
+                slackConsumerIndex = consumerIndex;
+                slackDonorIndex    = slackIndex;
+                ulConsumerRunTime  = ulGetTaskRunTimeEDF(consumerIndex);
+            }
+        }
+
+        /* 3. Set that task's priority to the highest, others to lower. */
         if(earliestIndex != -1)
         {
             for(int i = 0; i < NUM_EDF_TASKS; i++)
             {
                 if(i == earliestIndex)
                 {
-                    /* Highest priority => (configMAX_PRIORITIES - 1). */
-                    vTaskPrioritySet(xTasksEDF[i].xHandle, configMAX_PRIORITIES - 1);
+                    /* Highest task priority => (configMAX_PRIORITIES - 2),
+                     * one below this task so it always preempts the task. */
+                    vTaskPrioritySet(xTasksEDF[i].xHandle, configMAX_PRIORITIES - 2);
                 }
                 else
                 {
@@ -74,14 +242,15 @@ static void vScheduleEDF(void *pvParameters)
             }
         }
 
-        /* 3. Sleep a bit, then do it again. */
+        /* 4. Sleep a bit, then do it again. */
         vTaskDelay(xSchedulerDelay);
     }
 }
 
 void vStartEDFScheduler(void)
 {
-    /* Create the EDF scheduler task itself with high priority. */
+    /* Create the EDF scheduler task itself with the highest priority, above
+     * the priority it gives the earliest-deadline task. */
     xTaskCreate(vScheduleEDF, 
                 "EDF_Sched", 
                 configMINIMAL_STACK_SIZE, 
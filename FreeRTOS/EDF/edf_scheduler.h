@@ -4,6 +4,9 @@
 #include "FreeRTOS.h"
 #include "task.h"
 
+/* Most criticality levels a task can have deadlines for. */
+#define EDF_MAX_LEVELS (8)
+
 /**
  * @brief Register a task with the EDF scheduler. 
  *        (Stores the period and calculates initial deadline.)
@@ -19,6 +22,43 @@ void vRegisterTaskEDF(TaskHandle_t handle, TickType_t period, int index);
  */
 void vUpdateTaskDeadline(int index);
 
+/**
+ * @brief Set the relative deadline of a task at each system level, such as the
+ *        EDFVD_<task>_MODE_DEADLINES written by edfvd/edfvdsim.c. Until this
+ *        is called, the deadline is the period at every level.
+ * @param index            The index of this task in the EDF array
+ * @param pxModeDeadlines  Relative deadline in ticks at levels 0, 1, ...
+ * @param numLevels        Number of entries. Higher levels use the last one.
+ */
+void vSetTaskDeadlinesEDF(int index, const TickType_t *pxModeDeadlines, int numLevels);
+
+/**
+ * @brief Raise the system level, e.g. when a job overruns its budget at the
+ *        current one. Released jobs move to the deadlines of that level. The
+ *        scheduler returns to level 0 once every task is blocked.
+ * @param level  The new level, below EDF_MAX_LEVELS.
+ */
+void vSetSystemLevelEDF(int level);
+
+/**
+ * @brief Let a task run on slack donated by other tasks (see vDonateSlackEDF).
+ *        Meant for LO-criticality tasks that would otherwise wait.
+ * @param index     The index of this task in the EDF array
+ * @param consumer  pdTRUE to let it use slack, pdFALSE otherwise.
+ */
+void vSetSlackConsumerEDF(int index, BaseType_t consumer);
+
+/**
+ * @brief Donate the unused part of a job's budget when it finishes early.
+ *        Until the deadline of that job, a ready slack consumer runs ahead of
+ *        later deadlines until it has run for that many ticks, as measured
+ *        by the run time stats clock. Call it before vUpdateTaskDeadline().
+ *        Matches SLACK_EARLY in edfvd/edfvdsim.c.
+ * @param index        The index of this task in the EDF array
+ * @param unusedTicks  The job's budget minus the ticks it ran.
+ */
+void vDonateSlackEDF(int index, TickType_t unusedTicks);
+
 /**
  * @brief Creates the EDF scheduler task which runs at high priority.
  */
@@ -0,0 +1,30 @@
+/* Generated by edfvdsim from the tasks file. Times are in its units.
+ * MODE_DEADLINES lists the relative deadline used at each system level,
+ * and is what FreeRTOS/EDF passes to vSetTaskDeadlinesEDF().
+ * LO_DEADLINE is the one used before a mode switch, DEADLINE the real one. */
+#ifndef EDFVD_DEADLINES_H
+#define EDFVD_DEADLINES_H
+
+#define EDFVD_TASK_COUNT    3
+#define EDFVD_NUM_LEVELS    2
+#define EDFVD_VD_TUNED      1
+
+#define EDFVD_TEMP_CRIT_LEVEL     1
+#define EDFVD_TEMP_PERIOD         500
+#define EDFVD_TEMP_DEADLINE       400
+#define EDFVD_TEMP_LO_DEADLINE    150
+#define EDFVD_TEMP_MODE_DEADLINES { 150, 400 }
+
+#define EDFVD_PRESSURE_CRIT_LEVEL     1
+#define EDFVD_PRESSURE_PERIOD         1000
+#define EDFVD_PRESSURE_DEADLINE       1000
+#define EDFVD_PRESSURE_LO_DEADLINE    500
+#define EDFVD_PRESSURE_MODE_DEADLINES { 500, 1000 }
+
+#define EDFVD_HEIGHT_CRIT_LEVEL     0
+#define EDFVD_HEIGHT_PERIOD         2000
+#define EDFVD_HEIGHT_DEADLINE       2000
+#define EDFVD_HEIGHT_LO_DEADLINE    2000
+#define EDFVD_HEIGHT_MODE_DEADLINES { 2000, 2000 }
+
+#endif /* EDFVD_DEADLINES_H */
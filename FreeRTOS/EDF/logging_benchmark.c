@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "logging_deferred.h"
+#include "logging_benchmark.h"
+
+/* Latency statistics of one logging method, in nanoseconds. */
+typedef struct
+{
+    uint64_t ullMin;
+    uint64_t ullMax;
+    uint64_t ullTotal;
+} LatencyStats_t;
+
+/* This demo only runs on the POSIX port, so the host clock is available. */
+static uint64_t ullNowNs(void)
+{
+    struct timespec xNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &xNow);
+    return ((uint64_t)xNow.tv_sec * 1000000000ULL) + (uint64_t)xNow.tv_nsec;
+}
+
+static void vRecordLatency(LatencyStats_t *pxStats, uint64_t ullLatency)
+{
+    if(ullLatency < pxStats->ullMin)
+    {
+        pxStats->ullMin = ullLatency;
+    }
+
+    if(ullLatency > pxStats->ullMax)
+    {
+        pxStats->ullMax = ullLatency;
+    }
+
+    pxStats->ullTotal += ullLatency;
+}
+
+static void vLoggingBenchmarkTask(void *pvParameters)
+{
+    LatencyStats_t xPrintf   = { UINT64_MAX, 0U, 0U };
+    LatencyStats_t xDeferred = { UINT64_MAX, 0U, 0U };
+    uint32_t ulDroppedBefore;
+    uint64_t ullStart;
+    uint32_t i;
+
+    (void)pvParameters;
+
+    /* The same message as the sensor tasks log, printed synchronously. */
+    for(i = 0U; i < LOGGING_BENCHMARK_ITERATIONS; i++)
+    {
+        ullStart = ullNowNs();
+        printf("[TempTask]  Temp: %ld, TickTime: %lu\n",
+               (long)i, (unsigned long)xTaskGetTickCount());
+        vRecordLatency(&xPrintf, ullNowNs() - ullStart);
+
+        vTaskDelay(1);
+    }
+
+    /* The same message recorded for the logger task. The delay lets the
+       logger task drain the ring, as it would between periodic jobs. */
+    ulDroppedBefore = ulLoggingDeferredGetDroppedCount();
+
+    for(i = 0U; i < LOGGING_BENCHMARK_ITERATIONS; i++)
+    {
+        ullStart = ullNowNs();
+        vLoggingDeferredPrintf("[TempTask]  Temp: %ld, TickTime: %lu\n",
+                               (long)i, (unsigned long)xTaskGetTickCount());
+        vRecordLatency(&xDeferred, ullNowNs() - ullStart);
+
+        vTaskDelay(1);
+    }
+
+    vLoggingDeferredPrintf("Logging latency over %lu calls (ns): "
+                           "printf min %lu avg %lu max %lu, "
+                           "deferred min %lu avg %lu max %lu, %lu dropped\n",
+                           (unsigned long)LOGGING_BENCHMARK_ITERATIONS,
+                           (unsigned long)xPrintf.ullMin,
+                           (unsigned long)(xPrintf.ullTotal / LOGGING_BENCHMARK_ITERATIONS),
+                           (unsigned long)xPrintf.ullMax,
+                           (unsigned long)xDeferred.ullMin,
+                           (unsigned long)(xDeferred.ullTotal / LOGGING_BENCHMARK_ITERATIONS),
+                           (unsigned long)xDeferred.ullMax,
+                           (unsigned long)(ulLoggingDeferredGetDroppedCount() - ulDroppedBefore));
+
+    /* Done; stay out of the way of the logger task. */
+    for(;;)
+    {
+        vTaskDelay(portMAX_DELAY);
+    }
+}
+
+void vStartLoggingBenchmark(UBaseType_t priority)
+{
+    xTaskCreate(vLoggingBenchmarkTask,
+                "LogBench",
+                configMINIMAL_STACK_SIZE * 4U,
+                NULL,
+                priority,
+                NULL);
+}
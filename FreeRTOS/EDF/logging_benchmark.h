@@ -0,0 +1,16 @@
+#ifndef LOGGING_BENCHMARK_H
+#define LOGGING_BENCHMARK_H
+
+#include "FreeRTOS.h"
+
+/**
+ * @brief Creates a task that measures how long a task is held up by a log
+ *        call, first with printf() and then with the deferred logging
+ *        backend, and prints the min/avg/max latency of both.
+ * @param priority  Priority of the benchmark task. It should be above the
+ *                  logger task so that the latency of the deferred backend
+ *                  does not include any formatting.
+ */
+void vStartLoggingBenchmark(UBaseType_t priority);
+
+#endif /* LOGGING_BENCHMARK_H */
@@ -4,6 +4,9 @@
 #include "custom_apis.h"
 #include "FreeRTOSConfig.h"
 #include "edf_scheduler.h"  /* For EDF scheduling (Task 3) */
+#include "edfvd_deadlines.h" /* Deadlines tuned by edfvd/edfvdsim.c from edfvd/tasks.txt */
+#include "logging_deferred.h"
+#include "logging_benchmark.h"
 
 /* Forward declarations of the 3 tasks */
 static void vTemperatureTask(void *pvParameters);
@@ -20,10 +23,29 @@ TaskHandle_t heightTaskHandle   = NULL;
 #define PRESSURE_TASK_INDEX 1
 #define HEIGHT_TASK_INDEX   2
 
+/* edfvd/tasks.txt describes these tasks in milliseconds. Rerun edfvdsim in
+ * edfvd/ after changing either. */
+#if (EDFVD_TEMP_PERIOD != TEMP_TASK_PERIOD_MS) || \
+    (EDFVD_PRESSURE_PERIOD != PRESSURE_TASK_PERIOD_MS) || \
+    (EDFVD_HEIGHT_PERIOD != HEIGHT_TASK_PERIOD_MS)
+#error "edfvd/tasks.txt does not match the task periods in FreeRTOSConfig.h"
+#endif
+
+static void vSetDeadlinesMs(int index, const double *deadlinesMs);
+
 int main(void)
 {
     printf("Starting FreeRTOS tasks with EDF scheduling...\n");
 
+    /* The tasks only record their messages; this task prints them. */
+    xLoggingDeferredInit(LOGGER_TASK_PRIORITY, LOGGER_TASK_STACK_SIZE);
+
+#if (LOGGING_BENCHMARK_ENABLED == 1)
+    vStartLoggingBenchmark(TEMP_TASK_PRIORITY);
+    vTaskStartScheduler();
+    for(;;);
+#endif
+
     /* Create Temperature Task */
     xTaskCreate(vTemperatureTask,
                 "TempTask",
@@ -58,6 +80,17 @@ int main(void)
     vRegisterTaskEDF(pressureTaskHandle, pressurePeriodTicks, PRESSURE_TASK_INDEX);
     vRegisterTaskEDF(heightTaskHandle,   heightPeriodTicks,   HEIGHT_TASK_INDEX);
 
+    /* Schedule them by the virtual deadlines edfvdsim tuned for each level. */
+    static const double tempDeadlinesMs[EDFVD_NUM_LEVELS]     = EDFVD_TEMP_MODE_DEADLINES;
+    static const double pressureDeadlinesMs[EDFVD_NUM_LEVELS] = EDFVD_PRESSURE_MODE_DEADLINES;
+    static const double heightDeadlinesMs[EDFVD_NUM_LEVELS]   = EDFVD_HEIGHT_MODE_DEADLINES;
+    vSetDeadlinesMs(TEMP_TASK_INDEX,     tempDeadlinesMs);
+    vSetDeadlinesMs(PRESSURE_TASK_INDEX, pressureDeadlinesMs);
+    vSetDeadlinesMs(HEIGHT_TASK_INDEX,   heightDeadlinesMs);
+
+    /* The height task may run early on slack left by the other two. */
+    vSetSlackConsumerEDF(HEIGHT_TASK_INDEX, pdTRUE);
+
     /* Start the EDF scheduler (creates a high-priority scheduling task). */
     vStartEDFScheduler();
 
@@ -69,24 +102,53 @@ int main(void)
     return 0;
 }
 
+/**
+ * @brief Pass the per-level deadlines of a task, in milliseconds, to the EDF
+ *        scheduler. Rounding down to whole ticks only makes them stricter.
+ */
+static void vSetDeadlinesMs(int index, const double *deadlinesMs)
+{
+    TickType_t deadlines[EDFVD_NUM_LEVELS];
+
+    for(int m = 0; m < EDFVD_NUM_LEVELS; m++)
+    {
+        deadlines[m] = pdMS_TO_TICKS((TickType_t)deadlinesMs[m]);
+    }
+    vSetTaskDeadlinesEDF(index, deadlines, EDFVD_NUM_LEVELS);
+}
+
 /*-----------------------------------------------------------
  * Task Definitions
  *-----------------------------------------------------------*/
 
 /**
- * @brief Periodically reads a random temperature value and prints to console.
- *        Also updates its EDF deadline at the end of each iteration.
+ * @brief Periodically reads a random temperature value and logs it.
+ *        Also donates what is left of its budget as slack and updates its
+ *        EDF deadline at the end of each iteration.
  */
 static void vTemperatureTask(void *pvParameters)
 {
     (void) pvParameters;
-    const TickType_t xDelay = pdMS_TO_TICKS(TEMP_TASK_PERIOD_MS);
+    const TickType_t xDelay  = pdMS_TO_TICKS(TEMP_TASK_PERIOD_MS);
+    const TickType_t xBudget = pdMS_TO_TICKS(TEMP_TASK_BUDGET_MS);
 
     for(;;)
     {
+        TickType_t xJobStart = xTaskGetTickCount();
+
         int32_t temp = getTemperature();
-        printf("[TempTask]  Temp: %ld, TickTime: %lu\n",
-               (long)temp, (unsigned long)xTaskGetTickCount());
+        vLoggingDeferredPrintf("[TempTask]  Temp: %ld, TickTime: %lu\n",
+                               (long)temp, (unsigned long)xTaskGetTickCount());
+
+        /* Ticks since the job started are an upper bound on its run time. */
+        TickType_t xRan = xTaskGetTickCount() - xJobStart;
+        vDonateSlackEDF(TEMP_TASK_INDEX, (xRan < xBudget) ? (xBudget - xRan) : 0);
+
+        /* A job past its level-0 budget moves the system to its level. */
+        if(xRan > xBudget)
+        {
+            vSetSystemLevelEDF(EDFVD_TEMP_CRIT_LEVEL);
+        }
 
         /* Mark that we've completed one job, so push our deadline. */
         vUpdateTaskDeadline(TEMP_TASK_INDEX);
@@ -97,19 +159,31 @@ static void vTemperatureTask(void *pvParameters)
 }
 
 /**
- * @brief Periodically reads a random pressure value and prints to console.
- *        Also updates its EDF deadline at the end of each iteration.
+ * @brief Periodically reads a random pressure value and logs it.
+ *        Also donates what is left of its budget as slack and updates its
+ *        EDF deadline at the end of each iteration.
  */
 static void vPressureTask(void *pvParameters)
 {
     (void) pvParameters;
-    const TickType_t xDelay = pdMS_TO_TICKS(PRESSURE_TASK_PERIOD_MS);
+    const TickType_t xDelay  = pdMS_TO_TICKS(PRESSURE_TASK_PERIOD_MS);
+    const TickType_t xBudget = pdMS_TO_TICKS(PRESSURE_TASK_BUDGET_MS);
 
     for(;;)
     {
+        TickType_t xJobStart = xTaskGetTickCount();
+
         int32_t pressure = getPressure();
-        printf("[PressureTask]  Pressure: %ld, TickTime: %lu\n",
-               (long)pressure, (unsigned long)xTaskGetTickCount());
+        vLoggingDeferredPrintf("[PressureTask]  Pressure: %ld, TickTime: %lu\n",
+                               (long)pressure, (unsigned long)xTaskGetTickCount());
+
+        TickType_t xRan = xTaskGetTickCount() - xJobStart;
+        vDonateSlackEDF(PRESSURE_TASK_INDEX, (xRan < xBudget) ? (xBudget - xRan) : 0);
+
+        if(xRan > xBudget)
+        {
+            vSetSystemLevelEDF(EDFVD_PRESSURE_CRIT_LEVEL);
+        }
 
         vUpdateTaskDeadline(PRESSURE_TASK_INDEX);
 
@@ -118,8 +192,9 @@ static void vPressureTask(void *pvParameters)
 }
 
 /**
- * @brief Periodically reads a random height value and prints to console.
- *        Also updates its EDF deadline at the end of each iteration.
+ * @brief Periodically reads a random height value and logs it.
+ *        Also updates its EDF deadline at the end of each iteration. It is
+ *        the slack consumer, so it may run ahead of earlier deadlines.
  */
 static void vHeightTask(void *pvParameters)
 {
@@ -129,8 +204,8 @@ static void vHeightTask(void *pvParameters)
     for(;;)
     {
         int32_t height = getHeight();
-        printf("[HeightTask]  Height: %ld, TickTime: %lu\n",
-               (long)height, (unsigned long)xTaskGetTickCount());
+        vLoggingDeferredPrintf("[HeightTask]  Height: %ld, TickTime: %lu\n",
+                               (long)height, (unsigned long)xTaskGetTickCount());
 
         vUpdateTaskDeadline(HEIGHT_TASK_INDEX);
 
@@ -4,6 +4,7 @@
 */
 #include <pthread.h>
 #include <stdlib.h>
+#include <time.h>
 
 /* Define a structure to hold an event (a condition variable and its mutex). */
 typedef struct EventStruct {
@@ -58,3 +59,12 @@ int event_signal(void* ev)
     pthread_mutex_unlock(&e->mutex);
     return ret;
 }
+
+/* Run time stats clock, in microseconds (see FreeRTOSConfig.h). It is free
+   running and wraps, which the kernel allows for. */
+unsigned long ulGetRunTimeCounterValue(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long)ts.tv_sec * 1000000UL + (unsigned long)(ts.tv_nsec / 1000);
+}
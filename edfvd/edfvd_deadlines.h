@@ -0,0 +1,30 @@
+/* Generated by edfvdsim from the tasks file. Times are in its units.
+ * MODE_DEADLINES lists the relative deadline used at each system level,
+ * and is what FreeRTOS/EDF passes to vSetTaskDeadlinesEDF().
+ * LO_DEADLINE is the one used before a mode switch, DEADLINE the real one. */
+#ifndef EDFVD_DEADLINES_H
+#define EDFVD_DEADLINES_H
+
+#define EDFVD_TASK_COUNT    3
+#define EDFVD_NUM_LEVELS    2
+#define EDFVD_VD_TUNED      1
+
+#define EDFVD_T1_CRIT_LEVEL     1
+#define EDFVD_T1_PERIOD         10
+#define EDFVD_T1_DEADLINE       10
+#define EDFVD_T1_LO_DEADLINE    10
+#define EDFVD_T1_MODE_DEADLINES { 10, 10 }
+
+#define EDFVD_T2_CRIT_LEVEL     0
+#define EDFVD_T2_PERIOD         10
+#define EDFVD_T2_DEADLINE       10
+#define EDFVD_T2_LO_DEADLINE    10
+#define EDFVD_T2_MODE_DEADLINES { 10, 10 }
+
+#define EDFVD_T3_CRIT_LEVEL     1
+#define EDFVD_T3_PERIOD         20
+#define EDFVD_T3_DEADLINE       20
+#define EDFVD_T3_LO_DEADLINE    17
+#define EDFVD_T3_MODE_DEADLINES { 17, 20 }
+
+#endif /* EDFVD_DEADLINES_H */
@@ -5,20 +5,59 @@
  *   1) A "tasks file" with N tasks:
  *      - # of tasks in the first line
  *      - Each subsequent line: taskName phase period wcet deadline critLevel
+ *      - critLevel is L or H for two levels, a level number 0..K-1 (0 is the
+ *        least critical), or a DAL letter A..E (E is level 0, A is level 4)
+ *      - wcet is one value used at every level, or a comma separated list of
+ *        the budgets at levels 0, 1, ... up to critLevel (e.g. 2,3.5); a short
+ *        list repeats its last value
  *
  *   2) An "execution times file" that provides the actual exec times for each
  *      job of each task over the hyperperiod. The format could be something like:
  *        For each task, a line containing M actual execution times
  *        (M = number of job instances in the hyperperiod).
  *
- * Schedules from t=0 to t=hyperperiod using EDF-VD:
- *   - High-critical tasks have their deadlines scaled by x < 1
- *   - Low-critical tasks keep their deadlines
- *   - Only re-schedule at "decision points": arrivals or completions
+ *   3) An optional "overheads file" with the scheduling overheads, one per
+ *      line, in the time units of the tasks file ('#' starts a comment):
+ *        release 0.01       (per job release)
+ *        dispatch 0.02      (per dispatch: scheduler and context switch)
+ *        preemption 0.01    (per preemption, on top of the dispatch)
+ *        cpmd T1 0.05       (cache-related preemption delay of task T1)
+ *      A line "ns_per_unit 1000000" makes every value a time in nanoseconds,
+ *      so kernel benchmark results can be copied in as measured.
+ *
+ *   4) An optional "preemption file" that limits when tasks can be preempted:
+ *        npr T3 1.5         (a job of T3 asked to yield runs 1.5 more first)
+ *        points T3 1,2.5,4  (T3 can only be preempted after executing 1, 2.5
+ *                            or 4 time units, or when it completes)
+ *        threshold T3 5     (only jobs with a relative deadline below 5 can
+ *                            preempt T3, taking the virtual deadline of a HI
+ *                            job in LO mode; 0 makes it non-preemptive)
+ *
+ * Schedules from t=0 to t=hyperperiod using EDF-VD with K criticality levels:
+ *   - At system level m, tasks above m have their deadlines scaled by x[m] <= 1
+ *   - Tasks at level m keep their deadlines, tasks below m are dropped
+ *   - A job that runs past its budget for level m raises the system level,
+ *     which returns to 0 at the next idle instant
+ *   - Only re-schedule at "decision points": arrivals, completions or budget
+ *     exhaustion
+ *   - Overheads are charged to jobs as execution time, and every budget is
+ *     inflated by the worst case a job can be charged, so the EDF-VD test and
+ *     the budget checks account for them too
+ *   - Instead of being dropped, jobs below the system level can be served by
+ *     slack reclamation (see SLACK_POLICY): on budget left by jobs that
+ *     finished early, in idle time, or at stretched periods when the HI-mode
+ *     test has room for them
+ *   - A job that EDF-VD would preempt keeps running until its non-preemptive
+ *     region ends or it reaches a preemption point, and the demand-bound
+ *     search adds the resulting blocking to its test
+ *   - With two levels, the level-0 virtual deadline of each HI task is tuned
+ *     separately by a demand-bound-function search when the parameters are
+ *     integers, falling back to the uniform x if the search fails
  *
  * Outputs:
  *   1) schedule_output.txt   (the timeline of which job runs when)
  *   2) schedule_analysis.txt (preemptions, wait times, etc.)
+ *   3) edfvd_deadlines.h     (the deadlines used, for the kernel build)
  *
  * This is a reference skeleton. You may tailor naming, input format,
  * error checking, etc. to your exact assignment.
@@ -28,17 +67,23 @@
  #include <stdlib.h>
  #include <string.h>
  #include <math.h>
+ #include <ctype.h>
+ #include <time.h>
  
  /*-----------------------------------------------------------
   * Data Structures
   *-----------------------------------------------------------*/
  
- /* For a two-criticality system (High/Low). Adjust if needed. */
+ /* Criticality levels run from 0 (least critical) to g_numLevels-1. The
+  * two-level names are what 'L' and 'H' in the tasks file map to. */
  typedef enum {
      CRIT_LOW = 0,
      CRIT_HIGH
  } CritLevel_t;
  
+ #define MAX_CRIT_LEVELS 8
+ #define MAX_PREEMPTION_POINTS 16
+ 
  /* Info about each *Task*, read from the tasks file. */
  typedef struct {
      char         name[32];
@@ -46,8 +91,15 @@
      double       period;
      double       wcet;       /* worst-case execution time */
      double       deadline;
-     CritLevel_t  critLevel;
-     double       virtualDeadline; /* computed for EDF-VD */
+     int          critLevel;  /* 0..g_numLevels-1, see CritLevel_t */
+     double       levelWcet[MAX_CRIT_LEVELS]; /* budget at each system level up to critLevel */
+     double       virtualDeadline; /* computed for EDF-VD, at system level 0 */
+     double       modeDeadline[MAX_CRIT_LEVELS]; /* relative deadline used at each system level */
+     double       cpmd;       /* cache-related preemption delay when resuming after a preemption */
+     double       nprLength;  /* floating non-preemptive region, 0 if fully preemptive */
+     double       preemptionPoints[MAX_PREEMPTION_POINTS]; /* execution offsets where it can be preempted */
+     int          numPreemptionPoints; /* 0 if it can be preempted anywhere */
+     double       preemptionThreshold; /* only tasks with shorter relative deadlines preempt it */
      int          jobCount;   /* number of jobs in hyperperiod (filled later) */
  } TaskInfo_t;
  
@@ -61,9 +113,14 @@
      double  wcet;            /* worst-case. Not always used if we have actual exec times */
      double  actualExecTime;  /* from the second file, for this job iteration */
      double  remainingTime;   /* changes as the job executes */
+     double  overheadTime;    /* scheduling overhead charged to this job */
+     double  nprEnd;          /* end of its running non-preemptive region, or -1 */
      double  startTime;       /* when job first starts (for analysis) */
      double  finishTime;      /* when job completes (for analysis) */
      int     finished;        /* boolean: 1 if completed, 0 if not */
+     int     dropped;         /* boolean: 1 if discarded by a mode switch */
+     int     degraded;        /* boolean: 1 if kept above its level, runs only on slack */
+     int     elastic;         /* boolean: 1 if released above its level at a stretched period */
  } Job_t;
  
  /* For analyzing the schedule. We track each scheduling interval or "run slice." */
@@ -74,6 +131,19 @@
      int    jobId;
  } ScheduleSlice_t;
  
+ /* Scheduling overheads, in the time units of the tasks file. */
+ typedef struct {
+     double release;    /* releasing a job (timer interrupt, ready queue insert) */
+     double dispatch;   /* running the scheduler and switching to the chosen job */
+     double preemption; /* saving the context of the preempted job */
+ } Overheads_t;
+ 
+ /* Budget left by a job that finished early, usable until its deadline. */
+ typedef struct {
+     double amount;
+     double deadline;
+ } Slack_t;
+ 
  /*-----------------------------------------------------------
   * Global / Config
   *-----------------------------------------------------------*/
@@ -81,6 +151,22 @@
  #define MAX_JOBS  5000  /* depends on how large the hyperperiod is */
  #define MAX_SLICES 10000
  
+ /* How jobs released while the system is above their level are served.
+  * Plain EDF-VD drops them; each policy below keeps them without touching
+  * the guarantees of the other jobs. */
+ #define SLACK_DROP    0  /* drop them */
+ #define SLACK_IDLE    1  /* run them when no guaranteed job is ready */
+ #define SLACK_EARLY   2  /* run them on budget left by jobs that finished early */
+ #define SLACK_ELASTIC 4  /* guarantee new LO jobs at stretched periods if the test allows */
+ #define SLACK_POLICY  (SLACK_IDLE | SLACK_EARLY | SLACK_ELASTIC)
+ #define MAX_SLACK     64
+ #define BACKGROUND_PRIORITY 1e12 /* added to deadlines to queue jobs after every guaranteed one */
+ 
+ /* Limits of the per-task virtual-deadline search. */
+ #define VD_SEARCH_TIME_LIMIT_MS 1000     /* gives up and keeps the uniform x after this */
+ #define VD_SEARCH_MAX_HORIZON   1000000  /* longest demand-bound test interval */
+ #define ELASTIC_MAX_STRETCH     16       /* largest LO period factor tried with tuned deadlines */
+ 
  static TaskInfo_t tasks[MAX_TASKS];
  static Job_t      jobs[MAX_JOBS];
  static ScheduleSlice_t slices[MAX_SLICES];
@@ -89,21 +175,76 @@
  static int g_numJobs  = 0;
  static int g_numSlices = 0;
  
+ /* Number of criticality levels and the EDF-VD scaling factor of each. */
+ static int    g_numLevels = 1;
+ static double g_scaling[MAX_CRIT_LEVELS];
+ 
+ /* Current system criticality level, and how often it was raised. */
+ static int    g_mode = 0;
+ static int    g_numModeSwitches = 0;
+ 
+ /* Set when the level-0 virtual deadlines come from the per-task search. */
+ static int    g_vdTuned = 0;
+ 
+ /* Scheduling overheads, and the most that can be charged to one job. */
+ static Overheads_t g_overheads = { 0.0, 0.0, 0.0 };
+ static double g_jobOverheadBound = 0.0;
+ 
+ /* Set when any task limits its preemptions, and the time EDF-VD's choice
+  * waited for a running job because of it. */
+ static int    g_limitedPreemption = 0;
+ static double g_blockingTime = 0.0;
+ 
+ /* Slack reclamation state, and how much LO jobs got out of it. */
+ static int     g_slackPolicy = SLACK_POLICY;
+ static Slack_t g_slack[MAX_SLACK];
+ static int     g_numSlack = 0;
+ static double  g_elasticStretch = HUGE_VAL; /* LO period factor in HI mode, HUGE_VAL if none fits */
+ static double  g_elasticNext[MAX_TASKS];    /* earliest arrival of the next elastic job */
+ static double  g_slackTimeUsed = 0.0;
+ static double  g_backgroundTimeUsed = 0.0;
+ static int     g_loServedBaseline = -1;     /* LO jobs served without reclamation, -1 if not run */
+ 
  /*-----------------------------------------------------------
   * Function Prototypes
   *-----------------------------------------------------------*/
  void parseTaskFile(const char* filename);
  void computeHyperPeriodAndJobCounts(double* hyperPeriod);
+ void parseOverheadsFile(const char* filename);
+ void parsePreemptionFile(const char* filename);
  void computeEDFVDParameters();
+ int  tuneVirtualDeadlines(double hyperPeriod);
+ void computeElasticStretch(double hyperPeriod);
  void parseExecTimesFile(const char* filename);
  void buildJobsArray(double hyperPeriod);
  void scheduleEDFVD(double hyperPeriod);
  void writeScheduleToFile(const char* filename);
+ void writeKernelDeadlines(const char* filename);
  void analyzeSchedule(const char* filename);
  
  /* Helpers */
  static long long gcdLL(long long a, long long b);
  static long long lcmLL(long long a, long long b);
+ static int parseCritLevel(const char* token);
+ static int parseLevelWcets(const char* token, TaskInfo_t* task);
+ static double taskDeadlineInMode(int tIndex, int mode);
+ static void setSystemMode(int mode, double now);
+ static double budgetExhaustionTime(int jobIndex, double now);
+ static void checkBudgetOverrun(int jobIndex, double now);
+ static int elasticDemandFits(long stretch, double hyperPeriod);
+ static void chargeOverhead(int jobIndex, double cost);
+ static void chargeDispatchOverheads(int jobIndex, int prevJobIndex);
+ static double blockingLength(int tIndex);
+ static double nonPreemptibleUntil(int jobIndex, double now);
+ static int guaranteedJobReady(double now);
+ static void demoteJob(int jobIndex);
+ static int availableSlack(double now);
+ static void donateSlack(int jobIndex, double now);
+ static double degradedRunLimit(int jobIndex, double now);
+ static void accountDegradedRun(int jobIndex, double now, double delta);
+ static int countLoJobsServed(int* released);
+ static double dbfLO(int tIndex, long l, long loDeadline);
+ static double dbfHI(int tIndex, long l, long loDeadline);
  
  /*-----------------------------------------------------------
   * main()
@@ -117,8 +258,11 @@
       */
      const char* taskFile       = "tasks.txt";         /* Example name */
      const char* execTimesFile  = "exec_times.txt";    /* Example name */
+     const char* overheadsFile  = "overheads.txt";     /* optional */
+     const char* preemptionFile = "preemption.txt";    /* optional */
      const char* scheduleOut    = "schedule_output.txt";
      const char* analysisOut    = "schedule_analysis.txt";
+     const char* kernelOut      = "edfvd_deadlines.h";
  
      printf("EDF-VD Offline Scheduler Simulation\n");
  
@@ -131,8 +275,29 @@
      computeHyperPeriodAndJobCounts(&hyperPeriod);
      printf("HyperPeriod = %.2f\n", hyperPeriod);
  
+     /* 2b. Parse scheduling overheads, if measured, and inflate the budgets */
+     parseOverheadsFile(overheadsFile);
+ 
+     /* 2c. Parse non-preemptive regions, preemption points and thresholds */
+     parsePreemptionFile(preemptionFile);
+ 
      /* 3. Compute EDF-VD parameters (virtual deadlines for high-crit tasks) */
      computeEDFVDParameters();
+     for(int m=0; m<g_numLevels-1; m++){
+         printf("Scaling factor x[%d] = %.4f\n", m, g_scaling[m]);
+     }
+     if(tuneVirtualDeadlines(hyperPeriod)){
+         printf("Per-task virtual deadlines tuned by DBF search.\n");
+     }
+     else if(g_limitedPreemption){
+         fprintf(stderr, "[Warning] Blocking from limited preemption is not covered by the uniform x test.\n");
+     }
+     computeElasticStretch(hyperPeriod);
+     if(g_elasticStretch < HUGE_VAL){
+         printf("LO periods stretch by %.4f in HI mode.\n", g_elasticStretch);
+     }
+     writeKernelDeadlines(kernelOut);
+     printf("Deadlines written to %s.\n", kernelOut);
  
      /* 4. Parse actual execution times for each job from second file */
      parseExecTimesFile(execTimesFile);
@@ -140,7 +305,21 @@
      /* 5. Build the jobs array (arrival times, deadlines, etc.) */
      buildJobsArray(hyperPeriod);
  
-     /* 6. Run the EDF-VD scheduler from 0..hyperPeriod at decision points */
+     /* 6. Run the EDF-VD scheduler from 0..hyperPeriod at decision points.
+      *    With slack reclamation on, a run without it comes first, as the
+      *    baseline for the LO-task service reported by the analysis. */
+     if(g_slackPolicy != SLACK_DROP){
+         int policy = g_slackPolicy;
+         g_slackPolicy = SLACK_DROP;
+         scheduleEDFVD(hyperPeriod);
+         g_loServedBaseline = countLoJobsServed(NULL);
+ 
+         g_slackPolicy = policy;
+         g_mode = 0;
+         g_numModeSwitches = 0;
+         g_blockingTime = 0.0;
+         buildJobsArray(hyperPeriod);
+     }
      scheduleEDFVD(hyperPeriod);
  
      /* 7. Write schedule to a file */
@@ -178,20 +357,35 @@
           * name phase period wcet deadline critLevel
           * e.g.: T1 0 10 3 10 H
           */
-         char critChar;
+         char critToken[16];
+         char wcetToken[128];
          fscanf(fp, "%s", tasks[i].name);
          fscanf(fp, "%lf", &tasks[i].phase);
          fscanf(fp, "%lf", &tasks[i].period);
-         fscanf(fp, "%lf", &tasks[i].wcet);
+         fscanf(fp, "%127s", wcetToken);
          fscanf(fp, "%lf", &tasks[i].deadline);
-         fscanf(fp, " %c", &critChar);
+         fscanf(fp, "%15s", critToken);
  
-         if(critChar == 'H' || critChar == 'h')
-             tasks[i].critLevel = CRIT_HIGH;
-         else
-             tasks[i].critLevel = CRIT_LOW;
+         tasks[i].critLevel = parseCritLevel(critToken);
+         if(tasks[i].critLevel < 0){
+             fprintf(stderr, "Invalid criticality level '%s' for task %s.\n", critToken, tasks[i].name);
+             fclose(fp);
+             exit(1);
+         }
+         if(!parseLevelWcets(wcetToken, &tasks[i])){
+             fprintf(stderr, "Invalid wcet '%s' for task %s.\n", wcetToken, tasks[i].name);
+             fclose(fp);
+             exit(1);
+         }
+         if(tasks[i].critLevel >= g_numLevels){
+             g_numLevels = tasks[i].critLevel + 1;
+         }
  
          tasks[i].virtualDeadline = tasks[i].deadline; /* default, will be scaled for high-crit if needed */
+         tasks[i].cpmd = 0.0;
+         tasks[i].nprLength = 0.0;
+         tasks[i].numPreemptionPoints = 0;
+         tasks[i].preemptionThreshold = HUGE_VAL;
          tasks[i].jobCount = 0; /* filled later */
      }
  
@@ -236,46 +430,416 @@
      }
  }
  
+ /*-----------------------------------------------------------
+  * 2b) Parse the scheduling overheads file
+  *-----------------------------------------------------------*/
+ void parseOverheadsFile(const char* filename)
+ {
+     FILE* fp = fopen(filename, "r");
+     if(!fp){
+         printf("No overheads file %s, overheads are ignored.\n", filename);
+         return;
+     }
+ 
+     double nsPerUnit = 0.0; /* 0 if the values are already in task time units */
+     double maxCpmd = 0.0;
+     char line[256];
+     int lineNo = 0;
+     while(fgets(line, sizeof(line), fp)){
+         lineNo++;
+         char* comment = strchr(line, '#');
+         if(comment) *comment = '\0';
+ 
+         char key[32], name[32];
+         double value;
+         if(sscanf(line, "%31s", key) != 1) continue; /* blank line */
+ 
+         int ok = 0;
+         if(strcmp(key, "cpmd") == 0){
+             if(sscanf(line, "%*s %31s %lf", name, &value) == 2 && value >= 0.0){
+                 for(int i=0; i<g_numTasks; i++){
+                     if(strcmp(tasks[i].name, name) == 0){
+                         tasks[i].cpmd = value;
+                         ok = 1;
+                     }
+                 }
+             }
+         }
+         else if(sscanf(line, "%*s %lf", &value) == 1 && value >= 0.0){
+             ok = 1;
+             if(strcmp(key, "release") == 0)          g_overheads.release    = value;
+             else if(strcmp(key, "dispatch") == 0)    g_overheads.dispatch   = value;
+             else if(strcmp(key, "preemption") == 0)  g_overheads.preemption = value;
+             else if(strcmp(key, "ns_per_unit") == 0 && value > 0.0) nsPerUnit = value;
+             else ok = 0;
+         }
+         if(!ok){
+             fprintf(stderr, "Invalid line %d in overheads file %s.\n", lineNo, filename);
+             fclose(fp);
+             exit(1);
+         }
+     }
+     fclose(fp);
+ 
+     if(nsPerUnit > 0.0){
+         g_overheads.release    /= nsPerUnit;
+         g_overheads.dispatch   /= nsPerUnit;
+         g_overheads.preemption /= nsPerUnit;
+         for(int i=0; i<g_numTasks; i++){
+             tasks[i].cpmd /= nsPerUnit;
+         }
+     }
+     for(int i=0; i<g_numTasks; i++){
+         if(tasks[i].cpmd > maxCpmd) maxCpmd = tasks[i].cpmd;
+     }
+ 
+     /* Under EDF a job only preempts another when it is released, so each job
+      * causes at most one preemption. A job is charged its release and first
+      * dispatch, and for the preemption it causes, the context save plus the
+      * later dispatch and cache reload of the job it preempted. Inflating every
+      * budget by that bound lets the EDF-VD test and the budget checks use the
+      * measured costs unchanged. */
+     g_jobOverheadBound = g_overheads.release + 2.0 * g_overheads.dispatch +
+                          g_overheads.preemption + maxCpmd;
+     for(int i=0; i<g_numTasks; i++){
+         for(int m=0; m<MAX_CRIT_LEVELS; m++){
+             tasks[i].levelWcet[m] += g_jobOverheadBound;
+         }
+         tasks[i].wcet += g_jobOverheadBound;
+     }
+ 
+     printf("Overheads: release %.4f dispatch %.4f preemption %.4f, at most %.4f per job.\n",
+            g_overheads.release, g_overheads.dispatch, g_overheads.preemption, g_jobOverheadBound);
+ }
+ 
+ /*-----------------------------------------------------------
+  * 2c) Parse the preemption file
+  *-----------------------------------------------------------*/
+ void parsePreemptionFile(const char* filename)
+ {
+     FILE* fp = fopen(filename, "r");
+     if(!fp){
+         return; /* every task is fully preemptive */
+     }
+ 
+     char line[256];
+     int lineNo = 0;
+     while(fgets(line, sizeof(line), fp)){
+         lineNo++;
+         char* comment = strchr(line, '#');
+         if(comment) *comment = '\0';
+ 
+         char key[32], name[32], valueToken[160];
+         int fields = sscanf(line, "%31s %31s %159s", key, name, valueToken);
+         if(fields <= 0) continue; /* blank line */
+ 
+         int t = -1;
+         for(int i=0; i<g_numTasks && fields == 3; i++){
+             if(strcmp(tasks[i].name, name) == 0) t = i;
+         }
+ 
+         int ok = (t >= 0);
+         if(ok && strcmp(key, "npr") == 0){
+             char* end;
+             tasks[t].nprLength = strtod(valueToken, &end);
+             ok = (*end == '\0' && tasks[t].nprLength >= 0.0);
+         }
+         else if(ok && strcmp(key, "threshold") == 0){
+             char* end;
+             tasks[t].preemptionThreshold = strtod(valueToken, &end);
+             ok = (*end == '\0' && tasks[t].preemptionThreshold >= 0.0);
+         }
+         else if(ok && strcmp(key, "points") == 0){
+             /* Increasing execution offsets, e.g. 1,2.5,4 */
+             const char* p = valueToken;
+             int count = 0;
+             while(ok && *p != '\0'){
+                 char* end;
+                 double point = strtod(p, &end);
+                 if(end == p || point <= 0.0 || count >= MAX_PREEMPTION_POINTS ||
+                    (count > 0 && point <= tasks[t].preemptionPoints[count-1]))
+                 {
+                     ok = 0;
+                     break;
+                 }
+                 tasks[t].preemptionPoints[count++] = point;
+                 if(*end == ',') end++;
+                 else if(*end != '\0') ok = 0;
+                 p = end;
+             }
+             tasks[t].numPreemptionPoints = count;
+             ok = ok && (count > 0);
+         }
+         else {
+             ok = 0;
+         }
+ 
+         if(!ok){
+             fprintf(stderr, "Invalid line %d in preemption file %s.\n", lineNo, filename);
+             fclose(fp);
+             exit(1);
+         }
+         g_limitedPreemption = 1;
+     }
+     fclose(fp);
+ 
+     for(int i=0; i<g_numTasks; i++){
+         if(blockingLength(i) > 0.0){
+             printf("Task %s can block others for up to %.4f.\n", tasks[i].name, blockingLength(i));
+         }
+     }
+ }
+ 
  /*-----------------------------------------------------------
   * 3) Compute EDF-VD parameters (virtual deadlines for high-crit tasks)
   *-----------------------------------------------------------*/
  void computeEDFVDParameters()
  {
-     /* A typical 2-level approach for computing x:
-      *   U_H = sum of (wcet / period) for high-critical tasks
-      *   U_L = sum of (wcet / period) for low-critical tasks
-      *   We want x so that U_H / x + U_L <= 1, and x <= 1
+     /* The two-level test is applied at each mode switch. At system level m:
+      *   U_lo[m] = sum of C(m) / period for tasks at level m (real deadlines)
+      *   U_hi[m] = sum of C(m) / period for tasks above m (deadlines scaled by x[m])
+      * Level m is schedulable by EDF if its density V[m] = U_lo[m] + U_hi[m] / x[m]
+      * is at most 1, and switching from m to m+1 is safe if x[m] * U_lo[m] + V[m+1]
+      * is at most 1, with level m+1 standing in for the HI mode of the two-level
+      * test. The top level runs plain EDF, so x = 1 there.
+      *
+      * Levels above 0 take the largest x[m] the switch allows, which leaves the
+      * most room below them. Level 0 has nothing below it and keeps the standard
+      * formula x = U_H / (1 - U_L); with two levels it is the only factor.
       */
-     double U_H = 0.0, U_L = 0.0;
+     double U_lo[MAX_CRIT_LEVELS] = { 0.0 };
+     double U_hi[MAX_CRIT_LEVELS] = { 0.0 };
      for(int i=0; i<g_numTasks; i++){
-         double util = tasks[i].wcet / tasks[i].period;
-         if(tasks[i].critLevel == CRIT_HIGH) U_H += util;
-         else U_L += util;
+         for(int m=0; m<=tasks[i].critLevel; m++){
+             double util = tasks[i].levelWcet[m] / tasks[i].period;
+             if(m == tasks[i].critLevel) U_lo[m] += util;
+             else U_hi[m] += util;
+         }
      }
  
-     if(U_H > 1.0){
-         fprintf(stderr, "[Warning] High-crit tasks alone exceed total utilization > 1.\n");
+     int top = g_numLevels - 1;
+     double density = U_lo[top];
+     int feasible = (density <= 1.0 + 1e-9);
+     g_scaling[top] = 1.0;
+ 
+     if(density > 1.0){
+         fprintf(stderr, "[Warning] Highest-crit tasks alone exceed total utilization > 1.\n");
          /* Typically unschedulable, but let's keep going. */
      }
  
-     /* Compute x if possible. The standard formula is x = U_H / (1.0 - U_L),
-      * if U_L < 1. Otherwise, no feasible solution. We'll clamp x to 1 if it goes above 1.
+     for(int m=top-1; m>=0; m--){
+         double x = 1.0;
+         if(m == 0){
+             if(U_lo[0] < 1.0){
+                 x = U_hi[0] / (1.0 - U_lo[0]);
+             }
+         } else if(U_lo[m] > 0.0){
+             x = (1.0 - density) / U_lo[m];
+         }
+         if(x > 1.0) x = 1.0;
+         if(x <= 0.0){
+             /* No room left for this level: keep real deadlines and warn below. */
+             x = 1.0;
+             feasible = 0;
+         }
+ 
+         if(x * U_lo[m] + density > 1.0 + 1e-9) feasible = 0;
+         density = U_lo[m] + U_hi[m] / x;
+         if(density > 1.0 + 1e-9) feasible = 0;
+         g_scaling[m] = x;
+     }
+ 
+     if(!feasible && top > 0){
+         fprintf(stderr, "[Warning] Task set fails the EDF-VD test for %d criticality levels.\n", g_numLevels);
+     }
+ 
+     /* Deadlines at each level; tasks at or below it keep their real deadline. */
+     for(int i=0; i<g_numTasks; i++){
+         for(int m=0; m<MAX_CRIT_LEVELS; m++){
+             tasks[i].modeDeadline[m] = tasks[i].deadline;
+             if(m < g_numLevels && tasks[i].critLevel > m){
+                 tasks[i].modeDeadline[m] = tasks[i].deadline * g_scaling[m];
+             }
+         }
+         tasks[i].virtualDeadline = taskDeadlineInMode(i, 0);
+     }
+ }
+ 
+ /*-----------------------------------------------------------
+  * 3b) Tune per-task virtual deadlines (two levels)
+  *-----------------------------------------------------------*/
+ int tuneVirtualDeadlines(double hyperPeriod)
+ {
+     /* Greedy search in the style of Ekberg & Yi: every HI task starts with its
+      * LO-mode deadline equal to its real one. While the HI-mode demand bound
+      * exceeds the interval length somewhere, shorten by one time unit the
+      * LO-mode deadline of the HI task that lowers the HI-mode demand most at
+      * the first failing interval. Shortening only ever raises LO-mode demand,
+      * so the search fails as soon as the LO-mode test does.
+      *
+      * Demand is kept per interval length for both modes, and a step only
+      * re-evaluates the task it changed, so each step costs O(horizon).
+      *
+      * With limited preemption, an interval of length l can also be blocked
+      * once by a task whose deadline in that mode is longer than l, so the
+      * largest such blocking is added to the demand of both tests (Baruah).
       */
-     double x = 1.0;
-     if(U_L < 1.0){
-         double denom = (1.0 - U_L);
-         x = U_H / denom;
+     if(g_numLevels != 2) return 0;
+ 
+     long maxDeadline = 0;
+     for(int i=0; i<g_numTasks; i++){
+         if(tasks[i].period != floor(tasks[i].period) ||
+            tasks[i].deadline != floor(tasks[i].deadline) ||
+            tasks[i].deadline > tasks[i].period)
+         {
+             printf("Virtual-deadline search needs integer, constrained deadlines; keeping x.\n");
+             return 0;
+         }
+         if((long) tasks[i].deadline > maxDeadline) maxDeadline = (long) tasks[i].deadline;
+     }
+ 
+     /* Demand bounds repeat after the hyperperiod once every deadline is past. */
+     long horizon = (long) hyperPeriod + maxDeadline;
+     if(horizon > VD_SEARCH_MAX_HORIZON){
+         printf("Virtual-deadline search horizon %ld too long; keeping x.\n", horizon);
+         return 0;
+     }
+ 
+     long    loDeadline[MAX_TASKS];
+     double  blocking[MAX_TASKS];
+     for(int i=0; i<g_numTasks; i++){
+         blocking[i] = blockingLength(i);
+     }
+     double* loDemand = (double*) calloc(horizon + 1, sizeof(double));
+     double* hiDemand = (double*) calloc(horizon + 1, sizeof(double));
+     if(!loDemand || !hiDemand){
+         free(loDemand);
+         free(hiDemand);
+         return 0;
+     }
+ 
+     for(int i=0; i<g_numTasks; i++){
+         loDeadline[i] = (long) tasks[i].deadline;
+         for(long l=1; l<=horizon; l++){
+             loDemand[l] += dbfLO(i, l, loDeadline[i]);
+             if(tasks[i].critLevel == CRIT_HIGH) hiDemand[l] += dbfHI(i, l, loDeadline[i]);
+         }
+     }
+ 
+     clock_t startClock = clock();
+     int steps = 0;
+     int result = -1; /* -1 searching, 0 failed, 1 passed */
+     while(result < 0)
+     {
+         long failLO = 0, failHI = 0;
+         for(long l=1; l<=horizon && (failLO == 0 || failHI == 0); l++){
+             double blockLO = 0.0, blockHI = 0.0;
+             for(int i=0; i<g_numTasks && g_limitedPreemption; i++){
+                 if(loDeadline[i] > l && blocking[i] > blockLO) blockLO = blocking[i];
+                 if(tasks[i].critLevel == CRIT_HIGH && tasks[i].deadline > l && blocking[i] > blockHI){
+                     blockHI = blocking[i];
+                 }
+             }
+             /* Blocking only matters once some deadline falls in the interval. */
+             if(failLO == 0 && loDemand[l] > 0.0 && loDemand[l] + blockLO > l + 1e-9) failLO = l;
+             if(failHI == 0 && hiDemand[l] > 0.0 && hiDemand[l] + blockHI > l + 1e-9) failHI = l;
+         }
+ 
+         if(failLO != 0){
+             result = 0;
+         }
+         else if(failHI == 0){
+             result = 1;
+         }
+         else if((clock() - startClock) * 1000.0 / CLOCKS_PER_SEC > VD_SEARCH_TIME_LIMIT_MS){
+             printf("Virtual-deadline search hit its %d ms limit after %d steps.\n",
+                    VD_SEARCH_TIME_LIMIT_MS, steps);
+             result = 0;
+         }
+         else {
+             /* Pick the task whose one-unit shortening helps most at failHI,
+              * preferring the one with the most room left on ties. */
+             int best = -1;
+             double bestGain = -1.0;
+             for(int i=0; i<g_numTasks; i++){
+                 if(tasks[i].critLevel != CRIT_HIGH) continue;
+                 if(loDeadline[i] - 1 < (long) ceil(tasks[i].levelWcet[0]) || loDeadline[i] <= 1) continue;
+                 double gain = dbfHI(i, failHI, loDeadline[i]) - dbfHI(i, failHI, loDeadline[i] - 1);
+                 if(gain > bestGain + 1e-9 ||
+                    (fabs(gain - bestGain) <= 1e-9 && best >= 0 && loDeadline[i] > loDeadline[best]))
+                 {
+                     best = i;
+                     bestGain = gain;
+                 }
+             }
+ 
+             if(best < 0){
+                 result = 0;
+             }
+             else {
+                 long oldDeadline = loDeadline[best];
+                 loDeadline[best] = oldDeadline - 1;
+                 for(long l=1; l<=horizon; l++){
+                     loDemand[l] += dbfLO(best, l, loDeadline[best]) - dbfLO(best, l, oldDeadline);
+                     hiDemand[l] += dbfHI(best, l, loDeadline[best]) - dbfHI(best, l, oldDeadline);
+                 }
+                 steps++;
+             }
+         }
+     }
+ 
+     free(loDemand);
+     free(hiDemand);
+ 
+     if(result == 1){
+         for(int i=0; i<g_numTasks; i++){
+             if(tasks[i].critLevel == CRIT_HIGH){
+                 tasks[i].modeDeadline[0]  = (double) loDeadline[i];
+                 tasks[i].virtualDeadline = (double) loDeadline[i];
+             }
+         }
+         g_vdTuned = 1;
+     }
+     else {
+         printf("Virtual-deadline search failed after %d steps; keeping x.\n", steps);
      }
-     if(x > 1.0) x = 1.0;
+     return result == 1;
+ }
  
-     /* Scale the deadlines for high-critical tasks by x */
+ /*-----------------------------------------------------------
+  * 3c) Stretch LO periods in HI mode (two levels)
+  *-----------------------------------------------------------*/
+ void computeElasticStretch(double hyperPeriod)
+ {
+     /* The HI-mode condition of EDF-VD, x * U_L + U_H(HI) <= 1, leaves room
+      * that plain EDF-VD does not use. LO jobs released after the switch with
+      * their periods (and deadlines) stretched by k add U_L / k, so they stay
+      * guaranteed if x * U_L + U_H(HI) + U_L / k <= 1. Tuned deadlines have no
+      * single x, so for them k is the smallest whole factor for which the
+      * HI-mode demand bound test still passes with the stretched LO tasks. */
+     g_elasticStretch = HUGE_VAL;
+     if(g_numLevels != 2 || !(g_slackPolicy & SLACK_ELASTIC)) return;
+ 
+     double U_L = 0.0, U_HH = 0.0;
      for(int i=0; i<g_numTasks; i++){
-         if(tasks[i].critLevel == CRIT_HIGH){
-             tasks[i].virtualDeadline = tasks[i].deadline * x;
+         if(tasks[i].critLevel == CRIT_LOW) U_L += tasks[i].levelWcet[0] / tasks[i].period;
+         else U_HH += tasks[i].levelWcet[1] / tasks[i].period;
+     }
+     if(U_L <= 0.0) return;
+ 
+     if(g_vdTuned){
+         for(long k=1; k<=ELASTIC_MAX_STRETCH && g_elasticStretch == HUGE_VAL; k++){
+             if(U_HH + U_L / (double) k > 1.0 + 1e-9) continue;
+             if(elasticDemandFits(k, hyperPeriod)) g_elasticStretch = (double) k;
          }
+         return;
      }
  
-     /* For low-crit tasks, virtualDeadline = realDeadline. (already set by default) */
+     double room = 1.0 - g_scaling[0] * U_L - U_HH;
+     if(room <= 1e-9) return;
+ 
+     g_elasticStretch = U_L / room;
+     if(g_elasticStretch < 1.0) g_elasticStretch = 1.0;
  }
  
  /*-----------------------------------------------------------
@@ -368,7 +932,13 @@
              jobs[g_numJobs].wcet            = tasks[tIndex].wcet;
              jobs[g_numJobs].actualExecTime  = actualTimes[jobId];
              jobs[g_numJobs].remainingTime   = actualTimes[jobId];
+             jobs[g_numJobs].overheadTime    = 0.0;
+             jobs[g_numJobs].nprEnd          = -1.0;
              jobs[g_numJobs].finished        = 0;
+             jobs[g_numJobs].dropped         = 0;
+             jobs[g_numJobs].degraded        = 0;
+             jobs[g_numJobs].elastic         = 0;
+             chargeOverhead(g_numJobs, g_overheads.release);
  
              /* Real absolute deadline = arrival + tasks[tIndex].deadline */
              double realDL = arrival + tasks[tIndex].deadline;
@@ -413,6 +983,9 @@
  {
      double currentTime = 0.0;
      g_numSlices = 0;
+     g_numSlack = 0;
+     g_slackTimeUsed = 0.0;
+     g_backgroundTimeUsed = 0.0;
      int lastRunningJobIndex = -1;
  
      /* We’ll store events: arrivals and completions. We do
@@ -425,13 +998,38 @@
      while(currentTime < hyperPeriod)
      {
          /* 1) Collect active jobs (arrived, not finished, arrival <= currentTime, and remainingTime>0) */
+         /* The system returns to level 0 once no guaranteed job is ready, before
+          * jobs released at this instant are judged against the old level. */
+         if(g_mode != 0 && !guaranteedJobReady(currentTime)){
+             setSystemMode(0, currentTime);
+         }
+ 
          int activeCount = 0;
          int activeIndices[MAX_JOBS];
          for(int i=0; i<g_numJobs; i++){
-             if(!jobs[i].finished &&
+             if(!jobs[i].finished && !jobs[i].dropped &&
                 jobs[i].arrivalTime <= currentTime &&
                 jobs[i].remainingTime > 0.0)
              {
+                 if(tasks[jobs[i].taskIndex].critLevel < g_mode && !jobs[i].degraded && !jobs[i].elastic){
+                     /* released while the system is above its level */
+                     demoteJob(i);
+                     if(jobs[i].dropped) continue;
+                 }
+                 if(jobs[i].degraded){
+                     /* Degraded jobs run at the deadline of the slack they use,
+                      * or after every guaranteed job, until their own deadline. */
+                     if(currentTime >= jobs[i].absoluteDeadline - 1e-9){
+                         jobs[i].dropped = 1;
+                         continue;
+                     }
+                     int s = (g_slackPolicy & SLACK_EARLY) ? availableSlack(currentTime) : -1;
+                     if(s >= 0) jobs[i].virtualDeadline = g_slack[s].deadline;
+                     else if(g_slackPolicy & SLACK_IDLE) jobs[i].virtualDeadline = BACKGROUND_PRIORITY + jobs[i].absoluteDeadline;
+                     else continue;
+                     activeIndices[activeCount++] = i;
+                     continue;
+                 }
                  activeIndices[activeCount++] = i;
              }
          }
@@ -482,6 +1080,40 @@
                  fprintf(stderr, "Error selecting job.\n");
                  return;
              }
+ 
+             /* Limited preemption: the running job may keep the processor until
+              * it can be preempted, which then becomes a decision point. */
+             double preemptibleAt = HUGE_VAL;
+             int blocked = 0;
+             if(lastRunningJobIndex >= 0 && chosenIndex != lastRunningJobIndex &&
+                !jobs[lastRunningJobIndex].finished && !jobs[lastRunningJobIndex].dropped &&
+                !jobs[lastRunningJobIndex].degraded)
+             {
+                 int last = lastRunningJobIndex;
+                 /* Thresholds compare the relative deadline EDF-VD dispatches
+                  * by, the virtual one for a HI job in LO mode, so that a job
+                  * able to preempt also has the shorter deadline in the demand
+                  * bound tests. */
+                 double preemptorDeadline = jobs[chosenIndex].virtualDeadline - jobs[chosenIndex].arrivalTime;
+                 if(preemptorDeadline >= tasks[jobs[last].taskIndex].preemptionThreshold){
+                     blocked = 1;
+                 }
+                 else {
+                     preemptibleAt = nonPreemptibleUntil(last, currentTime);
+                     blocked = (preemptibleAt > currentTime + 1e-9);
+                 }
+                 if(blocked){
+                     chosenIndex = last;
+                 }
+                 else {
+                     jobs[last].nprEnd = -1.0; /* preempted, its region is over */
+                 }
+             }
+ 
+             if(chosenIndex != lastRunningJobIndex){
+                 chargeDispatchOverheads(chosenIndex, lastRunningJobIndex);
+             }
+ 
              /* 3) Decide how long we can run before next arrival or finishing this job. */
              double remain = jobs[chosenIndex].remainingTime;
              double nextArrival = hyperPeriod;
@@ -495,6 +1127,11 @@
  
              double nextCompletion = currentTime + remain; // if we run this job to finish
              double nextDecision = (nextArrival < nextCompletion) ? nextArrival : nextCompletion;
+             double budgetEnd = budgetExhaustionTime(chosenIndex, currentTime);
+             if(budgetEnd < nextDecision) nextDecision = budgetEnd;
+             if(preemptibleAt < nextDecision) nextDecision = preemptibleAt;
+             double degradedEnd = degradedRunLimit(chosenIndex, currentTime);
+             if(degradedEnd < nextDecision) nextDecision = degradedEnd;
  
              /* If we are switching jobs, that's a preemption (unless it's the same job). */
              if(chosenIndex != lastRunningJobIndex){
@@ -518,6 +1155,8 @@
  
              /* run chosen job from currentTime to nextDecision */
              double delta = nextDecision - currentTime;
+             if(blocked) g_blockingTime += delta;
+             accountDegradedRun(chosenIndex, currentTime, delta);
              jobs[chosenIndex].remainingTime -= delta;
              currentTime = nextDecision;
  
@@ -528,11 +1167,18 @@
              if(jobs[chosenIndex].remainingTime <= 1e-9){
                  jobs[chosenIndex].finished = 1;
                  jobs[chosenIndex].finishTime = currentTime;
+                 donateSlack(chosenIndex, currentTime);
+             }
+             else {
+                 checkBudgetOverrun(chosenIndex, currentTime);
              }
          }
          else {
              /* Only one active job, simpler. */
              int chosenIndex = activeIndices[0];
+             if(chosenIndex != lastRunningJobIndex){
+                 chargeDispatchOverheads(chosenIndex, lastRunningJobIndex);
+             }
              double remain = jobs[chosenIndex].remainingTime;
  
              double nextArrival = hyperPeriod;
@@ -545,6 +1191,10 @@
              }
              double nextCompletion = currentTime + remain; 
              double nextDecision = (nextArrival < nextCompletion)? nextArrival : nextCompletion;
+             double budgetEnd = budgetExhaustionTime(chosenIndex, currentTime);
+             if(budgetEnd < nextDecision) nextDecision = budgetEnd;
+             double degradedEnd = degradedRunLimit(chosenIndex, currentTime);
+             if(degradedEnd < nextDecision) nextDecision = degradedEnd;
  
              if(chosenIndex != lastRunningJobIndex){
                  /* new slice */
@@ -564,6 +1214,7 @@
              }
  
              double delta = nextDecision - currentTime;
+             accountDegradedRun(chosenIndex, currentTime, delta);
              jobs[chosenIndex].remainingTime -= delta;
              currentTime = nextDecision;
              slices[g_numSlices-1].end = currentTime;
@@ -571,6 +1222,10 @@
              if(jobs[chosenIndex].remainingTime <= 1e-9){
                  jobs[chosenIndex].finished = 1;
                  jobs[chosenIndex].finishTime = currentTime;
+                 donateSlack(chosenIndex, currentTime);
+             }
+             else {
+                 checkBudgetOverrun(chosenIndex, currentTime);
              }
          }
  
@@ -602,6 +1257,50 @@
      fclose(fp);
  }
  
+ /*-----------------------------------------------------------
+  * 7b) Write the deadlines as a header for the kernel build
+  *-----------------------------------------------------------*/
+ void writeKernelDeadlines(const char* filename)
+ {
+     FILE* fp = fopen(filename, "w");
+     if(!fp){
+         fprintf(stderr, "Cannot open %s for writing.\n", filename);
+         return;
+     }
+ 
+     fprintf(fp, "/* Generated by edfvdsim from the tasks file. Times are in its units.\n");
+     fprintf(fp, " * MODE_DEADLINES lists the relative deadline used at each system level,\n");
+     fprintf(fp, " * and is what FreeRTOS/EDF passes to vSetTaskDeadlinesEDF().\n");
+     fprintf(fp, " * LO_DEADLINE is the one used before a mode switch, DEADLINE the real one. */\n");
+     fprintf(fp, "#ifndef EDFVD_DEADLINES_H\n#define EDFVD_DEADLINES_H\n\n");
+     fprintf(fp, "#define EDFVD_TASK_COUNT    %d\n", g_numTasks);
+     fprintf(fp, "#define EDFVD_NUM_LEVELS    %d\n", g_numLevels);
+     fprintf(fp, "#define EDFVD_VD_TUNED      %d\n\n", g_vdTuned);
+ 
+     for(int i=0; i<g_numTasks; i++){
+         /* Task names become part of the macro names. */
+         char macroName[32];
+         int k = 0;
+         for(; tasks[i].name[k] != '\0' && k < (int) sizeof(macroName) - 1; k++){
+             macroName[k] = isalnum((unsigned char) tasks[i].name[k]) ?
+                            (char) toupper((unsigned char) tasks[i].name[k]) : '_';
+         }
+         macroName[k] = '\0';
+ 
+         fprintf(fp, "#define EDFVD_%s_CRIT_LEVEL     %d\n", macroName, tasks[i].critLevel);
+         fprintf(fp, "#define EDFVD_%s_PERIOD         %g\n", macroName, tasks[i].period);
+         fprintf(fp, "#define EDFVD_%s_DEADLINE       %g\n", macroName, tasks[i].deadline);
+         fprintf(fp, "#define EDFVD_%s_LO_DEADLINE    %g\n", macroName, tasks[i].modeDeadline[0]);
+         fprintf(fp, "#define EDFVD_%s_MODE_DEADLINES { ", macroName);
+         for(int m=0; m<g_numLevels; m++){
+             fprintf(fp, "%g%s", tasks[i].modeDeadline[m], (m < g_numLevels - 1) ? ", " : " }\n\n");
+         }
+     }
+ 
+     fprintf(fp, "#endif /* EDFVD_DEADLINES_H */\n");
+     fclose(fp);
+ }
+ 
  /*-----------------------------------------------------------
   * 8) Analyze schedule
   *-----------------------------------------------------------*/
@@ -617,6 +1316,9 @@
      double totalWait      = 0.0;
      double totalResponse  = 0.0;
      int finishedJobs      = 0;
+     int droppedJobs       = 0;
+     double totalOverhead  = 0.0;
+     int elasticJobs       = 0;
  
      /* Count preemptions by checking slices array: each time we change (taskIndex,jobId). */
      for(int i=1; i<g_numSlices; i++){
@@ -636,7 +1338,16 @@
              totalResponse += resp;
              finishedJobs++;
          }
+         if(jobs[i].dropped){
+             droppedJobs++;
+         }
+         totalOverhead += jobs[i].overheadTime;
+         if(jobs[i].elastic){
+             elasticJobs++;
+         }
      }
+     int loReleased = 0;
+     int loServed = countLoJobsServed(&loReleased);
  
      double avgWait      = (finishedJobs > 0) ? (totalWait      / finishedJobs) : 0.0;
      double avgResponse  = (finishedJobs > 0) ? (totalResponse  / finishedJobs) : 0.0;
@@ -653,6 +1364,26 @@
      fprintf(fp, "Number of Preemptions: %d\n", preemptions);
      fprintf(fp, "Average Waiting Time:  %.2f\n", avgWait);
      fprintf(fp, "Average Response Time: %.2f\n", avgResponse);
+     fprintf(fp, "Mode Switches:         %d\n", g_numModeSwitches);
+     fprintf(fp, "Dropped Jobs:          %d\n", droppedJobs);
+     fprintf(fp, "Virtual Deadlines:     %s\n", g_vdTuned ? "per-task (DBF search)" : "uniform x");
+     fprintf(fp, "Overhead Charged:      %.2f\n", totalOverhead);
+     fprintf(fp, "LO Jobs Served:        %d of %d", loServed, loReleased);
+     if(g_loServedBaseline >= 0){
+         fprintf(fp, " (%d without slack reclamation)", g_loServedBaseline);
+     }
+     fprintf(fp, "\n");
+     fprintf(fp, "Elastic LO Jobs:       %d\n", elasticJobs);
+     fprintf(fp, "Slack Time Used:       %.2f\n", g_slackTimeUsed);
+     fprintf(fp, "Background Time Used:  %.2f\n", g_backgroundTimeUsed);
+     if(g_limitedPreemption){
+         double maxBlocking = 0.0;
+         for(int i=0; i<g_numTasks; i++){
+             if(blockingLength(i) > maxBlocking) maxBlocking = blockingLength(i);
+         }
+         fprintf(fp, "Blocking Time:         %.2f\n", g_blockingTime);
+         fprintf(fp, "Max Blocking (bound):  %.2f\n", maxBlocking);
+     }
  
      /* You could also compute jitter, turnaround times, etc. if needed. */
  
@@ -674,4 +1405,383 @@
      if(g == 0) return 0;
      return (a / g) * b;
  }
- 
\ No newline at end of file
+ 
+ 
+ /*-----------------------------------------------------------
+  * Helpers: criticality levels
+  *-----------------------------------------------------------*/
+ static int parseCritLevel(const char* token)
+ {
+     /* L/H for two levels, a DAL letter (A is the most critical), or a number. */
+     if(token[0] != '\0' && token[1] == '\0'){
+         char c = (char) toupper((unsigned char) token[0]);
+         if(c == 'L') return CRIT_LOW;
+         if(c == 'H') return CRIT_HIGH;
+         if(c >= 'A' && c <= 'E') return 'E' - c;
+     }
+ 
+     char* end;
+     long level = strtol(token, &end, 10);
+     if(end == token || *end != '\0' || level < 0 || level >= MAX_CRIT_LEVELS){
+         return -1;
+     }
+     return (int) level;
+ }
+ 
+ static int parseLevelWcets(const char* token, TaskInfo_t* task)
+ {
+     /* "3" is the same budget at every level, "2,3" is C(0)=2 and C(1)=3. */
+     const char* p = token;
+     int count = 0;
+     while(*p != '\0'){
+         char* end;
+         double value = strtod(p, &end);
+         if(end == p || value < 0.0 || count > task->critLevel) return 0;
+         if(count > 0 && value < task->levelWcet[count-1]) return 0; /* budgets only grow */
+         task->levelWcet[count++] = value;
+         if(*end == ',') end++;
+         else if(*end != '\0') return 0;
+         p = end;
+     }
+     if(count == 0) return 0;
+ 
+     for(int m=count; m<MAX_CRIT_LEVELS; m++){
+         task->levelWcet[m] = task->levelWcet[count-1];
+     }
+     task->wcet = task->levelWcet[task->critLevel];
+     return 1;
+ }
+ 
+ static double taskDeadlineInMode(int tIndex, int mode)
+ {
+     /* Relative deadline used by EDF-VD at system level 'mode'. */
+     return tasks[tIndex].modeDeadline[mode];
+ }
+ 
+ static void setSystemMode(int mode, double now)
+ {
+     /* Released jobs below the new level are demoted (dropped under plain
+      * EDF-VD), the others switch to the virtual deadlines of the new level. */
+     if(mode > g_mode) g_numModeSwitches++;
+     if(g_mode == 0 && mode > 0){
+         /* Only LO jobs released from now on can be elastic. */
+         for(int t=0; t<g_numTasks; t++){
+             g_elasticNext[t] = now;
+         }
+     }
+     g_mode = mode;
+ 
+     for(int i=0; i<g_numJobs; i++){
+         if(jobs[i].finished || jobs[i].dropped || jobs[i].degraded || jobs[i].elastic) continue;
+         int t = jobs[i].taskIndex;
+         if(tasks[t].critLevel < mode){
+             if(jobs[i].arrivalTime <= now) demoteJob(i);
+             continue;
+         }
+         jobs[i].virtualDeadline = jobs[i].arrivalTime + taskDeadlineInMode(t, mode);
+     }
+ }
+ 
+ static double budgetExhaustionTime(int jobIndex, double now)
+ {
+     /* When the job would use up its budget at the current level and raise the
+      * system level, or HUGE_VAL if it completes within that budget. Degraded
+      * jobs run without a guarantee, so they never raise the level. */
+     int t = jobs[jobIndex].taskIndex;
+     double budget = tasks[t].levelWcet[g_mode];
+     if(jobs[jobIndex].degraded || tasks[t].critLevel <= g_mode ||
+        jobs[jobIndex].actualExecTime <= budget + 1e-9)
+     {
+         return HUGE_VAL;
+     }
+     double executed = jobs[jobIndex].actualExecTime - jobs[jobIndex].remainingTime;
+     return now + (budget - executed);
+ }
+ 
+ static void checkBudgetOverrun(int jobIndex, double now)
+ {
+     /* Raise the system level past every budget the job has used up. Budgets
+      * may be equal across levels, so one overrun can skip several levels.
+      * A degraded job above level 0 would otherwise raise the level again
+      * each time guaranteedJobReady() lets it drop back. */
+     if(jobs[jobIndex].degraded) return;
+     int t = jobs[jobIndex].taskIndex;
+     double executed = jobs[jobIndex].actualExecTime - jobs[jobIndex].remainingTime;
+     int mode = g_mode;
+     while(mode < tasks[t].critLevel &&
+           executed >= tasks[t].levelWcet[mode] - 1e-9 &&
+           jobs[jobIndex].actualExecTime > tasks[t].levelWcet[mode] + 1e-9)
+     {
+         mode++;
+     }
+     if(mode != g_mode){
+         setSystemMode(mode, now);
+     }
+ }
+ 
+ /*-----------------------------------------------------------
+  * Helpers: scheduling overheads
+  *-----------------------------------------------------------*/
+ static void chargeOverhead(int jobIndex, double cost)
+ {
+     /* Overheads run in the job's time, so they count against its budget. */
+     jobs[jobIndex].actualExecTime += cost;
+     jobs[jobIndex].remainingTime  += cost;
+     jobs[jobIndex].overheadTime   += cost;
+ }
+ 
+ static void chargeDispatchOverheads(int jobIndex, int prevJobIndex)
+ {
+     /* jobIndex is dispatched in place of prevJobIndex. A job pays for its
+      * first dispatch, and a preempting job also pays for resuming the job it
+      * preempted, matching the per-job bound of parseOverheadsFile().
+      * A degraded job switched out before it completes pays for that switch
+      * itself. It only ran on slack, and it already paid for resuming the job
+      * it had preempted, so the guaranteed job taking over owes nothing. */
+     if(jobs[jobIndex].startTime < 0){
+         chargeOverhead(jobIndex, g_overheads.dispatch);
+     }
+     if(prevJobIndex >= 0 && !jobs[prevJobIndex].finished && !jobs[prevJobIndex].dropped){
+         int payer = jobs[prevJobIndex].degraded ? prevJobIndex : jobIndex;
+         chargeOverhead(payer, g_overheads.preemption + g_overheads.dispatch +
+                               tasks[jobs[prevJobIndex].taskIndex].cpmd);
+     }
+ }
+ 
+ /*-----------------------------------------------------------
+  * Helpers: limited preemption
+  *-----------------------------------------------------------*/
+ static double blockingLength(int tIndex)
+ {
+     /* The longest a job of this task can run while a job EDF-VD prefers
+      * waits. A threshold can defer preemptions to the end of the job. */
+     double wcet = tasks[tIndex].wcet;
+     if(tasks[tIndex].preemptionThreshold < HUGE_VAL){
+         return wcet;
+     }
+     if(tasks[tIndex].numPreemptionPoints > 0){
+         double longest = 0.0, prev = 0.0;
+         for(int k=0; k<tasks[tIndex].numPreemptionPoints && prev < wcet; k++){
+             double point = fmin(tasks[tIndex].preemptionPoints[k], wcet);
+             if(point - prev > longest) longest = point - prev;
+             prev = point;
+         }
+         return fmax(longest, wcet - prev);
+     }
+     return fmin(tasks[tIndex].nprLength, wcet);
+ }
+ 
+ static double nonPreemptibleUntil(int jobIndex, double now)
+ {
+     /* When the running job can next be preempted, given that a preemption is
+      * pending. A floating non-preemptive region starts at the first request. */
+     int t = jobs[jobIndex].taskIndex;
+     double until = now;
+     if(tasks[t].numPreemptionPoints > 0){
+         double executed = jobs[jobIndex].actualExecTime - jobs[jobIndex].remainingTime;
+         until = HUGE_VAL; /* past the last point it runs to completion */
+         for(int k=0; k<tasks[t].numPreemptionPoints; k++){
+             if(tasks[t].preemptionPoints[k] >= executed - 1e-9){
+                 until = now + (tasks[t].preemptionPoints[k] - executed);
+                 break;
+             }
+         }
+     }
+     else if(tasks[t].nprLength > 0.0){
+         if(jobs[jobIndex].nprEnd < 0.0){
+             jobs[jobIndex].nprEnd = now + tasks[t].nprLength;
+         }
+         until = jobs[jobIndex].nprEnd;
+     }
+ 
+     double completion = now + jobs[jobIndex].remainingTime;
+     return (until < completion) ? until : completion;
+ }
+ 
+ /*-----------------------------------------------------------
+  * Helpers: slack reclamation
+  *-----------------------------------------------------------*/
+ static int guaranteedJobReady(double now)
+ {
+     /* Whether a released job still runs under the guarantees of the current
+      * level, so that the system cannot return to level 0 yet. */
+     for(int i=0; i<g_numJobs; i++){
+         if(jobs[i].finished || jobs[i].dropped || jobs[i].degraded) continue;
+         if(jobs[i].arrivalTime > now || jobs[i].remainingTime <= 0.0) continue;
+         if(jobs[i].elastic || tasks[jobs[i].taskIndex].critLevel >= g_mode) return 1;
+     }
+     return 0;
+ }
+ 
+ static void demoteJob(int jobIndex)
+ {
+     /* A released job below the system level becomes elastic if its task is
+      * due for a stretched release, degraded if any slack can serve it, and
+      * is dropped otherwise. */
+     int t = jobs[jobIndex].taskIndex;
+     if((g_slackPolicy & SLACK_ELASTIC) && g_elasticStretch < HUGE_VAL &&
+        jobs[jobIndex].arrivalTime >= g_elasticNext[t] - 1e-9)
+     {
+         double stretched = g_elasticStretch * tasks[t].period;
+         jobs[jobIndex].elastic = 1;
+         jobs[jobIndex].absoluteDeadline = jobs[jobIndex].arrivalTime + stretched;
+         jobs[jobIndex].virtualDeadline  = jobs[jobIndex].absoluteDeadline;
+         g_elasticNext[t] = jobs[jobIndex].arrivalTime + stretched;
+     }
+     else if(g_slackPolicy & (SLACK_IDLE | SLACK_EARLY)){
+         jobs[jobIndex].degraded = 1;
+     }
+     else {
+         jobs[jobIndex].dropped = 1;
+     }
+ }
+ 
+ static int availableSlack(double now)
+ {
+     /* Drops used up and expired slack, and returns the slack with the
+      * earliest deadline, or -1 if there is none. */
+     int kept = 0, earliest = -1;
+     for(int k=0; k<g_numSlack; k++){
+         if(g_slack[k].amount <= 1e-9 || g_slack[k].deadline <= now + 1e-9) continue;
+         g_slack[kept] = g_slack[k];
+         if(earliest < 0 || g_slack[kept].deadline < g_slack[earliest].deadline) earliest = kept;
+         kept++;
+     }
+     g_numSlack = kept;
+     return earliest;
+ }
+ 
+ static void donateSlack(int jobIndex, double now)
+ {
+     /* The EDF-VD test reserves each guaranteed job its budget at the current
+      * level until its virtual deadline, so whatever it did not use can be
+      * lent until then without delaying anyone else. */
+     if(!(g_slackPolicy & SLACK_EARLY) || jobs[jobIndex].degraded) return;
+ 
+     int t = jobs[jobIndex].taskIndex;
+     int level = (tasks[t].critLevel < g_mode) ? tasks[t].critLevel : g_mode;
+     double unused = tasks[t].levelWcet[level] - jobs[jobIndex].actualExecTime;
+     if(unused <= 1e-9 || jobs[jobIndex].virtualDeadline <= now) return;
+ 
+     availableSlack(now);
+     if(g_numSlack >= MAX_SLACK) return;
+     g_slack[g_numSlack].amount   = unused;
+     g_slack[g_numSlack].deadline = jobs[jobIndex].virtualDeadline;
+     g_numSlack++;
+ }
+ 
+ static double degradedRunLimit(int jobIndex, double now)
+ {
+     /* A degraded job stops at its deadline, and when the slack it runs on
+      * is used up or expires. */
+     if(!jobs[jobIndex].degraded) return HUGE_VAL;
+     double limit = jobs[jobIndex].absoluteDeadline;
+     if(jobs[jobIndex].virtualDeadline < BACKGROUND_PRIORITY){
+         int s = availableSlack(now);
+         if(s >= 0){
+             limit = fmin(limit, fmin(now + g_slack[s].amount, g_slack[s].deadline));
+         }
+     }
+     return limit;
+ }
+ 
+ static void accountDegradedRun(int jobIndex, double now, double delta)
+ {
+     if(!jobs[jobIndex].degraded) return;
+     if(jobs[jobIndex].virtualDeadline < BACKGROUND_PRIORITY){
+         int s = availableSlack(now);
+         if(s >= 0) g_slack[s].amount -= delta;
+         g_slackTimeUsed += delta;
+     }
+     else {
+         g_backgroundTimeUsed += delta;
+     }
+ }
+ 
+ static int countLoJobsServed(int* released)
+ {
+     /* Jobs below the top level that completed by their deadline, which is
+      * the stretched one for elastic jobs. */
+     int served = 0, total = 0;
+     for(int i=0; i<g_numJobs; i++){
+         if(tasks[jobs[i].taskIndex].critLevel >= g_numLevels - 1) continue;
+         total++;
+         if(jobs[i].finished && jobs[i].finishTime <= jobs[i].absoluteDeadline + 1e-9) served++;
+     }
+     if(released) *released = total;
+     return served;
+ }
+ 
+ /*-----------------------------------------------------------
+  * Helpers: demand bound functions (Ekberg & Yi)
+  *-----------------------------------------------------------*/
+ static double dbfLO(int tIndex, long l, long loDeadline)
+ {
+     /* LO-mode demand in any interval of length l, at the level-0 budget. */
+     long period = (long) tasks[tIndex].period;
+     if(l < loDeadline) return 0.0;
+     return (double) ((l - loDeadline) / period + 1) * tasks[tIndex].levelWcet[0];
+ }
+ 
+ static double dbfHI(int tIndex, long l, long loDeadline)
+ {
+     /* HI-mode demand in any interval of length l ending after the switch:
+      * full jobs at the level-1 budget, minus what a carry-over job must have
+      * executed in LO mode before its virtual deadline was missed. */
+     long period = (long) tasks[tIndex].period;
+     long deadline = (long) tasks[tIndex].deadline;
+     long gap = deadline - loDeadline;
+     if(l < gap) return 0.0;
+ 
+     double full = (double) ((l - gap) / period + 1) * tasks[tIndex].levelWcet[1];
+     long n = l % period;
+     double done = 0.0;
+     if(n >= gap && n < deadline){
+         done = tasks[tIndex].levelWcet[0] - (double) n + (double) gap;
+         if(done < 0.0) done = 0.0;
+     }
+     return full - done;
+ }
+ 
+ static int elasticDemandFits(long stretch, double hyperPeriod)
+ {
+     /* HI-mode test of tuneVirtualDeadlines() with every LO task added as a
+      * sporadic task whose period and deadline are stretch times its period.
+      * Elastic jobs are only released in HI mode, so the LO-mode test is
+      * unchanged. */
+     long long period = (long long) hyperPeriod;
+     long maxDeadline = 0;
+     long deadline[MAX_TASKS];
+     double blocking[MAX_TASKS];
+     for(int i=0; i<g_numTasks; i++){
+         if(tasks[i].critLevel == CRIT_LOW){
+             deadline[i] = stretch * (long) tasks[i].period;
+             period = lcmLL(period, deadline[i]);
+         }
+         else {
+             deadline[i] = (long) tasks[i].deadline;
+         }
+         if(deadline[i] > maxDeadline) maxDeadline = deadline[i];
+         blocking[i] = blockingLength(i);
+         if(period > VD_SEARCH_MAX_HORIZON) return 0;
+     }
+ 
+     /* Demand bounds repeat after the hyperperiod once every deadline is past. */
+     long horizon = (long) period + maxDeadline;
+     if(horizon > VD_SEARCH_MAX_HORIZON) return 0;
+ 
+     for(long l=1; l<=horizon; l++){
+         double demand = 0.0, block = 0.0;
+         for(int i=0; i<g_numTasks; i++){
+             if(tasks[i].critLevel == CRIT_HIGH){
+                 demand += dbfHI(i, l, (long) tasks[i].modeDeadline[0]);
+             }
+             else {
+                 demand += (double) (l / deadline[i]) * tasks[i].levelWcet[0];
+             }
+             if(g_limitedPreemption && deadline[i] > l && blocking[i] > block) block = blocking[i];
+         }
+         if(demand > 0.0 && demand + block > l + 1e-9) return 0;
+     }
+     return 1;
+ }